@@ -252,6 +252,7 @@ struct user_args
 {
 	Page		page;
 	OffsetNumber offset;
+	int			natts;			/* number of index attributes */
 };
 
 Datum
@@ -260,7 +261,7 @@ bt_page_items(PG_FUNCTION_ARGS)
 	text	   *relname = PG_GETARG_TEXT_P(0);
 	uint32		blkno = PG_GETARG_UINT32(1);
 	Datum		result;
-	char	   *values[6];
+	char	   *values[7];
 	HeapTuple	tuple;
 	FuncCallContext *fctx;
 	MemoryContext mctx;
@@ -317,6 +318,7 @@ bt_page_items(PG_FUNCTION_ARGS)
 
 		uargs->page = palloc(BLCKSZ);
 		memcpy(uargs->page, BufferGetPage(buffer), BLCKSZ);
+		uargs->natts = RelationGetNumberOfAttributes(rel);
 
 		UnlockReleaseBuffer(buffer);
 		relation_close(rel, AccessShareLock);
@@ -381,6 +383,19 @@ bt_page_items(PG_FUNCTION_ARGS)
 			sprintf(dump, "%02x", *(ptr + off) & 0xff);
 			dump += 2;
 		}
+		j++;
+
+		/*
+		 * Number of key attributes actually present in the tuple; less than
+		 * the number of index columns for suffix-truncated pivot tuples.
+		 * (Pre-1.4 definitions of the function don't have this column;
+		 * BuildTupleFromCStrings just ignores the extra value then.)
+		 */
+		if (BTreeTupleIsTruncated(itup))
+			values[j] = psprintf("%d", ItemPointerGetOffsetNumber(&itup->t_tid) &
+								 BT_N_KEYS_OFFSET_MASK);
+		else
+			values[j] = psprintf("%d", uargs->natts);
 
 		tuple = BuildTupleFromCStrings(fctx->attinmeta, values);
 		result = HeapTupleGetDatum(tuple);
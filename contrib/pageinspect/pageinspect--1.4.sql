@@ -1,4 +1,4 @@
-/* contrib/pageinspect/pageinspect--1.3.sql */
+/* contrib/pageinspect/pageinspect--1.4.sql */
 
 -- complain if script is sourced in psql, rather than via CREATE EXTENSION
 \echo Use "CREATE EXTENSION pageinspect" to load this file. \quit
@@ -93,7 +93,8 @@ CREATE FUNCTION bt_page_items(IN relname text, IN blkno int4,
     OUT itemlen smallint,
     OUT nulls bool,
     OUT vars bool,
-    OUT data text)
+    OUT data text,
+    OUT natts smallint)
 RETURNS SETOF record
 AS 'MODULE_PATHNAME', 'bt_page_items'
 LANGUAGE C STRICT;
@@ -0,0 +1,78 @@
+CREATE EXTENSION pageinspect;
+
+--
+-- Suffix truncation of pivot tuples.  The leading column has long runs of
+-- duplicates, so leaf pages split both within and between runs; in either
+-- case the trailing column is never needed to separate the two halves.
+--
+CREATE TABLE test_trunc (a text, b int, c int);
+CREATE INDEX test_trunc_idx ON test_trunc (a, b, c);
+
+-- leaf splits during insertion
+INSERT INTO test_trunc
+  SELECT repeat('x', 100) || (i / 100), i, i FROM generate_series(1, 5000) i;
+
+-- CREATE INDEX on the loaded table
+CREATE INDEX test_trunc_built_idx ON test_trunc (a, b, c);
+
+CREATE FUNCTION btree_pivots(idx regclass)
+RETURNS TABLE (type "char", natts smallint) AS $$
+  SELECT s.type, i.natts
+  FROM generate_series(1, (pg_relation_size(idx) /
+                           current_setting('block_size')::int)::int - 1) blk,
+       LATERAL bt_page_stats(idx::text, blk) s,
+       LATERAL bt_page_items(idx::text, blk) i
+  WHERE (s.type = 'l' AND s.btpo_next <> 0 AND i.itemoffset = 1) OR
+        (s.type IN ('i', 'r') AND i.data <> '')
+$$ LANGUAGE sql;
+
+SELECT level > 0 AS has_internal_pages FROM bt_metap('test_trunc_idx');
+
+-- every leaf high key and every downlink lacks the trailing column
+SELECT count(*) > 50 AS many_pivots, bool_and(natts < 3) AS all_truncated
+  FROM btree_pivots('test_trunc_idx');
+SELECT count(*) > 50 AS many_pivots, bool_and(natts < 3) AS all_truncated
+  FROM btree_pivots('test_trunc_built_idx');
+
+-- but leaf data items keep all of their columns
+SELECT bool_and(i.natts = 3) AS leaf_items_complete
+  FROM generate_series(1, (pg_relation_size('test_trunc_idx') /
+                           current_setting('block_size')::int)::int - 1) blk,
+       LATERAL bt_page_stats('test_trunc_idx', blk) s,
+       LATERAL bt_page_items('test_trunc_idx', blk) i
+  WHERE s.type = 'l' AND (s.btpo_next = 0 OR i.itemoffset > 1);
+
+-- searches descending through truncated pivots find the right rows
+SET enable_seqscan = off;
+SET enable_bitmapscan = off;
+SELECT count(*) FROM test_trunc WHERE a = repeat('x', 100) || '7' AND b > 750;
+SELECT a = repeat('x', 100) || '42', b, c FROM test_trunc
+  WHERE a = repeat('x', 100) || '42' AND b = 4242 AND c = 4242;
+SELECT count(*) FROM test_trunc WHERE a > repeat('x', 100) || '48';
+RESET enable_seqscan;
+RESET enable_bitmapscan;
+
+DROP TABLE test_trunc;
+
+--
+-- Pivot tuples of an index with included columns carry key columns only.
+--
+CREATE TABLE test_include (a int, b text);
+CREATE INDEX test_include_idx ON test_include (a) INCLUDE (b);
+INSERT INTO test_include
+  SELECT i, repeat('y', 100) FROM generate_series(1, 2000) i;
+CREATE INDEX test_include_built_idx ON test_include (a) INCLUDE (b);
+
+SELECT count(*) > 10 AS many_pivots, bool_and(natts = 1) AS keys_only
+  FROM btree_pivots('test_include_idx');
+SELECT count(*) > 10 AS many_pivots, bool_and(natts = 1) AS keys_only
+  FROM btree_pivots('test_include_built_idx');
+SELECT bool_and(i.natts = 2) AS leaf_items_complete
+  FROM generate_series(1, (pg_relation_size('test_include_idx') /
+                           current_setting('block_size')::int)::int - 1) blk,
+       LATERAL bt_page_stats('test_include_idx', blk) s,
+       LATERAL bt_page_items('test_include_idx', blk) i
+  WHERE s.type = 'l' AND (s.btpo_next = 0 OR i.itemoffset > 1);
+
+DROP TABLE test_include;
+DROP FUNCTION btree_pivots(regclass);
@@ -0,0 +1,41 @@
+-- predictability
+SET synchronous_commit = on;
+-- smallest possible budget, so that a few rows already exceed it
+SET logical_decoding_work_mem = '64kB';
+
+DROP TABLE IF EXISTS stream_test;
+CREATE TABLE stream_test(id int, data text);
+
+SELECT 'init' FROM pg_create_logical_replication_slot('regression_slot', 'test_decoding');
+
+-- large committed transaction, streamed in several blocks
+BEGIN;
+INSERT INTO stream_test SELECT g.i, 'row ' || g.i FROM generate_series(1, 500) g(i);
+COMMIT;
+
+SELECT count(*) FILTER (WHERE data = 'streaming change for transaction') AS changes,
+	count(*) FILTER (WHERE data = 'opening a streamed block for transaction') > 1 AS blocks,
+	count(*) FILTER (WHERE data = 'committing streamed transaction') AS commits
+FROM pg_logical_slot_get_changes('regression_slot', NULL, NULL, 'include-xids', '0', 'skip-empty-xacts', '1', 'stream-changes', '1');
+
+-- large aborted transaction, what was streamed has to be discarded
+BEGIN;
+INSERT INTO stream_test SELECT g.i, 'row ' || g.i FROM generate_series(1, 500) g(i);
+ROLLBACK;
+
+SELECT count(*) FILTER (WHERE data = 'opening a streamed block for transaction') > 1 AS blocks,
+	count(*) FILTER (WHERE data = 'aborting streamed (sub)transaction') AS aborts,
+	count(*) FILTER (WHERE data = 'committing streamed transaction') AS commits
+FROM pg_logical_slot_get_changes('regression_slot', NULL, NULL, 'include-xids', '0', 'skip-empty-xacts', '1', 'stream-changes', '1');
+
+-- without streaming, the transaction is spilled to disk and decoded at commit
+BEGIN;
+INSERT INTO stream_test SELECT g.i, 'row ' || g.i FROM generate_series(1, 500) g(i);
+COMMIT;
+
+SELECT count(*) FILTER (WHERE data LIKE 'table public.stream_test: INSERT:%') AS inserts,
+	count(*) FILTER (WHERE data LIKE '%stream%block%') AS blocks
+FROM pg_logical_slot_get_changes('regression_slot', NULL, NULL, 'include-xids', '0', 'skip-empty-xacts', '1');
+
+SELECT pg_drop_replication_slot('regression_slot');
+DROP TABLE stream_test;
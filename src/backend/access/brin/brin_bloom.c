@@ -0,0 +1,391 @@
+/*
+ * brin_bloom.c
+ *		Implementation of Bloom opclass for BRIN
+ *
+ * The bloom opclass summarizes each page range with a bloom filter built
+ * from the hash values of the indexed column.  Unlike minmax, the summary
+ * does not depend on the values being correlated with their physical
+ * position in the table, so it is useful for equality lookups on columns
+ * whose values are scattered across the table; but it cannot support range
+ * queries, and it gives false positives at a rate depending on how many
+ * distinct values each page range contains.
+ *
+ * Each opclass must provide a hash support procedure (BLOOM_PROCNUM_HASH),
+ * which maps a value to a uint32 in a way consistent with the equality
+ * operator.  Hash opclass support procedures are suitable.
+ *
+ * The size of the filter is derived from the pages_per_range setting of the
+ * index, assuming a fixed number of distinct values per heap page and the
+ * false positive rate given by BLOOM_FALSE_POSITIVE_RATE, and it is capped so
+ * that summary tuples fit comfortably on an index page.  Every filter records
+ * its own size, so a filter built with different parameters (for instance
+ * after pages_per_range was changed) can still be interpreted correctly.
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/backend/access/brin/brin_bloom.c
+ */
+#include "postgres.h"
+
+#include <math.h>
+
+#include "access/brin.h"
+#include "access/brin_internal.h"
+#include "access/brin_tuple.h"
+#include "access/genam.h"
+#include "access/hash.h"
+#include "access/stratnum.h"
+#include "catalog/pg_type.h"
+#include "utils/rel.h"
+
+
+/*
+ * Additional SQL level support functions
+ *
+ * Procedure numbers must not use values reserved for BRIN itself; see
+ * brin_internal.h.  Numbers 11 to 14 are used by other opclasses for
+ * procedures with a different signature, so we use a separate number.
+ */
+#define		BLOOM_PROCNUM_HASH			15	/* required */
+
+/*
+ * Only the equality strategy is supported.
+ */
+#define		BloomEqualStrategyNumber	1
+
+/*
+ * Filter sizing parameters.  We assume a range contains about
+ * BLOOM_DISTINCT_PER_PAGE distinct values per heap page; the filter is never
+ * smaller than BLOOM_MIN_BYTES nor larger than BLOOM_MAX_BYTES.
+ */
+#define		BLOOM_DISTINCT_PER_PAGE		10
+#define		BLOOM_FALSE_POSITIVE_RATE	0.01
+#define		BLOOM_MIN_BYTES				64
+#define		BLOOM_MAX_BYTES				(BLCKSZ / 4)
+
+/*
+ * On-disk representation of the filter.  This is a varlena, stored as
+ * a bytea in the BRIN tuple.
+ */
+typedef struct BloomFilter
+{
+	int32		vl_len_;		/* varlena header (do not touch directly!) */
+	uint16		nhashes;		/* number of hash functions */
+	uint32		nbits;			/* number of bits in the bitmap */
+	uint8		bitmap[FLEXIBLE_ARRAY_MEMBER];
+} BloomFilter;
+
+#define BloomFilterSize(nbits) \
+	(offsetof(BloomFilter, bitmap) + ((nbits) + 7) / 8)
+
+typedef struct BloomOpaque
+{
+	FmgrInfo	hash_procinfo;
+} BloomOpaque;
+
+Datum		brin_bloom_opcinfo(PG_FUNCTION_ARGS);
+Datum		brin_bloom_add_value(PG_FUNCTION_ARGS);
+Datum		brin_bloom_consistent(PG_FUNCTION_ARGS);
+Datum		brin_bloom_union(PG_FUNCTION_ARGS);
+static BloomFilter *bloom_init(BlockNumber pagesPerRange);
+static bool bloom_add_hash(BloomFilter *filter, uint32 hash);
+static bool bloom_contains_hash(BloomFilter *filter, uint32 hash);
+static uint32 bloom_get_hash(BrinDesc *bdesc, uint16 attno, Oid colloid,
+			   Datum value);
+
+
+/*
+ * Create an empty filter sized for page ranges of the given size.
+ */
+static BloomFilter *
+bloom_init(BlockNumber pagesPerRange)
+{
+	BloomFilter *filter;
+	double		ndistinct;
+	double		nbits;
+	int			nbytes;
+	int			nhashes;
+
+	/*
+	 * Optimal filter size for n distinct values and false positive rate p is
+	 * m = -n ln(p) / (ln 2)^2 bits, using k = (m / n) ln 2 hash functions.
+	 */
+	ndistinct = (double) pagesPerRange * BLOOM_DISTINCT_PER_PAGE;
+	nbits = ceil(-(ndistinct * log(BLOOM_FALSE_POSITIVE_RATE)) /
+				 (log(2.0) * log(2.0)));
+
+	nbytes = (int) Min(nbits / 8 + 1, (double) BLOOM_MAX_BYTES);
+	nbytes = Max(nbytes, BLOOM_MIN_BYTES);
+	nbits = nbytes * 8;
+
+	nhashes = (int) rint(nbits / ndistinct * log(2.0));
+	nhashes = Max(nhashes, 1);
+	nhashes = Min(nhashes, 16);
+
+	filter = palloc0(BloomFilterSize(nbits));
+	SET_VARSIZE(filter, BloomFilterSize(nbits));
+	filter->nhashes = (uint16) nhashes;
+	filter->nbits = (uint32) nbits;
+
+	return filter;
+}
+
+/*
+ * Set the bits for the given hash value.  We derive the k probe positions by
+ * double hashing from the value's hash and a rehash of it, which is as good
+ * as k independent hash functions for our purposes.  Returns true if any bit
+ * was changed.
+ */
+static bool
+bloom_add_hash(BloomFilter *filter, uint32 hash)
+{
+	uint32		h1 = hash;
+	uint32		h2 = DatumGetUInt32(hash_uint32(hash)) | 1;
+	bool		updated = false;
+	int			i;
+
+	for (i = 0; i < filter->nhashes; i++)
+	{
+		uint32		bit = (h1 + i * h2) % filter->nbits;
+		uint8		mask = 1 << (bit % 8);
+
+		if (!(filter->bitmap[bit / 8] & mask))
+		{
+			filter->bitmap[bit / 8] |= mask;
+			updated = true;
+		}
+	}
+
+	return updated;
+}
+
+/*
+ * Check whether the filter might contain a value with the given hash.
+ */
+static bool
+bloom_contains_hash(BloomFilter *filter, uint32 hash)
+{
+	uint32		h1 = hash;
+	uint32		h2 = DatumGetUInt32(hash_uint32(hash)) | 1;
+	int			i;
+
+	for (i = 0; i < filter->nhashes; i++)
+	{
+		uint32		bit = (h1 + i * h2) % filter->nbits;
+
+		if (!(filter->bitmap[bit / 8] & (1 << (bit % 8))))
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Compute the hash of a value using the opclass' hash support procedure.
+ */
+static uint32
+bloom_get_hash(BrinDesc *bdesc, uint16 attno, Oid colloid, Datum value)
+{
+	BloomOpaque *opaque;
+
+	opaque = (BloomOpaque *) bdesc->bd_info[attno - 1]->oi_opaque;
+
+	if (opaque->hash_procinfo.fn_oid == InvalidOid)
+		fmgr_info_copy(&opaque->hash_procinfo,
+					   index_getprocinfo(bdesc->bd_index, attno,
+										 BLOOM_PROCNUM_HASH),
+					   bdesc->bd_context);
+
+	return DatumGetUInt32(FunctionCall1Coll(&opaque->hash_procinfo, colloid,
+											value));
+}
+
+/*
+ * BRIN bloom OpcInfo function
+ */
+Datum
+brin_bloom_opcinfo(PG_FUNCTION_ARGS)
+{
+	BrinOpcInfo *result;
+
+	/*
+	 * opaque->hash_procinfo is initialized lazily; here it is set to
+	 * uninitialized by palloc0 which sets fn_oid to InvalidOid.
+	 *
+	 * The filter is stored as a bytea regardless of the indexed type.
+	 */
+	result = palloc0(MAXALIGN(SizeofBrinOpcInfo(1)) + sizeof(BloomOpaque));
+	result->oi_nstored = 1;
+	result->oi_opaque = (BloomOpaque *)
+		MAXALIGN((char *) result + SizeofBrinOpcInfo(1));
+	result->oi_typcache[0] = lookup_type_cache(BYTEAOID, 0);
+
+	PG_RETURN_POINTER(result);
+}
+
+/*
+ * Add the hash of a new value to the filter of the page range.  Returns true
+ * if the filter was modified, false otherwise.
+ */
+Datum
+brin_bloom_add_value(PG_FUNCTION_ARGS)
+{
+	BrinDesc   *bdesc = (BrinDesc *) PG_GETARG_POINTER(0);
+	BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+	Datum		newval = PG_GETARG_DATUM(2);
+	bool		isnull = PG_GETARG_DATUM(3);
+	Oid			colloid = PG_GET_COLLATION();
+	BloomFilter *filter;
+	uint32		hash;
+	bool		updated = false;
+
+	/*
+	 * If the new value is null, we record that we saw it if it's the first
+	 * one; otherwise, there's nothing to do.
+	 */
+	if (isnull)
+	{
+		if (column->bv_hasnulls)
+			PG_RETURN_BOOL(false);
+
+		column->bv_hasnulls = true;
+		PG_RETURN_BOOL(true);
+	}
+
+	/* If the recorded value is null, start with an empty filter. */
+	if (column->bv_allnulls)
+	{
+		filter = bloom_init(BrinGetPagesPerRange(bdesc->bd_index));
+		column->bv_values[0] = PointerGetDatum(filter);
+		column->bv_allnulls = false;
+		updated = true;
+	}
+	else
+	{
+		/*
+		 * The value was copied into the tuple's memory context when it was
+		 * deformed, so we can modify it in place, unless it had a short
+		 * header and detoasting had to make a copy; in that case remember
+		 * the new copy.
+		 */
+		filter = (BloomFilter *) PG_DETOAST_DATUM(column->bv_values[0]);
+		column->bv_values[0] = PointerGetDatum(filter);
+	}
+
+	hash = bloom_get_hash(bdesc, column->bv_attno, colloid, newval);
+	updated |= bloom_add_hash(filter, hash);
+
+	PG_RETURN_BOOL(updated);
+}
+
+/*
+ * Given an index tuple corresponding to a certain page range and a scan key,
+ * return whether the scan key might match a value in the page range, based
+ * on the bloom filter.
+ */
+Datum
+brin_bloom_consistent(PG_FUNCTION_ARGS)
+{
+	BrinDesc   *bdesc = (BrinDesc *) PG_GETARG_POINTER(0);
+	BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+	ScanKey		key = (ScanKey) PG_GETARG_POINTER(2);
+	Oid			colloid = PG_GET_COLLATION();
+	BloomFilter *filter;
+	uint32		hash;
+
+	Assert(key->sk_attno == column->bv_attno);
+
+	/* handle IS NULL/IS NOT NULL tests */
+	if (key->sk_flags & SK_ISNULL)
+	{
+		if (key->sk_flags & SK_SEARCHNULL)
+		{
+			if (column->bv_allnulls || column->bv_hasnulls)
+				PG_RETURN_BOOL(true);
+			PG_RETURN_BOOL(false);
+		}
+
+		/*
+		 * For IS NOT NULL, we can only skip ranges that are known to have
+		 * only nulls.
+		 */
+		Assert(key->sk_flags & SK_SEARCHNOTNULL);
+		PG_RETURN_BOOL(!column->bv_allnulls);
+	}
+
+	/* if the range is all empty, it cannot possibly be consistent */
+	if (column->bv_allnulls)
+		PG_RETURN_BOOL(false);
+
+	if (key->sk_strategy != BloomEqualStrategyNumber)
+		elog(ERROR, "invalid strategy number %d", key->sk_strategy);
+
+	filter = (BloomFilter *) PG_DETOAST_DATUM(column->bv_values[0]);
+	hash = bloom_get_hash(bdesc, key->sk_attno, colloid, key->sk_argument);
+
+	PG_RETURN_BOOL(bloom_contains_hash(filter, hash));
+}
+
+/*
+ * Given two BrinValues, update the first of them as a union of the summary
+ * values contained in both.  The second one is untouched.
+ */
+Datum
+brin_bloom_union(PG_FUNCTION_ARGS)
+{
+	BrinValues *col_a = (BrinValues *) PG_GETARG_POINTER(1);
+	BrinValues *col_b = (BrinValues *) PG_GETARG_POINTER(2);
+	BloomFilter *filter_a;
+	BloomFilter *filter_b;
+
+	Assert(col_a->bv_attno == col_b->bv_attno);
+
+	/* Adjust "hasnulls" */
+	if (!col_a->bv_hasnulls && col_b->bv_hasnulls)
+		col_a->bv_hasnulls = true;
+
+	/* If there are no values in B, there's nothing left to do */
+	if (col_b->bv_allnulls)
+		PG_RETURN_VOID();
+
+	filter_b = (BloomFilter *) PG_DETOAST_DATUM(col_b->bv_values[0]);
+
+	/*
+	 * Adjust "allnulls".  If A doesn't have values, just copy the filter from
+	 * B into A, and we're done.
+	 */
+	if (col_a->bv_allnulls)
+	{
+		col_a->bv_allnulls = false;
+		col_a->bv_values[0] = PointerGetDatum(palloc(VARSIZE(filter_b)));
+		memcpy(DatumGetPointer(col_a->bv_values[0]), filter_b,
+			   VARSIZE(filter_b));
+		PG_RETURN_VOID();
+	}
+
+	filter_a = (BloomFilter *) PG_DETOAST_DATUM(col_a->bv_values[0]);
+	col_a->bv_values[0] = PointerGetDatum(filter_a);
+
+	if (filter_a->nbits == filter_b->nbits &&
+		filter_a->nhashes == filter_b->nhashes)
+	{
+		uint32		i;
+
+		for (i = 0; i < (filter_a->nbits + 7) / 8; i++)
+			filter_a->bitmap[i] |= filter_b->bitmap[i];
+	}
+	else
+	{
+		/*
+		 * The filters were built with different parameters, so they can't be
+		 * combined.  Settle for a filter that matches everything, which is
+		 * always correct, if useless; the range will get a proper summary
+		 * again when it's resummarized.
+		 */
+		memset(filter_a->bitmap, 0xFF, (filter_a->nbits + 7) / 8);
+	}
+
+	PG_RETURN_VOID();
+}
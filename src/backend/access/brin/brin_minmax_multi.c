@@ -0,0 +1,651 @@
+/*
+ * brin_minmax_multi.c
+ *		Implementation of multi-range Min/Max opclass for BRIN
+ *
+ * The plain minmax opclass summarizes a page range with a single [min, max]
+ * interval, which becomes useless as soon as the range contains a couple of
+ * outliers, or values from several distinct clusters.  This opclass instead
+ * keeps a small sorted list of disjoint intervals per page range.  A new
+ * value that isn't covered by any interval is added as a degenerate interval
+ * [v, v]; when that makes the list longer than MINMAX_MULTI_MAX_RANGES, the
+ * two adjacent intervals separated by the smallest gap are merged.  The gap
+ * is measured with a per-opclass distance support procedure, so that the
+ * summary adapts to the actual distribution of values in the range.
+ *
+ * The intervals are stored as an array of the indexed type, holding the
+ * lower and upper boundary of each interval in ascending order.
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/backend/access/brin/brin_minmax_multi.c
+ */
+#include "postgres.h"
+
+#include "access/genam.h"
+#include "access/brin_internal.h"
+#include "access/brin_tuple.h"
+#include "access/stratnum.h"
+#include "catalog/pg_amop.h"
+#include "catalog/pg_type.h"
+#include "utils/array.h"
+#include "utils/builtins.h"
+#include "utils/date.h"
+#include "utils/lsyscache.h"
+#include "utils/rel.h"
+#include "utils/syscache.h"
+#include "utils/timestamp.h"
+
+
+/*
+ * Additional SQL level support functions
+ *
+ * Procedure numbers must not use values reserved for BRIN itself; see
+ * brin_internal.h.
+ */
+#define		MINMAX_MULTI_PROCNUM_DISTANCE	11	/* required */
+
+/* maximum number of intervals kept for each page range */
+#define		MINMAX_MULTI_MAX_RANGES			16
+
+typedef struct MinmaxMultiOpaque
+{
+	FmgrInfo	distance_procinfo;
+	Oid			cached_subtype;
+	FmgrInfo	strategy_procinfos[BTMaxStrategyNumber];
+} MinmaxMultiOpaque;
+
+/*
+ * Deconstructed summary: nranges intervals, whose boundaries are
+ * values[2 * i] and values[2 * i + 1].
+ */
+typedef struct MinmaxMultiRanges
+{
+	int			nranges;
+	Datum	   *values;
+} MinmaxMultiRanges;
+
+/* state passed to range_cmp through qsort_arg */
+typedef struct MinmaxMultiSortState
+{
+	FmgrInfo   *ltfn;
+	Oid			colloid;
+} MinmaxMultiSortState;
+
+Datum		brin_minmax_multi_opcinfo(PG_FUNCTION_ARGS);
+Datum		brin_minmax_multi_add_value(PG_FUNCTION_ARGS);
+Datum		brin_minmax_multi_consistent(PG_FUNCTION_ARGS);
+Datum		brin_minmax_multi_union(PG_FUNCTION_ARGS);
+Datum		brin_minmax_multi_distance_int4(PG_FUNCTION_ARGS);
+Datum		brin_minmax_multi_distance_int8(PG_FUNCTION_ARGS);
+Datum		brin_minmax_multi_distance_float8(PG_FUNCTION_ARGS);
+Datum		brin_minmax_multi_distance_date(PG_FUNCTION_ARGS);
+Datum		brin_minmax_multi_distance_timestamp(PG_FUNCTION_ARGS);
+Datum		brin_minmax_multi_distance_timestamptz(PG_FUNCTION_ARGS);
+static MinmaxMultiRanges *ranges_deserialize(BrinDesc *bdesc, uint16 attno,
+				   Datum value);
+static Datum ranges_serialize(BrinDesc *bdesc, uint16 attno,
+				 MinmaxMultiRanges *ranges);
+static void ranges_reduce(BrinDesc *bdesc, uint16 attno, Oid colloid,
+			  MinmaxMultiRanges *ranges);
+static int	range_cmp(const void *a, const void *b, void *arg);
+static FmgrInfo *minmax_multi_get_strategy_procinfo(BrinDesc *bdesc,
+								   uint16 attno, Oid subtype,
+								   uint16 strategynum);
+
+
+Datum
+brin_minmax_multi_opcinfo(PG_FUNCTION_ARGS)
+{
+	Oid			typoid = PG_GETARG_OID(0);
+	Oid			arraytypoid = get_array_type(typoid);
+	BrinOpcInfo *result;
+
+	if (!OidIsValid(arraytypoid))
+		elog(ERROR, "could not find array type for data type %s",
+			 format_type_be(typoid));
+
+	/*
+	 * opaque->strategy_procinfos and distance_procinfo are initialized
+	 * lazily; here they are set to all-uninitialized by palloc0 which sets
+	 * fn_oid to InvalidOid.
+	 */
+	result = palloc0(MAXALIGN(SizeofBrinOpcInfo(1)) +
+					 sizeof(MinmaxMultiOpaque));
+	result->oi_nstored = 1;
+	result->oi_opaque = (MinmaxMultiOpaque *)
+		MAXALIGN((char *) result + SizeofBrinOpcInfo(1));
+	result->oi_typcache[0] = lookup_type_cache(arraytypoid, 0);
+
+	PG_RETURN_POINTER(result);
+}
+
+/*
+ * Examine the given index tuple (which contains partial status of a certain
+ * page range) by comparing it to the given value that comes from another heap
+ * tuple.  If the new value is not covered by any of the intervals in the
+ * summary, add it and return true.  Otherwise, return false and do not modify
+ * in this case.
+ */
+Datum
+brin_minmax_multi_add_value(PG_FUNCTION_ARGS)
+{
+	BrinDesc   *bdesc = (BrinDesc *) PG_GETARG_POINTER(0);
+	BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+	Datum		newval = PG_GETARG_DATUM(2);
+	bool		isnull = PG_GETARG_DATUM(3);
+	Oid			colloid = PG_GET_COLLATION();
+	AttrNumber	attno;
+	Form_pg_attribute attr;
+	MinmaxMultiRanges *ranges;
+	FmgrInfo   *ltfn;
+	Datum		olddatum;
+	int			lo,
+				hi;
+
+	/*
+	 * If the new value is null, we record that we saw it if it's the first
+	 * one; otherwise, there's nothing to do.
+	 */
+	if (isnull)
+	{
+		if (column->bv_hasnulls)
+			PG_RETURN_BOOL(false);
+
+		column->bv_hasnulls = true;
+		PG_RETURN_BOOL(true);
+	}
+
+	attno = column->bv_attno;
+	attr = bdesc->bd_tupdesc->attrs[attno - 1];
+
+	/*
+	 * If the recorded value is null, store the new value as a single
+	 * degenerate interval, and we're done.
+	 */
+	if (column->bv_allnulls)
+	{
+		ranges = palloc(sizeof(MinmaxMultiRanges));
+		ranges->nranges = 1;
+		ranges->values = palloc(sizeof(Datum) * 2);
+		ranges->values[0] = ranges->values[1] = newval;
+		column->bv_values[0] = ranges_serialize(bdesc, attno, ranges);
+		column->bv_allnulls = false;
+		PG_RETURN_BOOL(true);
+	}
+
+	ranges = ranges_deserialize(bdesc, attno, column->bv_values[0]);
+	ltfn = minmax_multi_get_strategy_procinfo(bdesc, attno, attr->atttypid,
+											  BTLessStrategyNumber);
+
+	/*
+	 * Binary search for the first interval whose upper boundary is not less
+	 * than the new value.  If its lower boundary isn't greater than the new
+	 * value either, the value is already covered.
+	 */
+	lo = 0;
+	hi = ranges->nranges;
+	while (lo < hi)
+	{
+		int			mid = (lo + hi) / 2;
+
+		if (DatumGetBool(FunctionCall2Coll(ltfn, colloid,
+										   ranges->values[2 * mid + 1],
+										   newval)))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo < ranges->nranges &&
+		!DatumGetBool(FunctionCall2Coll(ltfn, colloid,
+										newval, ranges->values[2 * lo])))
+		PG_RETURN_BOOL(false);
+
+	/* Not covered; insert it as a new interval before interval "lo". */
+	ranges->values = repalloc(ranges->values,
+							  sizeof(Datum) * 2 * (ranges->nranges + 1));
+	memmove(&ranges->values[2 * lo + 2], &ranges->values[2 * lo],
+			sizeof(Datum) * 2 * (ranges->nranges - lo));
+	ranges->values[2 * lo] = ranges->values[2 * lo + 1] = newval;
+	ranges->nranges++;
+
+	ranges_reduce(bdesc, attno, colloid, ranges);
+
+	/* the deconstructed values may point into the old array; free it last */
+	olddatum = column->bv_values[0];
+	column->bv_values[0] = ranges_serialize(bdesc, attno, ranges);
+	pfree(DatumGetPointer(olddatum));
+
+	PG_RETURN_BOOL(true);
+}
+
+/*
+ * Given an index tuple corresponding to a certain page range and a scan key,
+ * return whether the scan key is consistent with the intervals in the
+ * summary.  Return true if so, false otherwise.
+ */
+Datum
+brin_minmax_multi_consistent(PG_FUNCTION_ARGS)
+{
+	BrinDesc   *bdesc = (BrinDesc *) PG_GETARG_POINTER(0);
+	BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+	ScanKey		key = (ScanKey) PG_GETARG_POINTER(2);
+	Oid			colloid = PG_GET_COLLATION(),
+				subtype;
+	AttrNumber	attno;
+	Datum		value;
+	Datum		matches;
+	FmgrInfo   *finfo;
+	MinmaxMultiRanges *ranges;
+	int			i;
+
+	Assert(key->sk_attno == column->bv_attno);
+
+	/* handle IS NULL/IS NOT NULL tests */
+	if (key->sk_flags & SK_ISNULL)
+	{
+		if (key->sk_flags & SK_SEARCHNULL)
+		{
+			if (column->bv_allnulls || column->bv_hasnulls)
+				PG_RETURN_BOOL(true);
+			PG_RETURN_BOOL(false);
+		}
+
+		/*
+		 * For IS NOT NULL, we can only skip ranges that are known to have
+		 * only nulls.
+		 */
+		Assert(key->sk_flags & SK_SEARCHNOTNULL);
+		PG_RETURN_BOOL(!column->bv_allnulls);
+	}
+
+	/* if the range is all empty, it cannot possibly be consistent */
+	if (column->bv_allnulls)
+		PG_RETURN_BOOL(false);
+
+	attno = key->sk_attno;
+	subtype = key->sk_subtype;
+	value = key->sk_argument;
+	ranges = ranges_deserialize(bdesc, attno, column->bv_values[0]);
+
+	switch (key->sk_strategy)
+	{
+		case BTLessStrategyNumber:
+		case BTLessEqualStrategyNumber:
+			/* only the overall minimum matters */
+			finfo = minmax_multi_get_strategy_procinfo(bdesc, attno, subtype,
+													   key->sk_strategy);
+			matches = FunctionCall2Coll(finfo, colloid, ranges->values[0],
+										value);
+			break;
+		case BTEqualStrategyNumber:
+
+			/*
+			 * In the equality case (WHERE col = someval), we want to return
+			 * the current page range if any of the intervals contains the
+			 * scan key.
+			 */
+			matches = BoolGetDatum(false);
+			for (i = 0; i < ranges->nranges; i++)
+			{
+				finfo = minmax_multi_get_strategy_procinfo(bdesc, attno,
+														   subtype,
+												  BTLessEqualStrategyNumber);
+				if (!DatumGetBool(FunctionCall2Coll(finfo, colloid,
+													ranges->values[2 * i],
+													value)))
+					break;		/* this and all later intervals are above */
+
+				finfo = minmax_multi_get_strategy_procinfo(bdesc, attno,
+														   subtype,
+											   BTGreaterEqualStrategyNumber);
+				if (DatumGetBool(FunctionCall2Coll(finfo, colloid,
+												   ranges->values[2 * i + 1],
+												   value)))
+				{
+					matches = BoolGetDatum(true);
+					break;
+				}
+			}
+			break;
+		case BTGreaterEqualStrategyNumber:
+		case BTGreaterStrategyNumber:
+			/* only the overall maximum matters */
+			finfo = minmax_multi_get_strategy_procinfo(bdesc, attno, subtype,
+													   key->sk_strategy);
+			matches = FunctionCall2Coll(finfo, colloid,
+								ranges->values[2 * ranges->nranges - 1],
+										value);
+			break;
+		default:
+			/* shouldn't happen */
+			elog(ERROR, "invalid strategy number %d", key->sk_strategy);
+			matches = 0;
+			break;
+	}
+
+	PG_RETURN_DATUM(matches);
+}
+
+/*
+ * Given two BrinValues, update the first of them as a union of the summary
+ * values contained in both.  The second one is untouched.
+ */
+Datum
+brin_minmax_multi_union(PG_FUNCTION_ARGS)
+{
+	BrinDesc   *bdesc = (BrinDesc *) PG_GETARG_POINTER(0);
+	BrinValues *col_a = (BrinValues *) PG_GETARG_POINTER(1);
+	BrinValues *col_b = (BrinValues *) PG_GETARG_POINTER(2);
+	Oid			colloid = PG_GET_COLLATION();
+	AttrNumber	attno;
+	Form_pg_attribute attr;
+	MinmaxMultiRanges *ranges_a;
+	MinmaxMultiRanges *ranges_b;
+	MinmaxMultiRanges *merged;
+	MinmaxMultiSortState sortstate;
+	FmgrInfo   *ltfn;
+	int			i,
+				n;
+
+	Assert(col_a->bv_attno == col_b->bv_attno);
+
+	/* Adjust "hasnulls" */
+	if (!col_a->bv_hasnulls && col_b->bv_hasnulls)
+		col_a->bv_hasnulls = true;
+
+	/* If there are no values in B, there's nothing left to do */
+	if (col_b->bv_allnulls)
+		PG_RETURN_VOID();
+
+	attno = col_a->bv_attno;
+	attr = bdesc->bd_tupdesc->attrs[attno - 1];
+
+	/*
+	 * Adjust "allnulls".  If A doesn't have values, just copy the values from
+	 * B into A, and we're done.  Note we already established that B contains
+	 * values.
+	 */
+	if (col_a->bv_allnulls)
+	{
+		ranges_b = ranges_deserialize(bdesc, attno, col_b->bv_values[0]);
+		col_a->bv_allnulls = false;
+		col_a->bv_values[0] = ranges_serialize(bdesc, attno, ranges_b);
+		PG_RETURN_VOID();
+	}
+
+	ranges_a = ranges_deserialize(bdesc, attno, col_a->bv_values[0]);
+	ranges_b = ranges_deserialize(bdesc, attno, col_b->bv_values[0]);
+
+	/* Put all the intervals together, sorted by their lower boundary ... */
+	merged = palloc(sizeof(MinmaxMultiRanges));
+	merged->nranges = ranges_a->nranges + ranges_b->nranges;
+	merged->values = palloc(sizeof(Datum) * 2 * merged->nranges);
+	memcpy(merged->values, ranges_a->values,
+		   sizeof(Datum) * 2 * ranges_a->nranges);
+	memcpy(&merged->values[2 * ranges_a->nranges], ranges_b->values,
+		   sizeof(Datum) * 2 * ranges_b->nranges);
+
+	ltfn = minmax_multi_get_strategy_procinfo(bdesc, attno, attr->atttypid,
+											  BTLessStrategyNumber);
+	sortstate.ltfn = ltfn;
+	sortstate.colloid = colloid;
+	qsort_arg(merged->values, merged->nranges, sizeof(Datum) * 2,
+			  range_cmp, &sortstate);
+
+	/* ... then coalesce the ones that overlap ... */
+	n = 0;
+	for (i = 1; i < merged->nranges; i++)
+	{
+		Datum	   *cur = &merged->values[2 * n];
+		Datum	   *next = &merged->values[2 * i];
+
+		if (!DatumGetBool(FunctionCall2Coll(ltfn, colloid, cur[1], next[0])))
+		{
+			if (DatumGetBool(FunctionCall2Coll(ltfn, colloid, cur[1], next[1])))
+				cur[1] = next[1];
+		}
+		else
+		{
+			n++;
+			merged->values[2 * n] = next[0];
+			merged->values[2 * n + 1] = next[1];
+		}
+	}
+	merged->nranges = n + 1;
+
+	/* ... and get rid of the smallest gaps until we're within limits. */
+	ranges_reduce(bdesc, attno, colloid, merged);
+
+	col_a->bv_values[0] = ranges_serialize(bdesc, attno, merged);
+
+	PG_RETURN_VOID();
+}
+
+/*
+ * Compute the distance between two values of the same type.  These are
+ * used to choose which intervals to merge; they don't need to be exact, only
+ * monotonic with respect to the sort order of the type.
+ */
+Datum
+brin_minmax_multi_distance_int4(PG_FUNCTION_ARGS)
+{
+	int32		a = PG_GETARG_INT32(0);
+	int32		b = PG_GETARG_INT32(1);
+
+	PG_RETURN_FLOAT8((float8) b - (float8) a);
+}
+
+Datum
+brin_minmax_multi_distance_int8(PG_FUNCTION_ARGS)
+{
+	int64		a = PG_GETARG_INT64(0);
+	int64		b = PG_GETARG_INT64(1);
+
+	PG_RETURN_FLOAT8((float8) b - (float8) a);
+}
+
+Datum
+brin_minmax_multi_distance_float8(PG_FUNCTION_ARGS)
+{
+	float8		a = PG_GETARG_FLOAT8(0);
+	float8		b = PG_GETARG_FLOAT8(1);
+
+	PG_RETURN_FLOAT8(b - a);
+}
+
+Datum
+brin_minmax_multi_distance_date(PG_FUNCTION_ARGS)
+{
+	DateADT		a = PG_GETARG_DATEADT(0);
+	DateADT		b = PG_GETARG_DATEADT(1);
+
+	PG_RETURN_FLOAT8((float8) b - (float8) a);
+}
+
+Datum
+brin_minmax_multi_distance_timestamp(PG_FUNCTION_ARGS)
+{
+	Timestamp	a = PG_GETARG_TIMESTAMP(0);
+	Timestamp	b = PG_GETARG_TIMESTAMP(1);
+
+	PG_RETURN_FLOAT8((float8) b - (float8) a);
+}
+
+Datum
+brin_minmax_multi_distance_timestamptz(PG_FUNCTION_ARGS)
+{
+	TimestampTz a = PG_GETARG_TIMESTAMPTZ(0);
+	TimestampTz b = PG_GETARG_TIMESTAMPTZ(1);
+
+	PG_RETURN_FLOAT8((float8) b - (float8) a);
+}
+
+/*
+ * Convert the stored array into a MinmaxMultiRanges.  The values point into
+ * the array, which must therefore not be freed while they're in use.
+ */
+static MinmaxMultiRanges *
+ranges_deserialize(BrinDesc *bdesc, uint16 attno, Datum value)
+{
+	Form_pg_attribute attr = bdesc->bd_tupdesc->attrs[attno - 1];
+	ArrayType  *arr = DatumGetArrayTypeP(value);
+	MinmaxMultiRanges *ranges;
+	int			nelems;
+
+	ranges = palloc(sizeof(MinmaxMultiRanges));
+	deconstruct_array(arr, attr->atttypid, attr->attlen, attr->attbyval,
+					  attr->attalign, &ranges->values, NULL, &nelems);
+	Assert(nelems > 0 && nelems % 2 == 0);
+	ranges->nranges = nelems / 2;
+
+	return ranges;
+}
+
+/*
+ * Build the array to be stored in the index tuple.
+ */
+static Datum
+ranges_serialize(BrinDesc *bdesc, uint16 attno, MinmaxMultiRanges *ranges)
+{
+	Form_pg_attribute attr = bdesc->bd_tupdesc->attrs[attno - 1];
+	ArrayType  *arr;
+
+	arr = construct_array(ranges->values, 2 * ranges->nranges,
+						  attr->atttypid, attr->attlen, attr->attbyval,
+						  attr->attalign);
+
+	return PointerGetDatum(arr);
+}
+
+/*
+ * Merge adjacent intervals, closest first, until no more than
+ * MINMAX_MULTI_MAX_RANGES remain.  The intervals must be sorted and disjoint.
+ */
+static void
+ranges_reduce(BrinDesc *bdesc, uint16 attno, Oid colloid,
+			  MinmaxMultiRanges *ranges)
+{
+	MinmaxMultiOpaque *opaque;
+	FmgrInfo   *distfn;
+
+	if (ranges->nranges <= MINMAX_MULTI_MAX_RANGES)
+		return;
+
+	opaque = (MinmaxMultiOpaque *) bdesc->bd_info[attno - 1]->oi_opaque;
+	if (opaque->distance_procinfo.fn_oid == InvalidOid)
+		fmgr_info_copy(&opaque->distance_procinfo,
+					   index_getprocinfo(bdesc->bd_index, attno,
+										 MINMAX_MULTI_PROCNUM_DISTANCE),
+					   bdesc->bd_context);
+	distfn = &opaque->distance_procinfo;
+
+	while (ranges->nranges > MINMAX_MULTI_MAX_RANGES)
+	{
+		int			best = 0;
+		float8		bestdist = 0;
+		int			i;
+
+		for (i = 0; i < ranges->nranges - 1; i++)
+		{
+			float8		dist;
+
+			dist = DatumGetFloat8(FunctionCall2Coll(distfn, colloid,
+												ranges->values[2 * i + 1],
+												ranges->values[2 * i + 2]));
+			if (i == 0 || dist < bestdist)
+			{
+				best = i;
+				bestdist = dist;
+			}
+		}
+
+		/* merge interval "best" with the following one */
+		ranges->values[2 * best + 1] = ranges->values[2 * best + 3];
+		memmove(&ranges->values[2 * best + 2], &ranges->values[2 * best + 4],
+				sizeof(Datum) * 2 * (ranges->nranges - best - 2));
+		ranges->nranges--;
+	}
+}
+
+/*
+ * qsort_arg comparator sorting intervals by lower boundary
+ */
+static int
+range_cmp(const void *a, const void *b, void *arg)
+{
+	Datum		da = *(const Datum *) a;
+	Datum		db = *(const Datum *) b;
+	MinmaxMultiSortState *state = (MinmaxMultiSortState *) arg;
+
+	if (DatumGetBool(FunctionCall2Coll(state->ltfn, state->colloid, da, db)))
+		return -1;
+	if (DatumGetBool(FunctionCall2Coll(state->ltfn, state->colloid, db, da)))
+		return 1;
+	return 0;
+}
+
+/*
+ * Cache and return the procedure for the given strategy.
+ *
+ * Note: this function mirrors minmax_get_strategy_procinfo; see notes there.
+ * If changes are made here, see that function too.
+ */
+static FmgrInfo *
+minmax_multi_get_strategy_procinfo(BrinDesc *bdesc, uint16 attno, Oid subtype,
+								   uint16 strategynum)
+{
+	MinmaxMultiOpaque *opaque;
+
+	Assert(strategynum >= 1 &&
+		   strategynum <= BTMaxStrategyNumber);
+
+	opaque = (MinmaxMultiOpaque *) bdesc->bd_info[attno - 1]->oi_opaque;
+
+	/*
+	 * We cache the procedures for the previous subtype in the opaque struct,
+	 * to avoid repetitive syscache lookups.  If the subtype changed,
+	 * invalidate all the cached entries.
+	 */
+	if (opaque->cached_subtype != subtype)
+	{
+		uint16		i;
+
+		for (i = 1; i <= BTMaxStrategyNumber; i++)
+			opaque->strategy_procinfos[i - 1].fn_oid = InvalidOid;
+		opaque->cached_subtype = subtype;
+	}
+
+	if (opaque->strategy_procinfos[strategynum - 1].fn_oid == InvalidOid)
+	{
+		Form_pg_attribute attr;
+		HeapTuple	tuple;
+		Oid			opfamily,
+					oprid;
+		bool		isNull;
+
+		opfamily = bdesc->bd_index->rd_opfamily[attno - 1];
+		attr = bdesc->bd_tupdesc->attrs[attno - 1];
+		tuple = SearchSysCache4(AMOPSTRATEGY, ObjectIdGetDatum(opfamily),
+								ObjectIdGetDatum(attr->atttypid),
+								ObjectIdGetDatum(subtype),
+								Int16GetDatum(strategynum));
+
+		if (!HeapTupleIsValid(tuple))
+			elog(ERROR, "missing operator %d(%u,%u) in opfamily %u",
+				 strategynum, attr->atttypid, subtype, opfamily);
+
+		oprid = DatumGetObjectId(SysCacheGetAttr(AMOPSTRATEGY, tuple,
+											 Anum_pg_amop_amopopr, &isNull));
+		ReleaseSysCache(tuple);
+		Assert(!isNull && RegProcedureIsValid(oprid));
+
+		fmgr_info_cxt(get_opcode(oprid),
+					  &opaque->strategy_procinfos[strategynum - 1],
+					  bdesc->bd_context);
+	}
+
+	return &opaque->strategy_procinfos[strategynum - 1];
+}
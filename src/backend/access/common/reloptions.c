@@ -77,6 +77,22 @@ static relopt_bool boolRelOpts[] =
 		},
 		true
 	},
+	{
+		{
+			"deferred_cleanup",
+			"Leaves pending list cleanup of this GIN index to autovacuum",
+			RELOPT_KIND_GIN
+		},
+		false
+	},
+	{
+		{
+			"autosummarize",
+			"Enables automatic summarization on this BRIN index",
+			RELOPT_KIND_BRIN
+		},
+		false
+	},
 	{
 		{
 			"security_barrier",
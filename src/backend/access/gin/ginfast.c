@@ -6,6 +6,9 @@
  *	  (typically during VACUUM), ginInsertCleanup() will be invoked to
  *	  transfer pending entries into the regular index structure.  This
  *	  wins because bulk insertion is much more efficient than retail.
+ *	  If the list grows beyond gin_pending_list_limit, it is cleaned up
+ *	  by the inserting backend, or by an autovacuum worker if the index
+ *	  has deferred_cleanup set.
  *
  * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
  * Portions Copyright (c) 1994, Regents of the University of California
@@ -20,8 +23,14 @@
 
 #include "access/gin_private.h"
 #include "access/xloginsert.h"
+#include "access/xlog.h"
+#include "catalog/pg_am.h"
 #include "commands/vacuum.h"
 #include "miscadmin.h"
+#include "postmaster/autovacuum.h"
+#include "storage/lmgr.h"
+#include "utils/acl.h"
+#include "utils/builtins.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
 
@@ -432,8 +441,22 @@ ginHeapTupleFastInsert(GinState *ginstate, GinTupleCollector *collector)
 
 	END_CRIT_SECTION();
 
+	/*
+	 * If the index asks for deferred cleanup, hand the job to autovacuum so
+	 * that this insertion doesn't have to wait for it.  We still do it
+	 * ourselves if autovacuum isn't running or can't take the request, so
+	 * that the pending list can't grow without bound.
+	 */
+	if (needCleanup && GinGetDeferredCleanup(index) && AutoVacuumingActive())
+	{
+		if (AutoVacuumRequestWork(AVW_GINCleanPendingList,
+								  RelationGetRelid(index),
+								  InvalidBlockNumber))
+			needCleanup = false;
+	}
+
 	if (needCleanup)
-		ginInsertCleanup(ginstate, false, NULL);
+		ginInsertCleanup(ginstate, false, false, NULL);
 }
 
 /*
@@ -712,25 +735,31 @@ processPendingPage(BuildAccumulator *accum, KeyArray *ka,
 /*
  * Move tuples from pending pages into regular GIN structure.
  *
- * This can be called concurrently by multiple backends, so it must cope.
- * On first glance it looks completely not concurrent-safe and not crash-safe
- * either.  The reason it's okay is that multiple insertion of the same entry
- * is detected and treated as a no-op by gininsert.c.  If we crash after
- * posting entries to the main index and before removing them from the
- * pending list, it's okay because when we redo the posting later on, nothing
- * bad will happen.  Likewise, if two backends simultaneously try to post
- * a pending entry into the main index, one will succeed and one will do
- * nothing.  We try to notice when someone else is a little bit ahead of
- * us in the process, but that's just to avoid wasting cycles.  Only the
- * action of removing a page from the pending list really needs exclusive
- * lock.
+ * On first glance this looks completely not crash-safe.  The reason it's
+ * okay is that multiple insertion of the same entry is detected and treated
+ * as a no-op by gininsert.c.  If we crash after posting entries to the main
+ * index and before removing them from the pending list, it's okay because
+ * when we redo the posting later on, nothing bad will happen.
+ *
+ * Only one backend cleans up the pending list of an index at a time; this is
+ * enforced by a heavyweight lock on the metapage.  Inserters never wait for
+ * that lock: if somebody else is already cleaning up, the list will be dealt
+ * with without our help.  Unless full_clean is set, we also stop once we've
+ * processed the pages that were in the list when we started, rather than
+ * chasing concurrent inserters indefinitely.  Concurrent insertions into the
+ * pending list are not blocked while we work, except briefly while pages are
+ * removed from its head.
+ *
+ * full_clean is used by VACUUM and gin_clean_pending_list(), which want an
+ * empty pending list when they're done: wait for a concurrent cleanup to
+ * finish, and clean up until the list is empty.
  *
  * vac_delay indicates that ginInsertCleanup is called from vacuum process,
  * so call vacuum_delay_point() periodically.
  * If stats isn't null, we count deleted pending pages into the counts.
  */
 void
-ginInsertCleanup(GinState *ginstate,
+ginInsertCleanup(GinState *ginstate, bool full_clean,
 				 bool vac_delay, IndexBulkDeleteResult *stats)
 {
 	Relation	index = ginstate->index;
@@ -743,7 +772,27 @@ ginInsertCleanup(GinState *ginstate,
 				oldCtx;
 	BuildAccumulator accum;
 	KeyArray	datums;
-	BlockNumber blkno;
+	BlockNumber blkno,
+				blknoFinish;
+	bool		cleanupFinish = false;
+	long		workMemory;
+
+	/*
+	 * Foreground cleanup runs in the context of an ordinary insertion, so
+	 * don't let it use more than work_mem.  Vacuum is allowed to use the same
+	 * amount of memory it uses for its other work.
+	 */
+	if (!vac_delay)
+		workMemory = work_mem;
+	else if (IsAutoVacuumWorkerProcess() && autovacuum_work_mem != -1)
+		workMemory = autovacuum_work_mem;
+	else
+		workMemory = maintenance_work_mem;
+
+	if (full_clean)
+		LockPage(index, GIN_METAPAGE_BLKNO, ExclusiveLock);
+	else if (!ConditionalLockPage(index, GIN_METAPAGE_BLKNO, ExclusiveLock))
+		return;
 
 	metabuffer = ReadBuffer(index, GIN_METAPAGE_BLKNO);
 	LockBuffer(metabuffer, GIN_SHARE);
@@ -754,9 +803,16 @@ ginInsertCleanup(GinState *ginstate,
 	{
 		/* Nothing to do */
 		UnlockReleaseBuffer(metabuffer);
+		UnlockPage(index, GIN_METAPAGE_BLKNO, ExclusiveLock);
 		return;
 	}
 
+	/*
+	 * Remember the current tail page, so that we know when to stop if we're
+	 * not asked for a full clean.
+	 */
+	blknoFinish = metadata->tail;
+
 	/*
 	 * Read and lock head of pending list
 	 */
@@ -789,12 +845,16 @@ ginInsertCleanup(GinState *ginstate,
 	 */
 	for (;;)
 	{
-		if (GinPageIsDeleted(page))
-		{
-			/* another cleanup process is running concurrently */
-			UnlockReleaseBuffer(buffer);
-			break;
-		}
+		/* we hold the cleanup lock, so nobody else can delete pages */
+		Assert(!GinPageIsDeleted(page));
+
+		/*
+		 * Are we at the page that was the tail when we started?  Unless
+		 * asked for a full clean, we stop after it; anything beyond it was
+		 * added after we started and can be left for the next cleanup.
+		 */
+		if (blkno == blknoFinish && !full_clean)
+			cleanupFinish = true;
 
 		/*
 		 * read page's datums into accum
@@ -807,14 +867,12 @@ ginInsertCleanup(GinState *ginstate,
 		/*
 		 * Is it time to flush memory to disk?	Flush if we are at the end of
 		 * the pending list, or if we have a full row and memory is getting
-		 * full.
-		 *
-		 * XXX using up maintenance_work_mem here is probably unreasonably
-		 * much, since vacuum might already be using that much.
+		 * full or we have reached the point where we stop.
 		 */
 		if (GinPageGetOpaque(page)->rightlink == InvalidBlockNumber ||
 			(GinPageHasFullRow(page) &&
-			 (accum.allocatedMemory >= maintenance_work_mem * 1024L)))
+			 (cleanupFinish ||
+			  accum.allocatedMemory >= workMemory * 1024L)))
 		{
 			ItemPointerData *list;
 			uint32		nlist;
@@ -852,13 +910,7 @@ ginInsertCleanup(GinState *ginstate,
 			LockBuffer(metabuffer, GIN_EXCLUSIVE);
 			LockBuffer(buffer, GIN_SHARE);
 
-			if (GinPageIsDeleted(page))
-			{
-				/* another cleanup process is running concurrently */
-				UnlockReleaseBuffer(buffer);
-				LockBuffer(metabuffer, GIN_UNLOCK);
-				break;
-			}
+			Assert(!GinPageIsDeleted(page));
 
 			/*
 			 * While we left the page unlocked, more stuff might have gotten
@@ -893,18 +945,20 @@ ginInsertCleanup(GinState *ginstate,
 			 */
 			if (shiftList(index, metabuffer, blkno, stats))
 			{
-				/* another cleanup process is running concurrently */
+				/* can't happen while we hold the cleanup lock */
 				LockBuffer(metabuffer, GIN_UNLOCK);
-				break;
+				elog(ERROR, "pending list of GIN index \"%s\" was concurrently modified",
+					 RelationGetRelationName(index));
 			}
 
 			Assert(blkno == metadata->head);
 			LockBuffer(metabuffer, GIN_UNLOCK);
 
 			/*
-			 * if we removed the whole pending list just exit
+			 * if we removed the whole pending list, or we have processed
+			 * everything that was there when we started, just exit
 			 */
-			if (blkno == InvalidBlockNumber)
+			if (blkno == InvalidBlockNumber || cleanupFinish)
 				break;
 
 			/*
@@ -930,8 +984,58 @@ ginInsertCleanup(GinState *ginstate,
 	}
 
 	ReleaseBuffer(metabuffer);
+	UnlockPage(index, GIN_METAPAGE_BLKNO, ExclusiveLock);
 
 	/* Clean up temporary space */
 	MemoryContextSwitchTo(oldCtx);
 	MemoryContextDelete(opCtx);
 }
+
+/*
+ * SQL-callable function to clean the insert pending list
+ */
+Datum
+gin_clean_pending_list(PG_FUNCTION_ARGS)
+{
+	Oid			indexoid = PG_GETARG_OID(0);
+	Relation	indexRel = index_open(indexoid, RowExclusiveLock);
+	IndexBulkDeleteResult stats;
+	GinState	ginstate;
+
+	if (RecoveryInProgress())
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("recovery is in progress"),
+		 errhint("GIN pending list cannot be cleaned up during recovery.")));
+
+	/* Must be a GIN index */
+	if (indexRel->rd_rel->relkind != RELKIND_INDEX ||
+		indexRel->rd_rel->relam != GIN_AM_OID)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("\"%s\" is not a GIN index",
+						RelationGetRelationName(indexRel))));
+
+	/*
+	 * Reject attempts to read non-local temporary relations; we would be
+	 * likely to get wrong data since we have no visibility into the owning
+	 * session's local buffers.
+	 */
+	if (RELATION_IS_OTHER_TEMP(indexRel))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			   errmsg("cannot access temporary indexes of other sessions")));
+
+	/* User must own the index (comparable to privileges needed for VACUUM) */
+	if (!pg_class_ownercheck(indexoid, GetUserId()))
+		aclcheck_error(ACLCHECK_NOT_OWNER, ACL_KIND_CLASS,
+					   RelationGetRelationName(indexRel));
+
+	memset(&stats, 0, sizeof(stats));
+	initGinState(&ginstate, indexRel);
+	ginInsertCleanup(&ginstate, true, true, &stats);
+
+	index_close(indexRel, RowExclusiveLock);
+
+	PG_RETURN_INT64((int64) stats.pages_deleted);
+}
@@ -527,7 +527,9 @@ ginoptions(PG_FUNCTION_ARGS)
 	static const relopt_parse_elt tab[] = {
 		{"fastupdate", RELOPT_TYPE_BOOL, offsetof(GinOptions, useFastUpdate)},
 		{"gin_pending_list_limit", RELOPT_TYPE_INT, offsetof(GinOptions,
-													 pendingListCleanupSize)}
+													 pendingListCleanupSize)},
+		{"deferred_cleanup", RELOPT_TYPE_BOOL, offsetof(GinOptions,
+														deferredCleanup)}
 	};
 
 	options = parseRelOptions(reloptions, validate, RELOPT_KIND_GIN,
@@ -275,7 +275,17 @@ btgettuple(PG_FUNCTION_ARGS)
 		_bt_start_array_keys(scan, dir);
 	}
 
-	/* This loop handles advancing to the next array elements, if any */
+	/* Likewise, a skip scan starts at the first leading-column value */
+	if (so->skipScan && !BTScanPosIsValid(so->currPos))
+	{
+		if (!_bt_start_skip_keys(scan, dir))
+			PG_RETURN_BOOL(false);
+	}
+
+	/*
+	 * This loop handles advancing to the next array elements or skip
+	 * prefix, if any
+	 */
 	do
 	{
 		/*
@@ -317,8 +327,9 @@ btgettuple(PG_FUNCTION_ARGS)
 		/* If we have a tuple, return it ... */
 		if (res)
 			break;
-		/* ... otherwise see if we have more array keys to deal with */
-	} while (so->numArrayKeys && _bt_advance_array_keys(scan, dir));
+		/* ... otherwise see if we have more array keys or prefixes */
+	} while ((so->numArrayKeys && _bt_advance_array_keys(scan, dir)) ||
+			 (so->skipScan && _bt_advance_skip_keys(scan, dir)));
 
 	PG_RETURN_BOOL(res);
 }
@@ -347,7 +358,17 @@ btgetbitmap(PG_FUNCTION_ARGS)
 		_bt_start_array_keys(scan, ForwardScanDirection);
 	}
 
-	/* This loop handles advancing to the next array elements, if any */
+	/* Likewise, find the first leading-column value for a skip scan */
+	if (so->skipScan)
+	{
+		if (!_bt_start_skip_keys(scan, ForwardScanDirection))
+			PG_RETURN_INT64(ntids);
+	}
+
+	/*
+	 * This loop handles advancing to the next array elements or skip
+	 * prefix, if any
+	 */
 	do
 	{
 		/* Fetch the first page & tuple */
@@ -377,8 +398,11 @@ btgetbitmap(PG_FUNCTION_ARGS)
 				ntids++;
 			}
 		}
-		/* Now see if we have more array keys to deal with */
-	} while (so->numArrayKeys && _bt_advance_array_keys(scan, ForwardScanDirection));
+		/* Now see if we have more array keys or prefixes to deal with */
+	} while ((so->numArrayKeys &&
+			  _bt_advance_array_keys(scan, ForwardScanDirection)) ||
+			 (so->skipScan &&
+			  _bt_advance_skip_keys(scan, ForwardScanDirection)));
 
 	PG_RETURN_INT64(ntids);
 }
@@ -405,8 +429,10 @@ btbeginscan(PG_FUNCTION_ARGS)
 	so = (BTScanOpaque) palloc(sizeof(BTScanOpaqueData));
 	BTScanPosInvalidate(so->currPos);
 	BTScanPosInvalidate(so->markPos);
+	/* leave room for the extra leading-column key of a skip scan */
 	if (scan->numberOfKeys > 0)
-		so->keyData = (ScanKey) palloc(scan->numberOfKeys * sizeof(ScanKeyData));
+		so->keyData = (ScanKey) palloc((scan->numberOfKeys + 1) *
+									   sizeof(ScanKeyData));
 	else
 		so->keyData = NULL;
 
@@ -415,6 +441,12 @@ btbeginscan(PG_FUNCTION_ARGS)
 	so->arrayKeys = NULL;
 	so->arrayContext = NULL;
 
+	so->skipScan = false;		/* decided in btrescan */
+	so->skipKeyData = NULL;
+	so->skipPrefixValid = false;
+	so->markSkipValid = false;
+	so->skipContext = NULL;
+
 	so->killedItems = NULL;		/* until needed */
 	so->numKilled = 0;
 
@@ -493,6 +525,9 @@ btrescan(PG_FUNCTION_ARGS)
 	/* If any keys are SK_SEARCHARRAY type, set up array-key info */
 	_bt_preprocess_array_keys(scan);
 
+	/* Set up for a skip scan, if the caller asked for one */
+	_bt_preprocess_skip_keys(scan);
+
 	PG_RETURN_VOID();
 }
 
@@ -525,6 +560,9 @@ btendscan(PG_FUNCTION_ARGS)
 	/* so->arrayKeyData and so->arrayKeys are in arrayContext */
 	if (so->arrayContext != NULL)
 		MemoryContextDelete(so->arrayContext);
+	/* so->skipKeyData and prefix values are in skipContext */
+	if (so->skipContext != NULL)
+		MemoryContextDelete(so->skipContext);
 	if (so->killedItems != NULL)
 		pfree(so->killedItems);
 	if (so->currTuples != NULL)
@@ -565,6 +603,10 @@ btmarkpos(PG_FUNCTION_ARGS)
 	if (so->numArrayKeys)
 		_bt_mark_array_keys(scan);
 
+	/* ... and the current skip prefix */
+	if (so->skipScan)
+		_bt_mark_skip_keys(scan);
+
 	PG_RETURN_VOID();
 }
 
@@ -581,6 +623,10 @@ btrestrpos(PG_FUNCTION_ARGS)
 	if (so->numArrayKeys)
 		_bt_restore_array_keys(scan);
 
+	/* Likewise the marked skip prefix */
+	if (so->skipScan)
+		_bt_restore_skip_keys(scan);
+
 	if (so->markItemIndex >= 0)
 	{
 		/*
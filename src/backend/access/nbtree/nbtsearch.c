@@ -20,6 +20,7 @@
 #include "miscadmin.h"
 #include "pgstat.h"
 #include "storage/predicate.h"
+#include "utils/datum.h"
 #include "utils/lsyscache.h"
 #include "utils/rel.h"
 #include "utils/tqual.h"
@@ -408,6 +409,9 @@ _bt_binsrch(Relation rel,
  * does not matter.  This convention allows us to implement the Lehman and
  * Yao convention that the first down-link pointer is before the first key.
  * See backend/access/nbtree/README for details.
+ *
+ * Similarly, key attributes that were suffix-truncated away from a pivot
+ * tuple (see _bt_truncate) are treated as "minus infinity".
  *----------
  */
 int32
@@ -420,6 +424,8 @@ _bt_compare(Relation rel,
 	TupleDesc	itupdesc = RelationGetDescr(rel);
 	BTPageOpaque opaque = (BTPageOpaque) PageGetSpecialPointer(page);
 	IndexTuple	itup;
+	int			ntupatts;
+	int			ncmpkey;
 	int			i;
 
 	/*
@@ -430,6 +436,8 @@ _bt_compare(Relation rel,
 		return 1;
 
 	itup = (IndexTuple) PageGetItem(page, PageGetItemId(page, offnum));
+	ntupatts = BTreeTupGetNAtts(itup, rel);
+	ncmpkey = Min(ntupatts, keysz);
 
 	/*
 	 * The scan key is set up with the attribute number associated with each
@@ -443,7 +451,7 @@ _bt_compare(Relation rel,
 	 * _bt_first).
 	 */
 
-	for (i = 1; i <= keysz; i++)
+	for (i = 1; i <= ncmpkey; i++)
 	{
 		Datum		datum;
 		bool		isNull;
@@ -494,6 +502,15 @@ _bt_compare(Relation rel,
 		scankey++;
 	}
 
+	/*
+	 * All the attributes we compared are equal.  If the item is a pivot
+	 * tuple whose trailing attributes were truncated away, those attributes
+	 * are treated as minus infinity, so a scan key that has values for them
+	 * is greater than the item.
+	 */
+	if (keysz > ntupatts)
+		return 1;
+
 	/* if we get here, the keys are equal */
 	return 0;
 }
@@ -1759,3 +1776,143 @@ _bt_endpoint(IndexScanDesc scan, ScanDirection dir)
 
 	return true;
 }
+
+/*
+ *	_bt_skip_find_prefix() -- find the next distinct leading-column value
+ *
+ * This is the workhorse of skip scans (see _bt_preprocess_skip_keys).  If
+ * "first" is true we return the first leading-column value in the index for
+ * the given scan direction.  Otherwise we return the first value that lies
+ * strictly beyond the current prefix held in so->skipKeyData[0].  Either
+ * way we get there with a fresh descent of the tree, so the cost does not
+ * depend on how many index entries share the current prefix.
+ *
+ * On success, the value (copied into so->skipContext if pass-by-reference)
+ * is returned in *value and *isnull.  Returns false if there are no more
+ * prefix values in that direction.
+ */
+bool
+_bt_skip_find_prefix(IndexScanDesc scan, ScanDirection dir, bool first,
+					 Datum *value, bool *isnull)
+{
+	Relation	rel = scan->indexRelation;
+	BTScanOpaque so = (BTScanOpaque) scan->opaque;
+	TupleDesc	itupdesc = RelationGetDescr(rel);
+	Buffer		buf;
+	Page		page;
+	BTPageOpaque opaque;
+	OffsetNumber offnum;
+	IndexTuple	itup;
+
+	if (first)
+	{
+		buf = _bt_get_endpoint(rel, 0, ScanDirectionIsBackward(dir));
+		if (!BufferIsValid(buf))
+		{
+			/* Empty index; as in _bt_endpoint, lock the whole relation */
+			PredicateLockRelation(rel, scan->xs_snapshot);
+			return false;
+		}
+		page = BufferGetPage(buf);
+		opaque = (BTPageOpaque) PageGetSpecialPointer(page);
+		if (ScanDirectionIsForward(dir))
+			offnum = P_FIRSTDATAKEY(opaque);
+		else
+			offnum = PageGetMaxOffsetNumber(page);
+	}
+	else
+	{
+		ScanKey		prefix = &so->skipKeyData[0];
+		ScanKeyData skey;
+		BTStack		stack;
+		bool		nextkey = ScanDirectionIsForward(dir);
+
+		Assert(so->skipPrefixValid);
+
+		/*
+		 * Build a one-column insertion scankey from the current prefix.  For
+		 * a forward scan we want the first item > prefix; for a backward scan
+		 * we find the first item >= prefix and then back up one item.
+		 */
+		ScanKeyEntryInitializeWithInfo(&skey,
+									   (prefix->sk_flags & SK_ISNULL) |
+								  (rel->rd_indoption[0] << SK_BT_INDOPTION_SHIFT),
+									   1,
+									   InvalidStrategy,
+									   InvalidOid,
+									   rel->rd_indcollation[0],
+									   index_getprocinfo(rel, 1, BTORDER_PROC),
+									   prefix->sk_argument);
+
+		stack = _bt_search(rel, 1, &skey, nextkey, &buf, BT_READ);
+		_bt_freestack(stack);
+
+		if (!BufferIsValid(buf))
+		{
+			PredicateLockRelation(rel, scan->xs_snapshot);
+			return false;
+		}
+
+		offnum = _bt_binsrch(rel, buf, 1, &skey, nextkey);
+		if (!nextkey)
+			offnum = OffsetNumberPrev(offnum);
+		page = BufferGetPage(buf);
+		opaque = (BTPageOpaque) PageGetSpecialPointer(page);
+	}
+
+	/*
+	 * The position we computed may be off the end of the page, or the page
+	 * may be empty; if so, step to the adjacent leaf page and try again.
+	 */
+	for (;;)
+	{
+		PredicateLockPage(rel, BufferGetBlockNumber(buf), scan->xs_snapshot);
+
+		if (ScanDirectionIsForward(dir))
+		{
+			if (!P_IGNORE(opaque) && offnum <= PageGetMaxOffsetNumber(page))
+				break;
+			if (P_RIGHTMOST(opaque))
+			{
+				_bt_relbuf(rel, buf);
+				return false;
+			}
+			buf = _bt_relandgetbuf(rel, buf, opaque->btpo_next, BT_READ);
+			page = BufferGetPage(buf);
+			opaque = (BTPageOpaque) PageGetSpecialPointer(page);
+			offnum = P_FIRSTDATAKEY(opaque);
+		}
+		else
+		{
+			if (!P_IGNORE(opaque) && offnum >= P_FIRSTDATAKEY(opaque))
+				break;
+			if (P_LEFTMOST(opaque))
+			{
+				_bt_relbuf(rel, buf);
+				return false;
+			}
+			buf = _bt_walk_left(rel, buf);
+			if (!BufferIsValid(buf))
+				return false;
+			page = BufferGetPage(buf);
+			opaque = (BTPageOpaque) PageGetSpecialPointer(page);
+			offnum = PageGetMaxOffsetNumber(page);
+		}
+	}
+
+	itup = (IndexTuple) PageGetItem(page, PageGetItemId(page, offnum));
+	*value = index_getattr(itup, 1, itupdesc, isnull);
+	if (!*isnull)
+	{
+		MemoryContext oldContext = MemoryContextSwitchTo(so->skipContext);
+
+		*value = datumCopy(*value,
+						   itupdesc->attrs[0]->attbyval,
+						   itupdesc->attrs[0]->attlen);
+		MemoryContextSwitchTo(oldContext);
+	}
+
+	_bt_relbuf(rel, buf);
+
+	return true;
+}
@@ -510,6 +510,7 @@ _bt_buildadd(BTWriteState *wstate, BTPageState *state, IndexTuple itup)
 		ItemId		ii;
 		ItemId		hii;
 		IndexTuple	oitup;
+		IndexTuple	truncated;
 
 		/* Create new page of same level */
 		npage = _bt_blnewpage(state->btps_level);
@@ -537,6 +538,32 @@ _bt_buildadd(BTWriteState *wstate, BTPageState *state, IndexTuple itup)
 		ItemIdSetUnused(ii);	/* redundant */
 		((PageHeader) opage)->pd_lower -= sizeof(ItemIdData);
 
+		/*
+		 * On the leaf level, suffix-truncate the high key the same way
+		 * _bt_split() does, keeping only the attributes needed to separate
+		 * it from the last item remaining on opage.  The truncated tuple
+		 * also becomes the new page's downlink in the parent.
+		 */
+		if (state->btps_level == 0)
+		{
+			IndexTuple	lastleft;
+
+			lastleft = (IndexTuple)
+				PageGetItem(opage,
+							PageGetItemId(opage, OffsetNumberPrev(last_off)));
+			truncated = _bt_truncate(wstate->index, lastleft, oitup);
+			if (BTreeTupleIsTruncated(truncated))
+			{
+				PageIndexTupleDelete(opage, P_HIKEY);
+				if (PageAddItem(opage, (Item) truncated,
+								IndexTupleSize(truncated), P_HIKEY,
+								false, false) == InvalidOffsetNumber)
+					elog(ERROR, "failed to add truncated high key to index page");
+			}
+		}
+		else
+			truncated = NULL;
+
 		/*
 		 * Link the old page into its parent, using its minimum key. If we
 		 * don't have a parent, we have to create one; this adds a new btree
@@ -546,7 +573,7 @@ _bt_buildadd(BTWriteState *wstate, BTPageState *state, IndexTuple itup)
 			state->btps_next = _bt_pagestate(wstate, state->btps_level + 1);
 
 		Assert(state->btps_minkey != NULL);
-		ItemPointerSet(&(state->btps_minkey->t_tid), oblkno, P_HIKEY);
+		BTreeInnerTupleSetDownLink(state->btps_minkey, oblkno);
 		_bt_buildadd(wstate, state->btps_next, state->btps_minkey);
 		pfree(state->btps_minkey);
 
@@ -555,7 +582,10 @@ _bt_buildadd(BTWriteState *wstate, BTPageState *state, IndexTuple itup)
 		 * it off the old page, not the new one, in case we are not at leaf
 		 * level.
 		 */
-		state->btps_minkey = CopyIndexTuple(oitup);
+		if (truncated)
+			state->btps_minkey = truncated;
+		else
+			state->btps_minkey = CopyIndexTuple(oitup);
 
 		/*
 		 * Set the sibling links for both pages.
@@ -590,7 +620,7 @@ _bt_buildadd(BTWriteState *wstate, BTPageState *state, IndexTuple itup)
 	if (last_off == P_HIKEY)
 	{
 		Assert(state->btps_minkey == NULL);
-		state->btps_minkey = CopyIndexTuple(itup);
+		state->btps_minkey = _bt_nonkey_truncate(wstate->index, itup);
 	}
 
 	/*
@@ -643,7 +673,7 @@ _bt_uppershutdown(BTWriteState *wstate, BTPageState *state)
 		else
 		{
 			Assert(s->btps_minkey != NULL);
-			ItemPointerSet(&(s->btps_minkey->t_tid), blkno, P_HIKEY);
+			BTreeInnerTupleSetDownLink(s->btps_minkey, blkno);
 			_bt_buildadd(wstate, s->btps_next, s->btps_minkey);
 			pfree(s->btps_minkey);
 			s->btps_minkey = NULL;
@@ -685,7 +715,7 @@ _bt_load(BTWriteState *wstate, BTSpool *btspool, BTSpool *btspool2)
 				load1;
 	TupleDesc	tupdes = RelationGetDescr(wstate->index);
 	int			i,
-				keysz = RelationGetNumberOfAttributes(wstate->index);
+				keysz = IndexRelationGetNumberOfKeyAttributes(wstate->index);
 	ScanKey		indexScanKey = NULL;
 	SortSupport sortKeys;
 
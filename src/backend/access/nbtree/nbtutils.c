@@ -22,6 +22,7 @@
 #include "access/relscan.h"
 #include "miscadmin.h"
 #include "utils/array.h"
+#include "utils/datum.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
@@ -46,6 +47,8 @@ static bool _bt_compare_scankey_args(IndexScanDesc scan, ScanKey op,
 						 bool *result);
 static bool _bt_fix_scankey_strategy(ScanKey skey, int16 *indoption);
 static void _bt_mark_scankey_required(ScanKey skey);
+static IndexTuple _bt_form_pivot(Relation rel, IndexTuple itup,
+			   int keepnatts);
 static bool _bt_check_rowcompare(ScanKey skey,
 					 IndexTuple tuple, TupleDesc tupdesc,
 					 ScanDirection dir, bool *continuescan);
@@ -57,6 +60,13 @@ static bool _bt_check_rowcompare(ScanKey skey,
  *		as well as comparator routines appropriate to the key datatypes.
  *
  *		The result is intended for use with _bt_compare().
+ *
+ *		If itup is a suffix-truncated pivot tuple, the entries for the
+ *		truncated attributes are set to NULL; the caller must not pass a
+ *		keysz larger than BTreeTupGetNAtts(itup, rel) to the search routines.
+ *
+ *		Only key attributes get a scan key entry; included (non-key)
+ *		attributes don't participate in the index ordering.
  */
 ScanKey
 _bt_mkscankey(Relation rel, IndexTuple itup)
@@ -64,11 +74,13 @@ _bt_mkscankey(Relation rel, IndexTuple itup)
 	ScanKey		skey;
 	TupleDesc	itupdesc;
 	int			natts;
+	int			tupnatts;
 	int16	   *indoption;
 	int			i;
 
 	itupdesc = RelationGetDescr(rel);
-	natts = RelationGetNumberOfAttributes(rel);
+	natts = IndexRelationGetNumberOfKeyAttributes(rel);
+	tupnatts = BTreeTupGetNAtts(itup, rel);
 	indoption = rel->rd_indoption;
 
 	skey = (ScanKey) palloc(natts * sizeof(ScanKeyData));
@@ -85,7 +97,13 @@ _bt_mkscankey(Relation rel, IndexTuple itup)
 		 * comparison can be needed.
 		 */
 		procinfo = index_getprocinfo(rel, i + 1, BTORDER_PROC);
-		arg = index_getattr(itup, i + 1, itupdesc, &null);
+		if (i < tupnatts)
+			arg = index_getattr(itup, i + 1, itupdesc, &null);
+		else
+		{
+			arg = (Datum) 0;
+			null = true;
+		}
 		flags = (null ? SK_ISNULL : 0) | (indoption[i] << SK_BT_INDOPTION_SHIFT);
 		ScanKeyEntryInitializeWithInfo(&skey[i],
 									   flags,
@@ -119,7 +137,7 @@ _bt_mkscankey_nodata(Relation rel)
 	int16	   *indoption;
 	int			i;
 
-	natts = RelationGetNumberOfAttributes(rel);
+	natts = IndexRelationGetNumberOfKeyAttributes(rel);
 	indoption = rel->rd_indoption;
 
 	skey = (ScanKey) palloc(natts * sizeof(ScanKeyData));
@@ -148,6 +166,137 @@ _bt_mkscankey_nodata(Relation rel)
 	return skey;
 }
 
+/*
+ * _bt_keep_natts
+ *		Determine how many leading key attributes a pivot tuple separating
+ *		lastleft and firstright must retain.
+ *
+ *		Attributes are compared using the opclass comparator rather than by
+ *		binary equality, since values that are equal according to the opclass
+ *		may have different representations (e.g. numeric 1.0 and 1.00).  If
+ *		the two tuples are equal in all key attributes, nothing but the
+ *		included (non-key) attributes, if any, can be truncated.
+ */
+static int
+_bt_keep_natts(Relation rel, IndexTuple lastleft, IndexTuple firstright)
+{
+	TupleDesc	itupdesc = RelationGetDescr(rel);
+	int			natts = IndexRelationGetNumberOfKeyAttributes(rel);
+	int			keepnatts;
+	int			i;
+
+	keepnatts = 1;
+	for (i = 1; i <= natts; i++)
+	{
+		FmgrInfo   *procinfo;
+		Datum		datum1,
+					datum2;
+		bool		isNull1,
+					isNull2;
+
+		datum1 = index_getattr(lastleft, i, itupdesc, &isNull1);
+		datum2 = index_getattr(firstright, i, itupdesc, &isNull2);
+
+		if (isNull1 != isNull2)
+			break;
+
+		if (!isNull1)
+		{
+			procinfo = index_getprocinfo(rel, i, BTORDER_PROC);
+			if (DatumGetInt32(FunctionCall2Coll(procinfo,
+												rel->rd_indcollation[i - 1],
+												datum1, datum2)) != 0)
+				break;
+		}
+
+		keepnatts++;
+	}
+
+	return Min(keepnatts, natts);
+}
+
+/*
+ * _bt_truncate
+ *		Build a pivot tuple to serve as the high key of the left half of a
+ *		leaf page split, keeping only as many leading attributes of firstright
+ *		as are needed to distinguish it from lastleft.  Included (non-key)
+ *		attributes are always truncated away, so they are only ever stored
+ *		at the leaf level.
+ *
+ *		The result is palloc'd.  It is at most as large as firstright, sorts
+ *		strictly after lastleft, and sorts no later than firstright, which is
+ *		all the Lehman and Yao algorithm requires of a high key.
+ */
+IndexTuple
+_bt_truncate(Relation rel, IndexTuple lastleft, IndexTuple firstright)
+{
+	int			natts = RelationGetNumberOfAttributes(rel);
+	int			keepnatts;
+
+	Assert(!BTreeTupleIsTruncated(lastleft));
+	Assert(!BTreeTupleIsTruncated(firstright));
+
+	keepnatts = _bt_keep_natts(rel, lastleft, firstright);
+	if (keepnatts >= natts)
+		return CopyIndexTuple(firstright);
+
+	return _bt_form_pivot(rel, firstright, keepnatts);
+}
+
+/*
+ * _bt_nonkey_truncate
+ *		Build a pivot tuple from the key attributes of a leaf tuple,
+ *		dropping any included (non-key) attributes.
+ *
+ *		This is used for the first downlink of each level built by CREATE
+ *		INDEX, which is never compared against but shouldn't carry payload
+ *		columns into the upper levels.  The result is palloc'd.
+ */
+IndexTuple
+_bt_nonkey_truncate(Relation rel, IndexTuple itup)
+{
+	int			nkeyatts = IndexRelationGetNumberOfKeyAttributes(rel);
+
+	if (nkeyatts >= RelationGetNumberOfAttributes(rel) ||
+		BTreeTupleIsTruncated(itup))
+		return CopyIndexTuple(itup);
+
+	return _bt_form_pivot(rel, itup, nkeyatts);
+}
+
+/*
+ * _bt_form_pivot
+ *		Form a copy of itup that keeps only its first keepnatts attributes.
+ */
+static IndexTuple
+_bt_form_pivot(Relation rel, IndexTuple itup, int keepnatts)
+{
+	TupleDesc	itupdesc = RelationGetDescr(rel);
+	Datum		values[INDEX_MAX_KEYS];
+	bool		isnull[INDEX_MAX_KEYS];
+	TupleDesc	truncdesc;
+	IndexTuple	pivot;
+
+	/*
+	 * Form a new tuple from the leading attributes.  Rebuilding it with a
+	 * shortened descriptor yields the same layout for the kept attributes as
+	 * in the original tuple; the values are already in their index storage
+	 * form, so index_form_tuple won't alter them.  The descriptor shares the
+	 * index's attribute array, so just pfree it afterwards.
+	 */
+	index_deform_tuple(itup, itupdesc, values, isnull);
+	truncdesc = CreateTupleDesc(keepnatts, false, itupdesc->attrs);
+	pivot = index_form_tuple(truncdesc, values, isnull);
+	pfree(truncdesc);
+
+	pivot->t_tid = itup->t_tid;
+	BTreeTupSetNAtts(pivot, keepnatts);
+
+	Assert(IndexTupleSize(pivot) <= IndexTupleSize(itup));
+
+	return pivot;
+}
+
 /*
  * free a scan key made by either _bt_mkscankey or _bt_mkscankey_nodata.
  */
@@ -655,13 +804,225 @@ _bt_restore_array_keys(IndexScanDesc scan)
 }
 
 
+/*
+ * _bt_preprocess_skip_keys() -- Set up skip scan state, if requested
+ *
+ * The executor sets scan->xs_skip_prefix when the planner decided that
+ * jumping from one distinct leading-column value to the next is cheaper than
+ * reading the whole index (see btcostestimate).  We honor that only when the
+ * leading column has no scan keys of its own, a later column has at least
+ * one, and there are no array keys (whose advancement logic we don't try to
+ * combine with skipping).
+ *
+ * A skip scan is run as a series of ordinary scans, one per distinct value
+ * of the leading column.  so->skipKeyData is a copy of scan->keyData with an
+ * extra "=" (or IS NULL) key on the leading column in front, which
+ * _bt_preprocess_keys reads in place of scan->keyData.  Since that key is an
+ * equality, the keys on the second column become required and can be used
+ * by _bt_first for positioning, just as if the query had constrained the
+ * leading column itself.
+ */
+void
+_bt_preprocess_skip_keys(IndexScanDesc scan)
+{
+	BTScanOpaque so = (BTScanOpaque) scan->opaque;
+	Relation	rel = scan->indexRelation;
+	Oid			eq_op;
+	MemoryContext oldContext;
+
+	so->skipScan = false;
+	so->skipKeyData = NULL;
+	so->skipPrefixValid = false;
+	so->markSkipValid = false;
+
+	if (scan->xs_skip_prefix <= 0 ||
+		IndexRelationGetNumberOfKeyAttributes(rel) < 2 ||
+		scan->numberOfKeys < 1 ||
+		scan->keyData[0].sk_attno == 1 ||
+		so->numArrayKeys != 0)
+		return;
+
+	eq_op = get_opfamily_member(rel->rd_opfamily[0],
+								rel->rd_opcintype[0],
+								rel->rd_opcintype[0],
+								BTEqualStrategyNumber);
+	if (!OidIsValid(eq_op))
+		return;					/* shouldn't happen, but just don't skip */
+
+	/*
+	 * Make a scan-lifespan context to hold skip-associated data, or reset it
+	 * if we already have one from a previous rescan cycle.
+	 */
+	if (so->skipContext == NULL)
+		so->skipContext = AllocSetContextCreate(CurrentMemoryContext,
+												"BTree Skip Context",
+												ALLOCSET_SMALL_MINSIZE,
+												ALLOCSET_SMALL_INITSIZE,
+												ALLOCSET_SMALL_MAXSIZE);
+	else
+		MemoryContextReset(so->skipContext);
+
+	oldContext = MemoryContextSwitchTo(so->skipContext);
+
+	so->skipKeyData = (ScanKey) palloc((scan->numberOfKeys + 1) *
+									   sizeof(ScanKeyData));
+	ScanKeyEntryInitialize(&so->skipKeyData[0],
+						   0,
+						   1,
+						   BTEqualStrategyNumber,
+						   rel->rd_opcintype[0],
+						   rel->rd_indcollation[0],
+						   get_opcode(eq_op),
+						   (Datum) 0);
+	memcpy(&so->skipKeyData[1],
+		   scan->keyData,
+		   scan->numberOfKeys * sizeof(ScanKeyData));
+
+	MemoryContextSwitchTo(oldContext);
+
+	so->skipScan = true;
+}
+
+/*
+ * Install a new prefix value in the skip key, releasing the old one.
+ *
+ * The value must already have been copied into so->skipContext.
+ */
+static void
+_bt_set_skip_prefix(IndexScanDesc scan, Datum value, bool isnull)
+{
+	BTScanOpaque so = (BTScanOpaque) scan->opaque;
+	Relation	rel = scan->indexRelation;
+	ScanKey		skey = &so->skipKeyData[0];
+
+	if (so->skipPrefixValid && !(skey->sk_flags & SK_ISNULL) &&
+		!RelationGetDescr(rel)->attrs[0]->attbyval)
+		pfree(DatumGetPointer(skey->sk_argument));
+
+	/* _bt_fix_scankey_strategy will add the indoption flags back */
+	if (isnull)
+	{
+		skey->sk_flags = SK_ISNULL | SK_SEARCHNULL;
+		skey->sk_argument = (Datum) 0;
+	}
+	else
+	{
+		skey->sk_flags = 0;
+		skey->sk_strategy = BTEqualStrategyNumber;
+		skey->sk_subtype = rel->rd_opcintype[0];
+		skey->sk_collation = rel->rd_indcollation[0];
+		skey->sk_argument = value;
+	}
+	so->skipPrefixValid = true;
+}
+
+/*
+ * _bt_start_skip_keys() -- Initialize the skip prefix at start of a scan
+ *
+ * Returns FALSE if the index is empty, so there's nothing to scan.
+ */
+bool
+_bt_start_skip_keys(IndexScanDesc scan, ScanDirection dir)
+{
+	Datum		value;
+	bool		isnull;
+
+	if (!_bt_skip_find_prefix(scan, dir, true, &value, &isnull))
+		return false;
+	_bt_set_skip_prefix(scan, value, isnull);
+	return true;
+}
+
+/*
+ * _bt_advance_skip_keys() -- Advance to the next leading-column value
+ *
+ * Returns TRUE if there is another prefix to scan, FALSE if not.
+ */
+bool
+_bt_advance_skip_keys(IndexScanDesc scan, ScanDirection dir)
+{
+	BTScanOpaque so = (BTScanOpaque) scan->opaque;
+	Datum		value;
+	bool		isnull;
+
+	/*
+	 * The leading-column key can't contradict keys on other columns, so if
+	 * the quals were found unsatisfiable they are so for every prefix.
+	 */
+	if (!so->qual_ok)
+		return false;
+
+	if (!_bt_skip_find_prefix(scan, dir, false, &value, &isnull))
+		return false;
+	_bt_set_skip_prefix(scan, value, isnull);
+	return true;
+}
+
+/*
+ * _bt_mark_skip_keys() -- Handle skip prefix during btmarkpos
+ */
+void
+_bt_mark_skip_keys(IndexScanDesc scan)
+{
+	BTScanOpaque so = (BTScanOpaque) scan->opaque;
+	Form_pg_attribute att = RelationGetDescr(scan->indexRelation)->attrs[0];
+	ScanKey		skey = &so->skipKeyData[0];
+
+	if (so->markSkipValid && !so->markSkipIsNull && !att->attbyval)
+		pfree(DatumGetPointer(so->markSkipPrefix));
+	so->markSkipValid = so->skipPrefixValid;
+	if (!so->skipPrefixValid)
+		return;
+
+	so->markSkipIsNull = (skey->sk_flags & SK_ISNULL) != 0;
+	if (so->markSkipIsNull)
+		so->markSkipPrefix = (Datum) 0;
+	else
+	{
+		MemoryContext oldContext = MemoryContextSwitchTo(so->skipContext);
+
+		so->markSkipPrefix = datumCopy(skey->sk_argument,
+									   att->attbyval, att->attlen);
+		MemoryContextSwitchTo(oldContext);
+	}
+}
+
+/*
+ * _bt_restore_skip_keys() -- Handle skip prefix during btrestrpos
+ */
+void
+_bt_restore_skip_keys(IndexScanDesc scan)
+{
+	BTScanOpaque so = (BTScanOpaque) scan->opaque;
+	Form_pg_attribute att = RelationGetDescr(scan->indexRelation)->attrs[0];
+	Datum		value = (Datum) 0;
+
+	if (!so->markSkipValid)
+		return;
+
+	if (!so->markSkipIsNull)
+	{
+		MemoryContext oldContext = MemoryContextSwitchTo(so->skipContext);
+
+		value = datumCopy(so->markSkipPrefix, att->attbyval, att->attlen);
+		MemoryContextSwitchTo(oldContext);
+	}
+	_bt_set_skip_prefix(scan, value, so->markSkipIsNull);
+
+	/* As in _bt_restore_array_keys, redo the key preprocessing */
+	_bt_preprocess_keys(scan);
+	Assert(so->qual_ok);
+}
+
+
 /*
  *	_bt_preprocess_keys() -- Preprocess scan keys
  *
- * The given search-type keys (in scan->keyData[] or so->arrayKeyData[])
- * are copied to so->keyData[] with possible transformation.
- * scan->numberOfKeys is the number of input keys, so->numberOfKeys gets
- * the number of output keys (possibly less, never greater).
+ * The given search-type keys (in scan->keyData[], so->arrayKeyData[] or
+ * so->skipKeyData[]) are copied to so->keyData[] with possible
+ * transformation.  scan->numberOfKeys is the number of input keys (plus one
+ * for the leading-column key of a skip scan), so->numberOfKeys gets the
+ * number of output keys (possibly less, never greater).
  *
  * The output keys are marked with additional sk_flag bits beyond the
  * system-standard bits supplied by the caller.  The DESC and NULLS_FIRST
@@ -764,10 +1125,16 @@ _bt_preprocess_keys(IndexScanDesc scan)
 		return;					/* done if qual-less scan */
 
 	/*
-	 * Read so->arrayKeyData if array keys are present, else scan->keyData
+	 * Read so->arrayKeyData if array keys are present, so->skipKeyData if
+	 * this is a skip scan, else scan->keyData
 	 */
 	if (so->arrayKeyData != NULL)
 		inkeys = so->arrayKeyData;
+	else if (so->skipScan)
+	{
+		inkeys = so->skipKeyData;
+		numberOfKeys++;
+	}
 	else
 		inkeys = scan->keyData;
 
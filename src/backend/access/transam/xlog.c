@@ -33,6 +33,8 @@
 #include "access/xact.h"
 #include "access/xlog_internal.h"
 #include "access/xloginsert.h"
+#include "access/xlogparallel.h"
+#include "access/xlogprefetch.h"
 #include "access/xlogreader.h"
 #include "access/xlogutils.h"
 #include "catalog/catversion.h"
@@ -213,6 +215,13 @@ static bool LocalRecoveryInProgress = true;
  */
 static bool LocalHotStandbyActive = false;
 
+/*
+ * Set by the redo routine of a commit record whose transaction waits for
+ * synchronous_commit = remote_apply, to have walreceiver tell the primary
+ * that it has been applied as soon as possible.
+ */
+static bool doRequestWalReceiverReply;
+
 /*
  * Local state for XLogInsertAllowed():
  *		1: unconditionally allowed to insert XLOG
@@ -1921,6 +1930,14 @@ AdvanceXLInsertBuffer(XLogRecPtr upto, bool opportunistic)
 
 		NewPage = (XLogPageHeader) (XLogCtl->pages + nextidx * (Size) XLOG_BLCKSZ);
 
+		/*
+		 * Mark the buffer as not holding any page while we reinitialize it,
+		 * so that WALReadFromBuffers(), which reads the old contents without
+		 * holding a lock, notices that it's being replaced.
+		 */
+		*((volatile XLogRecPtr *) &XLogCtl->xlblocks[nextidx]) = InvalidXLogRecPtr;
+		pg_write_barrier();
+
 		/*
 		 * Be sure to re-zero the buffer so that bytes beyond what we've
 		 * written will look like zeroes and not valid XLOG records...
@@ -5603,6 +5620,9 @@ recoveryPausesHere(void)
 	if (!LocalHotStandbyActive)
 		return;
 
+	/* Let users see everything replayed so far */
+	ParallelRedoWaitForWorkers();
+
 	ereport(LOG,
 			(errmsg("recovery has paused"),
 			 errhint("Execute pg_xlog_replay_resume() to continue.")));
@@ -6396,6 +6416,13 @@ StartupXLOG(void)
 		InRecovery = true;
 	}
 
+	/*
+	 * After a clean shutdown, reload the statistics saved by ShutdownXLOG.
+	 * If we need recovery they may be invalid, and are discarded below.
+	 */
+	if (!InRecovery)
+		pgstat_read_statsfile();
+
 	/* REDO */
 	if (InRecovery)
 	{
@@ -6673,6 +6700,7 @@ StartupXLOG(void)
 		{
 			ErrorContextCallback errcallback;
 			TimestampTz xtime;
+			XLogPrefetcher *prefetcher;
 
 			InRedo = true;
 
@@ -6680,6 +6708,12 @@ StartupXLOG(void)
 					(errmsg("redo starts at %X/%X",
 						 (uint32) (ReadRecPtr >> 32), (uint32) ReadRecPtr)));
 
+			/* Launch parallel redo workers, if requested */
+			ParallelRedoStart();
+
+			/* Prepare to read ahead and prefetch referenced blocks */
+			prefetcher = XLogPrefetcherAllocate();
+
 			/*
 			 * main redo apply loop
 			 */
@@ -6751,6 +6785,9 @@ StartupXLOG(void)
 						recoveryPausesHere();
 				}
 
+				/* Initiate reads of blocks we'll need soon */
+				XLogPrefetcherReadAhead(prefetcher, xlogreader);
+
 				/* Setup error traceback support for ereport() */
 				errcallback.callback = rm_redo_error_callback;
 				errcallback.arg = (void *) xlogreader;
@@ -6833,8 +6870,12 @@ StartupXLOG(void)
 					TransactionIdIsValid(record->xl_xid))
 					RecordKnownAssignedTransactionIds(record->xl_xid);
 
-				/* Now apply the WAL record itself */
-				RmgrTable[record->xl_rmid].rm_redo(xlogreader);
+				/*
+				 * Now apply the WAL record itself, or have a parallel redo
+				 * worker do it
+				 */
+				if (!ParallelRedoDispatch(xlogreader))
+					RmgrTable[record->xl_rmid].rm_redo(xlogreader);
 
 				/* Pop the error context stack */
 				error_context_stack = errcallback.previous;
@@ -6848,6 +6889,17 @@ StartupXLOG(void)
 				XLogCtl->lastReplayedTLI = ThisTimeLineID;
 				SpinLockRelease(&XLogCtl->info_lck);
 
+				/*
+				 * If rm_redo called XLogRequestWalReceiverReply, then we wake
+				 * up the receiver so that it notices the updated
+				 * lastReplayedEndRecPtr and sends a reply to the master.
+				 */
+				if (doRequestWalReceiverReply)
+				{
+					doRequestWalReceiverReply = false;
+					WalRcvForceReply();
+				}
+
 				/* Remember this record as the last-applied one */
 				LastRec = ReadRecPtr;
 
@@ -6887,6 +6939,9 @@ StartupXLOG(void)
 			 * end of main redo apply loop
 			 */
 
+			ParallelRedoShutdown();
+			XLogPrefetcherFree(prefetcher);
+
 			if (reachedStopPoint)
 			{
 				if (!reachedConsistency)
@@ -7434,7 +7489,11 @@ CheckRecoveryConsistency(void)
 		 * backupEndPoint, and update minRecoveryPoint to make sure we don't
 		 * allow starting up at an earlier point even if recovery is stopped
 		 * and restarted soon after this.
+		 *
+		 * The parallel redo workers have to catch up first, though.
 		 */
+		ParallelRedoWaitForWorkers();
+
 		elog(DEBUG1, "end of backup reached");
 
 		LWLockAcquire(ControlFileLock, LW_EXCLUSIVE);
@@ -7461,6 +7520,9 @@ CheckRecoveryConsistency(void)
 		minRecoveryPoint <= lastReplayedEndRecPtr &&
 		XLogRecPtrIsInvalid(ControlFile->backupStartPoint))
 	{
+		/* Everything up to here must have been replayed, by anyone */
+		ParallelRedoWaitForWorkers();
+
 		/*
 		 * Check to see if the XLOG sequence contained any unresolved
 		 * references to uninitialized pages.
@@ -7846,6 +7908,68 @@ GetInsertRecPtr(void)
 	return recptr;
 }
 
+/*
+ * Read WAL that has already been written out from the WAL buffers, to save
+ * walsenders from reading it back from the segment files.
+ *
+ * Copies as much as possible of the count bytes starting at startptr into
+ * dstbuf, stopping at the first page that is no longer in the buffers, and
+ * returns the number of bytes copied.  The caller must read the rest from
+ * disk.  Only WAL of the current timeline, up to the write position, may be
+ * requested, and nothing can be read this way during recovery.
+ *
+ * No lock is taken: we check before and after copying each page that its
+ * buffer still holds it.  A buffer that's being reinitialized shows
+ * InvalidXLogRecPtr in xlblocks meanwhile, see AdvanceXLInsertBuffer().
+ */
+Size
+WALReadFromBuffers(char *dstbuf, XLogRecPtr startptr, Size count)
+{
+	char	   *pdst = dstbuf;
+	XLogRecPtr	recptr = startptr;
+	Size		nbytes = count;
+
+	if (RecoveryInProgress())
+		return 0;
+
+	while (nbytes > 0)
+	{
+		int			idx = XLogRecPtrToBufIdx(recptr);
+		XLogRecPtr	expectedEndPtr;
+		XLogRecPtr	endptr;
+		Size		npagebytes;
+
+		expectedEndPtr = recptr;
+		expectedEndPtr += XLOG_BLCKSZ - recptr % XLOG_BLCKSZ;
+
+		/*
+		 * As in GetXLogBuffer(), a torn read of xlblocks can only produce a
+		 * value other than the one we're looking for, which makes us fall
+		 * back to reading from disk.
+		 */
+		endptr = *((volatile XLogRecPtr *) &XLogCtl->xlblocks[idx]);
+		if (endptr != expectedEndPtr)
+			break;
+		pg_read_barrier();
+
+		npagebytes = Min(nbytes, XLOG_BLCKSZ - recptr % XLOG_BLCKSZ);
+		memcpy(pdst, XLogCtl->pages + idx * (Size) XLOG_BLCKSZ +
+			   recptr % XLOG_BLCKSZ, npagebytes);
+
+		/* The page might have been replaced while we copied it */
+		pg_read_barrier();
+		endptr = *((volatile XLogRecPtr *) &XLogCtl->xlblocks[idx]);
+		if (endptr != expectedEndPtr)
+			break;
+
+		pdst += npagebytes;
+		recptr += npagebytes;
+		nbytes -= npagebytes;
+	}
+
+	return count - nbytes;
+}
+
 /*
  * GetFlushRecPtr -- Returns the current flush position, ie, the last WAL
  * position known to be fsync'd to disk.
@@ -7943,6 +8067,9 @@ ShutdownXLOG(int code, Datum arg)
 	ShutdownSUBTRANS();
 	ShutdownMultiXact();
 
+	/* Save the shared statistics for the next startup */
+	pgstat_write_statsfile();
+
 	/* Don't be chatty in standalone mode */
 	ereport(IsPostmasterEnvironment ? LOG : NOTICE,
 			(errmsg("database system is shut down")));
@@ -11590,6 +11717,15 @@ WakeupRecovery(void)
 	SetLatch(&XLogCtl->recoveryWakeupLatch);
 }
 
+/*
+ * Schedule a walreceiver wakeup in the main recovery loop.
+ */
+void
+XLogRequestWalReceiverReply(void)
+{
+	doRequestWalReceiverReply = true;
+}
+
 /*
  * Update the WalWriterSleeping flag.
  */
@@ -0,0 +1,936 @@
+/*-------------------------------------------------------------------------
+ *
+ * xlogparallel.c
+ *	  Parallel replay of WAL records by background workers
+ *
+ * With recovery_workers > 0, the startup process hands off the replay of
+ * WAL records that only modify pages of a single relation to a set of redo
+ * workers.  All records of a relation go to the same worker, determined by
+ * hashing its RelFileNode, so that changes to a relation are still applied in
+ * WAL order; different relations are replayed concurrently.
+ *
+ * All other records - those touching several relations or no pages at all,
+ * such as commit records, DDL, relation map updates or checkpoints, and
+ * records that need to resolve hot standby conflicts or take cleanup locks -
+ * act as barriers: the startup process waits until the workers have replayed
+ * everything dispatched before them, and then replays them itself.  As
+ * commit records are barriers, hot standby sessions never see the effects of
+ * a transaction before all of its changes have been replayed; the same holds
+ * for the point where recovery is declared consistent.  Under hot standby,
+ * heap records that clear a visibility map bit are barriers as well, so that
+ * index-only scans never see an index entry before the heap change that made
+ * its page not all-visible.
+ *
+ * Records are passed to the workers through one shm_mq per worker, in a
+ * dynamic shared memory segment that also holds a little state for each
+ * worker: how many records it has replayed, and a slot to hand references to
+ * invalid pages back to the startup process, which keeps track of them (see
+ * xlogutils.c).
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/backend/access/transam/xlogparallel.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "access/hash.h"
+#include "access/heapam_xlog.h"
+#include "access/nbtree.h"
+#include "access/rmgr.h"
+#include "access/xact.h"
+#include "access/xlog.h"
+#include "access/xlog_internal.h"
+#include "access/xlogparallel.h"
+#include "access/xlogutils.h"
+#include "catalog/pg_control.h"
+#include "miscadmin.h"
+#include "postmaster/bgworker.h"
+#include "postmaster/startup.h"
+#include "storage/dsm.h"
+#include "storage/proc.h"
+#include "storage/shm_mq.h"
+#include "storage/shm_toc.h"
+#include "storage/smgr.h"
+#include "storage/spin.h"
+#include "tcop/tcopprot.h"
+#include "utils/memutils.h"
+#include "utils/resowner.h"
+
+/* size of each worker's record queue */
+#define PARALLEL_REDO_QUEUE_SIZE			(1024 * 1024)
+
+/* Magic number for parallel redo TOC. */
+#define PARALLEL_REDO_MAGIC					0x50524544
+
+#define PARALLEL_REDO_KEY_SHARED			UINT64CONST(1)
+#define PARALLEL_REDO_KEY_QUEUES			UINT64CONST(2)
+
+/* Per-worker state. */
+typedef struct ParallelRedoWorkerSlot
+{
+	slock_t		mutex;			/* protects everything below */
+	PGPROC	   *proc;			/* the worker, once attached */
+	uint64		applied;		/* number of records replayed */
+
+	/* a reference to an invalid page waiting for the startup process */
+	bool		invalid_page_pending;
+	RelFileNode invalid_node;
+	ForkNumber	invalid_forkno;
+	BlockNumber invalid_blkno;
+	bool		invalid_present;
+} ParallelRedoWorkerSlot;
+
+/* State shared between the startup process and the workers. */
+typedef struct ParallelRedoShared
+{
+	PGPROC	   *startup_proc;
+	int			nworkers;
+
+	slock_t		mutex;			/* protects the fields below */
+	int			workers_attached;
+	uint32		smgr_generation;	/* bumped when relation files may change */
+	bool		invalid_pages_pending;
+
+	ParallelRedoWorkerSlot slots[FLEXIBLE_ARRAY_MEMBER];
+} ParallelRedoShared;
+
+/* What precedes each record in a worker's queue. */
+typedef struct ParallelRedoRecordHeader
+{
+	XLogRecPtr	ReadRecPtr;
+	XLogRecPtr	EndRecPtr;
+	HotStandbyState standbyState;	/* the startup process's, at this record */
+} ParallelRedoRecordHeader;
+
+/* GUC variable */
+int			recovery_workers = 0;
+
+int			ParallelRedoWorkerNumber = -1;
+
+/* startup process state */
+static dsm_segment *redo_seg = NULL;
+static ParallelRedoShared *redo_shared = NULL;
+static int	redo_nworkers = 0;
+static shm_mq_handle **redo_mqh = NULL;
+static BackgroundWorkerHandle **redo_handle = NULL;
+static uint64 *redo_sent = NULL;
+
+/* worker state */
+static ParallelRedoWorkerSlot *MyRedoSlot = NULL;
+
+static int	ParallelRedoTarget(XLogReaderState *record);
+static bool ParallelRedoClearsAllVisible(XLogReaderState *record);
+static bool ParallelRedoInvalidatesSmgr(XLogReaderState *record);
+static void ParallelRedoServiceWorkers(void);
+static void ParallelRedoCheckWorkers(void);
+static void ParallelRedoWait(void);
+static BgwHandleStatus ParallelRedoWaitForWorkerPid(BackgroundWorkerHandle *handle,
+							 BgwHandleStatus waitfor);
+static void ParallelRedoWorkerMain(Datum main_arg);
+static void ParallelRedoErrorCallback(void *arg);
+
+/*
+ * Launch the redo workers, if configured.  Called by the startup process
+ * before the redo loop.  If the workers can't all be started, we log that and
+ * replay serially.
+ */
+void
+ParallelRedoStart(void)
+{
+	shm_toc_estimator e;
+	shm_toc    *toc;
+	Size		segsize;
+	Size		sharedsize;
+	char	   *queues;
+	BackgroundWorker worker;
+	ResourceOwner owner;
+	ResourceOwner saved_owner;
+	int			nworkers = recovery_workers;
+	int			i;
+
+	Assert(redo_nworkers == 0);
+
+	if (nworkers <= 0 || !IsUnderPostmaster ||
+		dynamic_shared_memory_type == DSM_IMPL_NONE)
+		return;
+
+	if (nworkers > max_worker_processes)
+	{
+		ereport(LOG,
+				(errmsg("recovery_workers (%d) exceeds max_worker_processes (%d), using %d workers",
+						nworkers, max_worker_processes, max_worker_processes)));
+		nworkers = max_worker_processes;
+	}
+
+	sharedsize = add_size(offsetof(ParallelRedoShared, slots),
+						mul_size(nworkers, sizeof(ParallelRedoWorkerSlot)));
+
+	shm_toc_initialize_estimator(&e);
+	shm_toc_estimate_chunk(&e, sharedsize);
+	shm_toc_estimate_chunk(&e, mul_size(nworkers, PARALLEL_REDO_QUEUE_SIZE));
+	shm_toc_estimate_keys(&e, 2);
+	segsize = shm_toc_estimate(&e);
+
+	/*
+	 * The startup process has no resource owner, which dsm_create() needs,
+	 * so use a temporary one.  The mapping is kept until ParallelRedoShutdown
+	 * detaches it.
+	 */
+	saved_owner = CurrentResourceOwner;
+	owner = ResourceOwnerCreate(NULL, "parallel redo startup");
+	CurrentResourceOwner = owner;
+	redo_seg = dsm_create(segsize, DSM_CREATE_NULL_IF_MAXSEGMENTS);
+	if (redo_seg != NULL)
+		dsm_pin_mapping(redo_seg);
+	CurrentResourceOwner = saved_owner;
+	ResourceOwnerDelete(owner);
+	if (redo_seg == NULL)
+	{
+		ereport(LOG,
+				(errmsg("could not create shared memory segment for parallel redo, replaying serially")));
+		return;
+	}
+	toc = shm_toc_create(PARALLEL_REDO_MAGIC, dsm_segment_address(redo_seg),
+						 segsize);
+
+	redo_shared = shm_toc_allocate(toc, sharedsize);
+	redo_shared->startup_proc = MyProc;
+	redo_shared->nworkers = nworkers;
+	SpinLockInit(&redo_shared->mutex);
+	redo_shared->workers_attached = 0;
+	redo_shared->smgr_generation = 0;
+	redo_shared->invalid_pages_pending = false;
+	for (i = 0; i < nworkers; i++)
+	{
+		ParallelRedoWorkerSlot *slot = &redo_shared->slots[i];
+
+		SpinLockInit(&slot->mutex);
+		slot->proc = NULL;
+		slot->applied = 0;
+		slot->invalid_page_pending = false;
+	}
+	shm_toc_insert(toc, PARALLEL_REDO_KEY_SHARED, redo_shared);
+
+	queues = shm_toc_allocate(toc, mul_size(nworkers, PARALLEL_REDO_QUEUE_SIZE));
+	shm_toc_insert(toc, PARALLEL_REDO_KEY_QUEUES, queues);
+
+	redo_mqh = MemoryContextAlloc(TopMemoryContext,
+								  sizeof(shm_mq_handle *) * nworkers);
+	redo_handle = MemoryContextAllocZero(TopMemoryContext,
+								sizeof(BackgroundWorkerHandle *) * nworkers);
+	redo_sent = MemoryContextAllocZero(TopMemoryContext,
+									   sizeof(uint64) * nworkers);
+
+	for (i = 0; i < nworkers; i++)
+	{
+		shm_mq	   *mq;
+
+		mq = shm_mq_create(queues + i * PARALLEL_REDO_QUEUE_SIZE,
+						   PARALLEL_REDO_QUEUE_SIZE);
+		shm_mq_set_sender(mq, MyProc);
+		redo_mqh[i] = shm_mq_attach(mq, redo_seg, NULL);
+	}
+
+	/* Configure and register the workers. */
+	snprintf(worker.bgw_name, BGW_MAXLEN, "parallel redo worker");
+	worker.bgw_flags = BGWORKER_SHMEM_ACCESS;
+	worker.bgw_start_time = BgWorkerStart_PostmasterStart;
+	worker.bgw_restart_time = BGW_NEVER_RESTART;
+	worker.bgw_main = ParallelRedoWorkerMain;
+	worker.bgw_main_arg = UInt32GetDatum(dsm_segment_handle(redo_seg));
+	worker.bgw_notify_pid = MyProcPid;
+
+	for (i = 0; i < nworkers; i++)
+	{
+		if (!RegisterDynamicBackgroundWorker(&worker, &redo_handle[i]) ||
+			ParallelRedoWaitForWorkerPid(redo_handle[i],
+										 BGWH_NOT_YET_STARTED) != BGWH_STARTED)
+			break;
+	}
+
+	/*
+	 * Wait for the workers to attach to their queues; they pick them in the
+	 * order they get there.
+	 */
+	while (i == nworkers)
+	{
+		int			attached;
+		int			j;
+
+		SpinLockAcquire(&redo_shared->mutex);
+		attached = redo_shared->workers_attached;
+		SpinLockRelease(&redo_shared->mutex);
+		if (attached == nworkers)
+			break;
+
+		for (j = 0; j < nworkers; j++)
+		{
+			pid_t		pid;
+
+			if (GetBackgroundWorkerPid(redo_handle[j], &pid) != BGWH_STARTED)
+				i = j;
+		}
+
+		ParallelRedoWait();
+	}
+
+	redo_nworkers = nworkers;
+
+	if (i < nworkers)
+	{
+		ereport(LOG,
+				(errmsg("could not start parallel redo workers, replaying serially"),
+				 errhint("You might need to increase max_worker_processes.")));
+		ParallelRedoShutdown();
+		return;
+	}
+
+	ereport(LOG,
+			(errmsg("parallel redo started with %d workers", nworkers)));
+}
+
+/*
+ * Hand the replay of a WAL record to a redo worker, if possible.  Returns
+ * false if the startup process has to replay the record itself, in which case
+ * everything dispatched before has been replayed when we return.
+ */
+bool
+ParallelRedoDispatch(XLogReaderState *record)
+{
+	ParallelRedoRecordHeader hdr;
+	shm_mq_iovec iov[2];
+	int			target;
+
+	if (redo_nworkers == 0)
+		return false;
+
+	target = ParallelRedoTarget(record);
+
+	if (target < 0)
+	{
+		ParallelRedoWaitForWorkers();
+
+		/*
+		 * The workers are idle now, and only look at the generation counter
+		 * when they get their next record, which we'll only send once we've
+		 * replayed this one.
+		 */
+		if (ParallelRedoInvalidatesSmgr(record))
+		{
+			SpinLockAcquire(&redo_shared->mutex);
+			redo_shared->smgr_generation++;
+			SpinLockRelease(&redo_shared->mutex);
+		}
+		return false;
+	}
+
+	hdr.ReadRecPtr = record->ReadRecPtr;
+	hdr.EndRecPtr = record->EndRecPtr;
+	hdr.standbyState = standbyState;
+	iov[0].data = (char *) &hdr;
+	iov[0].len = sizeof(hdr);
+	iov[1].data = (char *) record->decoded_record;
+	iov[1].len = record->decoded_record->xl_tot_len;
+
+	for (;;)
+	{
+		shm_mq_result res;
+
+		/* a worker might be waiting for us to deal with an invalid page */
+		if (((volatile ParallelRedoShared *) redo_shared)->invalid_pages_pending)
+			ParallelRedoServiceWorkers();
+
+		res = shm_mq_sendv(redo_mqh[target], iov, 2, true);
+		if (res == SHM_MQ_SUCCESS)
+			break;
+		if (res == SHM_MQ_DETACHED)
+			ereport(FATAL,
+					(errmsg("parallel redo worker %d terminated unexpectedly",
+							target)));
+
+		/* queue is full */
+		ParallelRedoCheckWorkers();
+		ParallelRedoWait();
+	}
+
+	redo_sent[target]++;
+	return true;
+}
+
+/*
+ * Wait until the redo workers have replayed everything dispatched to them.
+ */
+void
+ParallelRedoWaitForWorkers(void)
+{
+	if (redo_nworkers == 0)
+		return;
+
+	for (;;)
+	{
+		bool		done = true;
+		int			i;
+
+		ParallelRedoServiceWorkers();
+
+		for (i = 0; i < redo_nworkers; i++)
+		{
+			ParallelRedoWorkerSlot *slot = &redo_shared->slots[i];
+			uint64		applied;
+
+			SpinLockAcquire(&slot->mutex);
+			applied = slot->applied;
+			SpinLockRelease(&slot->mutex);
+
+			if (applied != redo_sent[i])
+			{
+				done = false;
+				break;
+			}
+		}
+
+		if (done)
+			break;
+
+		ParallelRedoCheckWorkers();
+		ParallelRedoWait();
+	}
+}
+
+/*
+ * Wait for the workers to finish what they have been sent, and shut them
+ * down.  Called at the end of redo.
+ */
+void
+ParallelRedoShutdown(void)
+{
+	int			i;
+
+	if (redo_seg == NULL)
+		return;
+
+	ParallelRedoWaitForWorkers();
+
+	/* detaching from the queues tells the workers to exit */
+	dsm_detach(redo_seg);
+	redo_seg = NULL;
+	redo_shared = NULL;
+
+	for (i = 0; i < redo_nworkers; i++)
+	{
+		if (redo_handle[i] != NULL)
+		{
+			ParallelRedoWaitForWorkerPid(redo_handle[i], BGWH_STARTED);
+			pfree(redo_handle[i]);
+		}
+	}
+
+	pfree(redo_mqh);
+	pfree(redo_handle);
+	pfree(redo_sent);
+	redo_mqh = NULL;
+	redo_handle = NULL;
+	redo_sent = NULL;
+	redo_nworkers = 0;
+}
+
+/*
+ * Which worker should replay this record?  Returns -1 if it has to be
+ * replayed by the startup process, after everything before it.
+ *
+ * Only records that don't do anything but modify pages of a single relation
+ * are dispatched.  Notably, records that may have to resolve recovery
+ * conflicts with hot standby queries, or take cleanup locks, are left to the
+ * startup process, which is the only process equipped to do that.
+ */
+static int
+ParallelRedoTarget(XLogReaderState *record)
+{
+	uint8		info = XLogRecGetInfo(record) & ~XLR_INFO_MASK;
+	RelFileNode rnode;
+	int			block_id;
+	bool		found = false;
+
+	switch (XLogRecGetRmid(record))
+	{
+		case RM_HEAP_ID:
+			/* pruning, freezing and the like are all in RM_HEAP2_ID */
+			if (InHotStandby && ParallelRedoClearsAllVisible(record))
+				return -1;
+			break;
+
+		case RM_HEAP2_ID:
+			switch (info & XLOG_HEAP_OPMASK)
+			{
+				case XLOG_HEAP2_MULTI_INSERT:
+					if (InHotStandby && ParallelRedoClearsAllVisible(record))
+						return -1;
+					break;
+				case XLOG_HEAP2_LOCK_UPDATED:
+					break;
+				default:
+					return -1;
+			}
+			break;
+
+		case RM_BTREE_ID:
+			switch (info)
+			{
+				case XLOG_BTREE_INSERT_LEAF:
+				case XLOG_BTREE_INSERT_UPPER:
+				case XLOG_BTREE_INSERT_META:
+				case XLOG_BTREE_SPLIT_L:
+				case XLOG_BTREE_SPLIT_R:
+				case XLOG_BTREE_SPLIT_L_ROOT:
+				case XLOG_BTREE_SPLIT_R_ROOT:
+				case XLOG_BTREE_UNLINK_PAGE:
+				case XLOG_BTREE_UNLINK_PAGE_META:
+				case XLOG_BTREE_NEWROOT:
+				case XLOG_BTREE_MARK_PAGE_HALFDEAD:
+					break;
+				default:
+					/* VACUUM, DELETE and REUSE_PAGE */
+					return -1;
+			}
+			break;
+
+		case RM_XLOG_ID:
+			if (info != XLOG_FPI && info != XLOG_FPI_FOR_HINT)
+				return -1;
+			break;
+
+		default:
+			return -1;
+	}
+
+	/* all the blocks have to belong to the same relation */
+	for (block_id = 0; block_id <= record->max_block_id; block_id++)
+	{
+		RelFileNode blk_rnode;
+
+		if (!XLogRecHasBlockRef(record, block_id))
+			continue;
+
+		XLogRecGetBlockTag(record, block_id, &blk_rnode, NULL, NULL);
+		if (!found)
+		{
+			rnode = blk_rnode;
+			found = true;
+		}
+		else if (!RelFileNodeEquals(rnode, blk_rnode))
+			return -1;
+	}
+
+	if (!found)
+		return -1;
+
+	return hash_any((unsigned char *) &rnode, sizeof(RelFileNode)) %
+		redo_nworkers;
+}
+
+/*
+ * Does this heap record clear the all-visible bit of a page?
+ *
+ * The index entries for a new tuple version are inserted by records of
+ * their own, which are likely to go to a different worker than the heap
+ * record.  If the index insertion were replayed first, an index-only scan on
+ * the standby could find the new entry on a page still marked all-visible in
+ * the visibility map, and return it without looking at the heap.  So under
+ * hot standby, such heap records are barriers: the index records after them
+ * are only dispatched once the visibility map bit is cleared.
+ */
+static bool
+ParallelRedoClearsAllVisible(XLogReaderState *record)
+{
+	uint8		info = XLogRecGetInfo(record) & ~XLR_INFO_MASK;
+	char	   *data = XLogRecGetData(record);
+
+	if (XLogRecGetRmid(record) == RM_HEAP2_ID)
+	{
+		Assert((info & XLOG_HEAP_OPMASK) == XLOG_HEAP2_MULTI_INSERT);
+		return (((xl_heap_multi_insert *) data)->flags &
+				XLH_INSERT_ALL_VISIBLE_CLEARED) != 0;
+	}
+
+	switch (info & XLOG_HEAP_OPMASK)
+	{
+		case XLOG_HEAP_INSERT:
+			return (((xl_heap_insert *) data)->flags &
+					XLH_INSERT_ALL_VISIBLE_CLEARED) != 0;
+		case XLOG_HEAP_DELETE:
+			return (((xl_heap_delete *) data)->flags &
+					XLH_DELETE_ALL_VISIBLE_CLEARED) != 0;
+		case XLOG_HEAP_UPDATE:
+		case XLOG_HEAP_HOT_UPDATE:
+			return (((xl_heap_update *) data)->flags &
+					(XLH_UPDATE_OLD_ALL_VISIBLE_CLEARED |
+					 XLH_UPDATE_NEW_ALL_VISIBLE_CLEARED)) != 0;
+		default:
+			return false;
+	}
+}
+
+/*
+ * Might replaying this record remove, truncate or extend relation files
+ * behind the back of the workers' smgr caches?
+ */
+static bool
+ParallelRedoInvalidatesSmgr(XLogReaderState *record)
+{
+	uint8		info = XLogRecGetInfo(record);
+
+	switch (XLogRecGetRmid(record))
+	{
+		case RM_SMGR_ID:
+		case RM_DBASE_ID:
+		case RM_TBLSPC_ID:
+		case RM_HEAP2_ID:		/* XLOG_HEAP2_VISIBLE extends the VM */
+			return true;
+
+		case RM_XACT_ID:
+			switch (info & XLOG_XACT_OPMASK)
+			{
+				case XLOG_XACT_COMMIT:
+				case XLOG_XACT_COMMIT_PREPARED:
+					{
+						xl_xact_parsed_commit parsed;
+
+						ParseCommitRecord(info,
+							   (xl_xact_commit *) XLogRecGetData(record),
+										  &parsed);
+						return parsed.nrels > 0;
+					}
+				case XLOG_XACT_ABORT:
+				case XLOG_XACT_ABORT_PREPARED:
+					{
+						xl_xact_parsed_abort parsed;
+
+						ParseAbortRecord(info,
+								(xl_xact_abort *) XLogRecGetData(record),
+										 &parsed);
+						return parsed.nrels > 0;
+					}
+			}
+			return false;
+
+		default:
+			return false;
+	}
+}
+
+/*
+ * Record the references to invalid pages workers have asked us to, and let
+ * them continue.
+ */
+static void
+ParallelRedoServiceWorkers(void)
+{
+	int			i;
+
+	SpinLockAcquire(&redo_shared->mutex);
+	redo_shared->invalid_pages_pending = false;
+	SpinLockRelease(&redo_shared->mutex);
+
+	for (i = 0; i < redo_nworkers; i++)
+	{
+		ParallelRedoWorkerSlot *slot = &redo_shared->slots[i];
+		bool		pending;
+		RelFileNode node;
+		ForkNumber	forkno;
+		BlockNumber blkno;
+		bool		present;
+
+		SpinLockAcquire(&slot->mutex);
+		pending = slot->invalid_page_pending;
+		node = slot->invalid_node;
+		forkno = slot->invalid_forkno;
+		blkno = slot->invalid_blkno;
+		present = slot->invalid_present;
+		SpinLockRelease(&slot->mutex);
+
+		if (!pending)
+			continue;
+
+		XLogNoteInvalidPage(node, forkno, blkno, present);
+
+		SpinLockAcquire(&slot->mutex);
+		slot->invalid_page_pending = false;
+		SpinLockRelease(&slot->mutex);
+		SetLatch(&slot->proc->procLatch);
+	}
+}
+
+/*
+ * Bail out if a worker has died; it would never catch up.
+ */
+static void
+ParallelRedoCheckWorkers(void)
+{
+	int			i;
+
+	for (i = 0; i < redo_nworkers; i++)
+	{
+		pid_t		pid;
+
+		if (GetBackgroundWorkerPid(redo_handle[i], &pid) != BGWH_STARTED)
+			ereport(FATAL,
+					(errmsg("parallel redo worker terminated unexpectedly")));
+	}
+}
+
+/*
+ * Sleep until a worker wakes us up, or briefly.  The timeout covers for
+ * wakeups we don't ask for explicitly, and for signals to the startup
+ * process, which don't set our latch.
+ */
+static void
+ParallelRedoWait(void)
+{
+	WaitLatch(MyLatch, WL_LATCH_SET | WL_TIMEOUT | WL_POSTMASTER_DEATH, 10L);
+	ResetLatch(MyLatch);
+	HandleStartupProcInterrupts();
+}
+
+/*
+ * Wait for a worker to leave the given state, and return its new one.  This
+ * is WaitForBackgroundWorkerStartup() and WaitForBackgroundWorkerShutdown()
+ * for the startup process, whose latch the postmaster's notifications don't
+ * set.
+ */
+static BgwHandleStatus
+ParallelRedoWaitForWorkerPid(BackgroundWorkerHandle *handle,
+							 BgwHandleStatus waitfor)
+{
+	BgwHandleStatus status;
+	pid_t		pid;
+
+	while ((status = GetBackgroundWorkerPid(handle, &pid)) == waitfor)
+		ParallelRedoWait();
+
+	return status;
+}
+
+/*
+ * Called by log_invalid_page() in a redo worker: the startup process keeps
+ * track of all invalid pages, so hand it the reference and wait until it has
+ * dealt with it.
+ */
+void
+ParallelRedoReportInvalidPage(RelFileNode node, ForkNumber forkno,
+							  BlockNumber blkno, bool present)
+{
+	ParallelRedoShared *shared;
+
+	Assert(ParallelRedoWorkerNumber >= 0);
+
+	SpinLockAcquire(&MyRedoSlot->mutex);
+	MyRedoSlot->invalid_node = node;
+	MyRedoSlot->invalid_forkno = forkno;
+	MyRedoSlot->invalid_blkno = blkno;
+	MyRedoSlot->invalid_present = present;
+	MyRedoSlot->invalid_page_pending = true;
+	SpinLockRelease(&MyRedoSlot->mutex);
+
+	shared = (ParallelRedoShared *)
+		((char *) (MyRedoSlot - ParallelRedoWorkerNumber) -
+		 offsetof(ParallelRedoShared, slots));
+	SpinLockAcquire(&shared->mutex);
+	shared->invalid_pages_pending = true;
+	SpinLockRelease(&shared->mutex);
+	SetLatch(&shared->startup_proc->procLatch);
+
+	for (;;)
+	{
+		bool		pending;
+
+		SpinLockAcquire(&MyRedoSlot->mutex);
+		pending = MyRedoSlot->invalid_page_pending;
+		SpinLockRelease(&MyRedoSlot->mutex);
+
+		if (!pending)
+			break;
+
+		WaitLatch(MyLatch, WL_LATCH_SET | WL_TIMEOUT | WL_POSTMASTER_DEATH,
+				  10L);
+		ResetLatch(MyLatch);
+		CHECK_FOR_INTERRUPTS();
+	}
+}
+
+/*
+ * Main entrypoint of a redo worker.
+ */
+static void
+ParallelRedoWorkerMain(Datum main_arg)
+{
+	dsm_segment *seg;
+	shm_toc    *toc;
+	ParallelRedoShared *shared;
+	char	   *queues;
+	shm_mq	   *mq;
+	shm_mq_handle *mqh;
+	XLogReaderState *reader;
+	MemoryContext redo_context;
+	uint32		smgr_generation = 0;
+
+	/* Establish signal handlers. */
+	pqsignal(SIGTERM, die);
+	BackgroundWorkerUnblockSignals();
+
+	/* Set up a memory context and resource owner. */
+	Assert(CurrentResourceOwner == NULL);
+	CurrentResourceOwner = ResourceOwnerCreate(NULL, "parallel redo");
+	CurrentMemoryContext = AllocSetContextCreate(TopMemoryContext,
+												 "parallel redo worker",
+												 ALLOCSET_DEFAULT_MINSIZE,
+												 ALLOCSET_DEFAULT_INITSIZE,
+												 ALLOCSET_DEFAULT_MAXSIZE);
+	redo_context = AllocSetContextCreate(CurrentMemoryContext,
+										 "parallel redo record",
+										 ALLOCSET_DEFAULT_MINSIZE,
+										 ALLOCSET_DEFAULT_INITSIZE,
+										 ALLOCSET_DEFAULT_MAXSIZE);
+
+	seg = dsm_attach(DatumGetUInt32(main_arg));
+	if (seg == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("unable to map dynamic shared memory segment")));
+	toc = shm_toc_attach(PARALLEL_REDO_MAGIC, dsm_segment_address(seg));
+	if (toc == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+			   errmsg("bad magic number in dynamic shared memory segment")));
+	shared = shm_toc_lookup(toc, PARALLEL_REDO_KEY_SHARED);
+	queues = shm_toc_lookup(toc, PARALLEL_REDO_KEY_QUEUES);
+	Assert(shared != NULL && queues != NULL);
+
+	/* Determine our worker number, and attach to our queue. */
+	SpinLockAcquire(&shared->mutex);
+	if (shared->workers_attached < shared->nworkers)
+		ParallelRedoWorkerNumber = shared->workers_attached++;
+	smgr_generation = shared->smgr_generation;
+	SpinLockRelease(&shared->mutex);
+	if (ParallelRedoWorkerNumber < 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("too many parallel redo workers already attached")));
+
+	MyRedoSlot = &shared->slots[ParallelRedoWorkerNumber];
+	SpinLockAcquire(&MyRedoSlot->mutex);
+	MyRedoSlot->proc = MyProc;
+	SpinLockRelease(&MyRedoSlot->mutex);
+
+	mq = (shm_mq *) (queues +
+					 ParallelRedoWorkerNumber * PARALLEL_REDO_QUEUE_SIZE);
+	shm_mq_set_receiver(mq, MyProc);
+	mqh = shm_mq_attach(mq, seg, NULL);
+
+	SetLatch(&shared->startup_proc->procLatch);
+
+	/*
+	 * Behave like the startup process as far as redo routines can tell.
+	 * standbyState can change during recovery, so it comes with each record.
+	 */
+	InRecovery = true;
+
+	reader = XLogReaderAllocate(NULL, NULL);
+	if (reader == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of memory")));
+
+	for (;;)
+	{
+		shm_mq_result res;
+		Size		nbytes;
+		void	   *data;
+		ParallelRedoRecordHeader hdr;
+		char	   *errormsg;
+		uint32		generation;
+		ErrorContextCallback errcallback;
+
+		res = shm_mq_receive(mqh, &nbytes, &data, false);
+		if (res != SHM_MQ_SUCCESS)
+			break;				/* the startup process is done */
+
+		/* close files that might have been dropped or truncated meanwhile */
+		SpinLockAcquire(&shared->mutex);
+		generation = shared->smgr_generation;
+		SpinLockRelease(&shared->mutex);
+		if (generation != smgr_generation)
+		{
+			smgrcloseall();
+			smgr_generation = generation;
+		}
+
+		Assert(nbytes > sizeof(hdr));
+		memcpy(&hdr, data, sizeof(hdr));
+		reader->ReadRecPtr = hdr.ReadRecPtr;
+		reader->EndRecPtr = hdr.EndRecPtr;
+		standbyState = hdr.standbyState;
+		if (!DecodeXLogRecord(reader,
+							  (XLogRecord *) ((char *) data + sizeof(hdr)),
+							  &errormsg))
+			elog(ERROR, "could not decode WAL record at %X/%X: %s",
+				 (uint32) (hdr.ReadRecPtr >> 32), (uint32) hdr.ReadRecPtr,
+				 errormsg);
+
+		errcallback.callback = ParallelRedoErrorCallback;
+		errcallback.arg = (void *) reader;
+		errcallback.previous = error_context_stack;
+		error_context_stack = &errcallback;
+
+		MemoryContextSwitchTo(redo_context);
+		RmgrTable[XLogRecGetRmid(reader)].rm_redo(reader);
+		MemoryContextSwitchTo(redo_context->parent);
+		MemoryContextReset(redo_context);
+
+		error_context_stack = errcallback.previous;
+
+		SpinLockAcquire(&MyRedoSlot->mutex);
+		MyRedoSlot->applied++;
+		SpinLockRelease(&MyRedoSlot->mutex);
+
+		/* the startup process might be waiting for us */
+		SetLatch(&shared->startup_proc->procLatch);
+	}
+
+	XLogReaderFree(reader);
+	dsm_detach(seg);
+}
+
+/*
+ * Error context callback for errors occurring during rm_redo() in a worker.
+ */
+static void
+ParallelRedoErrorCallback(void *arg)
+{
+	XLogReaderState *record = (XLogReaderState *) arg;
+	RmgrId		rmid = XLogRecGetRmid(record);
+	uint8		info = XLogRecGetInfo(record);
+	StringInfoData buf;
+	const char *id;
+
+	initStringInfo(&buf);
+	appendStringInfoString(&buf, RmgrTable[rmid].rm_name);
+	appendStringInfoChar(&buf, '/');
+	id = RmgrTable[rmid].rm_identify(info);
+	if (id == NULL)
+		appendStringInfo(&buf, "UNKNOWN (%X): ", info & ~XLR_INFO_MASK);
+	else
+		appendStringInfo(&buf, "%s: ", id);
+	RmgrTable[rmid].rm_desc(&buf, record);
+
+	errcontext("xlog redo at %X/%X in parallel redo worker %d: %s",
+			   (uint32) (record->ReadRecPtr >> 32),
+			   (uint32) record->ReadRecPtr,
+			   ParallelRedoWorkerNumber, buf.data);
+
+	pfree(buf.data);
+}
@@ -0,0 +1,586 @@
+/*-------------------------------------------------------------------------
+ *
+ * xlogprefetch.c
+ *	  Prefetching of blocks referenced by WAL records during recovery
+ *
+ * Without prefetching, each block referenced by a WAL record that isn't in
+ * shared buffers is read synchronously when the record is replayed, so replay
+ * on a busy standby spends most of its time waiting for I/O.  To avoid that,
+ * the startup process decodes WAL up to recovery_prefetch_distance bytes ahead
+ * of the record being replayed, with a separate XLogReaderState, and issues
+ * asynchronous reads (posix_fadvise) for the blocks those records reference
+ * that aren't already cached.  Blocks that will be restored from a full-page
+ * image, or that redo initializes from scratch, aren't read by replay at all,
+ * so they are skipped.
+ *
+ * The look-ahead reader reads WAL segment files from pg_xlog directly, and
+ * simply gives up for the time being when it runs out of valid WAL; it tries
+ * again as replay progresses.  Segments restored from the archive aren't
+ * visible to it, so prefetching only helps during crash recovery and when
+ * the WAL is streamed.
+ *
+ * Relation files must not be opened before they have been created, or after
+ * they have been dropped or truncated, so the look-ahead stops at records
+ * that might do that, until they have been replayed.  We also don't prefetch
+ * blocks past the current end of a relation, which replay is going to
+ * extend it with.
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/backend/access/transam/xlogprefetch.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "access/htup_details.h"
+#include "access/xact.h"
+#include "access/xlog_internal.h"
+#include "access/xlogprefetch.h"
+#include "catalog/pg_type.h"
+#include "funcapi.h"
+#include "storage/bufmgr.h"
+#include "storage/fd.h"
+#include "storage/shmem.h"
+#include "storage/smgr.h"
+#include "storage/spin.h"
+#include "utils/hsearch.h"
+#include "utils/memutils.h"
+
+/* number of recently prefetched blocks remembered, to avoid repeats */
+#define XLOGPREFETCHER_RECENT_BLOCKS	16
+
+/* GUC variable */
+int			recovery_prefetch_distance = 0;
+
+/* Prefetch statistics, shown in pg_stat_wal_prefetch */
+typedef struct XLogPrefetchStats
+{
+	uint64		prefetch;		/* prefetches initiated */
+	uint64		hit;			/* blocks already in shared buffers */
+	uint64		skip_init;		/* blocks redo will initialize */
+	uint64		skip_new;		/* blocks past the end of the relation */
+	uint64		skip_fpw;		/* blocks with full-page images */
+	uint64		skip_rep;		/* blocks recently prefetched */
+	uint32		distance;		/* bytes of WAL decoded ahead of replay */
+} XLogPrefetchStats;
+
+typedef struct XLogPrefetchShared
+{
+	slock_t		mutex;			/* protects stats */
+	XLogPrefetchStats stats;
+} XLogPrefetchShared;
+
+static XLogPrefetchShared *XLogPrefetchCtl = NULL;
+
+/* Relation sizes, as far as the look-ahead is concerned */
+typedef struct XLogPrefetchRelKey
+{
+	RelFileNode rnode;
+	ForkNumber	forknum;
+} XLogPrefetchRelKey;
+
+typedef struct XLogPrefetchRelEntry
+{
+	XLogPrefetchRelKey key;		/* hash key (must be first) */
+	bool		exists;
+	BlockNumber nblocks;
+} XLogPrefetchRelEntry;
+
+typedef struct XLogPrefetchBlock
+{
+	RelFileNode rnode;
+	ForkNumber	forknum;
+	BlockNumber blkno;
+} XLogPrefetchBlock;
+
+struct XLogPrefetcher
+{
+	MemoryContext context;
+	XLogReaderState *reader;	/* look-ahead reader */
+
+	/* WAL segment being read by the look-ahead */
+	TimeLineID	tli;
+	int			readFile;
+	XLogSegNo	readSegNo;
+
+	bool		reading;		/* reader positioned to continue? */
+	XLogRecPtr	next_lsn;		/* end of the last record examined */
+	XLogRecPtr	retry_lsn;		/* after failing, retry once replay is here */
+	bool		blocked;		/* waiting for a record to be replayed? */
+	XLogRecPtr	blocked_lsn;	/* ... this one */
+
+	HTAB	   *relsizes;
+	XLogPrefetchBlock recent[XLOGPREFETCHER_RECENT_BLOCKS];
+	int			next_recent;
+
+	XLogPrefetchStats stats;
+};
+
+static int XLogPrefetcherReadPage(XLogReaderState *reader,
+					   XLogRecPtr targetPagePtr, int reqLen,
+					   XLogRecPtr targetRecPtr, char *readBuf,
+					   TimeLineID *pageTLI);
+static void XLogPrefetcherReset(XLogPrefetcher *prefetcher);
+static void XLogPrefetcherResetRelSizes(XLogPrefetcher *prefetcher);
+static bool XLogPrefetcherIsBarrier(XLogReaderState *record);
+static void XLogPrefetcherScanBlocks(XLogPrefetcher *prefetcher);
+static bool XLogPrefetcherBlockExists(XLogPrefetcher *prefetcher,
+						  SMgrRelation smgr, ForkNumber forknum,
+						  BlockNumber blkno);
+static void XLogPrefetcherPublishStats(XLogPrefetcher *prefetcher,
+						   XLogRecPtr replaying);
+
+/*
+ * Initialization of shared memory for prefetch statistics
+ */
+Size
+XLogPrefetchShmemSize(void)
+{
+	return sizeof(XLogPrefetchShared);
+}
+
+void
+XLogPrefetchShmemInit(void)
+{
+	bool		found;
+
+	XLogPrefetchCtl = (XLogPrefetchShared *)
+		ShmemInitStruct("XLog Prefetch Ctl", XLogPrefetchShmemSize(), &found);
+
+	if (!found)
+	{
+		SpinLockInit(&XLogPrefetchCtl->mutex);
+		memset(&XLogPrefetchCtl->stats, 0, sizeof(XLogPrefetchStats));
+	}
+}
+
+/*
+ * Create a prefetcher, for the startup process' redo loop.  Whether it does
+ * anything is decided by recovery_prefetch_distance on each call to
+ * XLogPrefetcherReadAhead.
+ */
+XLogPrefetcher *
+XLogPrefetcherAllocate(void)
+{
+	XLogPrefetcher *prefetcher;
+	MemoryContext context;
+
+	context = AllocSetContextCreate(TopMemoryContext,
+									"XLog prefetcher",
+									ALLOCSET_SMALL_MINSIZE,
+									ALLOCSET_SMALL_INITSIZE,
+									ALLOCSET_DEFAULT_MAXSIZE);
+	prefetcher = MemoryContextAllocZero(context, sizeof(XLogPrefetcher));
+	prefetcher->context = context;
+	prefetcher->readFile = -1;
+
+	prefetcher->reader = XLogReaderAllocate(XLogPrefetcherReadPage, prefetcher);
+	if (prefetcher->reader == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of memory"),
+			errdetail("Failed while allocating an XLog prefetching reader.")));
+
+	XLogPrefetcherResetRelSizes(prefetcher);
+
+	/* statistics cover the current recovery only */
+	SpinLockAcquire(&XLogPrefetchCtl->mutex);
+	memset(&XLogPrefetchCtl->stats, 0, sizeof(XLogPrefetchStats));
+	SpinLockRelease(&XLogPrefetchCtl->mutex);
+
+	return prefetcher;
+}
+
+void
+XLogPrefetcherFree(XLogPrefetcher *prefetcher)
+{
+	XLogPrefetcherReset(prefetcher);
+	XLogPrefetcherPublishStats(prefetcher, InvalidXLogRecPtr);
+	XLogReaderFree(prefetcher->reader);
+	MemoryContextDelete(prefetcher->context);
+}
+
+/*
+ * Called by the redo loop before replaying the record in 'replay': decode
+ * ahead of it, and issue prefetches for the blocks that will be needed.
+ */
+void
+XLogPrefetcherReadAhead(XLogPrefetcher *prefetcher, XLogReaderState *replay)
+{
+	XLogRecPtr	replaying = replay->ReadRecPtr;
+	uint64		distance = (uint64) recovery_prefetch_distance * 1024;
+
+	if (distance == 0)
+	{
+		if (prefetcher->reading || prefetcher->blocked)
+		{
+			XLogPrefetcherReset(prefetcher);
+			XLogPrefetcherPublishStats(prefetcher, InvalidXLogRecPtr);
+		}
+		return;
+	}
+
+	/* follow replay onto a new timeline */
+	if (replay->readPageTLI != prefetcher->tli)
+	{
+		XLogPrefetcherReset(prefetcher);
+		prefetcher->tli = replay->readPageTLI;
+	}
+
+	/* If we're waiting for a record to be replayed, check if it has been. */
+	if (prefetcher->blocked)
+	{
+		if (replaying <= prefetcher->blocked_lsn)
+			goto done;
+		prefetcher->blocked = false;
+		XLogPrefetcherResetRelSizes(prefetcher);
+	}
+
+	/* If replay has overtaken us, start over from where it is. */
+	if (prefetcher->reading && replaying >= prefetcher->next_lsn)
+		prefetcher->reading = false;
+
+	if (!prefetcher->reading && replaying < prefetcher->retry_lsn)
+		goto done;
+
+	while (!prefetcher->reading ||
+		   prefetcher->reader->EndRecPtr < replaying + distance)
+	{
+		XLogRecord *record;
+		char	   *errormsg;
+
+		record = XLogReadRecord(prefetcher->reader,
+								prefetcher->reading ?
+								InvalidXLogRecPtr : replaying,
+								&errormsg);
+		if (record == NULL)
+		{
+			/* out of WAL for now, try again a little later */
+			prefetcher->reading = false;
+			prefetcher->retry_lsn = replaying + XLOG_BLCKSZ;
+			break;
+		}
+		prefetcher->reading = true;
+
+		/* skip what we've already examined when restarting */
+		if (prefetcher->reader->ReadRecPtr < prefetcher->next_lsn)
+			continue;
+		prefetcher->next_lsn = prefetcher->reader->EndRecPtr;
+
+		if (XLogPrefetcherIsBarrier(prefetcher->reader))
+		{
+			prefetcher->blocked = true;
+			prefetcher->blocked_lsn = prefetcher->reader->ReadRecPtr;
+			break;
+		}
+
+		XLogPrefetcherScanBlocks(prefetcher);
+	}
+
+done:
+	XLogPrefetcherPublishStats(prefetcher, replaying);
+}
+
+/*
+ * Stop looking ahead; the next call starts over from the replay position.
+ */
+static void
+XLogPrefetcherReset(XLogPrefetcher *prefetcher)
+{
+	if (prefetcher->readFile >= 0)
+	{
+		close(prefetcher->readFile);
+		prefetcher->readFile = -1;
+	}
+	prefetcher->reading = false;
+	prefetcher->next_lsn = InvalidXLogRecPtr;
+	prefetcher->retry_lsn = InvalidXLogRecPtr;
+	prefetcher->blocked = false;
+	XLogPrefetcherResetRelSizes(prefetcher);
+}
+
+static void
+XLogPrefetcherResetRelSizes(XLogPrefetcher *prefetcher)
+{
+	HASHCTL		ctl;
+
+	if (prefetcher->relsizes != NULL)
+		hash_destroy(prefetcher->relsizes);
+
+	memset(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(XLogPrefetchRelKey);
+	ctl.entrysize = sizeof(XLogPrefetchRelEntry);
+	ctl.hcxt = prefetcher->context;
+	prefetcher->relsizes = hash_create("XLog prefetcher relation sizes", 64,
+									   &ctl,
+									   HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+
+	memset(prefetcher->recent, 0, sizeof(prefetcher->recent));
+	prefetcher->next_recent = 0;
+}
+
+/*
+ * Might replaying this record create, drop or truncate relation files?  We
+ * must not look past it until it has been replayed.
+ */
+static bool
+XLogPrefetcherIsBarrier(XLogReaderState *record)
+{
+	uint8		info = XLogRecGetInfo(record);
+
+	switch (XLogRecGetRmid(record))
+	{
+		case RM_SMGR_ID:
+		case RM_DBASE_ID:
+		case RM_TBLSPC_ID:
+			return true;
+
+		case RM_XACT_ID:
+			switch (info & XLOG_XACT_OPMASK)
+			{
+				case XLOG_XACT_COMMIT:
+				case XLOG_XACT_COMMIT_PREPARED:
+					{
+						xl_xact_parsed_commit parsed;
+
+						ParseCommitRecord(info,
+							   (xl_xact_commit *) XLogRecGetData(record),
+										  &parsed);
+						return parsed.nrels > 0;
+					}
+				case XLOG_XACT_ABORT:
+				case XLOG_XACT_ABORT_PREPARED:
+					{
+						xl_xact_parsed_abort parsed;
+
+						ParseAbortRecord(info,
+								(xl_xact_abort *) XLogRecGetData(record),
+										 &parsed);
+						return parsed.nrels > 0;
+					}
+			}
+			return false;
+
+		default:
+			return false;
+	}
+}
+
+/*
+ * Issue prefetches for the blocks referenced by the record just decoded.
+ */
+static void
+XLogPrefetcherScanBlocks(XLogPrefetcher *prefetcher)
+{
+	XLogReaderState *reader = prefetcher->reader;
+	int			block_id;
+
+	for (block_id = 0; block_id <= reader->max_block_id; block_id++)
+	{
+		DecodedBkpBlock *block = &reader->blocks[block_id];
+		XLogPrefetchBlock *recent;
+		SMgrRelation smgr;
+		int			i;
+
+		if (!block->in_use)
+			continue;
+
+		/* replay won't read these */
+		if (block->has_image)
+		{
+			prefetcher->stats.skip_fpw++;
+			continue;
+		}
+		if (block->flags & BKPBLOCK_WILL_INIT)
+		{
+			prefetcher->stats.skip_init++;
+			continue;
+		}
+
+		/* consecutive records often modify the same block */
+		for (i = 0; i < XLOGPREFETCHER_RECENT_BLOCKS; i++)
+		{
+			recent = &prefetcher->recent[i];
+			if (recent->blkno == block->blkno &&
+				recent->forknum == block->forknum &&
+				RelFileNodeEquals(recent->rnode, block->rnode))
+				break;
+		}
+		if (i < XLOGPREFETCHER_RECENT_BLOCKS)
+		{
+			prefetcher->stats.skip_rep++;
+			continue;
+		}
+		recent = &prefetcher->recent[prefetcher->next_recent];
+		recent->rnode = block->rnode;
+		recent->forknum = block->forknum;
+		recent->blkno = block->blkno;
+		prefetcher->next_recent = (prefetcher->next_recent + 1) %
+			XLOGPREFETCHER_RECENT_BLOCKS;
+
+		smgr = smgropen(block->rnode, InvalidBackendId);
+		if (!XLogPrefetcherBlockExists(prefetcher, smgr, block->forknum,
+									   block->blkno))
+		{
+			prefetcher->stats.skip_new++;
+			continue;
+		}
+
+		if (PrefetchSharedBuffer(smgr, block->forknum, block->blkno))
+			prefetcher->stats.prefetch++;
+		else
+			prefetcher->stats.hit++;
+	}
+}
+
+/*
+ * Does the block exist on disk now?  Relation sizes are remembered, so that
+ * we only look at the file again when referencing blocks beyond its end.
+ */
+static bool
+XLogPrefetcherBlockExists(XLogPrefetcher *prefetcher, SMgrRelation smgr,
+						  ForkNumber forknum, BlockNumber blkno)
+{
+	XLogPrefetchRelKey key;
+	XLogPrefetchRelEntry *entry;
+	bool		found;
+
+	memset(&key, 0, sizeof(key));
+	key.rnode = smgr->smgr_rnode.node;
+	key.forknum = forknum;
+
+	entry = hash_search(prefetcher->relsizes, &key, HASH_ENTER, &found);
+	if (!found)
+	{
+		entry->exists = smgrexists(smgr, forknum);
+		entry->nblocks = entry->exists ? smgrnblocks(smgr, forknum) : 0;
+	}
+	else if (entry->exists && blkno >= entry->nblocks)
+		entry->nblocks = smgrnblocks(smgr, forknum);
+
+	return entry->exists && blkno < entry->nblocks;
+}
+
+/*
+ * Make our statistics visible to pg_stat_wal_prefetch.
+ */
+static void
+XLogPrefetcherPublishStats(XLogPrefetcher *prefetcher, XLogRecPtr replaying)
+{
+	if (prefetcher->reading && replaying != InvalidXLogRecPtr &&
+		prefetcher->reader->EndRecPtr > replaying)
+		prefetcher->stats.distance = prefetcher->reader->EndRecPtr - replaying;
+	else
+		prefetcher->stats.distance = 0;
+
+	SpinLockAcquire(&XLogPrefetchCtl->mutex);
+	XLogPrefetchCtl->stats = prefetcher->stats;
+	SpinLockRelease(&XLogPrefetchCtl->mutex);
+}
+
+/*
+ * read_page callback for the look-ahead reader.  This reads straight from
+ * the segment files in pg_xlog, and fails quietly if the WAL isn't there yet;
+ * the reader will then notice and report anything that isn't valid WAL.
+ */
+static int
+XLogPrefetcherReadPage(XLogReaderState *reader, XLogRecPtr targetPagePtr,
+					   int reqLen, XLogRecPtr targetRecPtr, char *readBuf,
+					   TimeLineID *pageTLI)
+{
+	XLogPrefetcher *prefetcher = (XLogPrefetcher *) reader->private_data;
+	XLogSegNo	segno;
+	uint32		offset;
+
+	XLByteToSeg(targetPagePtr, segno);
+	offset = targetPagePtr % XLogSegSize;
+
+	if (prefetcher->readFile >= 0 && segno != prefetcher->readSegNo)
+	{
+		close(prefetcher->readFile);
+		prefetcher->readFile = -1;
+	}
+
+	if (prefetcher->readFile < 0)
+	{
+		char		path[MAXPGPATH];
+
+		XLogFilePath(path, prefetcher->tli, segno);
+		prefetcher->readFile = BasicOpenFile(path, O_RDONLY | PG_BINARY, 0);
+		if (prefetcher->readFile < 0)
+			return -1;
+		prefetcher->readSegNo = segno;
+	}
+
+	if (lseek(prefetcher->readFile, (off_t) offset, SEEK_SET) < 0 ||
+		read(prefetcher->readFile, readBuf, XLOG_BLCKSZ) != XLOG_BLCKSZ)
+	{
+		close(prefetcher->readFile);
+		prefetcher->readFile = -1;
+		return -1;
+	}
+
+	*pageTLI = prefetcher->tli;
+	return XLOG_BLCKSZ;
+}
+
+/*
+ * SQL-callable function returning the contents of pg_stat_wal_prefetch
+ */
+Datum
+pg_stat_get_wal_prefetch(PG_FUNCTION_ARGS)
+{
+	TupleDesc	tupdesc;
+	Datum		values[8];
+	bool		nulls[8];
+	XLogPrefetchStats stats;
+	uint64		lookups;
+
+	MemSet(values, 0, sizeof(values));
+	MemSet(nulls, 0, sizeof(nulls));
+
+	tupdesc = CreateTemplateTupleDesc(8, false);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 1, "prefetch",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 2, "hit",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 3, "skip_init",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 4, "skip_new",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 5, "skip_fpw",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 6, "skip_rep",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 7, "hit_ratio",
+					   FLOAT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 8, "distance",
+					   INT4OID, -1, 0);
+	BlessTupleDesc(tupdesc);
+
+	SpinLockAcquire(&XLogPrefetchCtl->mutex);
+	stats = XLogPrefetchCtl->stats;
+	SpinLockRelease(&XLogPrefetchCtl->mutex);
+
+	values[0] = Int64GetDatum((int64) stats.prefetch);
+	values[1] = Int64GetDatum((int64) stats.hit);
+	values[2] = Int64GetDatum((int64) stats.skip_init);
+	values[3] = Int64GetDatum((int64) stats.skip_new);
+	values[4] = Int64GetDatum((int64) stats.skip_fpw);
+	values[5] = Int64GetDatum((int64) stats.skip_rep);
+	lookups = stats.prefetch + stats.hit;
+	if (lookups > 0)
+		values[6] = Float8GetDatum((double) stats.hit / (double) lookups);
+	else
+		nulls[6] = true;
+	values[7] = Int32GetDatum((int32) stats.distance);
+
+	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
+}
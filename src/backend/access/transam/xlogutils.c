@@ -18,6 +18,7 @@
 #include "postgres.h"
 
 #include "access/xlog.h"
+#include "access/xlogparallel.h"
 #include "access/xlogutils.h"
 #include "catalog/catalog.h"
 #include "storage/smgr.h"
@@ -77,6 +78,13 @@ log_invalid_page(RelFileNode node, ForkNumber forkno, BlockNumber blkno,
 	xl_invalid_page *hentry;
 	bool		found;
 
+	/* In a parallel redo worker, the startup process keeps track for us */
+	if (ParallelRedoWorkerNumber >= 0)
+	{
+		ParallelRedoReportInvalidPage(node, forkno, blkno, present);
+		return;
+	}
+
 	/*
 	 * Once recovery has reached a consistent state, the invalid-page table
 	 * should be empty and remain so. If a reference to an invalid page is
@@ -132,6 +140,16 @@ log_invalid_page(RelFileNode node, ForkNumber forkno, BlockNumber blkno,
 	}
 }
 
+/*
+ * Log a reference to an invalid page on behalf of a parallel redo worker
+ */
+void
+XLogNoteInvalidPage(RelFileNode node, ForkNumber forkno, BlockNumber blkno,
+					bool present)
+{
+	log_invalid_page(node, forkno, blkno, present);
+}
+
 /* Forget any invalid pages >= minblkno, because they've been dropped */
 static void
 forget_invalid_pages(RelFileNode node, ForkNumber forkno, BlockNumber minblkno)
@@ -47,7 +47,11 @@
 #include "catalog/pg_foreign_table.h"
 #include "catalog/pg_inherits.h"
 #include "catalog/pg_namespace.h"
+#include "catalog/pg_opclass.h"
+#include "catalog/pg_partition.h"
+#include "catalog/pg_partitioned_table.h"
 #include "catalog/pg_statistic.h"
+#include "catalog/pg_statistic_ext.h"
 #include "catalog/pg_tablespace.h"
 #include "catalog/pg_type.h"
 #include "catalog/pg_type_fn.h"
@@ -62,6 +66,7 @@
 #include "parser/parse_collate.h"
 #include "parser/parse_expr.h"
 #include "parser/parse_relation.h"
+#include "storage/lmgr.h"
 #include "storage/predicate.h"
 #include "storage/smgr.h"
 #include "utils/acl.h"
@@ -1611,7 +1616,10 @@ RemoveAttributeById(Oid relid, AttrNumber attnum)
 	heap_close(attr_rel, RowExclusiveLock);
 
 	if (attnum > 0)
+	{
 		RemoveStatistics(relid, attnum);
+		RemoveStatisticsExt(relid, attnum);
+	}
 
 	relation_close(rel, NoLock);
 }
@@ -1833,10 +1841,17 @@ heap_drop_with_catalog(Oid relid)
 	 */
 	RelationRemoveInheritance(relid);
 
+	/*
+	 * remove partitioning information
+	 */
+	RemovePartitionBound(relid);
+	RemovePartitionKey(relid);
+
 	/*
 	 * delete statistics
 	 */
 	RemoveStatistics(relid, 0);
+	RemoveStatisticsExt(relid, 0);
 
 	/*
 	 * delete attribute tuples
@@ -2692,6 +2707,189 @@ RemoveStatistics(Oid relid, AttrNumber attnum)
 	heap_close(pgstatistic, RowExclusiveLock);
 }
 
+/*
+ * RemoveStatisticsExt --- remove the extended statistics objects of a rel
+ *
+ * If attnum is zero, remove all of them; else remove those including that
+ * column, which would be useless without it.
+ */
+void
+RemoveStatisticsExt(Oid relid, AttrNumber attnum)
+{
+	Relation	pgstatext;
+	SysScanDesc scan;
+	ScanKeyData key;
+	HeapTuple	tuple;
+
+	pgstatext = heap_open(StatisticExtRelationId, RowExclusiveLock);
+
+	ScanKeyInit(&key,
+				Anum_pg_statistic_ext_stxrelid,
+				BTEqualStrategyNumber, F_OIDEQ,
+				ObjectIdGetDatum(relid));
+
+	scan = systable_beginscan(pgstatext, StatisticExtRelidIndexId, true,
+							  NULL, 1, &key);
+
+	while (HeapTupleIsValid(tuple = systable_getnext(scan)))
+	{
+		Form_pg_statistic_ext statform;
+		bool		found = (attnum == 0);
+		int			i;
+
+		statform = (Form_pg_statistic_ext) GETSTRUCT(tuple);
+		for (i = 0; !found && i < statform->stxkeys.dim1; i++)
+		{
+			if (statform->stxkeys.values[i] == attnum)
+				found = true;
+		}
+
+		if (found)
+			simple_heap_delete(pgstatext, &tuple->t_self);
+	}
+
+	systable_endscan(scan);
+
+	heap_close(pgstatext, RowExclusiveLock);
+}
+
+
+/*
+ * StorePartitionKey --- record the partition key of a new partitioned table
+ */
+void
+StorePartitionKey(Oid relid, char strategy, AttrNumber attnum,
+				  Oid opclass, Oid collation)
+{
+	Relation	pg_partitioned_table;
+	HeapTuple	tuple;
+	Datum		values[Natts_pg_partitioned_table];
+	bool		nulls[Natts_pg_partitioned_table];
+	ObjectAddress myself;
+	ObjectAddress referenced;
+
+	memset(nulls, false, sizeof(nulls));
+	values[Anum_pg_partitioned_table_partrelid - 1] = ObjectIdGetDatum(relid);
+	values[Anum_pg_partitioned_table_partstrat - 1] = CharGetDatum(strategy);
+	values[Anum_pg_partitioned_table_partattnum - 1] = Int16GetDatum(attnum);
+	values[Anum_pg_partitioned_table_partopclass - 1] = ObjectIdGetDatum(opclass);
+	values[Anum_pg_partitioned_table_partcollation - 1] = ObjectIdGetDatum(collation);
+
+	pg_partitioned_table = heap_open(PartitionedRelationId, RowExclusiveLock);
+
+	tuple = heap_form_tuple(RelationGetDescr(pg_partitioned_table),
+							values, nulls);
+	simple_heap_insert(pg_partitioned_table, tuple);
+	CatalogUpdateIndexes(pg_partitioned_table, tuple);
+
+	heap_freetuple(tuple);
+	heap_close(pg_partitioned_table, RowExclusiveLock);
+
+	/* The key depends on its operator class and collation */
+	myself.classId = RelationRelationId;
+	myself.objectId = relid;
+	myself.objectSubId = 0;
+
+	referenced.classId = OperatorClassRelationId;
+	referenced.objectId = opclass;
+	referenced.objectSubId = 0;
+	recordDependencyOn(&myself, &referenced, DEPENDENCY_NORMAL);
+
+	if (OidIsValid(collation) && collation != DEFAULT_COLLATION_OID)
+	{
+		referenced.classId = CollationRelationId;
+		referenced.objectId = collation;
+		referenced.objectSubId = 0;
+		recordDependencyOn(&myself, &referenced, DEPENDENCY_NORMAL);
+	}
+}
+
+/*
+ * RemovePartitionKey --- remove the pg_partitioned_table entry of a rel,
+ * if it has one
+ */
+void
+RemovePartitionKey(Oid relid)
+{
+	Relation	pg_partitioned_table;
+	HeapTuple	tuple;
+
+	pg_partitioned_table = heap_open(PartitionedRelationId, RowExclusiveLock);
+
+	tuple = SearchSysCache1(PARTRELID, ObjectIdGetDatum(relid));
+	if (HeapTupleIsValid(tuple))
+	{
+		simple_heap_delete(pg_partitioned_table, &tuple->t_self);
+		ReleaseSysCache(tuple);
+	}
+
+	heap_close(pg_partitioned_table, RowExclusiveLock);
+}
+
+/*
+ * StorePartitionBound --- record a new partition of a partitioned table
+ *
+ * The bound must already have been transformed and checked against the
+ * existing partitions.  The parent's relcache entry is invalidated, so that
+ * its partition descriptor is rebuilt.
+ */
+void
+StorePartitionBound(Oid relid, Oid parentId, PartitionBoundSpec *bound)
+{
+	Relation	pg_partition;
+	HeapTuple	tuple;
+	Datum		values[Natts_pg_partition];
+	bool		nulls[Natts_pg_partition];
+
+	memset(nulls, false, sizeof(nulls));
+	values[Anum_pg_partition_partrelid - 1] = ObjectIdGetDatum(relid);
+	values[Anum_pg_partition_partparent - 1] = ObjectIdGetDatum(parentId);
+	values[Anum_pg_partition_partbound - 1] =
+		CStringGetTextDatum(nodeToString(bound));
+
+	pg_partition = heap_open(PartitionRelationId, RowExclusiveLock);
+
+	tuple = heap_form_tuple(RelationGetDescr(pg_partition), values, nulls);
+	simple_heap_insert(pg_partition, tuple);
+	CatalogUpdateIndexes(pg_partition, tuple);
+
+	heap_freetuple(tuple);
+	heap_close(pg_partition, RowExclusiveLock);
+
+	CacheInvalidateRelcacheByRelid(parentId);
+}
+
+/*
+ * RemovePartitionBound --- remove the pg_partition entry of a rel, if it
+ * is a partition
+ *
+ * The parent is locked as for adding a partition, and its relcache entry
+ * invalidated.
+ */
+void
+RemovePartitionBound(Oid relid)
+{
+	Relation	pg_partition;
+	HeapTuple	tuple;
+	Oid			parentId;
+
+	pg_partition = heap_open(PartitionRelationId, RowExclusiveLock);
+
+	tuple = SearchSysCache1(PARTITIONRELID, ObjectIdGetDatum(relid));
+	if (HeapTupleIsValid(tuple))
+	{
+		parentId = ((Form_pg_partition) GETSTRUCT(tuple))->partparent;
+		LockRelationOid(parentId, AccessExclusiveLock);
+
+		simple_heap_delete(pg_partition, &tuple->t_self);
+		ReleaseSysCache(tuple);
+
+		CacheInvalidateRelcacheByRelid(parentId);
+	}
+
+	heap_close(pg_partition, RowExclusiveLock);
+}
+
 
 /*
  * RelationTruncateIndexes - truncate all indexes associated
@@ -48,6 +48,7 @@
 #include "storage/ipc.h"
 #include "storage/lmgr.h"
 #include "storage/sinval.h"
+#include "tcop/sessionpool.h"
 #include "utils/acl.h"
 #include "utils/builtins.h"
 #include "utils/catcache.h"
@@ -3426,6 +3427,61 @@ get_conversion_oid(List *name, bool missing_ok)
 	return conoid;
 }
 
+/*
+ * get_statistics_oid - find a statistics object by possibly qualified name
+ *
+ * Unlike most other objects, statistics objects of temporary tables are
+ * found in the temporary namespace, since they live in their table's.
+ */
+Oid
+get_statistics_oid(List *names, bool missing_ok)
+{
+	char	   *schemaname;
+	char	   *stats_name;
+	Oid			namespaceId;
+	Oid			stats_oid = InvalidOid;
+	ListCell   *l;
+
+	/* deconstruct the name list */
+	DeconstructQualifiedName(names, &schemaname, &stats_name);
+
+	if (schemaname)
+	{
+		/* use exact schema given */
+		namespaceId = LookupExplicitNamespace(schemaname, missing_ok);
+		if (missing_ok && !OidIsValid(namespaceId))
+			stats_oid = InvalidOid;
+		else
+			stats_oid = GetSysCacheOid2(STATEXTNAMENSP,
+										PointerGetDatum(stats_name),
+										ObjectIdGetDatum(namespaceId));
+	}
+	else
+	{
+		/* search for it in search path */
+		recomputeNamespacePath();
+
+		foreach(l, activeSearchPath)
+		{
+			namespaceId = lfirst_oid(l);
+
+			stats_oid = GetSysCacheOid2(STATEXTNAMENSP,
+										PointerGetDatum(stats_name),
+										ObjectIdGetDatum(namespaceId));
+			if (OidIsValid(stats_oid))
+				return stats_oid;
+		}
+	}
+
+	/* Not found in path */
+	if (!OidIsValid(stats_oid) && !missing_ok)
+		ereport(ERROR,
+				(errcode(ERRCODE_UNDEFINED_OBJECT),
+				 errmsg("statistics object \"%s\" does not exist",
+						NameListToString(names))));
+	return stats_oid;
+}
+
 /*
  * FindDefaultConversionProc - find default encoding conversion proc
  */
@@ -3615,6 +3671,16 @@ InitTempTableNamespace(void)
 
 	Assert(!OidIsValid(myTempNamespace));
 
+	/*
+	 * Temporary tables belong to the backend, which a pooled client session
+	 * doesn't have to itself.
+	 */
+	if (am_pooled_backend)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("cannot create temporary tables in a pooled session"),
+				 errhint("Connect with session_pooling set to off to use temporary tables.")));
+
 	/*
 	 * First, do permission check to see if we are authorized to make temp
 	 * tables.  We use a nonstandard error message here since "databasename:
@@ -0,0 +1,965 @@
+/*-------------------------------------------------------------------------
+ *
+ * partition.c
+ *	  Partitioning related data structures and functions.
+ *
+ * A partitioned table is an inheritance parent whose children, its
+ * partitions, each accept a list or a range of values of a single key
+ * column.  The key is recorded in pg_partitioned_table and each partition's
+ * bound in pg_partition.  This file builds the relcache representation of
+ * both, and uses it to find the partition that accepts a key value, to find
+ * the partitions that can hold rows satisfying a set of restrictions without
+ * opening any of them, and to derive the constraint a partition's bound
+ * imposes on its rows.
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/backend/catalog/partition.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/genam.h"
+#include "access/heapam.h"
+#include "access/htup_details.h"
+#include "access/nbtree.h"
+#include "catalog/indexing.h"
+#include "catalog/partition.h"
+#include "catalog/pg_opclass.h"
+#include "catalog/pg_partition.h"
+#include "catalog/pg_partitioned_table.h"
+#include "catalog/pg_type.h"
+#include "nodes/makefuncs.h"
+#include "optimizer/clauses.h"
+#include "utils/builtins.h"
+#include "utils/datum.h"
+#include "utils/fmgroids.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/syscache.h"
+
+
+/* A range partition's bounds, while building a PartitionDesc */
+typedef struct RangeBoundEntry
+{
+	Oid			oid;
+	Datum		lower;
+	bool		lower_unbounded;
+	Datum		upper;
+	bool		upper_unbounded;
+} RangeBoundEntry;
+
+/* A value accepted by a list partition, while building a PartitionDesc */
+typedef struct ListValueEntry
+{
+	Datum		value;
+	int			part;			/* index into the unsorted partitions */
+} ListValueEntry;
+
+static void RelationBuildPartitionKey(Relation rel);
+static void RelationBuildPartitionDesc(Relation rel);
+static void RelationBuildPartitionQual(Relation rel);
+static MemoryContext partition_info_context(const char *name);
+static void attach_partition_info(Relation rel, MemoryContext cxt);
+static Datum bound_datum(Node *datum, bool *unbounded);
+static int32 partition_cmp(PartitionKey key, Datum a, Datum b);
+static int32 partition_bound_cmp(PartitionKey key, Datum bound,
+					bool unbounded, bool is_lower, Datum value);
+static int partition_bsearch(PartitionKey key, Datum *bounds,
+				  bool *unbounded, bool is_lower, int n,
+				  Datum value, bool orequal);
+static int	range_entry_cmp(const void *a, const void *b, void *arg);
+static int	list_entry_cmp(const void *a, const void *b, void *arg);
+static Expr *make_partition_opclause(Oid opfamily, Oid opcintype,
+						StrategyNumber strategy, Expr *keyexpr,
+						Expr *value, Oid collation);
+static char *partition_datum_out(PartitionKey key, Datum value);
+
+
+/*
+ * RelationGetPartitionKey
+ *		Return the partition key of a relation, or NULL if it isn't a
+ *		partitioned table.
+ *
+ * The result points into the relcache entry; see RelationClearRelation for
+ * how long it stays valid.
+ */
+PartitionKey
+RelationGetPartitionKey(Relation rel)
+{
+	if (!rel->rd_partkeyvalid)
+	{
+		if (rel->rd_rel->relkind == RELKIND_RELATION)
+			RelationBuildPartitionKey(rel);
+		rel->rd_partkeyvalid = true;
+	}
+	return rel->rd_partkey;
+}
+
+/*
+ * RelationGetPartitionDesc
+ *		Return the partitions of a partitioned table, or NULL if the
+ *		relation isn't partitioned.
+ *
+ * The caller must hold a lock on the table, which keeps the set of
+ * partitions from changing under it.
+ */
+PartitionDesc
+RelationGetPartitionDesc(Relation rel)
+{
+	if (rel->rd_partdesc == NULL && RelationGetPartitionKey(rel) != NULL)
+		RelationBuildPartitionDesc(rel);
+	return rel->rd_partdesc;
+}
+
+/*
+ * RelationGetPartitionQual
+ *		Return the constraint implied by a partition's bound, as an
+ *		implicitly-ANDed list of expressions on the partition's own columns
+ *		(Vars have varno 1), or NIL if the relation isn't a partition.
+ */
+List *
+RelationGetPartitionQual(Relation rel)
+{
+	if (!rel->rd_partcheckvalid)
+	{
+		if (rel->rd_rel->relkind == RELKIND_RELATION)
+			RelationBuildPartitionQual(rel);
+		rel->rd_partcheckvalid = true;
+	}
+	return rel->rd_partcheck;
+}
+
+/*
+ * get_partition_parent
+ *		Return the OID of the partitioned table a relation is a partition
+ *		of, or InvalidOid if it isn't a partition.
+ */
+Oid
+get_partition_parent(Oid relid)
+{
+	HeapTuple	tuple;
+	Oid			result;
+
+	tuple = SearchSysCache1(PARTITIONRELID, ObjectIdGetDatum(relid));
+	if (!HeapTupleIsValid(tuple))
+		return InvalidOid;
+	result = ((Form_pg_partition) GETSTRUCT(tuple))->partparent;
+	ReleaseSysCache(tuple);
+
+	return result;
+}
+
+/*
+ * check_new_partition_bound
+ *		Complain if a new partition of 'parent', with the given transformed
+ *		bound, would be empty or overlap an existing partition.
+ */
+void
+check_new_partition_bound(const char *relname, Relation parent,
+						  PartitionBoundSpec *spec)
+{
+	PartitionKey key = RelationGetPartitionKey(parent);
+	PartitionDesc pdesc = RelationGetPartitionDesc(parent);
+	int			i;
+
+	Assert(key != NULL && spec->strategy == key->strategy);
+
+	if (key->strategy == PARTITION_STRATEGY_RANGE)
+	{
+		bool		lower_unbounded;
+		bool		upper_unbounded;
+		Datum		lower = bound_datum(spec->lowerdatum, &lower_unbounded);
+		Datum		upper = bound_datum(spec->upperdatum, &upper_unbounded);
+
+		if (!lower_unbounded && !upper_unbounded &&
+			partition_cmp(key, lower, upper) >= 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+					 errmsg("empty range bound specified for partition \"%s\"",
+							relname),
+					 errdetail("Lower bound %s is not less than upper bound %s.",
+							   partition_datum_out(key, lower),
+							   partition_datum_out(key, upper))));
+
+		/*
+		 * Only the first existing partition whose upper bound is above the
+		 * new lower bound can overlap: earlier ones end before the new one
+		 * starts, and later ones start after this one.
+		 */
+		if (lower_unbounded)
+			i = 0;
+		else
+			i = partition_bsearch(key, pdesc->upper, pdesc->upper_unbounded,
+								  false, pdesc->nparts, lower, true);
+		if (i < pdesc->nparts &&
+			(upper_unbounded ||
+			 partition_bound_cmp(key, pdesc->lower[i],
+								 pdesc->lower_unbounded[i], true,
+								 upper) < 0))
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_OBJECT_DEFINITION),
+					 errmsg("partition \"%s\" would overlap partition \"%s\"",
+							relname, get_rel_name(pdesc->oids[i]))));
+	}
+	else
+	{
+		ListCell   *lc;
+
+		foreach(lc, spec->listdatums)
+		{
+			Const	   *value = (Const *) lfirst(lc);
+
+			i = get_partition_for_value(parent, value->constvalue, false);
+			if (i >= 0)
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_OBJECT_DEFINITION),
+					errmsg("partition \"%s\" would overlap partition \"%s\"",
+						   relname, get_rel_name(pdesc->oids[i])),
+						 errdetail("Value %s is already accepted by partition \"%s\".",
+								   partition_datum_out(key, value->constvalue),
+								   get_rel_name(pdesc->oids[i]))));
+		}
+	}
+}
+
+/*
+ * get_partition_for_value
+ *		Return the index in the PartitionDesc of the partition of 'rel' that
+ *		accepts the given key value, or -1 if there is none.
+ */
+int
+get_partition_for_value(Relation rel, Datum value, bool isnull)
+{
+	PartitionKey key = RelationGetPartitionKey(rel);
+	PartitionDesc pdesc = RelationGetPartitionDesc(rel);
+	int			i;
+
+	/* No partition accepts a null key */
+	if (isnull)
+		return -1;
+
+	if (key->strategy == PARTITION_STRATEGY_RANGE)
+	{
+		/* The last partition starting at or before the value, if any ... */
+		i = partition_bsearch(key, pdesc->lower, pdesc->lower_unbounded, true,
+							  pdesc->nparts, value, true) - 1;
+		/* ... holds it unless the value lies beyond its end */
+		if (i >= 0 &&
+			partition_bound_cmp(key, pdesc->upper[i],
+								pdesc->upper_unbounded[i], false, value) > 0)
+			return i;
+	}
+	else
+	{
+		i = partition_bsearch(key, pdesc->values, NULL, false,
+							  pdesc->nvalues, value, false);
+		if (i < pdesc->nvalues &&
+			partition_cmp(key, pdesc->values[i], value) == 0)
+			return pdesc->valueparts[i];
+	}
+
+	return -1;
+}
+
+/*
+ * get_partitions_for_clauses
+ *		Return the set of PartitionDesc indexes of the partitions of 'rel'
+ *		that can hold rows satisfying all of the given clauses.
+ *
+ * The clauses are first reduced to a single interval of key values, and the
+ * partitions overlapping it are then found by binary search over the
+ * sorted bounds, so the cost is logarithmic in the number of partitions
+ * (plus the size of the result).
+ */
+Bitmapset *
+get_partitions_for_clauses(Relation rel, PartitionPruneClause *clauses,
+						   int nclauses)
+{
+	PartitionKey key = RelationGetPartitionKey(rel);
+	PartitionDesc pdesc = RelationGetPartitionDesc(rel);
+	bool		have_lower = false;
+	bool		lower_incl = false;
+	Datum		lower = (Datum) 0;
+	bool		have_upper = false;
+	bool		upper_incl = false;
+	Datum		upper = (Datum) 0;
+	Bitmapset  *result = NULL;
+	int			first;
+	int			last;
+	int			i;
+
+	for (i = 0; i < nclauses; i++)
+	{
+		Datum		value = clauses[i].value;
+		bool		tighten_lower = false;
+		bool		tighten_upper = false;
+		bool		incl = false;
+
+		switch (clauses[i].strategy)
+		{
+			case BTLessStrategyNumber:
+				tighten_upper = true;
+				break;
+			case BTLessEqualStrategyNumber:
+				tighten_upper = true;
+				incl = true;
+				break;
+			case BTEqualStrategyNumber:
+				tighten_lower = tighten_upper = true;
+				incl = true;
+				break;
+			case BTGreaterEqualStrategyNumber:
+				tighten_lower = true;
+				incl = true;
+				break;
+			case BTGreaterStrategyNumber:
+				tighten_lower = true;
+				break;
+			default:
+				elog(ERROR, "unrecognized btree strategy number: %d",
+					 (int) clauses[i].strategy);
+		}
+
+		if (tighten_lower)
+		{
+			int32		cmp = have_lower ? partition_cmp(key, value, lower) : 1;
+
+			if (cmp > 0 || (cmp == 0 && !incl))
+			{
+				lower = value;
+				lower_incl = incl;
+				have_lower = true;
+			}
+		}
+		if (tighten_upper)
+		{
+			int32		cmp = have_upper ? partition_cmp(key, value, upper) : -1;
+
+			if (cmp < 0 || (cmp == 0 && !incl))
+			{
+				upper = value;
+				upper_incl = incl;
+				have_upper = true;
+			}
+		}
+	}
+
+	/* Contradictory clauses select nothing */
+	if (have_lower && have_upper)
+	{
+		int32		cmp = partition_cmp(key, lower, upper);
+
+		if (cmp > 0 || (cmp == 0 && !(lower_incl && upper_incl)))
+			return NULL;
+	}
+
+	if (key->strategy == PARTITION_STRATEGY_RANGE)
+	{
+		/*
+		 * Wanted are the partitions ending above the interval's lower end
+		 * and starting below (or at, if it's inclusive) its upper end.  As
+		 * both bound arrays are sorted, those form a contiguous run.
+		 */
+		if (have_lower)
+			first = partition_bsearch(key, pdesc->upper, pdesc->upper_unbounded,
+									  false, pdesc->nparts, lower, true);
+		else
+			first = 0;
+		if (have_upper)
+			last = partition_bsearch(key, pdesc->lower, pdesc->lower_unbounded,
+									 true, pdesc->nparts, upper,
+									 upper_incl) - 1;
+		else
+			last = pdesc->nparts - 1;
+
+		for (i = first; i <= last; i++)
+			result = bms_add_member(result, i);
+	}
+	else
+	{
+		/* Collect the partitions of the values within the interval */
+		if (have_lower)
+			first = partition_bsearch(key, pdesc->values, NULL, false,
+									  pdesc->nvalues, lower, !lower_incl);
+		else
+			first = 0;
+		if (have_upper)
+			last = partition_bsearch(key, pdesc->values, NULL, false,
+									 pdesc->nvalues, upper, upper_incl) - 1;
+		else
+			last = pdesc->nvalues - 1;
+
+		for (i = first; i <= last; i++)
+			result = bms_add_member(result, pdesc->valueparts[i]);
+	}
+
+	return result;
+}
+
+/*
+ * partition_bounds_equal
+ *		Are the two partitioned tables partitioned the same way: by the same
+ *		strategy, on keys compared the same way, with the same bounds?
+ *
+ * If so, the i'th partitions of the two accept exactly the same key values,
+ * so rows of the two with equal keys are always found in partitions with
+ * the same PartitionDesc index.
+ */
+bool
+partition_bounds_equal(Relation rel1, Relation rel2)
+{
+	PartitionKey key1 = RelationGetPartitionKey(rel1);
+	PartitionKey key2 = RelationGetPartitionKey(rel2);
+	PartitionDesc pdesc1 = RelationGetPartitionDesc(rel1);
+	PartitionDesc pdesc2 = RelationGetPartitionDesc(rel2);
+	int			i;
+
+	if (key1 == NULL || key2 == NULL)
+		return false;
+	if (key1->strategy != key2->strategy ||
+		key1->parttype != key2->parttype ||
+		key1->partopfamily != key2->partopfamily ||
+		key1->partopcintype != key2->partopcintype ||
+		key1->partcollation != key2->partcollation)
+		return false;
+
+	if (pdesc1->nparts != pdesc2->nparts)
+		return false;
+
+	if (key1->strategy == PARTITION_STRATEGY_RANGE)
+	{
+		for (i = 0; i < pdesc1->nparts; i++)
+		{
+			if (pdesc1->lower_unbounded[i] != pdesc2->lower_unbounded[i] ||
+				pdesc1->upper_unbounded[i] != pdesc2->upper_unbounded[i])
+				return false;
+			if (!pdesc1->lower_unbounded[i] &&
+				partition_cmp(key1, pdesc1->lower[i], pdesc2->lower[i]) != 0)
+				return false;
+			if (!pdesc1->upper_unbounded[i] &&
+				partition_cmp(key1, pdesc1->upper[i], pdesc2->upper[i]) != 0)
+				return false;
+		}
+	}
+	else
+	{
+		if (pdesc1->nvalues != pdesc2->nvalues)
+			return false;
+		for (i = 0; i < pdesc1->nvalues; i++)
+		{
+			if (pdesc1->valueparts[i] != pdesc2->valueparts[i] ||
+				partition_cmp(key1, pdesc1->values[i], pdesc2->values[i]) != 0)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * RelationBuildPartitionKey
+ *		Load the partition key of a relation from pg_partitioned_table,
+ *		if it has one.
+ */
+static void
+RelationBuildPartitionKey(Relation rel)
+{
+	HeapTuple	tuple;
+	Form_pg_partitioned_table form;
+	HeapTuple	opclasstup;
+	Form_pg_opclass opclass;
+	Form_pg_attribute attr;
+	Oid			cmpproc;
+	MemoryContext cxt;
+	PartitionKey key;
+
+	tuple = SearchSysCache1(PARTRELID,
+							ObjectIdGetDatum(RelationGetRelid(rel)));
+	if (!HeapTupleIsValid(tuple))
+		return;
+	form = (Form_pg_partitioned_table) GETSTRUCT(tuple);
+
+	opclasstup = SearchSysCache1(CLAOID, ObjectIdGetDatum(form->partopclass));
+	if (!HeapTupleIsValid(opclasstup))
+		elog(ERROR, "cache lookup failed for opclass %u", form->partopclass);
+	opclass = (Form_pg_opclass) GETSTRUCT(opclasstup);
+
+	cmpproc = get_opfamily_proc(opclass->opcfamily, opclass->opcintype,
+								opclass->opcintype, BTORDER_PROC);
+	if (!OidIsValid(cmpproc))
+		elog(ERROR, "missing support function %d(%u,%u) in opfamily %u",
+			 BTORDER_PROC, opclass->opcintype, opclass->opcintype,
+			 opclass->opcfamily);
+
+	attr = rel->rd_att->attrs[form->partattnum - 1];
+
+	cxt = partition_info_context("partition key");
+	key = (PartitionKey) MemoryContextAllocZero(cxt, sizeof(PartitionKeyData));
+	key->strategy = form->partstrat;
+	key->partattr = form->partattnum;
+	key->parttype = attr->atttypid;
+	key->parttypmod = attr->atttypmod;
+	key->parttyplen = attr->attlen;
+	key->parttypbyval = attr->attbyval;
+	key->partopfamily = opclass->opcfamily;
+	key->partopcintype = opclass->opcintype;
+	key->partcollation = form->partcollation;
+	fmgr_info_cxt(cmpproc, &key->partcmp, cxt);
+
+	ReleaseSysCache(opclasstup);
+	ReleaseSysCache(tuple);
+
+	attach_partition_info(rel, cxt);
+	rel->rd_partkey = key;
+}
+
+/*
+ * RelationBuildPartitionDesc
+ *		Load the partitions of a partitioned table from pg_partition, and
+ *		sort them by bound.
+ */
+static void
+RelationBuildPartitionDesc(Relation rel)
+{
+	PartitionKey key = RelationGetPartitionKey(rel);
+	Relation	catalog;
+	SysScanDesc scan;
+	ScanKeyData skey;
+	HeapTuple	tuple;
+	List	   *oids = NIL;
+	List	   *bounds = NIL;
+	ListCell   *lc;
+	ListCell   *lc2;
+	int			nparts;
+	MemoryContext cxt;
+	PartitionDesc pdesc;
+	int			i;
+
+	catalog = heap_open(PartitionRelationId, AccessShareLock);
+
+	ScanKeyInit(&skey,
+				Anum_pg_partition_partparent,
+				BTEqualStrategyNumber, F_OIDEQ,
+				ObjectIdGetDatum(RelationGetRelid(rel)));
+
+	scan = systable_beginscan(catalog, PartitionParentIndexId, true,
+							  NULL, 1, &skey);
+
+	while (HeapTupleIsValid(tuple = systable_getnext(scan)))
+	{
+		Form_pg_partition form = (Form_pg_partition) GETSTRUCT(tuple);
+		Datum		datum;
+		bool		isnull;
+
+		datum = heap_getattr(tuple, Anum_pg_partition_partbound,
+							 RelationGetDescr(catalog), &isnull);
+		if (isnull)
+			elog(ERROR, "null partbound for partition %u", form->partrelid);
+
+		oids = lappend_oid(oids, form->partrelid);
+		bounds = lappend(bounds, stringToNode(TextDatumGetCString(datum)));
+	}
+
+	systable_endscan(scan);
+	heap_close(catalog, AccessShareLock);
+
+	nparts = list_length(oids);
+
+	cxt = partition_info_context("partition descriptor");
+	pdesc = (PartitionDesc) MemoryContextAllocZero(cxt,
+												 sizeof(PartitionDescData));
+	pdesc->nparts = nparts;
+	pdesc->oids = (Oid *) MemoryContextAlloc(cxt, nparts * sizeof(Oid));
+
+	if (key->strategy == PARTITION_STRATEGY_RANGE)
+	{
+		RangeBoundEntry *entries;
+
+		entries = (RangeBoundEntry *) palloc(nparts * sizeof(RangeBoundEntry));
+		i = 0;
+		forboth(lc, oids, lc2, bounds)
+		{
+			PartitionBoundSpec *spec = (PartitionBoundSpec *) lfirst(lc2);
+
+			entries[i].oid = lfirst_oid(lc);
+			entries[i].lower = bound_datum(spec->lowerdatum,
+										   &entries[i].lower_unbounded);
+			entries[i].upper = bound_datum(spec->upperdatum,
+										   &entries[i].upper_unbounded);
+			i++;
+		}
+
+		qsort_arg(entries, nparts, sizeof(RangeBoundEntry),
+				  range_entry_cmp, key);
+
+		pdesc->lower = (Datum *) MemoryContextAllocZero(cxt,
+													nparts * sizeof(Datum));
+		pdesc->lower_unbounded = (bool *) MemoryContextAlloc(cxt,
+													 nparts * sizeof(bool));
+		pdesc->upper = (Datum *) MemoryContextAllocZero(cxt,
+													nparts * sizeof(Datum));
+		pdesc->upper_unbounded = (bool *) MemoryContextAlloc(cxt,
+													 nparts * sizeof(bool));
+		for (i = 0; i < nparts; i++)
+		{
+			MemoryContext oldcxt = MemoryContextSwitchTo(cxt);
+
+			pdesc->oids[i] = entries[i].oid;
+			pdesc->lower_unbounded[i] = entries[i].lower_unbounded;
+			if (!entries[i].lower_unbounded)
+				pdesc->lower[i] = datumCopy(entries[i].lower,
+											key->parttypbyval,
+											key->parttyplen);
+			pdesc->upper_unbounded[i] = entries[i].upper_unbounded;
+			if (!entries[i].upper_unbounded)
+				pdesc->upper[i] = datumCopy(entries[i].upper,
+											key->parttypbyval,
+											key->parttyplen);
+			MemoryContextSwitchTo(oldcxt);
+		}
+	}
+	else
+	{
+		ListValueEntry *entries;
+		int			nvalues = 0;
+		int		   *partnum;
+		int			nextpart;
+
+		foreach(lc, bounds)
+			nvalues += list_length(((PartitionBoundSpec *) lfirst(lc))->listdatums);
+
+		entries = (ListValueEntry *) palloc(nvalues * sizeof(ListValueEntry));
+		nvalues = 0;
+		i = 0;
+		foreach(lc, bounds)
+		{
+			PartitionBoundSpec *spec = (PartitionBoundSpec *) lfirst(lc);
+
+			foreach(lc2, spec->listdatums)
+			{
+				entries[nvalues].value = ((Const *) lfirst(lc2))->constvalue;
+				entries[nvalues].part = i;
+				nvalues++;
+			}
+			i++;
+		}
+
+		qsort_arg(entries, nvalues, sizeof(ListValueEntry),
+				  list_entry_cmp, key);
+
+		/* Number the partitions in order of their smallest value */
+		partnum = (int *) palloc(nparts * sizeof(int));
+		for (i = 0; i < nparts; i++)
+			partnum[i] = -1;
+		nextpart = 0;
+		for (i = 0; i < nvalues; i++)
+		{
+			if (partnum[entries[i].part] < 0)
+				partnum[entries[i].part] = nextpart++;
+		}
+		Assert(nextpart == nparts);
+
+		i = 0;
+		foreach(lc, oids)
+			pdesc->oids[partnum[i++]] = lfirst_oid(lc);
+
+		pdesc->nvalues = nvalues;
+		pdesc->values = (Datum *) MemoryContextAlloc(cxt,
+													 nvalues * sizeof(Datum));
+		pdesc->valueparts = (int *) MemoryContextAlloc(cxt,
+													   nvalues * sizeof(int));
+		for (i = 0; i < nvalues; i++)
+		{
+			MemoryContext oldcxt = MemoryContextSwitchTo(cxt);
+
+			pdesc->values[i] = datumCopy(entries[i].value,
+										 key->parttypbyval,
+										 key->parttyplen);
+			pdesc->valueparts[i] = partnum[entries[i].part];
+			MemoryContextSwitchTo(oldcxt);
+		}
+	}
+
+	attach_partition_info(rel, cxt);
+	rel->rd_partdesc = pdesc;
+}
+
+/*
+ * RelationBuildPartitionQual
+ *		Derive the constraint implied by a partition's bound, if the relation
+ *		is a partition.
+ *
+ * Only catalog lookups are used, not the parent's relcache entry, so that
+ * no lock needs to be taken on the parent.
+ */
+static void
+RelationBuildPartitionQual(Relation rel)
+{
+	HeapTuple	tuple;
+	Form_pg_partition form;
+	HeapTuple	keytuple;
+	Form_pg_partitioned_table keyform;
+	Datum		datum;
+	bool		isnull;
+	PartitionBoundSpec *spec;
+	Oid			opfamily;
+	Oid			opcintype;
+	char	   *colname;
+	AttrNumber	attnum;
+	Form_pg_attribute attr;
+	Expr	   *keyexpr;
+	List	   *result = NIL;
+	MemoryContext cxt;
+	MemoryContext oldcxt;
+
+	tuple = SearchSysCache1(PARTITIONRELID,
+							ObjectIdGetDatum(RelationGetRelid(rel)));
+	if (!HeapTupleIsValid(tuple))
+		return;
+	form = (Form_pg_partition) GETSTRUCT(tuple);
+
+	datum = SysCacheGetAttr(PARTITIONRELID, tuple,
+							Anum_pg_partition_partbound, &isnull);
+	if (isnull)
+		elog(ERROR, "null partbound for partition %u", form->partrelid);
+	spec = (PartitionBoundSpec *) stringToNode(TextDatumGetCString(datum));
+
+	keytuple = SearchSysCache1(PARTRELID, ObjectIdGetDatum(form->partparent));
+	if (!HeapTupleIsValid(keytuple))
+		elog(ERROR, "cache lookup failed for partition key of relation %u",
+			 form->partparent);
+	keyform = (Form_pg_partitioned_table) GETSTRUCT(keytuple);
+
+	opfamily = get_opclass_family(keyform->partopclass);
+	opcintype = get_opclass_input_type(keyform->partopclass);
+
+	/* The key column needn't have the same number in the partition */
+	colname = get_relid_attribute_name(form->partparent, keyform->partattnum);
+	attnum = get_attnum(RelationGetRelid(rel), colname);
+	if (attnum == InvalidAttrNumber)
+		elog(ERROR, "cache lookup failed for attribute \"%s\" of relation %u",
+			 colname, RelationGetRelid(rel));
+	attr = rel->rd_att->attrs[attnum - 1];
+
+	keyexpr = (Expr *) makeVar(1, attnum, attr->atttypid, attr->atttypmod,
+							   attr->attcollation, 0);
+	if (attr->atttypid != opcintype && !IsPolymorphicType(opcintype))
+		keyexpr = (Expr *) makeRelabelType(keyexpr, opcintype, -1,
+										   attr->attcollation,
+										   COERCE_IMPLICIT_CAST);
+
+	if (spec->strategy == PARTITION_STRATEGY_RANGE)
+	{
+		NullTest   *ntest = makeNode(NullTest);
+
+		/* Range partitions never accept a null key */
+		ntest->arg = keyexpr;
+		ntest->nulltesttype = IS_NOT_NULL;
+		ntest->argisrow = false;
+		ntest->location = -1;
+		result = lappend(result, ntest);
+
+		if (spec->lowerdatum)
+			result = lappend(result,
+							 make_partition_opclause(opfamily, opcintype,
+												BTGreaterEqualStrategyNumber,
+													 keyexpr,
+													 (Expr *) spec->lowerdatum,
+												   keyform->partcollation));
+		if (spec->upperdatum)
+			result = lappend(result,
+							 make_partition_opclause(opfamily, opcintype,
+													 BTLessStrategyNumber,
+													 keyexpr,
+													 (Expr *) spec->upperdatum,
+												   keyform->partcollation));
+	}
+	else
+	{
+		List	   *eqs = NIL;
+		ListCell   *lc;
+
+		foreach(lc, spec->listdatums)
+			eqs = lappend(eqs,
+						  make_partition_opclause(opfamily, opcintype,
+												  BTEqualStrategyNumber,
+												  keyexpr,
+												  (Expr *) lfirst(lc),
+												  keyform->partcollation));
+		if (list_length(eqs) > 1)
+			result = list_make1(makeBoolExpr(OR_EXPR, eqs, -1));
+		else
+			result = eqs;
+	}
+
+	ReleaseSysCache(keytuple);
+	ReleaseSysCache(tuple);
+
+	cxt = partition_info_context("partition constraint");
+	oldcxt = MemoryContextSwitchTo(cxt);
+	result = (List *) copyObject(result);
+	MemoryContextSwitchTo(oldcxt);
+
+	attach_partition_info(rel, cxt);
+	rel->rd_partcheck = result;
+}
+
+/*
+ * Each piece of partitioning info is built in a context of its own, which
+ * becomes part of the relcache entry only once complete, so that an error
+ * halfway through can't leave a partially built entry behind.
+ */
+static MemoryContext
+partition_info_context(const char *name)
+{
+	return AllocSetContextCreate(CacheMemoryContext,
+								 name,
+								 ALLOCSET_SMALL_MINSIZE,
+								 ALLOCSET_SMALL_INITSIZE,
+								 ALLOCSET_DEFAULT_MAXSIZE);
+}
+
+static void
+attach_partition_info(Relation rel, MemoryContext cxt)
+{
+	if (rel->rd_partcxt == NULL)
+		rel->rd_partcxt = AllocSetContextCreate(CacheMemoryContext,
+												"partitioning info",
+												ALLOCSET_SMALL_MINSIZE,
+												ALLOCSET_SMALL_INITSIZE,
+												ALLOCSET_SMALL_MAXSIZE);
+	MemoryContextSetParent(cxt, rel->rd_partcxt);
+}
+
+/*
+ * Extract a datum of a transformed range bound; NULL stands for UNBOUNDED.
+ */
+static Datum
+bound_datum(Node *datum, bool *unbounded)
+{
+	if (datum == NULL)
+	{
+		*unbounded = true;
+		return (Datum) 0;
+	}
+
+	Assert(IsA(datum, Const) &&!((Const *) datum)->constisnull);
+	*unbounded = false;
+	return ((Const *) datum)->constvalue;
+}
+
+static int32
+partition_cmp(PartitionKey key, Datum a, Datum b)
+{
+	return DatumGetInt32(FunctionCall2Coll(&key->partcmp,
+										   key->partcollation,
+										   a, b));
+}
+
+/*
+ * Compare a range bound with a value.  An unbounded lower bound sorts
+ * before every value, and an unbounded upper bound after every value.
+ */
+static int32
+partition_bound_cmp(PartitionKey key, Datum bound, bool unbounded,
+					bool is_lower, Datum value)
+{
+	if (unbounded)
+		return is_lower ? -1 : 1;
+	return partition_cmp(key, bound, value);
+}
+
+/*
+ * partition_bsearch
+ *		Return the number of leading entries of a sorted array of bounds that
+ *		are less than 'value', or less than or equal to it if 'orequal'.
+ *
+ * 'unbounded' may be NULL if no entry can be unbounded; 'is_lower' says
+ * whether the entries are lower or upper bounds.
+ */
+static int
+partition_bsearch(PartitionKey key, Datum *bounds, bool *unbounded,
+				  bool is_lower, int n, Datum value, bool orequal)
+{
+	int			lo = 0;
+	int			hi = n;
+
+	while (lo < hi)
+	{
+		int			mid = lo + (hi - lo) / 2;
+		int32		cmp;
+
+		cmp = partition_bound_cmp(key, bounds[mid],
+								  unbounded ? unbounded[mid] : false,
+								  is_lower, value);
+		if (cmp < 0 || (orequal && cmp == 0))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+/* qsort_arg comparator for RangeBoundEntry, by lower bound */
+static int
+range_entry_cmp(const void *a, const void *b, void *arg)
+{
+	const RangeBoundEntry *ea = (const RangeBoundEntry *) a;
+	const RangeBoundEntry *eb = (const RangeBoundEntry *) b;
+
+	if (ea->lower_unbounded)
+		return eb->lower_unbounded ? 0 : -1;
+	if (eb->lower_unbounded)
+		return 1;
+	return partition_cmp((PartitionKey) arg, ea->lower, eb->lower);
+}
+
+/* qsort_arg comparator for ListValueEntry */
+static int
+list_entry_cmp(const void *a, const void *b, void *arg)
+{
+	const ListValueEntry *ea = (const ListValueEntry *) a;
+	const ListValueEntry *eb = (const ListValueEntry *) b;
+
+	return partition_cmp((PartitionKey) arg, ea->value, eb->value);
+}
+
+/*
+ * Build "keyexpr op value", op being the key operator family's member with
+ * the given strategy.
+ */
+static Expr *
+make_partition_opclause(Oid opfamily, Oid opcintype, StrategyNumber strategy,
+						Expr *keyexpr, Expr *value, Oid collation)
+{
+	Oid			operoid;
+	OpExpr	   *opexpr;
+
+	operoid = get_opfamily_member(opfamily, opcintype, opcintype, strategy);
+	if (!OidIsValid(operoid))
+		elog(ERROR, "missing operator %d(%u,%u) in opfamily %u",
+			 strategy, opcintype, opcintype, opfamily);
+
+	opexpr = (OpExpr *) make_opclause(operoid, BOOLOID, false,
+									  keyexpr, value,
+									  InvalidOid, collation);
+	opexpr->opfuncid = get_opcode(operoid);
+
+	return (Expr *) opexpr;
+}
+
+static char *
+partition_datum_out(PartitionKey key, Datum value)
+{
+	Oid			typoutput;
+	bool		typisvarlena;
+
+	getTypeOutputInfo(key->parttype, &typoutput, &typisvarlena);
+	return OidOutputFunctionCall(typoutput, value);
+}
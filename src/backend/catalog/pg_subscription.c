@@ -0,0 +1,458 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_subscription.c
+ *		Routines to support manipulation of the pg_subscription relation
+ *
+ * Subscriptions are created and dropped through SQL-callable functions
+ * rather than DDL; the logical replication launcher picks up the changes
+ * and starts or stops apply workers accordingly.
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *		src/backend/catalog/pg_subscription.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/genam.h"
+#include "access/heapam.h"
+#include "access/htup_details.h"
+#include "access/sysattr.h"
+#include "catalog/catalog.h"
+#include "catalog/indexing.h"
+#include "catalog/namespace.h"
+#include "catalog/pg_subscription.h"
+#include "catalog/pg_type.h"
+#include "miscadmin.h"
+#include "replication/logicallauncher.h"
+#include "replication/origin.h"
+#include "storage/lmgr.h"
+#include "utils/array.h"
+#include "utils/builtins.h"
+#include "utils/fmgroids.h"
+#include "utils/rel.h"
+#include "utils/tqual.h"
+
+static Subscription *subscription_from_tuple(HeapTuple tup, TupleDesc desc);
+static HeapTuple subscription_tuple_by_name(Relation rel, Name subname);
+static Datum normalize_table_names(ArrayType *tables);
+static void subscription_set_enabled(Name subname, bool enabled);
+
+/*
+ * Build a Subscription from a pg_subscription tuple.
+ */
+static Subscription *
+subscription_from_tuple(HeapTuple tup, TupleDesc desc)
+{
+	Form_pg_subscription subform = (Form_pg_subscription) GETSTRUCT(tup);
+	Subscription *sub;
+	Datum		datum;
+	bool		isnull;
+
+	sub = (Subscription *) palloc0(sizeof(Subscription));
+	sub->oid = HeapTupleGetOid(tup);
+	sub->dbid = subform->subdbid;
+	sub->name = pstrdup(NameStr(subform->subname));
+	sub->enabled = subform->subenabled;
+	sub->slotname = pstrdup(NameStr(subform->subslotname));
+
+	datum = heap_getattr(tup, Anum_pg_subscription_subconninfo, desc, &isnull);
+	Assert(!isnull);
+	sub->conninfo = TextDatumGetCString(datum);
+
+	datum = heap_getattr(tup, Anum_pg_subscription_subtables, desc, &isnull);
+	if (!isnull)
+	{
+		Datum	   *elems;
+		int			nelems;
+		int			i;
+
+		deconstruct_array(DatumGetArrayTypeP(datum),
+						  TEXTOID, -1, false, 'i',
+						  &elems, NULL, &nelems);
+		for (i = 0; i < nelems; i++)
+			sub->tables = lappend(sub->tables, TextDatumGetCString(elems[i]));
+	}
+
+	return sub;
+}
+
+/*
+ * Fetch the subscription with the given OID.
+ *
+ * Returns NULL if it does not exist and missing_ok is true.
+ */
+Subscription *
+GetSubscription(Oid subid, bool missing_ok)
+{
+	Relation	rel;
+	ScanKeyData key;
+	SysScanDesc scan;
+	HeapTuple	tup;
+	Subscription *sub = NULL;
+
+	rel = heap_open(SubscriptionRelationId, AccessShareLock);
+	ScanKeyInit(&key,
+				ObjectIdAttributeNumber,
+				BTEqualStrategyNumber, F_OIDEQ,
+				ObjectIdGetDatum(subid));
+	scan = systable_beginscan(rel, SubscriptionObjectIndexId, true,
+							  NULL, 1, &key);
+	tup = systable_getnext(scan);
+	if (HeapTupleIsValid(tup))
+		sub = subscription_from_tuple(tup, RelationGetDescr(rel));
+	else if (!missing_ok)
+		elog(ERROR, "cache lookup failed for subscription %u", subid);
+	systable_endscan(scan);
+	heap_close(rel, AccessShareLock);
+
+	return sub;
+}
+
+/*
+ * Fetch all subscriptions of the cluster.
+ *
+ * This only reads the shared catalog, so it can be used by processes that
+ * are not connected to any particular database.  Such processes can't open
+ * the catalog's toast table, so only the fixed-width fields are filled in;
+ * conninfo is NULL and tables is NIL.  Use GetSubscription for the rest.
+ */
+List *
+GetSubscriptionList(void)
+{
+	Relation	rel;
+	HeapScanDesc scan;
+	HeapTuple	tup;
+	List	   *res = NIL;
+
+	rel = heap_open(SubscriptionRelationId, AccessShareLock);
+	scan = heap_beginscan_catalog(rel, 0, NULL);
+	while (HeapTupleIsValid(tup = heap_getnext(scan, ForwardScanDirection)))
+	{
+		Form_pg_subscription subform = (Form_pg_subscription) GETSTRUCT(tup);
+		Subscription *sub;
+
+		sub = (Subscription *) palloc0(sizeof(Subscription));
+		sub->oid = HeapTupleGetOid(tup);
+		sub->dbid = subform->subdbid;
+		sub->name = pstrdup(NameStr(subform->subname));
+		sub->enabled = subform->subenabled;
+		sub->slotname = pstrdup(NameStr(subform->subslotname));
+		res = lappend(res, sub);
+	}
+	heap_endscan(scan);
+	heap_close(rel, AccessShareLock);
+
+	return res;
+}
+
+/*
+ * Release memory allocated by GetSubscription.
+ */
+void
+FreeSubscription(Subscription *sub)
+{
+	pfree(sub->name);
+	pfree(sub->slotname);
+	pfree(sub->conninfo);
+	list_free_deep(sub->tables);
+	pfree(sub);
+}
+
+/*
+ * Count the subscriptions that apply changes to the given database.
+ */
+int
+CountDBSubscriptions(Oid dbid)
+{
+	Relation	rel;
+	ScanKeyData key;
+	SysScanDesc scan;
+	int			nsubs = 0;
+
+	rel = heap_open(SubscriptionRelationId, AccessShareLock);
+	ScanKeyInit(&key,
+				Anum_pg_subscription_subdbid,
+				BTEqualStrategyNumber, F_OIDEQ,
+				ObjectIdGetDatum(dbid));
+	scan = systable_beginscan(rel, SubscriptionNameIndexId, true,
+							  NULL, 1, &key);
+	while (HeapTupleIsValid(systable_getnext(scan)))
+		nsubs++;
+	systable_endscan(scan);
+	heap_close(rel, AccessShareLock);
+
+	return nsubs;
+}
+
+/*
+ * Look up a subscription of the current database by name.  The result is
+ * a copy of the catalog tuple, or NULL if there is no such subscription.
+ */
+static HeapTuple
+subscription_tuple_by_name(Relation rel, Name subname)
+{
+	ScanKeyData key[2];
+	SysScanDesc scan;
+	HeapTuple	tup;
+
+	ScanKeyInit(&key[0],
+				Anum_pg_subscription_subdbid,
+				BTEqualStrategyNumber, F_OIDEQ,
+				ObjectIdGetDatum(MyDatabaseId));
+	ScanKeyInit(&key[1],
+				Anum_pg_subscription_subname,
+				BTEqualStrategyNumber, F_NAMEEQ,
+				NameGetDatum(subname));
+	scan = systable_beginscan(rel, SubscriptionNameIndexId, true,
+							  NULL, 2, key);
+	tup = systable_getnext(scan);
+	if (HeapTupleIsValid(tup))
+		tup = heap_copytuple(tup);
+	systable_endscan(scan);
+
+	return tup;
+}
+
+/*
+ * Check the table names given to pg_subscription_create and convert them to
+ * the schema-qualified, quoted-as-needed form the output plugin compares
+ * against.
+ */
+static Datum
+normalize_table_names(ArrayType *tables)
+{
+	Datum	   *elems;
+	bool	   *nulls;
+	int			nelems;
+	int			i;
+
+	if (ARR_NDIM(tables) > 1)
+		ereport(ERROR,
+				(errcode(ERRCODE_ARRAY_SUBSCRIPT_ERROR),
+				 errmsg("wrong number of array subscripts")));
+
+	deconstruct_array(tables, TEXTOID, -1, false, 'i',
+					  &elems, &nulls, &nelems);
+	for (i = 0; i < nelems; i++)
+	{
+		List	   *names;
+		char	   *nspname;
+		char	   *relname;
+
+		if (nulls[i])
+			ereport(ERROR,
+					(errcode(ERRCODE_NULL_VALUE_NOT_ALLOWED),
+					 errmsg("table name must not be null")));
+
+		names = textToQualifiedNameList(DatumGetTextP(elems[i]));
+		if (list_length(names) != 2)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_NAME),
+					 errmsg("table name \"%s\" must be schema-qualified",
+							TextDatumGetCString(elems[i]))));
+		nspname = strVal(linitial(names));
+		relname = strVal(lsecond(names));
+
+		elems[i] = CStringGetTextDatum(quote_qualified_identifier(nspname,
+																  relname));
+	}
+
+	return PointerGetDatum(construct_array(elems, nelems, TEXTOID,
+										   -1, false, 'i'));
+}
+
+/*
+ * pg_subscription_create
+ *		Create an enabled subscription in the current database.
+ *
+ * Changes are streamed from the given logical slot on the publisher, which
+ * must use the pgoutput plugin.  If tables is NULL, changes to all tables
+ * are applied; otherwise only those to the listed tables.
+ */
+Datum
+pg_subscription_create(PG_FUNCTION_ARGS)
+{
+	Name		subname;
+	text	   *conninfo;
+	Name		slotname;
+	Relation	rel;
+	HeapTuple	tup;
+	Datum		values[Natts_pg_subscription];
+	bool		nulls[Natts_pg_subscription];
+	Oid			subid;
+	char		originname[NAMEDATALEN];
+
+	if (!superuser())
+		ereport(ERROR,
+				(errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
+				 errmsg("must be superuser to create subscriptions")));
+
+	if (PG_ARGISNULL(0) || PG_ARGISNULL(1) || PG_ARGISNULL(2))
+		ereport(ERROR,
+				(errcode(ERRCODE_NULL_VALUE_NOT_ALLOWED),
+				 errmsg("subscription name, connection string and slot name must not be null")));
+
+	subname = PG_GETARG_NAME(0);
+	conninfo = PG_GETARG_TEXT_PP(1);
+	slotname = PG_GETARG_NAME(2);
+
+	rel = heap_open(SubscriptionRelationId, RowExclusiveLock);
+
+	tup = subscription_tuple_by_name(rel, subname);
+	if (HeapTupleIsValid(tup))
+		ereport(ERROR,
+				(errcode(ERRCODE_DUPLICATE_OBJECT),
+				 errmsg("subscription \"%s\" already exists",
+						NameStr(*subname))));
+
+	memset(values, 0, sizeof(values));
+	memset(nulls, false, sizeof(nulls));
+
+	values[Anum_pg_subscription_subdbid - 1] = ObjectIdGetDatum(MyDatabaseId);
+	values[Anum_pg_subscription_subname - 1] = NameGetDatum(subname);
+	values[Anum_pg_subscription_subenabled - 1] = BoolGetDatum(true);
+	values[Anum_pg_subscription_subslotname - 1] = NameGetDatum(slotname);
+	values[Anum_pg_subscription_subconninfo - 1] = PointerGetDatum(conninfo);
+	if (PG_ARGISNULL(3))
+		nulls[Anum_pg_subscription_subtables - 1] = true;
+	else
+		values[Anum_pg_subscription_subtables - 1] =
+			normalize_table_names(PG_GETARG_ARRAYTYPE_P(3));
+
+	tup = heap_form_tuple(RelationGetDescr(rel), values, nulls);
+	subid = simple_heap_insert(rel, tup);
+	CatalogUpdateIndexes(rel, tup);
+	heap_freetuple(tup);
+
+	/* The apply worker tracks its progress in this replication origin. */
+	snprintf(originname, sizeof(originname), "pg_%u", subid);
+	replorigin_create(originname);
+
+	heap_close(rel, RowExclusiveLock);
+
+	ApplyLauncherWakeupAtCommit();
+
+	PG_RETURN_OID(subid);
+}
+
+/*
+ * pg_subscription_drop
+ *		Drop a subscription of the current database, stopping its worker.
+ *
+ * The replication slot on the publisher is left alone; it has to be dropped
+ * there separately once it is no longer needed.
+ */
+Datum
+pg_subscription_drop(PG_FUNCTION_ARGS)
+{
+	Name		subname = PG_GETARG_NAME(0);
+	Relation	rel;
+	HeapTuple	tup;
+	Oid			subid;
+	char		originname[NAMEDATALEN];
+	RepOriginId originid;
+
+	if (!superuser())
+		ereport(ERROR,
+				(errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
+				 errmsg("must be superuser to drop subscriptions")));
+
+	rel = heap_open(SubscriptionRelationId, RowExclusiveLock);
+
+	tup = subscription_tuple_by_name(rel, subname);
+	if (!HeapTupleIsValid(tup))
+		ereport(ERROR,
+				(errcode(ERRCODE_UNDEFINED_OBJECT),
+				 errmsg("subscription \"%s\" does not exist",
+						NameStr(*subname))));
+	subid = HeapTupleGetOid(tup);
+
+	/*
+	 * Lock the subscription, so that an apply worker starting concurrently
+	 * waits for us to commit and then finds it gone.
+	 */
+	LockSharedObject(SubscriptionRelationId, subid, 0, AccessExclusiveLock);
+
+	simple_heap_delete(rel, &tup->t_self);
+	heap_freetuple(tup);
+
+	/* Stop the worker, so that its replication origin can be dropped. */
+	logicalrep_worker_stop(subid);
+
+	snprintf(originname, sizeof(originname), "pg_%u", subid);
+	originid = replorigin_by_name(originname, true);
+	if (originid != InvalidRepOriginId)
+		replorigin_drop(originid);
+
+	heap_close(rel, RowExclusiveLock);
+
+	PG_RETURN_VOID();
+}
+
+/*
+ * Set subenabled of the named subscription and make the launcher react.
+ */
+static void
+subscription_set_enabled(Name subname, bool enabled)
+{
+	Relation	rel;
+	HeapTuple	tup;
+	Oid			subid;
+
+	if (!superuser())
+		ereport(ERROR,
+				(errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
+				 errmsg("must be superuser to alter subscriptions")));
+
+	rel = heap_open(SubscriptionRelationId, RowExclusiveLock);
+
+	tup = subscription_tuple_by_name(rel, subname);
+	if (!HeapTupleIsValid(tup))
+		ereport(ERROR,
+				(errcode(ERRCODE_UNDEFINED_OBJECT),
+				 errmsg("subscription \"%s\" does not exist",
+						NameStr(*subname))));
+	subid = HeapTupleGetOid(tup);
+
+	LockSharedObject(SubscriptionRelationId, subid, 0, AccessExclusiveLock);
+
+	((Form_pg_subscription) GETSTRUCT(tup))->subenabled = enabled;
+	simple_heap_update(rel, &tup->t_self, tup);
+	CatalogUpdateIndexes(rel, tup);
+	heap_freetuple(tup);
+
+	if (enabled)
+		ApplyLauncherWakeupAtCommit();
+	else
+		logicalrep_worker_stop(subid);
+
+	heap_close(rel, RowExclusiveLock);
+}
+
+/*
+ * pg_subscription_enable
+ *		Start applying changes for a disabled subscription again.
+ */
+Datum
+pg_subscription_enable(PG_FUNCTION_ARGS)
+{
+	subscription_set_enabled(PG_GETARG_NAME(0), true);
+
+	PG_RETURN_VOID();
+}
+
+/*
+ * pg_subscription_disable
+ *		Stop the apply worker of a subscription, keeping its progress.
+ */
+Datum
+pg_subscription_disable(PG_FUNCTION_ARGS)
+{
+	subscription_set_enabled(PG_GETARG_NAME(0), false);
+
+	PG_RETURN_VOID();
+}
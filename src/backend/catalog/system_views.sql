@@ -214,6 +214,7 @@ CREATE VIEW pg_stats AS
     WHERE NOT attisdropped AND has_column_privilege(c.oid, a.attnum, 'select');
 
 REVOKE ALL on pg_statistic FROM public;
+REVOKE ALL on pg_statistic_ext FROM public;
 
 CREATE VIEW pg_locks AS
     SELECT * FROM pg_lock_status() AS L;
@@ -652,6 +653,34 @@ CREATE VIEW pg_stat_replication AS
     WHERE S.usesysid = U.oid AND
             S.pid = W.pid;
 
+CREATE VIEW pg_stat_subscription AS
+    SELECT
+            su.oid AS subid,
+            su.subname,
+            st.pid,
+            st.received_lsn,
+            st.last_msg_receipt_time,
+            st.reply_lsn,
+            st.reply_time
+    FROM pg_subscription su
+            LEFT JOIN pg_stat_get_subscription() st
+                      ON (st.subid = su.oid);
+
+CREATE VIEW pg_stat_session_pool AS
+    SELECT
+            S.pid,
+            S.datid,
+            D.datname,
+            S.usesysid,
+            U.rolname AS usename,
+            S.sessions
+    FROM pg_stat_get_session_pool() AS S
+            LEFT JOIN pg_database AS D ON (S.datid = D.oid)
+            LEFT JOIN pg_authid AS U ON (S.usesysid = U.oid);
+
+CREATE VIEW pg_stat_syscache AS
+    SELECT * FROM pg_stat_get_syscache() AS S;
+
 CREATE VIEW pg_stat_ssl AS
     SELECT
             S.pid,
@@ -748,6 +777,18 @@ CREATE VIEW pg_stat_archiver AS
         s.stats_reset
     FROM pg_stat_get_archiver() s;
 
+CREATE VIEW pg_stat_wal_prefetch AS
+    SELECT
+        s.prefetch,
+        s.hit,
+        s.skip_init,
+        s.skip_new,
+        s.skip_fpw,
+        s.skip_rep,
+        s.hit_ratio,
+        s.distance
+    FROM pg_stat_get_wal_prefetch() s;
+
 CREATE VIEW pg_stat_bgwriter AS
     SELECT
         pg_stat_get_bgwriter_timed_checkpoints() AS checkpoints_timed,
@@ -791,6 +832,11 @@ CREATE VIEW pg_replication_origin_status AS
 
 REVOKE ALL ON pg_replication_origin_status FROM public;
 
+-- The connection strings of subscriptions may contain passwords.
+REVOKE ALL ON pg_subscription FROM public;
+GRANT SELECT (subdbid, subname, subenabled, subslotname, subtables)
+    ON pg_subscription TO public;
+
 --
 -- We have a few function definitions in here, too.
 -- At some point there might be enough to justify breaking them out into
@@ -46,6 +46,7 @@
 #include "utils/acl.h"
 #include "utils/attoptcache.h"
 #include "utils/datum.h"
+#include "utils/extended_stats.h"
 #include "utils/guc.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
@@ -562,6 +563,14 @@ do_analyze_rel(Relation onerel, int options, VacuumParams *params,
 			update_attstats(RelationGetRelid(Irel[ind]), false,
 							thisdata->attr_cnt, thisdata->vacattrstats);
 		}
+
+		/*
+		 * Build the extended statistics of the table's statistics objects,
+		 * if any, from the same sample.  They describe the table's own rows,
+		 * so there's nothing to do for inherited stats.
+		 */
+		if (!inh)
+			BuildRelationExtStatistics(onerel, totalrows, numrows, rows);
 	}
 
 	/*
@@ -132,6 +132,7 @@
 #include "storage/procarray.h"
 #include "storage/procsignal.h"
 #include "storage/sinval.h"
+#include "tcop/sessionpool.h"
 #include "tcop/tcopprot.h"
 #include "utils/builtins.h"
 #include "utils/memutils.h"
@@ -625,6 +626,13 @@ Async_Listen(const char *channel)
 	if (Trace_notify)
 		elog(DEBUG1, "Async_Listen(%s,%d)", channel, MyProcPid);
 
+	/* Notifications couldn't be delivered to a session that's switched out */
+	if (am_pooled_backend)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("cannot execute LISTEN in a pooled session"),
+				 errhint("Connect with session_pooling set to off to use LISTEN.")));
+
 	queue_listen(LISTEN_LISTEN, channel);
 }
 
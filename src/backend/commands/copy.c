@@ -26,6 +26,7 @@
 #include "access/xact.h"
 #include "access/xlog.h"
 #include "catalog/namespace.h"
+#include "catalog/partition.h"
 #include "catalog/pg_type.h"
 #include "commands/copy.h"
 #include "commands/defrem.h"
@@ -2155,6 +2156,7 @@ CopyFrom(CopyState cstate)
 	Datum	   *values;
 	bool	   *nulls;
 	ResultRelInfo *resultRelInfo;
+	bool		partitioned;
 	EState	   *estate = CreateExecutorState(); /* for ExecConstraints() */
 	ExprContext *econtext;
 	TupleTableSlot *myslot;
@@ -2172,6 +2174,7 @@ CopyFrom(CopyState cstate)
 	HeapTuple  *bufferedTuples = NULL;	/* initialize to silence warning */
 	Size		bufferedTuplesSize = 0;
 	int			firstBufferedLineNo = 0;
+	ListCell   *lc;
 
 	Assert(cstate->rel);
 
@@ -2206,6 +2209,19 @@ CopyFrom(CopyState cstate)
 
 	tupDesc = RelationGetDescr(cstate->rel);
 
+	/*
+	 * Rows copied into a partitioned table are routed to its partitions.
+	 * The optimizations below that depend on the target having been created
+	 * or truncated in this transaction apply to the partitioned table only,
+	 * so they're not used in that case.
+	 */
+	partitioned = (RelationGetPartitionKey(cstate->rel) != NULL);
+	if (partitioned && cstate->freeze)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("cannot perform FREEZE on partitioned table \"%s\"",
+						RelationGetRelationName(cstate->rel))));
+
 	/*----------
 	 * Check to see if we can avoid writing WAL
 	 *
@@ -2242,8 +2258,9 @@ CopyFrom(CopyState cstate)
 	 *----------
 	 */
 	/* createSubid is creation check, newRelfilenodeSubid is truncation check */
-	if (cstate->rel->rd_createSubid != InvalidSubTransactionId ||
-		cstate->rel->rd_newRelfilenodeSubid != InvalidSubTransactionId)
+	if (!partitioned &&
+		(cstate->rel->rd_createSubid != InvalidSubTransactionId ||
+		 cstate->rel->rd_newRelfilenodeSubid != InvalidSubTransactionId))
 	{
 		hi_options |= HEAP_INSERT_SKIP_FSM;
 		if (!XLogIsNeeded())
@@ -2292,6 +2309,9 @@ CopyFrom(CopyState cstate)
 	estate->es_result_relation_info = resultRelInfo;
 	estate->es_range_table = cstate->range_table;
 
+	if (partitioned)
+		ExecSetupPartitionRouting(resultRelInfo, estate);
+
 	/* Set up a tuple slot too */
 	myslot = ExecInitExtraTupleSlot(estate);
 	ExecSetSlotDescriptor(myslot, tupDesc);
@@ -2305,12 +2325,14 @@ CopyFrom(CopyState cstate)
 	 * BEFORE/INSTEAD OF triggers, or we need to evaluate volatile default
 	 * expressions. Such triggers or expressions might query the table we're
 	 * inserting to, and act differently if the tuples that have already been
-	 * processed and prepared for insertion are not there.
+	 * processed and prepared for insertion are not there.  Nor can we do it
+	 * when tuples are routed to partitions, as one batch would have to be
+	 * kept per partition.
 	 */
 	if ((resultRelInfo->ri_TrigDesc != NULL &&
 		 (resultRelInfo->ri_TrigDesc->trig_insert_before_row ||
 		  resultRelInfo->ri_TrigDesc->trig_insert_instead_row)) ||
-		cstate->volatile_defexprs)
+		cstate->volatile_defexprs || partitioned)
 	{
 		useHeapMultiInsert = false;
 	}
@@ -2334,7 +2356,8 @@ CopyFrom(CopyState cstate)
 	values = (Datum *) palloc(tupDesc->natts * sizeof(Datum));
 	nulls = (bool *) palloc(tupDesc->natts * sizeof(bool));
 
-	bistate = GetBulkInsertState();
+	/* A bulk insert state tracks a buffer of a single relation */
+	bistate = partitioned ? NULL : GetBulkInsertState();
 	econtext = GetPerTupleExprContext(estate);
 
 	/* Set up callback to identify error line number */
@@ -2346,6 +2369,7 @@ CopyFrom(CopyState cstate)
 	for (;;)
 	{
 		TupleTableSlot *slot;
+		ResultRelInfo *target = resultRelInfo;
 		bool		skip_tuple;
 		Oid			loaded_oid = InvalidOid;
 
@@ -2386,13 +2410,23 @@ CopyFrom(CopyState cstate)
 		slot = myslot;
 		ExecStoreTuple(tuple, slot, InvalidBuffer, false);
 
+		/* Find the partition to store the tuple in, if partitioned */
+		if (partitioned)
+		{
+			target = ExecFindPartition(resultRelInfo, &slot, estate);
+			if (slot != myslot)
+				tuple = ExecMaterializeSlot(slot);
+			tuple->t_tableOid = RelationGetRelid(target->ri_RelationDesc);
+			estate->es_result_relation_info = target;
+		}
+
 		skip_tuple = false;
 
 		/* BEFORE ROW INSERT Triggers */
-		if (resultRelInfo->ri_TrigDesc &&
-			resultRelInfo->ri_TrigDesc->trig_insert_before_row)
+		if (target->ri_TrigDesc &&
+			target->ri_TrigDesc->trig_insert_before_row)
 		{
-			slot = ExecBRInsertTriggers(estate, resultRelInfo, slot);
+			slot = ExecBRInsertTriggers(estate, target, slot);
 
 			if (slot == NULL)	/* "do nothing" */
 				skip_tuple = true;
@@ -2403,8 +2437,9 @@ CopyFrom(CopyState cstate)
 		if (!skip_tuple)
 		{
 			/* Check the constraints of the tuple */
-			if (cstate->rel->rd_att->constr)
-				ExecConstraints(resultRelInfo, slot, estate);
+			if (target->ri_RelationDesc->rd_att->constr ||
+				target->ri_PartitionCheck)
+				ExecConstraints(target, slot, estate);
 
 			if (useHeapMultiInsert)
 			{
@@ -2436,15 +2471,16 @@ CopyFrom(CopyState cstate)
 				List	   *recheckIndexes = NIL;
 
 				/* OK, store the tuple and create index entries for it */
-				heap_insert(cstate->rel, tuple, mycid, hi_options, bistate);
+				heap_insert(target->ri_RelationDesc, tuple, mycid,
+							hi_options, bistate);
 
-				if (resultRelInfo->ri_NumIndices > 0)
+				if (target->ri_NumIndices > 0)
 					recheckIndexes = ExecInsertIndexTuples(slot, &(tuple->t_self),
 														 estate, false, NULL,
 														   NIL);
 
 				/* AFTER ROW INSERT Triggers */
-				ExecARInsertTriggers(estate, resultRelInfo, tuple,
+				ExecARInsertTriggers(estate, target, tuple,
 									 recheckIndexes);
 
 				list_free(recheckIndexes);
@@ -2457,6 +2493,8 @@ CopyFrom(CopyState cstate)
 			 */
 			processed++;
 		}
+
+		estate->es_result_relation_info = resultRelInfo;
 	}
 
 	/* Flush any remaining buffered tuples */
@@ -2469,7 +2507,8 @@ CopyFrom(CopyState cstate)
 	/* Done, clean up */
 	error_context_stack = errcallback.previous;
 
-	FreeBulkInsertState(bistate);
+	if (bistate)
+		FreeBulkInsertState(bistate);
 
 	MemoryContextSwitchTo(oldcontext);
 
@@ -2493,6 +2532,15 @@ CopyFrom(CopyState cstate)
 
 	ExecCloseIndices(resultRelInfo);
 
+	/* Close partitions and any other trigger target relations */
+	foreach(lc, estate->es_trig_target_relations)
+	{
+		ResultRelInfo *rInfo = (ResultRelInfo *) lfirst(lc);
+
+		ExecCloseIndices(rInfo);
+		heap_close(rInfo->ri_RelationDesc, NoLock);
+	}
+
 	FreeExecutorState(estate);
 
 	/*
@@ -1077,6 +1077,9 @@ EventTriggerSupportsObjectType(ObjectType obtype)
 		case OBJECT_EVENT_TRIGGER:
 			/* no support for event triggers on event triggers */
 			return false;
+		case OBJECT_STATISTIC_EXT:
+			/* statistics objects aren't in pg_depend or objectaddress.c */
+			return false;
 		case OBJECT_AGGREGATE:
 		case OBJECT_AMOP:
 		case OBJECT_AMPROC:
@@ -56,7 +56,7 @@ static void report_triggers(ResultRelInfo *rInfo, bool show_relname,
 				ExplainState *es);
 static double elapsed_time(instr_time *starttime);
 static void ExplainPreScanNode(PlanState *planstate, Bitmapset **rels_used);
-static void ExplainPreScanMemberNodes(List *plans, PlanState **planstates,
+static void ExplainPreScanMemberNodes(PlanState **planstates, int nplans,
 						  Bitmapset **rels_used);
 static void ExplainPreScanSubPlans(List *plans, Bitmapset **rels_used);
 static void ExplainNode(PlanState *planstate, List *ancestors,
@@ -78,6 +78,8 @@ static void show_upper_qual(List *qual, const char *qlabel,
 				ExplainState *es);
 static void show_sort_keys(SortState *sortstate, List *ancestors,
 			   ExplainState *es);
+static void show_pruned_subplans(int nplans, int ninitialized,
+					 ExplainState *es);
 static void show_merge_append_keys(MergeAppendState *mstate, List *ancestors,
 					   ExplainState *es);
 static void show_agg_keys(AggState *astate, List *ancestors,
@@ -98,6 +100,8 @@ static void show_sortorder_options(StringInfo buf, Node *sortexpr,
 					   Oid sortOperator, Oid collation, bool nullsFirst);
 static void show_sort_info(SortState *sortstate, ExplainState *es);
 static void show_hash_info(HashState *hashstate, ExplainState *es);
+static void show_memoize_info(MemoizeState *mstate, List *ancestors,
+				  ExplainState *es);
 static void show_tidbitmap_info(BitmapHeapScanState *planstate,
 					ExplainState *es);
 static void show_instrumentation_count(const char *qlabel, int which,
@@ -111,7 +115,7 @@ static void ExplainModifyTarget(ModifyTable *plan, ExplainState *es);
 static void ExplainTargetRel(Plan *plan, Index rti, ExplainState *es);
 static void show_modifytable_info(ModifyTableState *mtstate, List *ancestors,
 					  ExplainState *es);
-static void ExplainMemberNodes(List *plans, PlanState **planstates,
+static void ExplainMemberNodes(PlanState **planstates, int nplans,
 				   List *ancestors, ExplainState *es);
 static void ExplainSubPlans(List *plans, List *ancestors,
 				const char *relationship, ExplainState *es);
@@ -776,28 +780,28 @@ ExplainPreScanNode(PlanState *planstate, Bitmapset **rels_used)
 	switch (nodeTag(plan))
 	{
 		case T_ModifyTable:
-			ExplainPreScanMemberNodes(((ModifyTable *) plan)->plans,
-								  ((ModifyTableState *) planstate)->mt_plans,
+			ExplainPreScanMemberNodes(((ModifyTableState *) planstate)->mt_plans,
+									  list_length(((ModifyTable *) plan)->plans),
 									  rels_used);
 			break;
 		case T_Append:
-			ExplainPreScanMemberNodes(((Append *) plan)->appendplans,
-									((AppendState *) planstate)->appendplans,
+			ExplainPreScanMemberNodes(((AppendState *) planstate)->appendplans,
+									  ((AppendState *) planstate)->as_nplans,
 									  rels_used);
 			break;
 		case T_MergeAppend:
-			ExplainPreScanMemberNodes(((MergeAppend *) plan)->mergeplans,
-								((MergeAppendState *) planstate)->mergeplans,
+			ExplainPreScanMemberNodes(((MergeAppendState *) planstate)->mergeplans,
+									  ((MergeAppendState *) planstate)->ms_nplans,
 									  rels_used);
 			break;
 		case T_BitmapAnd:
-			ExplainPreScanMemberNodes(((BitmapAnd *) plan)->bitmapplans,
-								 ((BitmapAndState *) planstate)->bitmapplans,
+			ExplainPreScanMemberNodes(((BitmapAndState *) planstate)->bitmapplans,
+									  list_length(((BitmapAnd *) plan)->bitmapplans),
 									  rels_used);
 			break;
 		case T_BitmapOr:
-			ExplainPreScanMemberNodes(((BitmapOr *) plan)->bitmapplans,
-								  ((BitmapOrState *) planstate)->bitmapplans,
+			ExplainPreScanMemberNodes(((BitmapOrState *) planstate)->bitmapplans,
+									  list_length(((BitmapOr *) plan)->bitmapplans),
 									  rels_used);
 			break;
 		case T_SubqueryScan:
@@ -817,14 +821,14 @@ ExplainPreScanNode(PlanState *planstate, Bitmapset **rels_used)
  * Prescan the constituent plans of a ModifyTable, Append, MergeAppend,
  * BitmapAnd, or BitmapOr node.
  *
- * Note: we don't actually need to examine the Plan list members, but
- * we need the list in order to determine the length of the PlanState array.
+ * nplans is the length of the PlanState array.  For Append and MergeAppend
+ * that can be less than the number of subplans, since the subplans that
+ * run-time partition pruning ruled out at executor startup have no PlanState.
  */
 static void
-ExplainPreScanMemberNodes(List *plans, PlanState **planstates,
+ExplainPreScanMemberNodes(PlanState **planstates, int nplans,
 						  Bitmapset **rels_used)
 {
-	int			nplans = list_length(plans);
 	int			j;
 
 	for (j = 0; j < nplans; j++)
@@ -994,6 +998,9 @@ ExplainNode(PlanState *planstate, List *ancestors,
 		case T_Material:
 			pname = sname = "Materialize";
 			break;
+		case T_Memoize:
+			pname = sname = "Memoize";
+			break;
 		case T_Sort:
 			pname = sname = "Sort";
 			break;
@@ -1318,6 +1325,9 @@ ExplainNode(PlanState *planstate, List *ancestors,
 		case T_IndexScan:
 			show_scan_qual(((IndexScan *) plan)->indexqualorig,
 						   "Index Cond", planstate, ancestors, es);
+			if (((IndexScan *) plan)->indexskipprefix > 0)
+				ExplainPropertyInteger("Skip Prefix",
+								((IndexScan *) plan)->indexskipprefix, es);
 			if (((IndexScan *) plan)->indexqualorig)
 				show_instrumentation_count("Rows Removed by Index Recheck", 2,
 										   planstate, es);
@@ -1331,6 +1341,9 @@ ExplainNode(PlanState *planstate, List *ancestors,
 		case T_IndexOnlyScan:
 			show_scan_qual(((IndexOnlyScan *) plan)->indexqual,
 						   "Index Cond", planstate, ancestors, es);
+			if (((IndexOnlyScan *) plan)->indexskipprefix > 0)
+				ExplainPropertyInteger("Skip Prefix",
+							((IndexOnlyScan *) plan)->indexskipprefix, es);
 			if (((IndexOnlyScan *) plan)->indexqual)
 				show_instrumentation_count("Rows Removed by Index Recheck", 2,
 										   planstate, es);
@@ -1347,6 +1360,9 @@ ExplainNode(PlanState *planstate, List *ancestors,
 		case T_BitmapIndexScan:
 			show_scan_qual(((BitmapIndexScan *) plan)->indexqualorig,
 						   "Index Cond", planstate, ancestors, es);
+			if (((BitmapIndexScan *) plan)->indexskipprefix > 0)
+				ExplainPropertyInteger("Skip Prefix",
+						  ((BitmapIndexScan *) plan)->indexskipprefix, es);
 			break;
 		case T_BitmapHeapScan:
 			show_scan_qual(((BitmapHeapScan *) plan)->bitmapqualorig,
@@ -1485,9 +1501,17 @@ ExplainNode(PlanState *planstate, List *ancestors,
 			show_sort_keys((SortState *) planstate, ancestors, es);
 			show_sort_info((SortState *) planstate, es);
 			break;
+		case T_Append:
+			show_pruned_subplans(list_length(((Append *) plan)->appendplans),
+								 ((AppendState *) planstate)->as_nplans,
+								 es);
+			break;
 		case T_MergeAppend:
 			show_merge_append_keys((MergeAppendState *) planstate,
 								   ancestors, es);
+			show_pruned_subplans(list_length(((MergeAppend *) plan)->mergeplans),
+								 ((MergeAppendState *) planstate)->ms_nplans,
+								 es);
 			break;
 		case T_Result:
 			show_upper_qual((List *) ((Result *) plan)->resconstantqual,
@@ -1504,6 +1528,9 @@ ExplainNode(PlanState *planstate, List *ancestors,
 		case T_Hash:
 			show_hash_info((HashState *) planstate, es);
 			break;
+		case T_Memoize:
+			show_memoize_info((MemoizeState *) planstate, ancestors, es);
+			break;
 		default:
 			break;
 	}
@@ -1650,28 +1677,28 @@ ExplainNode(PlanState *planstate, List *ancestors,
 	switch (nodeTag(plan))
 	{
 		case T_ModifyTable:
-			ExplainMemberNodes(((ModifyTable *) plan)->plans,
-							   ((ModifyTableState *) planstate)->mt_plans,
+			ExplainMemberNodes(((ModifyTableState *) planstate)->mt_plans,
+							   list_length(((ModifyTable *) plan)->plans),
 							   ancestors, es);
 			break;
 		case T_Append:
-			ExplainMemberNodes(((Append *) plan)->appendplans,
-							   ((AppendState *) planstate)->appendplans,
+			ExplainMemberNodes(((AppendState *) planstate)->appendplans,
+							   ((AppendState *) planstate)->as_nplans,
 							   ancestors, es);
 			break;
 		case T_MergeAppend:
-			ExplainMemberNodes(((MergeAppend *) plan)->mergeplans,
-							   ((MergeAppendState *) planstate)->mergeplans,
+			ExplainMemberNodes(((MergeAppendState *) planstate)->mergeplans,
+							   ((MergeAppendState *) planstate)->ms_nplans,
 							   ancestors, es);
 			break;
 		case T_BitmapAnd:
-			ExplainMemberNodes(((BitmapAnd *) plan)->bitmapplans,
-							   ((BitmapAndState *) planstate)->bitmapplans,
+			ExplainMemberNodes(((BitmapAndState *) planstate)->bitmapplans,
+							   list_length(((BitmapAnd *) plan)->bitmapplans),
 							   ancestors, es);
 			break;
 		case T_BitmapOr:
-			ExplainMemberNodes(((BitmapOr *) plan)->bitmapplans,
-							   ((BitmapOrState *) planstate)->bitmapplans,
+			ExplainMemberNodes(((BitmapOrState *) planstate)->bitmapplans,
+							   list_length(((BitmapOr *) plan)->bitmapplans),
 							   ancestors, es);
 			break;
 		case T_SubqueryScan:
@@ -1849,6 +1876,17 @@ show_merge_append_keys(MergeAppendState *mstate, List *ancestors,
 						 ancestors, es);
 }
 
+/*
+ * Show how many subplans of an Append or MergeAppend node run-time partition
+ * pruning ruled out at executor startup.
+ */
+static void
+show_pruned_subplans(int nplans, int ninitialized, ExplainState *es)
+{
+	if (ninitialized < nplans)
+		ExplainPropertyInteger("Subplans Removed", nplans - ninitialized, es);
+}
+
 /*
  * Show the grouping keys for an Agg node.
  */
@@ -2181,6 +2219,66 @@ show_hash_info(HashState *hashstate, ExplainState *es)
 	}
 }
 
+/*
+ * Show the cache keys of a Memoize node, and if it's EXPLAIN ANALYZE, how
+ * well the cache worked.
+ */
+static void
+show_memoize_info(MemoizeState *mstate, List *ancestors, ExplainState *es)
+{
+	Memoize    *plan = (Memoize *) mstate->ss.ps.plan;
+	List	   *context;
+	bool		useprefix;
+	StringInfoData keystr;
+	ListCell   *lc;
+	const char *separator = "";
+
+	/* Set up deparsing context */
+	context = set_deparse_context_planstate(es->deparse_cxt,
+											(Node *) mstate,
+											ancestors);
+	useprefix = list_length(es->rtable) > 1;
+
+	initStringInfo(&keystr);
+	foreach(lc, plan->param_exprs)
+	{
+		Node	   *expr = (Node *) lfirst(lc);
+
+		appendStringInfoString(&keystr, separator);
+		appendStringInfoString(&keystr,
+							   deparse_expression(expr, context,
+												  useprefix, false));
+		separator = ", ";
+	}
+	ExplainPropertyText("Cache Key", keystr.data, es);
+	pfree(keystr.data);
+
+	if (es->analyze)
+	{
+		long		memPeakKb = (mstate->mem_peak + 1023) / 1024;
+
+		if (es->format != EXPLAIN_FORMAT_TEXT)
+		{
+			ExplainPropertyLong("Cache Hits", mstate->cache_hits, es);
+			ExplainPropertyLong("Cache Misses", mstate->cache_misses, es);
+			ExplainPropertyLong("Cache Evictions",
+								mstate->cache_evictions, es);
+			ExplainPropertyLong("Cache Overflows",
+								mstate->cache_overflows, es);
+			ExplainPropertyLong("Peak Memory Usage", memPeakKb, es);
+		}
+		else if (mstate->cache_hits > 0 || mstate->cache_misses > 0)
+		{
+			appendStringInfoSpaces(es->str, es->indent * 2);
+			appendStringInfo(es->str,
+							 "Hits: %ld  Misses: %ld  Evictions: %ld  Overflows: %ld  Memory Usage: %ldkB\n",
+							 mstate->cache_hits, mstate->cache_misses,
+							 mstate->cache_evictions,
+							 mstate->cache_overflows, memPeakKb);
+		}
+	}
+}
+
 /*
  * If it's EXPLAIN ANALYZE, show exact/lossy pages for a BitmapHeapScan node
  */
@@ -2610,14 +2708,14 @@ show_modifytable_info(ModifyTableState *mtstate, List *ancestors,
  * The ancestors list should already contain the immediate parent of these
  * plans.
  *
- * Note: we don't actually need to examine the Plan list members, but
- * we need the list in order to determine the length of the PlanState array.
+ * nplans is the length of the PlanState array.  For Append and MergeAppend
+ * that can be less than the number of subplans, since the subplans that
+ * run-time partition pruning ruled out at executor startup have no PlanState.
  */
 static void
-ExplainMemberNodes(List *plans, PlanState **planstates,
+ExplainMemberNodes(PlanState **planstates, int nplans,
 				   List *ancestors, ExplainState *es)
 {
-	int			nplans = list_length(plans);
 	int			j;
 
 	for (j = 0; j < nplans; j++)
@@ -171,6 +171,8 @@ CheckIndexCompatible(Oid oldId,
 	 * later on, and it would have failed then anyway.
 	 */
 	indexInfo = makeNode(IndexInfo);
+	indexInfo->ii_NumIndexAttrs = numberOfAttributes;
+	indexInfo->ii_NumIndexKeyAttrs = numberOfAttributes;
 	indexInfo->ii_Expressions = NIL;
 	indexInfo->ii_ExpressionsState = NIL;
 	indexInfo->ii_PredicateState = NIL;
@@ -196,11 +198,13 @@ CheckIndexCompatible(Oid oldId,
 	indexForm = (Form_pg_index) GETSTRUCT(tuple);
 
 	/*
-	 * We don't assess expressions or predicates; assume incompatibility.
-	 * Also, if the index is invalid for any reason, treat it as incompatible.
+	 * We don't assess expressions, predicates or included columns; assume
+	 * incompatibility.  Also, if the index is invalid for any reason, treat
+	 * it as incompatible.
 	 */
 	if (!(heap_attisnull(tuple, Anum_pg_index_indpred) &&
 		  heap_attisnull(tuple, Anum_pg_index_indexprs) &&
+		  indexForm->indnkeyatts == indexForm->indnatts &&
 		  IndexIsValid(indexForm)))
 	{
 		ReleaseSysCache(tuple);
@@ -321,6 +325,8 @@ DefineIndex(Oid relationId,
 	int16	   *coloptions;
 	IndexInfo  *indexInfo;
 	int			numberOfAttributes;
+	int			numberOfKeyAttributes;
+	List	   *allIndexParams;
 	TransactionId limitXmin;
 	VirtualTransactionId *old_snapshots;
 	ObjectAddress address;
@@ -332,13 +338,21 @@ DefineIndex(Oid relationId,
 	int			i;
 
 	/*
-	 * count attributes in index
+	 * count key attributes in index
 	 */
-	numberOfAttributes = list_length(stmt->indexParams);
-	if (numberOfAttributes <= 0)
+	numberOfKeyAttributes = list_length(stmt->indexParams);
+	if (numberOfKeyAttributes <= 0)
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_OBJECT_DEFINITION),
 				 errmsg("must specify at least one column")));
+
+	/*
+	 * Included (non-key) columns follow the key columns in the index, so
+	 * treat them as a single list of columns from here on.
+	 */
+	allIndexParams = list_concat(list_copy(stmt->indexParams),
+								 list_copy(stmt->indexIncludingParams));
+	numberOfAttributes = list_length(allIndexParams);
 	if (numberOfAttributes > INDEX_MAX_KEYS)
 		ereport(ERROR,
 				(errcode(ERRCODE_TOO_MANY_COLUMNS),
@@ -448,7 +462,7 @@ DefineIndex(Oid relationId,
 	/*
 	 * Choose the index column names.
 	 */
-	indexColNames = ChooseIndexColumnNames(stmt->indexParams);
+	indexColNames = ChooseIndexColumnNames(allIndexParams);
 
 	/*
 	 * Select name for index if caller didn't specify
@@ -499,6 +513,11 @@ DefineIndex(Oid relationId,
 				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
 			   errmsg("access method \"%s\" does not support unique indexes",
 					  accessMethodName)));
+	if (stmt->indexIncludingParams != NIL && !accessMethodForm->amcaninclude)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("access method \"%s\" does not support included columns",
+				   accessMethodName)));
 	if (numberOfAttributes > 1 && !accessMethodForm->amcanmulticol)
 		ereport(ERROR,
 				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
@@ -535,6 +554,7 @@ DefineIndex(Oid relationId,
 	 */
 	indexInfo = makeNode(IndexInfo);
 	indexInfo->ii_NumIndexAttrs = numberOfAttributes;
+	indexInfo->ii_NumIndexKeyAttrs = numberOfKeyAttributes;
 	indexInfo->ii_Expressions = NIL;	/* for now */
 	indexInfo->ii_ExpressionsState = NIL;
 	indexInfo->ii_Predicate = make_ands_implicit((Expr *) stmt->whereClause);
@@ -554,7 +574,7 @@ DefineIndex(Oid relationId,
 	coloptions = (int16 *) palloc(numberOfAttributes * sizeof(int16));
 	ComputeIndexAttrs(indexInfo,
 					  typeObjectId, collationObjectId, classObjectId,
-					  coloptions, stmt->indexParams,
+					  coloptions, allIndexParams,
 					  stmt->excludeOpNames, relationId,
 					  accessMethodName, accessMethodId,
 					  amcanorder, stmt->isconstraint);
@@ -982,6 +1002,53 @@ ComputeIndexAttrs(IndexInfo *indexInfo,
 		Oid			atttype;
 		Oid			attcollation;
 
+		/*
+		 * Included (non-key) columns are just stored in the index; they have
+		 * no opclass, collation, or ordering options.  Only simple column
+		 * references are supported.
+		 */
+		if (attn >= indexInfo->ii_NumIndexKeyAttrs)
+		{
+			HeapTuple	atttuple;
+			Form_pg_attribute attform;
+
+			if (attribute->name == NULL)
+				ereport(ERROR,
+						(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+						 errmsg("expressions are not supported in included columns")));
+			if (attribute->collation != NIL)
+				ereport(ERROR,
+						(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+						 errmsg("including column does not support a collation")));
+			if (attribute->opclass != NIL)
+				ereport(ERROR,
+						(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+						 errmsg("including column does not support an operator class")));
+			if (attribute->ordering != SORTBY_DEFAULT ||
+				attribute->nulls_ordering != SORTBY_NULLS_DEFAULT)
+				ereport(ERROR,
+						(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+						 errmsg("including column does not support ASC/DESC/NULLS FIRST/LAST options")));
+
+			atttuple = SearchSysCacheAttName(relId, attribute->name);
+			if (!HeapTupleIsValid(atttuple))
+				ereport(ERROR,
+						(errcode(ERRCODE_UNDEFINED_COLUMN),
+						 errmsg("column \"%s\" does not exist",
+								attribute->name)));
+			attform = (Form_pg_attribute) GETSTRUCT(atttuple);
+			indexInfo->ii_KeyAttrNumbers[attn] = attform->attnum;
+			typeOidP[attn] = attform->atttypid;
+			ReleaseSysCache(atttuple);
+
+			collationOidP[attn] = InvalidOid;
+			classOidP[attn] = InvalidOid;
+			colOptionP[attn] = 0;
+
+			attn++;
+			continue;
+		}
+
 		/*
 		 * Process the column-or-expression to be indexed.
 		 */
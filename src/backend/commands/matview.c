@@ -653,7 +653,7 @@ refresh_by_match_merge(Oid matviewOid, Oid tempOid, Oid relowner,
 			RelationGetIndexExpressions(indexRel) == NIL &&
 			RelationGetIndexPredicate(indexRel) == NIL)
 		{
-			int			numatts = indexStruct->indnatts;
+			int			numatts = indexStruct->indnkeyatts;
 			int			i;
 
 			/* Add quals for all columns from this index. */
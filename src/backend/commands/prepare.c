@@ -608,6 +608,21 @@ DropAllPreparedStatements(void)
 	}
 }
 
+/*
+ * Install another set of prepared statements, returning the current one.
+ *
+ * This is used by pooled backends to give each client session its own
+ * prepared statements.  NULL stands for an empty set.
+ */
+HTAB *
+SwapPreparedStatements(HTAB *queries)
+{
+	HTAB	   *old = prepared_queries;
+
+	prepared_queries = queries;
+	return old;
+}
+
 /*
  * Implements the 'EXPLAIN EXECUTE' utility statement.
  *
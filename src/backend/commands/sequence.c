@@ -37,6 +37,7 @@
 #include "utils/acl.h"
 #include "utils/builtins.h"
 #include "utils/lsyscache.h"
+#include "utils/memutils.h"
 #include "utils/resowner.h"
 #include "utils/syscache.h"
 
@@ -87,6 +88,13 @@ static HTAB *seqhashtab = NULL; /* hash table for SeqTable items */
  */
 static SeqTableData *last_used_seq = NULL;
 
+/* The above, saved by SwapSequenceCaches */
+struct SequenceCaches
+{
+	HTAB	   *seqhashtab;
+	SeqTableData *last_used_seq;
+};
+
 static void fill_seq_with_data(Relation rel, HeapTuple tuple);
 static int64 nextval_internal(Oid relid);
 static Relation open_share_lock(SeqTable seq);
@@ -1638,3 +1646,38 @@ ResetSequenceCaches(void)
 
 	last_used_seq = NULL;
 }
+
+/*
+ * Install another set of sequence caches, returning the current one.
+ *
+ * This is used by pooled backends to give each client session its own
+ * currval() and lastval() values.  The numbers a session has cached go with
+ * it; they were allocated to this backend, and no other backend hands them
+ * out.  NULL stands for a session that hasn't used any sequences yet.
+ */
+SequenceCaches *
+SwapSequenceCaches(SequenceCaches *caches)
+{
+	SequenceCaches *old = NULL;
+
+	if (seqhashtab != NULL)
+	{
+		old = MemoryContextAlloc(TopMemoryContext, sizeof(SequenceCaches));
+		old->seqhashtab = seqhashtab;
+		old->last_used_seq = last_used_seq;
+	}
+
+	if (caches != NULL)
+	{
+		seqhashtab = caches->seqhashtab;
+		last_used_seq = caches->last_used_seq;
+		pfree(caches);
+	}
+	else
+	{
+		seqhashtab = NULL;
+		last_used_seq = NULL;
+	}
+
+	return old;
+}
@@ -0,0 +1,283 @@
+/*-------------------------------------------------------------------------
+ *
+ * statscmds.c
+ *	  Commands for creating and dropping extended statistics objects
+ *
+ * A statistics object belongs to the table whose columns it covers: it
+ * lives in the table's schema, only the table's owner can create or drop
+ * it, and it goes away with the table or any of its columns.
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *	  src/backend/commands/statscmds.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/heapam.h"
+#include "access/htup_details.h"
+#include "catalog/indexing.h"
+#include "catalog/namespace.h"
+#include "catalog/pg_statistic_ext.h"
+#include "catalog/pg_type.h"
+#include "commands/defrem.h"
+#include "miscadmin.h"
+#include "utils/acl.h"
+#include "utils/array.h"
+#include "utils/builtins.h"
+#include "utils/extended_stats.h"
+#include "utils/inval.h"
+#include "utils/lsyscache.h"
+#include "utils/rel.h"
+#include "utils/syscache.h"
+#include "utils/typcache.h"
+
+
+/* qsort comparator for the column numbers of a statistics object */
+static int
+compare_int16(const void *a, const void *b)
+{
+	int			av = *(const int16 *) a;
+	int			bv = *(const int16 *) b;
+
+	return av - bv;
+}
+
+/*
+ * CREATE STATISTICS
+ */
+ObjectAddress
+CreateStatistics(CreateStatsStmt *stmt)
+{
+	Relation	rel;
+	Relation	statrel;
+	Oid			relid;
+	Oid			namespaceId;
+	NameData	stxname;
+	int16		attnums[STATS_MAX_DIMENSIONS];
+	int			numcols = 0;
+	bool		build_ndistinct;
+	bool		build_dependencies;
+	Datum		kinds[2];
+	int			nkinds = 0;
+	Datum		values[Natts_pg_statistic_ext];
+	bool		nulls[Natts_pg_statistic_ext];
+	HeapTuple	htup;
+	Oid			statoid;
+	ObjectAddress address;
+	ListCell   *lc;
+	int			i;
+
+	/*
+	 * Lock the table against concurrent schema changes, but not against
+	 * queries or ANALYZE.
+	 */
+	rel = heap_openrv(stmt->relation, ShareUpdateExclusiveLock);
+	relid = RelationGetRelid(rel);
+
+	if (rel->rd_rel->relkind != RELKIND_RELATION &&
+		rel->rd_rel->relkind != RELKIND_MATVIEW)
+		ereport(ERROR,
+				(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+				 errmsg("\"%s\" is not a table or materialized view",
+						RelationGetRelationName(rel))));
+
+	if (!pg_class_ownercheck(relid, GetUserId()))
+		aclcheck_error(ACLCHECK_NOT_OWNER, ACL_KIND_CLASS,
+					   RelationGetRelationName(rel));
+
+	namespaceId = RelationGetNamespace(rel);
+	namestrcpy(&stxname, stmt->statname);
+
+	if (SearchSysCacheExists2(STATEXTNAMENSP,
+							  NameGetDatum(&stxname),
+							  ObjectIdGetDatum(namespaceId)))
+	{
+		if (stmt->if_not_exists)
+		{
+			ereport(NOTICE,
+					(errcode(ERRCODE_DUPLICATE_OBJECT),
+					 errmsg("statistics object \"%s\" already exists, skipping",
+							stmt->statname)));
+			heap_close(rel, NoLock);
+			return InvalidObjectAddress;
+		}
+
+		ereport(ERROR,
+				(errcode(ERRCODE_DUPLICATE_OBJECT),
+				 errmsg("statistics object \"%s\" already exists",
+						stmt->statname)));
+	}
+
+	foreach(lc, stmt->keys)
+	{
+		char	   *attname = strVal(lfirst(lc));
+		HeapTuple	atttuple;
+		Form_pg_attribute attform;
+		TypeCacheEntry *typentry;
+
+		atttuple = SearchSysCacheAttName(relid, attname);
+		if (!HeapTupleIsValid(atttuple))
+			ereport(ERROR,
+					(errcode(ERRCODE_UNDEFINED_COLUMN),
+					 errmsg("column \"%s\" does not exist",
+							attname)));
+		attform = (Form_pg_attribute) GETSTRUCT(atttuple);
+
+		if (attform->attnum <= 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				errmsg("statistics creation on system columns is not supported")));
+
+		typentry = lookup_type_cache(attform->atttypid, TYPECACHE_LT_OPR);
+		if (!OidIsValid(typentry->lt_opr))
+			ereport(ERROR,
+					(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					 errmsg("column \"%s\" cannot be used in statistics because its type %s has no default btree operator class",
+							attname, format_type_be(attform->atttypid))));
+
+		if (numcols >= STATS_MAX_DIMENSIONS)
+			ereport(ERROR,
+					(errcode(ERRCODE_TOO_MANY_COLUMNS),
+					 errmsg("cannot have more than %d columns in statistics",
+							STATS_MAX_DIMENSIONS)));
+
+		for (i = 0; i < numcols; i++)
+		{
+			if (attnums[i] == attform->attnum)
+				ereport(ERROR,
+						(errcode(ERRCODE_DUPLICATE_COLUMN),
+						 errmsg("duplicate column name in statistics definition")));
+		}
+
+		attnums[numcols++] = attform->attnum;
+		ReleaseSysCache(atttuple);
+	}
+
+	if (numcols < 2)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_OBJECT_DEFINITION),
+				 errmsg("extended statistics require at least 2 columns")));
+
+	/* Store the columns in a canonical order */
+	qsort(attnums, numcols, sizeof(int16), compare_int16);
+
+	/* No statistic kinds specified means all of them */
+	build_ndistinct = (stmt->stat_types == NIL);
+	build_dependencies = (stmt->stat_types == NIL);
+	foreach(lc, stmt->stat_types)
+	{
+		char	   *type = strVal(lfirst(lc));
+
+		if (strcmp(type, "ndistinct") == 0)
+			build_ndistinct = true;
+		else if (strcmp(type, "dependencies") == 0)
+			build_dependencies = true;
+		else
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("unrecognized statistic type \"%s\"",
+							type)));
+	}
+	if (build_ndistinct)
+		kinds[nkinds++] = CharGetDatum(STATS_EXT_NDISTINCT);
+	if (build_dependencies)
+		kinds[nkinds++] = CharGetDatum(STATS_EXT_DEPENDENCIES);
+
+	memset(values, 0, sizeof(values));
+	memset(nulls, false, sizeof(nulls));
+
+	values[Anum_pg_statistic_ext_stxrelid - 1] = ObjectIdGetDatum(relid);
+	values[Anum_pg_statistic_ext_stxname - 1] = NameGetDatum(&stxname);
+	values[Anum_pg_statistic_ext_stxnamespace - 1] =
+		ObjectIdGetDatum(namespaceId);
+	values[Anum_pg_statistic_ext_stxkeys - 1] =
+		PointerGetDatum(buildint2vector(attnums, numcols));
+	values[Anum_pg_statistic_ext_stxkind - 1] =
+		PointerGetDatum(construct_array(kinds, nkinds,
+										CHAROID, 1, true, 'c'));
+
+	/* The statistics themselves are built by the next ANALYZE */
+	nulls[Anum_pg_statistic_ext_stxndistinct - 1] = true;
+	nulls[Anum_pg_statistic_ext_stxdependencies - 1] = true;
+
+	statrel = heap_open(StatisticExtRelationId, RowExclusiveLock);
+
+	htup = heap_form_tuple(RelationGetDescr(statrel), values, nulls);
+	statoid = simple_heap_insert(statrel, htup);
+	CatalogUpdateIndexes(statrel, htup);
+	heap_freetuple(htup);
+
+	heap_close(statrel, RowExclusiveLock);
+
+	/* Make the planner of other backends see the new statistics object */
+	CacheInvalidateRelcache(rel);
+
+	heap_close(rel, NoLock);
+
+	ObjectAddressSet(address, StatisticExtRelationId, statoid);
+
+	return address;
+}
+
+/*
+ * DROP STATISTICS
+ */
+void
+RemoveStatisticsObjects(DropStmt *stmt)
+{
+	Relation	statrel;
+	ListCell   *lc;
+
+	statrel = heap_open(StatisticExtRelationId, RowExclusiveLock);
+
+	foreach(lc, stmt->objects)
+	{
+		List	   *names = (List *) lfirst(lc);
+		Oid			statoid;
+		Oid			relid;
+		HeapTuple	htup;
+		Relation	rel;
+
+		statoid = get_statistics_oid(names, stmt->missing_ok);
+		if (!OidIsValid(statoid))
+		{
+			ereport(NOTICE,
+				(errmsg("statistics object \"%s\" does not exist, skipping",
+						NameListToString(names))));
+			continue;
+		}
+
+		htup = SearchSysCache1(STATEXTOID, ObjectIdGetDatum(statoid));
+		if (!HeapTupleIsValid(htup))
+			elog(ERROR, "cache lookup failed for statistics object %u",
+				 statoid);
+		relid = ((Form_pg_statistic_ext) GETSTRUCT(htup))->stxrelid;
+		ReleaseSysCache(htup);
+
+		/* Lock the table as CREATE STATISTICS does, and recheck */
+		rel = heap_open(relid, ShareUpdateExclusiveLock);
+
+		htup = SearchSysCache1(STATEXTOID, ObjectIdGetDatum(statoid));
+		if (!HeapTupleIsValid(htup))
+			elog(ERROR, "cache lookup failed for statistics object %u",
+				 statoid);
+
+		if (!pg_class_ownercheck(relid, GetUserId()))
+			aclcheck_error(ACLCHECK_NOT_OWNER, ACL_KIND_CLASS,
+						   RelationGetRelationName(rel));
+
+		simple_heap_delete(statrel, &htup->t_self);
+		ReleaseSysCache(htup);
+
+		CacheInvalidateRelcache(rel);
+
+		heap_close(rel, NoLock);
+	}
+
+	heap_close(statrel, RowExclusiveLock);
+}
@@ -29,6 +29,7 @@
 #include "catalog/indexing.h"
 #include "catalog/namespace.h"
 #include "catalog/objectaccess.h"
+#include "catalog/partition.h"
 #include "catalog/pg_collation.h"
 #include "catalog/pg_constraint.h"
 #include "catalog/pg_depend.h"
@@ -273,9 +274,11 @@ static List *MergeAttributes(List *schema, List *supers, char relpersistence,
 static bool MergeCheckConstraint(List *constraints, char *name, Node *expr);
 static void MergeAttributesIntoExisting(Relation child_rel, Relation parent_rel);
 static void MergeConstraintsIntoExisting(Relation child_rel, Relation parent_rel);
-static void StoreCatalogInheritance(Oid relationId, List *supers);
+static void StoreCatalogInheritance(Oid relationId, List *supers,
+						bool child_is_partition);
 static void StoreCatalogInheritance1(Oid relationId, Oid parentOid,
-						 int16 seqNumber, Relation inhRelation);
+						 int16 seqNumber, Relation inhRelation,
+						 bool child_is_partition);
 static int	findAttrByName(const char *attributeName, List *schema);
 static void AlterIndexNamespaces(Relation classRel, Relation rel,
 				   Oid oldNspOid, Oid newNspOid, ObjectAddresses *objsMoved);
@@ -467,6 +470,8 @@ DefineRelation(CreateStmt *stmt, char relkind, Oid ownerId,
 	AttrNumber	attnum;
 	static char *validnsps[] = HEAP_RELOPT_NAMESPACES;
 	Oid			ofTypeId;
+	char		partstrategy = 0;
+	Relation	parent = NULL;
 	ObjectAddress address;
 
 	/*
@@ -484,6 +489,29 @@ DefineRelation(CreateStmt *stmt, char relkind, Oid ownerId,
 				(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
 				 errmsg("ON COMMIT can only be used on temporary tables")));
 
+	if ((stmt->partspec || stmt->partbound) && relkind != RELKIND_RELATION)
+		ereport(ERROR,
+				(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+				 errmsg("only tables can be partitioned or be partitions")));
+
+	if (stmt->partspec)
+	{
+		if (pg_strcasecmp(stmt->partspec->strategy, "range") == 0)
+			partstrategy = PARTITION_STRATEGY_RANGE;
+		else if (pg_strcasecmp(stmt->partspec->strategy, "list") == 0)
+			partstrategy = PARTITION_STRATEGY_LIST;
+		else
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("unrecognized partitioning strategy \"%s\"",
+							stmt->partspec->strategy)));
+
+		if (stmt->inhRelations && !stmt->partbound)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+					 errmsg("cannot create partitioned table as inheritance child")));
+	}
+
 	/*
 	 * Look up the namespace in which we are supposed to create the relation,
 	 * check we have permission to create there, lock it against concurrent
@@ -572,6 +600,41 @@ DefineRelation(CreateStmt *stmt, char relkind, Oid ownerId,
 							 stmt->relation->relpersistence,
 							 &inheritOids, &old_constraints, &parentOidCount);
 
+	/*
+	 * Partitioned tables and partitions only have partitions as inheritance
+	 * children.  A partition must have its parent's persistence, so that
+	 * rows routed to it survive (or don't) exactly as they would in the
+	 * parent.  transformCreateStmt already locked the parent of a new
+	 * partition against concurrent addition of partitions.
+	 */
+	foreach(listptr, inheritOids)
+	{
+		Oid			parentOid = lfirst_oid(listptr);
+
+		if (stmt->partbound)
+		{
+			parent = heap_open(parentOid, NoLock);
+			if (parent->rd_rel->relpersistence !=
+				stmt->relation->relpersistence)
+				ereport(ERROR,
+						(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+						 errmsg("partition \"%s\" must have the same persistence as partitioned table \"%s\"",
+								relname, RelationGetRelationName(parent))));
+		}
+		else if (SearchSysCacheExists1(PARTRELID,
+									   ObjectIdGetDatum(parentOid)))
+			ereport(ERROR,
+					(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+					 errmsg("cannot inherit from partitioned table \"%s\"",
+							get_rel_name(parentOid)),
+					 errhint("Use CREATE TABLE ... PARTITION OF to create a partition.")));
+		else if (OidIsValid(get_partition_parent(parentOid)))
+			ereport(ERROR,
+					(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+					 errmsg("cannot inherit from partition \"%s\"",
+							get_rel_name(parentOid))));
+	}
+
 	/*
 	 * Create a tuple descriptor from the relation schema.  Note that this
 	 * deals with column names, types, and NOT NULL constraints, but not
@@ -673,7 +736,57 @@ DefineRelation(CreateStmt *stmt, char relkind, Oid ownerId,
 										  typaddress);
 
 	/* Store inheritance information for new rel. */
-	StoreCatalogInheritance(relationId, inheritOids);
+	StoreCatalogInheritance(relationId, inheritOids, stmt->partbound != NULL);
+
+	/*
+	 * Record the partition key of a partitioned table.  It consists of a
+	 * single column, compared using its type's default btree operator class.
+	 */
+	if (stmt->partspec)
+	{
+		char	   *colname = stmt->partspec->colname;
+		Form_pg_attribute attr = NULL;
+		Oid			opclass;
+		int			i;
+
+		for (i = 0; i < descriptor->natts; i++)
+		{
+			if (strcmp(NameStr(descriptor->attrs[i]->attname), colname) == 0)
+			{
+				attr = descriptor->attrs[i];
+				break;
+			}
+		}
+		if (attr == NULL)
+			ereport(ERROR,
+					(errcode(ERRCODE_UNDEFINED_COLUMN),
+					 errmsg("column \"%s\" named in partition key does not exist",
+							colname)));
+
+		opclass = GetDefaultOpClass(attr->atttypid, BTREE_AM_OID);
+		if (!OidIsValid(opclass))
+			ereport(ERROR,
+					(errcode(ERRCODE_UNDEFINED_OBJECT),
+					 errmsg("data type %s has no default btree operator class",
+							format_type_be(attr->atttypid)),
+					 errhint("A partition key column must be of a type that can be sorted.")));
+
+		StorePartitionKey(relationId, partstrategy, attr->attnum, opclass,
+						  attr->attcollation);
+	}
+
+	/*
+	 * Record a new partition's bound, after making sure it's disjoint from
+	 * those of the other partitions.
+	 */
+	if (stmt->partbound)
+	{
+		Assert(parent != NULL);
+		check_new_partition_bound(relname, parent, stmt->partbound);
+		StorePartitionBound(relationId, RelationGetRelid(parent),
+							stmt->partbound);
+		heap_close(parent, NoLock);
+	}
 
 	/*
 	 * We must bump the command counter to make the newly-created relation
@@ -977,6 +1090,18 @@ RangeVarCallbackForDropRelation(const RangeVar *rel, Oid relOid, Oid oldRelOid,
 		if (OidIsValid(state->heapOid))
 			LockRelationOid(state->heapOid, heap_lockmode);
 	}
+
+	/*
+	 * Similarly, in DROP TABLE of a partition, lock the partitioned table
+	 * first: dropping the partition changes the parent's partitions, and
+	 * queries lock the parent before its partitions.
+	 */
+	if (relkind == RELKIND_RELATION && relOid != oldRelOid)
+	{
+		state->heapOid = get_partition_parent(relOid);
+		if (OidIsValid(state->heapOid))
+			LockRelationOid(state->heapOid, heap_lockmode);
+	}
 }
 
 /*
@@ -1959,9 +2084,12 @@ MergeCheckConstraint(List *constraints, char *name, Node *expr)
  *		Updates the system catalogs with proper inheritance information.
  *
  * supers is a list of the OIDs of the new relation's direct ancestors.
+ * child_is_partition is true if the new relation is a partition of its
+ * (single) parent.
  */
 static void
-StoreCatalogInheritance(Oid relationId, List *supers)
+StoreCatalogInheritance(Oid relationId, List *supers,
+						bool child_is_partition)
 {
 	Relation	relation;
 	int16		seqNumber;
@@ -1991,7 +2119,8 @@ StoreCatalogInheritance(Oid relationId, List *supers)
 	{
 		Oid			parentOid = lfirst_oid(entry);
 
-		StoreCatalogInheritance1(relationId, parentOid, seqNumber, relation);
+		StoreCatalogInheritance1(relationId, parentOid, seqNumber, relation,
+								 child_is_partition);
 		seqNumber++;
 	}
 
@@ -2001,10 +2130,14 @@ StoreCatalogInheritance(Oid relationId, List *supers)
 /*
  * Make catalog entries showing relationId as being an inheritance child
  * of parentOid.  inhRelation is the already-opened pg_inherits catalog.
+ *
+ * A partition goes away with its parent, so it depends on it automatically
+ * rather than normally.
  */
 static void
 StoreCatalogInheritance1(Oid relationId, Oid parentOid,
-						 int16 seqNumber, Relation inhRelation)
+						 int16 seqNumber, Relation inhRelation,
+						 bool child_is_partition)
 {
 	TupleDesc	desc = RelationGetDescr(inhRelation);
 	Datum		values[Natts_pg_inherits];
@@ -2040,7 +2173,8 @@ StoreCatalogInheritance1(Oid relationId, Oid parentOid,
 	childobject.objectId = relationId;
 	childobject.objectSubId = 0;
 
-	recordDependencyOn(&childobject, &parentobject, DEPENDENCY_NORMAL);
+	recordDependencyOn(&childobject, &parentobject,
+					   child_is_partition ? DEPENDENCY_AUTO : DEPENDENCY_NORMAL);
 
 	/*
 	 * Post creation hook of this inheritance. Since object_access_hook
@@ -5696,6 +5830,14 @@ ATExecDropColumn(List **wqueue, Relation rel, const char *colName,
 				 errmsg("cannot drop inherited column \"%s\"",
 						colName)));
 
+	/* Nor the partition key */
+	if (RelationGetPartitionKey(rel) != NULL &&
+		RelationGetPartitionKey(rel)->partattr == attnum)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+				 errmsg("cannot drop column \"%s\" named in partition key",
+						colName)));
+
 	ReleaseSysCache(tuple);
 
 	/*
@@ -7117,7 +7259,7 @@ transformFkeyCheckAttrs(Relation pkrel,
 		 * partial index; forget it if there are any expressions, too. Invalid
 		 * indexes are out as well.
 		 */
-		if (indexStruct->indnatts == numattrs &&
+		if (indexStruct->indnkeyatts == numattrs &&
 			indexStruct->indisunique &&
 			IndexIsValid(indexStruct) &&
 			heap_attisnull(indexTuple, Anum_pg_index_indpred) &&
@@ -7847,6 +7989,14 @@ ATPrepAlterColumnType(List **wqueue,
 				 errmsg("cannot alter inherited column \"%s\"",
 						colName)));
 
+	/* Partition bounds are stored as values of the key column's type */
+	if (RelationGetPartitionKey(rel) != NULL &&
+		RelationGetPartitionKey(rel)->partattr == attnum)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+				 errmsg("cannot alter type of column \"%s\" named in partition key",
+						colName)));
+
 	/* Look up the target type */
 	typenameTypeIdAndMod(NULL, typeName, &targettype, &targettypmod);
 
@@ -9916,6 +10066,28 @@ ATExecAddInherit(Relation child_rel, RangeVar *parent, LOCKMODE lockmode)
 				(errcode(ERRCODE_WRONG_OBJECT_TYPE),
 		 errmsg("cannot inherit to temporary relation of another session")));
 
+	/*
+	 * Partitions are only made by CREATE TABLE ... PARTITION OF, and
+	 * partitioned tables and partitions don't take part in plain
+	 * inheritance.
+	 */
+	if (RelationGetPartitionKey(parent_rel) != NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+				 errmsg("cannot inherit from partitioned table \"%s\"",
+						RelationGetRelationName(parent_rel))));
+	if (OidIsValid(get_partition_parent(RelationGetRelid(parent_rel))))
+		ereport(ERROR,
+				(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+				 errmsg("cannot inherit from partition \"%s\"",
+						RelationGetRelationName(parent_rel))));
+	if (RelationGetPartitionKey(child_rel) != NULL ||
+		OidIsValid(get_partition_parent(RelationGetRelid(child_rel))))
+		ereport(ERROR,
+				(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+				 errmsg("cannot change inheritance of partitioned table or partition \"%s\"",
+						RelationGetRelationName(child_rel))));
+
 	/*
 	 * Check for duplicates in the list of parents, and determine the highest
 	 * inhseqno already present; we'll use the next one for the new parent.
@@ -9993,7 +10165,8 @@ ATExecAddInherit(Relation child_rel, RangeVar *parent, LOCKMODE lockmode)
 	StoreCatalogInheritance1(RelationGetRelid(child_rel),
 							 RelationGetRelid(parent_rel),
 							 inhseqno + 1,
-							 catalogRelation);
+							 catalogRelation,
+							 false);
 
 	ObjectAddressSet(address, RelationRelationId,
 					 RelationGetRelid(parent_rel));
@@ -10302,6 +10475,12 @@ ATExecDropInherit(Relation rel, RangeVar *parent, LOCKMODE lockmode)
 	 * the child is presumed enough rights.
 	 */
 
+	if (OidIsValid(get_partition_parent(RelationGetRelid(rel))))
+		ereport(ERROR,
+				(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+				 errmsg("cannot change inheritance of partition \"%s\"",
+						RelationGetRelationName(rel))));
+
 	/*
 	 * Find and destroy the pg_inherits entry linking the two, or error out if
 	 * there is none.
@@ -10893,7 +11072,7 @@ ATExecReplicaIdentity(Relation rel, ReplicaIdentityStmt *stmt, LOCKMODE lockmode
 						RelationGetRelationName(indexRel))));
 
 	/* Check index for nullable columns. */
-	for (key = 0; key < indexRel->rd_index->indnatts; key++)
+	for (key = 0; key < indexRel->rd_index->indnkeyatts; key++)
 	{
 		int16		attno = indexRel->rd_index->indkey.values[key];
 		Form_pg_attribute attr;
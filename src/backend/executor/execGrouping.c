@@ -458,6 +458,49 @@ FindTupleHashEntry(TupleHashTable hashtable, TupleTableSlot *slot,
 	return entry;
 }
 
+/*
+ * Remove the hashtable entry matching the given tuple, which must be the
+ * same type as the hashtable entries, and return it, or NULL if there is
+ * none.  The returned entry's storage is recycled by the next insertion;
+ * freeing its firstTuple and any other data it points to is up to the
+ * caller.
+ */
+TupleHashEntry
+RemoveTupleHashEntry(TupleHashTable hashtable, TupleTableSlot *slot)
+{
+	TupleHashEntry entry;
+	MemoryContext oldContext;
+	TupleHashTable saveCurHT;
+	TupleHashEntryData dummy;
+
+	/* Nothing can match if nothing was ever entered */
+	if (hashtable->tableslot == NULL)
+		return NULL;
+
+	/* Need to run the hash functions in short-lived context */
+	oldContext = MemoryContextSwitchTo(hashtable->tempcxt);
+
+	/* Set up data needed by hash and match functions, as above */
+	hashtable->inputslot = slot;
+	hashtable->in_hash_funcs = hashtable->tab_hash_funcs;
+	hashtable->cur_eq_funcs = hashtable->tab_eq_funcs;
+
+	saveCurHT = CurTupleHashTable;
+	CurTupleHashTable = hashtable;
+
+	dummy.firstTuple = NULL;	/* flag to reference inputslot */
+	entry = (TupleHashEntry) hash_search(hashtable->hashtab,
+										 &dummy,
+										 HASH_REMOVE,
+										 NULL);
+
+	CurTupleHashTable = saveCurHT;
+
+	MemoryContextSwitchTo(oldContext);
+
+	return entry;
+}
+
 /*
  * Compute the hash value for a tuple
  *
@@ -38,10 +38,12 @@
 #include "postgres.h"
 
 #include "access/htup_details.h"
+#include "access/tupconvert.h"
 #include "access/sysattr.h"
 #include "access/transam.h"
 #include "access/xact.h"
 #include "catalog/namespace.h"
+#include "catalog/partition.h"
 #include "commands/matview.h"
 #include "commands/trigger.h"
 #include "executor/execdebug.h"
@@ -86,6 +88,10 @@ static bool ExecCheckRTEPermsModified(Oid relOid, Oid userid,
 						  Bitmapset *modifiedCols,
 						  AclMode requiredPerms);
 static void ExecCheckXactReadOnly(PlannedStmt *plannedstmt);
+static bool ExecPartitionCheck(ResultRelInfo *resultRelInfo,
+				   TupleTableSlot *slot, EState *estate);
+static ResultRelInfo *ExecOpenPartition(Relation root,
+				  ResultRelInfo *parentInfo, int partidx, EState *estate);
 static char *ExecBuildSlotValueDescription(Oid reloid,
 							  TupleTableSlot *slot,
 							  TupleDesc tupdesc,
@@ -1246,6 +1252,12 @@ InitResultRelInfo(ResultRelInfo *resultRelInfo,
 	resultRelInfo->ri_ConstraintExprs = NULL;
 	resultRelInfo->ri_junkFilter = NULL;
 	resultRelInfo->ri_projectReturning = NULL;
+	resultRelInfo->ri_PartitionRouting = NULL;
+	/* copy, as for the trigger descriptor */
+	resultRelInfo->ri_PartitionCheck =
+		(List *) copyObject(RelationGetPartitionQual(resultRelationDesc));
+	resultRelInfo->ri_PartitionCheckExpr = NIL;
+	resultRelInfo->ri_PartitionRootMap = NULL;
 }
 
 /*
@@ -1668,9 +1680,9 @@ ExecConstraints(ResultRelInfo *resultRelInfo,
 	Bitmapset  *insertedCols;
 	Bitmapset  *updatedCols;
 
-	Assert(constr);
+	Assert(constr || resultRelInfo->ri_PartitionCheck);
 
-	if (constr->has_not_null)
+	if (constr && constr->has_not_null)
 	{
 		int			natts = tupdesc->natts;
 		int			attrChk;
@@ -1701,7 +1713,7 @@ ExecConstraints(ResultRelInfo *resultRelInfo,
 		}
 	}
 
-	if (constr->num_check > 0)
+	if (constr && constr->num_check > 0)
 	{
 		const char *failed;
 
@@ -1725,6 +1737,217 @@ ExecConstraints(ResultRelInfo *resultRelInfo,
 					 errtableconstraint(rel, failed)));
 		}
 	}
+
+	if (resultRelInfo->ri_PartitionCheck &&
+		!ExecPartitionCheck(resultRelInfo, slot, estate))
+	{
+		char	   *val_desc;
+
+		insertedCols = GetInsertedColumns(resultRelInfo, estate);
+		updatedCols = GetUpdatedColumns(resultRelInfo, estate);
+		modifiedCols = bms_union(insertedCols, updatedCols);
+		val_desc = ExecBuildSlotValueDescription(RelationGetRelid(rel),
+												 slot,
+												 tupdesc,
+												 modifiedCols,
+												 64);
+		ereport(ERROR,
+				(errcode(ERRCODE_CHECK_VIOLATION),
+				 errmsg("new row for relation \"%s\" violates partition constraint",
+						RelationGetRelationName(rel)),
+			  val_desc ? errdetail("Failing row contains %s.", val_desc) : 0,
+				 errtable(rel)));
+	}
+}
+
+/*
+ * Check that a tuple satisfies the bound of the partition it's stored in.
+ */
+static bool
+ExecPartitionCheck(ResultRelInfo *resultRelInfo, TupleTableSlot *slot,
+				   EState *estate)
+{
+	ExprContext *econtext;
+
+	/* Prepare the expression tree if we haven't done so yet */
+	if (resultRelInfo->ri_PartitionCheckExpr == NIL)
+	{
+		MemoryContext oldcxt = MemoryContextSwitchTo(estate->es_query_cxt);
+
+		resultRelInfo->ri_PartitionCheckExpr = (List *)
+			ExecPrepareExpr((Expr *) resultRelInfo->ri_PartitionCheck, estate);
+		MemoryContextSwitchTo(oldcxt);
+	}
+
+	econtext = GetPerTupleExprContext(estate);
+	econtext->ecxt_scantuple = slot;
+
+	/*
+	 * Unlike for CHECK constraints, a NULL result means failure: a row with
+	 * a null key doesn't belong in any partition.
+	 */
+	return ExecQual(resultRelInfo->ri_PartitionCheckExpr, econtext, false);
+}
+
+/*
+ * ExecSetupPartitionRouting -- prepare for inserting tuples into a
+ * partitioned table, by routing each to the partition that accepts it
+ */
+void
+ExecSetupPartitionRouting(ResultRelInfo *resultRelInfo, EState *estate)
+{
+	Relation	rel = resultRelInfo->ri_RelationDesc;
+	PartitionDesc pdesc = RelationGetPartitionDesc(rel);
+	PartitionRoutingState *proute;
+	MemoryContext oldcxt;
+
+	Assert(pdesc != NULL);
+
+	oldcxt = MemoryContextSwitchTo(estate->es_query_cxt);
+
+	proute = (PartitionRoutingState *) palloc0(sizeof(PartitionRoutingState));
+	proute->nparts = pdesc->nparts;
+	proute->partoids = (Oid *) palloc(pdesc->nparts * sizeof(Oid));
+	memcpy(proute->partoids, pdesc->oids, pdesc->nparts * sizeof(Oid));
+	proute->partrels = (ResultRelInfo **)
+		palloc0(pdesc->nparts * sizeof(ResultRelInfo *));
+	proute->partmaps = (TupleConversionMap **)
+		palloc0(pdesc->nparts * sizeof(TupleConversionMap *));
+	proute->partslots = (TupleTableSlot **)
+		palloc0(pdesc->nparts * sizeof(TupleTableSlot *));
+	proute->rootslot = ExecInitExtraTupleSlot(estate);
+	ExecSetSlotDescriptor(proute->rootslot, RelationGetDescr(rel));
+
+	resultRelInfo->ri_PartitionRouting = proute;
+
+	MemoryContextSwitchTo(oldcxt);
+}
+
+/*
+ * ExecFindPartition -- find the partition a tuple inserted into a
+ * partitioned table is to be stored in
+ *
+ * The partition is looked up by binary search over the partition bounds,
+ * descending through partitions that are partitioned themselves.  Returns
+ * the partition's ResultRelInfo, and replaces *slot with one holding the
+ * tuple in the partition's rowtype if that differs.
+ */
+ResultRelInfo *
+ExecFindPartition(ResultRelInfo *resultRelInfo, TupleTableSlot **slot,
+				  EState *estate)
+{
+	Relation	root = resultRelInfo->ri_RelationDesc;
+
+	while (resultRelInfo->ri_PartitionRouting != NULL)
+	{
+		PartitionRoutingState *proute = resultRelInfo->ri_PartitionRouting;
+		Relation	rel = resultRelInfo->ri_RelationDesc;
+		Datum		value;
+		bool		isnull;
+		int			partidx;
+
+		value = slot_getattr(*slot, RelationGetPartitionKey(rel)->partattr,
+							 &isnull);
+		partidx = get_partition_for_value(rel, value, isnull);
+		if (partidx < 0)
+		{
+			char	   *val_desc;
+			Bitmapset  *insertedCols;
+
+			insertedCols = GetInsertedColumns(resultRelInfo, estate);
+			val_desc = ExecBuildSlotValueDescription(RelationGetRelid(rel),
+													 *slot,
+													 RelationGetDescr(rel),
+													 insertedCols,
+													 64);
+			ereport(ERROR,
+					(errcode(ERRCODE_CHECK_VIOLATION),
+					 errmsg("no partition of relation \"%s\" found for row",
+							RelationGetRelationName(rel)),
+			  val_desc ? errdetail("Failing row contains %s.", val_desc) : 0,
+					 errtable(rel)));
+		}
+
+		if (proute->partrels[partidx] == NULL)
+			ExecOpenPartition(root, resultRelInfo, partidx, estate);
+
+		if (proute->partmaps[partidx] != NULL)
+		{
+			HeapTuple	tuple;
+
+			tuple = do_convert_tuple(ExecMaterializeSlot(*slot),
+									 proute->partmaps[partidx]);
+			*slot = proute->partslots[partidx];
+			ExecStoreTuple(tuple, *slot, InvalidBuffer, true);
+		}
+
+		resultRelInfo = proute->partrels[partidx];
+	}
+
+	return resultRelInfo;
+}
+
+/*
+ * Open a partition of parentInfo's relation for routing tuples inserted into
+ * root (parentInfo's relation or an ancestor of it) to it.
+ */
+static ResultRelInfo *
+ExecOpenPartition(Relation root, ResultRelInfo *parentInfo, int partidx,
+				  EState *estate)
+{
+	PartitionRoutingState *proute = parentInfo->ri_PartitionRouting;
+	Relation	partrel;
+	ResultRelInfo *partInfo;
+	MemoryContext oldcxt;
+
+	/* The planner didn't lock the partitions of an INSERT target */
+	partrel = heap_open(proute->partoids[partidx], RowExclusiveLock);
+
+	oldcxt = MemoryContextSwitchTo(estate->es_query_cxt);
+
+	partInfo = makeNode(ResultRelInfo);
+	InitResultRelInfo(partInfo,
+					  partrel,
+					  parentInfo->ri_RangeTableIndex,
+					  estate->es_instrument);
+
+	/* Routed tuples satisfy the partition's bound by construction */
+	partInfo->ri_PartitionCheck = NIL;
+
+	if (partrel->rd_rel->relhasindex)
+		ExecOpenIndices(partInfo, false);
+
+	if (RelationGetPartitionKey(partrel) != NULL)
+		ExecSetupPartitionRouting(partInfo, estate);
+
+	proute->partmaps[partidx] =
+		convert_tuples_by_name(RelationGetDescr(parentInfo->ri_RelationDesc),
+							   RelationGetDescr(partrel),
+							   gettext_noop("could not convert row type"));
+	if (proute->partmaps[partidx] != NULL)
+	{
+		proute->partslots[partidx] = ExecInitExtraTupleSlot(estate);
+		ExecSetSlotDescriptor(proute->partslots[partidx],
+							  RelationGetDescr(partrel));
+	}
+	partInfo->ri_PartitionRootMap =
+		convert_tuples_by_name(RelationGetDescr(partrel),
+							   RelationGetDescr(root),
+							   gettext_noop("could not convert row type"));
+
+	/*
+	 * Make the partition known as a trigger target, so that its AFTER
+	 * trigger events find this ResultRelInfo, and so that it's closed along
+	 * with the other trigger target relations.
+	 */
+	estate->es_trig_target_relations =
+		lappend(estate->es_trig_target_relations, partInfo);
+
+	proute->partrels[partidx] = partInfo;
+
+	MemoryContextSwitchTo(oldcxt);
+
+	return partInfo;
 }
 
 /*
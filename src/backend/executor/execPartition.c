@@ -0,0 +1,310 @@
+/*-------------------------------------------------------------------------
+ *
+ * execPartition.c
+ *	  Run-time partition pruning for Append and MergeAppend nodes.
+ *
+ * The planner prunes the partitions of a partitioned table that the query's
+ * restrictions on its partition key rule out, as far as those restrictions
+ * reduce to constants at plan time.  Restrictions comparing the key with
+ * Params or stable expressions are instead attached to the Append or
+ * MergeAppend node scanning the table, as a PartitionPruneInfo, and
+ * evaluated here to skip the subplans that can't produce any rows.
+ *
+ * Restrictions that don't depend on PARAM_EXEC params, such as those using
+ * the parameters of a generic plan, are evaluated once at executor startup,
+ * and the subplans they rule out are never initialized.  The others, which
+ * use nestloop or initplan params, have to wait until the node is run, and
+ * are evaluated again each time the node is rescanned.
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *	  src/backend/executor/execPartition.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/nbtree.h"
+#include "catalog/partition.h"
+#include "executor/executor.h"
+#include "nodes/nodeFuncs.h"
+#include "utils/array.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+
+
+static bool contain_exec_param_walker(Node *node, void *context);
+static int *map_subplans_to_partitions(Relation partrel, List *subpartoids);
+
+
+/*
+ * ExecInitPartitionPrune
+ *		Set up run-time partition pruning for the Append or MergeAppend
+ *		node 'planstate', as described by 'pinfo'.
+ *
+ * The caller must have given the node an expression context.
+ */
+PartitionPruneState *
+ExecInitPartitionPrune(PlanState *planstate, PartitionPruneInfo *pinfo)
+{
+	PartitionPruneState *prunestate;
+	ListCell   *lc;
+	ListCell   *lc2;
+	int			i;
+
+	Assert(planstate->ps_ExprContext != NULL);
+
+	prunestate = (PartitionPruneState *) palloc0(sizeof(PartitionPruneState));
+
+	/* The planner already locked the partitioned table */
+	prunestate->pp_partrel = relation_open(pinfo->reloid, NoLock);
+	prunestate->pp_nsubplans = list_length(pinfo->subpartoids);
+	prunestate->pp_subpartidx =
+		map_subplans_to_partitions(prunestate->pp_partrel,
+								   pinfo->subpartoids);
+
+	prunestate->pp_nvalues = list_length(pinfo->values);
+	prunestate->pp_strategies = (StrategyNumber *)
+		palloc(prunestate->pp_nvalues * sizeof(StrategyNumber));
+	prunestate->pp_values = (ExprState **)
+		palloc(prunestate->pp_nvalues * sizeof(ExprState *));
+	prunestate->pp_value_isexec = (bool *)
+		palloc(prunestate->pp_nvalues * sizeof(bool));
+	i = 0;
+	forboth(lc, pinfo->strategies, lc2, pinfo->values)
+	{
+		Expr	   *value = (Expr *) lfirst(lc2);
+
+		prunestate->pp_strategies[i] = (StrategyNumber) lfirst_int(lc);
+		prunestate->pp_values[i] = ExecInitExpr(value, planstate);
+		prunestate->pp_value_isexec[i] =
+			contain_exec_param_walker((Node *) value, NULL);
+		if (prunestate->pp_value_isexec[i])
+			prunestate->pp_has_exec = true;
+		i++;
+	}
+
+	prunestate->pp_narrays = list_length(pinfo->arrayvalues);
+	prunestate->pp_arrays = (ExprState **)
+		palloc(prunestate->pp_narrays * sizeof(ExprState *));
+	prunestate->pp_array_isexec = (bool *)
+		palloc(prunestate->pp_narrays * sizeof(bool));
+	i = 0;
+	foreach(lc, pinfo->arrayvalues)
+	{
+		Expr	   *array = (Expr *) lfirst(lc);
+
+		prunestate->pp_arrays[i] = ExecInitExpr(array, planstate);
+		prunestate->pp_array_isexec[i] =
+			contain_exec_param_walker((Node *) array, NULL);
+		if (prunestate->pp_array_isexec[i])
+			prunestate->pp_has_exec = true;
+		i++;
+	}
+
+	prunestate->pp_econtext = planstate->ps_ExprContext;
+
+	return prunestate;
+}
+
+/*
+ * ExecFindValidSubplans
+ *		Return the set of indexes of the subplans that the pruning
+ *		restrictions don't rule out.
+ *
+ * If 'initial' is true, we're being called at executor startup, and only
+ * the restrictions that don't depend on PARAM_EXEC params are used.
+ */
+Bitmapset *
+ExecFindValidSubplans(PartitionPruneState *prunestate, bool initial)
+{
+	ExprContext *econtext = prunestate->pp_econtext;
+	Relation	partrel = prunestate->pp_partrel;
+	MemoryContext oldcontext;
+	PartitionPruneClause *clauses;
+	int			nclauses = 0;
+	Bitmapset  *parts;
+	Bitmapset  *result = NULL;
+	bool		prune_all = false;
+	int			i;
+
+	/* Do the work in the per-tuple context, so that we needn't clean up */
+	oldcontext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+
+	clauses = (PartitionPruneClause *)
+		palloc(Max(prunestate->pp_nvalues, 1) * sizeof(PartitionPruneClause));
+
+	for (i = 0; i < prunestate->pp_nvalues; i++)
+	{
+		bool		isnull;
+
+		if (initial && prunestate->pp_value_isexec[i])
+			continue;
+
+		clauses[nclauses].strategy = prunestate->pp_strategies[i];
+		clauses[nclauses].value = ExecEvalExpr(prunestate->pp_values[i],
+											   econtext, &isnull, NULL);
+		/* The operators are strict, so the key can't match a null */
+		if (isnull)
+		{
+			prune_all = true;
+			break;
+		}
+		nclauses++;
+	}
+
+	parts = NULL;
+	if (!prune_all)
+		parts = get_partitions_for_clauses(partrel, clauses, nclauses);
+
+	for (i = 0; i < prunestate->pp_narrays && !bms_is_empty(parts); i++)
+	{
+		ArrayType  *arr;
+		Datum		arrdatum;
+		bool		isnull;
+		int16		elmlen;
+		bool		elmbyval;
+		char		elmalign;
+		Datum	   *elems;
+		bool	   *elemnulls;
+		int			nelems;
+		Bitmapset  *these_parts = NULL;
+		int			j;
+
+		if (initial && prunestate->pp_array_isexec[i])
+			continue;
+
+		arrdatum = ExecEvalExpr(prunestate->pp_arrays[i], econtext,
+								&isnull, NULL);
+		if (isnull)
+		{
+			parts = NULL;
+			break;
+		}
+
+		arr = DatumGetArrayTypeP(arrdatum);
+		get_typlenbyvalalign(ARR_ELEMTYPE(arr),
+							 &elmlen, &elmbyval, &elmalign);
+		deconstruct_array(arr, ARR_ELEMTYPE(arr),
+						  elmlen, elmbyval, elmalign,
+						  &elems, &elemnulls, &nelems);
+		for (j = 0; j < nelems; j++)
+		{
+			PartitionPruneClause pc;
+
+			/* "key = NULL" is never true */
+			if (elemnulls[j])
+				continue;
+			pc.strategy = BTEqualStrategyNumber;
+			pc.value = elems[j];
+			these_parts = bms_add_members(these_parts,
+									get_partitions_for_clauses(partrel,
+															   &pc, 1));
+		}
+		parts = bms_int_members(parts, these_parts);
+	}
+
+	MemoryContextSwitchTo(oldcontext);
+
+	for (i = 0; i < prunestate->pp_nsubplans; i++)
+	{
+		int			partidx = prunestate->pp_subpartidx[i];
+
+		if (partidx < 0 || bms_is_member(partidx, parts))
+			result = bms_add_member(result, i);
+	}
+
+	ResetExprContext(econtext);
+
+	return result;
+}
+
+/*
+ * ExecKeepValidSubplans
+ *		Forget about the subplans not in 'validsubplans', after the caller
+ *		decided not to initialize them, so that subplan indexes passed to
+ *		and returned by ExecFindValidSubplans count only the rest.
+ */
+void
+ExecKeepValidSubplans(PartitionPruneState *prunestate,
+					  Bitmapset *validsubplans)
+{
+	int			nsubplans = 0;
+	int			i;
+
+	i = -1;
+	while ((i = bms_next_member(validsubplans, i)) >= 0)
+		prunestate->pp_subpartidx[nsubplans++] = prunestate->pp_subpartidx[i];
+	prunestate->pp_nsubplans = nsubplans;
+}
+
+/*
+ * ExecEndPartitionPrune
+ *		Release the resources of run-time partition pruning.
+ */
+void
+ExecEndPartitionPrune(PartitionPruneState *prunestate)
+{
+	relation_close(prunestate->pp_partrel, NoLock);
+}
+
+/*
+ * Does the expression reference any PARAM_EXEC params?
+ */
+static bool
+contain_exec_param_walker(Node *node, void *context)
+{
+	if (node == NULL)
+		return false;
+	if (IsA(node, Param))
+		return ((Param *) node)->paramkind == PARAM_EXEC;
+	return expression_tree_walker(node, contain_exec_param_walker, context);
+}
+
+/*
+ * map_subplans_to_partitions
+ *		Translate the per-subplan partition OIDs of a PartitionPruneInfo into
+ *		PartitionDesc indexes, or -1 for subplans not belonging to any
+ *		partition.
+ *
+ * The planner emits the subplans in partition bound order, which is the
+ * order of the PartitionDesc, so we look for each OID starting just past
+ * the previous one found, wrapping around if need be.
+ */
+static int *
+map_subplans_to_partitions(Relation partrel, List *subpartoids)
+{
+	PartitionDesc pdesc = RelationGetPartitionDesc(partrel);
+	int		   *subpartidx;
+	int			next = 0;
+	int			i;
+	ListCell   *lc;
+
+	subpartidx = (int *) palloc(Max(list_length(subpartoids), 1) * sizeof(int));
+
+	i = 0;
+	foreach(lc, subpartoids)
+	{
+		Oid			partoid = lfirst_oid(lc);
+		int			j;
+		int			k;
+
+		subpartidx[i] = -1;
+		for (k = 0; OidIsValid(partoid) && k < pdesc->nparts; k++)
+		{
+			j = (next + k) % pdesc->nparts;
+			if (pdesc->oids[j] == partoid)
+			{
+				subpartidx[i] = j;
+				next = j;
+				break;
+			}
+		}
+		i++;
+	}
+
+	return subpartidx;
+}
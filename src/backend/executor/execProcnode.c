@@ -96,6 +96,7 @@
 #include "executor/nodeLimit.h"
 #include "executor/nodeLockRows.h"
 #include "executor/nodeMaterial.h"
+#include "executor/nodeMemoize.h"
 #include "executor/nodeMergeAppend.h"
 #include "executor/nodeMergejoin.h"
 #include "executor/nodeModifyTable.h"
@@ -282,6 +283,11 @@ ExecInitNode(Plan *node, EState *estate, int eflags)
 													estate, eflags);
 			break;
 
+		case T_Memoize:
+			result = (PlanState *) ExecInitMemoize((Memoize *) node,
+												   estate, eflags);
+			break;
+
 		case T_Sort:
 			result = (PlanState *) ExecInitSort((Sort *) node,
 												estate, eflags);
@@ -484,6 +490,10 @@ ExecProcNode(PlanState *node)
 			result = ExecMaterial((MaterialState *) node);
 			break;
 
+		case T_MemoizeState:
+			result = ExecMemoize((MemoizeState *) node);
+			break;
+
 		case T_SortState:
 			result = ExecSort((SortState *) node);
 			break;
@@ -728,6 +738,10 @@ ExecEndNode(PlanState *node)
 			ExecEndMaterial((MaterialState *) node);
 			break;
 
+		case T_MemoizeState:
+			ExecEndMemoize((MemoizeState *) node);
+			break;
+
 		case T_SortState:
 			ExecEndSort((SortState *) node);
 			break;
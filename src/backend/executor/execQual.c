@@ -53,12 +53,22 @@
 #include "pgstat.h"
 #include "utils/acl.h"
 #include "utils/builtins.h"
+#include "utils/dynahash.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/typcache.h"
 #include "utils/xml.h"
 
 
+/*
+ * Constant arrays with at least this many elements are searched by means of
+ * a hash table in "scalar op ANY/ALL (array)", when the operator allows it.
+ * Below that, a linear search is cheap enough that building the hash table
+ * doesn't pay off.
+ */
+#define MIN_ARRAY_SIZE_FOR_HASHED_SAOP	9
+
+
 /* static function decls */
 static Datum ExecEvalArrayRef(ArrayRefExprState *astate,
 				 ExprContext *econtext,
@@ -118,6 +128,13 @@ static Datum ExecEvalDistinct(FuncExprState *fcache, ExprContext *econtext,
 static Datum ExecEvalScalarArrayOp(ScalarArrayOpExprState *sstate,
 					  ExprContext *econtext,
 					  bool *isNull, ExprDoneCond *isDone);
+static bool ExecInitHashedScalarArrayOp(ScalarArrayOpExprState *sstate,
+							ScalarArrayOpExpr *opexpr);
+static void build_saop_hash_table(ScalarArrayOpExprState *sstate,
+					  Datum arraydatum, ExprContext *econtext);
+static Datum ExecEvalHashedScalarArrayOp(ScalarArrayOpExprState *sstate,
+							ExprContext *econtext,
+							bool *isNull, ExprDoneCond *isDone);
 static Datum ExecEvalNot(BoolExprState *notclause, ExprContext *econtext,
 			bool *isNull, ExprDoneCond *isDone);
 static Datum ExecEvalOr(BoolExprState *orExpr, ExprContext *econtext,
@@ -2697,6 +2714,240 @@ ExecEvalScalarArrayOp(ScalarArrayOpExprState *sstate,
 	return result;
 }
 
+/*
+ * ExecInitHashedScalarArrayOp
+ *
+ * Check whether "scalar op ANY/ALL (array)" can be evaluated by probing a
+ * hash table of the array elements, and if so look up the functions needed
+ * for that.  The array must be a non-null constant with enough elements.
+ * For ANY, the operator must be a hashable equality; for ALL, it must have
+ * a hashable equality as its negator, since "x <> ALL (array)" is the same
+ * as "NOT (x = ANY (array))".  Both the operator and the equality must be
+ * strict, so that a NULL scalar or element can't yield anything but NULL.
+ */
+static bool
+ExecInitHashedScalarArrayOp(ScalarArrayOpExprState *sstate,
+							ScalarArrayOpExpr *opexpr)
+{
+	Const	   *arrayconst;
+	ArrayType  *arr;
+	Oid			eq_opr;
+	Oid			rhs_eq_opr;
+	RegProcedure lhs_hashfn;
+	RegProcedure rhs_hashfn;
+
+	Assert(list_length(opexpr->args) == 2);
+	arrayconst = (Const *) lsecond(opexpr->args);
+	if (!IsA(arrayconst, Const) || arrayconst->constisnull)
+		return false;
+
+	arr = DatumGetArrayTypeP(arrayconst->constvalue);
+	if (ArrayGetNItems(ARR_NDIM(arr), ARR_DIMS(arr)) <
+		MIN_ARRAY_SIZE_FOR_HASHED_SAOP)
+		return false;
+
+	if (opexpr->useOr)
+		eq_opr = opexpr->opno;
+	else
+		eq_opr = get_negator(opexpr->opno);
+	if (!OidIsValid(eq_opr))
+		return false;
+
+	if (!get_op_hash_functions(eq_opr, &lhs_hashfn, &rhs_hashfn) ||
+		!get_compatible_hash_operators(eq_opr, NULL, &rhs_eq_opr))
+		return false;
+
+	if (!func_strict(opexpr->opfuncid) || !func_strict(get_opcode(eq_opr)))
+		return false;
+
+	fmgr_info(get_opcode(eq_opr), &sstate->cur_eq_func);
+	fmgr_info_set_expr((Node *) opexpr, &sstate->cur_eq_func);
+	fmgr_info(lhs_hashfn, &sstate->lhs_hash_func);
+	fmgr_info(get_opcode(rhs_eq_opr), &sstate->tab_eq_func);
+	fmgr_info(rhs_hashfn, &sstate->tab_hash_func);
+
+	return true;
+}
+
+/*
+ * build_saop_hash_table
+ *
+ * Load the non-null elements of the array into an open-addressing hash
+ * table in per-query memory, leaving out duplicates, and remember whether
+ * there were any NULLs.  By-reference element values point into the array,
+ * so we keep a detoasted copy of it in per-query memory too; the argument
+ * value may be detoasted into per-tuple memory, which won't last.
+ */
+static void
+build_saop_hash_table(ScalarArrayOpExprState *sstate, Datum arraydatum,
+					  ExprContext *econtext)
+{
+	ScalarArrayOpExpr *opexpr = (ScalarArrayOpExpr *) sstate->fxprstate.xprstate.expr;
+	Oid			collation = opexpr->inputcollid;
+	MemoryContext oldcontext;
+	ArrayType  *arr;
+	Datum	   *elems;
+	bool	   *nulls;
+	int			nelems;
+	uint32		nbuckets;
+	int			i;
+
+	oldcontext = MemoryContextSwitchTo(econtext->ecxt_per_query_memory);
+
+	arr = DatumGetArrayTypePCopy(arraydatum);
+
+	get_typlenbyvalalign(ARR_ELEMTYPE(arr),
+						 &sstate->typlen,
+						 &sstate->typbyval,
+						 &sstate->typalign);
+	sstate->element_type = ARR_ELEMTYPE(arr);
+
+	deconstruct_array(arr, sstate->element_type,
+					  sstate->typlen, sstate->typbyval, sstate->typalign,
+					  &elems, &nulls, &nelems);
+
+	/* Keep the table at most half full */
+	nbuckets = (uint32) 1 << my_log2((long) nelems * 2);
+	sstate->hash_mask = nbuckets - 1;
+	sstate->hash_elems = (Datum *) palloc(nbuckets * sizeof(Datum));
+	sstate->hash_codes = (uint32 *) palloc(nbuckets * sizeof(uint32));
+	sstate->hash_used = (bool *) palloc0(nbuckets * sizeof(bool));
+
+	sstate->has_nulls = false;
+	for (i = 0; i < nelems; i++)
+	{
+		uint32		hashcode;
+		uint32		bucket;
+
+		if (nulls[i])
+		{
+			sstate->has_nulls = true;
+			continue;
+		}
+
+		hashcode = DatumGetUInt32(FunctionCall1Coll(&sstate->tab_hash_func,
+													collation,
+													elems[i]));
+		for (bucket = hashcode & sstate->hash_mask;
+			 sstate->hash_used[bucket];
+			 bucket = (bucket + 1) & sstate->hash_mask)
+		{
+			if (sstate->hash_codes[bucket] == hashcode &&
+				DatumGetBool(FunctionCall2Coll(&sstate->tab_eq_func,
+											   collation,
+											   sstate->hash_elems[bucket],
+											   elems[i])))
+				break;
+		}
+		if (sstate->hash_used[bucket])
+			continue;			/* duplicate element */
+
+		sstate->hash_elems[bucket] = elems[i];
+		sstate->hash_codes[bucket] = hashcode;
+		sstate->hash_used[bucket] = true;
+	}
+
+	pfree(elems);
+	pfree(nulls);
+
+	sstate->hash_built = true;
+
+	MemoryContextSwitchTo(oldcontext);
+}
+
+/*
+ * ExecEvalHashedScalarArrayOp
+ *
+ * Evaluate "scalar op ANY/ALL (array)" for a constant array by probing a
+ * hash table of its elements.  This gives the same result as the linear
+ * search in ExecEvalScalarArrayOp: for ANY, TRUE if an element is equal,
+ * else NULL if the array contains NULLs, else FALSE; for ALL, the negation
+ * of that.  As in hashed subplans, we rely on the equality operator never
+ * yielding NULL for non-null inputs, and on its hash functions agreeing
+ * with it.
+ */
+static Datum
+ExecEvalHashedScalarArrayOp(ScalarArrayOpExprState *sstate,
+							ExprContext *econtext,
+							bool *isNull, ExprDoneCond *isDone)
+{
+	ScalarArrayOpExpr *opexpr = (ScalarArrayOpExpr *) sstate->fxprstate.xprstate.expr;
+	bool		useOr = opexpr->useOr;
+	Oid			collation = opexpr->inputcollid;
+	FunctionCallInfo fcinfo;
+	ExprDoneCond argDone;
+	Datum		scalar;
+	uint32		hashcode;
+	uint32		bucket;
+	bool		found;
+
+	/* Set default values for result flags: non-null, not a set result */
+	*isNull = false;
+	if (isDone)
+		*isDone = ExprSingleResult;
+
+	/*
+	 * Initialize function cache if first time through
+	 */
+	if (sstate->fxprstate.func.fn_oid == InvalidOid)
+	{
+		init_fcache(opexpr->opfuncid, opexpr->inputcollid, &sstate->fxprstate,
+					econtext->ecxt_per_query_memory, true);
+		Assert(!sstate->fxprstate.func.fn_retset);
+	}
+
+	/*
+	 * Evaluate arguments
+	 */
+	fcinfo = &sstate->fxprstate.fcinfo_data;
+	argDone = ExecEvalFuncArgs(fcinfo, sstate->fxprstate.args, econtext);
+	if (argDone != ExprSingleResult)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATATYPE_MISMATCH),
+			   errmsg("op ANY/ALL (array) does not support set arguments")));
+	Assert(fcinfo->nargs == 2);
+	Assert(!fcinfo->argnull[1]);
+
+	/* Load the array elements into the hash table if first time through */
+	if (!sstate->hash_built)
+		build_saop_hash_table(sstate, fcinfo->arg[1], econtext);
+
+	/* The operator is strict, and the array is known to be nonempty */
+	if (fcinfo->argnull[0])
+	{
+		*isNull = true;
+		return (Datum) 0;
+	}
+
+	scalar = fcinfo->arg[0];
+	hashcode = DatumGetUInt32(FunctionCall1Coll(&sstate->lhs_hash_func,
+												collation, scalar));
+	found = false;
+	for (bucket = hashcode & sstate->hash_mask;
+		 sstate->hash_used[bucket];
+		 bucket = (bucket + 1) & sstate->hash_mask)
+	{
+		if (sstate->hash_codes[bucket] == hashcode &&
+			DatumGetBool(FunctionCall2Coll(&sstate->cur_eq_func,
+										   collation,
+										   scalar,
+										   sstate->hash_elems[bucket])))
+		{
+			found = true;
+			break;
+		}
+	}
+
+	if (found)
+		return BoolGetDatum(useOr);
+	if (sstate->has_nulls)
+	{
+		*isNull = true;
+		return (Datum) 0;
+	}
+	return BoolGetDatum(!useOr);
+}
+
 /* ----------------------------------------------------------------
  *		ExecEvalNot
  *		ExecEvalOr
@@ -4665,6 +4916,9 @@ ExecInitExpr(Expr *node, PlanState *parent)
 					ExecInitExpr((Expr *) opexpr->args, parent);
 				sstate->fxprstate.func.fn_oid = InvalidOid;		/* not initialized */
 				sstate->element_type = InvalidOid;		/* ditto */
+				sstate->hash_built = false; /* built on first use */
+				if (ExecInitHashedScalarArrayOp(sstate, opexpr))
+					sstate->fxprstate.xprstate.evalfunc = (ExprStateEvalFunc) ExecEvalHashedScalarArrayOp;
 				state = (ExprState *) sstate;
 			}
 			break;
@@ -53,6 +53,11 @@
  *			  nil	nil		 Scan	 Scan	  Scan	   Scan
  *							  |		  |		   |		|
  *							person employee student student-emp
+ *
+ *		When the relations are the partitions of a partitioned table, the
+ *		Append may carry restrictions on the partition key that could not
+ *		be evaluated at plan time, and skips the subplans they rule out;
+ *		see execPartition.c.
  */
 
 #include "postgres.h"
@@ -121,34 +126,72 @@ ExecInitAppend(Append *node, EState *estate, int eflags)
 {
 	AppendState *appendstate = makeNode(AppendState);
 	PlanState **appendplanstates;
+	Bitmapset  *validsubplans = NULL;
 	int			nplans;
 	int			i;
+	int			j;
 	ListCell   *lc;
 
 	/* check for unsupported flags */
 	Assert(!(eflags & EXEC_FLAG_MARK));
 
-	/*
-	 * Set up empty vector of subplan states
-	 */
-	nplans = list_length(node->appendplans);
-
-	appendplanstates = (PlanState **) palloc0(nplans * sizeof(PlanState *));
-
 	/*
 	 * create new AppendState for our append node
 	 */
 	appendstate->ps.plan = (Plan *) node;
 	appendstate->ps.state = estate;
-	appendstate->appendplans = appendplanstates;
-	appendstate->as_nplans = nplans;
 
 	/*
 	 * Miscellaneous initialization
 	 *
 	 * Append plans don't have expression contexts because they never call
-	 * ExecQual or ExecProject.
+	 * ExecQual or ExecProject, except to evaluate run-time partition pruning
+	 * restrictions.
+	 */
+	nplans = list_length(node->appendplans);
+	if (node->part_prune_info != NULL)
+	{
+		PartitionPruneState *prunestate;
+		bool		allpruned;
+
+		ExecAssignExprContext(estate, &appendstate->ps);
+		prunestate = ExecInitPartitionPrune(&appendstate->ps,
+											node->part_prune_info);
+
+		/*
+		 * Rule out what we can right away, so that we don't initialize
+		 * subplans that will never be run.
+		 */
+		validsubplans = ExecFindValidSubplans(prunestate, true);
+
+		/*
+		 * EXPLAIN needs at least one subplan to interpret our targetlist, so
+		 * if none are left, initialize the first anyway.  Its restrictions
+		 * are evaluated again at run time, and rule it out again.
+		 */
+		allpruned = bms_is_empty(validsubplans);
+		if (allpruned)
+			validsubplans = bms_make_singleton(0);
+		nplans = bms_num_members(validsubplans);
+
+		/* Keep the pruning state only if there's more to do at run time */
+		if (prunestate->pp_has_exec || allpruned)
+		{
+			ExecKeepValidSubplans(prunestate, validsubplans);
+			appendstate->as_prune_state = prunestate;
+			appendstate->as_prune_pending = true;
+		}
+		else
+			ExecEndPartitionPrune(prunestate);
+	}
+
+	/*
+	 * Set up empty vector of subplan states
 	 */
+	appendplanstates = (PlanState **) palloc0(nplans * sizeof(PlanState *));
+
+	appendstate->appendplans = appendplanstates;
+	appendstate->as_nplans = nplans;
 
 	/*
 	 * append nodes still have Result slots, which hold pointers to tuples, so
@@ -158,15 +201,17 @@ ExecInitAppend(Append *node, EState *estate, int eflags)
 
 	/*
 	 * call ExecInitNode on each of the plans to be executed and save the
-	 * results into the array "appendplans".
+	 * results into the array "appendplans".  Those pruned above are skipped.
 	 */
 	i = 0;
+	j = 0;
 	foreach(lc, node->appendplans)
 	{
 		Plan	   *initNode = (Plan *) lfirst(lc);
 
-		appendplanstates[i] = ExecInitNode(initNode, estate, eflags);
-		i++;
+		if (node->part_prune_info == NULL || bms_is_member(j, validsubplans))
+			appendplanstates[i++] = ExecInitNode(initNode, estate, eflags);
+		j++;
 	}
 
 	/*
@@ -193,11 +238,38 @@ ExecInitAppend(Append *node, EState *estate, int eflags)
 TupleTableSlot *
 ExecAppend(AppendState *node)
 {
+	/*
+	 * Now that the params are set, rule out the subplans that the run-time
+	 * pruning restrictions exclude.
+	 */
+	if (node->as_prune_pending)
+	{
+		bms_free(node->as_valid_subplans);
+		node->as_valid_subplans =
+			ExecFindValidSubplans(node->as_prune_state, false);
+		node->as_prune_pending = false;
+	}
+
 	for (;;)
 	{
 		PlanState  *subnode;
 		TupleTableSlot *result;
 
+		/*
+		 * skip the current subplan if run-time pruning ruled it out
+		 */
+		if (node->as_prune_state != NULL &&
+			!bms_is_member(node->as_whichplan, node->as_valid_subplans))
+		{
+			if (ScanDirectionIsForward(node->ps.state->es_direction))
+				node->as_whichplan++;
+			else
+				node->as_whichplan--;
+			if (!exec_append_initialize_next(node))
+				return ExecClearTuple(node->ps.ps_ResultTupleSlot);
+			continue;
+		}
+
 		/*
 		 * figure out which subplan we are currently processing
 		 */
@@ -255,11 +327,19 @@ ExecEndAppend(AppendState *node)
 	appendplans = node->appendplans;
 	nplans = node->as_nplans;
 
+	/*
+	 * Free the exprcontext, if we made one for run-time pruning
+	 */
+	ExecFreeExprContext(&node->ps);
+
 	/*
 	 * shut down each of the subscans
 	 */
 	for (i = 0; i < nplans; i++)
 		ExecEndNode(appendplans[i]);
+
+	if (node->as_prune_state)
+		ExecEndPartitionPrune(node->as_prune_state);
 }
 
 void
@@ -285,6 +365,11 @@ ExecReScanAppend(AppendState *node)
 		if (subnode->chgParam == NULL)
 			ExecReScan(subnode);
 	}
+
+	/* The params the pruning restrictions depend on may have changed */
+	if (node->as_prune_state)
+		node->as_prune_pending = true;
+
 	node->as_whichplan = 0;
 	exec_append_initialize_next(node);
 }
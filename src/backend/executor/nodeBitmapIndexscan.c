@@ -21,6 +21,7 @@
  */
 #include "postgres.h"
 
+#include "access/relscan.h"
 #include "executor/execdebug.h"
 #include "executor/nodeBitmapIndexscan.h"
 #include "executor/nodeIndexscan.h"
@@ -303,6 +304,9 @@ ExecInitBitmapIndexScan(BitmapIndexScan *node, EState *estate, int eflags)
 							   estate->es_snapshot,
 							   indexstate->biss_NumScanKeys);
 
+	/* Tell the AM whether the planner chose a skip scan */
+	indexstate->biss_ScanDesc->xs_skip_prefix = node->indexskipprefix;
+
 	/*
 	 * If no run-time keys to calculate, go ahead and pass the scankeys to the
 	 * index AM.
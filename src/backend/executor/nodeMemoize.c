@@ -0,0 +1,645 @@
+/*-------------------------------------------------------------------------
+ *
+ * nodeMemoize.c
+ *	  Routines to handle caching of results from parameterized nodes
+ *
+ * A Memoize node sits above the inner side of a parameterized nested loop
+ * join.  Each time it is rescanned with new parameter values, it computes
+ * the cache key expressions and looks them up in a hash table.  If the
+ * rows of a previous scan with equal keys are there, they are returned
+ * without running the subplan at all; this saves repeating, say, an index
+ * descent and heap fetch for every outer row that joins to the same row
+ * of a small dimension table.  Otherwise the subplan is run and its rows
+ * are added to a new cache entry as they are returned.  An entry becomes
+ * usable only once the subplan has been run to completion for it.
+ *
+ * The cache is limited to work_mem.  Entries are kept in a list in the
+ * order of their last use, and when the limit is exceeded, the least
+ * recently used ones are evicted.  If an entry alone doesn't fit, we give
+ * up caching it and just pass the subplan's rows through for the rest of
+ * that scan.
+ *
+ * If a parameter that is not part of the cache key changes, such as one
+ * set by an upper-level nested loop, every entry may be stale, so the
+ * whole cache is emptied.
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *	  src/backend/executor/nodeMemoize.c
+ *
+ *-------------------------------------------------------------------------
+ */
+/*
+ * INTERFACE ROUTINES
+ *		ExecMemoize			- return rows from the cache or the subplan
+ *		ExecInitMemoize		- initialize node and subnodes
+ *		ExecEndMemoize		- shutdown node and subnodes
+ *		ExecReScanMemoize	- prepare for a scan with new parameters
+ */
+#include "postgres.h"
+
+#include "access/htup_details.h"
+#include "executor/executor.h"
+#include "executor/nodeMemoize.h"
+#include "miscadmin.h"
+#include "nodes/nodeFuncs.h"
+#include "utils/memutils.h"
+
+/* States of the ExecMemoize state machine */
+#define MEMO_CACHE_LOOKUP			1	/* look up the cache for a new scan */
+#define MEMO_CACHE_FETCH_NEXT_TUPLE 2	/* return rows from a cache entry */
+#define MEMO_FILLING_CACHE			3	/* run subplan, caching its rows */
+#define MEMO_CACHE_BYPASS_MODE		4	/* run subplan without caching */
+#define MEMO_END_OF_SCAN			5	/* ready for rescan */
+
+/* A row remembered in a cache entry */
+struct MemoizeTuple
+{
+	MinimalTuple mintuple;		/* the cached row */
+	struct MemoizeTuple *next;	/* next row of the same entry, or NULL */
+};
+
+/* A hash table entry, holding the rows for one set of key values */
+struct MemoizeEntry
+{
+	TupleHashEntryData shared;	/* common header for hash table entries */
+	dlist_node	lru_node;		/* member of MemoizeState.lru_list */
+	MemoizeTuple *tuplehead;	/* first cached row, or NULL */
+	Size		mem;			/* memory charged for this entry */
+	bool		complete;		/* were all the rows cached? */
+};
+
+/* Memory charged for an entry without any rows, and for each row */
+#define EMPTY_ENTRY_MEMORY_BYTES(e) \
+	(sizeof(MemoizeEntry) + (e)->shared.firstTuple->t_len)
+#define CACHE_TUPLE_BYTES(t) \
+	(sizeof(MemoizeTuple) + (t)->mintuple->t_len)
+
+
+static bool collect_paramids_walker(Node *node, Bitmapset **paramids);
+static void build_hash_table(MemoizeState *mstate);
+static void prepare_probe_slot(MemoizeState *mstate);
+static void entry_free_tuples(MemoizeEntry *entry);
+static void remove_cache_entry(MemoizeState *mstate, MemoizeEntry *entry);
+static void cache_purge_all(MemoizeState *mstate);
+static bool cache_reduce_memory(MemoizeState *mstate,
+					MemoizeEntry *specialentry);
+static MemoizeEntry *cache_lookup(MemoizeState *mstate, bool *found);
+static bool cache_store_tuple(MemoizeState *mstate, TupleTableSlot *slot);
+
+
+/*
+ * Collect the IDs of the executor Params referenced in an expression
+ */
+static bool
+collect_paramids_walker(Node *node, Bitmapset **paramids)
+{
+	if (node == NULL)
+		return false;
+	if (IsA(node, Param))
+	{
+		Param	   *param = (Param *) node;
+
+		if (param->paramkind == PARAM_EXEC)
+			*paramids = bms_add_member(*paramids, param->paramid);
+		return false;
+	}
+	return expression_tree_walker(node, collect_paramids_walker,
+								  (void *) paramids);
+}
+
+/*
+ * Initialize the hash table to empty.
+ *
+ * The hash table and all the cached rows go into tableContext.
+ */
+static void
+build_hash_table(MemoizeState *mstate)
+{
+	Memoize    *node = (Memoize *) mstate->ss.ps.plan;
+	ExprContext *econtext = mstate->ss.ps.ps_ExprContext;
+	long		nbuckets;
+
+	nbuckets = node->est_entries > 0 ? (long) node->est_entries : 1024;
+
+	mstate->hashtable = BuildTupleHashTable(mstate->nkeys,
+											mstate->keyColIdx,
+											mstate->eqfunctions,
+											mstate->hashfunctions,
+											nbuckets,
+											sizeof(MemoizeEntry),
+											mstate->tableContext,
+											econtext->ecxt_per_tuple_memory);
+}
+
+/*
+ * Compute the cache keys for the current parameter values into probeslot
+ */
+static void
+prepare_probe_slot(MemoizeState *mstate)
+{
+	TupleTableSlot *pslot = mstate->probeslot;
+	ExprContext *econtext = mstate->ss.ps.ps_ExprContext;
+	MemoryContext oldcontext;
+	ListCell   *lc;
+	int			i = 0;
+
+	ResetExprContext(econtext);
+	oldcontext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+
+	ExecClearTuple(pslot);
+	foreach(lc, mstate->param_exprs)
+	{
+		ExprState  *exprstate = (ExprState *) lfirst(lc);
+
+		pslot->tts_values[i] = ExecEvalExpr(exprstate, econtext,
+											&pslot->tts_isnull[i], NULL);
+		i++;
+	}
+	ExecStoreVirtualTuple(pslot);
+
+	MemoryContextSwitchTo(oldcontext);
+}
+
+/*
+ * Free the rows cached in an entry
+ */
+static void
+entry_free_tuples(MemoizeEntry *entry)
+{
+	MemoizeTuple *tuple = entry->tuplehead;
+
+	while (tuple != NULL)
+	{
+		MemoizeTuple *next = tuple->next;
+
+		pfree(tuple->mintuple);
+		pfree(tuple);
+		tuple = next;
+	}
+	entry->tuplehead = NULL;
+}
+
+/*
+ * Remove an entry from the cache and free its memory
+ */
+static void
+remove_cache_entry(MemoizeState *mstate, MemoizeEntry *entry)
+{
+	MinimalTuple key = entry->shared.firstTuple;
+	TupleHashEntry removed PG_USED_FOR_ASSERTS_ONLY;
+
+	entry_free_tuples(entry);
+	dlist_delete(&entry->lru_node);
+	mstate->mem_used -= entry->mem;
+
+	/* The hash table finds the entry to remove by its key */
+	ExecStoreMinimalTuple(key, mstate->probeslot, false);
+	removed = RemoveTupleHashEntry(mstate->hashtable, mstate->probeslot);
+	Assert(removed == (TupleHashEntry) entry);
+	ExecClearTuple(mstate->probeslot);
+
+	pfree(key);
+}
+
+/*
+ * Empty the cache
+ */
+static void
+cache_purge_all(MemoizeState *mstate)
+{
+	/* Don't leave the result slot pointing into the freed memory */
+	ExecClearTuple(mstate->ss.ps.ps_ResultTupleSlot);
+
+	MemoryContextResetAndDeleteChildren(mstate->tableContext);
+	build_hash_table(mstate);
+	dlist_init(&mstate->lru_list);
+	mstate->mem_used = 0;
+
+	mstate->entry = NULL;
+	mstate->last_tuple = NULL;
+}
+
+/*
+ * Evict the least recently used entries until the cache fits into its
+ * memory limit again.  Since the entry being filled is always the most
+ * recently used one, it is evicted only if it doesn't fit on its own;
+ * "specialentry" is that entry, and we return false if we evicted it.
+ */
+static bool
+cache_reduce_memory(MemoizeState *mstate, MemoizeEntry *specialentry)
+{
+	bool		specialentry_evicted = false;
+	dlist_mutable_iter iter;
+
+	dlist_foreach_modify(iter, &mstate->lru_list)
+	{
+		MemoizeEntry *entry = dlist_container(MemoizeEntry, lru_node,
+											  iter.cur);
+
+		if (mstate->mem_used <= mstate->mem_limit)
+			break;
+
+		if (entry == specialentry)
+		{
+			specialentry_evicted = true;
+			mstate->cache_overflows++;
+		}
+		else
+			mstate->cache_evictions++;
+
+		remove_cache_entry(mstate, entry);
+	}
+
+	return !specialentry_evicted;
+}
+
+/*
+ * Look up the cache entry for the current parameter values, creating it if
+ * there isn't one.  *found is set to true if the entry holds the complete
+ * result of an earlier scan.  Returns NULL if a new entry was needed but
+ * there's no room for it.
+ */
+static MemoizeEntry *
+cache_lookup(MemoizeState *mstate, bool *found)
+{
+	MemoizeEntry *entry;
+	bool		isnew;
+
+	prepare_probe_slot(mstate);
+
+	entry = (MemoizeEntry *) LookupTupleHashEntry(mstate->hashtable,
+												  mstate->probeslot,
+												  &isnew);
+
+	if (!isnew)
+	{
+		/* It's now the most recently used entry */
+		dlist_move_tail(&mstate->lru_list, &entry->lru_node);
+
+		if (entry->complete)
+		{
+			*found = true;
+			return entry;
+		}
+
+		/*
+		 * An earlier scan with these keys was stopped before reaching the
+		 * end, so we must run the subplan again.  Start the entry over.
+		 */
+		entry_free_tuples(entry);
+		mstate->mem_used -= entry->mem;
+		entry->mem = EMPTY_ENTRY_MEMORY_BYTES(entry);
+		mstate->mem_used += entry->mem;
+
+		*found = false;
+		return entry;
+	}
+
+	*found = false;
+
+	/* LookupTupleHashEntry zeroed the rest of the new entry */
+	entry->mem = EMPTY_ENTRY_MEMORY_BYTES(entry);
+	dlist_push_tail(&mstate->lru_list, &entry->lru_node);
+
+	mstate->mem_used += entry->mem;
+	if (mstate->mem_used > mstate->mem_peak)
+		mstate->mem_peak = mstate->mem_used;
+
+	if (mstate->mem_used > mstate->mem_limit &&
+		!cache_reduce_memory(mstate, entry))
+		return NULL;
+
+	return entry;
+}
+
+/*
+ * Add a copy of the row in "slot" to the entry being filled.  Returns false
+ * if that made the entry too large to keep; it has then been removed.
+ */
+static bool
+cache_store_tuple(MemoizeState *mstate, TupleTableSlot *slot)
+{
+	MemoizeEntry *entry = mstate->entry;
+	MemoizeTuple *tuple;
+	MemoryContext oldcontext;
+	Size		size;
+
+	Assert(entry != NULL);
+
+	oldcontext = MemoryContextSwitchTo(mstate->tableContext);
+	tuple = (MemoizeTuple *) palloc(sizeof(MemoizeTuple));
+	tuple->mintuple = ExecCopySlotMinimalTuple(slot);
+	tuple->next = NULL;
+	MemoryContextSwitchTo(oldcontext);
+
+	if (entry->tuplehead == NULL)
+		entry->tuplehead = tuple;
+	else
+		mstate->last_tuple->next = tuple;
+	mstate->last_tuple = tuple;
+
+	size = CACHE_TUPLE_BYTES(tuple);
+	entry->mem += size;
+	mstate->mem_used += size;
+	if (mstate->mem_used > mstate->mem_peak)
+		mstate->mem_peak = mstate->mem_used;
+
+	if (mstate->mem_used > mstate->mem_limit &&
+		!cache_reduce_memory(mstate, entry))
+	{
+		mstate->entry = NULL;
+		mstate->last_tuple = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecMemoize
+ *
+ *		On the first call after a rescan, look up the cache.  On a hit,
+ *		return the cached rows; on a miss, return the subplan's rows,
+ *		adding them to the cache as we go.
+ * ----------------------------------------------------------------
+ */
+TupleTableSlot *
+ExecMemoize(MemoizeState *node)
+{
+	PlanState  *outerNode = outerPlanState(node);
+	TupleTableSlot *slot = node->ss.ps.ps_ResultTupleSlot;
+	TupleTableSlot *outerslot;
+
+	switch (node->mstatus)
+	{
+		case MEMO_CACHE_LOOKUP:
+			{
+				MemoizeEntry *entry;
+				bool		found;
+
+				Assert(node->entry == NULL);
+
+				/* The previous row may be about to be evicted */
+				ExecClearTuple(slot);
+
+				entry = cache_lookup(node, &found);
+
+				if (found)
+				{
+					node->cache_hits++;
+
+					if (entry->tuplehead == NULL)
+					{
+						/* The subplan returned no rows for these keys */
+						node->mstatus = MEMO_END_OF_SCAN;
+						return NULL;
+					}
+
+					node->last_tuple = entry->tuplehead;
+					node->mstatus = MEMO_CACHE_FETCH_NEXT_TUPLE;
+					return ExecStoreMinimalTuple(node->last_tuple->mintuple,
+												 slot, false);
+				}
+
+				node->cache_misses++;
+
+				outerslot = ExecProcNode(outerNode);
+				if (TupIsNull(outerslot))
+				{
+					/* Remember that there are no rows, if we have an entry */
+					if (entry != NULL)
+						entry->complete = true;
+					node->mstatus = MEMO_END_OF_SCAN;
+					return NULL;
+				}
+
+				node->entry = entry;
+				if (entry != NULL && cache_store_tuple(node, outerslot))
+					node->mstatus = MEMO_FILLING_CACHE;
+				else
+					node->mstatus = MEMO_CACHE_BYPASS_MODE;
+
+				return outerslot;
+			}
+
+		case MEMO_CACHE_FETCH_NEXT_TUPLE:
+			node->last_tuple = node->last_tuple->next;
+			if (node->last_tuple == NULL)
+			{
+				node->mstatus = MEMO_END_OF_SCAN;
+				return NULL;
+			}
+			return ExecStoreMinimalTuple(node->last_tuple->mintuple,
+										 slot, false);
+
+		case MEMO_FILLING_CACHE:
+			outerslot = ExecProcNode(outerNode);
+			if (TupIsNull(outerslot))
+			{
+				/* The entry now holds all the rows, so it can be used */
+				node->entry->complete = true;
+				node->mstatus = MEMO_END_OF_SCAN;
+				return NULL;
+			}
+
+			if (!cache_store_tuple(node, outerslot))
+				node->mstatus = MEMO_CACHE_BYPASS_MODE;
+
+			return outerslot;
+
+		case MEMO_CACHE_BYPASS_MODE:
+			outerslot = ExecProcNode(outerNode);
+			if (TupIsNull(outerslot))
+			{
+				node->mstatus = MEMO_END_OF_SCAN;
+				return NULL;
+			}
+			return outerslot;
+
+		case MEMO_END_OF_SCAN:
+
+			/*
+			 * Some plan node types are not robust about being called again
+			 * when they've already returned NULL, so don't.
+			 */
+			return NULL;
+
+		default:
+			elog(ERROR, "unrecognized memoize state: %d",
+				 node->mstatus);
+			return NULL;		/* keep compiler quiet */
+	}
+}
+
+/* ----------------------------------------------------------------
+ *		ExecInitMemoize
+ * ----------------------------------------------------------------
+ */
+MemoizeState *
+ExecInitMemoize(Memoize *node, EState *estate, int eflags)
+{
+	MemoizeState *mstate;
+	Plan	   *outerPlan;
+	int			i;
+
+	/* check for unsupported flags */
+	Assert(!(eflags & (EXEC_FLAG_BACKWARD | EXEC_FLAG_MARK)));
+
+	/*
+	 * create state structure
+	 */
+	mstate = makeNode(MemoizeState);
+	mstate->ss.ps.plan = (Plan *) node;
+	mstate->ss.ps.state = estate;
+
+	/*
+	 * Miscellaneous initialization
+	 *
+	 * We need an ExprContext to compute the cache keys; its per-tuple memory
+	 * also serves for running the hash and equality functions.
+	 */
+	ExecAssignExprContext(estate, &mstate->ss.ps);
+
+	/*
+	 * tuple table initialization
+	 */
+	ExecInitResultTupleSlot(estate, &mstate->ss.ps);
+	ExecInitScanTupleSlot(estate, &mstate->ss);
+
+	/*
+	 * initialize child nodes
+	 */
+	outerPlan = outerPlan(node);
+	outerPlanState(mstate) = ExecInitNode(outerPlan, estate, eflags);
+
+	/*
+	 * initialize tuple type.  no need to initialize projection info because
+	 * this node doesn't do projections.
+	 */
+	ExecAssignResultTypeFromTL(&mstate->ss.ps);
+	ExecAssignScanTypeFromOuterPlan(&mstate->ss);
+	mstate->ss.ps.ps_ProjInfo = NULL;
+
+	/*
+	 * initialize the cache keys.  The probe slot holds the keys of the
+	 * current lookup, in columns 1..nkeys.
+	 */
+	mstate->nkeys = node->numKeys;
+	mstate->param_exprs = (List *)
+		ExecInitExpr((Expr *) node->param_exprs, (PlanState *) mstate);
+	mstate->keyparamids = NULL;
+	(void) collect_paramids_walker((Node *) node->param_exprs,
+								   &mstate->keyparamids);
+
+	mstate->probeslot = ExecInitExtraTupleSlot(estate);
+	ExecSetSlotDescriptor(mstate->probeslot,
+						  ExecTypeFromExprList(node->param_exprs));
+
+	mstate->keyColIdx = (AttrNumber *) palloc(mstate->nkeys * sizeof(AttrNumber));
+	for (i = 0; i < mstate->nkeys; i++)
+		mstate->keyColIdx[i] = i + 1;
+
+	execTuplesHashPrepare(mstate->nkeys,
+						  node->hashOperators,
+						  &mstate->eqfunctions,
+						  &mstate->hashfunctions);
+
+	/*
+	 * initialize the cache itself
+	 */
+	mstate->tableContext =
+		AllocSetContextCreate(CurrentMemoryContext,
+							  "Memoize hash table",
+							  ALLOCSET_DEFAULT_MINSIZE,
+							  ALLOCSET_DEFAULT_INITSIZE,
+							  ALLOCSET_DEFAULT_MAXSIZE);
+	dlist_init(&mstate->lru_list);
+	mstate->mem_used = 0;
+	mstate->mem_limit = work_mem * 1024L;
+	build_hash_table(mstate);
+
+	mstate->mstatus = MEMO_CACHE_LOOKUP;
+	mstate->entry = NULL;
+	mstate->last_tuple = NULL;
+
+	mstate->cache_hits = 0;
+	mstate->cache_misses = 0;
+	mstate->cache_evictions = 0;
+	mstate->cache_overflows = 0;
+	mstate->mem_peak = 0;
+
+	return mstate;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecEndMemoize
+ * ----------------------------------------------------------------
+ */
+void
+ExecEndMemoize(MemoizeState *node)
+{
+	/*
+	 * Free the exprcontext
+	 */
+	ExecFreeExprContext(&node->ss.ps);
+
+	/*
+	 * clean out the tuple table
+	 */
+	ExecClearTuple(node->ss.ps.ps_ResultTupleSlot);
+	ExecClearTuple(node->ss.ss_ScanTupleSlot);
+
+	/*
+	 * Release the cache
+	 */
+	MemoryContextDelete(node->tableContext);
+
+	/*
+	 * shut down the subplan
+	 */
+	ExecEndNode(outerPlanState(node));
+}
+
+/* ----------------------------------------------------------------
+ *		ExecReScanMemoize
+ * ----------------------------------------------------------------
+ */
+void
+ExecReScanMemoize(MemoizeState *node)
+{
+	PlanState  *outerPlan = outerPlanState(node);
+
+	/* We must look up the cache for the new parameter values */
+	node->mstatus = MEMO_CACHE_LOOKUP;
+	node->entry = NULL;
+	node->last_tuple = NULL;
+
+	/*
+	 * if chgParam of subnode is not null then plan will be re-scanned by
+	 * first ExecProcNode.  Otherwise rescan it now, in case we need it.
+	 */
+	if (outerPlan->chgParam == NULL)
+		ExecReScan(outerPlan);
+
+	/*
+	 * If a parameter that is not a cache key changed, the cached rows may
+	 * no longer be right for any keys.
+	 */
+	if (bms_nonempty_difference(outerPlan->chgParam, node->keyparamids))
+		cache_purge_all(node);
+}
+
+/*
+ * ExecEstimateCacheEntryOverheadBytes
+ *		For use in the planner: the memory used by a cache entry with
+ *		ntuples rows, beyond that of the rows themselves.
+ */
+double
+ExecEstimateCacheEntryOverheadBytes(double ntuples)
+{
+	return sizeof(MemoizeEntry) + sizeof(MemoizeTuple) * ntuples;
+}
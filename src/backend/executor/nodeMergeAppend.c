@@ -64,25 +64,57 @@ ExecInitMergeAppend(MergeAppend *node, EState *estate, int eflags)
 {
 	MergeAppendState *mergestate = makeNode(MergeAppendState);
 	PlanState **mergeplanstates;
+	Bitmapset  *validsubplans = NULL;
 	int			nplans;
 	int			i;
+	int			j;
 	ListCell   *lc;
 
 	/* check for unsupported flags */
 	Assert(!(eflags & (EXEC_FLAG_BACKWARD | EXEC_FLAG_MARK)));
 
 	/*
-	 * Set up empty vector of subplan states
+	 * create new MergeAppendState for our node
 	 */
-	nplans = list_length(node->mergeplans);
+	mergestate->ps.plan = (Plan *) node;
+	mergestate->ps.state = estate;
 
-	mergeplanstates = (PlanState **) palloc0(nplans * sizeof(PlanState *));
+	/*
+	 * Miscellaneous initialization
+	 *
+	 * MergeAppend plans don't have expression contexts because they never
+	 * call ExecQual or ExecProject, except to evaluate run-time partition
+	 * pruning restrictions.  That works as in ExecInitAppend.
+	 */
+	nplans = list_length(node->mergeplans);
+	if (node->part_prune_info != NULL)
+	{
+		PartitionPruneState *prunestate;
+		bool		allpruned;
+
+		ExecAssignExprContext(estate, &mergestate->ps);
+		prunestate = ExecInitPartitionPrune(&mergestate->ps,
+											node->part_prune_info);
+		validsubplans = ExecFindValidSubplans(prunestate, true);
+		allpruned = bms_is_empty(validsubplans);
+		if (allpruned)
+			validsubplans = bms_make_singleton(0);
+		nplans = bms_num_members(validsubplans);
+
+		if (prunestate->pp_has_exec || allpruned)
+		{
+			ExecKeepValidSubplans(prunestate, validsubplans);
+			mergestate->ms_prune_state = prunestate;
+		}
+		else
+			ExecEndPartitionPrune(prunestate);
+	}
 
 	/*
-	 * create new MergeAppendState for our node
+	 * Set up empty vector of subplan states
 	 */
-	mergestate->ps.plan = (Plan *) node;
-	mergestate->ps.state = estate;
+	mergeplanstates = (PlanState **) palloc0(nplans * sizeof(PlanState *));
+
 	mergestate->mergeplans = mergeplanstates;
 	mergestate->ms_nplans = nplans;
 
@@ -90,13 +122,6 @@ ExecInitMergeAppend(MergeAppend *node, EState *estate, int eflags)
 	mergestate->ms_heap = binaryheap_allocate(nplans, heap_compare_slots,
 											  mergestate);
 
-	/*
-	 * Miscellaneous initialization
-	 *
-	 * MergeAppend plans don't have expression contexts because they never
-	 * call ExecQual or ExecProject.
-	 */
-
 	/*
 	 * MergeAppend nodes do have Result slots, which hold pointers to tuples,
 	 * so we have to initialize them.
@@ -105,15 +130,17 @@ ExecInitMergeAppend(MergeAppend *node, EState *estate, int eflags)
 
 	/*
 	 * call ExecInitNode on each of the plans to be executed and save the
-	 * results into the array "mergeplans".
+	 * results into the array "mergeplans".  Those pruned above are skipped.
 	 */
 	i = 0;
+	j = 0;
 	foreach(lc, node->mergeplans)
 	{
 		Plan	   *initNode = (Plan *) lfirst(lc);
 
-		mergeplanstates[i] = ExecInitNode(initNode, estate, eflags);
-		i++;
+		if (node->part_prune_info == NULL || bms_is_member(j, validsubplans))
+			mergeplanstates[i++] = ExecInitNode(initNode, estate, eflags);
+		j++;
 	}
 
 	/*
@@ -171,18 +198,30 @@ ExecMergeAppend(MergeAppendState *node)
 
 	if (!node->ms_initialized)
 	{
+		Bitmapset  *validsubplans = NULL;
+
+		/*
+		 * Now that the params are set, rule out the subplans that the
+		 * run-time pruning restrictions exclude.
+		 */
+		if (node->ms_prune_state)
+			validsubplans = ExecFindValidSubplans(node->ms_prune_state, false);
+
 		/*
 		 * First time through: pull the first tuple from each subplan, and set
 		 * up the heap.
 		 */
 		for (i = 0; i < node->ms_nplans; i++)
 		{
+			if (node->ms_prune_state && !bms_is_member(i, validsubplans))
+				continue;
 			node->ms_slots[i] = ExecProcNode(node->mergeplans[i]);
 			if (!TupIsNull(node->ms_slots[i]))
 				binaryheap_add_unordered(node->ms_heap, Int32GetDatum(i));
 		}
 		binaryheap_build(node->ms_heap);
 		node->ms_initialized = true;
+		bms_free(validsubplans);
 	}
 	else
 	{
@@ -276,11 +315,19 @@ ExecEndMergeAppend(MergeAppendState *node)
 	mergeplans = node->mergeplans;
 	nplans = node->ms_nplans;
 
+	/*
+	 * Free the exprcontext, if we made one for run-time pruning
+	 */
+	ExecFreeExprContext(&node->ps);
+
 	/*
 	 * shut down each of the subscans
 	 */
 	for (i = 0; i < nplans; i++)
 		ExecEndNode(mergeplans[i]);
+
+	if (node->ms_prune_state)
+		ExecEndPartitionPrune(node->ms_prune_state);
 }
 
 void
@@ -38,7 +38,9 @@
 #include "postgres.h"
 
 #include "access/htup_details.h"
+#include "access/tupconvert.h"
 #include "access/xact.h"
+#include "catalog/partition.h"
 #include "commands/trigger.h"
 #include "executor/executor.h"
 #include "executor/nodeModifyTable.h"
@@ -206,6 +208,39 @@ ExecCheckTIDVisible(EState *estate,
 	ReleaseBuffer(buffer);
 }
 
+/*
+ * ExecRoutedTupleToRoot
+ *
+ * Return a slot holding a tuple routed to a partition, in the rowtype of the
+ * partitioned table the tuple was inserted into.  rootslot is the slot the
+ * tuple originally came in, and slot the one holding it now.
+ */
+static TupleTableSlot *
+ExecRoutedTupleToRoot(ResultRelInfo *rootRelInfo, ResultRelInfo *partRelInfo,
+					  TupleTableSlot *rootslot, TupleTableSlot *slot)
+{
+	HeapTuple	tuple;
+	HeapTuple	roottuple;
+	TupleTableSlot *result;
+
+	/* Nothing to do if the tuple was neither converted nor replaced */
+	if (slot == rootslot)
+		return slot;
+
+	tuple = ExecMaterializeSlot(slot);
+	if (partRelInfo->ri_PartitionRootMap)
+		roottuple = do_convert_tuple(tuple, partRelInfo->ri_PartitionRootMap);
+	else
+		roottuple = heap_copytuple(tuple);
+	roottuple->t_self = tuple->t_self;
+	roottuple->t_tableOid = tuple->t_tableOid;
+
+	result = rootRelInfo->ri_PartitionRouting->rootslot;
+	ExecStoreTuple(roottuple, result, InvalidBuffer, true);
+
+	return result;
+}
+
 /* ----------------------------------------------------------------
  *		ExecInsert
  *
@@ -226,6 +261,8 @@ ExecInsert(ModifyTableState *mtstate,
 {
 	HeapTuple	tuple;
 	ResultRelInfo *resultRelInfo;
+	ResultRelInfo *rootRelInfo = NULL;
+	TupleTableSlot *rootslot = slot;
 	Relation	resultRelationDesc;
 	Oid			newId;
 	List	   *recheckIndexes = NIL;
@@ -240,6 +277,20 @@ ExecInsert(ModifyTableState *mtstate,
 	 * get information on the (current) result relation
 	 */
 	resultRelInfo = estate->es_result_relation_info;
+
+	/*
+	 * A tuple inserted into a partitioned table goes into the partition that
+	 * accepts it, which is the current result relation until we're done.
+	 * RETURNING and WITH CHECK OPTIONs are still processed for the
+	 * partitioned table.
+	 */
+	if (resultRelInfo->ri_PartitionRouting)
+	{
+		rootRelInfo = resultRelInfo;
+		resultRelInfo = ExecFindPartition(rootRelInfo, &slot, estate);
+		estate->es_result_relation_info = resultRelInfo;
+		tuple = ExecMaterializeSlot(slot);
+	}
 	resultRelationDesc = resultRelInfo->ri_RelationDesc;
 
 	/*
@@ -272,7 +323,11 @@ ExecInsert(ModifyTableState *mtstate,
 		slot = ExecBRInsertTriggers(estate, resultRelInfo, slot);
 
 		if (slot == NULL)		/* "do nothing" */
+		{
+			if (rootRelInfo)
+				estate->es_result_relation_info = rootRelInfo;
 			return NULL;
+		}
 
 		/* trigger might have changed tuple */
 		tuple = ExecMaterializeSlot(slot);
@@ -327,11 +382,18 @@ ExecInsert(ModifyTableState *mtstate,
 		if (resultRelInfo->ri_WithCheckOptions != NIL)
 			ExecWithCheckOptions(WCO_RLS_INSERT_CHECK,
 								 resultRelInfo, slot, estate);
+		else if (rootRelInfo && rootRelInfo->ri_WithCheckOptions != NIL)
+			ExecWithCheckOptions(WCO_RLS_INSERT_CHECK, rootRelInfo,
+								 ExecRoutedTupleToRoot(rootRelInfo,
+													   resultRelInfo,
+													   rootslot, slot),
+								 estate);
 
 		/*
 		 * Check the constraints of the tuple
 		 */
-		if (resultRelationDesc->rd_att->constr)
+		if (resultRelationDesc->rd_att->constr ||
+			resultRelInfo->ri_PartitionCheck)
 			ExecConstraints(resultRelInfo, slot, estate);
 
 		if (onconflict != ONCONFLICT_NONE && resultRelInfo->ri_NumIndices > 0)
@@ -474,6 +536,15 @@ ExecInsert(ModifyTableState *mtstate,
 
 	list_free(recheckIndexes);
 
+	/* Back to the partitioned table, for the steps below */
+	if (rootRelInfo)
+	{
+		slot = ExecRoutedTupleToRoot(rootRelInfo, resultRelInfo,
+									 rootslot, slot);
+		resultRelInfo = rootRelInfo;
+		estate->es_result_relation_info = rootRelInfo;
+	}
+
 	/*
 	 * Check any WITH CHECK OPTION constraints from parent views.  We are
 	 * required to do this after testing all constraints and uniqueness
@@ -870,7 +941,8 @@ lreplace:;
 		/*
 		 * Check the constraints of the tuple
 		 */
-		if (resultRelationDesc->rd_att->constr)
+		if (resultRelationDesc->rd_att->constr ||
+			resultRelInfo->ri_PartitionCheck)
 			ExecConstraints(resultRelInfo, slot, estate);
 
 		/*
@@ -1564,6 +1636,19 @@ ExecInitModifyTable(ModifyTable *node, EState *estate, int eflags)
 															 eflags);
 		}
 
+		/* Tuples inserted into a partitioned table go to its partitions */
+		if (operation == CMD_INSERT &&
+			resultRelInfo->ri_PartitionRouting == NULL &&
+			RelationGetPartitionKey(resultRelInfo->ri_RelationDesc) != NULL)
+		{
+			if (mtstate->mt_onconflict != ONCONFLICT_NONE)
+				ereport(ERROR,
+						(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+						 errmsg("ON CONFLICT is not supported on partitioned table \"%s\"",
+							RelationGetRelationName(resultRelInfo->ri_RelationDesc))));
+			ExecSetupPartitionRouting(resultRelInfo, estate);
+		}
+
 		resultRelInfo++;
 		i++;
 	}
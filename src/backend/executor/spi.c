@@ -2177,6 +2177,7 @@ _SPI_execute_plan(SPIPlanPtr plan, ParamListInfo paramLI,
 			{
 				QueryDesc  *qdesc;
 				Snapshot	snap;
+				instr_time	start_time;
 
 				if (ActiveSnapshotSet())
 					snap = GetActiveSnapshot();
@@ -2188,8 +2189,10 @@ _SPI_execute_plan(SPIPlanPtr plan, ParamListInfo paramLI,
 										snap, crosscheck_snapshot,
 										dest,
 										paramLI, 0);
+				INSTR_TIME_SET_CURRENT(start_time);
 				res = _SPI_pquery(qdesc, fire_triggers,
 								  canSetTag ? tcount : 0);
+				CachedPlanAddRunTime(cplan, start_time);
 				FreeQueryDesc(qdesc);
 			}
 			else
@@ -53,6 +53,8 @@ typedef struct pushdown_safety_info
 /* These parameters are set by GUC */
 bool		enable_geqo = false;	/* just in case GUC doesn't set it */
 int			geqo_threshold;
+bool		geqo_idp = true;
+int			geqo_idp_block_size = 4;
 
 /* Hook for plugins to get control in set_rel_pathlist() */
 set_rel_pathlist_hook_type set_rel_pathlist_hook = NULL;
@@ -1615,7 +1617,11 @@ make_rel_from_joinlist(PlannerInfo *root, List *joinlist)
 		if (join_search_hook)
 			return (*join_search_hook) (root, levels_needed, initial_rels);
 		else if (enable_geqo && levels_needed >= geqo_threshold)
+		{
+			if (geqo_idp)
+				return idp_join_search(root, levels_needed, initial_rels);
 			return geqo(root, levels_needed, initial_rels);
+		}
 		else
 			return standard_join_search(root, levels_needed, initial_rels);
 	}
@@ -1718,6 +1724,159 @@ standard_join_search(PlannerInfo *root, int levels_needed, List *initial_rels)
 	return rel;
 }
 
+/*
+ * idp_join_search
+ *	  Find a join order for a large join problem by iterative dynamic
+ *	  programming.
+ *
+ * The parameters and result are the same as for standard_join_search(),
+ * whose exhaustive search takes time exponential in the number of jointree
+ * items.  Instead, we run the same dynamic programming only up to joins of
+ * geqo_idp_block_size items, keep the cheapest of the largest joins found,
+ * and start over treating it as a single item, until the remaining items
+ * fit in one block and the last round can finish the search.  This is the
+ * IDP-1 algorithm of Kossmann and Stocker.  Unlike GEQO, it's deterministic,
+ * and each round considers all the ways to make the joins it builds.
+ *
+ * Between rounds we forget the join rels that weren't chosen, the same way
+ * geqo_eval() does, so that a later round can build joins of the same items
+ * out of the new ones.
+ */
+RelOptInfo *
+idp_join_search(PlannerInfo *root, int levels_needed, List *initial_rels)
+{
+	int			origlength = list_length(root->join_rel_list);
+	List	   *rels = initial_rels;
+	int			nrels = levels_needed;
+
+	Assert(root->join_rel_level == NULL);
+
+	for (;;)
+	{
+		int			maxlev = Min(nrels, geqo_idp_block_size);
+		int			savelength = list_length(root->join_rel_list);
+		RelOptInfo *best = NULL;
+		List	   *newrels = NIL;
+		bool		placed = false;
+		int			lev;
+		ListCell   *lc;
+
+		/* has_legal_joinclause() needs to see the items of this round */
+		root->initial_rels = rels;
+
+		/*
+		 * The join rels built by this round are only looked up in the list,
+		 * or a hash table made from it afresh, so that we can drop them.
+		 */
+		root->join_rel_hash = NULL;
+
+		root->join_rel_level = (List **) palloc0((maxlev + 1) * sizeof(List *));
+		root->join_rel_level[1] = rels;
+
+		for (lev = 2; lev <= maxlev; lev++)
+		{
+			join_search_one_level(root, lev);
+			if (root->join_rel_level[lev] == NIL)
+				break;
+
+			foreach(lc, root->join_rel_level[lev])
+			{
+				RelOptInfo *rel = (RelOptInfo *) lfirst(lc);
+
+				/* Find and save the cheapest paths for this rel */
+				set_cheapest(rel);
+
+#ifdef OPTIMIZER_DEBUG
+				debug_print_rel(root, rel);
+#endif
+			}
+		}
+		/* lev is now the highest level at which we built something */
+		lev--;
+
+		if (lev < 2)
+		{
+			/*
+			 * The joins chosen so far can't be joined with each other.  That
+			 * shouldn't happen, but if it does, start over with GEQO rather
+			 * than fail.  Exhaustive search is no option: the problem is
+			 * large, or we wouldn't be here.
+			 */
+			root->join_rel_level = NULL;
+			root->join_rel_list = list_truncate(root->join_rel_list,
+												origlength);
+			root->join_rel_hash = NULL;
+			root->initial_rels = initial_rels;
+			return geqo(root, levels_needed, initial_rels);
+		}
+
+		if (lev == nrels)
+		{
+			/* All the items fit in this round, so we're done */
+			Assert(list_length(root->join_rel_level[lev]) == 1);
+			best = (RelOptInfo *) linitial(root->join_rel_level[lev]);
+			root->join_rel_level = NULL;
+			root->initial_rels = initial_rels;
+			return best;
+		}
+
+		/*
+		 * Choose the join to keep: the cheapest one, preferring those not
+		 * needing to be parameterized by other rels, then the one producing
+		 * fewer rows.
+		 */
+		foreach(lc, root->join_rel_level[lev])
+		{
+			RelOptInfo *rel = (RelOptInfo *) lfirst(lc);
+			Path	   *path = rel->cheapest_total_path;
+			Path	   *bestpath;
+
+			if (best == NULL)
+			{
+				best = rel;
+				continue;
+			}
+			bestpath = best->cheapest_total_path;
+			if ((PATH_REQ_OUTER(path) == NULL) !=
+				(PATH_REQ_OUTER(bestpath) == NULL))
+			{
+				if (PATH_REQ_OUTER(path) == NULL)
+					best = rel;
+			}
+			else if (path->total_cost < bestpath->total_cost ||
+					 (path->total_cost == bestpath->total_cost &&
+					  rel->rows < best->rows))
+				best = rel;
+		}
+
+		root->join_rel_level = NULL;
+
+		/*
+		 * Forget the other joins built by this round, keeping the chosen one
+		 * in the list.  Its own components needn't be found again.
+		 */
+		root->join_rel_list = list_truncate(root->join_rel_list, savelength);
+		root->join_rel_list = lappend(root->join_rel_list, best);
+		root->join_rel_hash = NULL;
+
+		/* Replace the items it joins with it, keeping the items' order */
+		foreach(lc, rels)
+		{
+			RelOptInfo *rel = (RelOptInfo *) lfirst(lc);
+
+			if (!bms_is_subset(rel->relids, best->relids))
+				newrels = lappend(newrels, rel);
+			else if (!placed)
+			{
+				newrels = lappend(newrels, best);
+				placed = true;
+			}
+		}
+		rels = newrels;
+		nrels = list_length(rels);
+	}
+}
+
 /*****************************************************************************
  *			PUSHING QUALS DOWN INTO SUBQUERIES
  *****************************************************************************/
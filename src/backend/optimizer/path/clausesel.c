@@ -20,6 +20,8 @@
 #include "optimizer/cost.h"
 #include "optimizer/pathnode.h"
 #include "optimizer/plancat.h"
+#include "optimizer/var.h"
+#include "utils/extended_stats.h"
 #include "utils/fmgroids.h"
 #include "utils/lsyscache.h"
 #include "utils/selfuncs.h"
@@ -41,6 +43,8 @@ typedef struct RangeQueryClause
 
 static void addRangeClause(RangeQueryClause **rqlist, Node *clause,
 			   bool varonleft, bool isLTsel, Selectivity s2);
+static RelOptInfo *find_single_rel_for_clauses(PlannerInfo *root,
+							List *clauses);
 
 
 /****************************************************************************
@@ -61,8 +65,13 @@ static void addRangeClause(RangeQueryClause **rqlist, Node *clause,
  * subclauses.  However, that's only right if the subclauses have independent
  * probabilities, and in reality they are often NOT independent.  So,
  * we want to be smarter where we can.
-
- * Currently, the only extra smarts we have is to recognize "range queries",
+ *
+ * If all the clauses reference a single relation that has functional
+ * dependency statistics (see extended_stats.c), we first estimate the
+ * equality clauses those apply to together, and leave them out of the rest
+ * of the processing.
+ *
+ * The other extra smarts we have is to recognize "range queries",
  * such as "x > 34 AND x < 42".  Clauses are recognized as possible range
  * query components if they are restriction opclauses whose operators have
  * scalarltsel() or scalargtsel() as their restriction selectivity estimator.
@@ -98,6 +107,9 @@ clauselist_selectivity(PlannerInfo *root,
 {
 	Selectivity s1 = 1.0;
 	RangeQueryClause *rqlist = NULL;
+	RelOptInfo *rel;
+	Bitmapset  *estimatedclauses = NULL;
+	int			listidx;
 	ListCell   *l;
 
 	/*
@@ -108,17 +120,35 @@ clauselist_selectivity(PlannerInfo *root,
 		return clause_selectivity(root, (Node *) linitial(clauses),
 								  varRelid, jointype, sjinfo);
 
+	/*
+	 * Apply functional dependency statistics, if the clauses are all on a
+	 * relation that has some.  The clauses they account for are noted in
+	 * estimatedclauses.
+	 */
+	rel = find_single_rel_for_clauses(root, clauses);
+	if (rel != NULL && rel->statlist != NIL)
+		s1 = dependencies_clauselist_selectivity(root, clauses, varRelid,
+												 jointype, sjinfo, rel,
+												 &estimatedclauses);
+
 	/*
 	 * Initial scan over clauses.  Anything that doesn't look like a potential
 	 * rangequery clause gets multiplied into s1 and forgotten. Anything that
 	 * does gets inserted into an rqlist entry.
 	 */
+	listidx = -1;
 	foreach(l, clauses)
 	{
 		Node	   *clause = (Node *) lfirst(l);
 		RestrictInfo *rinfo;
 		Selectivity s2;
 
+		listidx++;
+
+		/* Skip the clauses already estimated using dependencies */
+		if (bms_is_member(listidx, estimatedclauses))
+			continue;
+
 		/* Always compute the selectivity using clause_selectivity */
 		s2 = clause_selectivity(root, clause, varRelid, jointype, sjinfo);
 
@@ -373,6 +403,45 @@ addRangeClause(RangeQueryClause **rqlist, Node *clause,
 	*rqlist = rqelem;
 }
 
+/*
+ * find_single_rel_for_clauses
+ *		Return the base relation all the clauses reference, or NULL if
+ *		they reference several or none.
+ *
+ * Clauses referencing no relation at all are ignored.
+ */
+static RelOptInfo *
+find_single_rel_for_clauses(PlannerInfo *root, List *clauses)
+{
+	int			lastrelid = 0;
+	ListCell   *l;
+
+	foreach(l, clauses)
+	{
+		Node	   *clause = (Node *) lfirst(l);
+		Relids		relids;
+		int			relid;
+
+		if (IsA(clause, RestrictInfo))
+			relids = ((RestrictInfo *) clause)->clause_relids;
+		else
+			relids = pull_varnos(clause);
+
+		if (bms_is_empty(relids))
+			continue;
+		if (!bms_get_singleton_member(relids, &relid))
+			return NULL;
+		if (lastrelid != 0 && relid != lastrelid)
+			return NULL;
+		lastrelid = relid;
+	}
+
+	if (lastrelid == 0 || lastrelid >= root->simple_rel_array_size)
+		return NULL;
+
+	return root->simple_rel_array[lastrelid];
+}
+
 /*
  * bms_is_subset_singleton
  *
@@ -76,6 +76,7 @@
 #include "access/htup_details.h"
 #include "executor/executor.h"
 #include "executor/nodeHash.h"
+#include "executor/nodeMemoize.h"
 #include "miscadmin.h"
 #include "nodes/nodeFuncs.h"
 #include "optimizer/clauses.h"
@@ -109,14 +110,18 @@ Cost		disable_cost = 1.0e10;
 bool		enable_seqscan = true;
 bool		enable_indexscan = true;
 bool		enable_indexonlyscan = true;
+bool		enable_indexskipscan = true;
 bool		enable_bitmapscan = true;
 bool		enable_tidscan = true;
 bool		enable_sort = true;
 bool		enable_hashagg = true;
 bool		enable_nestloop = true;
 bool		enable_material = true;
+bool		enable_memoize = true;
 bool		enable_mergejoin = true;
 bool		enable_hashjoin = true;
+bool		enable_partitionwise_join = false;
+bool		enable_partitionwise_aggregate = false;
 
 typedef struct
 {
@@ -130,6 +135,8 @@ static MergeScanSelCache *cached_scansel(PlannerInfo *root,
 			   PathKey *pathkey);
 static void cost_rescan(PlannerInfo *root, Path *path,
 			Cost *rescan_startup_cost, Cost *rescan_total_cost);
+static void cost_memoize_rescan(PlannerInfo *root, MemoizePath *mpath,
+					Cost *rescan_startup_cost, Cost *rescan_total_cost);
 static bool cost_qual_eval_walker(Node *node, cost_qual_eval_context *context);
 static void get_restriction_qual_cost(PlannerInfo *root, RelOptInfo *baserel,
 						  ParamPathInfo *param_info,
@@ -2990,6 +2997,10 @@ cost_rescan(PlannerInfo *root, Path *path,
 				*rescan_total_cost = run_cost;
 			}
 			break;
+		case T_Memoize:
+			cost_memoize_rescan(root, (MemoizePath *) path,
+								rescan_startup_cost, rescan_total_cost);
+			break;
 		default:
 			*rescan_startup_cost = path->startup_cost;
 			*rescan_total_cost = path->total_cost;
@@ -2997,6 +3008,80 @@ cost_rescan(PlannerInfo *root, Path *path,
 	}
 }
 
+/*
+ * cost_memoize_rescan
+ *	  Determines the estimated cost of rescanning a Memoize path.
+ *
+ * We estimate how many distinct sets of parameter values the rescans will
+ * use and how many cache entries fit into work_mem, and from those the
+ * fraction of rescans that will be answered from the cache.  A cache hit
+ * costs only the fetching of the cached tuples; a miss costs a rescan of
+ * the subpath plus storing its tuples, and possibly evicting older ones.
+ *
+ * As a side effect, the estimated number of cache entries is stored in the
+ * path, for use by the executor when sizing its hash table.
+ */
+static void
+cost_memoize_rescan(PlannerInfo *root, MemoizePath *mpath,
+					Cost *rescan_startup_cost, Cost *rescan_total_cost)
+{
+	Path	   *subpath = mpath->subpath;
+	double		tuples = mpath->subpath->rows;
+	double		calls = Max(mpath->calls, 1.0);
+	int			nkeys = list_length(mpath->param_exprs);
+	double		est_entry_bytes;
+	double		est_cache_entries;
+	double		ndistinct;
+	double		evict_ratio;
+	double		hit_ratio;
+	Cost		sub_startup_cost;
+	Cost		sub_total_cost;
+	Cost		startup_cost;
+	Cost		total_cost;
+
+	/* Estimate the size of one cache entry and how many of them fit */
+	est_entry_bytes = relation_byte_size(tuples, subpath->parent->width) +
+		ExecEstimateCacheEntryOverheadBytes(tuples);
+	est_cache_entries = floor(work_mem * 1024.0 / est_entry_bytes);
+
+	/* Estimate the number of distinct parameter values we'll see */
+	ndistinct = estimate_num_groups(root, mpath->param_exprs, calls, NULL);
+	ndistinct = clamp_row_est(Min(ndistinct, calls));
+
+	mpath->est_entries = (uint32) Min(Min(ndistinct, est_cache_entries),
+									  PG_UINT32_MAX);
+
+	/*
+	 * If not all the entries fit, a fraction of them has to be evicted to
+	 * make room for new ones.  Assume that the lookups are evenly spread
+	 * over the parameter values; then only the fraction of lookups hitting
+	 * a value that is still cached is a hit, and the first lookup of each
+	 * value is always a miss.
+	 */
+	evict_ratio = 1.0 - Min(est_cache_entries, ndistinct) / ndistinct;
+	hit_ratio = ((calls - ndistinct) / calls) *
+		(est_cache_entries / Max(ndistinct, est_cache_entries));
+	hit_ratio = Max(hit_ratio, 0.0);
+
+	/* A miss costs whatever rescanning the subpath costs */
+	cost_rescan(root, subpath, &sub_startup_cost, &sub_total_cost);
+
+	/* Charge the hash lookup on every rescan */
+	startup_cost = sub_startup_cost * (1.0 - hit_ratio) +
+		cpu_operator_cost * nkeys;
+	total_cost = sub_total_cost * (1.0 - hit_ratio) +
+		cpu_operator_cost * nkeys;
+
+	/* Each tuple is either returned from the cache or stored into it */
+	total_cost += cpu_tuple_cost * tuples;
+
+	/* And evicting entries to make room for new ones */
+	total_cost += cpu_operator_cost * tuples * evict_ratio;
+
+	*rescan_startup_cost = startup_cost;
+	*rescan_total_cost = total_cost;
+}
+
 
 /*
  * cost_qual_eval
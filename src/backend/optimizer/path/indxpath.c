@@ -130,6 +130,8 @@ static Relids get_bitmap_tree_required_outer(Path *bitmapqual);
 static void find_indexpath_quals(Path *bitmapqual, List **quals, List **preds);
 static int	find_list_position(Node *node, List **nodelist);
 static bool check_index_only(RelOptInfo *rel, IndexOptInfo *index);
+static int	index_skip_prefix(IndexOptInfo *index, List *index_clauses,
+				  List *clause_columns);
 static double get_loop_count(PlannerInfo *root, Index cur_relid, Relids outer_relids);
 static double adjust_rowcount_for_semijoins(PlannerInfo *root,
 							  Index cur_relid,
@@ -463,7 +465,7 @@ consider_index_join_clauses(PlannerInfo *root, RelOptInfo *rel,
 	 * relation itself is also included in the relids set.  considered_relids
 	 * lists all relids sets we've already tried.
 	 */
-	for (indexcol = 0; indexcol < index->ncolumns; indexcol++)
+	for (indexcol = 0; indexcol < index->nkeycolumns; indexcol++)
 	{
 		/* Consider each applicable simple join clause */
 		considered_clauses += list_length(jclauseset->indexclauses[indexcol]);
@@ -617,7 +619,7 @@ get_join_index_paths(PlannerInfo *root, RelOptInfo *rel,
 	/* Identify indexclauses usable with this relids set */
 	MemSet(&clauseset, 0, sizeof(clauseset));
 
-	for (indexcol = 0; indexcol < index->ncolumns; indexcol++)
+	for (indexcol = 0; indexcol < index->nkeycolumns; indexcol++)
 	{
 		ListCell   *lc;
 
@@ -872,6 +874,7 @@ build_index_paths(PlannerInfo *root, RelOptInfo *rel,
 	bool		pathkeys_possibly_useful;
 	bool		index_is_ordered;
 	bool		index_only_scan;
+	int			skip_prefix;
 	int			indexcol;
 
 	/*
@@ -917,7 +920,7 @@ build_index_paths(PlannerInfo *root, RelOptInfo *rel,
 	clause_columns = NIL;
 	found_lower_saop_clause = false;
 	outer_relids = bms_copy(rel->lateral_relids);
-	for (indexcol = 0; indexcol < index->ncolumns; indexcol++)
+	for (indexcol = 0; indexcol < index->nkeycolumns; indexcol++)
 	{
 		ListCell   *lc;
 
@@ -1022,7 +1025,14 @@ build_index_paths(PlannerInfo *root, RelOptInfo *rel,
 					   check_index_only(rel, index));
 
 	/*
-	 * 4. Generate an indexscan path if there are relevant restriction clauses
+	 * 4. Check if a skip scan is possible.  If so, we generate skip scan
+	 * paths in addition to the ordinary ones below, and leave it to add_path
+	 * to keep whichever is cheaper.
+	 */
+	skip_prefix = index_skip_prefix(index, index_clauses, clause_columns);
+
+	/*
+	 * 5. Generate an indexscan path if there are relevant restriction clauses
 	 * in the current clauses, OR the index ordering is potentially useful for
 	 * later merging or final output ordering, OR the index has a useful
 	 * predicate, OR an index-only scan is possible.
@@ -1040,13 +1050,30 @@ build_index_paths(PlannerInfo *root, RelOptInfo *rel,
 								  ForwardScanDirection :
 								  NoMovementScanDirection,
 								  index_only_scan,
+								  0,
 								  outer_relids,
 								  loop_count);
 		result = lappend(result, ipath);
+
+		if (skip_prefix > 0)
+		{
+			ipath = create_index_path(root, index,
+									  index_clauses,
+									  clause_columns,
+									  orderbyclauses,
+									  orderbyclausecols,
+									  useful_pathkeys,
+									  ForwardScanDirection,
+									  index_only_scan,
+									  skip_prefix,
+									  outer_relids,
+									  loop_count);
+			result = lappend(result, ipath);
+		}
 	}
 
 	/*
-	 * 5. If the index is ordered, a backwards scan might be interesting.
+	 * 6. If the index is ordered, a backwards scan might be interesting.
 	 */
 	if (index_is_ordered && pathkeys_possibly_useful)
 	{
@@ -1064,9 +1091,26 @@ build_index_paths(PlannerInfo *root, RelOptInfo *rel,
 									  useful_pathkeys,
 									  BackwardScanDirection,
 									  index_only_scan,
+									  0,
 									  outer_relids,
 									  loop_count);
 			result = lappend(result, ipath);
+
+			if (skip_prefix > 0)
+			{
+				ipath = create_index_path(root, index,
+										  index_clauses,
+										  clause_columns,
+										  NIL,
+										  NIL,
+										  useful_pathkeys,
+										  BackwardScanDirection,
+										  index_only_scan,
+										  skip_prefix,
+										  outer_relids,
+										  loop_count);
+				result = lappend(result, ipath);
+			}
 		}
 	}
 
@@ -1852,6 +1896,48 @@ check_index_only(RelOptInfo *rel, IndexOptInfo *index)
 	return result;
 }
 
+/*
+ * index_skip_prefix
+ *		Determine how many leading index columns a scan with the given index
+ *		clauses could skip over, or zero if a skip scan isn't possible.
+ *
+ * nbtree can visit each distinct value of the leading column in turn when
+ * that column has no clauses but the second one does.  Whether this is
+ * actually cheaper than reading the whole index is for btcostestimate to
+ * say, given the path we build.  ScalarArrayOpExpr clauses are excluded,
+ * since nbtree doesn't combine array keys with skipping.
+ *
+ * index_clauses and clause_columns are as built by build_index_paths.
+ */
+static int
+index_skip_prefix(IndexOptInfo *index, List *index_clauses,
+				  List *clause_columns)
+{
+	bool		found_second = false;
+	ListCell   *lc,
+			   *lcc;
+
+	if (!enable_indexskipscan ||
+		index->relam != BTREE_AM_OID ||
+		index->nkeycolumns < 2)
+		return 0;
+
+	forboth(lc, index_clauses, lcc, clause_columns)
+	{
+		RestrictInfo *rinfo = (RestrictInfo *) lfirst(lc);
+		int			indexcol = lfirst_int(lcc);
+
+		if (indexcol == 0)
+			return 0;
+		if (IsA(rinfo->clause, ScalarArrayOpExpr))
+			return 0;
+		if (indexcol == 1)
+			found_second = true;
+	}
+
+	return found_second ? 1 : 0;
+}
+
 /*
  * get_loop_count
  *		Choose the loop count estimate to use for costing a parameterized path
@@ -2069,7 +2155,7 @@ match_eclass_clauses_to_index(PlannerInfo *root, IndexOptInfo *index,
 	if (!index->rel->has_eclass_joins)
 		return;
 
-	for (indexcol = 0; indexcol < index->ncolumns; indexcol++)
+	for (indexcol = 0; indexcol < index->nkeycolumns; indexcol++)
 	{
 		ec_member_matches_arg arg;
 		List	   *clauses;
@@ -2136,7 +2222,7 @@ match_clause_to_index(IndexOptInfo *index,
 {
 	int			indexcol;
 
-	for (indexcol = 0; indexcol < index->ncolumns; indexcol++)
+	for (indexcol = 0; indexcol < index->nkeycolumns; indexcol++)
 	{
 		if (match_clause_to_indexcol(index,
 									 indexcol,
@@ -2518,7 +2604,7 @@ match_pathkeys_to_index(IndexOptInfo *index, List *pathkeys,
 			 * amcanorderbyop.  We might need different logic in future for
 			 * other implementations.
 			 */
-			for (indexcol = 0; indexcol < index->ncolumns; indexcol++)
+			for (indexcol = 0; indexcol < index->nkeycolumns; indexcol++)
 			{
 				Expr	   *expr;
 
@@ -2890,7 +2976,7 @@ relation_has_unique_index_for(PlannerInfo *root, RelOptInfo *rel,
 		 * Try to find each index column in the lists of conditions.  This is
 		 * O(N^2) or worse, but we expect all the lists to be short.
 		 */
-		for (c = 0; c < ind->ncolumns; c++)
+		for (c = 0; c < ind->nkeycolumns; c++)
 		{
 			bool		matched = false;
 			ListCell   *lc;
@@ -2966,7 +3052,7 @@ relation_has_unique_index_for(PlannerInfo *root, RelOptInfo *rel,
 		}
 
 		/* Matched all columns of this index? */
-		if (c == ind->ncolumns)
+		if (c == ind->nkeycolumns)
 			return true;
 	}
 
@@ -3723,7 +3809,7 @@ adjust_rowcompare_for_index(RowCompareExpr *clause,
 		/*
 		 * The Var side can match any column of the index.
 		 */
-		for (i = 0; i < index->ncolumns; i++)
+		for (i = 0; i < index->nkeycolumns; i++)
 		{
 			if (match_index_to_operand(varop, i, index) &&
 				get_op_opfamily_strategy(expr_op,
@@ -3732,7 +3818,7 @@ adjust_rowcompare_for_index(RowCompareExpr *clause,
 										 lfirst_oid(collids_cell)))
 				break;
 		}
-		if (i >= index->ncolumns)
+		if (i >= index->nkeycolumns)
 			break;				/* no match found */
 
 		/* Add column number to returned list */
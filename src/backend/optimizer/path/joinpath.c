@@ -18,9 +18,13 @@
 
 #include "executor/executor.h"
 #include "foreign/fdwapi.h"
+#include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
 #include "optimizer/cost.h"
 #include "optimizer/pathnode.h"
 #include "optimizer/paths.h"
+#include "utils/lsyscache.h"
+#include "utils/typcache.h"
 
 /* Hook for plugins to get control in add_paths_to_joinrel() */
 set_join_pathlist_hook_type set_join_pathlist_hook = NULL;
@@ -34,6 +38,9 @@ static void sort_inner_and_outer(PlannerInfo *root, RelOptInfo *joinrel,
 static void match_unsorted_outer(PlannerInfo *root, RelOptInfo *joinrel,
 					 RelOptInfo *outerrel, RelOptInfo *innerrel,
 					 JoinType jointype, JoinPathExtraData *extra);
+static Path *get_memoize_path(PlannerInfo *root, RelOptInfo *innerrel,
+				 RelOptInfo *outerrel, Path *inner_path,
+				 Path *outer_path, JoinType jointype);
 static void hash_inner_and_outer(PlannerInfo *root, RelOptInfo *joinrel,
 					 RelOptInfo *outerrel, RelOptInfo *innerrel,
 					 JoinType jointype, JoinPathExtraData *extra);
@@ -885,6 +892,7 @@ match_unsorted_outer(PlannerInfo *root,
 			foreach(lc2, innerrel->cheapest_parameterized_paths)
 			{
 				Path	   *innerpath = (Path *) lfirst(lc2);
+				Path	   *mpath;
 
 				try_nestloop_path(root,
 								  joinrel,
@@ -893,6 +901,21 @@ match_unsorted_outer(PlannerInfo *root,
 								  merge_pathkeys,
 								  jointype,
 								  extra);
+
+				/*
+				 * Also consider caching the results of a parameterized inner
+				 * path across rescans with repeated parameter values.
+				 */
+				mpath = get_memoize_path(root, innerrel, outerrel,
+										 innerpath, outerpath, jointype);
+				if (mpath != NULL)
+					try_nestloop_path(root,
+									  joinrel,
+									  outerpath,
+									  mpath,
+									  merge_pathkeys,
+									  jointype,
+									  extra);
 			}
 
 			/* Also consider materialized form of the cheapest inner path */
@@ -1112,6 +1135,105 @@ match_unsorted_outer(PlannerInfo *root,
 	}
 }
 
+/*
+ * get_memoize_path
+ *	  If possible, make and return a MemoizePath caching the results of
+ *	  'inner_path' for the inner side of a nestloop with 'outer_path'.
+ *	  Returns NULL if memoizing is not possible or not worthwhile.
+ *
+ * The inner path must be parameterized by the outer rel only, and its
+ * results must depend on nothing but the parameter values; then the outer
+ * expressions the parameters are computed from serve as the cache keys.
+ * We insist on each parameterized clause being a hashable equality between
+ * an outer and an inner expression, so that we can hash the keys.
+ */
+static Path *
+get_memoize_path(PlannerInfo *root, RelOptInfo *innerrel,
+				 RelOptInfo *outerrel, Path *inner_path,
+				 Path *outer_path, JoinType jointype)
+{
+	List	   *param_exprs = NIL;
+	List	   *hash_operators = NIL;
+	ListCell   *lc;
+
+	if (!enable_memoize)
+		return NULL;
+
+	/* Caching is pointless unless we expect to rescan the inner side */
+	if (outer_path->rows < 2)
+		return NULL;
+
+	/* The inner path must be parameterized, and by the outer rel only */
+	if (inner_path->param_info == NULL ||
+		inner_path->param_info->ppi_clauses == NIL ||
+		!bms_is_subset(PATH_REQ_OUTER(inner_path), outerrel->relids))
+		return NULL;
+
+	/*
+	 * Semi and anti joins stop scanning the inner side at the first match,
+	 * so the cache entries would hardly ever be complete.
+	 */
+	if (jointype == JOIN_SEMI || jointype == JOIN_ANTI)
+		return NULL;
+
+	/*
+	 * Only plain base relations are handled.  Anything else, or a base rel
+	 * with lateral references, might depend on values other than the
+	 * parameters of its join clauses.
+	 */
+	if (innerrel->reloptkind != RELOPT_BASEREL ||
+		innerrel->lateral_relids != NULL)
+		return NULL;
+
+	/* Volatile restrictions could return different rows on each rescan */
+	foreach(lc, innerrel->baserestrictinfo)
+	{
+		RestrictInfo *rinfo = (RestrictInfo *) lfirst(lc);
+
+		if (contain_volatile_functions((Node *) rinfo->clause))
+			return NULL;
+	}
+
+	foreach(lc, inner_path->param_info->ppi_clauses)
+	{
+		RestrictInfo *rinfo = (RestrictInfo *) lfirst(lc);
+		OpExpr	   *opexpr;
+		Node	   *outer_expr;
+		TypeCacheEntry *typentry;
+
+		if (!is_opclause(rinfo->clause) ||
+			list_length(((OpExpr *) rinfo->clause)->args) != 2)
+			return NULL;
+		opexpr = (OpExpr *) rinfo->clause;
+
+		if (!op_hashjoinable(opexpr->opno,
+							 exprType(linitial(opexpr->args))))
+			return NULL;
+
+		if (bms_is_subset(rinfo->left_relids, outerrel->relids) &&
+			bms_is_subset(rinfo->right_relids, innerrel->relids))
+			outer_expr = (Node *) linitial(opexpr->args);
+		else if (bms_is_subset(rinfo->left_relids, innerrel->relids) &&
+				 bms_is_subset(rinfo->right_relids, outerrel->relids))
+			outer_expr = (Node *) lsecond(opexpr->args);
+		else
+			return NULL;
+
+		/* Hash the key using the equality operator of its own type */
+		typentry = lookup_type_cache(exprType(outer_expr),
+									 TYPECACHE_EQ_OPR);
+		if (!OidIsValid(typentry->eq_opr) ||
+			!op_hashjoinable(typentry->eq_opr, exprType(outer_expr)))
+			return NULL;
+
+		param_exprs = lappend(param_exprs, outer_expr);
+		hash_operators = lappend_oid(hash_operators, typentry->eq_opr);
+	}
+
+	return (Path *) create_memoize_path(innerrel, inner_path, param_exprs,
+										hash_operators, outer_path->rows);
+}
+
 /*
  * hash_inner_and_outer
  *	  Create hashjoin join paths by explicitly hashing both the outer and
@@ -14,12 +14,27 @@
  */
 #include "postgres.h"
 
+#include "access/heapam.h"
+#include "access/nbtree.h"
+#include "catalog/partition.h"
+#include "optimizer/clauses.h"
+#include "optimizer/cost.h"
 #include "optimizer/joininfo.h"
 #include "optimizer/pathnode.h"
 #include "optimizer/paths.h"
+#include "optimizer/prep.h"
+#include "parser/parsetree.h"
 #include "utils/memutils.h"
 
 
+/* A rel's path lists, as saved by hide_parameterized_paths */
+typedef struct SavedRelPaths
+{
+	List	   *pathlist;
+	List	   *cheapest_parameterized_paths;
+	Path	   *cheapest_unique_path;
+} SavedRelPaths;
+
 static void make_rels_by_clause_joins(PlannerInfo *root,
 						  RelOptInfo *old_rel,
 						  ListCell *other_rels);
@@ -32,6 +47,17 @@ static bool is_dummy_rel(RelOptInfo *rel);
 static void mark_dummy_rel(RelOptInfo *rel);
 static bool restriction_is_constant_false(List *restrictlist,
 							  bool only_pushed_down);
+static void try_partitionwise_join(PlannerInfo *root, RelOptInfo *rel1,
+					   RelOptInfo *rel2, RelOptInfo *joinrel,
+					   SpecialJoinInfo *sjinfo, List *restrictlist);
+static bool have_partkey_equijoin(PlannerInfo *root,
+					  RelOptInfo *rel1, PartitionKey key1,
+					  RelOptInfo *rel2, PartitionKey key2,
+					  JoinType jointype, List *restrictlist);
+static RelOptInfo *get_partition_child_rel(PlannerInfo *root,
+						AppendRelInfo *appinfo);
+static bool hide_parameterized_paths(RelOptInfo *rel, SavedRelPaths *saved);
+static void restore_rel_paths(RelOptInfo *rel, SavedRelPaths *saved);
 
 
 /*
@@ -792,11 +818,348 @@ make_join_rel(PlannerInfo *root, RelOptInfo *rel1, RelOptInfo *rel2)
 			break;
 	}
 
+	/* Also consider joining matching partitions separately */
+	if (!is_dummy_rel(joinrel))
+		try_partitionwise_join(root, rel1, rel2, joinrel, sjinfo,
+							   restrictlist);
+
 	bms_free(joinrelids);
 
 	return joinrel;
 }
 
+/*
+ * try_partitionwise_join
+ *	  If rel1 and rel2 are tables partitioned the same way, and the join
+ *	  requires their partition keys to be equal, add to joinrel a path that
+ *	  appends the joins of each pair of matching partitions.
+ *
+ * Rows with equal keys are always found in partitions with the same bounds,
+ * so the join of the tables is the union of the joins of the partitions.
+ * Each of those is much smaller than the whole join, so its hash table or
+ * sort is likelier to fit in work_mem, and each can use whatever join
+ * method suits the partitions involved.
+ *
+ * For now, we only do this for joins of two partitioned base relations,
+ * neither of which has partitions that are partitioned themselves, and the
+ * partition joins are only planned with unparameterized input paths.
+ */
+static void
+try_partitionwise_join(PlannerInfo *root, RelOptInfo *rel1, RelOptInfo *rel2,
+					   RelOptInfo *joinrel, SpecialJoinInfo *sjinfo,
+					   List *restrictlist)
+{
+	RangeTblEntry *rte1;
+	RangeTblEntry *rte2;
+	Relation	prel1;
+	Relation	prel2;
+	AppendRelInfo **appinfos1 = NULL;
+	AppendRelInfo **appinfos2 = NULL;
+	RelOptInfo **children1;
+	RelOptInfo **children2;
+	List	   *subpaths = NIL;
+	bool		match;
+	int			nparts;
+	int			i;
+
+	if (!enable_partitionwise_join)
+		return;
+
+	if (rel1->reloptkind != RELOPT_BASEREL ||
+		rel2->reloptkind != RELOPT_BASEREL)
+		return;
+	rte1 = planner_rt_fetch(rel1->relid, root);
+	rte2 = planner_rt_fetch(rel2->relid, root);
+	if (rte1->rtekind != RTE_RELATION || !rte1->inh ||
+		rte2->rtekind != RTE_RELATION || !rte2->inh)
+		return;
+
+	/*
+	 * Lateral references, placeholders and row marks would all need to be
+	 * translated to the partitions as well; don't bother.
+	 */
+	if (rel1->lateral_relids || rel2->lateral_relids ||
+		root->placeholder_list != NIL || root->rowMarks != NIL)
+		return;
+
+	/* The planner already locked the tables */
+	prel1 = heap_open(rte1->relid, NoLock);
+	prel2 = heap_open(rte2->relid, NoLock);
+
+	match = (partition_bounds_equal(prel1, prel2) &&
+			 have_partkey_equijoin(root,
+								   rel1, RelationGetPartitionKey(prel1),
+								   rel2, RelationGetPartitionKey(prel2),
+								   sjinfo->jointype, restrictlist));
+	if (match)
+	{
+		appinfos1 = find_partition_appinfos(root, prel1, rel1->relid);
+		appinfos2 = find_partition_appinfos(root, prel2, rel2->relid);
+	}
+	nparts = RelationGetPartitionDesc(prel1)->nparts;
+
+	heap_close(prel1, NoLock);
+	heap_close(prel2, NoLock);
+
+	if (appinfos1 == NULL || appinfos2 == NULL)
+		return;
+
+	/*
+	 * Pair up the partitions.  A partition that was pruned from the scan, or
+	 * proven empty, has nothing to join; if it's on the nullable side of an
+	 * outer join, though, its partner's rows must still be null-extended,
+	 * which we could only do by joining with a dummy rel.  We just give up
+	 * in that case.
+	 */
+	children1 = (RelOptInfo **) palloc(nparts * sizeof(RelOptInfo *));
+	children2 = (RelOptInfo **) palloc(nparts * sizeof(RelOptInfo *));
+	for (i = 0; i < nparts; i++)
+	{
+		children1[i] = get_partition_child_rel(root, appinfos1[i]);
+		children2[i] = get_partition_child_rel(root, appinfos2[i]);
+
+		switch (sjinfo->jointype)
+		{
+			case JOIN_INNER:
+			case JOIN_SEMI:
+				break;
+			case JOIN_LEFT:
+			case JOIN_ANTI:
+				if (children1[i] != NULL && children2[i] == NULL)
+					return;
+				break;
+			case JOIN_FULL:
+				if ((children1[i] == NULL) != (children2[i] == NULL))
+					return;
+				break;
+			default:
+				/* other values not expected here */
+				elog(ERROR, "unrecognized join type: %d",
+					 (int) sjinfo->jointype);
+				break;
+		}
+	}
+
+	for (i = 0; i < nparts; i++)
+	{
+		RelOptInfo *child1 = children1[i];
+		RelOptInfo *child2 = children2[i];
+		List	   *appinfos;
+		List	   *child_restrictlist;
+		SpecialJoinInfo *child_sjinfo;
+		RelOptInfo *child_joinrel;
+		SavedRelPaths saved1;
+		SavedRelPaths saved2;
+
+		if (child1 == NULL || child2 == NULL)
+			continue;
+
+		appinfos = list_make2(appinfos1[i], appinfos2[i]);
+		child_restrictlist = (List *)
+			adjust_appendrel_attrs_multiple(root, (Node *) restrictlist,
+											appinfos);
+
+		/*
+		 * The sides of the parent join are exactly rel1 and rel2, so those of
+		 * the child join are exactly the partitions.
+		 */
+		child_sjinfo = makeNode(SpecialJoinInfo);
+		memcpy(child_sjinfo, sjinfo, sizeof(SpecialJoinInfo));
+		child_sjinfo->min_lefthand = child1->relids;
+		child_sjinfo->min_righthand = child2->relids;
+		child_sjinfo->syn_lefthand = child1->relids;
+		child_sjinfo->syn_righthand = child2->relids;
+		child_sjinfo->semi_rhs_exprs = (List *)
+			adjust_appendrel_attrs_multiple(root,
+											(Node *) sjinfo->semi_rhs_exprs,
+											appinfos);
+
+		child_joinrel = build_child_join_rel(root, joinrel, child1, child2,
+											 appinfos, child_sjinfo,
+											 child_restrictlist);
+
+		if (!hide_parameterized_paths(child1, &saved1))
+			return;
+		if (!hide_parameterized_paths(child2, &saved2))
+		{
+			restore_rel_paths(child1, &saved1);
+			return;
+		}
+
+		switch (sjinfo->jointype)
+		{
+			case JOIN_INNER:
+				add_paths_to_joinrel(root, child_joinrel, child1, child2,
+									 JOIN_INNER, child_sjinfo,
+									 child_restrictlist);
+				add_paths_to_joinrel(root, child_joinrel, child2, child1,
+									 JOIN_INNER, child_sjinfo,
+									 child_restrictlist);
+				break;
+			case JOIN_LEFT:
+				add_paths_to_joinrel(root, child_joinrel, child1, child2,
+									 JOIN_LEFT, child_sjinfo,
+									 child_restrictlist);
+				add_paths_to_joinrel(root, child_joinrel, child2, child1,
+									 JOIN_RIGHT, child_sjinfo,
+									 child_restrictlist);
+				break;
+			case JOIN_FULL:
+				add_paths_to_joinrel(root, child_joinrel, child1, child2,
+									 JOIN_FULL, child_sjinfo,
+									 child_restrictlist);
+				add_paths_to_joinrel(root, child_joinrel, child2, child1,
+									 JOIN_FULL, child_sjinfo,
+									 child_restrictlist);
+				break;
+			case JOIN_SEMI:
+				add_paths_to_joinrel(root, child_joinrel, child1, child2,
+									 JOIN_SEMI, child_sjinfo,
+									 child_restrictlist);
+				break;
+			case JOIN_ANTI:
+				add_paths_to_joinrel(root, child_joinrel, child1, child2,
+									 JOIN_ANTI, child_sjinfo,
+									 child_restrictlist);
+				break;
+			default:
+				/* other values not expected here */
+				elog(ERROR, "unrecognized join type: %d",
+					 (int) sjinfo->jointype);
+				break;
+		}
+
+		restore_rel_paths(child1, &saved1);
+		restore_rel_paths(child2, &saved2);
+
+		/* A FULL JOIN might not have produced any path; give up then */
+		if (child_joinrel->pathlist == NIL)
+			return;
+		set_cheapest(child_joinrel);
+
+		subpaths = lappend(subpaths, child_joinrel->cheapest_total_path);
+	}
+
+	add_path(joinrel, (Path *) create_append_path(joinrel, subpaths, NULL));
+}
+
+/*
+ * have_partkey_equijoin
+ *	  Does the join's restrictlist require the partition keys of rel1 and
+ *	  rel2 to be equal, using the equality operator of their operator family?
+ *
+ * For an outer join, only the join's own clauses count: a pushed-down
+ * clause doesn't keep unmatched rows from being null-extended.
+ */
+static bool
+have_partkey_equijoin(PlannerInfo *root,
+					  RelOptInfo *rel1, PartitionKey key1,
+					  RelOptInfo *rel2, PartitionKey key2,
+					  JoinType jointype, List *restrictlist)
+{
+	ListCell   *lc;
+
+	foreach(lc, restrictlist)
+	{
+		RestrictInfo *rinfo = (RestrictInfo *) lfirst(lc);
+		OpExpr	   *opexpr;
+		Node	   *other;
+		StrategyNumber strategy;
+
+		if (IS_OUTER_JOIN(jointype) && rinfo->is_pushed_down)
+			continue;
+		if (!is_opclause(rinfo->clause) ||
+			list_length(((OpExpr *) rinfo->clause)->args) != 2)
+			continue;
+		opexpr = (OpExpr *) rinfo->clause;
+
+		if (!match_partition_key_clause(key1, rel1->relid,
+										opexpr->opno, opexpr->inputcollid,
+										linitial(opexpr->args),
+										lsecond(opexpr->args),
+										&other, &strategy) ||
+			strategy != BTEqualStrategyNumber)
+			continue;
+
+		/* The other side must be rel2's key */
+		while (other && IsA(other, RelabelType))
+			other = (Node *) ((RelabelType *) other)->arg;
+		if (other != NULL && IsA(other, Var) &&
+			((Var *) other)->varno == rel2->relid &&
+			((Var *) other)->varattno == key2->partattr &&
+			((Var *) other)->varlevelsup == 0)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Get the RelOptInfo of the partition described by 'appinfo', or NULL if
+ * there is none or it's proven empty.
+ */
+static RelOptInfo *
+get_partition_child_rel(PlannerInfo *root, AppendRelInfo *appinfo)
+{
+	RelOptInfo *rel;
+
+	if (appinfo == NULL)
+		return NULL;
+	rel = find_base_rel(root, appinfo->child_relid);
+	if (is_dummy_rel(rel))
+		return NULL;
+	return rel;
+}
+
+/*
+ * Leave a partition's rel with only its unparameterized paths, saving its
+ * path lists in *saved, until restore_rel_paths() puts them back.  A
+ * parameterized path of a partition depends on the parent of the other side
+ * of the join, so it's useless for joining partitions.  The paths are hidden
+ * in place, rather than in a copy of the rel, because the join paths built
+ * meanwhile may wrap them in paths of their own rel, such as Materialize.
+ *
+ * Returns false, with nothing changed, if the rel has no unparameterized
+ * path at all.
+ */
+static bool
+hide_parameterized_paths(RelOptInfo *rel, SavedRelPaths *saved)
+{
+	List	   *pathlist = NIL;
+	ListCell   *lc;
+
+	foreach(lc, rel->pathlist)
+	{
+		Path	   *path = (Path *) lfirst(lc);
+
+		if (path->param_info == NULL)
+			pathlist = lappend(pathlist, path);
+	}
+	if (pathlist == NIL || rel->cheapest_total_path->param_info != NULL)
+		return false;
+
+	saved->pathlist = rel->pathlist;
+	saved->cheapest_parameterized_paths = rel->cheapest_parameterized_paths;
+	saved->cheapest_unique_path = rel->cheapest_unique_path;
+
+	rel->pathlist = pathlist;
+	rel->cheapest_parameterized_paths = list_make1(rel->cheapest_total_path);
+	rel->cheapest_unique_path = NULL;
+
+	return true;
+}
+
+/*
+ * Undo hide_parameterized_paths().
+ */
+static void
+restore_rel_paths(RelOptInfo *rel, SavedRelPaths *saved)
+{
+	rel->pathlist = saved->pathlist;
+	rel->cheapest_parameterized_paths = saved->cheapest_parameterized_paths;
+	rel->cheapest_unique_path = saved->cheapest_unique_path;
+}
+
 
 /*
  * have_join_order_restriction
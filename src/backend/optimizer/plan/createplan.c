@@ -19,6 +19,7 @@
 #include <limits.h>
 #include <math.h>
 
+#include "access/heapam.h"
 #include "access/stratnum.h"
 #include "access/sysattr.h"
 #include "catalog/pg_class.h"
@@ -53,8 +54,12 @@ static Plan *create_gating_plan(PlannerInfo *root, Plan *plan, List *quals);
 static Plan *create_join_plan(PlannerInfo *root, JoinPath *best_path);
 static Plan *create_append_plan(PlannerInfo *root, AppendPath *best_path);
 static Plan *create_merge_append_plan(PlannerInfo *root, MergeAppendPath *best_path);
+static PartitionPruneInfo *make_partition_prune_info(PlannerInfo *root,
+						  Path *best_path, List *subpaths);
+static Oid	get_top_partition(Oid relid, Oid rootoid);
 static Result *create_result_plan(PlannerInfo *root, ResultPath *best_path);
 static Material *create_material_plan(PlannerInfo *root, MaterialPath *best_path);
+static Memoize *create_memoize_plan(PlannerInfo *root, MemoizePath *best_path);
 static Plan *create_unique_plan(PlannerInfo *root, UniquePath *best_path);
 static SeqScan *create_seqscan_plan(PlannerInfo *root, Path *best_path,
 					List *tlist, List *scan_clauses);
@@ -107,15 +112,16 @@ static IndexScan *make_indexscan(List *qptlist, List *qpqual, Index scanrelid,
 			   Oid indexid, List *indexqual, List *indexqualorig,
 			   List *indexorderby, List *indexorderbyorig,
 			   List *indexorderbyops,
-			   ScanDirection indexscandir);
+			   ScanDirection indexscandir, int indexskipprefix);
 static IndexOnlyScan *make_indexonlyscan(List *qptlist, List *qpqual,
 				   Index scanrelid, Oid indexid,
 				   List *indexqual, List *indexorderby,
 				   List *indextlist,
-				   ScanDirection indexscandir);
+				   ScanDirection indexscandir, int indexskipprefix);
 static BitmapIndexScan *make_bitmap_indexscan(Index scanrelid, Oid indexid,
 					  List *indexqual,
-					  List *indexqualorig);
+					  List *indexqualorig,
+					  int indexskipprefix);
 static BitmapHeapScan *make_bitmap_heapscan(List *qptlist,
 					 List *qpqual,
 					 Plan *lefttree,
@@ -175,6 +181,8 @@ static EquivalenceMember *find_ec_member_for_tle(EquivalenceClass *ec,
 					   TargetEntry *tle,
 					   Relids relids);
 static Material *make_material(Plan *lefttree);
+static Memoize *make_memoize(Plan *lefttree, Oid *hashoperators,
+			 List *param_exprs, uint32 est_entries);
 
 
 /*
@@ -268,6 +276,10 @@ create_plan_recurse(PlannerInfo *root, Path *best_path)
 			plan = (Plan *) create_material_plan(root,
 												 (MaterialPath *) best_path);
 			break;
+		case T_Memoize:
+			plan = (Plan *) create_memoize_plan(root,
+												(MemoizePath *) best_path);
+			break;
 		case T_Unique:
 			plan = create_unique_plan(root,
 									  (UniquePath *) best_path);
@@ -744,6 +756,10 @@ create_append_plan(PlannerInfo *root, AppendPath *best_path)
 
 	plan = make_append(subplans, tlist);
 
+	plan->part_prune_info = make_partition_prune_info(root,
+													  &best_path->path,
+													  best_path->subpaths);
+
 	return (Plan *) plan;
 }
 
@@ -845,9 +861,167 @@ create_merge_append_plan(PlannerInfo *root, MergeAppendPath *best_path)
 
 	node->mergeplans = subplans;
 
+	node->part_prune_info = make_partition_prune_info(root,
+													  &best_path->path,
+													  best_path->subpaths);
+
 	return (Plan *) node;
 }
 
+/*
+ * make_partition_prune_info
+ *	  Build the run-time partition pruning information for an Append or
+ *	  MergeAppend path scanning a partitioned table, or return NULL if it
+ *	  wouldn't be of use.
+ *
+ * expand_inherited_rtentry() has already pruned the partitions ruled out by
+ * restrictions on the partition key that reduce to constants at plan time.
+ * Here we look for the ones that don't: those comparing the key with
+ * Params, such as the parameters of a generic plan, or with expressions
+ * involving stable functions, like now().  If the path is parameterized,
+ * the join clauses it enforces are candidates too, with the outer
+ * relations' Vars replaced by the nestloop Params that will carry them.
+ */
+static PartitionPruneInfo *
+make_partition_prune_info(PlannerInfo *root, Path *best_path, List *subpaths)
+{
+	RelOptInfo *rel = best_path->parent;
+	RangeTblEntry *rte;
+	Relation	relation;
+	PartitionKey key;
+	List	   *clauses;
+	PartitionPruneInfo *pinfo;
+	ListCell   *lc;
+
+	if (rel->reloptkind != RELOPT_BASEREL || rel->rtekind != RTE_RELATION)
+		return NULL;
+	rte = planner_rt_fetch(rel->relid, root);
+	if (!rte->inh)
+		return NULL;
+
+	clauses = rel->baserestrictinfo;
+	if (best_path->param_info)
+		clauses = list_concat(list_copy(clauses),
+							  best_path->param_info->ppi_clauses);
+	if (clauses == NIL)
+		return NULL;
+
+	/* We assume the relation was already locked by the planner */
+	relation = heap_open(rte->relid, NoLock);
+	key = RelationGetPartitionKey(relation);
+	if (key == NULL)
+	{
+		heap_close(relation, NoLock);
+		return NULL;
+	}
+
+	pinfo = makeNode(PartitionPruneInfo);
+	pinfo->reloid = rte->relid;
+
+	foreach(lc, clauses)
+	{
+		RestrictInfo *rinfo = (RestrictInfo *) lfirst(lc);
+		Expr	   *clause = rinfo->clause;
+		Node	   *leftop;
+		Node	   *rightop;
+		Oid			opno;
+		Oid			inputcollid;
+		bool		isarray;
+		Node	   *other;
+		StrategyNumber strategy;
+
+		if (rinfo->pseudoconstant)
+			continue;
+
+		if (is_opclause(clause) && list_length(((OpExpr *) clause)->args) == 2)
+		{
+			leftop = linitial(((OpExpr *) clause)->args);
+			rightop = lsecond(((OpExpr *) clause)->args);
+			opno = ((OpExpr *) clause)->opno;
+			inputcollid = ((OpExpr *) clause)->inputcollid;
+			isarray = false;
+		}
+		else if (IsA(clause, ScalarArrayOpExpr) &&
+				 ((ScalarArrayOpExpr *) clause)->useOr)
+		{
+			leftop = linitial(((ScalarArrayOpExpr *) clause)->args);
+			rightop = lsecond(((ScalarArrayOpExpr *) clause)->args);
+			opno = ((ScalarArrayOpExpr *) clause)->opno;
+			inputcollid = ((ScalarArrayOpExpr *) clause)->inputcollid;
+			isarray = true;
+		}
+		else
+			continue;
+
+		if (!match_partition_key_clause(key, rel->relid, opno, inputcollid,
+										leftop, rightop, &other, &strategy))
+			continue;
+
+		/* For "key = ANY (array)", the key must be on the left */
+		if (isarray &&
+			(other != rightop || strategy != BTEqualStrategyNumber))
+			continue;
+
+		/* Constants were already used by expand_inherited_rtentry() */
+		if (IsA(other, Const))
+			continue;
+
+		/* The value must be computable before scanning the relation */
+		if (bms_is_member(rel->relid, pull_varnos(other)) ||
+			contain_volatile_functions(other) ||
+			contain_subplans(other))
+			continue;
+
+		other = replace_nestloop_params(root, other);
+
+		if (isarray)
+			pinfo->arrayvalues = lappend(pinfo->arrayvalues, other);
+		else
+		{
+			pinfo->strategies = lappend_int(pinfo->strategies, strategy);
+			pinfo->values = lappend(pinfo->values, other);
+		}
+	}
+
+	heap_close(relation, NoLock);
+
+	if (pinfo->values == NIL && pinfo->arrayvalues == NIL)
+		return NULL;
+
+	foreach(lc, subpaths)
+	{
+		Path	   *subpath = (Path *) lfirst(lc);
+		Oid			childoid;
+
+		childoid = planner_rt_fetch(subpath->parent->relid, root)->relid;
+		pinfo->subpartoids = lappend_oid(pinfo->subpartoids,
+										 get_top_partition(childoid,
+														   rte->relid));
+	}
+
+	return pinfo;
+}
+
+/*
+ * get_top_partition
+ *	  Return the OID of the partition of rootoid that relid is, or is a
+ *	  descendant of, or InvalidOid if there is none.
+ */
+static Oid
+get_top_partition(Oid relid, Oid rootoid)
+{
+	for (;;)
+	{
+		Oid			parent = get_partition_parent(relid);
+
+		if (parent == rootoid)
+			return relid;
+		if (!OidIsValid(parent))
+			return InvalidOid;
+		relid = parent;
+	}
+}
+
 /*
  * create_result_plan
  *	  Create a Result plan for 'best_path'.
@@ -897,6 +1071,48 @@ create_material_plan(PlannerInfo *root, MaterialPath *best_path)
 	return plan;
 }
 
+/*
+ * create_memoize_plan
+ *	  Create a Memoize plan for 'best_path' and (recursively) plans
+ *	  for its subpaths.
+ *
+ *	  Returns a Plan node.
+ */
+static Memoize *
+create_memoize_plan(PlannerInfo *root, MemoizePath *best_path)
+{
+	Memoize    *plan;
+	Plan	   *subplan;
+	List	   *param_exprs;
+	Oid		   *hashoperators;
+	ListCell   *lc;
+	int			i;
+
+	subplan = create_plan_recurse(root, best_path->subpath);
+
+	/* We don't want any excess columns in the cached tuples */
+	disuse_physical_tlist(root, subplan, best_path->subpath);
+
+	/*
+	 * The cache keys refer to outer-relation Vars; replace them with the
+	 * nestloop Params the subplan is computed from.
+	 */
+	param_exprs = (List *) replace_nestloop_params(root,
+											(Node *) best_path->param_exprs);
+
+	hashoperators = (Oid *) palloc(list_length(param_exprs) * sizeof(Oid));
+	i = 0;
+	foreach(lc, best_path->hash_operators)
+		hashoperators[i++] = lfirst_oid(lc);
+
+	plan = make_memoize(subplan, hashoperators, param_exprs,
+						best_path->est_entries);
+
+	copy_path_costsize(&plan->plan, (Path *) best_path);
+
+	return plan;
+}
+
 /*
  * create_unique_plan
  *	  Create a Unique plan for 'best_path' and (recursively) plans
@@ -1365,7 +1581,8 @@ create_indexscan_plan(PlannerInfo *root,
 												fixed_indexquals,
 												fixed_indexorderbys,
 											best_path->indexinfo->indextlist,
-												best_path->indexscandir);
+												best_path->indexscandir,
+												best_path->indexskipprefix);
 	else
 		scan_plan = (Scan *) make_indexscan(tlist,
 											qpqual,
@@ -1376,7 +1593,8 @@ create_indexscan_plan(PlannerInfo *root,
 											fixed_indexorderbys,
 											indexorderbys,
 											indexorderbyops,
-											best_path->indexscandir);
+											best_path->indexscandir,
+											best_path->indexskipprefix);
 
 	copy_path_costsize(&scan_plan->plan, &best_path->path);
 
@@ -1661,7 +1879,8 @@ create_bitmap_subplan(PlannerInfo *root, Path *bitmapqual,
 		plan = (Plan *) make_bitmap_indexscan(iscan->scan.scanrelid,
 											  iscan->indexid,
 											  iscan->indexqual,
-											  iscan->indexqualorig);
+											  iscan->indexqualorig,
+											  iscan->indexskipprefix);
 		plan->startup_cost = 0.0;
 		plan->total_cost = ipath->indextotalcost;
 		plan->plan_rows =
@@ -3451,7 +3670,8 @@ make_indexscan(List *qptlist,
 			   List *indexorderby,
 			   List *indexorderbyorig,
 			   List *indexorderbyops,
-			   ScanDirection indexscandir)
+			   ScanDirection indexscandir,
+			   int indexskipprefix)
 {
 	IndexScan  *node = makeNode(IndexScan);
 	Plan	   *plan = &node->scan.plan;
@@ -3469,6 +3689,7 @@ make_indexscan(List *qptlist,
 	node->indexorderbyorig = indexorderbyorig;
 	node->indexorderbyops = indexorderbyops;
 	node->indexorderdir = indexscandir;
+	node->indexskipprefix = indexskipprefix;
 
 	return node;
 }
@@ -3481,7 +3702,8 @@ make_indexonlyscan(List *qptlist,
 				   List *indexqual,
 				   List *indexorderby,
 				   List *indextlist,
-				   ScanDirection indexscandir)
+				   ScanDirection indexscandir,
+				   int indexskipprefix)
 {
 	IndexOnlyScan *node = makeNode(IndexOnlyScan);
 	Plan	   *plan = &node->scan.plan;
@@ -3497,6 +3719,7 @@ make_indexonlyscan(List *qptlist,
 	node->indexorderby = indexorderby;
 	node->indextlist = indextlist;
 	node->indexorderdir = indexscandir;
+	node->indexskipprefix = indexskipprefix;
 
 	return node;
 }
@@ -3505,7 +3728,8 @@ static BitmapIndexScan *
 make_bitmap_indexscan(Index scanrelid,
 					  Oid indexid,
 					  List *indexqual,
-					  List *indexqualorig)
+					  List *indexqualorig,
+					  int indexskipprefix)
 {
 	BitmapIndexScan *node = makeNode(BitmapIndexScan);
 	Plan	   *plan = &node->scan.plan;
@@ -3519,6 +3743,7 @@ make_bitmap_indexscan(Index scanrelid,
 	node->indexid = indexid;
 	node->indexqual = indexqual;
 	node->indexqualorig = indexqualorig;
+	node->indexskipprefix = indexskipprefix;
 
 	return node;
 }
@@ -3748,6 +3973,7 @@ make_append(List *appendplans, List *tlist)
 	plan->lefttree = NULL;
 	plan->righttree = NULL;
 	node->appendplans = appendplans;
+	node->part_prune_info = NULL;
 
 	return node;
 }
@@ -4448,6 +4674,27 @@ make_material(Plan *lefttree)
 	return node;
 }
 
+static Memoize *
+make_memoize(Plan *lefttree, Oid *hashoperators, List *param_exprs,
+			 uint32 est_entries)
+{
+	Memoize    *node = makeNode(Memoize);
+	Plan	   *plan = &node->plan;
+
+	/* cost should be inserted by caller */
+	plan->targetlist = lefttree->targetlist;
+	plan->qual = NIL;
+	plan->lefttree = lefttree;
+	plan->righttree = NULL;
+
+	node->numKeys = list_length(param_exprs);
+	node->hashOperators = hashoperators;
+	node->param_exprs = param_exprs;
+	node->est_entries = est_entries;
+
+	return node;
+}
+
 /*
  * materialize_finished_plan: stick a Material node atop a completed plan
  *
@@ -5090,6 +5337,7 @@ is_projection_capable_plan(Plan *plan)
 	{
 		case T_Hash:
 		case T_Material:
+		case T_Memoize:
 		case T_Sort:
 		case T_Unique:
 		case T_SetOp:
@@ -18,7 +18,9 @@
 #include <limits.h>
 #include <math.h>
 
+#include "access/heapam.h"
 #include "access/htup_details.h"
+#include "catalog/partition.h"
 #include "executor/executor.h"
 #include "executor/nodeAgg.h"
 #include "foreign/fdwapi.h"
@@ -43,6 +45,7 @@
 #include "parser/parsetree.h"
 #include "parser/parse_agg.h"
 #include "rewrite/rewriteManip.h"
+#include "utils/lsyscache.h"
 #include "utils/rel.h"
 #include "utils/selfuncs.h"
 
@@ -100,6 +103,11 @@ static bool choose_hashed_distinct(PlannerInfo *root,
 					   Cost sorted_startup_cost, Cost sorted_total_cost,
 					   List *sorted_pathkeys,
 					   double dNumDistinctRows);
+static bool grouping_is_partitionwise(PlannerInfo *root, Path *best_path);
+static Plan *make_partitionwise_agg(PlannerInfo *root, List *tlist,
+					   List *sub_tlist, const AggClauseCosts *agg_costs,
+					   int numGroupCols, AttrNumber *groupColIdx,
+					   long numGroups, AppendPath *apath, Append *append);
 static List *make_subplanTargetList(PlannerInfo *root, List *tlist,
 					   AttrNumber **groupColIdx, bool *need_tlist_eval);
 static int	get_grouping_column_index(Query *parse, TargetEntry *tle);
@@ -1733,10 +1741,21 @@ grouping_planner(PlannerInfo *root, double tuple_fraction)
 			 * results.
 			 */
 			bool		need_sort_for_grouping = false;
+			bool		partitionwise_grouping;
 
 			result_plan = create_plan(root, best_path);
 			current_pathkeys = best_path->pathkeys;
 
+			/*
+			 * If the hashed grouping can be done separately for each member
+			 * of an Append, the sub_tlist is applied to each member below.
+			 */
+			partitionwise_grouping = (use_hashed_grouping &&
+									  !parse->groupingSets &&
+									  IsA(result_plan, Append) &&
+									  grouping_is_partitionwise(root,
+																best_path));
+
 			/* Detect if we'll need an explicit sort for grouping */
 			if (parse->groupClause && !use_hashed_grouping &&
 			  !pathkeys_contained_in(root->group_pathkeys, current_pathkeys))
@@ -1756,7 +1775,11 @@ grouping_planner(PlannerInfo *root, double tuple_fraction)
 			 * the top plan node.  However, we can skip that if we determined
 			 * that whatever create_plan chose to return will be good enough.
 			 */
-			if (need_tlist_eval)
+			if (partitionwise_grouping)
+			{
+				/* make_partitionwise_agg takes care of it */
+			}
+			else if (need_tlist_eval)
 			{
 				/*
 				 * If the top-level plan node is one that cannot do expression
@@ -1826,7 +1849,21 @@ grouping_planner(PlannerInfo *root, double tuple_fraction)
 			 *
 			 * HAVING clause, if any, becomes qual of the Agg or Group node.
 			 */
-			if (use_hashed_grouping)
+			if (partitionwise_grouping)
+			{
+				/* One hashed aggregate plan per member of the Append */
+				result_plan = make_partitionwise_agg(root,
+													 tlist,
+													 sub_tlist,
+													 &agg_costs,
+													 numGroupCols,
+													 groupColIdx,
+													 numGroups,
+													 (AppendPath *) best_path,
+													 (Append *) result_plan);
+				current_pathkeys = NIL;
+			}
+			else if (use_hashed_grouping)
 			{
 				/* Hashed aggregate plan --- no sort needed */
 				result_plan = (Plan *) make_agg(root,
@@ -3767,6 +3804,185 @@ choose_hashed_distinct(PlannerInfo *root,
 	return false;
 }
 
+/*
+ * grouping_is_partitionwise
+ *	  Can the grouping be done separately for each member of best_path, an
+ *	  Append of the partitions of a partitioned table, or of the joins of
+ *	  matching partitions of two such tables?
+ *
+ * That's so if the GROUP BY clause includes a partition key compared with
+ * the equality operator of its operator family, since all the rows of a
+ * group then come from the same partition.  The key mustn't be nullable by
+ * an outer join, though, else null-extended rows from different partitions
+ * would fall into the same group.
+ */
+static bool
+grouping_is_partitionwise(PlannerInfo *root, Path *best_path)
+{
+	Query	   *parse = root->parse;
+	RelOptInfo *rel = best_path->parent;
+	ListCell   *lc;
+
+	if (!enable_partitionwise_aggregate)
+		return false;
+	if (!IsA(best_path, AppendPath) ||
+		((AppendPath *) best_path)->subpaths == NIL)
+		return false;
+
+	/*
+	 * An Append path for a join can only come from a partition-wise join,
+	 * which has already checked the partitioning of both sides.
+	 */
+	if (rel->reloptkind != RELOPT_BASEREL &&
+		rel->reloptkind != RELOPT_JOINREL)
+		return false;
+
+	/* Subplans in the targetlist or HAVING would be duplicated */
+	if (contain_subplans((Node *) parse->targetList) ||
+		contain_subplans(parse->havingQual))
+		return false;
+
+	foreach(lc, parse->groupClause)
+	{
+		SortGroupClause *sgc = (SortGroupClause *) lfirst(lc);
+		Node	   *expr = get_sortgroupclause_expr(sgc, parse->targetList);
+		Var		   *var;
+		RangeTblEntry *rte;
+		Relation	relation;
+		PartitionKey key;
+		bool		nullable = false;
+		bool		result;
+		ListCell   *lc2;
+
+		while (expr && IsA(expr, RelabelType))
+			expr = (Node *) ((RelabelType *) expr)->arg;
+		if (expr == NULL || !IsA(expr, Var))
+			continue;
+		var = (Var *) expr;
+		if (var->varlevelsup != 0 || !bms_is_member(var->varno, rel->relids))
+			continue;
+
+		foreach(lc2, root->join_info_list)
+		{
+			SpecialJoinInfo *sjinfo = (SpecialJoinInfo *) lfirst(lc2);
+
+			if (bms_is_member(var->varno, sjinfo->syn_righthand) ||
+				(sjinfo->jointype == JOIN_FULL &&
+				 bms_is_member(var->varno, sjinfo->syn_lefthand)))
+				nullable = true;
+		}
+		if (nullable)
+			continue;
+
+		rte = planner_rt_fetch(var->varno, root);
+		if (rte->rtekind != RTE_RELATION || !rte->inh)
+			continue;
+
+		/* The planner already locked the table */
+		relation = heap_open(rte->relid, NoLock);
+		key = RelationGetPartitionKey(relation);
+		result = (key != NULL &&
+				  var->varattno == key->partattr &&
+				  (!OidIsValid(key->partcollation) ||
+				   var->varcollid == key->partcollation) &&
+				  op_in_opfamily(sgc->eqop, key->partopfamily) &&
+				  (rel->reloptkind == RELOPT_JOINREL ||
+				   find_partition_appinfos(root, relation,
+										   var->varno) != NULL));
+		heap_close(relation, NoLock);
+
+		if (result)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * make_partitionwise_agg
+ *	  Build a hashed aggregation plan for each member of 'append', the plan
+ *	  made for 'apath', and return an Append of them.
+ *
+ * Each member is made to compute the sub_tlist and is aggregated with the
+ * query's targetlist and HAVING qual, all translated to refer to the
+ * partitions the member scans.  The members' groups are disjoint, per
+ * grouping_is_partitionwise, so their union is the whole query's result.
+ */
+static Plan *
+make_partitionwise_agg(PlannerInfo *root, List *tlist, List *sub_tlist,
+					   const AggClauseCosts *agg_costs,
+					   int numGroupCols, AttrNumber *groupColIdx,
+					   long numGroups, AppendPath *apath, Append *append)
+{
+	Query	   *parse = root->parse;
+	List	   *aggplans = NIL;
+	double		total_rows = 0;
+	ListCell   *lc;
+	ListCell   *lc2;
+
+	foreach(lc, append->appendplans)
+		total_rows += ((Plan *) lfirst(lc))->plan_rows;
+
+	forboth(lc, apath->subpaths, lc2, append->appendplans)
+	{
+		Path	   *subpath = (Path *) lfirst(lc);
+		Plan	   *subplan = (Plan *) lfirst(lc2);
+		List	   *appinfos = NIL;
+		List	   *child_tlist;
+		List	   *child_sub_tlist;
+		List	   *child_having;
+		double		child_groups;
+		ListCell   *lc3;
+
+		foreach(lc3, root->append_rel_list)
+		{
+			AppendRelInfo *appinfo = (AppendRelInfo *) lfirst(lc3);
+
+			if (bms_is_member(appinfo->child_relid, subpath->parent->relids))
+				appinfos = lappend(appinfos, appinfo);
+		}
+
+		child_tlist = (List *)
+			adjust_appendrel_attrs_multiple(root, (Node *) tlist, appinfos);
+		child_sub_tlist = (List *)
+			adjust_appendrel_attrs_multiple(root, (Node *) sub_tlist,
+											appinfos);
+		child_having = (List *)
+			adjust_appendrel_attrs_multiple(root, parse->havingQual,
+											appinfos);
+
+		/* As in grouping_planner, insert a Result if we can't project */
+		if (!is_projection_capable_plan(subplan) &&
+			!tlist_same_exprs(child_sub_tlist, subplan->targetlist))
+			subplan = (Plan *) make_result(root, child_sub_tlist, NULL,
+										   subplan);
+		else
+			subplan->targetlist = child_sub_tlist;
+		add_tlist_costs_to_plan(root, subplan, child_sub_tlist);
+
+		/* Assume the groups are spread over the members like the rows */
+		child_groups = numGroups;
+		if (total_rows > 0)
+			child_groups = clamp_row_est(numGroups * subplan->plan_rows /
+										 total_rows);
+
+		aggplans = lappend(aggplans,
+						   make_agg(root,
+									child_tlist,
+									child_having,
+									AGG_HASHED,
+									agg_costs,
+									numGroupCols,
+									groupColIdx,
+									extract_grouping_ops(parse->groupClause),
+									NIL,
+									(long) child_groups,
+									subplan));
+	}
+
+	return (Plan *) make_append(aggplans, tlist);
+}
+
 /*
  * make_subplanTargetList
  *	  Generate appropriate target list when grouping is required.
@@ -4548,7 +4764,7 @@ plan_cluster_use_sort(Oid tableOid, Oid indexOid)
 	/* Estimate the cost of index scan */
 	indexScanPath = create_index_path(root, indexInfo,
 									  NIL, NIL, NIL, NIL, NIL,
-									  ForwardScanDirection, false,
+									  ForwardScanDirection, false, 0,
 									  NULL, 1.0);
 
 	return (seqScanAndSortPath.total_cost < indexScanPath->path.total_cost);
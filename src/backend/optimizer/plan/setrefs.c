@@ -105,6 +105,8 @@ static bool fix_scan_expr_walker(Node *node, fix_scan_expr_context *context);
 static void set_join_references(PlannerInfo *root, Join *join, int rtoffset);
 static void set_upper_references(PlannerInfo *root, Plan *plan, int rtoffset);
 static void set_dummy_tlist_references(Plan *plan, int rtoffset);
+static void fix_partition_prune_info(PlannerInfo *root,
+						 PartitionPruneInfo *pinfo, int rtoffset);
 static indexed_tlist *build_tlist_index(List *tlist);
 static Var *search_indexed_tlist_for_var(Var *var,
 							 indexed_tlist *itlist,
@@ -614,6 +616,22 @@ set_plan_refs(PlannerInfo *root, Plan *plan, int rtoffset)
 			 */
 			Assert(plan->qual == NIL);
 			break;
+		case T_Memoize:
+			{
+				Memoize    *mplan = (Memoize *) plan;
+
+				/*
+				 * Like Material, Memoize doesn't evaluate its tlist or quals.
+				 * But its cache keys are expressions over the nestloop
+				 * Params, which need the usual scan-level fixing.
+				 */
+				set_dummy_tlist_references(plan, rtoffset);
+				Assert(plan->qual == NIL);
+
+				mplan->param_exprs =
+					fix_scan_list(root, mplan->param_exprs, rtoffset);
+			}
+			break;
 		case T_LockRows:
 			{
 				LockRows   *splan = (LockRows *) plan;
@@ -829,6 +847,9 @@ set_plan_refs(PlannerInfo *root, Plan *plan, int rtoffset)
 											  (Plan *) lfirst(l),
 											  rtoffset);
 				}
+				if (splan->part_prune_info)
+					fix_partition_prune_info(root, splan->part_prune_info,
+											 rtoffset);
 			}
 			break;
 		case T_MergeAppend:
@@ -847,6 +868,9 @@ set_plan_refs(PlannerInfo *root, Plan *plan, int rtoffset)
 											  (Plan *) lfirst(l),
 											  rtoffset);
 				}
+				if (splan->part_prune_info)
+					fix_partition_prune_info(root, splan->part_prune_info,
+											 rtoffset);
 			}
 			break;
 		case T_RecursiveUnion:
@@ -1641,6 +1665,24 @@ set_upper_references(PlannerInfo *root, Plan *plan, int rtoffset)
 	pfree(subplan_itlist);
 }
 
+/*
+ * fix_partition_prune_info
+ *	  Finish up the comparison values of an Append's or MergeAppend's
+ *	  run-time partition pruning information.
+ *
+ * The values contain no Vars, but fix_scan_expr still has to look up
+ * operator functions and record plan dependencies for us.
+ */
+static void
+fix_partition_prune_info(PlannerInfo *root, PartitionPruneInfo *pinfo,
+						 int rtoffset)
+{
+	pinfo->values = (List *)
+		fix_scan_expr(root, (Node *) pinfo->values, rtoffset);
+	pinfo->arrayvalues = (List *)
+		fix_scan_expr(root, (Node *) pinfo->arrayvalues, rtoffset);
+}
+
 /*
  * set_dummy_tlist_references
  *	  Replace the targetlist of an upper-level plan node with a simple
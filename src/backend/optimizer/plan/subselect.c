@@ -2410,6 +2410,7 @@ finalize_plan(PlannerInfo *root, Plan *plan, Bitmapset *valid_params,
 
 		case T_Append:
 			{
+				PartitionPruneInfo *pinfo = ((Append *) plan)->part_prune_info;
 				ListCell   *l;
 
 				foreach(l, ((Append *) plan)->appendplans)
@@ -2421,11 +2422,17 @@ finalize_plan(PlannerInfo *root, Plan *plan, Bitmapset *valid_params,
 													  valid_params,
 													  scan_params));
 				}
+				if (pinfo)
+				{
+					finalize_primnode((Node *) pinfo->values, &context);
+					finalize_primnode((Node *) pinfo->arrayvalues, &context);
+				}
 			}
 			break;
 
 		case T_MergeAppend:
 			{
+				PartitionPruneInfo *pinfo = ((MergeAppend *) plan)->part_prune_info;
 				ListCell   *l;
 
 				foreach(l, ((MergeAppend *) plan)->mergeplans)
@@ -2437,6 +2444,11 @@ finalize_plan(PlannerInfo *root, Plan *plan, Bitmapset *valid_params,
 													  valid_params,
 													  scan_params));
 				}
+				if (pinfo)
+				{
+					finalize_primnode((Node *) pinfo->values, &context);
+					finalize_primnode((Node *) pinfo->arrayvalues, &context);
+				}
 			}
 			break;
 
@@ -2527,6 +2539,11 @@ finalize_plan(PlannerInfo *root, Plan *plan, Bitmapset *valid_params,
 										 locally_added_param);
 			break;
 
+		case T_Memoize:
+			finalize_primnode((Node *) ((Memoize *) plan)->param_exprs,
+							  &context);
+			break;
+
 		case T_WindowAgg:
 			finalize_primnode(((WindowAgg *) plan)->startOffset,
 							  &context);
@@ -33,19 +33,24 @@
 #include "access/heapam.h"
 #include "access/htup_details.h"
 #include "access/sysattr.h"
+#include "access/nbtree.h"
+#include "catalog/partition.h"
 #include "catalog/pg_inherits_fn.h"
 #include "catalog/pg_type.h"
 #include "miscadmin.h"
 #include "nodes/makefuncs.h"
 #include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
 #include "optimizer/cost.h"
 #include "optimizer/pathnode.h"
 #include "optimizer/planmain.h"
 #include "optimizer/planner.h"
 #include "optimizer/prep.h"
 #include "optimizer/tlist.h"
+#include "optimizer/var.h"
 #include "parser/parse_coerce.h"
 #include "parser/parsetree.h"
+#include "utils/array.h"
 #include "utils/lsyscache.h"
 #include "utils/rel.h"
 #include "utils/selfuncs.h"
@@ -101,6 +106,15 @@ static List *generate_append_tlist(List *colTypes, List *colCollations,
 static List *generate_setop_grouplist(SetOperationStmt *op, List *targetlist);
 static void expand_inherited_rtentry(PlannerInfo *root, RangeTblEntry *rte,
 						 Index rti);
+static List *find_unpruned_partitions(PlannerInfo *root, Relation parent,
+						 Index rti, LOCKMODE lockmode);
+static void collect_partition_quals(Node *jtnode, Index rti, List **quals);
+static void flatten_partition_quals(Node *qual, List **quals);
+static bool match_partition_clause(PlannerInfo *root, PartitionKey key,
+					   Index rti, Oid opno, Oid inputcollid,
+					   Node *leftop, Node *rightop,
+					   PartitionPruneClause *pc);
+static bool is_partition_key_var(Node *node, PartitionKey key, Index rti);
 static void make_inh_translation_list(Relation oldrelation,
 						  Relation newrelation,
 						  Index newvarno,
@@ -1281,16 +1295,30 @@ expand_inherited_rtentry(PlannerInfo *root, RangeTblEntry *rte, Index rti)
 	else
 		lockmode = AccessShareLock;
 
-	/* Scan for all members of inheritance set, acquire needed locks */
-	inhOIDs = find_all_inheritors(parentOID, lockmode, NULL);
+	/*
+	 * Must open the parent relation to examine its tupdesc and partitioning.
+	 * We need not lock it; we assume the rewriter already did.
+	 */
+	oldrelation = heap_open(parentOID, NoLock);
+
+	/*
+	 * Scan for all members of inheritance set, acquire needed locks.  Of a
+	 * partitioned table, only the partitions the query's restrictions don't
+	 * rule out are members.
+	 */
+	if (RelationGetPartitionKey(oldrelation) != NULL)
+		inhOIDs = find_unpruned_partitions(root, oldrelation, rti, lockmode);
+	else
+		inhOIDs = find_all_inheritors(parentOID, lockmode, NULL);
 
 	/*
 	 * Check that there's at least one descendant, else treat as no-child
 	 * case.  This could happen despite above has_subclass() check, if table
-	 * once had a child but no longer does.
+	 * once had a child but no longer does, or if all partitions were pruned.
 	 */
 	if (list_length(inhOIDs) < 2)
 	{
+		heap_close(oldrelation, NoLock);
 		/* Clear flag before returning */
 		rte->inh = false;
 		return;
@@ -1304,12 +1332,6 @@ expand_inherited_rtentry(PlannerInfo *root, RangeTblEntry *rte, Index rti)
 	if (oldrc)
 		oldrc->isParent = true;
 
-	/*
-	 * Must open the parent relation to examine its tupdesc.  We need not lock
-	 * it; we assume the rewriter already did.
-	 */
-	oldrelation = heap_open(parentOID, NoLock);
-
 	/* Scan the inheritance set and expand it */
 	appinfos = NIL;
 	foreach(l, inhOIDs)
@@ -1430,6 +1452,370 @@ expand_inherited_rtentry(PlannerInfo *root, RangeTblEntry *rte, Index rti)
 	root->append_rel_list = list_concat(root->append_rel_list, appinfos);
 }
 
+/*
+ * find_unpruned_partitions
+ *		Return the OIDs of the members of the partitioning hierarchy of
+ *		'parent' that a scan of it, as RT index rti, must visit, after
+ *		locking them; the parent itself comes first.
+ *
+ * Partitions are ruled out using restrictions of the form "key op value" on
+ * the partition key, found among the query's top-level conjunctive quals,
+ * where op belongs to the key's btree operator family and value reduces to
+ * a constant at plan time; "key = ANY (array)" is handled too.  The
+ * remaining partitions are found by binary search over the parent's sorted
+ * bounds, so that pruned partitions are never opened or locked.  Partitions
+ * that are partitioned themselves are not pruned any further.
+ */
+static List *
+find_unpruned_partitions(PlannerInfo *root, Relation parent, Index rti,
+						 LOCKMODE lockmode)
+{
+	PartitionKey key = RelationGetPartitionKey(parent);
+	PartitionDesc pdesc = RelationGetPartitionDesc(parent);
+	List	   *quals = NIL;
+	PartitionPruneClause *clauses;
+	int			nclauses = 0;
+	Bitmapset  *saop_parts = NULL;
+	bool		have_saop = false;
+	Bitmapset  *parts;
+	List	   *result;
+	ListCell   *lc;
+	int			i;
+
+	collect_partition_quals((Node *) root->parse->jointree, rti, &quals);
+
+	clauses = (PartitionPruneClause *)
+		palloc(Max(list_length(quals), 1) * sizeof(PartitionPruneClause));
+
+	foreach(lc, quals)
+	{
+		Node	   *qual = (Node *) lfirst(lc);
+
+		if (IsA(qual, OpExpr) &&
+			list_length(((OpExpr *) qual)->args) == 2)
+		{
+			OpExpr	   *opexpr = (OpExpr *) qual;
+
+			if (match_partition_clause(root, key, rti, opexpr->opno,
+									   opexpr->inputcollid,
+									   linitial(opexpr->args),
+									   lsecond(opexpr->args),
+									   &clauses[nclauses]))
+				nclauses++;
+		}
+		else if (IsA(qual, ScalarArrayOpExpr) &&
+				 ((ScalarArrayOpExpr *) qual)->useOr)
+		{
+			ScalarArrayOpExpr *saop = (ScalarArrayOpExpr *) qual;
+			PartitionPruneClause pc;
+			ArrayType  *arr;
+			int16		elmlen;
+			bool		elmbyval;
+			char		elmalign;
+			Datum	   *elems;
+			bool	   *elemnulls;
+			int			nelems;
+			Bitmapset  *these_parts = NULL;
+
+			/*
+			 * The array, reduced to a constant, stands in for the comparison
+			 * value; only equality is of use.
+			 */
+			if (!is_partition_key_var(linitial(saop->args), key, rti) ||
+				!match_partition_clause(root, key, rti, saop->opno,
+										saop->inputcollid,
+										linitial(saop->args),
+										lsecond(saop->args), &pc) ||
+				pc.strategy != BTEqualStrategyNumber)
+				continue;
+
+			arr = DatumGetArrayTypeP(pc.value);
+			get_typlenbyvalalign(ARR_ELEMTYPE(arr),
+								 &elmlen, &elmbyval, &elmalign);
+			deconstruct_array(arr, ARR_ELEMTYPE(arr),
+							  elmlen, elmbyval, elmalign,
+							  &elems, &elemnulls, &nelems);
+			for (i = 0; i < nelems; i++)
+			{
+				/* "key = NULL" is never true */
+				if (elemnulls[i])
+					continue;
+				pc.value = elems[i];
+				these_parts = bms_add_members(these_parts,
+										get_partitions_for_clauses(parent,
+																   &pc, 1));
+			}
+
+			if (have_saop)
+				saop_parts = bms_int_members(saop_parts, these_parts);
+			else
+				saop_parts = these_parts;
+			have_saop = true;
+		}
+	}
+
+	parts = get_partitions_for_clauses(parent, clauses, nclauses);
+	if (have_saop)
+		parts = bms_int_members(parts, saop_parts);
+
+	result = list_make1_oid(RelationGetRelid(parent));
+	i = -1;
+	while ((i = bms_next_member(parts, i)) >= 0)
+		result = list_concat(result,
+							 find_all_inheritors(pdesc->oids[i], lockmode,
+												 NULL));
+
+	return result;
+}
+
+/*
+ * collect_partition_quals
+ *		Add to *quals the conjuncts of the quals in the join tree that must
+ *		hold for every row of RT index rti that contributes to the result.
+ *
+ * These are the WHERE and inner join quals, plus the quals of outer joins
+ * rti is on the nullable side of: rows of rti failing those could only be
+ * null-extended away.  WHERE quals mentioning rti below the nullable side
+ * of an outer join are usable too, as the btree operators we're interested
+ * in are strict and so reject the null-extended rows anyway.
+ */
+static void
+collect_partition_quals(Node *jtnode, Index rti, List **quals)
+{
+	if (jtnode == NULL)
+		return;
+	if (IsA(jtnode, FromExpr))
+	{
+		FromExpr   *f = (FromExpr *) jtnode;
+		ListCell   *lc;
+
+		flatten_partition_quals(f->quals, quals);
+		foreach(lc, f->fromlist)
+			collect_partition_quals((Node *) lfirst(lc), rti, quals);
+	}
+	else if (IsA(jtnode, JoinExpr))
+	{
+		JoinExpr   *j = (JoinExpr *) jtnode;
+
+		switch (j->jointype)
+		{
+			case JOIN_INNER:
+				flatten_partition_quals(j->quals, quals);
+				break;
+			case JOIN_LEFT:
+			case JOIN_SEMI:
+			case JOIN_ANTI:
+				if (bms_is_member(rti, get_relids_in_jointree(j->rarg, false)))
+					flatten_partition_quals(j->quals, quals);
+				break;
+			case JOIN_RIGHT:
+				if (bms_is_member(rti, get_relids_in_jointree(j->larg, false)))
+					flatten_partition_quals(j->quals, quals);
+				break;
+			default:
+				/* no restriction applies to either side of a FULL join */
+				break;
+		}
+		collect_partition_quals(j->larg, rti, quals);
+		collect_partition_quals(j->rarg, rti, quals);
+	}
+}
+
+/*
+ * Add the conjuncts of a qual, which hasn't been preprocessed yet, to *quals.
+ */
+static void
+flatten_partition_quals(Node *qual, List **quals)
+{
+	if (qual == NULL)
+		return;
+	if (IsA(qual, List))
+	{
+		ListCell   *lc;
+
+		foreach(lc, (List *) qual)
+			flatten_partition_quals((Node *) lfirst(lc), quals);
+	}
+	else if (and_clause(qual))
+		flatten_partition_quals((Node *) ((BoolExpr *) qual)->args, quals);
+	else
+		*quals = lappend(*quals, qual);
+}
+
+/*
+ * match_partition_clause
+ *		Check whether "leftop opno rightop" compares the partition key of
+ *		RT index rti with an expression reducing to a non-null constant at
+ *		plan time, using an operator of the key's operator family.  If so,
+ *		fill in *pc, with the strategy as seen from the key.
+ */
+static bool
+match_partition_clause(PlannerInfo *root, PartitionKey key, Index rti,
+					   Oid opno, Oid inputcollid,
+					   Node *leftop, Node *rightop, PartitionPruneClause *pc)
+{
+	Node	   *other;
+	StrategyNumber strategy;
+
+	if (!match_partition_key_clause(key, rti, opno, inputcollid,
+									leftop, rightop, &other, &strategy))
+		return false;
+
+	if (contain_var_clause(other) || contain_volatile_functions(other))
+		return false;
+	other = eval_const_expressions(root, other);
+	if (!IsA(other, Const) || ((Const *) other)->constisnull)
+		return false;
+
+	pc->strategy = strategy;
+	pc->value = ((Const *) other)->constvalue;
+	return true;
+}
+
+/*
+ * match_partition_key_clause
+ *		Check whether "leftop opno rightop" compares the partition key of
+ *		RT index rti with some other expression, using an operator of the
+ *		key's operator family whose input types are those of the key's
+ *		operator class.  If so, return the other expression in *other and
+ *		the operator's btree strategy, as seen from the key, in *strategy.
+ *
+ * It's up to the caller to check that *other is something it can compute.
+ */
+bool
+match_partition_key_clause(PartitionKey key, Index rti,
+						   Oid opno, Oid inputcollid,
+						   Node *leftop, Node *rightop,
+						   Node **other, StrategyNumber *strategy)
+{
+	bool		commuted;
+	int			op_strategy;
+	Oid			lefttype;
+	Oid			righttype;
+
+	if (is_partition_key_var(leftop, key, rti))
+	{
+		*other = rightop;
+		commuted = false;
+	}
+	else if (is_partition_key_var(rightop, key, rti))
+	{
+		*other = leftop;
+		commuted = true;
+	}
+	else
+		return false;
+
+	/* Partitions are ordered by the key's collation, so it must match */
+	if (OidIsValid(key->partcollation) && inputcollid != key->partcollation)
+		return false;
+
+	if (!op_in_opfamily(opno, key->partopfamily))
+		return false;
+	get_op_opfamily_properties(opno, key->partopfamily, false,
+							   &op_strategy, &lefttype, &righttype);
+	if (lefttype != key->partopcintype || righttype != key->partopcintype)
+		return false;
+
+	if (commuted)
+	{
+		switch (op_strategy)
+		{
+			case BTLessStrategyNumber:
+				op_strategy = BTGreaterStrategyNumber;
+				break;
+			case BTLessEqualStrategyNumber:
+				op_strategy = BTGreaterEqualStrategyNumber;
+				break;
+			case BTGreaterEqualStrategyNumber:
+				op_strategy = BTLessEqualStrategyNumber;
+				break;
+			case BTGreaterStrategyNumber:
+				op_strategy = BTLessStrategyNumber;
+				break;
+		}
+	}
+
+	*strategy = op_strategy;
+	return true;
+}
+
+/*
+ * find_partition_appinfos
+ *		Return an array of the AppendRelInfos of the partitions of 'parent',
+ *		the partitioned table scanned as RT index rti, indexed like its
+ *		PartitionDesc.  Partitions pruned from the scan have NULL entries.
+ *
+ * Returns NULL if some member of the inheritance set is neither the parent
+ * itself nor one of its partitions, which is the case if a partition is
+ * partitioned in turn.  The parent's own member is left out, since a
+ * partitioned table's own storage is always empty.
+ */
+AppendRelInfo **
+find_partition_appinfos(PlannerInfo *root, Relation parent, Index rti)
+{
+	PartitionDesc pdesc = RelationGetPartitionDesc(parent);
+	AppendRelInfo **result;
+	int			next = 0;
+	ListCell   *lc;
+
+	result = (AppendRelInfo **)
+		palloc0(Max(pdesc->nparts, 1) * sizeof(AppendRelInfo *));
+
+	foreach(lc, root->append_rel_list)
+	{
+		AppendRelInfo *appinfo = (AppendRelInfo *) lfirst(lc);
+		Oid			childoid;
+		bool		found = false;
+		int			k;
+
+		if (appinfo->parent_relid != rti)
+			continue;
+		childoid = planner_rt_fetch(appinfo->child_relid, root)->relid;
+		if (childoid == RelationGetRelid(parent))
+			continue;
+
+		/*
+		 * The partitions were expanded in bound order, so look for each one
+		 * starting at the slot of the previous one.
+		 */
+		for (k = 0; k < pdesc->nparts; k++)
+		{
+			int			j = (next + k) % pdesc->nparts;
+
+			if (pdesc->oids[j] == childoid)
+			{
+				result[j] = appinfo;
+				next = j;
+				found = true;
+				break;
+			}
+		}
+		if (!found)
+		{
+			pfree(result);
+			return NULL;
+		}
+	}
+
+	return result;
+}
+
+/*
+ * Is the node a Var for the partition key of RT index rti?
+ */
+static bool
+is_partition_key_var(Node *node, PartitionKey key, Index rti)
+{
+	while (node && IsA(node, RelabelType))
+		node = (Node *) ((RelabelType *) node)->arg;
+
+	return (node != NULL && IsA(node, Var) &&
+			((Var *) node)->varno == rti &&
+			((Var *) node)->varattno == key->partattr &&
+			((Var *) node)->varlevelsup == 0);
+}
+
 /*
  * make_inh_translation_list
  *	  Build the list of translations from parent Vars to child Vars for
@@ -2014,3 +2400,24 @@ adjust_appendrel_attrs_multilevel(PlannerInfo *root, Node *node,
 	/* Now translate for this child */
 	return adjust_appendrel_attrs(root, node, appinfo);
 }
+
+/*
+ * adjust_appendrel_attrs_multiple
+ *	  Apply the Var translations of several AppendRelInfos, each for a
+ *	  different appendrel parent.
+ *
+ * This is used for expressions referencing a join of appendrel parents,
+ * to make them reference the join of one child of each.
+ */
+Node *
+adjust_appendrel_attrs_multiple(PlannerInfo *root, Node *node,
+								List *appinfos)
+{
+	ListCell   *lc;
+
+	foreach(lc, appinfos)
+		node = adjust_appendrel_attrs(root, node,
+									  (AppendRelInfo *) lfirst(lc));
+
+	return node;
+}
@@ -743,6 +743,8 @@ create_samplescan_path(PlannerInfo *root, RelOptInfo *rel, Relids required_outer
  *			for an ordered index, or NoMovementScanDirection for
  *			an unordered index.
  * 'indexonly' is true if an index-only scan is wanted.
+ * 'indexskipprefix' is the number of leading index columns to skip over,
+ *			or zero for an ordinary scan.
  * 'required_outer' is the set of outer relids for a parameterized path.
  * 'loop_count' is the number of repetitions of the indexscan to factor into
  *		estimates of caching behavior.
@@ -759,6 +761,7 @@ create_index_path(PlannerInfo *root,
 				  List *pathkeys,
 				  ScanDirection indexscandir,
 				  bool indexonly,
+				  int indexskipprefix,
 				  Relids required_outer,
 				  double loop_count)
 {
@@ -785,6 +788,7 @@ create_index_path(PlannerInfo *root,
 	pathnode->indexorderbys = indexorderbys;
 	pathnode->indexorderbycols = indexorderbycols;
 	pathnode->indexscandir = indexscandir;
+	pathnode->indexskipprefix = indexskipprefix;
 
 	cost_index(pathnode, root, loop_count);
 
@@ -1089,6 +1093,46 @@ create_material_path(RelOptInfo *rel, Path *subpath)
 	return pathnode;
 }
 
+/*
+ * create_memoize_path
+ *	  Creates a path corresponding to a Memoize plan, returning the pathnode.
+ *
+ * 'param_exprs' are the cache keys, 'hash_operators' their hashable
+ * equality operators, and 'calls' the number of times we expect the path
+ * to be rescanned.  The costs set here are those of a single scan; the
+ * effect of caching is accounted for by cost_rescan().
+ */
+MemoizePath *
+create_memoize_path(RelOptInfo *rel, Path *subpath, List *param_exprs,
+					List *hash_operators, double calls)
+{
+	MemoizePath *pathnode = makeNode(MemoizePath);
+
+	Assert(subpath->parent == rel);
+
+	pathnode->path.pathtype = T_Memoize;
+	pathnode->path.parent = rel;
+	pathnode->path.param_info = subpath->param_info;
+	pathnode->path.pathkeys = subpath->pathkeys;
+
+	pathnode->subpath = subpath;
+	pathnode->hash_operators = hash_operators;
+	pathnode->param_exprs = param_exprs;
+	pathnode->calls = calls;
+	pathnode->est_entries = 0;
+
+	/*
+	 * Add a small charge for caching the first scan's tuples.  We don't know
+	 * yet how often the cache will be hit; that is estimated when the path
+	 * is costed as the inner side of a nestloop.
+	 */
+	pathnode->path.rows = subpath->rows;
+	pathnode->path.startup_cost = subpath->startup_cost + cpu_tuple_cost;
+	pathnode->path.total_cost = subpath->total_cost + cpu_tuple_cost;
+
+	return pathnode;
+}
+
 /*
  * create_unique_path
  *	  Creates a path representing elimination of distinct rows from the
@@ -19,6 +19,7 @@
 #include "optimizer/paths.h"
 #include "optimizer/placeholder.h"
 #include "optimizer/plancat.h"
+#include "optimizer/prep.h"
 #include "optimizer/restrictinfo.h"
 #include "utils/hsearch.h"
 
@@ -115,6 +116,7 @@ build_simple_rel(PlannerInfo *root, int relid, RelOptKind reloptkind)
 	rel->lateral_relids = NULL;
 	rel->lateral_referencers = NULL;
 	rel->indexlist = NIL;
+	rel->statlist = NIL;
 	rel->pages = 0;
 	rel->tuples = 0;
 	rel->allvisfrac = 0;
@@ -378,6 +380,7 @@ build_join_rel(PlannerInfo *root,
 	joinrel->lateral_relids = NULL;
 	joinrel->lateral_referencers = NULL;
 	joinrel->indexlist = NIL;
+	joinrel->statlist = NIL;
 	joinrel->pages = 0;
 	joinrel->tuples = 0;
 	joinrel->allvisfrac = 0;
@@ -720,6 +723,48 @@ build_empty_join_rel(PlannerInfo *root)
 	return joinrel;
 }
 
+/*
+ * build_child_join_rel
+ *	  Build the relation entry for the join of 'outer_rel' and 'inner_rel',
+ *	  appendrel children of the two rels joined by 'parent_joinrel', for a
+ *	  partition-wise join.
+ *
+ * 'appinfos' holds the AppendRelInfos of the two children, and 'sjinfo' and
+ * 'restrictlist' have already been translated to refer to them.  The child
+ * join's targetlist is the parent join's, translated likewise, so that the
+ * child joins can be appended to produce the parent join's rows.
+ *
+ * Unlike build_join_rel, we don't enter the new rel into the query's list
+ * of joinrels: it's only used as a member of a path for 'parent_joinrel'.
+ */
+RelOptInfo *
+build_child_join_rel(PlannerInfo *root, RelOptInfo *parent_joinrel,
+					 RelOptInfo *outer_rel, RelOptInfo *inner_rel,
+					 List *appinfos, SpecialJoinInfo *sjinfo,
+					 List *restrictlist)
+{
+	RelOptInfo *joinrel;
+
+	joinrel = makeNode(RelOptInfo);
+	joinrel->reloptkind = RELOPT_JOINREL;
+	joinrel->relids = bms_union(outer_rel->relids, inner_rel->relids);
+	joinrel->consider_startup = parent_joinrel->consider_startup;
+	joinrel->reltargetlist = (List *)
+		adjust_appendrel_attrs_multiple(root,
+										(Node *) parent_joinrel->reltargetlist,
+										appinfos);
+	joinrel->width = parent_joinrel->width;
+	joinrel->relid = 0;			/* indicates not a baserel */
+	joinrel->rtekind = RTE_JOIN;
+	joinrel->serverid = InvalidOid;
+	joinrel->has_eclass_joins = false;
+
+	set_joinrel_size_estimates(root, joinrel, outer_rel, inner_rel,
+							   sjinfo, restrictlist);
+
+	return joinrel;
+}
+
 
 /*
  * find_childrel_appendrelinfo
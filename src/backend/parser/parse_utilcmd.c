@@ -32,6 +32,7 @@
 #include "catalog/heap.h"
 #include "catalog/index.h"
 #include "catalog/namespace.h"
+#include "catalog/partition.h"
 #include "catalog/pg_collation.h"
 #include "catalog/pg_constraint.h"
 #include "catalog/pg_opclass.h"
@@ -44,8 +45,10 @@
 #include "miscadmin.h"
 #include "nodes/makefuncs.h"
 #include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
 #include "parser/analyze.h"
 #include "parser/parse_clause.h"
+#include "parser/parse_coerce.h"
 #include "parser/parse_collate.h"
 #include "parser/parse_expr.h"
 #include "parser/parse_relation.h"
@@ -108,6 +111,10 @@ static void transformTableLikeClause(CreateStmtContext *cxt,
 						 TableLikeClause *table_like_clause);
 static void transformOfType(CreateStmtContext *cxt,
 				TypeName *ofTypename);
+static PartitionBoundSpec *transformPartitionBound(ParseState *pstate,
+						CreateStmt *stmt);
+static Node *transformPartitionBoundDatum(ParseState *pstate, Node *datum,
+							 PartitionKey key);
 static IndexStmt *generateClonedIndexStmt(CreateStmtContext *cxt,
 						Relation source_idx,
 						const AttrNumber *attmap, int attmap_length);
@@ -240,6 +247,9 @@ transformCreateStmt(CreateStmt *stmt, const char *queryString)
 	if (stmt->ofTypename)
 		transformOfType(&cxt, stmt->ofTypename);
 
+	if (stmt->partbound)
+		stmt->partbound = transformPartitionBound(pstate, stmt);
+
 	/*
 	 * Run through each primary element in the table creation clause. Separate
 	 * column defs from constraints, and do preliminary analysis.
@@ -301,6 +311,124 @@ transformCreateStmt(CreateStmt *stmt, const char *queryString)
 	return result;
 }
 
+/*
+ * transformPartitionBound -
+ *		transform the FOR VALUES clause of CREATE TABLE ... PARTITION OF
+ *
+ * Each bound datum is coerced to the type of the parent's partition key
+ * and reduced to a non-null Const, which is the form stored in pg_partition.
+ * The parent is locked against concurrent addition of partitions here, so
+ * that the new bound can't be made to overlap another one before the new
+ * partition is recorded.
+ */
+static PartitionBoundSpec *
+transformPartitionBound(ParseState *pstate, CreateStmt *stmt)
+{
+	PartitionBoundSpec *spec = stmt->partbound;
+	PartitionBoundSpec *result;
+	RangeVar   *parentrv = (RangeVar *) linitial(stmt->inhRelations);
+	Relation	parent;
+	PartitionKey key;
+	ListCell   *lc;
+
+	parent = heap_openrv(parentrv, AccessExclusiveLock);
+
+	key = RelationGetPartitionKey(parent);
+	if (key == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+				 errmsg("\"%s\" is not partitioned",
+						RelationGetRelationName(parent)),
+				 parser_errposition(pstate, parentrv->location)));
+
+	if (spec->strategy != key->strategy)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+				 errmsg("invalid bound specification for a %s partition",
+						key->strategy == PARTITION_STRATEGY_RANGE ?
+						"range" : "list"),
+				 parser_errposition(pstate, spec->location)));
+
+	result = makeNode(PartitionBoundSpec);
+	result->strategy = spec->strategy;
+	result->location = spec->location;
+
+	if (spec->strategy == PARTITION_STRATEGY_LIST)
+	{
+		foreach(lc, spec->listdatums)
+		{
+			Node	   *datum = (Node *) lfirst(lc);
+
+			if (datum == NULL)
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+						 errmsg("UNBOUNDED is not allowed in a list partition bound"),
+						 parser_errposition(pstate, spec->location)));
+			result->listdatums = lappend(result->listdatums,
+										 transformPartitionBoundDatum(pstate,
+																	  datum,
+																	  key));
+		}
+	}
+	else
+	{
+		if (spec->lowerdatum)
+			result->lowerdatum = transformPartitionBoundDatum(pstate,
+														   spec->lowerdatum,
+															  key);
+		if (spec->upperdatum)
+			result->upperdatum = transformPartitionBoundDatum(pstate,
+														   spec->upperdatum,
+															  key);
+	}
+
+	/* Keep the lock until commit */
+	heap_close(parent, NoLock);
+
+	return result;
+}
+
+/*
+ * transformPartitionBoundDatum -
+ *		coerce one datum of a partition bound to the partition key's type
+ */
+static Node *
+transformPartitionBoundDatum(ParseState *pstate, Node *datum,
+							 PartitionKey key)
+{
+	A_Const    *con = (A_Const *) datum;
+	Node	   *value;
+
+	Assert(IsA(con, A_Const));
+
+	value = (Node *) make_const(pstate, &con->val, con->location);
+	value = coerce_to_target_type(pstate, value, exprType(value),
+								  key->parttype, key->parttypmod,
+								  COERCION_ASSIGNMENT,
+								  COERCE_IMPLICIT_CAST,
+								  -1);
+	if (value == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATATYPE_MISMATCH),
+				 errmsg("partition bound value must be of type %s",
+						format_type_be(key->parttype)),
+				 parser_errposition(pstate, con->location)));
+
+	value = eval_const_expressions(NULL, value);
+	if (!IsA(value, Const))
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+				 errmsg("partition bound value must be a constant"),
+				 parser_errposition(pstate, con->location)));
+	if (((Const *) value)->constisnull)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+				 errmsg("partition bound value cannot be null"),
+				 parser_errposition(pstate, con->location)));
+
+	return value;
+}
+
 /*
  * transformColumnDefinition -
  *		transform a single ColumnDef within CREATE TABLE
@@ -1193,9 +1321,10 @@ generateClonedIndexStmt(CreateStmtContext *cxt, Relation source_idx,
 
 	/* Build the list of IndexElem */
 	index->indexParams = NIL;
+	index->indexIncludingParams = NIL;
 
 	indexpr_item = list_head(indexprs);
-	for (keyno = 0; keyno < idxrec->indnatts; keyno++)
+	for (keyno = 0; keyno < idxrec->indnkeyatts; keyno++)
 	{
 		IndexElem  *iparam;
 		AttrNumber	attnum = idxrec->indkey.values[keyno];
@@ -1282,6 +1411,29 @@ generateClonedIndexStmt(CreateStmtContext *cxt, Relation source_idx,
 		index->indexParams = lappend(index->indexParams, iparam);
 	}
 
+	/* Handle included columns separately; they are always simple columns */
+	for (keyno = idxrec->indnkeyatts; keyno < idxrec->indnatts; keyno++)
+	{
+		IndexElem  *iparam;
+		AttrNumber	attnum = idxrec->indkey.values[keyno];
+
+		if (!AttributeNumberIsValid(attnum))
+			elog(ERROR, "unexpected expression in included column of index %u",
+				 RelationGetRelid(source_idx));
+
+		iparam = makeNode(IndexElem);
+		iparam->name = get_relid_attribute_name(indrelid, attnum);
+		iparam->expr = NULL;
+		iparam->indexcolname = pstrdup(NameStr(attrs[keyno]->attname));
+		iparam->collation = NIL;
+		iparam->opclass = NIL;
+		iparam->ordering = SORTBY_DEFAULT;
+		iparam->nulls_ordering = SORTBY_NULLS_DEFAULT;
+
+		index->indexIncludingParams = lappend(index->indexIncludingParams,
+											  iparam);
+	}
+
 	/* Copy reloptions if any */
 	datum = SysCacheGetAttr(RELOID, ht_idxrel,
 							Anum_pg_class_reloptions, &isnull);
@@ -1473,6 +1625,7 @@ transformIndexConstraints(CreateStmtContext *cxt)
 			IndexStmt  *priorindex = lfirst(k);
 
 			if (equal(index->indexParams, priorindex->indexParams) &&
+				equal(index->indexIncludingParams, priorindex->indexIncludingParams) &&
 				equal(index->whereClause, priorindex->whereClause) &&
 				equal(index->excludeOpNames, priorindex->excludeOpNames) &&
 				strcmp(index->accessMethod, priorindex->accessMethod) == 0 &&
@@ -1640,6 +1793,17 @@ transformIndexConstraint(Constraint *constraint, CreateStmtContext *cxt)
 					 errdetail("Cannot create a primary key or unique constraint using such an index."),
 					 parser_errposition(cxt->pstate, constraint->location)));
 
+		/*
+		 * A constraint's columns can't be distinguished from an index's
+		 * included columns in the catalogs, so reject those too.
+		 */
+		if (index_form->indnkeyatts != index_form->indnatts)
+			ereport(ERROR,
+					(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+					 errmsg("index \"%s\" has included columns", index_name),
+					 errdetail("Cannot create a primary key or unique constraint using such an index."),
+					 parser_errposition(cxt->pstate, constraint->location)));
+
 		/*
 		 * It's probably unsafe to change a deferred index to non-deferred. (A
 		 * non-constraint index couldn't be deferred anyway, so this case
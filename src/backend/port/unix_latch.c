@@ -498,6 +498,148 @@ WaitLatchOrSocket(volatile Latch *latch, int wakeEvents, pgsocket sock,
 	return result;
 }
 
+/*
+ * Like WaitLatchOrSocket, but waits for any of several sockets to become
+ * readable.  On return, ready[i] tells whether socks[i] is readable (or has
+ * hit EOF or an error); WL_SOCKET_READABLE is reported if any of them is.
+ * WL_SOCKET_WRITEABLE is not supported.
+ *
+ * Only available on platforms with poll(2); this is used by the session
+ * pool, which is not supported elsewhere.
+ */
+int
+WaitLatchOrSockets(volatile Latch *latch, int wakeEvents,
+				   pgsocket *socks, bool *ready, int nsocks, long timeout)
+{
+#ifdef HAVE_POLL
+	int			result = 0;
+	int			rc;
+	int			i;
+	instr_time	start_time,
+				cur_time;
+	long		cur_timeout;
+	struct pollfd *pfds;
+	int			nfds;
+
+	Assert(!(wakeEvents & WL_SOCKET_WRITEABLE));
+	Assert(wakeEvents != 0);	/* must have at least one wake event */
+
+	if ((wakeEvents & WL_LATCH_SET) && latch->owner_pid != MyProcPid)
+		elog(ERROR, "cannot wait on a latch owned by another process");
+
+	if (!(wakeEvents & WL_SOCKET_READABLE))
+		nsocks = 0;
+	for (i = 0; i < nsocks; i++)
+		ready[i] = false;
+
+	/* sockets first, then the self-pipe and the postmaster-alive fd */
+	pfds = (struct pollfd *) palloc((nsocks + 2) * sizeof(struct pollfd));
+
+	if (wakeEvents & WL_TIMEOUT)
+	{
+		INSTR_TIME_SET_CURRENT(start_time);
+		Assert(timeout >= 0 && timeout <= INT_MAX);
+		cur_timeout = timeout;
+	}
+	else
+		cur_timeout = -1;
+
+	waiting = true;
+	do
+	{
+		/* See WaitLatchOrSocket for why the pipe is drained first */
+		drainSelfPipe();
+
+		if ((wakeEvents & WL_LATCH_SET) && latch->is_set)
+		{
+			result |= WL_LATCH_SET;
+			break;
+		}
+
+		nfds = 0;
+		for (i = 0; i < nsocks; i++)
+		{
+			pfds[nfds].fd = socks[i];
+			pfds[nfds].events = POLLIN;
+			pfds[nfds].revents = 0;
+			nfds++;
+		}
+
+		pfds[nfds].fd = selfpipe_readfd;
+		pfds[nfds].events = POLLIN;
+		pfds[nfds].revents = 0;
+		nfds++;
+
+		if (wakeEvents & WL_POSTMASTER_DEATH)
+		{
+			pfds[nfds].fd = postmaster_alive_fds[POSTMASTER_FD_WATCH];
+			pfds[nfds].events = POLLIN;
+			pfds[nfds].revents = 0;
+			nfds++;
+		}
+
+		/* Sleep */
+		rc = poll(pfds, nfds, (int) cur_timeout);
+
+		/* Check return code */
+		if (rc < 0)
+		{
+			/* EINTR is okay, otherwise complain */
+			if (errno != EINTR)
+			{
+				waiting = false;
+				ereport(ERROR,
+						(errcode_for_socket_access(),
+						 errmsg("poll() failed: %m")));
+			}
+		}
+		else if (rc == 0)
+		{
+			/* timeout exceeded */
+			if (wakeEvents & WL_TIMEOUT)
+				result |= WL_TIMEOUT;
+		}
+		else
+		{
+			for (i = 0; i < nsocks; i++)
+			{
+				/* data available in socket, or EOF/error condition */
+				if (pfds[i].revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL))
+				{
+					ready[i] = true;
+					result |= WL_SOCKET_READABLE;
+				}
+			}
+
+			if ((wakeEvents & WL_POSTMASTER_DEATH) &&
+				(pfds[nfds - 1].revents & (POLLHUP | POLLIN | POLLERR | POLLNVAL)))
+			{
+				if (!PostmasterIsAlive())
+					result |= WL_POSTMASTER_DEATH;
+			}
+		}
+
+		/* If we're not done, update cur_timeout for next iteration */
+		if (result == 0 && cur_timeout >= 0)
+		{
+			INSTR_TIME_SET_CURRENT(cur_time);
+			INSTR_TIME_SUBTRACT(cur_time, start_time);
+			cur_timeout = timeout - (long) INSTR_TIME_GET_MILLISEC(cur_time);
+			if (cur_timeout < 0)
+				cur_timeout = 0;
+		}
+	} while (result == 0);
+	waiting = false;
+
+	pfree(pfds);
+
+	return result;
+#else
+	elog(ERROR, "waiting on multiple sockets is not supported on this platform");
+	return 0;					/* keep compiler quiet */
+#endif   /* HAVE_POLL */
+}
+
 /*
  * Sets a latch and wakes up anyone waiting on it.
  *
@@ -285,6 +285,17 @@ WaitLatchOrSocket(volatile Latch *latch, int wakeEvents, pgsocket sock,
 	return result;
 }
 
+/*
+ * Session pooling, the only user of this, is not supported on Windows.
+ */
+int
+WaitLatchOrSockets(volatile Latch *latch, int wakeEvents,
+				   pgsocket *socks, bool *ready, int nsocks, long timeout)
+{
+	elog(ERROR, "waiting on multiple sockets is not supported on this platform");
+	return 0;					/* keep compiler quiet */
+}
+
 /*
  * The comments above the unix implementation (unix_latch.c) of this function
  * apply here as well.
@@ -732,7 +732,8 @@ StartBackgroundWorker(void)
  * Register a new background worker while processing shared_preload_libraries.
  *
  * This can only be called in the _PG_init function of a module library
- * that's loaded by shared_preload_libraries; otherwise it has no effect.
+ * that's loaded by shared_preload_libraries, or by the postmaster itself
+ * during startup; otherwise it has no effect.
  */
 void
 RegisterBackgroundWorker(BackgroundWorker *worker)
@@ -744,7 +745,12 @@ RegisterBackgroundWorker(BackgroundWorker *worker)
 		ereport(LOG,
 		 (errmsg("registering background worker \"%s\"", worker->bgw_name)));
 
-	if (!process_shared_preload_libraries_in_progress)
+	/*
+	 * Besides libraries in shared_preload_libraries, the postmaster itself
+	 * registers built-in workers during startup.
+	 */
+	if (!process_shared_preload_libraries_in_progress &&
+		!(IsPostmasterEnvironment && !IsUnderPostmaster))
 	{
 		if (!IsUnderPostmaster)
 			ereport(LOG,
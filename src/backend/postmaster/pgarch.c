@@ -157,9 +157,11 @@ pgarch_start(void)
 			/* Close the postmaster's sockets */
 			ClosePostmasterPorts(false);
 
-			/* Drop our connection to postmaster's shared memory, as well */
+			/*
+			 * Drop our connection to dynamic shared memory.  We stay attached
+			 * to the main segment, where the archiver statistics are kept.
+			 */
 			dsm_detach_all();
-			PGSharedMemoryDetach();
 
 			PgArchiverMain(0, NULL);
 			break;
@@ -248,8 +250,14 @@ PgArchiverMain(int argc, char *argv[])
 static void
 pgarch_exit(SIGNAL_ARGS)
 {
-	/* SIGQUIT means curl up and die ... */
-	exit(1);
+	/*
+	 * SIGQUIT means curl up and die.  We are attached to shared memory,
+	 * which may be corrupted, so don't run the on_shmem_exit callbacks; and
+	 * exit(2) so that the postmaster treats this as a crash, as it does for
+	 * the other auxiliary processes.
+	 */
+	on_exit_reset();
+	exit(2);
 }
 
 /* SIGHUP signal handler for archiver process */
@@ -3,6 +3,11 @@
  *
  *	All the statistics collector stuff hacked up in one big, ugly file.
  *
+ *	Backends accumulate per-table and per-function counts locally and flush
+ *	them in batches into hash tables kept in shared memory, where they are
+ *	visible to every other process at once.  The shared tables are written
+ *	to disk only at shutdown, and loaded again at the next clean startup.
+ *
  *	TODO:	- Separate collector, postmaster and backend stuff
  *			  into different files.
  *
@@ -22,10 +27,6 @@
 #include <fcntl.h>
 #include <sys/param.h>
 #include <sys/time.h>
-#include <sys/socket.h>
-#include <netdb.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
 #include <signal.h>
 #include <time.h>
 
@@ -38,29 +39,25 @@
 #include "access/xact.h"
 #include "catalog/pg_database.h"
 #include "catalog/pg_proc.h"
-#include "lib/ilist.h"
-#include "libpq/ip.h"
 #include "libpq/libpq.h"
-#include "libpq/pqsignal.h"
 #include "mb/pg_wchar.h"
 #include "miscadmin.h"
+#include "nodes/pg_list.h"
 #include "pg_trace.h"
 #include "postmaster/autovacuum.h"
-#include "postmaster/fork_process.h"
 #include "postmaster/postmaster.h"
 #include "storage/proc.h"
 #include "storage/backendid.h"
-#include "storage/dsm.h"
 #include "storage/fd.h"
 #include "storage/ipc.h"
-#include "storage/latch.h"
-#include "storage/pg_shmem.h"
+#include "storage/lwlock.h"
 #include "storage/procsignal.h"
+#include "storage/shmem.h"
 #include "storage/sinvaladt.h"
+#include "storage/spin.h"
 #include "utils/ascii.h"
 #include "utils/guc.h"
 #include "utils/memutils.h"
-#include "utils/ps_status.h"
 #include "utils/rel.h"
 #include "utils/snapmgr.h"
 #include "utils/timestamp.h"
@@ -71,34 +68,37 @@
  * Timer definitions.
  * ----------
  */
-#define PGSTAT_STAT_INTERVAL	500		/* Minimum time between stats file
-										 * updates; in milliseconds. */
-
-#define PGSTAT_RETRY_DELAY		10		/* How long to wait between checks for
-										 * a new file; in milliseconds. */
-
-#define PGSTAT_MAX_WAIT_TIME	10000	/* Maximum time to wait for a stats
-										 * file update; in milliseconds. */
-
-#define PGSTAT_INQ_INTERVAL		640		/* How often to ping the collector for
-										 * a new file; in milliseconds. */
-
-#define PGSTAT_RESTART_INTERVAL 60		/* How often to attempt to restart a
-										 * failed statistics collector; in
-										 * seconds. */
-
-#define PGSTAT_POLL_LOOP_COUNT	(PGSTAT_MAX_WAIT_TIME / PGSTAT_RETRY_DELAY)
-#define PGSTAT_INQ_LOOP_COUNT	(PGSTAT_INQ_INTERVAL / PGSTAT_RETRY_DELAY)
+#define PGSTAT_STAT_INTERVAL	500		/* Minimum time between flushes of a
+										 * backend's counts into shared
+										 * memory; in milliseconds. */
 
 
 /* ----------
- * The initial size hints for the hash tables used in the collector.
+ * The initial size hints for the backend-local hash tables.
  * ----------
  */
 #define PGSTAT_DB_HASH_SIZE		16
 #define PGSTAT_TAB_HASH_SIZE	512
 #define PGSTAT_FUNCTION_HASH_SIZE	512
 
+/* ----------
+ * Sizes of the shared hash tables.  max_stats_entries bounds the number of
+ * tables and indexes tracked; the other two limits are derived from it.
+ * ----------
+ */
+#define PGSTAT_MAX_TAB_ENTRIES	(pgstat_max_entries)
+#define PGSTAT_MAX_FUNC_ENTRIES Max(pgstat_max_entries / 4, 64)
+#define PGSTAT_MAX_DB_ENTRIES	Max(pgstat_max_entries / 64, 64)
+
+/* Minimum time between complaints about a full hash table (in msec) */
+#define PGSTAT_HASH_FULL_REPORT_INTERVAL	60000
+
+/* Indexes of the shared hash tables in the report state arrays below */
+#define PGSTAT_HASH_DB			0
+#define PGSTAT_HASH_TAB			1
+#define PGSTAT_HASH_FUNC		2
+#define PGSTAT_NUM_HASHES		3
+
 
 /* ----------
  * GUC parameters
@@ -108,14 +108,13 @@ bool		pgstat_track_activities = false;
 bool		pgstat_track_counts = false;
 int			pgstat_track_functions = TRACK_FUNC_OFF;
 int			pgstat_track_activity_query_size = 1024;
+int			pgstat_max_entries = 250000;
 
 /* ----------
  * Built from GUC parameter
  * ----------
  */
 char	   *pgstat_stat_directory = NULL;
-char	   *pgstat_stat_filename = NULL;
-char	   *pgstat_stat_tmpname = NULL;
 
 /*
  * BgWriter global statistics counters (unused in other processes).
@@ -125,16 +124,55 @@ char	   *pgstat_stat_tmpname = NULL;
 PgStat_MsgBgWriter BgWriterStats;
 
 /* ----------
- * Local data
+ * Shared-memory data
+ *
+ * Statistics for databases, tables and functions live in three shared hash
+ * tables.  Table and function entries are keyed by database OID plus object
+ * OID; shared relations are filed under database InvalidOid.  The tables are
+ * partitioned, and all three share the NUM_PGSTAT_PARTITIONS LWLocks, chosen
+ * by an entry's hash code.  Updating or reading one entry takes just that
+ * entry's partition lock; scanning a whole table takes all of them, in
+ * partition order.
+ *
+ * The cluster-wide archiver and bgwriter counters are protected by a
+ * spinlock instead, since the archiver has no PGPROC and can't use LWLocks.
+ * So is the state used to rate-limit complaints about full hash tables.
  * ----------
  */
-NON_EXEC_STATIC pgsocket pgStatSock = PGINVALID_SOCKET;
+typedef struct PgStat_ShmemControl
+{
+	slock_t		mutex;			/* protects the following fields */
+	PgStat_ArchiverStats archiverStats;
+	PgStat_GlobalStats globalStats;
+	TimestampTz hashFullReported[PGSTAT_NUM_HASHES];	/* last complaint */
+	int			hashFullDropped[PGSTAT_NUM_HASHES]; /* objects dropped since */
+} PgStat_ShmemControl;
+
+/* Hash key of the table and function hashes */
+typedef struct PgStat_ObjectKey
+{
+	Oid			databaseid;
+	Oid			objectid;
+} PgStat_ObjectKey;
+
+#define PgStatHashPartition(hashcode) \
+	((hashcode) % NUM_PGSTAT_PARTITIONS)
+#define PgStatHashPartitionLock(hashcode) \
+	(&MainLWLockArray[PGSTAT_LWLOCK_OFFSET + \
+		PgStatHashPartition(hashcode)].lock)
+#define PgStatHashPartitionLockByIndex(i) \
+	(&MainLWLockArray[PGSTAT_LWLOCK_OFFSET + (i)].lock)
 
-static struct sockaddr_storage pgStatAddr;
+NON_EXEC_STATIC PgStat_ShmemControl *pgStatShmem = NULL;
 
-static time_t last_pgstat_start_time;
+static HTAB *pgStatSharedDBHash = NULL;
+static HTAB *pgStatSharedTabHash = NULL;
+static HTAB *pgStatSharedFuncHash = NULL;
 
-static bool pgStatRunningInCollector = false;
+/* ----------
+ * Local data
+ * ----------
+ */
 
 /*
  * Structures in which backends store per-table info that's waiting to be
@@ -206,34 +244,24 @@ typedef struct TwoPhasePgStatRecord
 } TwoPhasePgStatRecord;
 
 /*
- * Info about current "snapshot" of stats file
+ * Info about the current transaction's "snapshot" of the shared statistics.
+ * Entries are copied out of shared memory the first time they're asked for,
+ * so that repeated lookups in one transaction return stable values.
  */
 static MemoryContext pgStatLocalContext = NULL;
 static HTAB *pgStatDBHash = NULL;
+static HTAB *pgStatTabHash = NULL;
+static HTAB *pgStatFuncHash = NULL;
 static LocalPgBackendStatus *localBackendStatusTable = NULL;
 static int	localNumBackends = 0;
 
 /*
- * Cluster wide statistics, kept in the stats collector.
- * Contains statistics that are not collected per database
- * or per table.
+ * Snapshot of the cluster wide statistics, which are not collected
+ * per database or per table.
  */
 static PgStat_ArchiverStats archiverStats;
 static PgStat_GlobalStats globalStats;
-
-/* Write request info for each database */
-typedef struct DBWriteRequest
-{
-	Oid			databaseid;		/* OID of the database to write */
-	TimestampTz request_time;	/* timestamp of the last write request */
-	slist_node	next;
-} DBWriteRequest;
-
-/* Latest statistics request times from backends */
-static slist_head last_statrequests = SLIST_STATIC_INIT(last_statrequests);
-
-static volatile bool need_exit = false;
-static volatile bool got_SIGHUP = false;
+static bool globalStatsValid = false;
 
 /*
  * Total time charged to functions so far in the current backend.
@@ -247,27 +275,24 @@ static instr_time total_func_time;
  * Local function forward declarations
  * ----------
  */
-#ifdef EXEC_BACKEND
-static pid_t pgstat_forkexec(void);
-#endif
-
-NON_EXEC_STATIC void PgstatCollectorMain(int argc, char *argv[]) pg_attribute_noreturn();
-static void pgstat_exit(SIGNAL_ARGS);
 static void pgstat_beshutdown_hook(int code, Datum arg);
-static void pgstat_sighup_handler(SIGNAL_ARGS);
-
-static PgStat_StatDBEntry *pgstat_get_db_entry(Oid databaseid, bool create);
-static PgStat_StatTabEntry *pgstat_get_tab_entry(PgStat_StatDBEntry *dbentry,
-					 Oid tableoid, bool create);
-static void pgstat_write_statsfiles(bool permanent, bool allDbs);
-static void pgstat_write_db_statsfile(PgStat_StatDBEntry *dbentry, bool permanent);
-static HTAB *pgstat_read_statsfiles(Oid onlydb, bool permanent, bool deep);
-static void pgstat_read_db_statsfile(Oid databaseid, HTAB *tabhash, HTAB *funchash, bool permanent);
-static void backend_read_statsfile(void);
-static void pgstat_read_current_status(void);
 
-static bool pgstat_write_statsfile_needed(void);
-static bool pgstat_db_requested(Oid databaseid);
+static PgStat_StatDBEntry *pgstat_get_db_entry(Oid databaseid, bool create,
+					LWLock **partitionLock);
+static PgStat_StatTabEntry *pgstat_get_tab_entry(Oid databaseid, Oid tableoid,
+					 bool create, LWLock **partitionLock);
+static PgStat_StatFuncEntry *pgstat_get_func_entry(Oid databaseid,
+					  Oid functionid, bool create, LWLock **partitionLock);
+static void *pgstat_lock_entry(HTAB *htab, const void *key, bool create,
+				  bool *found, LWLock **partitionLock);
+static void pgstat_remove_entry(HTAB *htab, const void *key);
+static void pgstat_remove_db_objects(Oid databaseid);
+static void pgstat_lock_all_partitions(LWLockMode mode);
+static void pgstat_unlock_all_partitions(void);
+static void pgstat_report_hash_full(HTAB *htab, const void *key);
+static bool pgstat_copy_entry(HTAB *htab, const void *key, void *dest,
+				  Size size);
+static void pgstat_read_current_status(void);
 
 static void pgstat_send_tabstat(PgStat_MsgTabstat *tsmsg);
 static void pgstat_send_funcstats(void);
@@ -276,11 +301,11 @@ static HTAB *pgstat_collect_oids(Oid catalogid);
 static PgStat_TableStatus *get_tabstat_entry(Oid rel_id, bool isshared);
 
 static void pgstat_setup_memcxt(void);
+static void pgstat_setup_snapshot(void);
 
 static void pgstat_setheader(PgStat_MsgHdr *hdr, StatMsgType mtype);
 static void pgstat_send(void *msg, int len);
 
-static void pgstat_recv_inquiry(PgStat_MsgInquiry *msg, int len);
 static void pgstat_recv_tabstat(PgStat_MsgTabstat *msg, int len);
 static void pgstat_recv_tabpurge(PgStat_MsgTabpurge *msg, int len);
 static void pgstat_recv_dropdb(PgStat_MsgDropdb *msg, int len);
@@ -304,262 +329,83 @@ static void pgstat_recv_tempfile(PgStat_MsgTempFile *msg, int len);
  */
 
 /* ----------
- * pgstat_init() -
+ * StatsShmemSize() -
  *
- *	Called from postmaster at startup. Create the resources required
- *	by the statistics collector process.  If unable to do so, do not
- *	fail --- better to let the postmaster start with stats collection
- *	disabled.
+ *	Compute the space needed for the shared statistics.
  * ----------
  */
-void
-pgstat_init(void)
+Size
+StatsShmemSize(void)
 {
-	ACCEPT_TYPE_ARG3 alen;
-	struct addrinfo *addrs = NULL,
-			   *addr,
-				hints;
-	int			ret;
-	fd_set		rset;
-	struct timeval tv;
-	char		test_byte;
-	int			sel_res;
-	int			tries = 0;
-
-#define TESTBYTEVAL ((char) 199)
-
-	/*
-	 * This static assertion verifies that we didn't mess up the calculations
-	 * involved in selecting maximum payload sizes for our UDP messages.
-	 * Because the only consequence of overrunning PGSTAT_MAX_MSG_SIZE would
-	 * be silent performance loss from fragmentation, it seems worth having a
-	 * compile-time cross-check that we didn't.
-	 */
-	StaticAssertStmt(sizeof(PgStat_Msg) <= PGSTAT_MAX_MSG_SIZE,
-				   "maximum stats message size exceeds PGSTAT_MAX_MSG_SIZE");
-
-	/*
-	 * Create the UDP socket for sending and receiving statistic messages
-	 */
-	hints.ai_flags = AI_PASSIVE;
-	hints.ai_family = AF_UNSPEC;
-	hints.ai_socktype = SOCK_DGRAM;
-	hints.ai_protocol = 0;
-	hints.ai_addrlen = 0;
-	hints.ai_addr = NULL;
-	hints.ai_canonname = NULL;
-	hints.ai_next = NULL;
-	ret = pg_getaddrinfo_all("localhost", NULL, &hints, &addrs);
-	if (ret || !addrs)
-	{
-		ereport(LOG,
-				(errmsg("could not resolve \"localhost\": %s",
-						gai_strerror(ret))));
-		goto startup_failed;
-	}
-
-	/*
-	 * On some platforms, pg_getaddrinfo_all() may return multiple addresses
-	 * only one of which will actually work (eg, both IPv6 and IPv4 addresses
-	 * when kernel will reject IPv6).  Worse, the failure may occur at the
-	 * bind() or perhaps even connect() stage.  So we must loop through the
-	 * results till we find a working combination. We will generate LOG
-	 * messages, but no error, for bogus combinations.
-	 */
-	for (addr = addrs; addr; addr = addr->ai_next)
-	{
-#ifdef HAVE_UNIX_SOCKETS
-		/* Ignore AF_UNIX sockets, if any are returned. */
-		if (addr->ai_family == AF_UNIX)
-			continue;
-#endif
-
-		if (++tries > 1)
-			ereport(LOG,
-			(errmsg("trying another address for the statistics collector")));
-
-		/*
-		 * Create the socket.
-		 */
-		if ((pgStatSock = socket(addr->ai_family, SOCK_DGRAM, 0)) == PGINVALID_SOCKET)
-		{
-			ereport(LOG,
-					(errcode_for_socket_access(),
-			errmsg("could not create socket for statistics collector: %m")));
-			continue;
-		}
-
-		/*
-		 * Bind it to a kernel assigned port on localhost and get the assigned
-		 * port via getsockname().
-		 */
-		if (bind(pgStatSock, addr->ai_addr, addr->ai_addrlen) < 0)
-		{
-			ereport(LOG,
-					(errcode_for_socket_access(),
-			  errmsg("could not bind socket for statistics collector: %m")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
-
-		alen = sizeof(pgStatAddr);
-		if (getsockname(pgStatSock, (struct sockaddr *) & pgStatAddr, &alen) < 0)
-		{
-			ereport(LOG,
-					(errcode_for_socket_access(),
-					 errmsg("could not get address of socket for statistics collector: %m")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
-
-		/*
-		 * Connect the socket to its own address.  This saves a few cycles by
-		 * not having to respecify the target address on every send. This also
-		 * provides a kernel-level check that only packets from this same
-		 * address will be received.
-		 */
-		if (connect(pgStatSock, (struct sockaddr *) & pgStatAddr, alen) < 0)
-		{
-			ereport(LOG,
-					(errcode_for_socket_access(),
-			errmsg("could not connect socket for statistics collector: %m")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
-
-		/*
-		 * Try to send and receive a one-byte test message on the socket. This
-		 * is to catch situations where the socket can be created but will not
-		 * actually pass data (for instance, because kernel packet filtering
-		 * rules prevent it).
-		 */
-		test_byte = TESTBYTEVAL;
-
-retry1:
-		if (send(pgStatSock, &test_byte, 1, 0) != 1)
-		{
-			if (errno == EINTR)
-				goto retry1;	/* if interrupted, just retry */
-			ereport(LOG,
-					(errcode_for_socket_access(),
-					 errmsg("could not send test message on socket for statistics collector: %m")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
-
-		/*
-		 * There could possibly be a little delay before the message can be
-		 * received.  We arbitrarily allow up to half a second before deciding
-		 * it's broken.
-		 */
-		for (;;)				/* need a loop to handle EINTR */
-		{
-			FD_ZERO(&rset);
-			FD_SET(pgStatSock, &rset);
-
-			tv.tv_sec = 0;
-			tv.tv_usec = 500000;
-			sel_res = select(pgStatSock + 1, &rset, NULL, NULL, &tv);
-			if (sel_res >= 0 || errno != EINTR)
-				break;
-		}
-		if (sel_res < 0)
-		{
-			ereport(LOG,
-					(errcode_for_socket_access(),
-					 errmsg("select() failed in statistics collector: %m")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
-		if (sel_res == 0 || !FD_ISSET(pgStatSock, &rset))
-		{
-			/*
-			 * This is the case we actually think is likely, so take pains to
-			 * give a specific message for it.
-			 *
-			 * errno will not be set meaningfully here, so don't use it.
-			 */
-			ereport(LOG,
-					(errcode(ERRCODE_CONNECTION_FAILURE),
-					 errmsg("test message did not get through on socket for statistics collector")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
-
-		test_byte++;			/* just make sure variable is changed */
+	Size		size;
 
-retry2:
-		if (recv(pgStatSock, &test_byte, 1, 0) != 1)
-		{
-			if (errno == EINTR)
-				goto retry2;	/* if interrupted, just retry */
-			ereport(LOG,
-					(errcode_for_socket_access(),
-					 errmsg("could not receive test message on socket for statistics collector: %m")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
+	size = MAXALIGN(sizeof(PgStat_ShmemControl));
+	size = add_size(size, hash_estimate_size(PGSTAT_MAX_DB_ENTRIES,
+											 sizeof(PgStat_StatDBEntry)));
+	size = add_size(size, hash_estimate_size(PGSTAT_MAX_TAB_ENTRIES,
+											 sizeof(PgStat_StatTabEntry)));
+	size = add_size(size, hash_estimate_size(PGSTAT_MAX_FUNC_ENTRIES,
+											 sizeof(PgStat_StatFuncEntry)));
 
-		if (test_byte != TESTBYTEVAL)	/* strictly paranoia ... */
-		{
-			ereport(LOG,
-					(errcode(ERRCODE_INTERNAL_ERROR),
-					 errmsg("incorrect test message transmission on socket for statistics collector")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
+	return size;
+}
 
-		/* If we get here, we have a working socket */
-		break;
-	}
+/* ----------
+ * StatsShmemInit() -
+ *
+ *	Allocate and initialize the shared statistics, or attach to them if
+ *	they already exist.  The hash tables are of fixed size: when one fills
+ *	up, counts for objects not already in it are simply not kept.
+ * ----------
+ */
+void
+StatsShmemInit(void)
+{
+	HASHCTL		info;
+	bool		found;
 
-	/* Did we find a working address? */
-	if (!addr || pgStatSock == PGINVALID_SOCKET)
-		goto startup_failed;
+	pgStatShmem = (PgStat_ShmemControl *)
+		ShmemInitStruct("Statistics Data", sizeof(PgStat_ShmemControl),
+						&found);
 
-	/*
-	 * Set the socket to non-blocking IO.  This ensures that if the collector
-	 * falls behind, statistics messages will be discarded; backends won't
-	 * block waiting to send messages to the collector.
-	 */
-	if (!pg_set_noblock(pgStatSock))
+	if (!found)
 	{
-		ereport(LOG,
-				(errcode_for_socket_access(),
-				 errmsg("could not set statistics collector socket to nonblocking mode: %m")));
-		goto startup_failed;
-	}
-
-	pg_freeaddrinfo_all(hints.ai_family, addrs);
-
-	return;
+		TimestampTz now = GetCurrentTimestamp();
 
-startup_failed:
-	ereport(LOG,
-	  (errmsg("disabling statistics collector for lack of working socket")));
-
-	if (addrs)
-		pg_freeaddrinfo_all(hints.ai_family, addrs);
-
-	if (pgStatSock != PGINVALID_SOCKET)
-		closesocket(pgStatSock);
-	pgStatSock = PGINVALID_SOCKET;
+		MemSet(pgStatShmem, 0, sizeof(PgStat_ShmemControl));
+		SpinLockInit(&pgStatShmem->mutex);
+		pgStatShmem->archiverStats.stat_reset_timestamp = now;
+		pgStatShmem->globalStats.stat_reset_timestamp = now;
+	}
 
-	/*
-	 * Adjust GUC variables to suppress useless activity, and for debugging
-	 * purposes (seeing track_counts off is a clue that we failed here). We
-	 * use PGC_S_OVERRIDE because there is no point in trying to turn it back
-	 * on from postgresql.conf without a restart.
-	 */
-	SetConfigOption("track_counts", "off", PGC_INTERNAL, PGC_S_OVERRIDE);
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(Oid);
+	info.entrysize = sizeof(PgStat_StatDBEntry);
+	info.num_partitions = NUM_PGSTAT_PARTITIONS;
+	pgStatSharedDBHash = ShmemInitHash("Statistics Database Hash",
+									   PGSTAT_MAX_DB_ENTRIES,
+									   PGSTAT_MAX_DB_ENTRIES,
+									   &info,
+									   HASH_ELEM | HASH_BLOBS |
+									   HASH_PARTITION | HASH_FIXED_SIZE);
+
+	info.keysize = sizeof(PgStat_ObjectKey);
+	info.entrysize = sizeof(PgStat_StatTabEntry);
+	pgStatSharedTabHash = ShmemInitHash("Statistics Table Hash",
+										PGSTAT_MAX_TAB_ENTRIES,
+										PGSTAT_MAX_TAB_ENTRIES,
+										&info,
+										HASH_ELEM | HASH_BLOBS |
+										HASH_PARTITION | HASH_FIXED_SIZE);
+
+	info.keysize = sizeof(PgStat_ObjectKey);
+	info.entrysize = sizeof(PgStat_StatFuncEntry);
+	pgStatSharedFuncHash = ShmemInitHash("Statistics Function Hash",
+										 PGSTAT_MAX_FUNC_ENTRIES,
+										 PGSTAT_MAX_FUNC_ENTRIES,
+										 &info,
+										 HASH_ELEM | HASH_BLOBS |
+										 HASH_PARTITION | HASH_FIXED_SIZE);
 }
 
 /*
@@ -620,110 +466,6 @@ pgstat_reset_all(void)
 	pgstat_reset_remove_files(PGSTAT_STAT_PERMANENT_DIRECTORY);
 }
 
-#ifdef EXEC_BACKEND
-
-/*
- * pgstat_forkexec() -
- *
- * Format up the arglist for, then fork and exec, statistics collector process
- */
-static pid_t
-pgstat_forkexec(void)
-{
-	char	   *av[10];
-	int			ac = 0;
-
-	av[ac++] = "postgres";
-	av[ac++] = "--forkcol";
-	av[ac++] = NULL;			/* filled in by postmaster_forkexec */
-
-	av[ac] = NULL;
-	Assert(ac < lengthof(av));
-
-	return postmaster_forkexec(ac, av);
-}
-#endif   /* EXEC_BACKEND */
-
-
-/*
- * pgstat_start() -
- *
- *	Called from postmaster at startup or after an existing collector
- *	died.  Attempt to fire up a fresh statistics collector.
- *
- *	Returns PID of child process, or 0 if fail.
- *
- *	Note: if fail, we will be called again from the postmaster main loop.
- */
-int
-pgstat_start(void)
-{
-	time_t		curtime;
-	pid_t		pgStatPid;
-
-	/*
-	 * Check that the socket is there, else pgstat_init failed and we can do
-	 * nothing useful.
-	 */
-	if (pgStatSock == PGINVALID_SOCKET)
-		return 0;
-
-	/*
-	 * Do nothing if too soon since last collector start.  This is a safety
-	 * valve to protect against continuous respawn attempts if the collector
-	 * is dying immediately at launch.  Note that since we will be re-called
-	 * from the postmaster main loop, we will get another chance later.
-	 */
-	curtime = time(NULL);
-	if ((unsigned int) (curtime - last_pgstat_start_time) <
-		(unsigned int) PGSTAT_RESTART_INTERVAL)
-		return 0;
-	last_pgstat_start_time = curtime;
-
-	/*
-	 * Okay, fork off the collector.
-	 */
-#ifdef EXEC_BACKEND
-	switch ((pgStatPid = pgstat_forkexec()))
-#else
-	switch ((pgStatPid = fork_process()))
-#endif
-	{
-		case -1:
-			ereport(LOG,
-					(errmsg("could not fork statistics collector: %m")));
-			return 0;
-
-#ifndef EXEC_BACKEND
-		case 0:
-			/* in postmaster child ... */
-			InitPostmasterChild();
-
-			/* Close the postmaster's sockets */
-			ClosePostmasterPorts(false);
-
-			/* Drop our connection to postmaster's shared memory, as well */
-			dsm_detach_all();
-			PGSharedMemoryDetach();
-
-			PgstatCollectorMain(0, NULL);
-			break;
-#endif
-
-		default:
-			return (int) pgStatPid;
-	}
-
-	/* shouldn't get here */
-	return 0;
-}
-
-void
-allow_immediate_pgstat_restart(void)
-{
-	last_pgstat_start_time = 0;
-}
-
 /* ------------------------------------------------------------
  * Public functions used by backends follow
  *------------------------------------------------------------
@@ -842,7 +584,7 @@ pgstat_send_tabstat(PgStat_MsgTabstat *tsmsg)
 	int			len;
 
 	/* It's unlikely we'd get here with no socket, but maybe not impossible */
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (pgStatShmem == NULL)
 		return;
 
 	/*
@@ -935,7 +677,7 @@ pgstat_send_funcstats(void)
 /* ----------
  * pgstat_vacuum_stat() -
  *
- *	Will tell the collector about objects he can get rid of.
+ *	Get rid of the statistics of objects that no longer exist.
  * ----------
  */
 void
@@ -948,16 +690,31 @@ pgstat_vacuum_stat(void)
 	PgStat_StatDBEntry *dbentry;
 	PgStat_StatTabEntry *tabentry;
 	PgStat_StatFuncEntry *funcentry;
+	List	   *oids;
+	ListCell   *lc;
 	int			len;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (pgStatShmem == NULL)
 		return;
 
 	/*
-	 * If not done for this transaction, read the statistics collector stats
-	 * file into some hash tables.
+	 * Make a list of the OIDs of all databases, and of all tables and
+	 * functions of our own database, that have entries in the shared hash
+	 * tables.  We can't purge anything while scanning, since that needs the
+	 * partition locks we're holding in shared mode, so just remember them.
 	 */
-	backend_read_statsfile();
+	pgstat_lock_all_partitions(LW_SHARED);
+
+	oids = NIL;
+	hash_seq_init(&hstat, pgStatSharedDBHash);
+	while ((dbentry = (PgStat_StatDBEntry *) hash_seq_search(&hstat)) != NULL)
+	{
+		/* the DB entry for shared tables (with InvalidOid) is never dropped */
+		if (OidIsValid(dbentry->databaseid))
+			oids = lappend_oid(oids, dbentry->databaseid);
+	}
+
+	pgstat_unlock_all_partitions();
 
 	/*
 	 * Read pg_database and make a list of OIDs of all existing databases
@@ -965,66 +722,86 @@ pgstat_vacuum_stat(void)
 	htab = pgstat_collect_oids(DatabaseRelationId);
 
 	/*
-	 * Search the database hash table for dead databases and tell the
-	 * collector to drop them.
+	 * Tell the collector to drop the dead ones.
 	 */
-	hash_seq_init(&hstat, pgStatDBHash);
-	while ((dbentry = (PgStat_StatDBEntry *) hash_seq_search(&hstat)) != NULL)
+	foreach(lc, oids)
 	{
-		Oid			dbid = dbentry->databaseid;
+		Oid			dbid = lfirst_oid(lc);
 
 		CHECK_FOR_INTERRUPTS();
 
-		/* the DB entry for shared tables (with InvalidOid) is never dropped */
-		if (OidIsValid(dbid) &&
-			hash_search(htab, (void *) &dbid, HASH_FIND, NULL) == NULL)
+		if (hash_search(htab, (void *) &dbid, HASH_FIND, NULL) == NULL)
 			pgstat_drop_database(dbid);
 	}
 
 	/* Clean up */
 	hash_destroy(htab);
+	list_free(oids);
 
 	/*
-	 * Lookup our own database entry; if not found, nothing more to do.
-	 */
-	dbentry = (PgStat_StatDBEntry *) hash_search(pgStatDBHash,
-												 (void *) &MyDatabaseId,
-												 HASH_FIND, NULL);
-	if (dbentry == NULL || dbentry->tables == NULL)
-		return;
-
-	/*
-	 * Similarly to above, make a list of all known relations in this DB.
-	 */
-	htab = pgstat_collect_oids(RelationRelationId);
-
-	/*
-	 * Initialize our messages table counter to zero
+	 * Now collect the tables of our own database.
 	 */
-	msg.m_nentries = 0;
+	pgstat_lock_all_partitions(LW_SHARED);
 
-	/*
-	 * Check for all tables listed in stats hashtable if they still exist.
-	 */
-	hash_seq_init(&hstat, dbentry->tables);
+	oids = NIL;
+	hash_seq_init(&hstat, pgStatSharedTabHash);
 	while ((tabentry = (PgStat_StatTabEntry *) hash_seq_search(&hstat)) != NULL)
 	{
-		Oid			tabid = tabentry->tableid;
+		if (tabentry->databaseid == MyDatabaseId)
+			oids = lappend_oid(oids, tabentry->tableid);
+	}
 
-		CHECK_FOR_INTERRUPTS();
+	pgstat_unlock_all_partitions();
 
-		if (hash_search(htab, (void *) &tabid, HASH_FIND, NULL) != NULL)
-			continue;
+	if (oids != NIL)
+	{
+		/*
+		 * Similarly to above, make a list of all known relations in this DB.
+		 */
+		htab = pgstat_collect_oids(RelationRelationId);
+
+		/*
+		 * Initialize our messages table counter to zero
+		 */
+		msg.m_nentries = 0;
 
 		/*
-		 * Not there, so add this table's Oid to the message
+		 * Check for all tables listed in stats hashtable if they still exist.
 		 */
-		msg.m_tableid[msg.m_nentries++] = tabid;
+		foreach(lc, oids)
+		{
+			Oid			tabid = lfirst_oid(lc);
+
+			CHECK_FOR_INTERRUPTS();
+
+			if (hash_search(htab, (void *) &tabid, HASH_FIND, NULL) != NULL)
+				continue;
+
+			/*
+			 * Not there, so add this table's Oid to the message
+			 */
+			msg.m_tableid[msg.m_nentries++] = tabid;
+
+			/*
+			 * If the message is full, send it out and reinitialize to empty
+			 */
+			if (msg.m_nentries >= PGSTAT_NUM_TABPURGE)
+			{
+				len = offsetof(PgStat_MsgTabpurge, m_tableid[0])
+					+msg.m_nentries * sizeof(Oid);
+
+				pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_TABPURGE);
+				msg.m_databaseid = MyDatabaseId;
+				pgstat_send(&msg, len);
+
+				msg.m_nentries = 0;
+			}
+		}
 
 		/*
-		 * If the message is full, send it out and reinitialize to empty
+		 * Send the rest
 		 */
-		if (msg.m_nentries >= PGSTAT_NUM_TABPURGE)
+		if (msg.m_nentries > 0)
 		{
 			len = offsetof(PgStat_MsgTabpurge, m_tableid[0])
 				+msg.m_nentries * sizeof(Oid);
@@ -1032,33 +809,31 @@ pgstat_vacuum_stat(void)
 			pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_TABPURGE);
 			msg.m_databaseid = MyDatabaseId;
 			pgstat_send(&msg, len);
-
-			msg.m_nentries = 0;
 		}
+
+		/* Clean up */
+		hash_destroy(htab);
+		list_free(oids);
 	}
 
 	/*
-	 * Send the rest
+	 * Now repeat the above steps for functions.  However, we needn't bother
+	 * reading pg_proc in the common case where no function stats are being
+	 * collected.
 	 */
-	if (msg.m_nentries > 0)
-	{
-		len = offsetof(PgStat_MsgTabpurge, m_tableid[0])
-			+msg.m_nentries * sizeof(Oid);
+	pgstat_lock_all_partitions(LW_SHARED);
 
-		pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_TABPURGE);
-		msg.m_databaseid = MyDatabaseId;
-		pgstat_send(&msg, len);
+	oids = NIL;
+	hash_seq_init(&hstat, pgStatSharedFuncHash);
+	while ((funcentry = (PgStat_StatFuncEntry *) hash_seq_search(&hstat)) != NULL)
+	{
+		if (funcentry->databaseid == MyDatabaseId)
+			oids = lappend_oid(oids, funcentry->functionid);
 	}
 
-	/* Clean up */
-	hash_destroy(htab);
+	pgstat_unlock_all_partitions();
 
-	/*
-	 * Now repeat the above steps for functions.  However, we needn't bother
-	 * in the common case where no function stats are being collected.
-	 */
-	if (dbentry->functions != NULL &&
-		hash_get_num_entries(dbentry->functions) > 0)
+	if (oids != NIL)
 	{
 		htab = pgstat_collect_oids(ProcedureRelationId);
 
@@ -1066,10 +841,9 @@ pgstat_vacuum_stat(void)
 		f_msg.m_databaseid = MyDatabaseId;
 		f_msg.m_nentries = 0;
 
-		hash_seq_init(&hstat, dbentry->functions);
-		while ((funcentry = (PgStat_StatFuncEntry *) hash_seq_search(&hstat)) != NULL)
+		foreach(lc, oids)
 		{
-			Oid			funcid = funcentry->functionid;
+			Oid			funcid = lfirst_oid(lc);
 
 			CHECK_FOR_INTERRUPTS();
 
@@ -1107,6 +881,7 @@ pgstat_vacuum_stat(void)
 		}
 
 		hash_destroy(htab);
+		list_free(oids);
 	}
 }
 
@@ -1171,7 +946,7 @@ pgstat_drop_database(Oid databaseid)
 {
 	PgStat_MsgDropdb msg;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (pgStatShmem == NULL)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_DROPDB);
@@ -1198,7 +973,7 @@ pgstat_drop_relation(Oid relid)
 	PgStat_MsgTabpurge msg;
 	int			len;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (pgStatShmem == NULL)
 		return;
 
 	msg.m_tableid[0] = relid;
@@ -1224,7 +999,7 @@ pgstat_reset_counters(void)
 {
 	PgStat_MsgResetcounter msg;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (pgStatShmem == NULL)
 		return;
 
 	if (!superuser())
@@ -1248,7 +1023,7 @@ pgstat_reset_shared_counters(const char *target)
 {
 	PgStat_MsgResetsharedcounter msg;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (pgStatShmem == NULL)
 		return;
 
 	if (!superuser())
@@ -1281,7 +1056,7 @@ pgstat_reset_single_counter(Oid objoid, PgStat_Single_Reset_Type type)
 {
 	PgStat_MsgResetsinglecounter msg;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (pgStatShmem == NULL)
 		return;
 
 	if (!superuser())
@@ -1310,7 +1085,7 @@ pgstat_report_autovac(Oid dboid)
 {
 	PgStat_MsgAutovacStart msg;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (pgStatShmem == NULL)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_AUTOVAC_START);
@@ -1333,7 +1108,7 @@ pgstat_report_vacuum(Oid tableoid, bool shared,
 {
 	PgStat_MsgVacuum msg;
 
-	if (pgStatSock == PGINVALID_SOCKET || !pgstat_track_counts)
+	if (pgStatShmem == NULL || !pgstat_track_counts)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_VACUUM);
@@ -1358,7 +1133,7 @@ pgstat_report_analyze(Relation rel,
 {
 	PgStat_MsgAnalyze msg;
 
-	if (pgStatSock == PGINVALID_SOCKET || !pgstat_track_counts)
+	if (pgStatShmem == NULL || !pgstat_track_counts)
 		return;
 
 	/*
@@ -1408,7 +1183,7 @@ pgstat_report_recovery_conflict(int reason)
 {
 	PgStat_MsgRecoveryConflict msg;
 
-	if (pgStatSock == PGINVALID_SOCKET || !pgstat_track_counts)
+	if (pgStatShmem == NULL || !pgstat_track_counts)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_RECOVERYCONFLICT);
@@ -1428,7 +1203,7 @@ pgstat_report_deadlock(void)
 {
 	PgStat_MsgDeadlock msg;
 
-	if (pgStatSock == PGINVALID_SOCKET || !pgstat_track_counts)
+	if (pgStatShmem == NULL || !pgstat_track_counts)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_DEADLOCK);
@@ -1447,7 +1222,7 @@ pgstat_report_tempfile(size_t filesize)
 {
 	PgStat_MsgTempFile msg;
 
-	if (pgStatSock == PGINVALID_SOCKET || !pgstat_track_counts)
+	if (pgStatShmem == NULL || !pgstat_track_counts)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_TEMPFILE);
@@ -1457,60 +1232,23 @@ pgstat_report_tempfile(size_t filesize)
 }
 
 
-/* ----------
- * pgstat_ping() -
- *
- *	Send some junk data to the collector to increase traffic.
- * ----------
+/*
+ * Initialize function call usage data.
+ * Called by the executor before invoking a function.
  */
 void
-pgstat_ping(void)
+pgstat_init_function_usage(FunctionCallInfoData *fcinfo,
+						   PgStat_FunctionCallUsage *fcu)
 {
-	PgStat_MsgDummy msg;
+	PgStat_BackendFunctionEntry *htabent;
+	bool		found;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (pgstat_track_functions <= fcinfo->flinfo->fn_stats)
+	{
+		/* stats not wanted */
+		fcu->fs = NULL;
 		return;
-
-	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_DUMMY);
-	pgstat_send(&msg, sizeof(msg));
-}
-
-/* ----------
- * pgstat_send_inquiry() -
- *
- *	Notify collector that we need fresh data.
- * ----------
- */
-static void
-pgstat_send_inquiry(TimestampTz clock_time, TimestampTz cutoff_time, Oid databaseid)
-{
-	PgStat_MsgInquiry msg;
-
-	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_INQUIRY);
-	msg.clock_time = clock_time;
-	msg.cutoff_time = cutoff_time;
-	msg.databaseid = databaseid;
-	pgstat_send(&msg, sizeof(msg));
-}
-
-
-/*
- * Initialize function call usage data.
- * Called by the executor before invoking a function.
- */
-void
-pgstat_init_function_usage(FunctionCallInfoData *fcinfo,
-						   PgStat_FunctionCallUsage *fcu)
-{
-	PgStat_BackendFunctionEntry *htabent;
-	bool		found;
-
-	if (pgstat_track_functions <= fcinfo->flinfo->fn_stats)
-	{
-		/* stats not wanted */
-		fcu->fs = NULL;
-		return;
-	}
+	}
 
 	if (!pgStatFunctions)
 	{
@@ -1644,7 +1382,7 @@ pgstat_initstats(Relation rel)
 		return;
 	}
 
-	if (pgStatSock == PGINVALID_SOCKET || !pgstat_track_counts)
+	if (pgStatShmem == NULL || !pgstat_track_counts)
 	{
 		/* We're not counting at all */
 		rel->pgstat_info = NULL;
@@ -2276,18 +2014,36 @@ pgstat_twophase_postabort(TransactionId xid, uint16 info,
 PgStat_StatDBEntry *
 pgstat_fetch_stat_dbentry(Oid dbid)
 {
+	PgStat_StatDBEntry *dbentry;
+	PgStat_StatDBEntry dbbuf;
+
+	if (pgStatShmem == NULL)
+		return NULL;
+
 	/*
-	 * If not done for this transaction, read the statistics collector stats
-	 * file into some hash tables.
+	 * If we've already looked at this database in this transaction, return
+	 * the same copy again.
 	 */
-	backend_read_statsfile();
+	pgstat_setup_snapshot();
+
+	dbentry = (PgStat_StatDBEntry *) hash_search(pgStatDBHash,
+												 (void *) &dbid,
+												 HASH_FIND, NULL);
+	if (dbentry != NULL)
+		return dbentry;
 
 	/*
-	 * Lookup the requested database; return NULL if not found
+	 * Otherwise copy it out of shared memory; return NULL if not found
 	 */
-	return (PgStat_StatDBEntry *) hash_search(pgStatDBHash,
-											  (void *) &dbid,
-											  HASH_FIND, NULL);
+	if (!pgstat_copy_entry(pgStatSharedDBHash, &dbid, &dbbuf, sizeof(dbbuf)))
+		return NULL;
+
+	dbentry = (PgStat_StatDBEntry *) hash_search(pgStatDBHash,
+												 (void *) &dbid,
+												 HASH_ENTER, NULL);
+	memcpy(dbentry, &dbbuf, sizeof(dbbuf));
+
+	return dbentry;
 }
 
 
@@ -2303,49 +2059,59 @@ pgstat_fetch_stat_dbentry(Oid dbid)
 PgStat_StatTabEntry *
 pgstat_fetch_stat_tabentry(Oid relid)
 {
-	Oid			dbid;
-	PgStat_StatDBEntry *dbentry;
 	PgStat_StatTabEntry *tabentry;
 
 	/*
-	 * If not done for this transaction, read the statistics collector stats
-	 * file into some hash tables.
-	 */
-	backend_read_statsfile();
-
-	/*
-	 * Lookup our database, then look in its table hash table.
+	 * Look in our database first.
 	 */
-	dbid = MyDatabaseId;
-	dbentry = (PgStat_StatDBEntry *) hash_search(pgStatDBHash,
-												 (void *) &dbid,
-												 HASH_FIND, NULL);
-	if (dbentry != NULL && dbentry->tables != NULL)
-	{
-		tabentry = (PgStat_StatTabEntry *) hash_search(dbentry->tables,
-													   (void *) &relid,
-													   HASH_FIND, NULL);
-		if (tabentry)
-			return tabentry;
-	}
+	tabentry = pgstat_fetch_stat_tabentry_ext(false, relid);
+	if (tabentry)
+		return tabentry;
 
 	/*
 	 * If we didn't find it, maybe it's a shared table.
 	 */
-	dbid = InvalidOid;
-	dbentry = (PgStat_StatDBEntry *) hash_search(pgStatDBHash,
-												 (void *) &dbid,
-												 HASH_FIND, NULL);
-	if (dbentry != NULL && dbentry->tables != NULL)
-	{
-		tabentry = (PgStat_StatTabEntry *) hash_search(dbentry->tables,
-													   (void *) &relid,
-													   HASH_FIND, NULL);
-		if (tabentry)
-			return tabentry;
-	}
+	return pgstat_fetch_stat_tabentry_ext(true, relid);
+}
 
-	return NULL;
+
+/* ----------
+ * pgstat_fetch_stat_tabentry_ext() -
+ *
+ *	Like pgstat_fetch_stat_tabentry(), but only looks among shared tables
+ *	or among our own database's tables, as the caller says.
+ * ----------
+ */
+PgStat_StatTabEntry *
+pgstat_fetch_stat_tabentry_ext(bool shared, Oid relid)
+{
+	PgStat_ObjectKey key;
+	PgStat_StatTabEntry *tabentry;
+	PgStat_StatTabEntry tabbuf;
+
+	if (pgStatShmem == NULL)
+		return NULL;
+
+	pgstat_setup_snapshot();
+
+	key.databaseid = shared ? InvalidOid : MyDatabaseId;
+	key.objectid = relid;
+
+	tabentry = (PgStat_StatTabEntry *) hash_search(pgStatTabHash,
+												   (void *) &key,
+												   HASH_FIND, NULL);
+	if (tabentry != NULL)
+		return tabentry;
+
+	if (!pgstat_copy_entry(pgStatSharedTabHash, &key, &tabbuf, sizeof(tabbuf)))
+		return NULL;
+
+	tabentry = (PgStat_StatTabEntry *) hash_search(pgStatTabHash,
+												   (void *) &key,
+												   HASH_ENTER, NULL);
+	memcpy(tabentry, &tabbuf, sizeof(tabbuf));
+
+	return tabentry;
 }
 
 
@@ -2359,20 +2125,32 @@ pgstat_fetch_stat_tabentry(Oid relid)
 PgStat_StatFuncEntry *
 pgstat_fetch_stat_funcentry(Oid func_id)
 {
-	PgStat_StatDBEntry *dbentry;
-	PgStat_StatFuncEntry *funcentry = NULL;
+	PgStat_ObjectKey key;
+	PgStat_StatFuncEntry *funcentry;
+	PgStat_StatFuncEntry funcbuf;
 
-	/* load the stats file if needed */
-	backend_read_statsfile();
+	if (pgStatShmem == NULL)
+		return NULL;
 
-	/* Lookup our database, then find the requested function.  */
-	dbentry = pgstat_fetch_stat_dbentry(MyDatabaseId);
-	if (dbentry != NULL && dbentry->functions != NULL)
-	{
-		funcentry = (PgStat_StatFuncEntry *) hash_search(dbentry->functions,
-														 (void *) &func_id,
-														 HASH_FIND, NULL);
-	}
+	pgstat_setup_snapshot();
+
+	key.databaseid = MyDatabaseId;
+	key.objectid = func_id;
+
+	funcentry = (PgStat_StatFuncEntry *) hash_search(pgStatFuncHash,
+													 (void *) &key,
+													 HASH_FIND, NULL);
+	if (funcentry != NULL)
+		return funcentry;
+
+	if (!pgstat_copy_entry(pgStatSharedFuncHash, &key, &funcbuf,
+						   sizeof(funcbuf)))
+		return NULL;
+
+	funcentry = (PgStat_StatFuncEntry *) hash_search(pgStatFuncHash,
+													 (void *) &key,
+													 HASH_ENTER, NULL);
+	memcpy(funcentry, &funcbuf, sizeof(funcbuf));
 
 	return funcentry;
 }
@@ -2437,6 +2215,35 @@ pgstat_fetch_stat_numbackends(void)
 	return localNumBackends;
 }
 
+/*
+ * Subroutine for pgstat_fetch_stat_archiver and pgstat_fetch_global: take
+ * a snapshot of the cluster-wide statistics, if not done yet in this
+ * transaction.
+ */
+static void
+pgstat_fetch_global_stats(void)
+{
+	if (globalStatsValid)
+		return;
+
+	if (pgStatShmem == NULL)
+	{
+		memset(&archiverStats, 0, sizeof(archiverStats));
+		memset(&globalStats, 0, sizeof(globalStats));
+	}
+	else
+	{
+		SpinLockAcquire(&pgStatShmem->mutex);
+		memcpy(&archiverStats, &pgStatShmem->archiverStats,
+			   sizeof(archiverStats));
+		memcpy(&globalStats, &pgStatShmem->globalStats, sizeof(globalStats));
+		SpinLockRelease(&pgStatShmem->mutex);
+	}
+
+	globalStats.stats_timestamp = GetCurrentTimestamp();
+	globalStatsValid = true;
+}
+
 /*
  * ---------
  * pgstat_fetch_stat_archiver() -
@@ -2448,7 +2255,7 @@ pgstat_fetch_stat_numbackends(void)
 PgStat_ArchiverStats *
 pgstat_fetch_stat_archiver(void)
 {
-	backend_read_statsfile();
+	pgstat_fetch_global_stats();
 
 	return &archiverStats;
 }
@@ -2465,7 +2272,7 @@ pgstat_fetch_stat_archiver(void)
 PgStat_GlobalStats *
 pgstat_fetch_global(void)
 {
-	backend_read_statsfile();
+	pgstat_fetch_global_stats();
 
 	return &globalStats;
 }
@@ -2939,7 +2746,6 @@ pgstat_read_current_status(void)
 			   *localactivity;
 	int			i;
 
-	Assert(!pgStatRunningInCollector);
 	if (localBackendStatusTable)
 		return;					/* already done */
 
@@ -3210,30 +3016,97 @@ pgstat_setheader(PgStat_MsgHdr *hdr, StatMsgType mtype)
 /* ----------
  * pgstat_send() -
  *
- *		Send out one statistics message to the collector
+ *		Apply one statistics message to the shared statistics.
+ *
+ *	The messages used to travel over a UDP socket to a separate collector
+ *	process.  Now the sending process applies them itself, taking the
+ *	partition locks of the entries it touches; so the messages are really
+ *	just a convenient way of batching up counts.
  * ----------
  */
 static void
 pgstat_send(void *msg, int len)
 {
-	int			rc;
+	PgStat_MsgHdr *hdr = (PgStat_MsgHdr *) msg;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (pgStatShmem == NULL)
 		return;
 
-	((PgStat_MsgHdr *) msg)->m_size = len;
+	hdr->m_size = len;
 
-	/* We'll retry after EINTR, but ignore all other failures */
-	do
+	switch (hdr->m_type)
 	{
-		rc = send(pgStatSock, msg, len, 0);
-	} while (rc < 0 && errno == EINTR);
+		case PGSTAT_MTYPE_DUMMY:
+			break;
 
-#ifdef USE_ASSERT_CHECKING
-	/* In debug builds, log send failures ... */
-	if (rc < 0)
-		elog(LOG, "could not send to statistics collector: %m");
-#endif
+		case PGSTAT_MTYPE_TABSTAT:
+			pgstat_recv_tabstat((PgStat_MsgTabstat *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_TABPURGE:
+			pgstat_recv_tabpurge((PgStat_MsgTabpurge *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_DROPDB:
+			pgstat_recv_dropdb((PgStat_MsgDropdb *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_RESETCOUNTER:
+			pgstat_recv_resetcounter((PgStat_MsgResetcounter *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_RESETSHAREDCOUNTER:
+			pgstat_recv_resetsharedcounter((PgStat_MsgResetsharedcounter *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_RESETSINGLECOUNTER:
+			pgstat_recv_resetsinglecounter((PgStat_MsgResetsinglecounter *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_AUTOVAC_START:
+			pgstat_recv_autovac((PgStat_MsgAutovacStart *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_VACUUM:
+			pgstat_recv_vacuum((PgStat_MsgVacuum *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_ANALYZE:
+			pgstat_recv_analyze((PgStat_MsgAnalyze *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_ARCHIVER:
+			pgstat_recv_archiver((PgStat_MsgArchiver *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_BGWRITER:
+			pgstat_recv_bgwriter((PgStat_MsgBgWriter *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_FUNCSTAT:
+			pgstat_recv_funcstat((PgStat_MsgFuncstat *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_FUNCPURGE:
+			pgstat_recv_funcpurge((PgStat_MsgFuncpurge *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_RECOVERYCONFLICT:
+			pgstat_recv_recoveryconflict((PgStat_MsgRecoveryConflict *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_DEADLOCK:
+			pgstat_recv_deadlock((PgStat_MsgDeadlock *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_TEMPFILE:
+			pgstat_recv_tempfile((PgStat_MsgTempFile *) msg, len);
+			break;
+
+		default:
+			elog(ERROR, "unrecognized statistics message type: %d",
+				 (int) hdr->m_type);
+	}
 }
 
 /* ----------
@@ -3291,447 +3164,365 @@ pgstat_send_bgwriter(void)
 }
 
 
-/* ----------
- * PgstatCollectorMain() -
- *
- *	Start up the statistics collector process.  This is the body of the
- *	postmaster child process.
- *
- *	The argc/argv parameters are valid only in EXEC_BACKEND case.
- * ----------
+/*
+ * Subroutine to clear stats in a database entry
  */
-NON_EXEC_STATIC void
-PgstatCollectorMain(int argc, char *argv[])
+static void
+reset_dbentry_counters(PgStat_StatDBEntry *dbentry)
 {
-	int			len;
-	PgStat_Msg	msg;
-	int			wr;
-
-	/*
-	 * Ignore all signals usually bound to some action in the postmaster,
-	 * except SIGHUP and SIGQUIT.  Note we don't need a SIGUSR1 handler to
-	 * support latch operations, because we only use a local latch.
-	 */
-	pqsignal(SIGHUP, pgstat_sighup_handler);
-	pqsignal(SIGINT, SIG_IGN);
-	pqsignal(SIGTERM, SIG_IGN);
-	pqsignal(SIGQUIT, pgstat_exit);
-	pqsignal(SIGALRM, SIG_IGN);
-	pqsignal(SIGPIPE, SIG_IGN);
-	pqsignal(SIGUSR1, SIG_IGN);
-	pqsignal(SIGUSR2, SIG_IGN);
-	pqsignal(SIGCHLD, SIG_DFL);
-	pqsignal(SIGTTIN, SIG_DFL);
-	pqsignal(SIGTTOU, SIG_DFL);
-	pqsignal(SIGCONT, SIG_DFL);
-	pqsignal(SIGWINCH, SIG_DFL);
-	PG_SETMASK(&UnBlockSig);
-
-	/*
-	 * Identify myself via ps
-	 */
-	init_ps_display("stats collector process", "", "", "");
+	dbentry->n_xact_commit = 0;
+	dbentry->n_xact_rollback = 0;
+	dbentry->n_blocks_fetched = 0;
+	dbentry->n_blocks_hit = 0;
+	dbentry->n_tuples_returned = 0;
+	dbentry->n_tuples_fetched = 0;
+	dbentry->n_tuples_inserted = 0;
+	dbentry->n_tuples_updated = 0;
+	dbentry->n_tuples_deleted = 0;
+	dbentry->last_autovac_time = 0;
+	dbentry->n_conflict_tablespace = 0;
+	dbentry->n_conflict_lock = 0;
+	dbentry->n_conflict_snapshot = 0;
+	dbentry->n_conflict_bufferpin = 0;
+	dbentry->n_conflict_startup_deadlock = 0;
+	dbentry->n_temp_files = 0;
+	dbentry->n_temp_bytes = 0;
+	dbentry->n_deadlocks = 0;
+	dbentry->n_block_read_time = 0;
+	dbentry->n_block_write_time = 0;
 
-	/*
-	 * Read in an existing statistics stats file or initialize the stats to
-	 * zero.
-	 */
-	pgStatRunningInCollector = true;
-	pgStatDBHash = pgstat_read_statsfiles(InvalidOid, true, true);
+	dbentry->stat_reset_timestamp = GetCurrentTimestamp();
+}
 
-	/*
-	 * Loop to process messages until we get SIGQUIT or detect ungraceful
-	 * death of our parent postmaster.
-	 *
-	 * For performance reasons, we don't want to do ResetLatch/WaitLatch after
-	 * every message; instead, do that only after a recv() fails to obtain a
-	 * message.  (This effectively means that if backends are sending us stuff
-	 * like mad, we won't notice postmaster death until things slack off a
-	 * bit; which seems fine.)	To do that, we have an inner loop that
-	 * iterates as long as recv() succeeds.  We do recognize got_SIGHUP inside
-	 * the inner loop, which means that such interrupts will get serviced but
-	 * the latch won't get cleared until next time there is a break in the
-	 * action.
-	 */
-	for (;;)
+/*
+ * Lookup an entry of one of the shared hash tables, and return it with its
+ * partition lock held exclusively; the caller must release *partitionLock
+ * when done with it.  If the entry doesn't exist, create it if the create
+ * parameter is true.  Else, or if the hash table is full, return NULL with
+ * no lock held.  *found tells whether the entry already existed.
+ */
+static void *
+pgstat_lock_entry(HTAB *htab, const void *key, bool create, bool *found,
+				  LWLock **partitionLock)
+{
+	uint32		hashcode;
+	LWLock	   *lock;
+	void	   *result;
+
+	hashcode = get_hash_value(htab, key);
+	lock = PgStatHashPartitionLock(hashcode);
+
+	LWLockAcquire(lock, LW_EXCLUSIVE);
+	result = hash_search_with_hash_value(htab, key, hashcode,
+									create ? HASH_ENTER_NULL : HASH_FIND,
+										 found);
+	if (result == NULL)
 	{
-		/* Clear any already-pending wakeups */
-		ResetLatch(MyLatch);
-
-		/*
-		 * Quit if we get SIGQUIT from the postmaster.
-		 */
-		if (need_exit)
-			break;
-
-		/*
-		 * Inner loop iterates as long as we keep getting messages, or until
-		 * need_exit becomes set.
-		 */
-		while (!need_exit)
-		{
-			/*
-			 * Reload configuration if we got SIGHUP from the postmaster.
-			 */
-			if (got_SIGHUP)
-			{
-				got_SIGHUP = false;
-				ProcessConfigFile(PGC_SIGHUP);
-			}
-
-			/*
-			 * Write the stats file if a new request has arrived that is not
-			 * satisfied by existing file.
-			 */
-			if (pgstat_write_statsfile_needed())
-				pgstat_write_statsfiles(false, false);
-
-			/*
-			 * Try to receive and process a message.  This will not block,
-			 * since the socket is set to non-blocking mode.
-			 *
-			 * XXX On Windows, we have to force pgwin32_recv to cooperate,
-			 * despite the previous use of pg_set_noblock() on the socket.
-			 * This is extremely broken and should be fixed someday.
-			 */
-#ifdef WIN32
-			pgwin32_noblock = 1;
-#endif
-
-			len = recv(pgStatSock, (char *) &msg,
-					   sizeof(PgStat_Msg), 0);
-
-#ifdef WIN32
-			pgwin32_noblock = 0;
-#endif
-
-			if (len < 0)
-			{
-				if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
-					break;		/* out of inner loop */
-				ereport(ERROR,
-						(errcode_for_socket_access(),
-						 errmsg("could not read statistics message: %m")));
-			}
-
-			/*
-			 * We ignore messages that are smaller than our common header
-			 */
-			if (len < sizeof(PgStat_MsgHdr))
-				continue;
+		LWLockRelease(lock);
+		if (create)
+			pgstat_report_hash_full(htab, key);
+		return NULL;
+	}
 
-			/*
-			 * The received length must match the length in the header
-			 */
-			if (msg.msg_hdr.m_size != len)
-				continue;
+	*partitionLock = lock;
+	return result;
+}
 
-			/*
-			 * O.K. - we accept this message.  Process it.
-			 */
-			switch (msg.msg_hdr.m_type)
-			{
-				case PGSTAT_MTYPE_DUMMY:
-					break;
+/*
+ * Lookup the shared hash table entry for the specified database, as
+ * pgstat_lock_entry does.
+ */
+static PgStat_StatDBEntry *
+pgstat_get_db_entry(Oid databaseid, bool create, LWLock **partitionLock)
+{
+	PgStat_StatDBEntry *result;
+	bool		found;
 
-				case PGSTAT_MTYPE_INQUIRY:
-					pgstat_recv_inquiry((PgStat_MsgInquiry *) &msg, len);
-					break;
+	result = (PgStat_StatDBEntry *) pgstat_lock_entry(pgStatSharedDBHash,
+													  &databaseid, create,
+													  &found, partitionLock);
 
-				case PGSTAT_MTYPE_TABSTAT:
-					pgstat_recv_tabstat((PgStat_MsgTabstat *) &msg, len);
-					break;
+	/* If it's new, initialize it. */
+	if (result != NULL && !found)
+		reset_dbentry_counters(result);
 
-				case PGSTAT_MTYPE_TABPURGE:
-					pgstat_recv_tabpurge((PgStat_MsgTabpurge *) &msg, len);
-					break;
+	return result;
+}
 
-				case PGSTAT_MTYPE_DROPDB:
-					pgstat_recv_dropdb((PgStat_MsgDropdb *) &msg, len);
-					break;
 
-				case PGSTAT_MTYPE_RESETCOUNTER:
-					pgstat_recv_resetcounter((PgStat_MsgResetcounter *) &msg,
-											 len);
-					break;
+/*
+ * Lookup the shared hash table entry for the specified table, as
+ * pgstat_lock_entry does.
+ */
+static PgStat_StatTabEntry *
+pgstat_get_tab_entry(Oid databaseid, Oid tableoid, bool create,
+					 LWLock **partitionLock)
+{
+	PgStat_StatTabEntry *result;
+	PgStat_ObjectKey key;
+	bool		found;
 
-				case PGSTAT_MTYPE_RESETSHAREDCOUNTER:
-					pgstat_recv_resetsharedcounter(
-									   (PgStat_MsgResetsharedcounter *) &msg,
-												   len);
-					break;
+	key.databaseid = databaseid;
+	key.objectid = tableoid;
 
-				case PGSTAT_MTYPE_RESETSINGLECOUNTER:
-					pgstat_recv_resetsinglecounter(
-									   (PgStat_MsgResetsinglecounter *) &msg,
-												   len);
-					break;
+	result = (PgStat_StatTabEntry *) pgstat_lock_entry(pgStatSharedTabHash,
+													   &key, create,
+													   &found, partitionLock);
 
-				case PGSTAT_MTYPE_AUTOVAC_START:
-					pgstat_recv_autovac((PgStat_MsgAutovacStart *) &msg, len);
-					break;
-
-				case PGSTAT_MTYPE_VACUUM:
-					pgstat_recv_vacuum((PgStat_MsgVacuum *) &msg, len);
-					break;
-
-				case PGSTAT_MTYPE_ANALYZE:
-					pgstat_recv_analyze((PgStat_MsgAnalyze *) &msg, len);
-					break;
-
-				case PGSTAT_MTYPE_ARCHIVER:
-					pgstat_recv_archiver((PgStat_MsgArchiver *) &msg, len);
-					break;
-
-				case PGSTAT_MTYPE_BGWRITER:
-					pgstat_recv_bgwriter((PgStat_MsgBgWriter *) &msg, len);
-					break;
-
-				case PGSTAT_MTYPE_FUNCSTAT:
-					pgstat_recv_funcstat((PgStat_MsgFuncstat *) &msg, len);
-					break;
-
-				case PGSTAT_MTYPE_FUNCPURGE:
-					pgstat_recv_funcpurge((PgStat_MsgFuncpurge *) &msg, len);
-					break;
-
-				case PGSTAT_MTYPE_RECOVERYCONFLICT:
-					pgstat_recv_recoveryconflict((PgStat_MsgRecoveryConflict *) &msg, len);
-					break;
+	/* If it's new, initialize it. */
+	if (result != NULL && !found)
+	{
+		result->numscans = 0;
+		result->tuples_returned = 0;
+		result->tuples_fetched = 0;
+		result->tuples_inserted = 0;
+		result->tuples_updated = 0;
+		result->tuples_deleted = 0;
+		result->tuples_hot_updated = 0;
+		result->n_live_tuples = 0;
+		result->n_dead_tuples = 0;
+		result->changes_since_analyze = 0;
+		result->blocks_fetched = 0;
+		result->blocks_hit = 0;
+		result->vacuum_timestamp = 0;
+		result->vacuum_count = 0;
+		result->autovac_vacuum_timestamp = 0;
+		result->autovac_vacuum_count = 0;
+		result->analyze_timestamp = 0;
+		result->analyze_count = 0;
+		result->autovac_analyze_timestamp = 0;
+		result->autovac_analyze_count = 0;
+	}
 
-				case PGSTAT_MTYPE_DEADLOCK:
-					pgstat_recv_deadlock((PgStat_MsgDeadlock *) &msg, len);
-					break;
+	return result;
+}
 
-				case PGSTAT_MTYPE_TEMPFILE:
-					pgstat_recv_tempfile((PgStat_MsgTempFile *) &msg, len);
-					break;
 
-				default:
-					break;
-			}
-		}						/* end of inner message-processing loop */
-
-		/* Sleep until there's something to do */
-#ifndef WIN32
-		wr = WaitLatchOrSocket(MyLatch,
-					 WL_LATCH_SET | WL_POSTMASTER_DEATH | WL_SOCKET_READABLE,
-							   pgStatSock,
-							   -1L);
-#else
+/*
+ * Lookup the shared hash table entry for the specified function, as
+ * pgstat_lock_entry does.
+ */
+static PgStat_StatFuncEntry *
+pgstat_get_func_entry(Oid databaseid, Oid functionid, bool create,
+					  LWLock **partitionLock)
+{
+	PgStat_StatFuncEntry *result;
+	PgStat_ObjectKey key;
+	bool		found;
 
-		/*
-		 * Windows, at least in its Windows Server 2003 R2 incarnation,
-		 * sometimes loses FD_READ events.  Waking up and retrying the recv()
-		 * fixes that, so don't sleep indefinitely.  This is a crock of the
-		 * first water, but until somebody wants to debug exactly what's
-		 * happening there, this is the best we can do.  The two-second
-		 * timeout matches our pre-9.2 behavior, and needs to be short enough
-		 * to not provoke "using stale statistics" complaints from
-		 * backend_read_statsfile.
-		 */
-		wr = WaitLatchOrSocket(MyLatch,
-		WL_LATCH_SET | WL_POSTMASTER_DEATH | WL_SOCKET_READABLE | WL_TIMEOUT,
-							   pgStatSock,
-							   2 * 1000L /* msec */ );
-#endif
+	key.databaseid = databaseid;
+	key.objectid = functionid;
 
-		/*
-		 * Emergency bailout if postmaster has died.  This is to avoid the
-		 * necessity for manual cleanup of all postmaster children.
-		 */
-		if (wr & WL_POSTMASTER_DEATH)
-			break;
-	}							/* end of outer loop */
+	result = (PgStat_StatFuncEntry *) pgstat_lock_entry(pgStatSharedFuncHash,
+														&key, create,
+														&found, partitionLock);
 
-	/*
-	 * Save the final stats to reuse at next startup.
-	 */
-	pgstat_write_statsfiles(true, true);
+	/* If it's new, initialize it. */
+	if (result != NULL && !found)
+	{
+		result->f_numcalls = 0;
+		result->f_total_time = 0;
+		result->f_self_time = 0;
+	}
 
-	exit(0);
+	return result;
 }
 
 
-/* SIGQUIT signal handler for collector process */
+/*
+ * Remove an entry from one of the shared hash tables, if it's there.
+ */
 static void
-pgstat_exit(SIGNAL_ARGS)
+pgstat_remove_entry(HTAB *htab, const void *key)
 {
-	int			save_errno = errno;
+	uint32		hashcode;
+	LWLock	   *lock;
 
-	need_exit = true;
-	SetLatch(MyLatch);
+	hashcode = get_hash_value(htab, key);
+	lock = PgStatHashPartitionLock(hashcode);
 
-	errno = save_errno;
+	LWLockAcquire(lock, LW_EXCLUSIVE);
+	(void) hash_search_with_hash_value(htab, key, hashcode, HASH_REMOVE, NULL);
+	LWLockRelease(lock);
 }
 
-/* SIGHUP handler for collector process */
+
+/*
+ * Remove all the table and function entries of a database.  The caller must
+ * hold all the partition locks exclusively.
+ */
 static void
-pgstat_sighup_handler(SIGNAL_ARGS)
+pgstat_remove_db_objects(Oid databaseid)
 {
-	int			save_errno = errno;
+	HASH_SEQ_STATUS hstat;
+	PgStat_StatTabEntry *tabentry;
+	PgStat_StatFuncEntry *funcentry;
+
+	hash_seq_init(&hstat, pgStatSharedTabHash);
+	while ((tabentry = (PgStat_StatTabEntry *) hash_seq_search(&hstat)) != NULL)
+	{
+		if (tabentry->databaseid != databaseid)
+			continue;
 
-	got_SIGHUP = true;
-	SetLatch(MyLatch);
+		/* dynahash allows removing the element just returned */
+		(void) hash_search(pgStatSharedTabHash, (void *) tabentry,
+						   HASH_REMOVE, NULL);
+	}
+
+	hash_seq_init(&hstat, pgStatSharedFuncHash);
+	while ((funcentry = (PgStat_StatFuncEntry *) hash_seq_search(&hstat)) != NULL)
+	{
+		if (funcentry->databaseid != databaseid)
+			continue;
 
-	errno = save_errno;
+		(void) hash_search(pgStatSharedFuncHash, (void *) funcentry,
+						   HASH_REMOVE, NULL);
+	}
 }
 
+
 /*
- * Subroutine to clear stats in a database entry
- *
- * Tables and functions hashes are initialized to empty.
+ * Acquire all the partition locks, in order, for an operation that scans or
+ * rewrites whole shared hash tables.
  */
 static void
-reset_dbentry_counters(PgStat_StatDBEntry *dbentry)
+pgstat_lock_all_partitions(LWLockMode mode)
 {
-	HASHCTL		hash_ctl;
-
-	dbentry->n_xact_commit = 0;
-	dbentry->n_xact_rollback = 0;
-	dbentry->n_blocks_fetched = 0;
-	dbentry->n_blocks_hit = 0;
-	dbentry->n_tuples_returned = 0;
-	dbentry->n_tuples_fetched = 0;
-	dbentry->n_tuples_inserted = 0;
-	dbentry->n_tuples_updated = 0;
-	dbentry->n_tuples_deleted = 0;
-	dbentry->last_autovac_time = 0;
-	dbentry->n_conflict_tablespace = 0;
-	dbentry->n_conflict_lock = 0;
-	dbentry->n_conflict_snapshot = 0;
-	dbentry->n_conflict_bufferpin = 0;
-	dbentry->n_conflict_startup_deadlock = 0;
-	dbentry->n_temp_files = 0;
-	dbentry->n_temp_bytes = 0;
-	dbentry->n_deadlocks = 0;
-	dbentry->n_block_read_time = 0;
-	dbentry->n_block_write_time = 0;
+	int			i;
 
-	dbentry->stat_reset_timestamp = GetCurrentTimestamp();
-	dbentry->stats_timestamp = 0;
+	for (i = 0; i < NUM_PGSTAT_PARTITIONS; i++)
+		LWLockAcquire(PgStatHashPartitionLockByIndex(i), mode);
+}
 
-	memset(&hash_ctl, 0, sizeof(hash_ctl));
-	hash_ctl.keysize = sizeof(Oid);
-	hash_ctl.entrysize = sizeof(PgStat_StatTabEntry);
-	dbentry->tables = hash_create("Per-database table",
-								  PGSTAT_TAB_HASH_SIZE,
-								  &hash_ctl,
-								  HASH_ELEM | HASH_BLOBS);
+static void
+pgstat_unlock_all_partitions(void)
+{
+	int			i;
 
-	hash_ctl.keysize = sizeof(Oid);
-	hash_ctl.entrysize = sizeof(PgStat_StatFuncEntry);
-	dbentry->functions = hash_create("Per-database function",
-									 PGSTAT_FUNCTION_HASH_SIZE,
-									 &hash_ctl,
-									 HASH_ELEM | HASH_BLOBS);
+	for (i = NUM_PGSTAT_PARTITIONS; --i >= 0;)
+		LWLockRelease(PgStatHashPartitionLockByIndex(i));
 }
 
+
 /*
- * Lookup the hash table entry for the specified database. If no hash
- * table entry exists, initialize it, if the create parameter is true.
- * Else, return NULL.
+ * Complain that the counts for the object with the given key in one of the
+ * shared hash tables are being dropped because the table is full.  A table
+ * without an entry is invisible to autovacuum, so the administrator must not
+ * miss this; but once a table is full, every backend touching an untracked
+ * object would otherwise log it at every flush.  So we complain at most once
+ * per PGSTAT_HASH_FULL_REPORT_INTERVAL for each hash table, and count the
+ * objects dropped in between.
  */
-static PgStat_StatDBEntry *
-pgstat_get_db_entry(Oid databaseid, bool create)
+static void
+pgstat_report_hash_full(HTAB *htab, const void *key)
 {
-	PgStat_StatDBEntry *result;
-	bool		found;
-	HASHACTION	action = (create ? HASH_ENTER : HASH_FIND);
-
-	/* Lookup or create the hash table entry for this database */
-	result = (PgStat_StatDBEntry *) hash_search(pgStatDBHash,
-												&databaseid,
-												action, &found);
+	const PgStat_ObjectKey *objkey = (const PgStat_ObjectKey *) key;
+	TimestampTz now = GetCurrentTimestamp();
+	int			which;
+	int			ndropped = 0;
+
+	if (htab == pgStatSharedDBHash)
+		which = PGSTAT_HASH_DB;
+	else if (htab == pgStatSharedTabHash)
+		which = PGSTAT_HASH_TAB;
+	else
+		which = PGSTAT_HASH_FUNC;
 
-	if (!create && !found)
-		return NULL;
+	SpinLockAcquire(&pgStatShmem->mutex);
+	pgStatShmem->hashFullDropped[which]++;
+	if (pgStatShmem->hashFullReported[which] == 0 ||
+		TimestampDifferenceExceeds(pgStatShmem->hashFullReported[which], now,
+								   PGSTAT_HASH_FULL_REPORT_INTERVAL))
+	{
+		ndropped = pgStatShmem->hashFullDropped[which];
+		pgStatShmem->hashFullDropped[which] = 0;
+		pgStatShmem->hashFullReported[which] = now;
+	}
+	SpinLockRelease(&pgStatShmem->mutex);
 
-	/*
-	 * If not found, initialize the new one.  This creates empty hash tables
-	 * for tables and functions, too.
-	 */
-	if (!found)
-		reset_dbentry_counters(result);
+	if (ndropped == 0)
+		return;
 
-	return result;
+	if (which == PGSTAT_HASH_DB)
+		ereport(LOG,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of shared memory for statistics"),
+				 errdetail_plural("Statistics for %d database were not stored since the last such message, most recently for database %u.",
+								  "Statistics for %d databases were not stored since the last such message, most recently for database %u.",
+								  ndropped, ndropped, *(const Oid *) key),
+				 errhint("You might need to increase max_stats_entries.")));
+	else if (which == PGSTAT_HASH_TAB)
+		ereport(LOG,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of shared memory for statistics"),
+				 errdetail_plural("Statistics for %d relation were not stored since the last such message, most recently for relation %u of database %u.",
+								  "Statistics for %d relations were not stored since the last such message, most recently for relation %u of database %u.",
+								  ndropped, ndropped,
+								  objkey->objectid, objkey->databaseid),
+				 errhint("You might need to increase max_stats_entries.")));
+	else
+		ereport(LOG,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of shared memory for statistics"),
+				 errdetail_plural("Statistics for %d function were not stored since the last such message, most recently for function %u of database %u.",
+								  "Statistics for %d functions were not stored since the last such message, most recently for function %u of database %u.",
+								  ndropped, ndropped,
+								  objkey->objectid, objkey->databaseid),
+				 errhint("You might need to increase max_stats_entries.")));
 }
 
 
 /*
- * Lookup the hash table entry for the specified table. If no hash
- * table entry exists, initialize it, if the create parameter is true.
- * Else, return NULL.
+ * Copy an entry of one of the shared hash tables into *dest, which is of the
+ * given size.  Returns false if there's no such entry.
  */
-static PgStat_StatTabEntry *
-pgstat_get_tab_entry(PgStat_StatDBEntry *dbentry, Oid tableoid, bool create)
+static bool
+pgstat_copy_entry(HTAB *htab, const void *key, void *dest, Size size)
 {
-	PgStat_StatTabEntry *result;
-	bool		found;
-	HASHACTION	action = (create ? HASH_ENTER : HASH_FIND);
+	uint32		hashcode;
+	LWLock	   *lock;
+	void	   *entry;
 
-	/* Lookup or create the hash table entry for this table */
-	result = (PgStat_StatTabEntry *) hash_search(dbentry->tables,
-												 &tableoid,
-												 action, &found);
+	hashcode = get_hash_value(htab, key);
+	lock = PgStatHashPartitionLock(hashcode);
 
-	if (!create && !found)
-		return NULL;
+	LWLockAcquire(lock, LW_SHARED);
+	entry = hash_search_with_hash_value(htab, key, hashcode, HASH_FIND, NULL);
+	if (entry != NULL)
+		memcpy(dest, entry, size);
+	LWLockRelease(lock);
 
-	/* If not found, initialize the new one. */
-	if (!found)
-	{
-		result->numscans = 0;
-		result->tuples_returned = 0;
-		result->tuples_fetched = 0;
-		result->tuples_inserted = 0;
-		result->tuples_updated = 0;
-		result->tuples_deleted = 0;
-		result->tuples_hot_updated = 0;
-		result->n_live_tuples = 0;
-		result->n_dead_tuples = 0;
-		result->changes_since_analyze = 0;
-		result->blocks_fetched = 0;
-		result->blocks_hit = 0;
-		result->vacuum_timestamp = 0;
-		result->vacuum_count = 0;
-		result->autovac_vacuum_timestamp = 0;
-		result->autovac_vacuum_count = 0;
-		result->analyze_timestamp = 0;
-		result->analyze_count = 0;
-		result->autovac_analyze_timestamp = 0;
-		result->autovac_analyze_count = 0;
-	}
-
-	return result;
+	return entry != NULL;
 }
 
 
 /* ----------
- * pgstat_write_statsfiles() -
- *		Write the global statistics file, as well as requested DB files.
- *
- *	If writing to the permanent files (happens when the collector is
- *	shutting down only), remove the temporary files so that backends
- *	starting up under a new postmaster can't read the old data before
- *	the new collector is ready.
+ * pgstat_write_statsfile() -
+ *		Write the shared statistics out to the permanent stats file.
  *
- *	When 'allDbs' is false, only the requested databases (listed in
- *	last_statrequests) will be written; otherwise, all databases will be
- *	written.
+ *	This is done only at shutdown, by the checkpointer (or a standalone
+ *	backend), once regular backends are gone.  The startup process reads the
+ *	file back at the next clean startup.
  * ----------
  */
-static void
-pgstat_write_statsfiles(bool permanent, bool allDbs)
+void
+pgstat_write_statsfile(void)
 {
 	HASH_SEQ_STATUS hstat;
 	PgStat_StatDBEntry *dbentry;
+	PgStat_StatTabEntry *tabentry;
+	PgStat_StatFuncEntry *funcentry;
+	PgStat_GlobalStats gstats;
+	PgStat_ArchiverStats astats;
 	FILE	   *fpout;
 	int32		format_id;
-	const char *tmpfile = permanent ? PGSTAT_STAT_PERMANENT_TMPFILE : pgstat_stat_tmpname;
-	const char *statfile = permanent ? PGSTAT_STAT_PERMANENT_FILENAME : pgstat_stat_filename;
+	const char *tmpfile = PGSTAT_STAT_PERMANENT_TMPFILE;
+	const char *statfile = PGSTAT_STAT_PERMANENT_FILENAME;
 	int			rc;
 
+	if (pgStatShmem == NULL)
+		return;
+
 	elog(DEBUG2, "writing stats file \"%s\"", statfile);
 
 	/*
@@ -3747,11 +3538,6 @@ pgstat_write_statsfiles(bool permanent, bool allDbs)
 		return;
 	}
 
-	/*
-	 * Set the timestamp of the stats file.
-	 */
-	globalStats.stats_timestamp = GetCurrentTimestamp();
-
 	/*
 	 * Write the file header --- currently just a format ID.
 	 */
@@ -3760,199 +3546,52 @@ pgstat_write_statsfiles(bool permanent, bool allDbs)
 	(void) rc;					/* we'll check for error with ferror */
 
 	/*
-	 * Write global stats struct
+	 * Write global and archiver stats structs
 	 */
-	rc = fwrite(&globalStats, sizeof(globalStats), 1, fpout);
-	(void) rc;					/* we'll check for error with ferror */
+	SpinLockAcquire(&pgStatShmem->mutex);
+	memcpy(&gstats, &pgStatShmem->globalStats, sizeof(gstats));
+	memcpy(&astats, &pgStatShmem->archiverStats, sizeof(astats));
+	SpinLockRelease(&pgStatShmem->mutex);
 
-	/*
-	 * Write archiver stats struct
-	 */
-	rc = fwrite(&archiverStats, sizeof(archiverStats), 1, fpout);
+	gstats.stats_timestamp = GetCurrentTimestamp();
+
+	rc = fwrite(&gstats, sizeof(gstats), 1, fpout);
+	(void) rc;					/* we'll check for error with ferror */
+	rc = fwrite(&astats, sizeof(astats), 1, fpout);
 	(void) rc;					/* we'll check for error with ferror */
 
 	/*
-	 * Walk through the database table.
+	 * Walk through the shared hash tables.  Nobody should be updating them
+	 * anymore, but lock them anyway.
 	 */
-	hash_seq_init(&hstat, pgStatDBHash);
+	pgstat_lock_all_partitions(LW_SHARED);
+
+	hash_seq_init(&hstat, pgStatSharedDBHash);
 	while ((dbentry = (PgStat_StatDBEntry *) hash_seq_search(&hstat)) != NULL)
 	{
-		/*
-		 * Write out the tables and functions into the DB stat file, if
-		 * required.
-		 *
-		 * We need to do this before the dbentry write, to ensure the
-		 * timestamps written to both are consistent.
-		 */
-		if (allDbs || pgstat_db_requested(dbentry->databaseid))
-		{
-			dbentry->stats_timestamp = globalStats.stats_timestamp;
-			pgstat_write_db_statsfile(dbentry, permanent);
-		}
-
-		/*
-		 * Write out the DB entry. We don't write the tables or functions
-		 * pointers, since they're of no use to any other process.
-		 */
 		fputc('D', fpout);
-		rc = fwrite(dbentry, offsetof(PgStat_StatDBEntry, tables), 1, fpout);
+		rc = fwrite(dbentry, sizeof(PgStat_StatDBEntry), 1, fpout);
 		(void) rc;				/* we'll check for error with ferror */
 	}
 
-	/*
-	 * No more output to be done. Close the temp file and replace the old
-	 * pgstat.stat with it.  The ferror() check replaces testing for error
-	 * after each individual fputc or fwrite above.
-	 */
-	fputc('E', fpout);
-
-	if (ferror(fpout))
-	{
-		ereport(LOG,
-				(errcode_for_file_access(),
-			   errmsg("could not write temporary statistics file \"%s\": %m",
-					  tmpfile)));
-		FreeFile(fpout);
-		unlink(tmpfile);
-	}
-	else if (FreeFile(fpout) < 0)
-	{
-		ereport(LOG,
-				(errcode_for_file_access(),
-			   errmsg("could not close temporary statistics file \"%s\": %m",
-					  tmpfile)));
-		unlink(tmpfile);
-	}
-	else if (rename(tmpfile, statfile) < 0)
-	{
-		ereport(LOG,
-				(errcode_for_file_access(),
-				 errmsg("could not rename temporary statistics file \"%s\" to \"%s\": %m",
-						tmpfile, statfile)));
-		unlink(tmpfile);
-	}
-
-	if (permanent)
-		unlink(pgstat_stat_filename);
-
-	/*
-	 * Now throw away the list of requests.  Note that requests sent after we
-	 * started the write are still waiting on the network socket.
-	 */
-	if (!slist_is_empty(&last_statrequests))
-	{
-		slist_mutable_iter iter;
-
-		/*
-		 * Strictly speaking we should do slist_delete_current() before
-		 * freeing each request struct.  We skip that and instead
-		 * re-initialize the list header at the end.  Nonetheless, we must use
-		 * slist_foreach_modify, not just slist_foreach, since we will free
-		 * the node's storage before advancing.
-		 */
-		slist_foreach_modify(iter, &last_statrequests)
-		{
-			DBWriteRequest *req;
-
-			req = slist_container(DBWriteRequest, next, iter.cur);
-			pfree(req);
-		}
-
-		slist_init(&last_statrequests);
-	}
-}
-
-/*
- * return the filename for a DB stat file; filename is the output buffer,
- * of length len.
- */
-static void
-get_dbstat_filename(bool permanent, bool tempname, Oid databaseid,
-					char *filename, int len)
-{
-	int			printed;
-
-	/* NB -- pgstat_reset_remove_files knows about the pattern this uses */
-	printed = snprintf(filename, len, "%s/db_%u.%s",
-					   permanent ? PGSTAT_STAT_PERMANENT_DIRECTORY :
-					   pgstat_stat_directory,
-					   databaseid,
-					   tempname ? "tmp" : "stat");
-	if (printed > len)
-		elog(ERROR, "overlength pgstat path");
-}
-
-/* ----------
- * pgstat_write_db_statsfile() -
- *		Write the stat file for a single database.
- *
- *	If writing to the permanent file (happens when the collector is
- *	shutting down only), remove the temporary file so that backends
- *	starting up under a new postmaster can't read the old data before
- *	the new collector is ready.
- * ----------
- */
-static void
-pgstat_write_db_statsfile(PgStat_StatDBEntry *dbentry, bool permanent)
-{
-	HASH_SEQ_STATUS tstat;
-	HASH_SEQ_STATUS fstat;
-	PgStat_StatTabEntry *tabentry;
-	PgStat_StatFuncEntry *funcentry;
-	FILE	   *fpout;
-	int32		format_id;
-	Oid			dbid = dbentry->databaseid;
-	int			rc;
-	char		tmpfile[MAXPGPATH];
-	char		statfile[MAXPGPATH];
-
-	get_dbstat_filename(permanent, true, dbid, tmpfile, MAXPGPATH);
-	get_dbstat_filename(permanent, false, dbid, statfile, MAXPGPATH);
-
-	elog(DEBUG2, "writing stats file \"%s\"", statfile);
-
-	/*
-	 * Open the statistics temp file to write out the current values.
-	 */
-	fpout = AllocateFile(tmpfile, PG_BINARY_W);
-	if (fpout == NULL)
-	{
-		ereport(LOG,
-				(errcode_for_file_access(),
-				 errmsg("could not open temporary statistics file \"%s\": %m",
-						tmpfile)));
-		return;
-	}
-
-	/*
-	 * Write the file header --- currently just a format ID.
-	 */
-	format_id = PGSTAT_FILE_FORMAT_ID;
-	rc = fwrite(&format_id, sizeof(format_id), 1, fpout);
-	(void) rc;					/* we'll check for error with ferror */
-
-	/*
-	 * Walk through the database's access stats per table.
-	 */
-	hash_seq_init(&tstat, dbentry->tables);
-	while ((tabentry = (PgStat_StatTabEntry *) hash_seq_search(&tstat)) != NULL)
+	hash_seq_init(&hstat, pgStatSharedTabHash);
+	while ((tabentry = (PgStat_StatTabEntry *) hash_seq_search(&hstat)) != NULL)
 	{
 		fputc('T', fpout);
 		rc = fwrite(tabentry, sizeof(PgStat_StatTabEntry), 1, fpout);
 		(void) rc;				/* we'll check for error with ferror */
 	}
 
-	/*
-	 * Walk through the database's function stats table.
-	 */
-	hash_seq_init(&fstat, dbentry->functions);
-	while ((funcentry = (PgStat_StatFuncEntry *) hash_seq_search(&fstat)) != NULL)
+	hash_seq_init(&hstat, pgStatSharedFuncHash);
+	while ((funcentry = (PgStat_StatFuncEntry *) hash_seq_search(&hstat)) != NULL)
 	{
 		fputc('F', fpout);
 		rc = fwrite(funcentry, sizeof(PgStat_StatFuncEntry), 1, fpout);
 		(void) rc;				/* we'll check for error with ferror */
 	}
 
+	pgstat_unlock_all_partitions();
+
 	/*
 	 * No more output to be done. Close the temp file and replace the old
 	 * pgstat.stat with it.  The ferror() check replaces testing for error
@@ -3985,123 +3624,82 @@ pgstat_write_db_statsfile(PgStat_StatDBEntry *dbentry, bool permanent)
 						tmpfile, statfile)));
 		unlink(tmpfile);
 	}
-
-	if (permanent)
-	{
-		get_dbstat_filename(false, false, dbid, statfile, MAXPGPATH);
-
-		elog(DEBUG2, "removing temporary stats file \"%s\"", statfile);
-		unlink(statfile);
-	}
 }
 
+
 /* ----------
- * pgstat_read_statsfiles() -
+ * pgstat_read_statsfile() -
  *
- *	Reads in the existing statistics collector files and initializes the
- *	databases' hash table.  If the permanent file name is requested (which
- *	only happens in the stats collector itself), also remove the file after
- *	reading; the in-memory status is now authoritative, and the permanent file
- *	would be out of date in case somebody else reads it.
- *
- *	If a deep read is requested, table/function stats are read also, otherwise
- *	the table/function hash tables remain empty.
+ *	Reads the statistics saved at the last shutdown into the shared hash
+ *	tables.  Called by the startup process when no recovery is needed, before
+ *	anybody else can touch the statistics.  The file is removed afterwards:
+ *	shared memory is now authoritative, and the file would be out of date if
+ *	we crashed.
  * ----------
  */
-static HTAB *
-pgstat_read_statsfiles(Oid onlydb, bool permanent, bool deep)
+void
+pgstat_read_statsfile(void)
 {
-	PgStat_StatDBEntry *dbentry;
 	PgStat_StatDBEntry dbbuf;
-	HASHCTL		hash_ctl;
-	HTAB	   *dbhash;
+	PgStat_StatTabEntry tabbuf;
+	PgStat_StatFuncEntry funcbuf;
+	PgStat_GlobalStats gstats;
+	PgStat_ArchiverStats astats;
+	void	   *entry;
 	FILE	   *fpin;
 	int32		format_id;
 	bool		found;
-	const char *statfile = permanent ? PGSTAT_STAT_PERMANENT_FILENAME : pgstat_stat_filename;
+	int			ndropped = 0;
+	const char *statfile = PGSTAT_STAT_PERMANENT_FILENAME;
 
-	/*
-	 * The tables will live in pgStatLocalContext.
-	 */
-	pgstat_setup_memcxt();
-
-	/*
-	 * Create the DB hashtable
-	 */
-	memset(&hash_ctl, 0, sizeof(hash_ctl));
-	hash_ctl.keysize = sizeof(Oid);
-	hash_ctl.entrysize = sizeof(PgStat_StatDBEntry);
-	hash_ctl.hcxt = pgStatLocalContext;
-	dbhash = hash_create("Databases hash", PGSTAT_DB_HASH_SIZE, &hash_ctl,
-						 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
-
-	/*
-	 * Clear out global and archiver statistics so they start from zero in
-	 * case we can't load an existing statsfile.
-	 */
-	memset(&globalStats, 0, sizeof(globalStats));
-	memset(&archiverStats, 0, sizeof(archiverStats));
-
-	/*
-	 * Set the current timestamp (will be kept only in case we can't load an
-	 * existing statsfile).
-	 */
-	globalStats.stat_reset_timestamp = GetCurrentTimestamp();
-	archiverStats.stat_reset_timestamp = globalStats.stat_reset_timestamp;
+	if (pgStatShmem == NULL)
+		return;
 
 	/*
-	 * Try to open the stats file. If it doesn't exist, the backends simply
-	 * return zero for anything and the collector simply starts from scratch
-	 * with empty counters.
-	 *
-	 * ENOENT is a possibility if the stats collector is not running or has
-	 * not yet written the stats file the first time.  Any other failure
-	 * condition is suspicious.
+	 * Try to open the stats file.  If it doesn't exist, we simply start from
+	 * scratch with empty counters.
 	 */
 	if ((fpin = AllocateFile(statfile, PG_BINARY_R)) == NULL)
 	{
 		if (errno != ENOENT)
-			ereport(pgStatRunningInCollector ? LOG : WARNING,
+			ereport(LOG,
 					(errcode_for_file_access(),
 					 errmsg("could not open statistics file \"%s\": %m",
 							statfile)));
-		return dbhash;
+		return;
 	}
 
+	pgstat_lock_all_partitions(LW_EXCLUSIVE);
+
 	/*
 	 * Verify it's of the expected format.
 	 */
 	if (fread(&format_id, 1, sizeof(format_id), fpin) != sizeof(format_id) ||
 		format_id != PGSTAT_FILE_FORMAT_ID)
 	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
+		ereport(LOG,
 				(errmsg("corrupted statistics file \"%s\"", statfile)));
 		goto done;
 	}
 
 	/*
-	 * Read global stats struct
+	 * Read global and archiver stats structs
 	 */
-	if (fread(&globalStats, 1, sizeof(globalStats), fpin) != sizeof(globalStats))
+	if (fread(&gstats, 1, sizeof(gstats), fpin) != sizeof(gstats) ||
+		fread(&astats, 1, sizeof(astats), fpin) != sizeof(astats))
 	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
+		ereport(LOG,
 				(errmsg("corrupted statistics file \"%s\"", statfile)));
 		goto done;
 	}
 
-	/*
-	 * Read archiver stats struct
-	 */
-	if (fread(&archiverStats, 1, sizeof(archiverStats), fpin) != sizeof(archiverStats))
-	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
-				(errmsg("corrupted statistics file \"%s\"", statfile)));
-		goto done;
-	}
+	SpinLockAcquire(&pgStatShmem->mutex);
+	memcpy(&pgStatShmem->globalStats, &gstats, sizeof(gstats));
+	memcpy(&pgStatShmem->archiverStats, &astats, sizeof(astats));
+	SpinLockRelease(&pgStatShmem->mutex);
 
 	/*
-	 * We found an existing collector stats file. Read it and put all the
-	 * hashtable entries into place.
+	 * Read the entries and put them into place.
 	 */
 	for (;;)
 	{
@@ -4112,378 +3710,98 @@ pgstat_read_statsfiles(Oid onlydb, bool permanent, bool deep)
 				 * follows.
 				 */
 			case 'D':
-				if (fread(&dbbuf, 1, offsetof(PgStat_StatDBEntry, tables),
-						  fpin) != offsetof(PgStat_StatDBEntry, tables))
+				if (fread(&dbbuf, 1, sizeof(dbbuf), fpin) != sizeof(dbbuf))
 				{
-					ereport(pgStatRunningInCollector ? LOG : WARNING,
+					ereport(LOG,
 							(errmsg("corrupted statistics file \"%s\"",
 									statfile)));
 					goto done;
 				}
 
-				/*
-				 * Add to the DB hash
-				 */
-				dbentry = (PgStat_StatDBEntry *) hash_search(dbhash,
-												  (void *) &dbbuf.databaseid,
-															 HASH_ENTER,
-															 &found);
+				entry = hash_search(pgStatSharedDBHash,
+									(void *) &dbbuf.databaseid,
+									HASH_ENTER_NULL, &found);
+				if (entry == NULL)
+				{
+					ndropped++;
+					break;
+				}
 				if (found)
 				{
-					ereport(pgStatRunningInCollector ? LOG : WARNING,
+					ereport(LOG,
 							(errmsg("corrupted statistics file \"%s\"",
 									statfile)));
 					goto done;
 				}
 
-				memcpy(dbentry, &dbbuf, sizeof(PgStat_StatDBEntry));
-				dbentry->tables = NULL;
-				dbentry->functions = NULL;
-
-				/*
-				 * Don't collect tables if not the requested DB (or the
-				 * shared-table info)
-				 */
-				if (onlydb != InvalidOid)
-				{
-					if (dbbuf.databaseid != onlydb &&
-						dbbuf.databaseid != InvalidOid)
-						break;
-				}
-
-				memset(&hash_ctl, 0, sizeof(hash_ctl));
-				hash_ctl.keysize = sizeof(Oid);
-				hash_ctl.entrysize = sizeof(PgStat_StatTabEntry);
-				hash_ctl.hcxt = pgStatLocalContext;
-				dbentry->tables = hash_create("Per-database table",
-											  PGSTAT_TAB_HASH_SIZE,
-											  &hash_ctl,
-									  HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
-
-				hash_ctl.keysize = sizeof(Oid);
-				hash_ctl.entrysize = sizeof(PgStat_StatFuncEntry);
-				hash_ctl.hcxt = pgStatLocalContext;
-				dbentry->functions = hash_create("Per-database function",
-												 PGSTAT_FUNCTION_HASH_SIZE,
-												 &hash_ctl,
-									  HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
-
-				/*
-				 * If requested, read the data from the database-specific
-				 * file. If there was onlydb specified (!= InvalidOid), we
-				 * would not get here because of a break above. So we don't
-				 * need to recheck.
-				 */
-				if (deep)
-					pgstat_read_db_statsfile(dbentry->databaseid,
-											 dbentry->tables,
-											 dbentry->functions,
-											 permanent);
-
+				memcpy(entry, &dbbuf, sizeof(dbbuf));
 				break;
 
-			case 'E':
-				goto done;
-
-			default:
-				ereport(pgStatRunningInCollector ? LOG : WARNING,
-						(errmsg("corrupted statistics file \"%s\"",
-								statfile)));
-				goto done;
-		}
-	}
-
-done:
-	FreeFile(fpin);
-
-	/* If requested to read the permanent file, also get rid of it. */
-	if (permanent)
-	{
-		elog(DEBUG2, "removing permanent stats file \"%s\"", statfile);
-		unlink(statfile);
-	}
-
-	return dbhash;
-}
-
-
-/* ----------
- * pgstat_read_db_statsfile() -
- *
- *	Reads in the existing statistics collector file for the given database,
- *	and initializes the tables and functions hash tables.
- *
- *	As pgstat_read_statsfiles, if the permanent file is requested, it is
- *	removed after reading.
- * ----------
- */
-static void
-pgstat_read_db_statsfile(Oid databaseid, HTAB *tabhash, HTAB *funchash,
-						 bool permanent)
-{
-	PgStat_StatTabEntry *tabentry;
-	PgStat_StatTabEntry tabbuf;
-	PgStat_StatFuncEntry funcbuf;
-	PgStat_StatFuncEntry *funcentry;
-	FILE	   *fpin;
-	int32		format_id;
-	bool		found;
-	char		statfile[MAXPGPATH];
-
-	get_dbstat_filename(permanent, false, databaseid, statfile, MAXPGPATH);
-
-	/*
-	 * Try to open the stats file. If it doesn't exist, the backends simply
-	 * return zero for anything and the collector simply starts from scratch
-	 * with empty counters.
-	 *
-	 * ENOENT is a possibility if the stats collector is not running or has
-	 * not yet written the stats file the first time.  Any other failure
-	 * condition is suspicious.
-	 */
-	if ((fpin = AllocateFile(statfile, PG_BINARY_R)) == NULL)
-	{
-		if (errno != ENOENT)
-			ereport(pgStatRunningInCollector ? LOG : WARNING,
-					(errcode_for_file_access(),
-					 errmsg("could not open statistics file \"%s\": %m",
-							statfile)));
-		return;
-	}
-
-	/*
-	 * Verify it's of the expected format.
-	 */
-	if (fread(&format_id, 1, sizeof(format_id), fpin) != sizeof(format_id) ||
-		format_id != PGSTAT_FILE_FORMAT_ID)
-	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
-				(errmsg("corrupted statistics file \"%s\"", statfile)));
-		goto done;
-	}
-
-	/*
-	 * We found an existing collector stats file. Read it and put all the
-	 * hashtable entries into place.
-	 */
-	for (;;)
-	{
-		switch (fgetc(fpin))
-		{
 				/*
 				 * 'T'	A PgStat_StatTabEntry follows.
 				 */
 			case 'T':
-				if (fread(&tabbuf, 1, sizeof(PgStat_StatTabEntry),
-						  fpin) != sizeof(PgStat_StatTabEntry))
+				if (fread(&tabbuf, 1, sizeof(tabbuf), fpin) != sizeof(tabbuf))
 				{
-					ereport(pgStatRunningInCollector ? LOG : WARNING,
+					ereport(LOG,
 							(errmsg("corrupted statistics file \"%s\"",
 									statfile)));
 					goto done;
 				}
 
-				/*
-				 * Skip if table belongs to a not requested database.
-				 */
-				if (tabhash == NULL)
-					break;
-
-				tabentry = (PgStat_StatTabEntry *) hash_search(tabhash,
-													(void *) &tabbuf.tableid,
-														 HASH_ENTER, &found);
-
-				if (found)
-				{
-					ereport(pgStatRunningInCollector ? LOG : WARNING,
-							(errmsg("corrupted statistics file \"%s\"",
-									statfile)));
-					goto done;
-				}
-
-				memcpy(tabentry, &tabbuf, sizeof(tabbuf));
-				break;
-
-				/*
-				 * 'F'	A PgStat_StatFuncEntry follows.
-				 */
-			case 'F':
-				if (fread(&funcbuf, 1, sizeof(PgStat_StatFuncEntry),
-						  fpin) != sizeof(PgStat_StatFuncEntry))
+				entry = hash_search(pgStatSharedTabHash, (void *) &tabbuf,
+									HASH_ENTER_NULL, &found);
+				if (entry == NULL)
 				{
-					ereport(pgStatRunningInCollector ? LOG : WARNING,
-							(errmsg("corrupted statistics file \"%s\"",
-									statfile)));
-					goto done;
-				}
-
-				/*
-				 * Skip if function belongs to a not requested database.
-				 */
-				if (funchash == NULL)
+					ndropped++;
 					break;
-
-				funcentry = (PgStat_StatFuncEntry *) hash_search(funchash,
-												(void *) &funcbuf.functionid,
-														 HASH_ENTER, &found);
-
-				if (found)
-				{
-					ereport(pgStatRunningInCollector ? LOG : WARNING,
-							(errmsg("corrupted statistics file \"%s\"",
-									statfile)));
-					goto done;
+				}
+				if (found)
+				{
+					ereport(LOG,
+							(errmsg("corrupted statistics file \"%s\"",
+									statfile)));
+					goto done;
 				}
 
-				memcpy(funcentry, &funcbuf, sizeof(funcbuf));
-				break;
-
-				/*
-				 * 'E'	The EOF marker of a complete stats file.
-				 */
-			case 'E':
-				goto done;
-
-			default:
-				ereport(pgStatRunningInCollector ? LOG : WARNING,
-						(errmsg("corrupted statistics file \"%s\"",
-								statfile)));
-				goto done;
-		}
-	}
-
-done:
-	FreeFile(fpin);
-
-	if (permanent)
-	{
-		elog(DEBUG2, "removing permanent stats file \"%s\"", statfile);
-		unlink(statfile);
-	}
-
-	return;
-}
-
-/* ----------
- * pgstat_read_db_statsfile_timestamp() -
- *
- *	Attempt to determine the timestamp of the last db statfile write.
- *	Returns TRUE if successful; the timestamp is stored in *ts.
- *
- *	This needs to be careful about handling databases for which no stats file
- *	exists, such as databases without a stat entry or those not yet written:
- *
- *	- if there's a database entry in the global file, return the corresponding
- *	stats_timestamp value.
- *
- *	- if there's no db stat entry (e.g. for a new or inactive database),
- *	there's no stats_timestamp value, but also nothing to write so we return
- *	the timestamp of the global statfile.
- * ----------
- */
-static bool
-pgstat_read_db_statsfile_timestamp(Oid databaseid, bool permanent,
-								   TimestampTz *ts)
-{
-	PgStat_StatDBEntry dbentry;
-	PgStat_GlobalStats myGlobalStats;
-	PgStat_ArchiverStats myArchiverStats;
-	FILE	   *fpin;
-	int32		format_id;
-	const char *statfile = permanent ? PGSTAT_STAT_PERMANENT_FILENAME : pgstat_stat_filename;
-
-	/*
-	 * Try to open the stats file.  As above, anything but ENOENT is worthy of
-	 * complaining about.
-	 */
-	if ((fpin = AllocateFile(statfile, PG_BINARY_R)) == NULL)
-	{
-		if (errno != ENOENT)
-			ereport(pgStatRunningInCollector ? LOG : WARNING,
-					(errcode_for_file_access(),
-					 errmsg("could not open statistics file \"%s\": %m",
-							statfile)));
-		return false;
-	}
-
-	/*
-	 * Verify it's of the expected format.
-	 */
-	if (fread(&format_id, 1, sizeof(format_id), fpin) != sizeof(format_id) ||
-		format_id != PGSTAT_FILE_FORMAT_ID)
-	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
-				(errmsg("corrupted statistics file \"%s\"", statfile)));
-		FreeFile(fpin);
-		return false;
-	}
-
-	/*
-	 * Read global stats struct
-	 */
-	if (fread(&myGlobalStats, 1, sizeof(myGlobalStats),
-			  fpin) != sizeof(myGlobalStats))
-	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
-				(errmsg("corrupted statistics file \"%s\"", statfile)));
-		FreeFile(fpin);
-		return false;
-	}
-
-	/*
-	 * Read archiver stats struct
-	 */
-	if (fread(&myArchiverStats, 1, sizeof(myArchiverStats),
-			  fpin) != sizeof(myArchiverStats))
-	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
-				(errmsg("corrupted statistics file \"%s\"", statfile)));
-		FreeFile(fpin);
-		return false;
-	}
-
-	/* By default, we're going to return the timestamp of the global file. */
-	*ts = myGlobalStats.stats_timestamp;
+				memcpy(entry, &tabbuf, sizeof(tabbuf));
+				break;
 
-	/*
-	 * We found an existing collector stats file.  Read it and look for a
-	 * record for the requested database.  If found, use its timestamp.
-	 */
-	for (;;)
-	{
-		switch (fgetc(fpin))
-		{
 				/*
-				 * 'D'	A PgStat_StatDBEntry struct describing a database
-				 * follows.
+				 * 'F'	A PgStat_StatFuncEntry follows.
 				 */
-			case 'D':
-				if (fread(&dbentry, 1, offsetof(PgStat_StatDBEntry, tables),
-						  fpin) != offsetof(PgStat_StatDBEntry, tables))
+			case 'F':
+				if (fread(&funcbuf, 1, sizeof(funcbuf), fpin) != sizeof(funcbuf))
 				{
-					ereport(pgStatRunningInCollector ? LOG : WARNING,
+					ereport(LOG,
 							(errmsg("corrupted statistics file \"%s\"",
 									statfile)));
 					goto done;
 				}
 
-				/*
-				 * If this is the DB we're looking for, save its timestamp and
-				 * we're done.
-				 */
-				if (dbentry.databaseid == databaseid)
+				entry = hash_search(pgStatSharedFuncHash, (void *) &funcbuf,
+									HASH_ENTER_NULL, &found);
+				if (entry == NULL)
+				{
+					ndropped++;
+					break;
+				}
+				if (found)
 				{
-					*ts = dbentry.stats_timestamp;
+					ereport(LOG,
+							(errmsg("corrupted statistics file \"%s\"",
+									statfile)));
 					goto done;
 				}
 
+				memcpy(entry, &funcbuf, sizeof(funcbuf));
 				break;
 
 			case 'E':
 				goto done;
 
 			default:
-				ereport(pgStatRunningInCollector ? LOG : WARNING,
+				ereport(LOG,
 						(errmsg("corrupted statistics file \"%s\"",
 								statfile)));
 				goto done;
@@ -4491,127 +3809,20 @@ pgstat_read_db_statsfile_timestamp(Oid databaseid, bool permanent,
 	}
 
 done:
+	pgstat_unlock_all_partitions();
 	FreeFile(fpin);
-	return true;
-}
-
-/*
- * If not already done, read the statistics collector stats file into
- * some hash tables.  The results will be kept until pgstat_clear_snapshot()
- * is called (typically, at end of transaction).
- */
-static void
-backend_read_statsfile(void)
-{
-	TimestampTz min_ts = 0;
-	TimestampTz ref_ts = 0;
-	int			count;
-
-	/* already read it? */
-	if (pgStatDBHash)
-		return;
-	Assert(!pgStatRunningInCollector);
-
-	/*
-	 * Loop until fresh enough stats file is available or we ran out of time.
-	 * The stats inquiry message is sent repeatedly in case collector drops
-	 * it; but not every single time, as that just swamps the collector.
-	 */
-	for (count = 0; count < PGSTAT_POLL_LOOP_COUNT; count++)
-	{
-		bool		ok;
-		TimestampTz file_ts = 0;
-		TimestampTz cur_ts;
-
-		CHECK_FOR_INTERRUPTS();
-
-		ok = pgstat_read_db_statsfile_timestamp(MyDatabaseId, false, &file_ts);
-
-		cur_ts = GetCurrentTimestamp();
-		/* Calculate min acceptable timestamp, if we didn't already */
-		if (count == 0 || cur_ts < ref_ts)
-		{
-			/*
-			 * We set the minimum acceptable timestamp to PGSTAT_STAT_INTERVAL
-			 * msec before now.  This indirectly ensures that the collector
-			 * needn't write the file more often than PGSTAT_STAT_INTERVAL. In
-			 * an autovacuum worker, however, we want a lower delay to avoid
-			 * using stale data, so we use PGSTAT_RETRY_DELAY (since the
-			 * number of workers is low, this shouldn't be a problem).
-			 *
-			 * We don't recompute min_ts after sleeping, except in the
-			 * unlikely case that cur_ts went backwards.  So we might end up
-			 * accepting a file a bit older than PGSTAT_STAT_INTERVAL.  In
-			 * practice that shouldn't happen, though, as long as the sleep
-			 * time is less than PGSTAT_STAT_INTERVAL; and we don't want to
-			 * tell the collector that our cutoff time is less than what we'd
-			 * actually accept.
-			 */
-			ref_ts = cur_ts;
-			if (IsAutoVacuumWorkerProcess())
-				min_ts = TimestampTzPlusMilliseconds(ref_ts,
-													 -PGSTAT_RETRY_DELAY);
-			else
-				min_ts = TimestampTzPlusMilliseconds(ref_ts,
-													 -PGSTAT_STAT_INTERVAL);
-		}
-
-		/*
-		 * If the file timestamp is actually newer than cur_ts, we must have
-		 * had a clock glitch (system time went backwards) or there is clock
-		 * skew between our processor and the stats collector's processor.
-		 * Accept the file, but send an inquiry message anyway to make
-		 * pgstat_recv_inquiry do a sanity check on the collector's time.
-		 */
-		if (ok && file_ts > cur_ts)
-		{
-			/*
-			 * A small amount of clock skew between processors isn't terribly
-			 * surprising, but a large difference is worth logging.  We
-			 * arbitrarily define "large" as 1000 msec.
-			 */
-			if (file_ts >= TimestampTzPlusMilliseconds(cur_ts, 1000))
-			{
-				char	   *filetime;
-				char	   *mytime;
-
-				/* Copy because timestamptz_to_str returns a static buffer */
-				filetime = pstrdup(timestamptz_to_str(file_ts));
-				mytime = pstrdup(timestamptz_to_str(cur_ts));
-				elog(LOG, "stats collector's time %s is later than backend local time %s",
-					 filetime, mytime);
-				pfree(filetime);
-				pfree(mytime);
-			}
-
-			pgstat_send_inquiry(cur_ts, min_ts, MyDatabaseId);
-			break;
-		}
-
-		/* Normal acceptance case: file is not older than cutoff time */
-		if (ok && file_ts >= min_ts)
-			break;
-
-		/* Not there or too old, so kick the collector and wait a bit */
-		if ((count % PGSTAT_INQ_LOOP_COUNT) == 0)
-			pgstat_send_inquiry(cur_ts, min_ts, MyDatabaseId);
 
-		pg_usleep(PGSTAT_RETRY_DELAY * 1000L);
-	}
-
-	if (count >= PGSTAT_POLL_LOOP_COUNT)
+	if (ndropped > 0)
 		ereport(LOG,
-				(errmsg("using stale statistics instead of current ones "
-						"because stats collector is not responding")));
-
-	/*
-	 * Autovacuum launcher wants stats about all databases, but a shallow read
-	 * is sufficient.
-	 */
-	if (IsAutoVacuumLauncherProcess())
-		pgStatDBHash = pgstat_read_statsfiles(InvalidOid, false, false);
-	else
-		pgStatDBHash = pgstat_read_statsfiles(MyDatabaseId, false, true);
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of shared memory for statistics"),
+				 errdetail_plural("Statistics for %d object in file \"%s\" were not loaded.",
+								  "Statistics for %d objects in file \"%s\" were not loaded.",
+								  ndropped, ndropped, statfile),
+				 errhint("You might need to increase max_stats_entries.")));
+
+	elog(DEBUG2, "removing permanent stats file \"%s\"", statfile);
+	unlink(statfile);
 }
 
 
@@ -4633,6 +3844,49 @@ pgstat_setup_memcxt(void)
 }
 
 
+/* ----------
+ * pgstat_setup_snapshot() -
+ *
+ *	Create the hash tables holding this transaction's copies of shared
+ *	entries, if not already done.
+ * ----------
+ */
+static void
+pgstat_setup_snapshot(void)
+{
+	HASHCTL		hash_ctl;
+
+	if (pgStatDBHash != NULL)
+		return;
+
+	/*
+	 * The tables will live in pgStatLocalContext.
+	 */
+	pgstat_setup_memcxt();
+
+	memset(&hash_ctl, 0, sizeof(hash_ctl));
+	hash_ctl.keysize = sizeof(Oid);
+	hash_ctl.entrysize = sizeof(PgStat_StatDBEntry);
+	hash_ctl.hcxt = pgStatLocalContext;
+	pgStatDBHash = hash_create("Databases hash", PGSTAT_DB_HASH_SIZE,
+							   &hash_ctl,
+							   HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+
+	hash_ctl.keysize = sizeof(PgStat_ObjectKey);
+	hash_ctl.entrysize = sizeof(PgStat_StatTabEntry);
+	pgStatTabHash = hash_create("Per-database table", PGSTAT_TAB_HASH_SIZE,
+								&hash_ctl,
+								HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+
+	hash_ctl.keysize = sizeof(PgStat_ObjectKey);
+	hash_ctl.entrysize = sizeof(PgStat_StatFuncEntry);
+	pgStatFuncHash = hash_create("Per-database function",
+								 PGSTAT_FUNCTION_HASH_SIZE,
+								 &hash_ctl,
+								 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+}
+
+
 /* ----------
  * pgstat_clear_snapshot() -
  *
@@ -4653,94 +3907,14 @@ pgstat_clear_snapshot(void)
 	/* Reset variables */
 	pgStatLocalContext = NULL;
 	pgStatDBHash = NULL;
+	pgStatTabHash = NULL;
+	pgStatFuncHash = NULL;
+	globalStatsValid = false;
 	localBackendStatusTable = NULL;
 	localNumBackends = 0;
 }
 
 
-/* ----------
- * pgstat_recv_inquiry() -
- *
- *	Process stat inquiry requests.
- * ----------
- */
-static void
-pgstat_recv_inquiry(PgStat_MsgInquiry *msg, int len)
-{
-	slist_iter	iter;
-	DBWriteRequest *newreq;
-	PgStat_StatDBEntry *dbentry;
-
-	elog(DEBUG2, "received inquiry for database %u", msg->databaseid);
-
-	/*
-	 * Find the last write request for this DB.  If it's older than the
-	 * request's cutoff time, update it; otherwise there's nothing to do.
-	 *
-	 * Note that if a request is found, we return early and skip the below
-	 * check for clock skew.  This is okay, since the only way for a DB
-	 * request to be present in the list is that we have been here since the
-	 * last write round.
-	 */
-	slist_foreach(iter, &last_statrequests)
-	{
-		DBWriteRequest *req = slist_container(DBWriteRequest, next, iter.cur);
-
-		if (req->databaseid != msg->databaseid)
-			continue;
-
-		if (msg->cutoff_time > req->request_time)
-			req->request_time = msg->cutoff_time;
-		return;
-	}
-
-	/*
-	 * There's no request for this DB yet, so create one.
-	 */
-	newreq = palloc(sizeof(DBWriteRequest));
-
-	newreq->databaseid = msg->databaseid;
-	newreq->request_time = msg->clock_time;
-	slist_push_head(&last_statrequests, &newreq->next);
-
-	/*
-	 * If the requestor's local clock time is older than stats_timestamp, we
-	 * should suspect a clock glitch, ie system time going backwards; though
-	 * the more likely explanation is just delayed message receipt.  It is
-	 * worth expending a GetCurrentTimestamp call to be sure, since a large
-	 * retreat in the system clock reading could otherwise cause us to neglect
-	 * to update the stats file for a long time.
-	 */
-	dbentry = pgstat_get_db_entry(msg->databaseid, false);
-	if ((dbentry != NULL) && (msg->clock_time < dbentry->stats_timestamp))
-	{
-		TimestampTz cur_ts = GetCurrentTimestamp();
-
-		if (cur_ts < dbentry->stats_timestamp)
-		{
-			/*
-			 * Sure enough, time went backwards.  Force a new stats file write
-			 * to get back in sync; but first, log a complaint.
-			 */
-			char	   *writetime;
-			char	   *mytime;
-
-			/* Copy because timestamptz_to_str returns a static buffer */
-			writetime = pstrdup(timestamptz_to_str(dbentry->stats_timestamp));
-			mytime = pstrdup(timestamptz_to_str(cur_ts));
-			elog(LOG,
-				 "stats_timestamp %s is later than collector's time %s for database %u",
-				 writetime, mytime, dbentry->databaseid);
-			pfree(writetime);
-			pfree(mytime);
-
-			newreq->request_time = cur_ts;
-			dbentry->stats_timestamp = cur_ts - 1;
-		}
-	}
-}
-
-
 /* ----------
  * pgstat_recv_tabstat() -
  *
@@ -4752,62 +3926,28 @@ pgstat_recv_tabstat(PgStat_MsgTabstat *msg, int len)
 {
 	PgStat_StatDBEntry *dbentry;
 	PgStat_StatTabEntry *tabentry;
+	PgStat_TableCounts dbcounts;
+	LWLock	   *lock;
 	int			i;
-	bool		found;
-
-	dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
 
 	/*
-	 * Update database-wide stats.
+	 * Process all table entries in the message, adding up the database-wide
+	 * totals as we go.  Each table entry is locked separately, so that we
+	 * never hold more than one partition lock at a time.
 	 */
-	dbentry->n_xact_commit += (PgStat_Counter) (msg->m_xact_commit);
-	dbentry->n_xact_rollback += (PgStat_Counter) (msg->m_xact_rollback);
-	dbentry->n_block_read_time += msg->m_block_read_time;
-	dbentry->n_block_write_time += msg->m_block_write_time;
+	memset(&dbcounts, 0, sizeof(dbcounts));
 
-	/*
-	 * Process all table entries in the message.
-	 */
 	for (i = 0; i < msg->m_nentries; i++)
 	{
 		PgStat_TableEntry *tabmsg = &(msg->m_entry[i]);
 
-		tabentry = (PgStat_StatTabEntry *) hash_search(dbentry->tables,
-													(void *) &(tabmsg->t_id),
-													   HASH_ENTER, &found);
+		tabentry = pgstat_get_tab_entry(msg->m_databaseid, tabmsg->t_id,
+										true, &lock);
 
-		if (!found)
-		{
-			/*
-			 * If it's a new table entry, initialize counters to the values we
-			 * just got.
-			 */
-			tabentry->numscans = tabmsg->t_counts.t_numscans;
-			tabentry->tuples_returned = tabmsg->t_counts.t_tuples_returned;
-			tabentry->tuples_fetched = tabmsg->t_counts.t_tuples_fetched;
-			tabentry->tuples_inserted = tabmsg->t_counts.t_tuples_inserted;
-			tabentry->tuples_updated = tabmsg->t_counts.t_tuples_updated;
-			tabentry->tuples_deleted = tabmsg->t_counts.t_tuples_deleted;
-			tabentry->tuples_hot_updated = tabmsg->t_counts.t_tuples_hot_updated;
-			tabentry->n_live_tuples = tabmsg->t_counts.t_delta_live_tuples;
-			tabentry->n_dead_tuples = tabmsg->t_counts.t_delta_dead_tuples;
-			tabentry->changes_since_analyze = tabmsg->t_counts.t_changed_tuples;
-			tabentry->blocks_fetched = tabmsg->t_counts.t_blocks_fetched;
-			tabentry->blocks_hit = tabmsg->t_counts.t_blocks_hit;
-
-			tabentry->vacuum_timestamp = 0;
-			tabentry->vacuum_count = 0;
-			tabentry->autovac_vacuum_timestamp = 0;
-			tabentry->autovac_vacuum_count = 0;
-			tabentry->analyze_timestamp = 0;
-			tabentry->analyze_count = 0;
-			tabentry->autovac_analyze_timestamp = 0;
-			tabentry->autovac_analyze_count = 0;
-		}
-		else
+		if (tabentry != NULL)
 		{
 			/*
-			 * Otherwise add the values to the existing entry.
+			 * Add the values to the entry; a new one starts at zero.
 			 */
 			tabentry->numscans += tabmsg->t_counts.t_numscans;
 			tabentry->tuples_returned += tabmsg->t_counts.t_tuples_returned;
@@ -4827,24 +3967,48 @@ pgstat_recv_tabstat(PgStat_MsgTabstat *msg, int len)
 			tabentry->changes_since_analyze += tabmsg->t_counts.t_changed_tuples;
 			tabentry->blocks_fetched += tabmsg->t_counts.t_blocks_fetched;
 			tabentry->blocks_hit += tabmsg->t_counts.t_blocks_hit;
-		}
 
-		/* Clamp n_live_tuples in case of negative delta_live_tuples */
-		tabentry->n_live_tuples = Max(tabentry->n_live_tuples, 0);
-		/* Likewise for n_dead_tuples */
-		tabentry->n_dead_tuples = Max(tabentry->n_dead_tuples, 0);
+			/* Clamp n_live_tuples in case of negative delta_live_tuples */
+			tabentry->n_live_tuples = Max(tabentry->n_live_tuples, 0);
+			/* Likewise for n_dead_tuples */
+			tabentry->n_dead_tuples = Max(tabentry->n_dead_tuples, 0);
+
+			LWLockRelease(lock);
+		}
 
 		/*
-		 * Add per-table stats to the per-database entry, too.
+		 * Add per-table stats to the per-database totals, too.
 		 */
-		dbentry->n_tuples_returned += tabmsg->t_counts.t_tuples_returned;
-		dbentry->n_tuples_fetched += tabmsg->t_counts.t_tuples_fetched;
-		dbentry->n_tuples_inserted += tabmsg->t_counts.t_tuples_inserted;
-		dbentry->n_tuples_updated += tabmsg->t_counts.t_tuples_updated;
-		dbentry->n_tuples_deleted += tabmsg->t_counts.t_tuples_deleted;
-		dbentry->n_blocks_fetched += tabmsg->t_counts.t_blocks_fetched;
-		dbentry->n_blocks_hit += tabmsg->t_counts.t_blocks_hit;
+		dbcounts.t_tuples_returned += tabmsg->t_counts.t_tuples_returned;
+		dbcounts.t_tuples_fetched += tabmsg->t_counts.t_tuples_fetched;
+		dbcounts.t_tuples_inserted += tabmsg->t_counts.t_tuples_inserted;
+		dbcounts.t_tuples_updated += tabmsg->t_counts.t_tuples_updated;
+		dbcounts.t_tuples_deleted += tabmsg->t_counts.t_tuples_deleted;
+		dbcounts.t_blocks_fetched += tabmsg->t_counts.t_blocks_fetched;
+		dbcounts.t_blocks_hit += tabmsg->t_counts.t_blocks_hit;
 	}
+
+	/*
+	 * Update database-wide stats.
+	 */
+	dbentry = pgstat_get_db_entry(msg->m_databaseid, true, &lock);
+	if (dbentry == NULL)
+		return;
+
+	dbentry->n_xact_commit += (PgStat_Counter) (msg->m_xact_commit);
+	dbentry->n_xact_rollback += (PgStat_Counter) (msg->m_xact_rollback);
+	dbentry->n_block_read_time += msg->m_block_read_time;
+	dbentry->n_block_write_time += msg->m_block_write_time;
+
+	dbentry->n_tuples_returned += dbcounts.t_tuples_returned;
+	dbentry->n_tuples_fetched += dbcounts.t_tuples_fetched;
+	dbentry->n_tuples_inserted += dbcounts.t_tuples_inserted;
+	dbentry->n_tuples_updated += dbcounts.t_tuples_updated;
+	dbentry->n_tuples_deleted += dbcounts.t_tuples_deleted;
+	dbentry->n_blocks_fetched += dbcounts.t_blocks_fetched;
+	dbentry->n_blocks_hit += dbcounts.t_blocks_hit;
+
+	LWLockRelease(lock);
 }
 
 
@@ -4857,16 +4021,10 @@ pgstat_recv_tabstat(PgStat_MsgTabstat *msg, int len)
 static void
 pgstat_recv_tabpurge(PgStat_MsgTabpurge *msg, int len)
 {
-	PgStat_StatDBEntry *dbentry;
+	PgStat_ObjectKey key;
 	int			i;
 
-	dbentry = pgstat_get_db_entry(msg->m_databaseid, false);
-
-	/*
-	 * No need to purge if we don't even know the database.
-	 */
-	if (!dbentry || !dbentry->tables)
-		return;
+	key.databaseid = msg->m_databaseid;
 
 	/*
 	 * Process all table entries in the message.
@@ -4874,9 +4032,8 @@ pgstat_recv_tabpurge(PgStat_MsgTabpurge *msg, int len)
 	for (i = 0; i < msg->m_nentries; i++)
 	{
 		/* Remove from hashtable if present; we don't care if it's not. */
-		(void) hash_search(dbentry->tables,
-						   (void *) &(msg->m_tableid[i]),
-						   HASH_REMOVE, NULL);
+		key.objectid = msg->m_tableid[i];
+		pgstat_remove_entry(pgStatSharedTabHash, &key);
 	}
 }
 
@@ -4891,36 +4048,17 @@ static void
 pgstat_recv_dropdb(PgStat_MsgDropdb *msg, int len)
 {
 	Oid			dbid = msg->m_databaseid;
-	PgStat_StatDBEntry *dbentry;
 
-	/*
-	 * Lookup the database in the hashtable.
-	 */
-	dbentry = pgstat_get_db_entry(dbid, false);
+	pgstat_lock_all_partitions(LW_EXCLUSIVE);
 
 	/*
-	 * If found, remove it (along with the db statfile).
+	 * Remove the database's entry, if any, along with all its tables and
+	 * functions.
 	 */
-	if (dbentry)
-	{
-		char		statfile[MAXPGPATH];
-
-		get_dbstat_filename(false, false, dbid, statfile, MAXPGPATH);
+	(void) hash_search(pgStatSharedDBHash, (void *) &dbid, HASH_REMOVE, NULL);
+	pgstat_remove_db_objects(dbid);
 
-		elog(DEBUG2, "removing stats file \"%s\"", statfile);
-		unlink(statfile);
-
-		if (dbentry->tables != NULL)
-			hash_destroy(dbentry->tables);
-		if (dbentry->functions != NULL)
-			hash_destroy(dbentry->functions);
-
-		if (hash_search(pgStatDBHash,
-						(void *) &dbid,
-						HASH_REMOVE, NULL) == NULL)
-			ereport(ERROR,
-					(errmsg("database hash table corrupted during cleanup --- abort")));
-	}
+	pgstat_unlock_all_partitions();
 }
 
 
@@ -4935,31 +4073,26 @@ pgstat_recv_resetcounter(PgStat_MsgResetcounter *msg, int len)
 {
 	PgStat_StatDBEntry *dbentry;
 
-	/*
-	 * Lookup the database in the hashtable.  Nothing to do if not there.
-	 */
-	dbentry = pgstat_get_db_entry(msg->m_databaseid, false);
-
-	if (!dbentry)
-		return;
+	pgstat_lock_all_partitions(LW_EXCLUSIVE);
 
 	/*
-	 * We simply throw away all the database's table entries by recreating a
-	 * new hash table for them.
+	 * Lookup the database in the hashtable.  Nothing to do if not there.
 	 */
-	if (dbentry->tables != NULL)
-		hash_destroy(dbentry->tables);
-	if (dbentry->functions != NULL)
-		hash_destroy(dbentry->functions);
+	dbentry = (PgStat_StatDBEntry *) hash_search(pgStatSharedDBHash,
+												 (void *) &msg->m_databaseid,
+												 HASH_FIND, NULL);
 
-	dbentry->tables = NULL;
-	dbentry->functions = NULL;
+	if (dbentry != NULL)
+	{
+		/*
+		 * We simply throw away all the database's table and function
+		 * entries, then reset the database-level stats, too.
+		 */
+		pgstat_remove_db_objects(msg->m_databaseid);
+		reset_dbentry_counters(dbentry);
+	}
 
-	/*
-	 * Reset database-level stats, too.  This creates empty hash tables for
-	 * tables and functions.
-	 */
-	reset_dbentry_counters(dbentry);
+	pgstat_unlock_all_partitions();
 }
 
 /* ----------
@@ -4971,19 +4104,25 @@ pgstat_recv_resetcounter(PgStat_MsgResetcounter *msg, int len)
 static void
 pgstat_recv_resetsharedcounter(PgStat_MsgResetsharedcounter *msg, int len)
 {
+	TimestampTz now = GetCurrentTimestamp();
+
+	SpinLockAcquire(&pgStatShmem->mutex);
+
 	if (msg->m_resettarget == RESET_BGWRITER)
 	{
 		/* Reset the global background writer statistics for the cluster. */
-		memset(&globalStats, 0, sizeof(globalStats));
-		globalStats.stat_reset_timestamp = GetCurrentTimestamp();
+		memset(&pgStatShmem->globalStats, 0, sizeof(PgStat_GlobalStats));
+		pgStatShmem->globalStats.stat_reset_timestamp = now;
 	}
 	else if (msg->m_resettarget == RESET_ARCHIVER)
 	{
 		/* Reset the archiver statistics for the cluster. */
-		memset(&archiverStats, 0, sizeof(archiverStats));
-		archiverStats.stat_reset_timestamp = GetCurrentTimestamp();
+		memset(&pgStatShmem->archiverStats, 0, sizeof(PgStat_ArchiverStats));
+		pgStatShmem->archiverStats.stat_reset_timestamp = now;
 	}
 
+	SpinLockRelease(&pgStatShmem->mutex);
+
 	/*
 	 * Presumably the sender of this message validated the target, don't
 	 * complain here if it's not valid
@@ -5000,8 +4139,10 @@ static void
 pgstat_recv_resetsinglecounter(PgStat_MsgResetsinglecounter *msg, int len)
 {
 	PgStat_StatDBEntry *dbentry;
+	PgStat_ObjectKey key;
+	LWLock	   *lock;
 
-	dbentry = pgstat_get_db_entry(msg->m_databaseid, false);
+	dbentry = pgstat_get_db_entry(msg->m_databaseid, false, &lock);
 
 	if (!dbentry)
 		return;
@@ -5009,13 +4150,15 @@ pgstat_recv_resetsinglecounter(PgStat_MsgResetsinglecounter *msg, int len)
 	/* Set the reset timestamp for the whole database */
 	dbentry->stat_reset_timestamp = GetCurrentTimestamp();
 
+	LWLockRelease(lock);
+
 	/* Remove object if it exists, ignore it if not */
+	key.databaseid = msg->m_databaseid;
+	key.objectid = msg->m_objectid;
 	if (msg->m_resettype == RESET_TABLE)
-		(void) hash_search(dbentry->tables, (void *) &(msg->m_objectid),
-						   HASH_REMOVE, NULL);
+		pgstat_remove_entry(pgStatSharedTabHash, &key);
 	else if (msg->m_resettype == RESET_FUNCTION)
-		(void) hash_search(dbentry->functions, (void *) &(msg->m_objectid),
-						   HASH_REMOVE, NULL);
+		pgstat_remove_entry(pgStatSharedFuncHash, &key);
 }
 
 /* ----------
@@ -5028,13 +4171,18 @@ static void
 pgstat_recv_autovac(PgStat_MsgAutovacStart *msg, int len)
 {
 	PgStat_StatDBEntry *dbentry;
+	LWLock	   *lock;
 
 	/*
 	 * Store the last autovacuum time in the database's hashtable entry.
 	 */
-	dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
+	dbentry = pgstat_get_db_entry(msg->m_databaseid, true, &lock);
+	if (dbentry == NULL)
+		return;
 
 	dbentry->last_autovac_time = msg->m_start_time;
+
+	LWLockRelease(lock);
 }
 
 /* ----------
@@ -5046,15 +4194,16 @@ pgstat_recv_autovac(PgStat_MsgAutovacStart *msg, int len)
 static void
 pgstat_recv_vacuum(PgStat_MsgVacuum *msg, int len)
 {
-	PgStat_StatDBEntry *dbentry;
 	PgStat_StatTabEntry *tabentry;
+	LWLock	   *lock;
 
 	/*
 	 * Store the data in the table's hashtable entry.
 	 */
-	dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
-
-	tabentry = pgstat_get_tab_entry(dbentry, msg->m_tableoid, true);
+	tabentry = pgstat_get_tab_entry(msg->m_databaseid, msg->m_tableoid,
+									true, &lock);
+	if (tabentry == NULL)
+		return;
 
 	tabentry->n_live_tuples = msg->m_live_tuples;
 	tabentry->n_dead_tuples = msg->m_dead_tuples;
@@ -5069,6 +4218,8 @@ pgstat_recv_vacuum(PgStat_MsgVacuum *msg, int len)
 		tabentry->vacuum_timestamp = msg->m_vacuumtime;
 		tabentry->vacuum_count++;
 	}
+
+	LWLockRelease(lock);
 }
 
 /* ----------
@@ -5080,15 +4231,16 @@ pgstat_recv_vacuum(PgStat_MsgVacuum *msg, int len)
 static void
 pgstat_recv_analyze(PgStat_MsgAnalyze *msg, int len)
 {
-	PgStat_StatDBEntry *dbentry;
 	PgStat_StatTabEntry *tabentry;
+	LWLock	   *lock;
 
 	/*
 	 * Store the data in the table's hashtable entry.
 	 */
-	dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
-
-	tabentry = pgstat_get_tab_entry(dbentry, msg->m_tableoid, true);
+	tabentry = pgstat_get_tab_entry(msg->m_databaseid, msg->m_tableoid,
+									true, &lock);
+	if (tabentry == NULL)
+		return;
 
 	tabentry->n_live_tuples = msg->m_live_tuples;
 	tabentry->n_dead_tuples = msg->m_dead_tuples;
@@ -5109,6 +4261,8 @@ pgstat_recv_analyze(PgStat_MsgAnalyze *msg, int len)
 		tabentry->analyze_timestamp = msg->m_analyzetime;
 		tabentry->analyze_count++;
 	}
+
+	LWLockRelease(lock);
 }
 
 
@@ -5121,22 +4275,28 @@ pgstat_recv_analyze(PgStat_MsgAnalyze *msg, int len)
 static void
 pgstat_recv_archiver(PgStat_MsgArchiver *msg, int len)
 {
+	PgStat_ArchiverStats *archiver = &pgStatShmem->archiverStats;
+
+	SpinLockAcquire(&pgStatShmem->mutex);
+
 	if (msg->m_failed)
 	{
 		/* Failed archival attempt */
-		++archiverStats.failed_count;
-		memcpy(archiverStats.last_failed_wal, msg->m_xlog,
-			   sizeof(archiverStats.last_failed_wal));
-		archiverStats.last_failed_timestamp = msg->m_timestamp;
+		++archiver->failed_count;
+		memcpy(archiver->last_failed_wal, msg->m_xlog,
+			   sizeof(archiver->last_failed_wal));
+		archiver->last_failed_timestamp = msg->m_timestamp;
 	}
 	else
 	{
 		/* Successful archival operation */
-		++archiverStats.archived_count;
-		memcpy(archiverStats.last_archived_wal, msg->m_xlog,
-			   sizeof(archiverStats.last_archived_wal));
-		archiverStats.last_archived_timestamp = msg->m_timestamp;
+		++archiver->archived_count;
+		memcpy(archiver->last_archived_wal, msg->m_xlog,
+			   sizeof(archiver->last_archived_wal));
+		archiver->last_archived_timestamp = msg->m_timestamp;
 	}
+
+	SpinLockRelease(&pgStatShmem->mutex);
 }
 
 /* ----------
@@ -5148,16 +4308,22 @@ pgstat_recv_archiver(PgStat_MsgArchiver *msg, int len)
 static void
 pgstat_recv_bgwriter(PgStat_MsgBgWriter *msg, int len)
 {
-	globalStats.timed_checkpoints += msg->m_timed_checkpoints;
-	globalStats.requested_checkpoints += msg->m_requested_checkpoints;
-	globalStats.checkpoint_write_time += msg->m_checkpoint_write_time;
-	globalStats.checkpoint_sync_time += msg->m_checkpoint_sync_time;
-	globalStats.buf_written_checkpoints += msg->m_buf_written_checkpoints;
-	globalStats.buf_written_clean += msg->m_buf_written_clean;
-	globalStats.maxwritten_clean += msg->m_maxwritten_clean;
-	globalStats.buf_written_backend += msg->m_buf_written_backend;
-	globalStats.buf_fsync_backend += msg->m_buf_fsync_backend;
-	globalStats.buf_alloc += msg->m_buf_alloc;
+	PgStat_GlobalStats *global = &pgStatShmem->globalStats;
+
+	SpinLockAcquire(&pgStatShmem->mutex);
+
+	global->timed_checkpoints += msg->m_timed_checkpoints;
+	global->requested_checkpoints += msg->m_requested_checkpoints;
+	global->checkpoint_write_time += msg->m_checkpoint_write_time;
+	global->checkpoint_sync_time += msg->m_checkpoint_sync_time;
+	global->buf_written_checkpoints += msg->m_buf_written_checkpoints;
+	global->buf_written_clean += msg->m_buf_written_clean;
+	global->maxwritten_clean += msg->m_maxwritten_clean;
+	global->buf_written_backend += msg->m_buf_written_backend;
+	global->buf_fsync_backend += msg->m_buf_fsync_backend;
+	global->buf_alloc += msg->m_buf_alloc;
+
+	SpinLockRelease(&pgStatShmem->mutex);
 }
 
 /* ----------
@@ -5170,8 +4336,11 @@ static void
 pgstat_recv_recoveryconflict(PgStat_MsgRecoveryConflict *msg, int len)
 {
 	PgStat_StatDBEntry *dbentry;
+	LWLock	   *lock;
 
-	dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
+	dbentry = pgstat_get_db_entry(msg->m_databaseid, true, &lock);
+	if (dbentry == NULL)
+		return;
 
 	switch (msg->m_reason)
 	{
@@ -5198,6 +4367,8 @@ pgstat_recv_recoveryconflict(PgStat_MsgRecoveryConflict *msg, int len)
 			dbentry->n_conflict_startup_deadlock++;
 			break;
 	}
+
+	LWLockRelease(lock);
 }
 
 /* ----------
@@ -5210,10 +4381,15 @@ static void
 pgstat_recv_deadlock(PgStat_MsgDeadlock *msg, int len)
 {
 	PgStat_StatDBEntry *dbentry;
+	LWLock	   *lock;
 
-	dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
+	dbentry = pgstat_get_db_entry(msg->m_databaseid, true, &lock);
+	if (dbentry == NULL)
+		return;
 
 	dbentry->n_deadlocks++;
+
+	LWLockRelease(lock);
 }
 
 /* ----------
@@ -5226,11 +4402,16 @@ static void
 pgstat_recv_tempfile(PgStat_MsgTempFile *msg, int len)
 {
 	PgStat_StatDBEntry *dbentry;
+	LWLock	   *lock;
 
-	dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
+	dbentry = pgstat_get_db_entry(msg->m_databaseid, true, &lock);
+	if (dbentry == NULL)
+		return;
 
 	dbentry->n_temp_bytes += msg->m_filesize;
 	dbentry->n_temp_files += 1;
+
+	LWLockRelease(lock);
 }
 
 /* ----------
@@ -5243,41 +4424,28 @@ static void
 pgstat_recv_funcstat(PgStat_MsgFuncstat *msg, int len)
 {
 	PgStat_FunctionEntry *funcmsg = &(msg->m_entry[0]);
-	PgStat_StatDBEntry *dbentry;
 	PgStat_StatFuncEntry *funcentry;
+	LWLock	   *lock;
 	int			i;
-	bool		found;
-
-	dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
 
 	/*
 	 * Process all function entries in the message.
 	 */
 	for (i = 0; i < msg->m_nentries; i++, funcmsg++)
 	{
-		funcentry = (PgStat_StatFuncEntry *) hash_search(dbentry->functions,
-												   (void *) &(funcmsg->f_id),
-														 HASH_ENTER, &found);
+		funcentry = pgstat_get_func_entry(msg->m_databaseid, funcmsg->f_id,
+										  true, &lock);
+		if (funcentry == NULL)
+			continue;
 
-		if (!found)
-		{
-			/*
-			 * If it's a new function entry, initialize counters to the values
-			 * we just got.
-			 */
-			funcentry->f_numcalls = funcmsg->f_numcalls;
-			funcentry->f_total_time = funcmsg->f_total_time;
-			funcentry->f_self_time = funcmsg->f_self_time;
-		}
-		else
-		{
-			/*
-			 * Otherwise add the values to the existing entry.
-			 */
-			funcentry->f_numcalls += funcmsg->f_numcalls;
-			funcentry->f_total_time += funcmsg->f_total_time;
-			funcentry->f_self_time += funcmsg->f_self_time;
-		}
+		/*
+		 * Add the values to the entry; a new one starts at zero.
+		 */
+		funcentry->f_numcalls += funcmsg->f_numcalls;
+		funcentry->f_total_time += funcmsg->f_total_time;
+		funcentry->f_self_time += funcmsg->f_self_time;
+
+		LWLockRelease(lock);
 	}
 }
 
@@ -5290,16 +4458,10 @@ pgstat_recv_funcstat(PgStat_MsgFuncstat *msg, int len)
 static void
 pgstat_recv_funcpurge(PgStat_MsgFuncpurge *msg, int len)
 {
-	PgStat_StatDBEntry *dbentry;
+	PgStat_ObjectKey key;
 	int			i;
 
-	dbentry = pgstat_get_db_entry(msg->m_databaseid, false);
-
-	/*
-	 * No need to purge if we don't even know the database.
-	 */
-	if (!dbentry || !dbentry->functions)
-		return;
+	key.databaseid = msg->m_databaseid;
 
 	/*
 	 * Process all function entries in the message.
@@ -5307,47 +4469,7 @@ pgstat_recv_funcpurge(PgStat_MsgFuncpurge *msg, int len)
 	for (i = 0; i < msg->m_nentries; i++)
 	{
 		/* Remove from hashtable if present; we don't care if it's not. */
-		(void) hash_search(dbentry->functions,
-						   (void *) &(msg->m_functionid[i]),
-						   HASH_REMOVE, NULL);
-	}
-}
-
-/* ----------
- * pgstat_write_statsfile_needed() -
- *
- *	Do we need to write out the files?
- * ----------
- */
-static bool
-pgstat_write_statsfile_needed(void)
-{
-	if (!slist_is_empty(&last_statrequests))
-		return true;
-
-	/* Everything was written recently */
-	return false;
-}
-
-/* ----------
- * pgstat_db_requested() -
- *
- *	Checks whether stats for a particular DB need to be written to a file.
- * ----------
- */
-static bool
-pgstat_db_requested(Oid databaseid)
-{
-	slist_iter	iter;
-
-	/* Check the databases if they need to refresh the stats. */
-	slist_foreach(iter, &last_statrequests)
-	{
-		DBWriteRequest *req = slist_container(DBWriteRequest, next, iter.cur);
-
-		if (req->databaseid == databaseid)
-			return true;
+		key.objectid = msg->m_functionid[i];
+		pgstat_remove_entry(pgStatSharedFuncHash, &key);
 	}
-
-	return false;
 }
@@ -16,6 +16,11 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
 
 #include "access/xlog_internal.h"		/* for pg_start/stop_backup */
 #include "catalog/catalog.h"
@@ -23,18 +28,30 @@
 #include "lib/stringinfo.h"
 #include "libpq/libpq.h"
 #include "libpq/pqformat.h"
+#include "libpq/pqmq.h"
 #include "miscadmin.h"
 #include "nodes/pg_list.h"
 #include "pgtar.h"
 #include "pgstat.h"
+#include "postmaster/bgworker.h"
 #include "replication/basebackup.h"
 #include "replication/walsender.h"
 #include "replication/walsender_private.h"
+#include "storage/bufpage.h"
+#include "storage/dsm.h"
 #include "storage/fd.h"
 #include "storage/ipc.h"
+#include "storage/proc.h"
+#include "storage/shm_mq.h"
+#include "storage/shm_toc.h"
+#include "storage/spin.h"
+#include "tcop/sessionpool.h"
+#include "tcop/tcopprot.h"
 #include "utils/builtins.h"
 #include "utils/elog.h"
+#include "utils/memutils.h"
 #include "utils/ps_status.h"
+#include "utils/resowner.h"
 #include "utils/timestamp.h"
 
 
@@ -47,8 +64,80 @@ typedef struct
 	bool		includewal;
 	uint32		maxrate;
 	bool		sendtblspcmapfile;
+	int			compression;
+	int			nworkers;
+	XLogRecPtr	incremental_lsn;
 } basebackup_options;
 
+/*
+ * A file, or a range of one, to be sent by a base backup worker.
+ */
+typedef struct BaseBackupWorkItem
+{
+	struct stat statbuf;
+	pgoff_t		offset;			/* range of the file to send */
+	pgoff_t		length;
+	bool		first;			/* send the tar header? */
+	bool		last;			/* send the padding? */
+	bool		incremental;	/* send changed blocks of the whole file */
+	char		readfilename[MAXPGPATH];
+	char		tarfilename[MAXPGPATH];
+} BaseBackupWorkItem;
+
+/*
+ * State shared with the base backup workers.
+ */
+typedef struct BaseBackupShared
+{
+	int			nworkers;
+	int			compression;
+	XLogRecPtr	incremental_lsn;
+
+	slock_t		mutex;			/* protects nattached */
+	int			nattached;
+} BaseBackupShared;
+
+/*
+ * An entry in the walsender's queue of output to forward to the client:
+ * either a work item in flight in a worker, or data we produced ourselves
+ * (directory entries and the like) in between.
+ */
+typedef struct BaseBackupPending
+{
+	int			worker;			/* worker doing the item, or -1 */
+	uint64		file;			/* file the item belongs to */
+	bool		first;			/* first item of its file? */
+	char	   *data;			/* our own data, if worker is -1 */
+	int			len;
+} BaseBackupPending;
+
+/*
+ * The walsender's view of the workers.  Work items are assigned to workers
+ * round-robin, and the output of each is forwarded to the client in the
+ * order the items were handed out, so that the tar stream is laid out just
+ * like without workers.
+ */
+typedef struct BaseBackupWorkers
+{
+	MemoryContext context;
+	dsm_segment *seg;
+	int			nworkers;
+	BackgroundWorkerHandle **handle;
+	shm_mq_handle **inqh;		/* work items, to the workers */
+	shm_mq_handle **outqh;		/* tar data, from the workers */
+	int		   *outstanding;	/* items in flight, per worker */
+	int			nassigned;		/* items handed out so far */
+
+	BaseBackupPending *pending; /* ring of output yet to forward */
+	int			npending;
+	int			maxpending;
+	int			pending_head;
+
+	StringInfoData local;		/* our own data not yet queued */
+	uint64		file_seq;		/* number of the last file handed out */
+	uint64		skip_file;		/* file found missing, discard its items */
+} BaseBackupWorkers;
+
 
 static int64 sendDir(char *path, int basepathlen, bool sizeonly,
 		List *tablespaces, bool sendtblspclinks);
@@ -57,6 +146,26 @@ static bool sendFile(char *readfilename, char *tarfilename,
 static void sendFileWithContent(const char *filename, const char *content);
 static void _tarWriteHeader(const char *filename, const char *linktarget,
 				struct stat * statbuf);
+static bool sendFileRange(char *readfilename, char *tarfilename,
+			  struct stat * statbuf, bool missing_ok, pgoff_t offset,
+			  pgoff_t length, bool first, bool last);
+static bool sendFileIncremental(char *readfilename, char *tarfilename,
+					struct stat * statbuf);
+static bool sendRegularFile(char *readfilename, char *tarfilename,
+				struct stat * statbuf);
+static bool isIncrementalFile(const char *path, const char *filename);
+static void bbPutData(const char *data, size_t len);
+static void bbSendData(const char *data, size_t len);
+static void bbEndStream(void);
+static void bbCompressStart(int level);
+static void bbCompressEnd(void);
+static void bbWorkersStart(basebackup_options *opt);
+static void bbWorkersDispatch(BaseBackupWorkItem *item);
+static void bbWorkersConsumeOne(void);
+static void bbWorkersQueueLocal(void);
+static void bbWorkersDrain(void);
+static void bbWorkersShutdown(bool wait);
+static void BaseBackupWorkerMain(Datum main_arg);
 static void send_int8_string(StringInfoData *buf, int64 intval);
 static void SendBackupHeader(List *tablespaces);
 static void base_backup_cleanup(int code, Datum arg);
@@ -72,11 +181,43 @@ static bool backup_started_in_recovery = false;
 /* Relative path of temporary statistics directory */
 static char *statrelpath = NULL;
 
+/* Send only blocks changed since this LSN, if valid */
+static XLogRecPtr incremental_lsn = InvalidXLogRecPtr;
+
+/* Workers reading and compressing files for us, if any */
+static BaseBackupWorkers *bbworkers = NULL;
+
+#ifdef HAVE_LIBZ
+/* Compression of the tar stream, if requested */
+static z_stream *bbzstream = NULL;
+static char *bbzbuf = NULL;
+static bool bbzpending = false; /* any input since the last member ended? */
+#endif
+
 /*
  * Size of each block sent into the tar stream for larger files.
  */
 #define TAR_SEND_SIZE 32768
 
+/*
+ * Files larger than this are split into several work items when sending them
+ * with workers, so that large files are read and compressed in parallel too.
+ */
+#define BASEBACKUP_CHUNK_SIZE	(8 * 1024 * 1024)
+
+/* Maximum number of work items assigned to each worker at a time */
+#define BASEBACKUP_ITEMS_PER_WORKER 4
+
+/* Sizes of the queues to and from each worker */
+#define BASEBACKUP_INQUEUE_SIZE \
+	MAXALIGN(BASEBACKUP_ITEMS_PER_WORKER * (sizeof(BaseBackupWorkItem) + 64))
+#define BASEBACKUP_OUTQUEUE_SIZE	(1024 * 1024)
+
+/* Magic number and TOC keys for the workers' shared memory segment */
+#define BASEBACKUP_MAGIC			0x42424b50
+#define BASEBACKUP_KEY_SHARED		UINT64CONST(1)
+#define BASEBACKUP_KEY_QUEUES		UINT64CONST(2)
+
 /*
  * How frequently to throttle, as a fraction of the specified rate-second.
  */
@@ -102,6 +243,8 @@ static void
 base_backup_cleanup(int code, Datum arg)
 {
 	do_pg_abort_backup();
+	bbWorkersShutdown(false);
+	bbCompressEnd();
 }
 
 /*
@@ -189,6 +332,13 @@ perform_base_backup(basebackup_options *opt, DIR *tblspcdir)
 			throttling_counter = -1;
 		}
 
+		/* Set up compression, incremental mode and workers, if requested */
+		if (opt->compression > 0)
+			bbCompressStart(opt->compression);
+		incremental_lsn = opt->incremental_lsn;
+		if (opt->nworkers > 1)
+			bbWorkersStart(opt);
+
 		/* Send off our tablespaces one by one */
 		foreach(lc, tablespaces)
 		{
@@ -231,6 +381,9 @@ perform_base_backup(basebackup_options *opt, DIR *tblspcdir)
 			else
 				sendTablespace(ti->path, false);
 
+			/* Wait for the workers to send everything we handed out */
+			bbWorkersDrain();
+
 			/*
 			 * If we're including WAL, and this is the main data directory we
 			 * don't terminate the tar stream here. Instead, we will append
@@ -242,8 +395,13 @@ perform_base_backup(basebackup_options *opt, DIR *tblspcdir)
 				Assert(lnext(lc) == NULL);
 			}
 			else
+			{
+				bbEndStream();
 				pq_putemptymessage('c');		/* CopyDone */
+			}
 		}
+
+		bbWorkersShutdown(true);
 	}
 	PG_END_ENSURE_ERROR_CLEANUP(base_backup_cleanup, (Datum) 0);
 
@@ -418,9 +576,7 @@ perform_base_backup(basebackup_options *opt, DIR *tblspcdir)
 			{
 				CheckXLogRemoved(segno, tli);
 				/* Send the chunk as a CopyData message */
-				if (pq_putmessage('d', buf, cnt))
-					ereport(ERROR,
-							(errmsg("base backup could not send data, aborting backup")));
+				bbPutData(buf, cnt);
 
 				len += cnt;
 				throttle(cnt);
@@ -479,8 +635,10 @@ perform_base_backup(basebackup_options *opt, DIR *tblspcdir)
 		}
 
 		/* Send CopyDone message for the last tar file */
+		bbEndStream();
 		pq_putemptymessage('c');
 	}
+	bbCompressEnd();
 	SendXlogRecPtrResult(endptr, endtli);
 }
 
@@ -511,6 +669,9 @@ parse_basebackup_options(List *options, basebackup_options *opt)
 	bool		o_wal = false;
 	bool		o_maxrate = false;
 	bool		o_tablespace_map = false;
+	bool		o_compression = false;
+	bool		o_parallel = false;
+	bool		o_incremental = false;
 
 	MemSet(opt, 0, sizeof(*opt));
 	foreach(lopt, options)
@@ -590,6 +751,69 @@ parse_basebackup_options(List *options, basebackup_options *opt)
 			opt->sendtblspcmapfile = true;
 			o_tablespace_map = true;
 		}
+		else if (strcmp(defel->defname, "compression") == 0)
+		{
+			long		level;
+
+			if (o_compression)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("duplicate option \"%s\"", defel->defname)));
+
+			level = intVal(defel->arg);
+			if (level < 1 || level > 9)
+				ereport(ERROR,
+						(errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+						 errmsg("%d is outside the valid range for parameter \"%s\" (%d .. %d)",
+								(int) level, "COMPRESSION", 1, 9)));
+#ifndef HAVE_LIBZ
+			ereport(ERROR,
+					(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					 errmsg("compression is not supported by this build")));
+#endif
+
+			opt->compression = (int) level;
+			o_compression = true;
+		}
+		else if (strcmp(defel->defname, "parallel") == 0)
+		{
+			long		nworkers;
+
+			if (o_parallel)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("duplicate option \"%s\"", defel->defname)));
+
+			nworkers = intVal(defel->arg);
+			if (nworkers < 1 || nworkers > MAX_PARALLEL_WORKERS)
+				ereport(ERROR,
+						(errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+						 errmsg("%d is outside the valid range for parameter \"%s\" (%d .. %d)",
+				  (int) nworkers, "PARALLEL", 1, MAX_PARALLEL_WORKERS)));
+
+			opt->nworkers = (int) nworkers;
+			o_parallel = true;
+		}
+		else if (strcmp(defel->defname, "incremental") == 0)
+		{
+			uint32		hi,
+						lo;
+
+			if (o_incremental)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("duplicate option \"%s\"", defel->defname)));
+
+			if (sscanf(strVal(defel->arg), "%X/%X", &hi, &lo) != 2 ||
+				(hi == 0 && lo == 0))
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("invalid value for parameter \"%s\": \"%s\"",
+								"INCREMENTAL", strVal(defel->arg))));
+
+			opt->incremental_lsn = ((uint64) hi) << 32 | lo;
+			o_incremental = true;
+		}
 		else
 			elog(ERROR, "option \"%s\" not recognized",
 				 defel->defname);
@@ -798,7 +1022,7 @@ sendFileWithContent(const char *filename, const char *content)
 
 	_tarWriteHeader(filename, NULL, &statbuf);
 	/* Send the contents as a CopyData message */
-	pq_putmessage('d', content, len);
+	bbPutData(content, len);
 
 	/* Pad to 512 byte boundary, per tar format requirements */
 	pad = ((len + 511) & ~511) - len;
@@ -807,7 +1031,7 @@ sendFileWithContent(const char *filename, const char *content)
 		char		buf[512];
 
 		MemSet(buf, 0, pad);
-		pq_putmessage('d', buf, pad);
+		bbPutData(buf, pad);
 	}
 }
 
@@ -965,10 +1189,12 @@ sendDir(char *path, int basepathlen, bool sizeonly, List *tablespaces,
 		}
 
 		/*
-		 * Skip pg_replslot, not useful to copy. But include it as an empty
-		 * directory anyway, so we get permissions right.
+		 * Skip pg_replslot and the session pool sockets in pg_session_pool,
+		 * not useful to copy. But include them as empty directories anyway,
+		 * so we get permissions right.
 		 */
-		if (strcmp(de->d_name, "pg_replslot") == 0)
+		if (strcmp(de->d_name, "pg_replslot") == 0 ||
+			strcmp(de->d_name, SESSION_POOL_DIR) == 0)
 		{
 			if (!sizeonly)
 				_tarWriteHeader(pathbuf + basepathlen + 1, NULL, &statbuf);
@@ -1098,8 +1324,8 @@ sendDir(char *path, int basepathlen, bool sizeonly, List *tablespaces,
 			bool		sent = false;
 
 			if (!sizeonly)
-				sent = sendFile(pathbuf, pathbuf + basepathlen + 1, &statbuf,
-								true);
+				sent = sendRegularFile(pathbuf, pathbuf + basepathlen + 1,
+									   &statbuf);
 
 			if (sent || sizeonly)
 			{
@@ -1141,6 +1367,26 @@ sendDir(char *path, int basepathlen, bool sizeonly, List *tablespaces,
 static bool
 sendFile(char *readfilename, char *tarfilename, struct stat * statbuf,
 		 bool missing_ok)
+{
+	return sendFileRange(readfilename, tarfilename, statbuf, missing_ok,
+						 0, statbuf->st_size, true, true);
+}
+
+/*
+ * Send 'length' bytes of a file, starting at 'offset', as part of its tar
+ * member.  The TAR header is written only if 'first' is true, and the padding
+ * at the end of the member only if 'last' is true, so that a large file can
+ * be sent as several ranges, by different workers.
+ *
+ * If the file is missing and this is the first range, returns false if
+ * 'missing_ok' (or throws an error if not).  If the file went away or was
+ * truncated after its first range was sent, the rest of it is sent as zeros,
+ * like when a file is truncated while we are sending it.
+ */
+static bool
+sendFileRange(char *readfilename, char *tarfilename, struct stat * statbuf,
+			  bool missing_ok, pgoff_t offset, pgoff_t length, bool first,
+			  bool last)
 {
 	FILE	   *fp;
 	char		buf[TAR_SEND_SIZE];
@@ -1151,38 +1397,47 @@ sendFile(char *readfilename, char *tarfilename, struct stat * statbuf,
 	fp = AllocateFile(readfilename, "rb");
 	if (fp == NULL)
 	{
-		if (errno == ENOENT && missing_ok)
+		if (errno != ENOENT || !missing_ok)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not open file \"%s\": %m", readfilename)));
+		if (first)
 			return false;
-		ereport(ERROR,
-				(errcode_for_file_access(),
-				 errmsg("could not open file \"%s\": %m", readfilename)));
 	}
 
-	/*
-	 * Some compilers will throw a warning knowing this test can never be true
-	 * because pgoff_t can't exceed the compared maximum on their platform.
-	 */
-	if (statbuf->st_size > MAX_TAR_MEMBER_FILELEN)
-		ereport(ERROR,
-				(errmsg("archive member \"%s\" too large for tar format",
-						tarfilename)));
+	if (first)
+	{
+		/*
+		 * Some compilers will throw a warning knowing this test can never be
+		 * true because pgoff_t can't exceed the compared maximum on their
+		 * platform.
+		 */
+		if (statbuf->st_size > MAX_TAR_MEMBER_FILELEN)
+			ereport(ERROR,
+					(errmsg("archive member \"%s\" too large for tar format",
+							tarfilename)));
+
+		_tarWriteHeader(tarfilename, NULL, statbuf);
+	}
 
-	_tarWriteHeader(tarfilename, NULL, statbuf);
+	if (fp != NULL && offset > 0 && fseeko(fp, offset, SEEK_SET) != 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not seek in file \"%s\": %m", readfilename)));
 
-	while ((cnt = fread(buf, 1, Min(sizeof(buf), statbuf->st_size - len), fp)) > 0)
+	while (fp != NULL &&
+		   (cnt = fread(buf, 1, Min(sizeof(buf), length - len), fp)) > 0)
 	{
 		/* Send the chunk as a CopyData message */
-		if (pq_putmessage('d', buf, cnt))
-			ereport(ERROR,
-			   (errmsg("base backup could not send data, aborting backup")));
+		bbPutData(buf, cnt);
 
 		len += cnt;
 		throttle(cnt);
 
-		if (len >= statbuf->st_size)
+		if (len >= length)
 		{
 			/*
-			 * Reached end of file. The file could be longer, if it was
+			 * Reached end of range. The file could be longer, if it was
 			 * extended while we were sending it, but for a base backup we can
 			 * ignore such extended data. It will be restored from WAL.
 			 */
@@ -1191,13 +1446,13 @@ sendFile(char *readfilename, char *tarfilename, struct stat * statbuf,
 	}
 
 	/* If the file was truncated while we were sending it, pad it with zeros */
-	if (len < statbuf->st_size)
+	if (len < length)
 	{
 		MemSet(buf, 0, sizeof(buf));
-		while (len < statbuf->st_size)
+		while (len < length)
 		{
-			cnt = Min(sizeof(buf), statbuf->st_size - len);
-			pq_putmessage('d', buf, cnt);
+			cnt = Min(sizeof(buf), length - len);
+			bbPutData(buf, cnt);
 			len += cnt;
 			throttle(cnt);
 		}
@@ -1207,18 +1462,225 @@ sendFile(char *readfilename, char *tarfilename, struct stat * statbuf,
 	 * Pad to 512 byte boundary, per tar format requirements. (This small
 	 * piece of data is probably not worth throttling.)
 	 */
+	if (last)
+	{
+		pad = ((statbuf->st_size + 511) & ~511) - statbuf->st_size;
+		if (pad > 0)
+		{
+			MemSet(buf, 0, pad);
+			bbPutData(buf, pad);
+		}
+	}
+
+	if (fp != NULL)
+		FreeFile(fp);
+
+	return true;
+}
+
+/*
+ * Send only the blocks of a relation file that changed since incremental_lsn.
+ *
+ * Instead of the file itself, a member named "<tarfilename>.incr" is sent,
+ * containing a header of three uint32s in network byte order (magic number,
+ * size of the file in blocks, number of blocks that follow), the numbers of
+ * the blocks that follow, and then the blocks themselves.  A block is
+ * considered changed if its page LSN is at or past incremental_lsn, or zero
+ * (a new page, or one that was bulk-loaded without WAL).  Every other block
+ * has not been modified since the backup we are based on was started, and
+ * any modification made while we read the file will be replayed from WAL,
+ * which has a full-page image of it.
+ *
+ * Returns false if the file went away before we could open it.
+ */
+static bool
+sendFileIncremental(char *readfilename, char *tarfilename,
+					struct stat * statbuf)
+{
+	FILE	   *fp;
+	char		buf[BLCKSZ];
+	char		incrname[MAXPGPATH];
+	struct stat incrstat;
+	BlockNumber nblocks;
+	BlockNumber nchanged = 0;
+	BlockNumber *changed;
+	BlockNumber blkno;
+	uint32		hdr[3];
+	pgoff_t		len;
+	size_t		pad;
+	int			i;
+
+	fp = AllocateFile(readfilename, "rb");
+	if (fp == NULL)
+	{
+		if (errno == ENOENT)
+			return false;
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not open file \"%s\": %m", readfilename)));
+	}
+
+	/*
+	 * First pass: find the changed blocks.  Blocks beyond the end of a file
+	 * that was truncated meanwhile are sent as zeros, like sendFile does.
+	 */
+	nblocks = statbuf->st_size / BLCKSZ;
+	changed = palloc(Max(nblocks, 1) * sizeof(BlockNumber));
+	for (blkno = 0; blkno < nblocks; blkno++)
+	{
+		XLogRecPtr	lsn;
+
+		if (fread(buf, 1, BLCKSZ, fp) != BLCKSZ)
+		{
+			while (blkno < nblocks)
+				changed[nchanged++] = blkno++;
+			break;
+		}
+		lsn = PageGetLSN((Page) buf);
+		if (lsn == InvalidXLogRecPtr || lsn >= incremental_lsn)
+			changed[nchanged++] = blkno;
+
+		if (blkno % 1024 == 0)
+			CHECK_FOR_INTERRUPTS();
+	}
+
+	len = sizeof(hdr) + nchanged * (sizeof(uint32) + BLCKSZ);
+	if (strlen(tarfilename) + sizeof(".incr") > MAXPGPATH)
+		ereport(ERROR,
+				(errmsg("file name too long for tar format: \"%s\"",
+						tarfilename)));
+	snprintf(incrname, sizeof(incrname), "%s.incr", tarfilename);
+	incrstat = *statbuf;
+	incrstat.st_size = len;
+	_tarWriteHeader(incrname, NULL, &incrstat);
+
+	hdr[0] = htonl(INCREMENTAL_FILE_MAGIC);
+	hdr[1] = htonl(nblocks);
+	hdr[2] = htonl(nchanged);
+	bbPutData((char *) hdr, sizeof(hdr));
+	for (i = 0; i < nchanged; i++)
+	{
+		uint32		n = htonl(changed[i]);
+
+		bbPutData((char *) &n, sizeof(n));
+	}
+	throttle(sizeof(hdr) + nchanged * sizeof(uint32));
+
+	/* Second pass: send the changed blocks */
+	for (i = 0; i < nchanged; i++)
+	{
+		if (fseeko(fp, (pgoff_t) changed[i] * BLCKSZ, SEEK_SET) != 0 ||
+			fread(buf, 1, BLCKSZ, fp) != BLCKSZ)
+			MemSet(buf, 0, BLCKSZ);
+		bbPutData(buf, BLCKSZ);
+		throttle(BLCKSZ);
+	}
+
+	/* Pad to 512 byte boundary, per tar format requirements */
 	pad = ((len + 511) & ~511) - len;
 	if (pad > 0)
 	{
 		MemSet(buf, 0, pad);
-		pq_putmessage('d', buf, pad);
+		bbPutData(buf, pad);
 	}
 
 	FreeFile(fp);
+	pfree(changed);
 
 	return true;
 }
 
+/*
+ * Does 'filename' in directory 'path' look like the main fork of a relation,
+ * which can be sent incrementally?  Other forks are always sent in full; the
+ * free space map isn't WAL-logged, and we don't trust the LSNs on visibility
+ * map pages enough.
+ */
+static bool
+isIncrementalFile(const char *path, const char *filename)
+{
+	const char *p = filename;
+
+	/* Relation segments are named "12345" or "12345.6" */
+	while (isdigit((unsigned char) *p))
+		p++;
+	if (p == filename)
+		return false;
+	if (*p == '.')
+	{
+		const char *segno = ++p;
+
+		while (isdigit((unsigned char) *p))
+			p++;
+		if (p == segno)
+			return false;
+	}
+	if (*p != '\0')
+		return false;
+
+	/* ... and live in a database directory */
+	return strcmp(path, "./global") == 0 ||
+		strncmp(path, "./base/", 7) == 0 ||
+		strstr(path, "/" TABLESPACE_VERSION_DIRECTORY "/") != NULL;
+}
+
+/*
+ * Send a regular file found by sendDir, incrementally if requested and
+ * possible.  If we have workers, the file is handed off to them, split into
+ * several ranges if it's large, and we always report success; a file that
+ * went away meanwhile is just left out of the stream.
+ */
+static bool
+sendRegularFile(char *readfilename, char *tarfilename, struct stat * statbuf)
+{
+	BaseBackupWorkItem item;
+	bool		incremental;
+	char	   *filename;
+	char		dirname[MAXPGPATH];
+	pgoff_t		offset;
+
+	incremental = false;
+	if (!XLogRecPtrIsInvalid(incremental_lsn))
+	{
+		strlcpy(dirname, readfilename, sizeof(dirname));
+		filename = strrchr(dirname, '/');
+		if (filename != NULL)
+		{
+			*filename++ = '\0';
+			incremental = isIncrementalFile(dirname, filename);
+		}
+	}
+
+	if (bbworkers == NULL)
+	{
+		if (incremental)
+			return sendFileIncremental(readfilename, tarfilename, statbuf);
+		return sendFile(readfilename, tarfilename, statbuf, true);
+	}
+
+	MemSet(&item, 0, sizeof(item));
+	item.statbuf = *statbuf;
+	item.incremental = incremental;
+	strlcpy(item.readfilename, readfilename, MAXPGPATH);
+	strlcpy(item.tarfilename, tarfilename, MAXPGPATH);
+
+	bbworkers->file_seq++;
+	offset = 0;
+	do
+	{
+		item.offset = offset;
+		if (incremental)
+			item.length = statbuf->st_size;
+		else
+			item.length = Min(BASEBACKUP_CHUNK_SIZE, statbuf->st_size - offset);
+		item.first = (offset == 0);
+		offset += item.length;
+		item.last = (offset >= statbuf->st_size);
+		bbWorkersDispatch(&item);
+	} while (!item.last);
+
+	return true;
+}
 
 static void
 _tarWriteHeader(const char *filename, const char *linktarget,
@@ -1249,7 +1711,7 @@ _tarWriteHeader(const char *filename, const char *linktarget,
 			elog(ERROR, "unrecognized tar error: %d", rc);
 	}
 
-	pq_putmessage('d', h, 512);
+	bbPutData(h, 512);
 }
 
 /*
@@ -1319,3 +1781,589 @@ throttle(size_t increment)
 		/* Sleep was necessary but might have been interrupted. */
 		throttled_last = GetCurrentIntegerTimestamp();
 }
+
+/*****
+ * Functions for sending the tar stream, possibly compressed
+ */
+
+/*
+ * Add data to the tar stream.  If we have workers, our own data is queued
+ * behind the output of the work items handed out so far, see
+ * bbWorkersQueueLocal.
+ */
+static void
+bbPutData(const char *data, size_t len)
+{
+	if (bbworkers != NULL)
+	{
+		appendBinaryStringInfo(&bbworkers->local, data, len);
+		return;
+	}
+
+	bbSendData(data, len);
+}
+
+/*
+ * Send data to the client, or to the walsender if we're a worker, as
+ * CopyData messages, compressing it first if requested.
+ */
+static void
+bbSendData(const char *data, size_t len)
+{
+#ifdef HAVE_LIBZ
+	if (bbzstream != NULL)
+	{
+		bbzstream->next_in = (Bytef *) data;
+		bbzstream->avail_in = len;
+		while (bbzstream->avail_in > 0)
+		{
+			if (deflate(bbzstream, Z_NO_FLUSH) != Z_OK)
+				elog(ERROR, "could not compress data: %s",
+					 bbzstream->msg ? bbzstream->msg : "unknown error");
+
+			if (bbzstream->avail_out == 0)
+			{
+				if (pq_putmessage('d', bbzbuf, TAR_SEND_SIZE))
+					ereport(ERROR,
+							(errmsg("base backup could not send data, aborting backup")));
+				bbzstream->next_out = (Bytef *) bbzbuf;
+				bbzstream->avail_out = TAR_SEND_SIZE;
+			}
+		}
+		bbzpending = true;
+		return;
+	}
+#endif
+
+	if (pq_putmessage('d', data, len))
+		ereport(ERROR,
+				(errmsg("base backup could not send data, aborting backup")));
+}
+
+/*
+ * Finish the current gzip member, if compressing.  This is done at the end
+ * of each tar stream, and by workers at the end of each work item, so that
+ * the stream is a series of complete gzip members, which gzip decompresses
+ * as if they were one.
+ */
+static void
+bbEndStream(void)
+{
+#ifdef HAVE_LIBZ
+	int			rc;
+
+	if (bbzstream == NULL || !bbzpending)
+		return;
+
+	do
+	{
+		rc = deflate(bbzstream, Z_FINISH);
+		if (rc != Z_OK && rc != Z_STREAM_END)
+			elog(ERROR, "could not compress data: %s",
+				 bbzstream->msg ? bbzstream->msg : "unknown error");
+
+		if (bbzstream->avail_out < TAR_SEND_SIZE)
+		{
+			if (pq_putmessage('d', bbzbuf,
+							  TAR_SEND_SIZE - bbzstream->avail_out))
+				ereport(ERROR,
+						(errmsg("base backup could not send data, aborting backup")));
+			bbzstream->next_out = (Bytef *) bbzbuf;
+			bbzstream->avail_out = TAR_SEND_SIZE;
+		}
+	} while (rc != Z_STREAM_END);
+
+	if (deflateReset(bbzstream) != Z_OK)
+		elog(ERROR, "could not reset compression stream: %s",
+			 bbzstream->msg ? bbzstream->msg : "unknown error");
+	bbzpending = false;
+#endif
+}
+
+/*
+ * Start compressing the tar stream at the given level.
+ */
+static void
+bbCompressStart(int level)
+{
+#ifdef HAVE_LIBZ
+	bbCompressEnd();
+
+	bbzstream = MemoryContextAllocZero(TopMemoryContext, sizeof(z_stream));
+	bbzbuf = MemoryContextAlloc(TopMemoryContext, TAR_SEND_SIZE);
+
+	/* 15 + 16 means a 32k window with a gzip header */
+	if (deflateInit2(bbzstream, level, Z_DEFLATED, 15 + 16, 8,
+					 Z_DEFAULT_STRATEGY) != Z_OK)
+	{
+		pfree(bbzstream);
+		bbzstream = NULL;
+		elog(ERROR, "could not initialize compression library");
+	}
+	bbzstream->next_out = (Bytef *) bbzbuf;
+	bbzstream->avail_out = TAR_SEND_SIZE;
+	bbzpending = false;
+#else
+	elog(ERROR, "compression is not supported by this build");
+#endif
+}
+
+/*
+ * Release the compression state, if any.
+ */
+static void
+bbCompressEnd(void)
+{
+#ifdef HAVE_LIBZ
+	if (bbzstream == NULL)
+		return;
+
+	deflateEnd(bbzstream);
+	pfree(bbzstream);
+	pfree(bbzbuf);
+	bbzstream = NULL;
+	bbzbuf = NULL;
+#endif
+}
+
+/*****
+ * Functions for handing files off to base backup workers
+ *
+ * Each worker gets a queue of work items, each of which is a file or a range
+ * of one, and a queue for the tar data it produces.  A worker sends each item
+ * exactly as sendFile or sendFileIncremental would, compressed as a separate
+ * gzip member if requested, followed by a 'Z' message saying whether the file
+ * was found.  We forward the CopyData messages to the client, and rethrow any
+ * errors or notices.
+ */
+
+/*
+ * Start the requested number of workers.  If none can be started, we send
+ * the files ourselves.
+ */
+static void
+bbWorkersStart(basebackup_options *opt)
+{
+	BaseBackupWorkers *w;
+	MemoryContext context;
+	MemoryContext oldcontext;
+	shm_toc_estimator e;
+	shm_toc    *toc;
+	Size		queuesize;
+	Size		segsize;
+	BaseBackupShared *shared;
+	char	   *queues;
+	BackgroundWorker worker;
+	int			i;
+
+	/* Without dynamic shared memory, we can't talk to workers. */
+	if (dynamic_shared_memory_type == DSM_IMPL_NONE)
+	{
+		ereport(WARNING,
+				(errmsg("could not start base backup workers"),
+				 errdetail("Dynamic shared memory is not available.")));
+		return;
+	}
+
+	context = AllocSetContextCreate(TopMemoryContext,
+									"base backup workers",
+									ALLOCSET_DEFAULT_MINSIZE,
+									ALLOCSET_DEFAULT_INITSIZE,
+									ALLOCSET_DEFAULT_MAXSIZE);
+	oldcontext = MemoryContextSwitchTo(context);
+
+	w = palloc0(sizeof(BaseBackupWorkers));
+	w->context = context;
+	w->handle = palloc0(opt->nworkers * sizeof(BackgroundWorkerHandle *));
+	w->inqh = palloc0(opt->nworkers * sizeof(shm_mq_handle *));
+	w->outqh = palloc0(opt->nworkers * sizeof(shm_mq_handle *));
+	w->outstanding = palloc0(opt->nworkers * sizeof(int));
+	initStringInfo(&w->local);
+
+	/* Set up the shared memory segment */
+	queuesize = BASEBACKUP_INQUEUE_SIZE + BASEBACKUP_OUTQUEUE_SIZE;
+	shm_toc_initialize_estimator(&e);
+	shm_toc_estimate_chunk(&e, sizeof(BaseBackupShared));
+	shm_toc_estimate_chunk(&e, mul_size(queuesize, opt->nworkers));
+	shm_toc_estimate_keys(&e, 2);
+	segsize = shm_toc_estimate(&e);
+
+	w->seg = dsm_create(segsize, 0);
+	dsm_pin_mapping(w->seg);
+	toc = shm_toc_create(BASEBACKUP_MAGIC, dsm_segment_address(w->seg),
+						 segsize);
+
+	shared = shm_toc_allocate(toc, sizeof(BaseBackupShared));
+	shared->nworkers = opt->nworkers;
+	shared->compression = opt->compression;
+	shared->incremental_lsn = opt->incremental_lsn;
+	SpinLockInit(&shared->mutex);
+	shared->nattached = 0;
+	shm_toc_insert(toc, BASEBACKUP_KEY_SHARED, shared);
+
+	queues = shm_toc_allocate(toc, mul_size(queuesize, opt->nworkers));
+	shm_toc_insert(toc, BASEBACKUP_KEY_QUEUES, queues);
+	for (i = 0; i < opt->nworkers; i++)
+	{
+		char	   *space = queues + i * queuesize;
+		shm_mq	   *mq;
+
+		mq = shm_mq_create(space, BASEBACKUP_INQUEUE_SIZE);
+		shm_mq_set_sender(mq, MyProc);
+		w->inqh[i] = shm_mq_attach(mq, w->seg, NULL);
+
+		mq = shm_mq_create(space + BASEBACKUP_INQUEUE_SIZE,
+						   BASEBACKUP_OUTQUEUE_SIZE);
+		shm_mq_set_receiver(mq, MyProc);
+		w->outqh[i] = shm_mq_attach(mq, w->seg, NULL);
+	}
+
+	/* Launch the workers */
+	MemSet(&worker, 0, sizeof(worker));
+	snprintf(worker.bgw_name, BGW_MAXLEN, "base backup worker for PID %d",
+			 MyProcPid);
+	worker.bgw_flags = BGWORKER_SHMEM_ACCESS;
+	/* a base backup can be taken from a standby that isn't hot */
+	worker.bgw_start_time = BgWorkerStart_PostmasterStart;
+	worker.bgw_restart_time = BGW_NEVER_RESTART;
+	worker.bgw_main = BaseBackupWorkerMain;
+	worker.bgw_main_arg = UInt32GetDatum(dsm_segment_handle(w->seg));
+	worker.bgw_notify_pid = MyProcPid;
+
+	for (i = 0; i < opt->nworkers; i++)
+	{
+		if (!RegisterDynamicBackgroundWorker(&worker, &w->handle[i]))
+			break;
+		shm_mq_set_handle(w->inqh[i], w->handle[i]);
+		shm_mq_set_handle(w->outqh[i], w->handle[i]);
+	}
+	w->nworkers = i;
+
+	/* Make room for all the items in flight, and our data in between */
+	w->maxpending = 2 * w->nworkers * BASEBACKUP_ITEMS_PER_WORKER + 1;
+	w->pending = palloc0(w->maxpending * sizeof(BaseBackupPending));
+
+	MemoryContextSwitchTo(oldcontext);
+
+	if (w->nworkers == 0)
+	{
+		ereport(WARNING,
+				(errmsg("could not start base backup workers"),
+				 errhint("You might need to increase max_worker_processes.")));
+		dsm_detach(w->seg);
+		MemoryContextDelete(w->context);
+		return;
+	}
+
+	bbworkers = w;
+}
+
+/*
+ * Queue the data we have sent ourselves since the last work item was handed
+ * out, so that it reaches the client after the output of that item.
+ */
+static void
+bbWorkersQueueLocal(void)
+{
+	BaseBackupWorkers *w = bbworkers;
+	BaseBackupPending *entry;
+
+	if (w->local.len == 0)
+		return;
+
+	while (w->npending >= w->maxpending)
+		bbWorkersConsumeOne();
+
+	entry = &w->pending[(w->pending_head + w->npending) % w->maxpending];
+	entry->worker = -1;
+	entry->data = MemoryContextAlloc(w->context, w->local.len);
+	memcpy(entry->data, w->local.data, w->local.len);
+	entry->len = w->local.len;
+	w->npending++;
+
+	resetStringInfo(&w->local);
+}
+
+/*
+ * Hand a work item to the next worker, first forwarding output of earlier
+ * items if that worker is busy.
+ */
+static void
+bbWorkersDispatch(BaseBackupWorkItem *item)
+{
+	BaseBackupWorkers *w = bbworkers;
+	BaseBackupPending *entry;
+	int			worker;
+
+	bbWorkersQueueLocal();
+
+	worker = w->nassigned % w->nworkers;
+	while (w->outstanding[worker] >= BASEBACKUP_ITEMS_PER_WORKER ||
+		   w->npending >= w->maxpending)
+		bbWorkersConsumeOne();
+
+	if (shm_mq_send(w->inqh[worker], sizeof(BaseBackupWorkItem), item,
+					false) != SHM_MQ_SUCCESS)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("base backup worker exited unexpectedly")));
+
+	entry = &w->pending[(w->pending_head + w->npending) % w->maxpending];
+	entry->worker = worker;
+	entry->file = w->file_seq;
+	entry->first = item->first;
+	entry->data = NULL;
+	entry->len = 0;
+	w->npending++;
+
+	w->outstanding[worker]++;
+	w->nassigned++;
+}
+
+/*
+ * Forward the output of the oldest pending entry to the client.
+ */
+static void
+bbWorkersConsumeOne(void)
+{
+	BaseBackupWorkers *w = bbworkers;
+	BaseBackupPending *entry;
+
+	Assert(w->npending > 0);
+	entry = &w->pending[w->pending_head];
+
+	if (entry->worker < 0)
+	{
+		bbSendData(entry->data, entry->len);
+		pfree(entry->data);
+	}
+	else
+	{
+		bool		discard = (entry->file == w->skip_file);
+		bool		done = false;
+
+		/* The worker's gzip members must not be mixed into our own */
+		bbEndStream();
+
+		while (!done)
+		{
+			shm_mq_result res;
+			Size		nbytes;
+			void	   *data;
+			StringInfoData msg;
+			char		msgtype;
+
+			res = shm_mq_receive(w->outqh[entry->worker], &nbytes, &data,
+								 false);
+			if (res != SHM_MQ_SUCCESS)
+				ereport(ERROR,
+						(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+						 errmsg("base backup worker exited unexpectedly")));
+
+			initStringInfo(&msg);
+			appendBinaryStringInfo(&msg, data, nbytes);
+			msgtype = pq_getmsgbyte(&msg);
+
+			switch (msgtype)
+			{
+				case 'd':		/* CopyData */
+					if (!discard)
+					{
+						if (pq_putmessage('d', msg.data + msg.cursor,
+										  msg.len - msg.cursor))
+							ereport(ERROR,
+									(errmsg("base backup could not send data, aborting backup")));
+						throttle(msg.len - msg.cursor);
+					}
+					break;
+
+				case 'E':		/* ErrorResponse */
+				case 'N':		/* NoticeResponse */
+					{
+						ErrorData	edata;
+
+						pq_parse_errornotice(&msg, &edata);
+
+						/* Death of a worker isn't enough justification for suicide. */
+						edata.elevel = Min(edata.elevel, ERROR);
+
+						ThrowErrorData(&edata);
+						break;
+					}
+
+				case 'Z':		/* end of item */
+					{
+						bool		sent = pq_getmsgbyte(&msg) != 0;
+
+						/*
+						 * If the file went away before its first range was
+						 * sent, there's no header for the other ranges.
+						 */
+						if (entry->first && !sent)
+							w->skip_file = entry->file;
+						done = true;
+						break;
+					}
+
+				default:
+					elog(ERROR, "unrecognized message type received from base backup worker: %c (message length %d bytes)",
+						 msgtype, msg.len);
+			}
+
+			pfree(msg.data);
+		}
+
+		w->outstanding[entry->worker]--;
+	}
+
+	w->pending_head = (w->pending_head + 1) % w->maxpending;
+	w->npending--;
+}
+
+/*
+ * Forward everything handed out so far, and our own data queued behind it.
+ */
+static void
+bbWorkersDrain(void)
+{
+	if (bbworkers == NULL)
+		return;
+
+	bbWorkersQueueLocal();
+	while (bbworkers->npending > 0)
+		bbWorkersConsumeOne();
+}
+
+/*
+ * Shut down the workers.  Detaching from the segment detaches the queues,
+ * which tells the workers to exit.  If 'wait' is false, as when we are
+ * cleaning up after an error, we terminate them instead of waiting for them.
+ */
+static void
+bbWorkersShutdown(bool wait)
+{
+	BaseBackupWorkers *w = bbworkers;
+	int			i;
+
+	if (w == NULL)
+		return;
+	bbworkers = NULL;
+
+	if (!wait)
+	{
+		for (i = 0; i < w->nworkers; i++)
+			TerminateBackgroundWorker(w->handle[i]);
+	}
+
+	dsm_detach(w->seg);
+
+	if (wait)
+	{
+		for (i = 0; i < w->nworkers; i++)
+			WaitForBackgroundWorkerShutdown(w->handle[i]);
+	}
+
+	MemoryContextDelete(w->context);
+}
+
+/*
+ * Main entry point for a base backup worker.
+ */
+static void
+BaseBackupWorkerMain(Datum main_arg)
+{
+	dsm_segment *seg;
+	shm_toc    *toc;
+	BaseBackupShared *shared;
+	char	   *queues;
+	Size		queuesize;
+	shm_mq	   *inmq;
+	shm_mq	   *outmq;
+	shm_mq_handle *inqh;
+	shm_mq_handle *outqh;
+	int			slot = -1;
+
+	/* Establish signal handlers. */
+	pqsignal(SIGTERM, die);
+	BackgroundWorkerUnblockSignals();
+
+	/* Set up a resource owner, so that we can attach to the segment. */
+	Assert(CurrentResourceOwner == NULL);
+	CurrentResourceOwner = ResourceOwnerCreate(NULL, "base backup worker");
+	CurrentMemoryContext = AllocSetContextCreate(TopMemoryContext,
+												 "base backup worker",
+												 ALLOCSET_DEFAULT_MINSIZE,
+												 ALLOCSET_DEFAULT_INITSIZE,
+												 ALLOCSET_DEFAULT_MAXSIZE);
+
+	seg = dsm_attach(DatumGetUInt32(main_arg));
+	if (seg == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("unable to map dynamic shared memory segment")));
+	toc = shm_toc_attach(BASEBACKUP_MAGIC, dsm_segment_address(seg));
+	if (toc == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+			   errmsg("bad magic number in dynamic shared memory segment")));
+
+	/* Claim a pair of queues */
+	shared = shm_toc_lookup(toc, BASEBACKUP_KEY_SHARED);
+	SpinLockAcquire(&shared->mutex);
+	if (shared->nattached < shared->nworkers)
+		slot = shared->nattached++;
+	SpinLockRelease(&shared->mutex);
+	if (slot < 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("too many base backup workers already attached")));
+
+	queuesize = BASEBACKUP_INQUEUE_SIZE + BASEBACKUP_OUTQUEUE_SIZE;
+	queues = shm_toc_lookup(toc, BASEBACKUP_KEY_QUEUES);
+	inmq = (shm_mq *) (queues + slot * queuesize);
+	outmq = (shm_mq *) (queues + slot * queuesize + BASEBACKUP_INQUEUE_SIZE);
+	shm_mq_set_receiver(inmq, MyProc);
+	shm_mq_set_sender(outmq, MyProc);
+	inqh = shm_mq_attach(inmq, seg, NULL);
+	outqh = shm_mq_attach(outmq, seg, NULL);
+
+	/* From now on, our output (including errors) goes to the walsender. */
+	pq_redirect_to_shm_mq(outmq, outqh);
+
+	/* The walsender throttles what it forwards. */
+	throttling_counter = -1;
+	incremental_lsn = shared->incremental_lsn;
+	if (shared->compression > 0)
+		bbCompressStart(shared->compression);
+
+	for (;;)
+	{
+		BaseBackupWorkItem item;
+		Size		nbytes;
+		void	   *data;
+		bool		sent;
+		char		status;
+
+		/* The walsender detaches when there's no more work. */
+		if (shm_mq_receive(inqh, &nbytes, &data, false) != SHM_MQ_SUCCESS)
+			break;
+		if (nbytes != sizeof(BaseBackupWorkItem))
+			elog(ERROR, "invalid base backup work item size: %zu", nbytes);
+		memcpy(&item, data, sizeof(BaseBackupWorkItem));
+
+		if (item.incremental)
+			sent = sendFileIncremental(item.readfilename, item.tarfilename,
+									   &item.statbuf);
+		else
+			sent = sendFileRange(item.readfilename, item.tarfilename,
+								 &item.statbuf, true, item.offset,
+								 item.length, item.first, item.last);
+		bbEndStream();
+
+		status = sent ? 1 : 0;
+		pq_putmessage('Z', &status, 1);
+	}
+
+	bbCompressEnd();
+	proc_exit(0);
+}
@@ -21,6 +21,8 @@
 
 #include "libpq-fe.h"
 #include "access/xlog.h"
+#include "lib/stringinfo.h"
+#include "mb/pg_wchar.h"
 #include "miscadmin.h"
 #include "replication/walreceiver.h"
 #include "utils/builtins.h"
@@ -55,6 +57,9 @@ static void libpqrcv_endstreaming(TimeLineID *next_tli);
 static int	libpqrcv_receive(int timeout, char **buffer);
 static void libpqrcv_send(const char *buffer, int nbytes);
 static void libpqrcv_disconnect(void);
+static void libpqrcv_connect_logical(char *conninfo, char *appname);
+static void libpqrcv_startstreaming_logical(char *slotname,
+								XLogRecPtr startpoint, char *options);
 
 /* Prototypes for private functions */
 static bool libpq_select(int timeout_ms);
@@ -71,7 +76,8 @@ _PG_init(void)
 		walrcv_readtimelinehistoryfile != NULL ||
 		walrcv_startstreaming != NULL || walrcv_endstreaming != NULL ||
 		walrcv_receive != NULL || walrcv_send != NULL ||
-		walrcv_disconnect != NULL)
+		walrcv_disconnect != NULL || walrcv_connect_logical != NULL ||
+		walrcv_startstreaming_logical != NULL)
 		elog(ERROR, "libpqwalreceiver already loaded");
 	walrcv_connect = libpqrcv_connect;
 	walrcv_identify_system = libpqrcv_identify_system;
@@ -81,6 +87,8 @@ _PG_init(void)
 	walrcv_receive = libpqrcv_receive;
 	walrcv_send = libpqrcv_send;
 	walrcv_disconnect = libpqrcv_disconnect;
+	walrcv_connect_logical = libpqrcv_connect_logical;
+	walrcv_startstreaming_logical = libpqrcv_startstreaming_logical;
 }
 
 /*
@@ -117,6 +125,38 @@ libpqrcv_connect(char *conninfo)
 						PQerrorMessage(streamConn))));
 }
 
+/*
+ * Establish a database-bound replication connection to the publisher, for
+ * streaming from a logical slot.
+ *
+ * Unlike libpqrcv_connect, the database named in the connection string is
+ * used, and the client encoding is set to our database encoding so that
+ * values sent in text form can be fed to our input functions directly.
+ */
+static void
+libpqrcv_connect_logical(char *conninfo, char *appname)
+{
+	const char *keys[5];
+	const char *vals[5];
+
+	keys[0] = "dbname";
+	vals[0] = conninfo;
+	keys[1] = "replication";
+	vals[1] = "database";
+	keys[2] = "fallback_application_name";
+	vals[2] = appname;
+	keys[3] = "client_encoding";
+	vals[3] = GetDatabaseEncodingName();
+	keys[4] = NULL;
+	vals[4] = NULL;
+
+	streamConn = PQconnectdbParams(keys, vals, /* expand_dbname = */ true);
+	if (PQstatus(streamConn) != CONNECTION_OK)
+		ereport(ERROR,
+				(errmsg("could not connect to the publisher: %s",
+						PQerrorMessage(streamConn))));
+}
+
 /*
  * Check that primary's system identifier matches ours, and fetch the current
  * timeline ID of the primary.
@@ -215,6 +255,40 @@ libpqrcv_startstreaming(TimeLineID tli, XLogRecPtr startpoint, char *slotname)
 	return true;
 }
 
+/*
+ * Start streaming changes from a logical slot, beginning at startpoint.
+ *
+ * options is passed as the parenthesized list of output plugin options, or
+ * may be NULL.  Throws an ERROR if the server did not switch to copy-both
+ * mode.
+ */
+static void
+libpqrcv_startstreaming_logical(char *slotname, XLogRecPtr startpoint,
+								char *options)
+{
+	StringInfoData cmd;
+	PGresult   *res;
+
+	initStringInfo(&cmd);
+	appendStringInfo(&cmd, "START_REPLICATION SLOT \"%s\" LOGICAL %X/%X",
+					 slotname,
+					 (uint32) (startpoint >> 32), (uint32) startpoint);
+	if (options != NULL && options[0] != '\0')
+		appendStringInfo(&cmd, " (%s)", options);
+
+	res = libpqrcv_PQexec(cmd.data);
+	pfree(cmd.data);
+
+	if (PQresultStatus(res) != PGRES_COPY_BOTH)
+	{
+		PQclear(res);
+		ereport(ERROR,
+				(errmsg("could not start logical replication streaming: %s",
+						PQerrorMessage(streamConn))));
+	}
+	PQclear(res);
+}
+
 /*
  * Stop streaming WAL data. Returns the next timeline's ID in *next_tli, as
  * reported by the server, or 0 if it did not report it.
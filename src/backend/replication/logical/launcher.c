@@ -0,0 +1,680 @@
+/*-------------------------------------------------------------------------
+ *
+ * launcher.c
+ *	   PostgreSQL logical replication worker launcher
+ *
+ * The launcher is a background worker, registered by the postmaster at
+ * startup, that is not connected to any particular database.  It
+ * periodically scans the shared pg_subscription catalog and starts an apply
+ * worker (see worker.c) for every enabled subscription that does not have
+ * one, as long as there are free worker slots.  Workers that exit are
+ * restarted after wal_retrieve_retry_interval.
+ *
+ * Each apply worker owns a slot in shared memory, which it uses to report
+ * its progress and which backends use to find and stop the worker when a
+ * subscription is disabled or dropped.
+ *
+ * Copyright (c) 2015, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  src/backend/replication/logical/launcher.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <signal.h>
+
+#include "access/xact.h"
+#include "access/xlog.h"
+#include "catalog/pg_subscription.h"
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "postmaster/bgworker.h"
+#include "replication/logicallauncher.h"
+#include "storage/ipc.h"
+#include "storage/latch.h"
+#include "storage/proc.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
+#include "utils/builtins.h"
+#include "utils/guc.h"
+#include "utils/hsearch.h"
+#include "utils/memutils.h"
+#include "utils/pg_lsn.h"
+#include "utils/snapmgr.h"
+#include "utils/timestamp.h"
+
+/* max sleep time between cycles (3min) */
+#define DEFAULT_NAPTIME_PER_CYCLE 180000L
+
+int			max_logical_replication_workers = 4;
+
+typedef struct LogicalRepCtxStruct
+{
+	slock_t		mutex;			/* protects everything below */
+	Latch	   *launcher_latch; /* latch of the running launcher, if any */
+	LogicalRepWorker workers[FLEXIBLE_ARRAY_MEMBER];
+} LogicalRepCtxStruct;
+
+static LogicalRepCtxStruct *LogicalRepCtx;
+
+LogicalRepWorker *MyLogicalRepWorker = NULL;
+
+/* Set by ApplyLauncherWakeupAtCommit, consumed at end of transaction */
+static bool on_commit_launcher_wakeup = false;
+
+/*
+ * Launcher-local state.  The launcher keeps the handle of every worker it
+ * registered, indexed by slot, and the time each subscription's worker was
+ * last started, to throttle restarts of failing workers.
+ */
+static BackgroundWorkerHandle **worker_handles = NULL;
+
+typedef struct LauncherLastStart
+{
+	Oid			subid;			/* hash key */
+	TimestampTz last_start;
+} LauncherLastStart;
+
+static HTAB *last_start_times = NULL;
+
+static volatile sig_atomic_t got_SIGHUP = false;
+static volatile sig_atomic_t got_SIGTERM = false;
+
+static void logicalrep_launcher_onexit(int code, Datum arg);
+static void logicalrep_worker_onexit(int code, Datum arg);
+static void logicalrep_launcher_sighup(SIGNAL_ARGS);
+static void logicalrep_launcher_sigterm(SIGNAL_ARGS);
+static void logicalrep_launcher_sigusr1(SIGNAL_ARGS);
+static bool logicalrep_worker_running(Oid subid);
+static void logicalrep_worker_launch(Oid dbid, Oid subid);
+static void logicalrep_launcher_reap(void);
+static long logicalrep_launcher_reconcile(void);
+
+
+/*
+ * Report shared-memory space needed by ApplyLauncherShmemInit
+ */
+Size
+ApplyLauncherShmemSize(void)
+{
+	Size		size;
+
+	size = offsetof(LogicalRepCtxStruct, workers);
+	size = add_size(size, mul_size(max_logical_replication_workers,
+								   sizeof(LogicalRepWorker)));
+	return size;
+}
+
+/*
+ * Allocate and initialize the shared state of the launcher and workers
+ */
+void
+ApplyLauncherShmemInit(void)
+{
+	bool		found;
+
+	LogicalRepCtx = (LogicalRepCtxStruct *)
+		ShmemInitStruct("Logical Replication Launcher Data",
+						ApplyLauncherShmemSize(),
+						&found);
+
+	if (!found)
+	{
+		MemSet(LogicalRepCtx, 0, ApplyLauncherShmemSize());
+		SpinLockInit(&LogicalRepCtx->mutex);
+	}
+}
+
+/*
+ * Register the launcher with the postmaster.  Called by the postmaster at
+ * startup; does nothing if logical replication workers are disabled.
+ */
+void
+ApplyLauncherRegister(void)
+{
+	BackgroundWorker bgw;
+
+	if (max_logical_replication_workers == 0)
+		return;
+
+	MemSet(&bgw, 0, sizeof(bgw));
+	snprintf(bgw.bgw_name, BGW_MAXLEN, "logical replication launcher");
+	bgw.bgw_flags = BGWORKER_SHMEM_ACCESS |
+		BGWORKER_BACKEND_DATABASE_CONNECTION;
+	bgw.bgw_start_time = BgWorkerStart_RecoveryFinished;
+	bgw.bgw_restart_time = 5;
+	bgw.bgw_main = ApplyLauncherMain;
+	bgw.bgw_main_arg = (Datum) 0;
+	bgw.bgw_notify_pid = 0;
+
+	RegisterBackgroundWorker(&bgw);
+}
+
+/*
+ * Request the launcher to rescan subscriptions when the current transaction
+ * commits.
+ */
+void
+ApplyLauncherWakeupAtCommit(void)
+{
+	on_commit_launcher_wakeup = true;
+}
+
+/*
+ * Wake up the launcher, if requested in this transaction and we committed.
+ */
+void
+AtEOXact_ApplyLauncher(bool isCommit)
+{
+	if (isCommit && on_commit_launcher_wakeup && LogicalRepCtx != NULL)
+	{
+		Latch	   *latch;
+
+		SpinLockAcquire(&LogicalRepCtx->mutex);
+		latch = LogicalRepCtx->launcher_latch;
+		SpinLockRelease(&LogicalRepCtx->mutex);
+
+		if (latch != NULL)
+			SetLatch(latch);
+	}
+
+	on_commit_launcher_wakeup = false;
+}
+
+/*
+ * Is there a worker slot assigned to the given subscription?
+ */
+static bool
+logicalrep_worker_running(Oid subid)
+{
+	bool		found = false;
+	int			i;
+
+	SpinLockAcquire(&LogicalRepCtx->mutex);
+	for (i = 0; i < max_logical_replication_workers; i++)
+	{
+		LogicalRepWorker *w = &LogicalRepCtx->workers[i];
+
+		if (w->in_use && w->subid == subid)
+		{
+			found = true;
+			break;
+		}
+	}
+	SpinLockRelease(&LogicalRepCtx->mutex);
+
+	return found;
+}
+
+/*
+ * Start an apply worker for the given subscription.  Called by the launcher.
+ */
+static void
+logicalrep_worker_launch(Oid dbid, Oid subid)
+{
+	BackgroundWorker bgw;
+	BackgroundWorkerHandle *handle;
+	MemoryContext oldcontext;
+	int			slot = -1;
+	int			i;
+
+	/* Find a free slot; slots with a handle still await reaping */
+	SpinLockAcquire(&LogicalRepCtx->mutex);
+	for (i = 0; i < max_logical_replication_workers; i++)
+	{
+		LogicalRepWorker *w = &LogicalRepCtx->workers[i];
+
+		if (!w->in_use && worker_handles[i] == NULL)
+		{
+			MemSet(w, 0, sizeof(LogicalRepWorker));
+			w->in_use = true;
+			w->dbid = dbid;
+			w->subid = subid;
+			slot = i;
+			break;
+		}
+	}
+	SpinLockRelease(&LogicalRepCtx->mutex);
+
+	if (slot < 0)
+	{
+		ereport(WARNING,
+				(errcode(ERRCODE_CONFIGURATION_LIMIT_EXCEEDED),
+				 errmsg("out of logical replication worker slots"),
+				 errhint("You might need to increase max_logical_replication_workers.")));
+		return;
+	}
+
+	ereport(DEBUG1,
+			(errmsg("starting logical replication worker for subscription %u",
+					subid)));
+
+	MemSet(&bgw, 0, sizeof(bgw));
+	snprintf(bgw.bgw_name, BGW_MAXLEN,
+			 "logical replication worker for subscription %u", subid);
+	bgw.bgw_flags = BGWORKER_SHMEM_ACCESS |
+		BGWORKER_BACKEND_DATABASE_CONNECTION;
+	bgw.bgw_start_time = BgWorkerStart_RecoveryFinished;
+	bgw.bgw_restart_time = BGW_NEVER_RESTART;
+	bgw.bgw_main = ApplyWorkerMain;
+	bgw.bgw_main_arg = Int32GetDatum(slot);
+	bgw.bgw_notify_pid = MyProcPid;
+
+	oldcontext = MemoryContextSwitchTo(TopMemoryContext);
+	if (!RegisterDynamicBackgroundWorker(&bgw, &handle))
+	{
+		MemoryContextSwitchTo(oldcontext);
+
+		SpinLockAcquire(&LogicalRepCtx->mutex);
+		LogicalRepCtx->workers[slot].in_use = false;
+		SpinLockRelease(&LogicalRepCtx->mutex);
+
+		ereport(WARNING,
+				(errcode(ERRCODE_CONFIGURATION_LIMIT_EXCEEDED),
+				 errmsg("out of background worker slots"),
+				 errhint("You might need to increase max_worker_processes.")));
+		return;
+	}
+	MemoryContextSwitchTo(oldcontext);
+
+	worker_handles[slot] = handle;
+}
+
+/*
+ * Attach the current apply worker to its slot.
+ */
+void
+logicalrep_worker_attach(int slot)
+{
+	Assert(slot >= 0 && slot < max_logical_replication_workers);
+
+	SpinLockAcquire(&LogicalRepCtx->mutex);
+	MyLogicalRepWorker = &LogicalRepCtx->workers[slot];
+	if (!MyLogicalRepWorker->in_use || MyLogicalRepWorker->pid != 0)
+	{
+		SpinLockRelease(&LogicalRepCtx->mutex);
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("logical replication worker slot %d is not available",
+						slot)));
+	}
+	MyLogicalRepWorker->pid = MyProcPid;
+	SpinLockRelease(&LogicalRepCtx->mutex);
+
+	on_shmem_exit(logicalrep_worker_onexit, (Datum) 0);
+}
+
+/*
+ * Release the slot of an exiting apply worker.
+ */
+static void
+logicalrep_worker_onexit(int code, Datum arg)
+{
+	SpinLockAcquire(&LogicalRepCtx->mutex);
+	MyLogicalRepWorker->in_use = false;
+	MyLogicalRepWorker->pid = 0;
+	SpinLockRelease(&LogicalRepCtx->mutex);
+
+	MyLogicalRepWorker = NULL;
+}
+
+/*
+ * Report the progress of the current apply worker, for pg_stat_subscription.
+ * Invalid positions and zero timestamps leave the corresponding field alone.
+ */
+void
+logicalrep_worker_report(XLogRecPtr received_lsn, TimestampTz recv_time,
+						 XLogRecPtr reply_lsn, TimestampTz reply_time)
+{
+	Assert(MyLogicalRepWorker != NULL);
+
+	SpinLockAcquire(&LogicalRepCtx->mutex);
+	if (!XLogRecPtrIsInvalid(received_lsn))
+		MyLogicalRepWorker->received_lsn = received_lsn;
+	if (recv_time != 0)
+		MyLogicalRepWorker->last_recv_time = recv_time;
+	if (!XLogRecPtrIsInvalid(reply_lsn))
+		MyLogicalRepWorker->reply_lsn = reply_lsn;
+	if (reply_time != 0)
+		MyLogicalRepWorker->reply_time = reply_time;
+	SpinLockRelease(&LogicalRepCtx->mutex);
+}
+
+/*
+ * Stop the apply worker of the given subscription, if any, and wait for it
+ * to exit.
+ *
+ * The caller holds a lock on the subscription that prevents a newly started
+ * worker from getting past its startup, so once no slot is assigned to the
+ * subscription it stays that way until the caller's transaction ends.
+ */
+void
+logicalrep_worker_stop(Oid subid)
+{
+	pid_t		signalled_pid = 0;
+
+	for (;;)
+	{
+		bool		found = false;
+		pid_t		pid = 0;
+		int			rc;
+		int			i;
+
+		SpinLockAcquire(&LogicalRepCtx->mutex);
+		for (i = 0; i < max_logical_replication_workers; i++)
+		{
+			LogicalRepWorker *w = &LogicalRepCtx->workers[i];
+
+			if (w->in_use && w->subid == subid)
+			{
+				found = true;
+				pid = w->pid;
+				break;
+			}
+		}
+		SpinLockRelease(&LogicalRepCtx->mutex);
+
+		if (!found)
+			break;
+
+		/* A worker that has not started yet will be signalled once it has */
+		if (pid != 0 && pid != signalled_pid)
+		{
+			kill(pid, SIGTERM);
+			signalled_pid = pid;
+		}
+
+		rc = WaitLatch(MyLatch,
+					   WL_LATCH_SET | WL_TIMEOUT | WL_POSTMASTER_DEATH, 10L);
+		if (rc & WL_POSTMASTER_DEATH)
+			proc_exit(1);
+		ResetLatch(MyLatch);
+
+		CHECK_FOR_INTERRUPTS();
+	}
+}
+
+/*
+ * Forget the handles of workers that have exited, freeing their slots.
+ */
+static void
+logicalrep_launcher_reap(void)
+{
+	int			i;
+
+	for (i = 0; i < max_logical_replication_workers; i++)
+	{
+		BgwHandleStatus status;
+		pid_t		pid;
+
+		if (worker_handles[i] == NULL)
+			continue;
+
+		status = GetBackgroundWorkerPid(worker_handles[i], &pid);
+		if (status != BGWH_STOPPED && status != BGWH_POSTMASTER_DIED)
+			continue;
+
+		pfree(worker_handles[i]);
+		worker_handles[i] = NULL;
+
+		/* The worker normally does this itself, but it may have crashed */
+		SpinLockAcquire(&LogicalRepCtx->mutex);
+		LogicalRepCtx->workers[i].in_use = false;
+		LogicalRepCtx->workers[i].pid = 0;
+		SpinLockRelease(&LogicalRepCtx->mutex);
+	}
+}
+
+/*
+ * Start workers for enabled subscriptions that lack one.
+ *
+ * Returns how long the launcher may sleep before it needs to run again.
+ */
+static long
+logicalrep_launcher_reconcile(void)
+{
+	long		wait_time = DEFAULT_NAPTIME_PER_CYCLE;
+	TimestampTz now;
+	List	   *sublist;
+	ListCell   *lc;
+
+	logicalrep_launcher_reap();
+
+	now = GetCurrentTimestamp();
+
+	StartTransactionCommand();
+	(void) GetTransactionSnapshot();
+
+	sublist = GetSubscriptionList();
+	foreach(lc, sublist)
+	{
+		Subscription *sub = (Subscription *) lfirst(lc);
+		LauncherLastStart *entry;
+		bool		found;
+
+		if (!sub->enabled || logicalrep_worker_running(sub->oid))
+			continue;
+
+		entry = hash_search(last_start_times, &sub->oid, HASH_ENTER, &found);
+		if (found &&
+			!TimestampDifferenceExceeds(entry->last_start, now,
+										wal_retrieve_retry_interval))
+		{
+			/* Started recently; retry once the interval has passed */
+			wait_time = Min(wait_time, wal_retrieve_retry_interval);
+			continue;
+		}
+
+		entry->last_start = now;
+		logicalrep_worker_launch(sub->dbid, sub->oid);
+	}
+
+	CommitTransactionCommand();
+
+	return wait_time;
+}
+
+/*
+ * Clear the launcher's latch from shared memory on exit.
+ */
+static void
+logicalrep_launcher_onexit(int code, Datum arg)
+{
+	SpinLockAcquire(&LogicalRepCtx->mutex);
+	LogicalRepCtx->launcher_latch = NULL;
+	SpinLockRelease(&LogicalRepCtx->mutex);
+}
+
+/* SIGHUP: set flag to reload configuration at next convenient time */
+static void
+logicalrep_launcher_sighup(SIGNAL_ARGS)
+{
+	int			save_errno = errno;
+
+	got_SIGHUP = true;
+	SetLatch(MyLatch);
+
+	errno = save_errno;
+}
+
+/* SIGTERM: set flag to exit at next convenient time */
+static void
+logicalrep_launcher_sigterm(SIGNAL_ARGS)
+{
+	int			save_errno = errno;
+
+	got_SIGTERM = true;
+	SetLatch(MyLatch);
+
+	errno = save_errno;
+}
+
+/* SIGUSR1: the postmaster reports a worker having started or stopped */
+static void
+logicalrep_launcher_sigusr1(SIGNAL_ARGS)
+{
+	int			save_errno = errno;
+
+	SetLatch(MyLatch);
+	latch_sigusr1_handler();
+
+	errno = save_errno;
+}
+
+/*
+ * Main loop for the launcher process.
+ */
+void
+ApplyLauncherMain(Datum main_arg)
+{
+	HASHCTL		ctl;
+
+	ereport(DEBUG1,
+			(errmsg("logical replication launcher started")));
+
+	/* Establish signal handlers. */
+	pqsignal(SIGHUP, logicalrep_launcher_sighup);
+	pqsignal(SIGTERM, logicalrep_launcher_sigterm);
+	pqsignal(SIGUSR1, logicalrep_launcher_sigusr1);
+	BackgroundWorkerUnblockSignals();
+
+	/* Only shared catalogs are needed, so don't connect to a database. */
+	BackgroundWorkerInitializeConnection(NULL, NULL);
+
+	worker_handles = (BackgroundWorkerHandle **)
+		MemoryContextAllocZero(TopMemoryContext,
+							   max_logical_replication_workers *
+							   sizeof(BackgroundWorkerHandle *));
+
+	MemSet(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(Oid);
+	ctl.entrysize = sizeof(LauncherLastStart);
+	last_start_times = hash_create("logical replication launcher start times",
+								   32, &ctl, HASH_ELEM | HASH_BLOBS);
+
+	/* Let backends wake us up when subscriptions change. */
+	SpinLockAcquire(&LogicalRepCtx->mutex);
+	LogicalRepCtx->launcher_latch = MyLatch;
+	SpinLockRelease(&LogicalRepCtx->mutex);
+	on_shmem_exit(logicalrep_launcher_onexit, (Datum) 0);
+
+	while (!got_SIGTERM)
+	{
+		long		wait_time;
+		int			rc;
+
+		wait_time = logicalrep_launcher_reconcile();
+
+		rc = WaitLatch(MyLatch,
+					   WL_LATCH_SET | WL_TIMEOUT | WL_POSTMASTER_DEATH,
+					   wait_time);
+
+		/* emergency bailout if postmaster has died */
+		if (rc & WL_POSTMASTER_DEATH)
+			proc_exit(1);
+
+		ResetLatch(MyLatch);
+
+		if (got_SIGHUP)
+		{
+			got_SIGHUP = false;
+			ProcessConfigFile(PGC_SIGHUP);
+		}
+	}
+
+	/*
+	 * Workers are left running; they are stopped by the postmaster.  Exit
+	 * with status 1 so that we are restarted if we were terminated by
+	 * anything other than a server shutdown.
+	 */
+	proc_exit(1);
+}
+
+/*
+ * Returns state of the logical replication workers.
+ */
+Datum
+pg_stat_get_subscription(PG_FUNCTION_ARGS)
+{
+#define PG_STAT_GET_SUBSCRIPTION_COLS	6
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+	int			i;
+
+	/* check to see if caller supports us returning a tuplestore */
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("set-valued function called in context that cannot accept a set")));
+	if (!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("materialize mode required, but it is not " \
+						"allowed in this context")));
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	for (i = 0; i < max_logical_replication_workers; i++)
+	{
+		LogicalRepWorker worker;
+		Datum		values[PG_STAT_GET_SUBSCRIPTION_COLS];
+		bool		nulls[PG_STAT_GET_SUBSCRIPTION_COLS];
+
+		SpinLockAcquire(&LogicalRepCtx->mutex);
+		memcpy(&worker, &LogicalRepCtx->workers[i], sizeof(LogicalRepWorker));
+		SpinLockRelease(&LogicalRepCtx->mutex);
+
+		if (!worker.in_use)
+			continue;
+
+		MemSet(values, 0, sizeof(values));
+		MemSet(nulls, 0, sizeof(nulls));
+
+		values[0] = ObjectIdGetDatum(worker.subid);
+		if (worker.pid != 0)
+			values[1] = Int32GetDatum(worker.pid);
+		else
+			nulls[1] = true;
+		if (XLogRecPtrIsInvalid(worker.received_lsn))
+			nulls[2] = true;
+		else
+			values[2] = LSNGetDatum(worker.received_lsn);
+		if (worker.last_recv_time == 0)
+			nulls[3] = true;
+		else
+			values[3] = TimestampTzGetDatum(worker.last_recv_time);
+		if (XLogRecPtrIsInvalid(worker.reply_lsn))
+			nulls[4] = true;
+		else
+			values[4] = LSNGetDatum(worker.reply_lsn);
+		if (worker.reply_time == 0)
+			nulls[5] = true;
+		else
+			values[5] = TimestampTzGetDatum(worker.reply_time);
+
+		tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+	}
+
+	/* clean up and return the tuplestore */
+	tuplestore_donestoring(tupstore);
+
+	return (Datum) 0;
+}
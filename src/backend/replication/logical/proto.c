@@ -0,0 +1,520 @@
+/*-------------------------------------------------------------------------
+ *
+ * proto.c
+ *		logical replication protocol functions
+ *
+ * The messages defined here are written by the pgoutput output plugin on
+ * the publisher and read by the apply worker on the subscriber.  Each
+ * message starts with a single byte identifying its type:
+ *
+ *	'B' begin of a transaction
+ *	'C' commit of a transaction
+ *	'R' description of a relation, sent before the first change to it
+ *	'I', 'U', 'D' insert, update and delete of a row
+ *
+ * Rows are sent as a column count followed by, for each column, a kind byte
+ * ('n' for null, 'u' for an unchanged toasted value that is not sent, 't'
+ * for a value in text format, 'b' for a value in binary format) and the
+ * length and data of the value.
+ *
+ * The writer may restrict the columns sent to a subset of the relation's
+ * columns; the relation message then only describes those, and all rows of
+ * the relation are sent with the same columns.  Binary format is only used
+ * when requested, and only for built-in types, whose send and receive
+ * functions are the same on every server; other values are sent as text.
+ *
+ * Copyright (c) 2015, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *		src/backend/replication/logical/proto.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/htup_details.h"
+#include "access/sysattr.h"
+#include "access/transam.h"
+#include "access/tuptoaster.h"
+#include "catalog/pg_namespace.h"
+#include "catalog/pg_type.h"
+#include "libpq/pqformat.h"
+#include "replication/logicalproto.h"
+#include "utils/builtins.h"
+#include "utils/lsyscache.h"
+#include "utils/syscache.h"
+
+/* flags of a column in the relation message */
+#define LOGICALREP_IS_KEY		0x01
+
+static bool logicalrep_column_sent(Form_pg_attribute att,
+					   Bitmapset *columns);
+static void logicalrep_write_tuple(StringInfo out, Relation rel,
+					   HeapTuple tuple, Bitmapset *columns, bool binary);
+static void logicalrep_read_tuple(StringInfo in, LogicalRepTupleData *tuple);
+static void logicalrep_write_timestamp(StringInfo out, TimestampTz ts);
+static TimestampTz logicalrep_read_timestamp(StringInfo in);
+
+/*
+ * Timestamps are sent in the server's native representation.
+ */
+static void
+logicalrep_write_timestamp(StringInfo out, TimestampTz ts)
+{
+#ifdef HAVE_INT64_TIMESTAMP
+	pq_sendint64(out, ts);
+#else
+	pq_sendfloat8(out, ts);
+#endif
+}
+
+static TimestampTz
+logicalrep_read_timestamp(StringInfo in)
+{
+#ifdef HAVE_INT64_TIMESTAMP
+	return pq_getmsgint64(in);
+#else
+	return pq_getmsgfloat8(in);
+#endif
+}
+
+/*
+ * Write BEGIN to the output stream.
+ */
+void
+logicalrep_write_begin(StringInfo out, ReorderBufferTXN *txn)
+{
+	pq_sendbyte(out, 'B');
+
+	pq_sendint64(out, txn->final_lsn);
+	logicalrep_write_timestamp(out, txn->commit_time);
+	pq_sendint(out, txn->xid, 4);
+}
+
+/*
+ * Read BEGIN from the stream.
+ */
+void
+logicalrep_read_begin(StringInfo in, LogicalRepBeginData *begin_data)
+{
+	begin_data->final_lsn = pq_getmsgint64(in);
+	if (begin_data->final_lsn == InvalidXLogRecPtr)
+		elog(ERROR, "final_lsn not set in begin message");
+	begin_data->committime = logicalrep_read_timestamp(in);
+	begin_data->xid = pq_getmsgint(in, 4);
+}
+
+/*
+ * Write COMMIT to the output stream.
+ */
+void
+logicalrep_write_commit(StringInfo out, ReorderBufferTXN *txn,
+						XLogRecPtr commit_lsn)
+{
+	pq_sendbyte(out, 'C');
+
+	pq_sendint64(out, commit_lsn);
+	pq_sendint64(out, txn->end_lsn);
+	logicalrep_write_timestamp(out, txn->commit_time);
+}
+
+/*
+ * Read COMMIT from the stream.
+ */
+void
+logicalrep_read_commit(StringInfo in, LogicalRepCommitData *commit_data)
+{
+	commit_data->commit_lsn = pq_getmsgint64(in);
+	commit_data->end_lsn = pq_getmsgint64(in);
+	commit_data->committime = logicalrep_read_timestamp(in);
+}
+
+/*
+ * Write INSERT to the output stream.
+ */
+void
+logicalrep_write_insert(StringInfo out, Relation rel, HeapTuple newtuple,
+						Bitmapset *columns, bool binary)
+{
+	pq_sendbyte(out, 'I');
+
+	pq_sendint(out, RelationGetRelid(rel), 4);
+
+	pq_sendbyte(out, 'N');		/* new tuple follows */
+	logicalrep_write_tuple(out, rel, newtuple, columns, binary);
+}
+
+/*
+ * Read INSERT from the stream.
+ *
+ * Fills the new tuple and returns the id of the relation.
+ */
+LogicalRepRelId
+logicalrep_read_insert(StringInfo in, LogicalRepTupleData *newtup)
+{
+	char		action;
+	LogicalRepRelId relid;
+
+	relid = pq_getmsgint(in, 4);
+
+	action = pq_getmsgbyte(in);
+	if (action != 'N')
+		elog(ERROR, "expected new tuple but got %d", action);
+
+	logicalrep_read_tuple(in, newtup);
+
+	return relid;
+}
+
+/*
+ * Write UPDATE to the output stream.
+ *
+ * The old tuple is only available if the replica identity key changed or
+ * the relation uses REPLICA IDENTITY FULL; otherwise the subscriber locates
+ * the row by the key columns of the new tuple.
+ */
+void
+logicalrep_write_update(StringInfo out, Relation rel, HeapTuple oldtuple,
+						HeapTuple newtuple, Bitmapset *columns, bool binary)
+{
+	pq_sendbyte(out, 'U');
+
+	pq_sendint(out, RelationGetRelid(rel), 4);
+
+	if (oldtuple != NULL)
+	{
+		if (rel->rd_rel->relreplident == REPLICA_IDENTITY_FULL)
+			pq_sendbyte(out, 'O');	/* old tuple follows */
+		else
+			pq_sendbyte(out, 'K');	/* old key follows */
+		logicalrep_write_tuple(out, rel, oldtuple, columns, binary);
+	}
+
+	pq_sendbyte(out, 'N');		/* new tuple follows */
+	logicalrep_write_tuple(out, rel, newtuple, columns, binary);
+}
+
+/*
+ * Read UPDATE from the stream.
+ */
+LogicalRepRelId
+logicalrep_read_update(StringInfo in, bool *has_oldtuple,
+					   LogicalRepTupleData *oldtup,
+					   LogicalRepTupleData *newtup)
+{
+	char		action;
+	LogicalRepRelId relid;
+
+	relid = pq_getmsgint(in, 4);
+
+	action = pq_getmsgbyte(in);
+	if (action != 'K' && action != 'O' && action != 'N')
+		elog(ERROR, "expected action 'N', 'O' or 'K', got %c", action);
+
+	if (action == 'K' || action == 'O')
+	{
+		logicalrep_read_tuple(in, oldtup);
+		*has_oldtuple = true;
+
+		action = pq_getmsgbyte(in);
+	}
+	else
+		*has_oldtuple = false;
+
+	if (action != 'N')
+		elog(ERROR, "expected action 'N', got %c", action);
+
+	logicalrep_read_tuple(in, newtup);
+
+	return relid;
+}
+
+/*
+ * Write DELETE to the output stream.
+ */
+void
+logicalrep_write_delete(StringInfo out, Relation rel, HeapTuple oldtuple,
+						Bitmapset *columns, bool binary)
+{
+	Assert(rel->rd_rel->relreplident == REPLICA_IDENTITY_DEFAULT ||
+		   rel->rd_rel->relreplident == REPLICA_IDENTITY_FULL ||
+		   rel->rd_rel->relreplident == REPLICA_IDENTITY_INDEX);
+
+	pq_sendbyte(out, 'D');
+
+	pq_sendint(out, RelationGetRelid(rel), 4);
+
+	if (rel->rd_rel->relreplident == REPLICA_IDENTITY_FULL)
+		pq_sendbyte(out, 'O');	/* old tuple follows */
+	else
+		pq_sendbyte(out, 'K');	/* old key follows */
+
+	logicalrep_write_tuple(out, rel, oldtuple, columns, binary);
+}
+
+/*
+ * Read DELETE from the stream.
+ *
+ * Fills the old tuple and returns the id of the relation.
+ */
+LogicalRepRelId
+logicalrep_read_delete(StringInfo in, LogicalRepTupleData *oldtup)
+{
+	char		action;
+	LogicalRepRelId relid;
+
+	relid = pq_getmsgint(in, 4);
+
+	action = pq_getmsgbyte(in);
+	if (action != 'K' && action != 'O')
+		elog(ERROR, "expected action 'O' or 'K', got %c", action);
+
+	logicalrep_read_tuple(in, oldtup);
+
+	return relid;
+}
+
+/*
+ * Is the given column sent?  columns is the set of attribute numbers of the
+ * columns to send, or NULL to send all of them.
+ */
+static bool
+logicalrep_column_sent(Form_pg_attribute att, Bitmapset *columns)
+{
+	if (att->attisdropped)
+		return false;
+
+	return columns == NULL || bms_is_member(att->attnum, columns);
+}
+
+/*
+ * Write the description of a relation to the output stream.
+ */
+void
+logicalrep_write_rel(StringInfo out, Relation rel, Bitmapset *columns)
+{
+	TupleDesc	desc = RelationGetDescr(rel);
+	Bitmapset  *idattrs = NULL;
+	bool		replidentfull;
+	char	   *nspname;
+	int			nliveatts;
+	int			i;
+
+	pq_sendbyte(out, 'R');
+
+	pq_sendint(out, RelationGetRelid(rel), 4);
+
+	nspname = get_namespace_name(RelationGetNamespace(rel));
+	if (nspname == NULL)
+		elog(ERROR, "cache lookup failed for namespace %u",
+			 RelationGetNamespace(rel));
+	pq_sendstring(out, nspname);
+	pq_sendstring(out, RelationGetRelationName(rel));
+
+	pq_sendbyte(out, rel->rd_rel->relreplident);
+
+	replidentfull = (rel->rd_rel->relreplident == REPLICA_IDENTITY_FULL);
+	if (!replidentfull)
+		idattrs = RelationGetIndexAttrBitmap(rel,
+											 INDEX_ATTR_BITMAP_IDENTITY_KEY);
+
+	nliveatts = 0;
+	for (i = 0; i < desc->natts; i++)
+	{
+		if (logicalrep_column_sent(desc->attrs[i], columns))
+			nliveatts++;
+	}
+	pq_sendint(out, nliveatts, 2);
+
+	for (i = 0; i < desc->natts; i++)
+	{
+		Form_pg_attribute att = desc->attrs[i];
+		uint8		flags = 0;
+
+		if (!logicalrep_column_sent(att, columns))
+			continue;
+
+		if (replidentfull ||
+			bms_is_member(att->attnum - FirstLowInvalidHeapAttributeNumber,
+						  idattrs))
+			flags |= LOGICALREP_IS_KEY;
+		pq_sendbyte(out, flags);
+
+		pq_sendstring(out, NameStr(att->attname));
+		pq_sendint(out, (int) att->atttypid, 4);
+	}
+
+	bms_free(idattrs);
+}
+
+/*
+ * Read the description of a relation from the stream.
+ */
+LogicalRepRelation *
+logicalrep_read_rel(StringInfo in)
+{
+	LogicalRepRelation *rel = palloc(sizeof(LogicalRepRelation));
+	int			i;
+
+	rel->remoteid = pq_getmsgint(in, 4);
+	rel->nspname = pstrdup(pq_getmsgstring(in));
+	rel->relname = pstrdup(pq_getmsgstring(in));
+	rel->replident = pq_getmsgbyte(in);
+
+	rel->natts = pq_getmsgint(in, 2);
+	rel->attnames = palloc(rel->natts * sizeof(char *));
+	rel->atttyps = palloc(rel->natts * sizeof(Oid));
+	rel->attkeys = NULL;
+
+	for (i = 0; i < rel->natts; i++)
+	{
+		uint8		flags = pq_getmsgbyte(in);
+
+		if (flags & LOGICALREP_IS_KEY)
+			rel->attkeys = bms_add_member(rel->attkeys, i);
+
+		rel->attnames[i] = pstrdup(pq_getmsgstring(in));
+		rel->atttyps[i] = (Oid) pq_getmsgint(in, 4);
+	}
+
+	return rel;
+}
+
+/*
+ * Write a tuple to the output stream, in text format unless binary is
+ * requested and possible for the column's type.
+ */
+static void
+logicalrep_write_tuple(StringInfo out, Relation rel, HeapTuple tuple,
+					   Bitmapset *columns, bool binary)
+{
+	TupleDesc	desc = RelationGetDescr(rel);
+	Datum	   *values;
+	bool	   *isnull;
+	int			nliveatts;
+	int			i;
+
+	nliveatts = 0;
+	for (i = 0; i < desc->natts; i++)
+	{
+		if (logicalrep_column_sent(desc->attrs[i], columns))
+			nliveatts++;
+	}
+	pq_sendint(out, nliveatts, 2);
+
+	values = (Datum *) palloc(desc->natts * sizeof(Datum));
+	isnull = (bool *) palloc(desc->natts * sizeof(bool));
+	heap_deform_tuple(tuple, desc, values, isnull);
+
+	for (i = 0; i < desc->natts; i++)
+	{
+		Form_pg_attribute att = desc->attrs[i];
+		HeapTuple	typtup;
+		Form_pg_type typclass;
+		Oid			typsend;
+		Oid			typoutput;
+		char	   *outputstr;
+
+		if (!logicalrep_column_sent(att, columns))
+			continue;
+
+		if (isnull[i])
+		{
+			pq_sendbyte(out, 'n');
+			continue;
+		}
+
+		/*
+		 * A toasted value that was not changed by an update is not logged,
+		 * so we cannot send it.  The subscriber keeps its existing value.
+		 */
+		if (att->attlen == -1 && VARATT_IS_EXTERNAL_ONDISK(values[i]))
+		{
+			pq_sendbyte(out, 'u');
+			continue;
+		}
+
+		typtup = SearchSysCache1(TYPEOID, ObjectIdGetDatum(att->atttypid));
+		if (!HeapTupleIsValid(typtup))
+			elog(ERROR, "cache lookup failed for type %u", att->atttypid);
+		typclass = (Form_pg_type) GETSTRUCT(typtup);
+		typsend = typclass->typsend;
+		typoutput = typclass->typoutput;
+		ReleaseSysCache(typtup);
+
+		if (binary && att->atttypid < FirstNormalObjectId &&
+			OidIsValid(typsend))
+		{
+			bytea	   *outputbytes;
+
+			outputbytes = OidSendFunctionCall(typsend, values[i]);
+
+			pq_sendbyte(out, 'b');
+			pq_sendint(out, VARSIZE(outputbytes) - VARHDRSZ, 4);
+			pq_sendbytes(out, VARDATA(outputbytes),
+						 VARSIZE(outputbytes) - VARHDRSZ);
+
+			pfree(outputbytes);
+			continue;
+		}
+
+		outputstr = OidOutputFunctionCall(typoutput, values[i]);
+
+		pq_sendbyte(out, 't');
+		pq_sendcountedtext(out, outputstr, strlen(outputstr), false);
+
+		pfree(outputstr);
+	}
+
+	pfree(values);
+	pfree(isnull);
+}
+
+/*
+ * Read a tuple in text format from the stream.
+ */
+static void
+logicalrep_read_tuple(StringInfo in, LogicalRepTupleData *tuple)
+{
+	int			natts;
+	int			i;
+
+	natts = pq_getmsgint(in, 2);
+
+	tuple->natts = natts;
+	tuple->values = palloc(natts * sizeof(char *));
+	tuple->lengths = palloc0(natts * sizeof(int));
+	tuple->binary = palloc0(natts * sizeof(bool));
+	tuple->changed = palloc(natts * sizeof(bool));
+
+	for (i = 0; i < natts; i++)
+	{
+		char		kind = pq_getmsgbyte(in);
+		int			len;
+
+		switch (kind)
+		{
+			case 'n':			/* null */
+				tuple->values[i] = NULL;
+				tuple->changed[i] = true;
+				break;
+			case 'u':			/* unchanged toasted value */
+				tuple->values[i] = NULL;
+				tuple->changed[i] = false;
+				break;
+			case 't':			/* text formatted value */
+			case 'b':			/* binary formatted value */
+				len = pq_getmsgint(in, 4);
+				tuple->values[i] = palloc(len + 1);
+				pq_copymsgbytes(in, tuple->values[i], len);
+				tuple->values[i][len] = '\0';
+				tuple->lengths[i] = len;
+				tuple->binary[i] = (kind == 'b');
+				tuple->changed[i] = true;
+				break;
+			default:
+				elog(ERROR, "unrecognized data representation type '%c'",
+					 kind);
+		}
+	}
+}
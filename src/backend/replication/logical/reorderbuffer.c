@@ -31,10 +31,13 @@
  *	  smallest current LSN from the heap.
  *
  *	  In order to cope with large transactions - which can be several times as
- *	  big as the available memory - this module supports spooling the contents
- *	  of a large transactions to disk. When the transaction is replayed the
- *	  contents of individual (sub-)transactions will be read from disk in
- *	  chunks.
+ *	  big as the available memory - this module keeps track of the memory used
+ *	  by the changes it buffers.  Once that exceeds logical_decoding_work_mem,
+ *	  the largest toplevel transaction is either streamed to the output plugin
+ *	  ahead of its commit (if the plugin supports that, and the transaction
+ *	  can safely be decoded yet), or its contents are spooled to disk. When a
+ *	  spooled transaction is replayed the contents of individual
+ *	  (sub-)transactions will be read from disk in chunks.
  *
  *	  This module also has to deal with reassembling toast records from the
  *	  individual chunks stored in WAL. When a new (or initial) version of a
@@ -135,17 +138,14 @@ typedef struct ReorderBufferDiskChange
 	/* data follows */
 } ReorderBufferDiskChange;
 
+/* GUC variable: memory budget for buffered changes, in kilobytes */
+int			logical_decoding_work_mem = 65536;
+
 /*
- * Maximum number of changes kept in memory, per transaction. After that,
- * changes are spooled to disk.
- *
- * The current value should be sufficient to decode the entire transaction
- * without hitting disk in OLTP workloads, while starting to spool to disk in
- * other workloads reasonably fast.
- *
- * At some point in the future it probably makes sense to have a more elaborate
- * resource management here, but it's not entirely clear what that would look
- * like.
+ * Maximum number of changes of a (sub-)transaction read back into memory at
+ * once, when replaying a transaction that has been spooled to disk.  Which
+ * transactions get spooled, and when, is governed by
+ * logical_decoding_work_mem instead.
  */
 static const Size max_changes_in_memory = 4096;
 
@@ -173,6 +173,23 @@ static ReorderBufferTXN *ReorderBufferTXNByXid(ReorderBuffer *rb,
 
 static void AssertTXNLsnOrder(ReorderBuffer *rb);
 
+/* ---------------------------------------
+ * memory accounting, and dealing with exceeding logical_decoding_work_mem
+ * ---------------------------------------
+ */
+static Size ReorderBufferChangeSize(ReorderBufferChange *change);
+static void ReorderBufferChangeMemoryUpdate(ReorderBuffer *rb,
+								ReorderBufferChange *change, bool addition);
+static void ReorderBufferCheckMemoryLimit(ReorderBuffer *rb);
+static ReorderBufferTXN *ReorderBufferLargestTXN(ReorderBuffer *rb);
+static bool ReorderBufferCanStream(ReorderBuffer *rb, ReorderBufferTXN *txn);
+static bool ReorderBufferTXNHasStreamed(ReorderBufferTXN *txn);
+static void ReorderBufferStreamTXN(ReorderBuffer *rb, ReorderBufferTXN *txn);
+static void ReorderBufferTruncateTXN(ReorderBuffer *rb, ReorderBufferTXN *txn);
+static void ReorderBufferProcessTXN(ReorderBuffer *rb, ReorderBufferTXN *txn,
+						XLogRecPtr commit_lsn, volatile Snapshot snapshot_now,
+						volatile CommandId command_id, bool streaming);
+
 /* ---------------------------------------
  * support functions for lsn-order iterating over the ->changes of a
  * transaction and its subtransactions
@@ -193,7 +210,6 @@ static void ReorderBufferExecuteInvalidations(ReorderBuffer *rb, ReorderBufferTX
  * Disk serialization support functions
  * ---------------------------------------
  */
-static void ReorderBufferCheckSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn);
 static void ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn);
 static void ReorderBufferSerializeChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
 							 int fd, ReorderBufferChange *change);
@@ -257,6 +273,8 @@ ReorderBufferAllocate(void)
 	buffer->nr_cached_changes = 0;
 	buffer->nr_cached_tuplebufs = 0;
 
+	buffer->size = 0;
+
 	buffer->outbuf = NULL;
 	buffer->outbufsize = 0;
 
@@ -395,6 +413,13 @@ ReorderBufferGetChange(ReorderBuffer *rb)
 void
 ReorderBufferReturnChange(ReorderBuffer *rb, ReorderBufferChange *change)
 {
+	/* update memory accounting info, while the contained data is still there */
+	if (change->txn != NULL)
+	{
+		ReorderBufferChangeMemoryUpdate(rb, change, false);
+		change->txn = NULL;
+	}
+
 	/* free contained data */
 	switch (change->action)
 	{
@@ -591,12 +616,15 @@ ReorderBufferQueueChange(ReorderBuffer *rb, TransactionId xid, XLogRecPtr lsn,
 	txn = ReorderBufferTXNByXid(rb, xid, true, NULL, lsn, true);
 
 	change->lsn = lsn;
+	change->txn = txn;
 	Assert(InvalidXLogRecPtr != lsn);
 	dlist_push_tail(&txn->changes, &change->node);
 	txn->nentries++;
 	txn->nentries_mem++;
 
-	ReorderBufferCheckSerializeTXN(rb, txn);
+	/* account for the memory it uses, and evict something if over budget */
+	ReorderBufferChangeMemoryUpdate(rb, change, true);
+	ReorderBufferCheckMemoryLimit(rb);
 }
 
 static void
@@ -845,8 +873,13 @@ ReorderBufferIterTXNInit(ReorderBuffer *rb, ReorderBufferTXN *txn)
 		ReorderBufferChange *cur_change;
 
 		if (txn->nentries != txn->nentries_mem)
+		{
+			/* restoring frees what's in memory, so spill that first */
+			if (txn->nentries_mem > 0)
+				ReorderBufferSerializeTXN(rb, txn);
 			ReorderBufferRestoreChanges(rb, txn, &state->entries[off].fd,
 										&state->entries[off].segno);
+		}
 
 		cur_change = dlist_head_element(ReorderBufferChange, node,
 										&txn->changes);
@@ -869,10 +902,14 @@ ReorderBufferIterTXNInit(ReorderBuffer *rb, ReorderBufferTXN *txn)
 		{
 			ReorderBufferChange *cur_change;
 
-			if (txn->nentries != txn->nentries_mem)
+			if (cur_txn->nentries != cur_txn->nentries_mem)
+			{
+				if (cur_txn->nentries_mem > 0)
+					ReorderBufferSerializeTXN(rb, cur_txn);
 				ReorderBufferRestoreChanges(rb, cur_txn,
 											&state->entries[off].fd,
 											&state->entries[off].segno);
+			}
 
 			cur_change = dlist_head_element(ReorderBufferChange, node,
 											&cur_txn->changes);
@@ -1020,6 +1057,12 @@ ReorderBufferCleanupTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 	bool		found;
 	dlist_mutable_iter iter;
 
+	/*
+	 * Leftover toast chunks, e.g. of a streamed transaction that aborted.
+	 * They might belong to subtransactions, so do this first.
+	 */
+	ReorderBufferToastReset(rb, txn);
+
 	/* cleanup subtransactions & their changes */
 	dlist_foreach_modify(iter, &txn->subtxns)
 	{
@@ -1068,6 +1111,13 @@ ReorderBufferCleanupTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 		txn->base_snapshot_lsn = InvalidXLogRecPtr;
 	}
 
+	/* state left behind by streaming parts of the transaction */
+	if (txn->snapshot_now != NULL)
+	{
+		ReorderBufferFreeSnap(rb, txn->snapshot_now);
+		txn->snapshot_now = NULL;
+	}
+
 	/* delete from list of known subxacts */
 	if (txn->is_known_as_subxact)
 	{
@@ -1242,61 +1292,32 @@ ReorderBufferFreeSnap(ReorderBuffer *rb, Snapshot snap)
 }
 
 /*
- * Perform the replay of a transaction and it's non-aborted subtransactions.
+ * Replay the changes of a transaction and its non-aborted subtransactions
+ * that are currently in the reorder buffer, in lsn order, passing them to the
+ * output plugin.
  *
- * Subtransactions previously have to be processed by
- * ReorderBufferCommitChild(), even if previously assigned to the toplevel
- * transaction with ReorderBufferAssignChild.
+ * This is used both when the commit of a transaction is decoded, and to
+ * stream a chunk of a still running transaction (streaming = true) when the
+ * reorder buffer exceeds logical_decoding_work_mem.  A committing transaction
+ * some of whose changes have been streamed before is finished by streaming
+ * its remaining changes and calling the stream_commit callback, instead of
+ * the usual begin/change/commit sequence.
  *
- * We currently can only decode a transaction's contents in when their commit
- * record is read because that's currently the only place where we know about
- * cache invalidations. Thus, once a toplevel commit is read, we iterate over
- * the top and subtransactions (using a k-way merge) and replay the changes in
- * lsn order.
+ * When streaming, the changes passed on are released afterwards, but the
+ * transaction itself is kept, remembering the snapshot and command id to
+ * continue with.
  */
-void
-ReorderBufferCommit(ReorderBuffer *rb, TransactionId xid,
-					XLogRecPtr commit_lsn, XLogRecPtr end_lsn,
-					TimestampTz commit_time,
-					RepOriginId origin_id, XLogRecPtr origin_lsn)
+static void
+ReorderBufferProcessTXN(ReorderBuffer *rb, ReorderBufferTXN *txn,
+						XLogRecPtr commit_lsn, volatile Snapshot snapshot_now,
+						volatile CommandId command_id, bool streaming)
 {
-	ReorderBufferTXN *txn;
-	volatile Snapshot snapshot_now;
-	volatile CommandId command_id = FirstCommandId;
 	bool		using_subtxn;
+	bool		stream_mode;
 	ReorderBufferIterTXNState *volatile iterstate = NULL;
 
-	txn = ReorderBufferTXNByXid(rb, xid, false, NULL, InvalidXLogRecPtr,
-								false);
-
-	/* unknown transaction, nothing to replay */
-	if (txn == NULL)
-		return;
-
-	txn->final_lsn = commit_lsn;
-	txn->end_lsn = end_lsn;
-	txn->commit_time = commit_time;
-	txn->origin_id = origin_id;
-	txn->origin_lsn = origin_lsn;
-
-	/* serialize the last bunch of changes if we need start earlier anyway */
-	if (txn->nentries_mem != txn->nentries)
-		ReorderBufferSerializeTXN(rb, txn);
-
-	/*
-	 * If this transaction didn't have any real changes in our database, it's
-	 * OK not to have a snapshot. Note that ReorderBufferCommitChild will have
-	 * transferred its snapshot to this transaction if it had one and the
-	 * toplevel tx didn't.
-	 */
-	if (txn->base_snapshot == NULL)
-	{
-		Assert(txn->ninvalidations == 0);
-		ReorderBufferCleanupTXN(rb, txn);
-		return;
-	}
-
-	snapshot_now = txn->base_snapshot;
+	/* are we sending this transaction as part of a stream? */
+	stream_mode = streaming || ReorderBufferTXNHasStreamed(txn);
 
 	/* build data to be able to lookup the CommandIds of catalog tuples */
 	ReorderBufferBuildTupleCidHash(rb, txn);
@@ -1322,11 +1343,14 @@ ReorderBufferCommit(ReorderBuffer *rb, TransactionId xid,
 		ReorderBufferChange *specinsert = NULL;
 
 		if (using_subtxn)
-			BeginInternalSubTransaction("replay");
+			BeginInternalSubTransaction(streaming ? "stream" : "replay");
 		else
 			StartTransactionCommand();
 
-		rb->begin(rb, txn);
+		if (stream_mode)
+			rb->stream_start(rb, txn);
+		else
+			rb->begin(rb, txn);
 
 		iterstate = ReorderBufferIterTXNInit(rb, txn);
 		while ((change = ReorderBufferIterTXNNext(rb, iterstate)) != NULL)
@@ -1393,7 +1417,10 @@ ReorderBufferCommit(ReorderBuffer *rb, TransactionId xid,
 					if (!IsToastRelation(relation))
 					{
 						ReorderBufferToastReplace(rb, txn, relation, change);
-						rb->apply_change(rb, txn, relation, change);
+						if (stream_mode)
+							rb->stream_change(rb, txn, relation, change);
+						else
+							rb->apply_change(rb, txn, relation, change);
 
 						/*
 						 * Only clear reassembled toast chunks if we're sure
@@ -1412,7 +1439,9 @@ ReorderBufferCommit(ReorderBuffer *rb, TransactionId xid,
 						 * we're done remove it from the list of this
 						 * transaction's changes. Otherwise it will get
 						 * freed/reused while restoring spooled data from
-						 * disk.
+						 * disk.  When streaming, the chunks stay in the
+						 * toast hash until the tuple owning them arrives,
+						 * possibly in a later chunk of the stream.
 						 */
 						dlist_delete(&change->node);
 						ReorderBufferToastAppendChunk(rb, txn, relation,
@@ -1534,11 +1563,12 @@ ReorderBufferCommit(ReorderBuffer *rb, TransactionId xid,
 		}
 
 		/*
-		 * There's a speculative insertion remaining, just clean in up, it
-		 * can't have been successful, otherwise we'd gotten a confirmation
-		 * record.
+		 * There's a speculative insertion remaining.  At commit, just clean
+		 * it up, it can't have been successful, otherwise we'd gotten a
+		 * confirmation record.  When streaming, the confirmation may simply
+		 * not have been decoded yet, so it's kept for the next chunk below.
 		 */
-		if (specinsert)
+		if (specinsert && !streaming)
 		{
 			ReorderBufferReturnChange(rb, specinsert);
 			specinsert = NULL;
@@ -1548,8 +1578,16 @@ ReorderBufferCommit(ReorderBuffer *rb, TransactionId xid,
 		ReorderBufferIterTXNFinish(rb, iterstate);
 		iterstate = NULL;
 
-		/* call commit callback */
-		rb->commit(rb, txn, commit_lsn);
+		/* call commit or stream callbacks */
+		if (streaming)
+			rb->stream_stop(rb, txn);
+		else if (stream_mode)
+		{
+			rb->stream_stop(rb, txn);
+			rb->stream_commit(rb, txn, commit_lsn);
+		}
+		else
+			rb->commit(rb, txn, commit_lsn);
 
 		/* this is just a sanity check against bad output plugin behaviour */
 		if (GetCurrentTransactionIdIfAny() != InvalidTransactionId)
@@ -1573,11 +1611,38 @@ ReorderBufferCommit(ReorderBuffer *rb, TransactionId xid,
 		if (using_subtxn)
 			RollbackAndReleaseCurrentSubTransaction();
 
-		if (snapshot_now->copied)
-			ReorderBufferFreeSnap(rb, snapshot_now);
+		if (streaming)
+		{
+			/*
+			 * Remember where we are for the next chunk.  The snapshot might
+			 * belong to a change we're about to release, so make our own copy.
+			 */
+			if (!snapshot_now->copied)
+				snapshot_now = ReorderBufferCopySnap(rb, snapshot_now,
+													 txn, command_id);
+			txn->snapshot_now = snapshot_now;
+			txn->command_id = command_id;
 
-		/* remove potential on-disk data, and deallocate */
-		ReorderBufferCleanupTXN(rb, txn);
+			/* release the streamed changes, and put back a pending one */
+			ReorderBufferTruncateTXN(rb, txn);
+
+			if (specinsert != NULL)
+			{
+				ReorderBufferTXN *owner = specinsert->txn;
+
+				dlist_push_tail(&owner->changes, &specinsert->node);
+				owner->nentries++;
+				owner->nentries_mem++;
+			}
+		}
+		else
+		{
+			if (snapshot_now->copied)
+				ReorderBufferFreeSnap(rb, snapshot_now);
+
+			/* remove potential on-disk data, and deallocate */
+			ReorderBufferCleanupTXN(rb, txn);
+		}
 	}
 	PG_CATCH();
 	{
@@ -1602,14 +1667,86 @@ ReorderBufferCommit(ReorderBuffer *rb, TransactionId xid,
 		if (snapshot_now->copied)
 			ReorderBufferFreeSnap(rb, snapshot_now);
 
-		/* remove potential on-disk data, and deallocate */
-		ReorderBufferCleanupTXN(rb, txn);
+		/*
+		 * Remove potential on-disk data, and deallocate.  A transaction that
+		 * was being streamed is left alone, it's still in progress.
+		 */
+		if (!streaming)
+			ReorderBufferCleanupTXN(rb, txn);
 
 		PG_RE_THROW();
 	}
 	PG_END_TRY();
 }
 
+/*
+ * Perform the replay of a transaction and it's non-aborted subtransactions.
+ *
+ * Subtransactions previously have to be processed by
+ * ReorderBufferCommitChild(), even if previously assigned to the toplevel
+ * transaction with ReorderBufferAssignChild.
+ *
+ * We currently can only decode a transaction's contents in when their commit
+ * record is read because that's currently the only place where we know about
+ * cache invalidations. Thus, once a toplevel commit is read, we iterate over
+ * the top and subtransactions (using a k-way merge) and replay the changes in
+ * lsn order.  (Large transactions without catalog changes may have been
+ * streamed in part before, see ReorderBufferStreamTXN.)
+ */
+void
+ReorderBufferCommit(ReorderBuffer *rb, TransactionId xid,
+					XLogRecPtr commit_lsn, XLogRecPtr end_lsn,
+					TimestampTz commit_time,
+					RepOriginId origin_id, XLogRecPtr origin_lsn)
+{
+	ReorderBufferTXN *txn;
+	Snapshot	snapshot_now;
+	CommandId	command_id = FirstCommandId;
+
+	txn = ReorderBufferTXNByXid(rb, xid, false, NULL, InvalidXLogRecPtr,
+								false);
+
+	/* unknown transaction, nothing to replay */
+	if (txn == NULL)
+		return;
+
+	txn->final_lsn = commit_lsn;
+	txn->end_lsn = end_lsn;
+	txn->commit_time = commit_time;
+	txn->origin_id = origin_id;
+	txn->origin_lsn = origin_lsn;
+
+	/* serialize the last bunch of changes if we need start earlier anyway */
+	if (txn->nentries_mem != txn->nentries)
+		ReorderBufferSerializeTXN(rb, txn);
+
+	/*
+	 * If this transaction didn't have any real changes in our database, it's
+	 * OK not to have a snapshot. Note that ReorderBufferCommitChild will have
+	 * transferred its snapshot to this transaction if it had one and the
+	 * toplevel tx didn't.
+	 */
+	if (txn->base_snapshot == NULL)
+	{
+		Assert(txn->ninvalidations == 0);
+		ReorderBufferCleanupTXN(rb, txn);
+		return;
+	}
+
+	/* continue where the last streamed chunk left off, if any */
+	if (txn->snapshot_now != NULL)
+	{
+		snapshot_now = txn->snapshot_now;
+		command_id = txn->command_id;
+		txn->snapshot_now = NULL;
+	}
+	else
+		snapshot_now = txn->base_snapshot;
+
+	ReorderBufferProcessTXN(rb, txn, commit_lsn, snapshot_now, command_id,
+							false);
+}
+
 /*
  * Abort a transaction that possibly has previous changes. Needs to be first
  * called for subtransactions and then for the toplevel xid.
@@ -1637,6 +1774,10 @@ ReorderBufferAbort(ReorderBuffer *rb, TransactionId xid, XLogRecPtr lsn)
 	/* cosmetic... */
 	txn->final_lsn = lsn;
 
+	/* tell the output plugin to discard what it has been streamed */
+	if (ReorderBufferTXNHasStreamed(txn))
+		rb->stream_abort(rb, txn, lsn);
+
 	/* remove potential on-disk data, and deallocate */
 	ReorderBufferCleanupTXN(rb, txn);
 }
@@ -1670,6 +1811,9 @@ ReorderBufferAbortOld(ReorderBuffer *rb, TransactionId oldestRunningXid)
 		{
 			elog(DEBUG1, "aborting old transaction %u", txn->xid);
 
+			if (ReorderBufferTXNHasStreamed(txn))
+				rb->stream_abort(rb, txn, InvalidXLogRecPtr);
+
 			/* remove potential on-disk data, and deallocate this tx */
 			ReorderBufferCleanupTXN(rb, txn);
 		}
@@ -1706,6 +1850,10 @@ ReorderBufferForget(ReorderBuffer *rb, TransactionId xid, XLogRecPtr lsn)
 	/* cosmetic... */
 	txn->final_lsn = lsn;
 
+	/* parts of it might have been streamed before we knew to skip it */
+	if (ReorderBufferTXNHasStreamed(txn))
+		rb->stream_abort(rb, txn, lsn);
+
 	/*
 	 * Process cache invalidation messages if there are any. Even if we're not
 	 * interested in the transaction's contents, it could have manipulated the
@@ -1934,42 +2082,306 @@ ReorderBufferXidHasBaseSnapshot(ReorderBuffer *rb, TransactionId xid)
 
 /*
  * ---------------------------------------
- * Disk serialization support
+ * Memory accounting and enforcement of logical_decoding_work_mem
  * ---------------------------------------
  */
 
 /*
- * Ensure the IO buffer is >= sz.
+ * Amount of memory used by a queued change, including the data hanging off
+ * it.  Tuple buffers are always allocated with the maximum size.
+ */
+static Size
+ReorderBufferChangeSize(ReorderBufferChange *change)
+{
+	Size		sz = sizeof(ReorderBufferChange);
+
+	switch (change->action)
+	{
+		case REORDER_BUFFER_CHANGE_INSERT:
+		case REORDER_BUFFER_CHANGE_UPDATE:
+		case REORDER_BUFFER_CHANGE_DELETE:
+		case REORDER_BUFFER_CHANGE_INTERNAL_SPEC_INSERT:
+			if (change->data.tp.oldtuple)
+				sz += sizeof(ReorderBufferTupleBuf);
+			if (change->data.tp.newtuple)
+				sz += sizeof(ReorderBufferTupleBuf);
+			break;
+		case REORDER_BUFFER_CHANGE_INTERNAL_SNAPSHOT:
+			{
+				Snapshot	snap = change->data.snapshot;
+
+				sz += sizeof(SnapshotData) +
+					sizeof(TransactionId) * (snap->xcnt + snap->subxcnt);
+				break;
+			}
+			/* no data in addition to the struct itself */
+		case REORDER_BUFFER_CHANGE_INTERNAL_SPEC_CONFIRM:
+		case REORDER_BUFFER_CHANGE_INTERNAL_COMMAND_ID:
+		case REORDER_BUFFER_CHANGE_INTERNAL_TUPLECID:
+			break;
+	}
+
+	return sz;
+}
+
+/*
+ * Add or subtract the size of a change to the counters of the transaction it
+ * belongs to, and of the whole reorder buffer.
  */
 static void
-ReorderBufferSerializeReserve(ReorderBuffer *rb, Size sz)
+ReorderBufferChangeMemoryUpdate(ReorderBuffer *rb,
+								ReorderBufferChange *change, bool addition)
 {
-	if (!rb->outbufsize)
+	Size		sz = ReorderBufferChangeSize(change);
+	ReorderBufferTXN *txn = change->txn;
+
+	Assert(txn != NULL);
+
+	if (addition)
 	{
-		rb->outbuf = MemoryContextAlloc(rb->context, sz);
-		rb->outbufsize = sz;
+		txn->size += sz;
+		rb->size += sz;
 	}
-	else if (rb->outbufsize < sz)
+	else
 	{
-		rb->outbuf = repalloc(rb->outbuf, sz);
-		rb->outbufsize = sz;
+		Assert(txn->size >= sz && rb->size >= sz);
+		txn->size -= sz;
+		rb->size -= sz;
+	}
+}
+
+/*
+ * Find the toplevel transaction using the most memory, counting its known
+ * subtransactions.  Returns NULL if no transaction has changes in memory.
+ */
+static ReorderBufferTXN *
+ReorderBufferLargestTXN(ReorderBuffer *rb)
+{
+	ReorderBufferTXN *largest = NULL;
+	Size		largest_size = 0;
+	dlist_iter	iter;
+
+	dlist_foreach(iter, &rb->toplevel_by_lsn)
+	{
+		ReorderBufferTXN *txn;
+		Size		size;
+		dlist_iter	subtxn_i;
+
+		txn = dlist_container(ReorderBufferTXN, node, iter.cur);
+		size = txn->size;
+
+		dlist_foreach(subtxn_i, &txn->subtxns)
+		{
+			ReorderBufferTXN *subtxn;
+
+			subtxn = dlist_container(ReorderBufferTXN, node, subtxn_i.cur);
+			size += subtxn->size;
+		}
+
+		if (size > largest_size)
+		{
+			largest = txn;
+			largest_size = size;
+		}
+	}
+
+	return largest;
+}
+
+/*
+ * Has the transaction, or one of its subtransactions, been streamed to the
+ * output plugin in part already?
+ */
+static bool
+ReorderBufferTXNHasStreamed(ReorderBufferTXN *txn)
+{
+	dlist_iter	iter;
+
+	if (txn->is_streamed)
+		return true;
+
+	dlist_foreach(iter, &txn->subtxns)
+	{
+		ReorderBufferTXN *subtxn;
+
+		subtxn = dlist_container(ReorderBufferTXN, node, iter.cur);
+		if (subtxn->is_streamed)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Can the changes of the still running transaction txn be passed to the
+ * output plugin right now?
+ *
+ * Apart from the output plugin having to support it, we need to be able to
+ * decode the changes correctly without having seen the transaction's commit
+ * record.  Cache invalidations are only logged at commit, so that's only the
+ * case as long as no transaction in progress has modified the catalog.
+ */
+static bool
+ReorderBufferCanStream(ReorderBuffer *rb, ReorderBufferTXN *txn)
+{
+	LogicalDecodingContext *ctx = rb->private_data;
+	dlist_iter	iter;
+
+	if (!ctx->streaming)
+		return false;
+
+	/* nothing may be sent before we reached a consistent point */
+	if (SnapBuildCurrentState(ctx->snapshot_builder) != SNAPBUILD_CONSISTENT ||
+		SnapBuildXactNeedsSkip(ctx->snapshot_builder, txn->first_lsn))
+		return false;
+
+	if (txn->base_snapshot == NULL && txn->snapshot_now == NULL)
+		return false;
+
+	dlist_foreach(iter, &rb->toplevel_by_lsn)
+	{
+		ReorderBufferTXN *cur_txn;
+		dlist_iter	subtxn_i;
+
+		cur_txn = dlist_container(ReorderBufferTXN, node, iter.cur);
+
+		if (cur_txn->has_catalog_changes ||
+			!dlist_is_empty(&cur_txn->tuplecids))
+			return false;
+
+		dlist_foreach(subtxn_i, &cur_txn->subtxns)
+		{
+			ReorderBufferTXN *subtxn;
+
+			subtxn = dlist_container(ReorderBufferTXN, node, subtxn_i.cur);
+			if (subtxn->has_catalog_changes)
+				return false;
+		}
 	}
+
+	return true;
 }
 
 /*
- * Check whether the transaction tx should spill its data to disk.
+ * Pass all changes of the still running transaction txn (and its known
+ * subtransactions) buffered so far on to the output plugin, and release them.
  */
 static void
-ReorderBufferCheckSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
+ReorderBufferStreamTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 {
+	Snapshot	snapshot_now;
+	CommandId	command_id = FirstCommandId;
+
+	/* continue where the last chunk left off, if there was one */
+	if (txn->snapshot_now != NULL)
+	{
+		snapshot_now = txn->snapshot_now;
+		command_id = txn->command_id;
+		txn->snapshot_now = NULL;
+	}
+	else
+		snapshot_now = txn->base_snapshot;
+
+	ReorderBufferProcessTXN(rb, txn, InvalidXLogRecPtr, snapshot_now,
+							command_id, true);
+}
+
+/*
+ * Release the changes of a transaction (and its subtransactions) that have
+ * just been streamed, both in memory and on disk, keeping the transactions
+ * themselves around.
+ */
+static void
+ReorderBufferTruncateTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
+{
+	dlist_iter	subtxn_i;
+	dlist_mutable_iter iter;
+
+	dlist_foreach(subtxn_i, &txn->subtxns)
+	{
+		ReorderBufferTXN *subtxn;
+
+		subtxn = dlist_container(ReorderBufferTXN, node, subtxn_i.cur);
+
+		if (subtxn->nentries > 0)
+			subtxn->is_streamed = true;
+
+		ReorderBufferTruncateTXN(rb, subtxn);
+	}
+
+	dlist_foreach_modify(iter, &txn->changes)
+	{
+		ReorderBufferChange *change;
+
+		change = dlist_container(ReorderBufferChange, node, iter.cur);
+		dlist_delete(&change->node);
+		ReorderBufferReturnChange(rb, change);
+	}
+
 	/*
-	 * TODO: improve accounting so we cheaply can take subtransactions into
-	 * account here.
+	 * Even if all spilled changes fit into memory again, the files are still
+	 * there, and new ones would be appended to them.  Spilling sets final_lsn
+	 * of a running transaction, so that tells us whether to look.
 	 */
-	if (txn->nentries_mem >= max_changes_in_memory)
+	if (txn->final_lsn != InvalidXLogRecPtr)
+		ReorderBufferRestoreCleanup(rb, txn);
+
+	txn->nentries = 0;
+	txn->nentries_mem = 0;
+
+	if (!txn->is_known_as_subxact)
+		txn->is_streamed = true;
+}
+
+/*
+ * Make sure the changes buffered in memory stay within
+ * logical_decoding_work_mem, by streaming or spilling to disk the largest
+ * transaction(s).
+ */
+static void
+ReorderBufferCheckMemoryLimit(ReorderBuffer *rb)
+{
+	while (rb->size >= logical_decoding_work_mem * 1024L)
 	{
-		ReorderBufferSerializeTXN(rb, txn);
-		Assert(txn->nentries_mem == 0);
+		ReorderBufferTXN *txn = ReorderBufferLargestTXN(rb);
+		Size		before = rb->size;
+
+		/* everything left is in use by changes currently being decoded */
+		if (txn == NULL)
+			break;
+
+		if (ReorderBufferCanStream(rb, txn))
+			ReorderBufferStreamTXN(rb, txn);
+		else
+			ReorderBufferSerializeTXN(rb, txn);
+
+		if (rb->size >= before)
+			break;
+	}
+}
+
+
+/*
+ * ---------------------------------------
+ * Disk serialization support
+ * ---------------------------------------
+ */
+
+/*
+ * Ensure the IO buffer is >= sz.
+ */
+static void
+ReorderBufferSerializeReserve(ReorderBuffer *rb, Size sz)
+{
+	if (!rb->outbufsize)
+	{
+		rb->outbuf = MemoryContextAlloc(rb->context, sz);
+		rb->outbufsize = sz;
+	}
+	else if (rb->outbufsize < sz)
+	{
+		rb->outbuf = repalloc(rb->outbuf, sz);
+		rb->outbufsize = sz;
 	}
 }
 
@@ -2041,6 +2453,14 @@ ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 
 		ReorderBufferSerializeChange(rb, txn, fd, change);
 		dlist_delete(&change->node);
+
+		/*
+		 * Remember how far the on-disk data goes, so a transaction that's
+		 * still in progress can be restored and cleaned up as well.
+		 */
+		if (change->lsn > txn->final_lsn)
+			txn->final_lsn = change->lsn;
+
 		ReorderBufferReturnChange(rb, change);
 
 		spilled++;
@@ -2384,8 +2804,13 @@ ReorderBufferRestoreChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
 			break;
 	}
 
+	/* the on-disk copy points to whatever the transaction was back then */
+	change->txn = txn;
+
 	dlist_push_tail(&txn->changes, &change->node);
 	txn->nentries_mem++;
+
+	ReorderBufferChangeMemoryUpdate(rb, change, true);
 }
 
 /*
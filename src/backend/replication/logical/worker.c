@@ -0,0 +1,1469 @@
+/*-------------------------------------------------------------------------
+ * worker.c
+ *	   PostgreSQL logical replication apply worker
+ *
+ * Copyright (c) 2015, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  src/backend/replication/logical/worker.c
+ *
+ * NOTES
+ *	  An apply worker is started by the launcher (see launcher.c) for each
+ *	  enabled subscription.  It connects to the publisher using the walsender
+ *	  protocol, starts logical decoding on the subscription's slot using the
+ *	  pgoutput plugin, and applies the changes it receives to the local
+ *	  tables.
+ *
+ *	  Each remote transaction is applied in one local transaction.  The
+ *	  subscription's replication origin is advanced at commit, so after a
+ *	  restart streaming resumes right after the last transaction applied.
+ *	  Because local commits are asynchronous, the position reported back to
+ *	  the publisher as flushed is only advanced once the local commit record
+ *	  has been flushed to disk.
+ *
+ *	  Target tables are looked up by schema-qualified name, and columns are
+ *	  matched by name; the local table may have additional columns, which
+ *	  get their default values.  Values are converted with the input
+ *	  functions of the local column types, or with their receive functions
+ *	  for values the publisher sent in binary format.  Rows to update or
+ *	  delete are found using the local replica identity index if the
+ *	  publisher sent values for all of its columns, and by a sequential scan
+ *	  comparing the replica identity columns sent otherwise.
+ *
+ *	  Triggers and rules on the target tables are not fired.
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/genam.h"
+#include "access/heapam.h"
+#include "access/htup_details.h"
+#include "access/nbtree.h"
+#include "access/xact.h"
+#include "access/xlog.h"
+#include "catalog/namespace.h"
+#include "catalog/pg_subscription.h"
+#include "executor/executor.h"
+#include "libpq/pqformat.h"
+#include "miscadmin.h"
+#include "nodes/makefuncs.h"
+#include "optimizer/planner.h"
+#include "pgstat.h"
+#include "postmaster/bgworker.h"
+#include "replication/logicallauncher.h"
+#include "replication/logicalproto.h"
+#include "replication/origin.h"
+#include "replication/walreceiver.h"
+#include "rewrite/rewriteHandler.h"
+#include "storage/ipc.h"
+#include "storage/lmgr.h"
+#include "storage/pmsignal.h"
+#include "tcop/tcopprot.h"
+#include "utils/builtins.h"
+#include "utils/fmgroids.h"
+#include "utils/guc.h"
+#include "utils/inval.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/snapmgr.h"
+#include "utils/syscache.h"
+#include "utils/timestamp.h"
+#include "utils/tqual.h"
+#include "utils/typcache.h"
+
+#define NAPTIME_PER_CYCLE 100	/* max sleep time between cycles (100ms) */
+
+/*
+ * Remote transactions whose local commit has not been flushed yet.  The
+ * publisher is told that a remote transaction has been flushed once the
+ * local WAL up to local_end is on disk.
+ */
+typedef struct FlushPosition
+{
+	dlist_node	node;
+	XLogRecPtr	local_end;
+	XLogRecPtr	remote_end;
+} FlushPosition;
+
+static dlist_head lsn_mapping = DLIST_STATIC_INIT(lsn_mapping);
+
+/*
+ * Mapping of a relation sent by the publisher to the local relation.
+ */
+typedef struct LogicalRepRelMapEntry
+{
+	LogicalRepRelId remoteid;	/* remote relation id, hash key */
+	LogicalRepRelation *remoterel;		/* as sent by the publisher */
+	Oid			localreloid;	/* local relation, or InvalidOid if the
+								 * mapping needs to be rebuilt */
+	int		   *attrmap;		/* local attribute index of each remote
+								 * column */
+	int		   *localattrmap;	/* remote column index of each local
+								 * attribute, or -1 */
+	int			nlocalatts;		/* length of localattrmap */
+} LogicalRepRelMapEntry;
+
+static HTAB *LogicalRepRelMap = NULL;
+
+/* Errcontext information for converting remote values */
+typedef struct SlotErrCallbackArg
+{
+	LogicalRepRelMapEntry *entry;
+	int			remote_attnum;
+} SlotErrCallbackArg;
+
+static MemoryContext ApplyContext = NULL;
+static MemoryContext ApplyMessageContext = NULL;
+
+static Subscription *MySubscription = NULL;
+
+static bool in_remote_transaction = false;
+static XLogRecPtr remote_final_lsn = InvalidXLogRecPtr;
+
+static volatile sig_atomic_t got_SIGHUP = false;
+
+static void logicalrep_worker_sighup(SIGNAL_ARGS);
+static void send_feedback(XLogRecPtr recvpos, bool force, bool requestReply);
+static void store_flush_position(XLogRecPtr remote_lsn);
+
+
+/* SIGHUP: set flag to reload configuration at next convenient time */
+static void
+logicalrep_worker_sighup(SIGNAL_ARGS)
+{
+	int			save_errno = errno;
+
+	got_SIGHUP = true;
+	SetLatch(MyLatch);
+
+	errno = save_errno;
+}
+
+/*
+ * Relcache invalidation callback: forget the local side of the mapping of
+ * the affected relation, so that it is looked up again on next use.
+ */
+static void
+logicalrep_relmap_invalidate_cb(Datum arg, Oid reloid)
+{
+	HASH_SEQ_STATUS status;
+	LogicalRepRelMapEntry *entry;
+
+	if (LogicalRepRelMap == NULL)
+		return;
+
+	hash_seq_init(&status, LogicalRepRelMap);
+	while ((entry = (LogicalRepRelMapEntry *) hash_seq_search(&status)) != NULL)
+	{
+		if (reloid == InvalidOid || entry->localreloid == reloid)
+			entry->localreloid = InvalidOid;
+	}
+}
+
+/*
+ * Remember the description of a relation sent by the publisher.
+ */
+static void
+logicalrep_relmap_update(LogicalRepRelation *remoterel)
+{
+	LogicalRepRelMapEntry *entry;
+	MemoryContext oldctx;
+	bool		found;
+	int			i;
+
+	if (LogicalRepRelMap == NULL)
+	{
+		HASHCTL		ctl;
+
+		MemSet(&ctl, 0, sizeof(ctl));
+		ctl.keysize = sizeof(LogicalRepRelId);
+		ctl.entrysize = sizeof(LogicalRepRelMapEntry);
+		ctl.hcxt = ApplyContext;
+
+		LogicalRepRelMap = hash_create("logical replication relation map",
+									   128, &ctl,
+									   HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	}
+
+	entry = hash_search(LogicalRepRelMap, &remoterel->remoteid,
+						HASH_ENTER, &found);
+
+	if (found)
+	{
+		LogicalRepRelation *old = entry->remoterel;
+
+		pfree(old->nspname);
+		pfree(old->relname);
+		for (i = 0; i < old->natts; i++)
+			pfree(old->attnames[i]);
+		pfree(old->attnames);
+		pfree(old->atttyps);
+		bms_free(old->attkeys);
+		pfree(old);
+		if (entry->attrmap)
+			pfree(entry->attrmap);
+		if (entry->localattrmap)
+			pfree(entry->localattrmap);
+	}
+
+	/* Make a long-lived copy of the remote description. */
+	oldctx = MemoryContextSwitchTo(ApplyContext);
+	entry->remoterel = palloc(sizeof(LogicalRepRelation));
+	entry->remoterel->remoteid = remoterel->remoteid;
+	entry->remoterel->nspname = pstrdup(remoterel->nspname);
+	entry->remoterel->relname = pstrdup(remoterel->relname);
+	entry->remoterel->replident = remoterel->replident;
+	entry->remoterel->natts = remoterel->natts;
+	entry->remoterel->attnames = palloc(remoterel->natts * sizeof(char *));
+	entry->remoterel->atttyps = palloc(remoterel->natts * sizeof(Oid));
+	for (i = 0; i < remoterel->natts; i++)
+	{
+		entry->remoterel->attnames[i] = pstrdup(remoterel->attnames[i]);
+		entry->remoterel->atttyps[i] = remoterel->atttyps[i];
+	}
+	entry->remoterel->attkeys = bms_copy(remoterel->attkeys);
+	MemoryContextSwitchTo(oldctx);
+
+	entry->localreloid = InvalidOid;
+	entry->attrmap = NULL;
+	entry->localattrmap = NULL;
+	entry->nlocalatts = 0;
+}
+
+/*
+ * Build the column mapping between the remote and the given local relation.
+ */
+static void
+logicalrep_relmap_build_attrmap(LogicalRepRelMapEntry *entry, Relation rel)
+{
+	LogicalRepRelation *remoterel = entry->remoterel;
+	TupleDesc	desc = RelationGetDescr(rel);
+	MemoryContext oldctx;
+	int			i;
+
+	if (entry->attrmap)
+		pfree(entry->attrmap);
+	if (entry->localattrmap)
+		pfree(entry->localattrmap);
+
+	oldctx = MemoryContextSwitchTo(ApplyContext);
+	entry->attrmap = palloc(Max(remoterel->natts, 1) * sizeof(int));
+	entry->localattrmap = palloc(Max(desc->natts, 1) * sizeof(int));
+	entry->nlocalatts = desc->natts;
+	MemoryContextSwitchTo(oldctx);
+
+	for (i = 0; i < desc->natts; i++)
+		entry->localattrmap[i] = -1;
+
+	for (i = 0; i < remoterel->natts; i++)
+	{
+		int			j;
+
+		entry->attrmap[i] = -1;
+		for (j = 0; j < desc->natts; j++)
+		{
+			Form_pg_attribute att = desc->attrs[j];
+
+			if (att->attisdropped)
+				continue;
+
+			if (strcmp(NameStr(att->attname), remoterel->attnames[i]) == 0)
+			{
+				entry->attrmap[i] = j;
+				entry->localattrmap[j] = i;
+				break;
+			}
+		}
+
+		if (entry->attrmap[i] < 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+					 errmsg("logical replication target relation \"%s.%s\" is missing replicated column \"%s\"",
+							remoterel->nspname, remoterel->relname,
+							remoterel->attnames[i])));
+	}
+}
+
+/*
+ * Open the local relation the given remote relation maps to.
+ *
+ * The mapping is (re)built if it was invalidated since it was last used.
+ */
+static Relation
+logicalrep_rel_open(LogicalRepRelId remoteid, LOCKMODE lockmode,
+					LogicalRepRelMapEntry **entryp)
+{
+	LogicalRepRelMapEntry *entry = NULL;
+	LogicalRepRelation *remoterel;
+	Relation	rel = NULL;
+	bool		found;
+
+	if (LogicalRepRelMap == NULL)
+		found = false;
+	else
+		entry = hash_search(LogicalRepRelMap, &remoteid, HASH_FIND, &found);
+
+	if (!found)
+		ereport(ERROR,
+				(errcode(ERRCODE_PROTOCOL_VIOLATION),
+				 errmsg("no relation map entry for remote relation ID %u",
+						remoteid)));
+
+	remoterel = entry->remoterel;
+
+	/* Try the relation we used last time, if it's still around. */
+	if (OidIsValid(entry->localreloid))
+	{
+		rel = try_relation_open(entry->localreloid, lockmode);
+
+		/* Processing invalidations while locking it may have reset us. */
+		if (rel != NULL && !OidIsValid(entry->localreloid))
+		{
+			heap_close(rel, lockmode);
+			rel = NULL;
+		}
+	}
+
+	if (rel == NULL)
+	{
+		Oid			relid;
+
+		relid = RangeVarGetRelid(makeRangeVar(remoterel->nspname,
+											  remoterel->relname, -1),
+								 lockmode, true);
+		if (!OidIsValid(relid))
+			ereport(ERROR,
+					(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+					 errmsg("logical replication target relation \"%s.%s\" does not exist",
+							remoterel->nspname, remoterel->relname)));
+		rel = heap_open(relid, NoLock);
+
+		if (rel->rd_rel->relkind != RELKIND_RELATION)
+			ereport(ERROR,
+					(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+					 errmsg("logical replication target relation \"%s.%s\" is not a table",
+							remoterel->nspname, remoterel->relname)));
+
+		logicalrep_relmap_build_attrmap(entry, rel);
+		entry->localreloid = relid;
+	}
+
+	*entryp = entry;
+	return rel;
+}
+
+/*
+ * Make sure that we are in a transaction, and in the per-message memory
+ * context.  Returns true if a new transaction was started.
+ */
+static bool
+ensure_transaction(void)
+{
+	if (IsTransactionState())
+	{
+		if (CurrentMemoryContext != ApplyMessageContext)
+			MemoryContextSwitchTo(ApplyMessageContext);
+		return false;
+	}
+
+	StartTransactionCommand();
+	MemoryContextSwitchTo(ApplyMessageContext);
+	return true;
+}
+
+/*
+ * Executor state for applying a change to the given relation.
+ */
+static EState *
+create_estate_for_relation(Relation rel)
+{
+	EState	   *estate;
+	ResultRelInfo *resultRelInfo;
+	RangeTblEntry *rte;
+
+	estate = CreateExecutorState();
+
+	rte = makeNode(RangeTblEntry);
+	rte->rtekind = RTE_RELATION;
+	rte->relid = RelationGetRelid(rel);
+	rte->relkind = rel->rd_rel->relkind;
+	estate->es_range_table = list_make1(rte);
+
+	resultRelInfo = makeNode(ResultRelInfo);
+	InitResultRelInfo(resultRelInfo, rel, 1, 0);
+
+	estate->es_result_relations = resultRelInfo;
+	estate->es_num_result_relations = 1;
+	estate->es_result_relation_info = resultRelInfo;
+	estate->es_output_cid = GetCurrentCommandId(true);
+
+	ExecOpenIndices(resultRelInfo, false);
+
+	return estate;
+}
+
+static void
+free_estate(EState *estate)
+{
+	ExecCloseIndices(estate->es_result_relation_info);
+	ExecResetTupleTable(estate->es_tupleTable, false);
+	FreeExecutorState(estate);
+}
+
+/*
+ * Error context callback for converting remote values to local datums.
+ */
+static void
+slot_store_error_callback(void *arg)
+{
+	SlotErrCallbackArg *errarg = (SlotErrCallbackArg *) arg;
+	LogicalRepRelation *remoterel = errarg->entry->remoterel;
+
+	if (errarg->remote_attnum < 0)
+		return;
+
+	errcontext("processing remote data for replication target relation \"%s.%s\" column \"%s\"",
+			   remoterel->nspname, remoterel->relname,
+			   remoterel->attnames[errarg->remote_attnum]);
+}
+
+/*
+ * Convert the remote value of one column to a datum of the local column.
+ *
+ * Values in binary format are only sent for built-in types, but they can
+ * only be read if the local column has the same type.
+ */
+static Datum
+remote_value_to_datum(LogicalRepRelMapEntry *entry, Form_pg_attribute att,
+					  LogicalRepTupleData *tup, int remote_attnum,
+					  bool *isnull)
+{
+	SlotErrCallbackArg errarg;
+	ErrorContextCallback errcallback;
+	char	   *value = tup->values[remote_attnum];
+	Oid			typioparam;
+	Datum		result;
+
+	if (value == NULL)
+	{
+		*isnull = true;
+		return (Datum) 0;
+	}
+
+	errarg.entry = entry;
+	errarg.remote_attnum = remote_attnum;
+	errcallback.callback = slot_store_error_callback;
+	errcallback.arg = (void *) &errarg;
+	errcallback.previous = error_context_stack;
+	error_context_stack = &errcallback;
+
+	if (tup->binary[remote_attnum])
+	{
+		Oid			typreceive;
+		StringInfoData buf;
+
+		if (entry->remoterel->atttyps[remote_attnum] != att->atttypid)
+			ereport(ERROR,
+					(errcode(ERRCODE_DATATYPE_MISMATCH),
+					 errmsg("binary data of type %s cannot be stored in a column of type %s",
+						format_type_be(entry->remoterel->atttyps[remote_attnum]),
+							format_type_be(att->atttypid))));
+
+		buf.data = value;
+		buf.len = tup->lengths[remote_attnum];
+		buf.maxlen = buf.len + 1;
+		buf.cursor = 0;
+
+		getTypeBinaryInputInfo(att->atttypid, &typreceive, &typioparam);
+		result = OidReceiveFunctionCall(typreceive, &buf, typioparam,
+										att->atttypmod);
+		if (buf.cursor != buf.len)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+					 errmsg("incorrect binary data format")));
+	}
+	else
+	{
+		Oid			typinput;
+
+		getTypeInputInfo(att->atttypid, &typinput, &typioparam);
+		result = OidInputFunctionCall(typinput, value, typioparam,
+									  att->atttypmod);
+	}
+
+	error_context_stack = errcallback.previous;
+
+	*isnull = false;
+	return result;
+}
+
+/*
+ * Is the value of the given remote column usable to identify a row?  Only
+ * replica identity columns are sent in the old tuple, and a toasted value
+ * that was not changed is not sent at all.
+ */
+static bool
+remote_key_available(LogicalRepRelMapEntry *entry, LogicalRepTupleData *tup,
+					 int remote_attnum)
+{
+	return remote_attnum >= 0 &&
+		bms_is_member(remote_attnum, entry->remoterel->attkeys) &&
+		tup->changed[remote_attnum];
+}
+
+/*
+ * Does a local tuple match the key values sent by the publisher?
+ */
+static bool
+tuple_matches_key(TupleDesc desc, HeapTuple tuple, Datum *keyvalues,
+				  bool *keynulls, bool *keyused)
+{
+	Datum	   *values = palloc(desc->natts * sizeof(Datum));
+	bool	   *nulls = palloc(desc->natts * sizeof(bool));
+	bool		equal = true;
+	int			i;
+
+	heap_deform_tuple(tuple, desc, values, nulls);
+
+	for (i = 0; i < desc->natts && equal; i++)
+	{
+		Form_pg_attribute att = desc->attrs[i];
+		TypeCacheEntry *typentry;
+
+		if (!keyused[i])
+			continue;
+
+		if (nulls[i] || keynulls[i])
+		{
+			equal = nulls[i] && keynulls[i];
+			continue;
+		}
+
+		typentry = lookup_type_cache(att->atttypid, TYPECACHE_EQ_OPR_FINFO);
+		if (!OidIsValid(typentry->eq_opr_finfo.fn_oid))
+			ereport(ERROR,
+					(errcode(ERRCODE_UNDEFINED_FUNCTION),
+					 errmsg("could not identify an equality operator for type %s",
+							format_type_be(att->atttypid))));
+
+		equal = DatumGetBool(FunctionCall2Coll(&typentry->eq_opr_finfo,
+											   att->attcollation,
+											   values[i],
+											   keyvalues[i]));
+	}
+
+	pfree(values);
+	pfree(nulls);
+
+	return equal;
+}
+
+/*
+ * Find the local tuple matching the replica identity sent by the publisher,
+ * and lock it in the given mode.
+ *
+ * The search uses a dirty snapshot, so that rows inserted or deleted by
+ * transactions still in progress are seen; if the row found is being
+ * modified by such a transaction, we wait for it to finish and search again.
+ * The same happens if the row is updated concurrently before we manage to
+ * lock it.  Once locked, the caller can update or delete the row with
+ * simple_heap_update/simple_heap_delete.
+ *
+ * On success, a copy of the tuple is returned in *tuple.
+ */
+static bool
+locate_tuple(LogicalRepRelMapEntry *entry, Relation rel,
+			 LogicalRepTupleData *keytup, LockTupleMode lockmode,
+			 HeapTuple *tuple)
+{
+	TupleDesc	desc = RelationGetDescr(rel);
+	Datum	   *keyvalues;
+	bool	   *keynulls;
+	bool	   *keyused;
+	bool		any_key = false;
+	Oid			idxoid;
+	Relation	idxrel = NULL;
+	int			nkeys = 0;
+	ScanKey		skey = NULL;
+	SnapshotData snap;
+	bool		found;
+	int			i;
+
+	/* Convert the key values sent to local datums */
+	keyvalues = palloc(desc->natts * sizeof(Datum));
+	keynulls = palloc(desc->natts * sizeof(bool));
+	keyused = palloc0(desc->natts * sizeof(bool));
+	for (i = 0; i < desc->natts; i++)
+	{
+		int			remote_attnum = entry->localattrmap[i];
+
+		if (!remote_key_available(entry, keytup, remote_attnum))
+			continue;
+
+		keyvalues[i] = remote_value_to_datum(entry, desc->attrs[i], keytup,
+											 remote_attnum, &keynulls[i]);
+		keyused[i] = true;
+		any_key = true;
+	}
+
+	if (!any_key)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("publisher did not send replica identity for replication target relation \"%s.%s\"",
+						entry->remoterel->nspname,
+						entry->remoterel->relname)));
+
+	/*
+	 * Use the local replica identity index if we have non-null values for
+	 * all of its key columns; included columns can't be searched on.
+	 */
+	idxoid = RelationGetReplicaIndex(rel);
+	if (OidIsValid(idxoid))
+	{
+		int2vector *indkey;
+		Datum		indclassDatum;
+		oidvector  *opclass;
+		bool		isnull;
+
+		idxrel = index_open(idxoid, RowExclusiveLock);
+		indkey = &idxrel->rd_index->indkey;
+		nkeys = IndexRelationGetNumberOfKeyAttributes(idxrel);
+		skey = palloc(nkeys * sizeof(ScanKeyData));
+
+		indclassDatum = SysCacheGetAttr(INDEXRELID, idxrel->rd_indextuple,
+										Anum_pg_index_indclass, &isnull);
+		Assert(!isnull);
+		opclass = (oidvector *) DatumGetPointer(indclassDatum);
+
+		for (i = 0; i < nkeys; i++)
+		{
+			AttrNumber	attno = indkey->values[i];
+			Oid			optype;
+			Oid			operator;
+
+			if (attno <= 0 || !keyused[attno - 1] || keynulls[attno - 1])
+				break;
+
+			optype = get_opclass_input_type(opclass->values[i]);
+			operator = get_opfamily_member(get_opclass_family(opclass->values[i]),
+										   optype, optype,
+										   BTEqualStrategyNumber);
+			if (!OidIsValid(operator))
+				elog(ERROR, "missing operator %d(%u,%u) in opfamily %u",
+					 BTEqualStrategyNumber, optype, optype,
+					 get_opclass_family(opclass->values[i]));
+
+			ScanKeyInit(&skey[i], i + 1, BTEqualStrategyNumber,
+						get_opcode(operator), keyvalues[attno - 1]);
+		}
+
+		if (i < nkeys)
+		{
+			/* Otherwise, scan the whole table comparing the key columns. */
+			index_close(idxrel, NoLock);
+			idxrel = NULL;
+		}
+	}
+
+	InitDirtySnapshot(snap);
+
+retry:
+	found = false;
+
+	if (idxrel != NULL)
+	{
+		IndexScanDesc scan;
+		HeapTuple	scantuple;
+
+		scan = index_beginscan(rel, idxrel, &snap, nkeys, 0);
+		index_rescan(scan, skey, nkeys, NULL, 0);
+
+		scantuple = index_getnext(scan, ForwardScanDirection);
+		if (scantuple != NULL)
+		{
+			*tuple = heap_copytuple(scantuple);
+			found = true;
+		}
+
+		index_endscan(scan);
+	}
+	else
+	{
+		HeapScanDesc scan;
+		HeapTuple	scantuple;
+
+		scan = heap_beginscan(rel, &snap, 0, NULL);
+		while ((scantuple = heap_getnext(scan, ForwardScanDirection)) != NULL)
+		{
+			if (tuple_matches_key(desc, scantuple, keyvalues, keynulls,
+								  keyused))
+			{
+				*tuple = heap_copytuple(scantuple);
+				found = true;
+				break;
+			}
+		}
+		heap_endscan(scan);
+	}
+
+	if (found)
+	{
+		TransactionId xwait;
+		HeapTupleData locktup;
+		Buffer		buf;
+		HeapUpdateFailureData hufd;
+		HTSU_Result res;
+
+		/* Wait for a transaction inserting or deleting the row to finish. */
+		xwait = TransactionIdIsValid(snap.xmin) ? snap.xmin : snap.xmax;
+		if (TransactionIdIsValid(xwait))
+		{
+			heap_freetuple(*tuple);
+			XactLockTableWait(xwait, rel, NULL, XLTW_None);
+			goto retry;
+		}
+
+		locktup.t_self = (*tuple)->t_self;
+		PushActiveSnapshot(GetLatestSnapshot());
+		res = heap_lock_tuple(rel, &locktup, GetCurrentCommandId(false),
+							  lockmode, LockWaitBlock,
+							  false /* don't follow updates */ ,
+							  &buf, &hufd);
+		/* we only need the lock, not the pin */
+		ReleaseBuffer(buf);
+		PopActiveSnapshot();
+
+		switch (res)
+		{
+			case HeapTupleMayBeUpdated:
+				break;
+			case HeapTupleUpdated:
+				/* the row was changed since we found it; look again */
+				heap_freetuple(*tuple);
+				goto retry;
+			case HeapTupleInvisible:
+				elog(ERROR, "attempted to lock invisible tuple");
+				break;
+			default:
+				elog(ERROR, "unexpected heap_lock_tuple status: %u", res);
+				break;
+		}
+	}
+
+	if (idxrel != NULL)
+		index_close(idxrel, NoLock);
+
+	return found;
+}
+
+/*
+ * Handle BEGIN message.
+ */
+static void
+apply_handle_begin(StringInfo s)
+{
+	LogicalRepBeginData begin_data;
+
+	logicalrep_read_begin(s, &begin_data);
+
+	remote_final_lsn = begin_data.final_lsn;
+	in_remote_transaction = true;
+
+	pgstat_report_activity(STATE_RUNNING, NULL);
+}
+
+/*
+ * Handle COMMIT message.
+ */
+static void
+apply_handle_commit(StringInfo s)
+{
+	LogicalRepCommitData commit_data;
+
+	logicalrep_read_commit(s, &commit_data);
+
+	if (!in_remote_transaction ||
+		commit_data.commit_lsn != remote_final_lsn)
+		ereport(ERROR,
+				(errcode(ERRCODE_PROTOCOL_VIOLATION),
+				 errmsg("unexpected commit message for transaction ending at %X/%X",
+						(uint32) (commit_data.commit_lsn >> 32),
+						(uint32) commit_data.commit_lsn)));
+
+	if (IsTransactionState())
+	{
+		/*
+		 * Record the remote commit in our replication origin, so that it's
+		 * advanced atomically with the local commit.
+		 */
+		replorigin_sesssion_origin_lsn = commit_data.end_lsn;
+		replorigin_sesssion_origin_timestamp = commit_data.committime;
+
+		CommitTransactionCommand();
+
+		store_flush_position(commit_data.end_lsn);
+	}
+
+	in_remote_transaction = false;
+
+	pgstat_report_stat(false);
+	pgstat_report_activity(STATE_IDLE, NULL);
+}
+
+/*
+ * Handle RELATION message.
+ */
+static void
+apply_handle_relation(StringInfo s)
+{
+	LogicalRepRelation *rel;
+
+	rel = logicalrep_read_rel(s);
+	logicalrep_relmap_update(rel);
+}
+
+/*
+ * Handle INSERT message.
+ */
+static void
+apply_handle_insert(StringInfo s)
+{
+	LogicalRepRelMapEntry *entry;
+	LogicalRepTupleData newtup;
+	LogicalRepRelId relid;
+	Relation	rel;
+	TupleDesc	desc;
+	EState	   *estate;
+	ResultRelInfo *resultRelInfo;
+	TupleTableSlot *slot;
+	HeapTuple	tuple;
+	Datum	   *values;
+	bool	   *nulls;
+	int			i;
+
+	ensure_transaction();
+
+	relid = logicalrep_read_insert(s, &newtup);
+	rel = logicalrep_rel_open(relid, RowExclusiveLock, &entry);
+	desc = RelationGetDescr(rel);
+
+	PushActiveSnapshot(GetTransactionSnapshot());
+
+	estate = create_estate_for_relation(rel);
+	resultRelInfo = estate->es_result_relation_info;
+	slot = ExecInitExtraTupleSlot(estate);
+	ExecSetSlotDescriptor(slot, desc);
+
+	/* Build the new tuple; columns not sent get their default values. */
+	values = palloc(desc->natts * sizeof(Datum));
+	nulls = palloc(desc->natts * sizeof(bool));
+	for (i = 0; i < desc->natts; i++)
+	{
+		Form_pg_attribute att = desc->attrs[i];
+		int			remote_attnum = entry->localattrmap[i];
+
+		values[i] = (Datum) 0;
+		nulls[i] = true;
+
+		if (att->attisdropped)
+			continue;
+
+		if (remote_attnum >= 0)
+			values[i] = remote_value_to_datum(entry, att, &newtup,
+											  remote_attnum, &nulls[i]);
+		else
+		{
+			Node	   *defexpr = build_column_default(rel, i + 1);
+
+			if (defexpr != NULL)
+			{
+				ExprState  *exprstate;
+
+				exprstate = ExecInitExpr(expression_planner((Expr *) defexpr),
+										 NULL);
+				values[i] = ExecEvalExpr(exprstate,
+										 GetPerTupleExprContext(estate),
+										 &nulls[i], NULL);
+			}
+		}
+	}
+
+	tuple = heap_form_tuple(desc, values, nulls);
+	ExecStoreTuple(tuple, slot, InvalidBuffer, false);
+
+	if (rel->rd_att->constr || resultRelInfo->ri_PartitionCheck)
+		ExecConstraints(resultRelInfo, slot, estate);
+
+	simple_heap_insert(rel, tuple);
+	if (resultRelInfo->ri_NumIndices > 0)
+		ExecInsertIndexTuples(slot, &(tuple->t_self), estate, false, NULL,
+							  NIL);
+
+	PopActiveSnapshot();
+	free_estate(estate);
+	heap_close(rel, NoLock);
+
+	CommandCounterIncrement();
+}
+
+/*
+ * Handle UPDATE message.
+ */
+static void
+apply_handle_update(StringInfo s)
+{
+	LogicalRepRelMapEntry *entry;
+	LogicalRepTupleData oldtup;
+	LogicalRepTupleData newtup;
+	LogicalRepRelId relid;
+	bool		has_oldtup;
+	Relation	rel;
+	TupleDesc	desc;
+	EState	   *estate;
+	ResultRelInfo *resultRelInfo;
+	TupleTableSlot *slot;
+	HeapTuple	localtuple;
+
+	ensure_transaction();
+
+	relid = logicalrep_read_update(s, &has_oldtup, &oldtup, &newtup);
+	rel = logicalrep_rel_open(relid, RowExclusiveLock, &entry);
+	desc = RelationGetDescr(rel);
+
+	PushActiveSnapshot(GetTransactionSnapshot());
+
+	estate = create_estate_for_relation(rel);
+	resultRelInfo = estate->es_result_relation_info;
+	slot = ExecInitExtraTupleSlot(estate);
+	ExecSetSlotDescriptor(slot, desc);
+
+	/* If the key was not changed, the publisher only sends the new tuple. */
+	if (locate_tuple(entry, rel, has_oldtup ? &oldtup : &newtup,
+					 LockTupleExclusive, &localtuple))
+	{
+		HeapTuple	tuple;
+		Datum	   *values;
+		bool	   *nulls;
+		int			i;
+
+		/* Start from the local row, replacing the columns that were sent. */
+		values = palloc(desc->natts * sizeof(Datum));
+		nulls = palloc(desc->natts * sizeof(bool));
+		heap_deform_tuple(localtuple, desc, values, nulls);
+
+		for (i = 0; i < desc->natts; i++)
+		{
+			int			remote_attnum = entry->localattrmap[i];
+
+			if (remote_attnum < 0 || !newtup.changed[remote_attnum])
+				continue;
+
+			values[i] = remote_value_to_datum(entry, desc->attrs[i], &newtup,
+											  remote_attnum, &nulls[i]);
+		}
+
+		tuple = heap_form_tuple(desc, values, nulls);
+		ExecStoreTuple(tuple, slot, InvalidBuffer, false);
+
+		if (rel->rd_att->constr || resultRelInfo->ri_PartitionCheck)
+			ExecConstraints(resultRelInfo, slot, estate);
+
+		simple_heap_update(rel, &localtuple->t_self, tuple);
+		if (resultRelInfo->ri_NumIndices > 0 && !HeapTupleIsHeapOnly(tuple))
+			ExecInsertIndexTuples(slot, &(tuple->t_self), estate, false, NULL,
+								  NIL);
+	}
+	else
+		elog(DEBUG1,
+			 "logical replication did not find row for update in replication target relation \"%s\"",
+			 RelationGetRelationName(rel));
+
+	PopActiveSnapshot();
+	free_estate(estate);
+	heap_close(rel, NoLock);
+
+	CommandCounterIncrement();
+}
+
+/*
+ * Handle DELETE message.
+ */
+static void
+apply_handle_delete(StringInfo s)
+{
+	LogicalRepRelMapEntry *entry;
+	LogicalRepTupleData oldtup;
+	LogicalRepRelId relid;
+	Relation	rel;
+	HeapTuple	localtuple;
+
+	ensure_transaction();
+
+	relid = logicalrep_read_delete(s, &oldtup);
+	rel = logicalrep_rel_open(relid, RowExclusiveLock, &entry);
+
+	PushActiveSnapshot(GetTransactionSnapshot());
+
+	if (locate_tuple(entry, rel, &oldtup, LockTupleExclusive, &localtuple))
+		simple_heap_delete(rel, &localtuple->t_self);
+	else
+		elog(DEBUG1,
+			 "logical replication could not find row for delete in replication target relation \"%s\"",
+			 RelationGetRelationName(rel));
+
+	PopActiveSnapshot();
+	heap_close(rel, NoLock);
+
+	CommandCounterIncrement();
+}
+
+/*
+ * Logical replication protocol message dispatcher.
+ */
+static void
+apply_dispatch(StringInfo s)
+{
+	char		action = pq_getmsgbyte(s);
+
+	switch (action)
+	{
+		case 'B':
+			apply_handle_begin(s);
+			break;
+		case 'C':
+			apply_handle_commit(s);
+			break;
+		case 'I':
+			apply_handle_insert(s);
+			break;
+		case 'U':
+			apply_handle_update(s);
+			break;
+		case 'D':
+			apply_handle_delete(s);
+			break;
+		case 'R':
+			apply_handle_relation(s);
+			break;
+		default:
+			ereport(ERROR,
+					(errcode(ERRCODE_PROTOCOL_VIOLATION),
+					 errmsg("invalid logical replication message type \"%c\"",
+							action)));
+	}
+}
+
+/*
+ * Figure out which remote positions can be reported as written and flushed.
+ *
+ * Transactions whose local commit record has been flushed are forgotten;
+ * *have_pending_txes is set if some are still waiting for that.
+ */
+static void
+get_flush_position(XLogRecPtr *write, XLogRecPtr *flush,
+				   bool *have_pending_txes)
+{
+	dlist_mutable_iter iter;
+	XLogRecPtr	local_flush = GetFlushRecPtr();
+
+	*write = InvalidXLogRecPtr;
+	*flush = InvalidXLogRecPtr;
+
+	dlist_foreach_modify(iter, &lsn_mapping)
+	{
+		FlushPosition *pos =
+		dlist_container(FlushPosition, node, iter.cur);
+
+		*write = pos->remote_end;
+
+		if (pos->local_end <= local_flush)
+		{
+			*flush = pos->remote_end;
+			dlist_delete(iter.cur);
+			pfree(pos);
+		}
+		else
+		{
+			/*
+			 * Don't want to uselessly iterate over the rest of the list which
+			 * could potentially be long. Instead get the last element and
+			 * grab the write position from there.
+			 */
+			pos = dlist_tail_element(FlushPosition, node, &lsn_mapping);
+			*write = pos->remote_end;
+			*have_pending_txes = true;
+			return;
+		}
+	}
+
+	*have_pending_txes = !dlist_is_empty(&lsn_mapping);
+}
+
+/*
+ * Remember the local commit record of the remote transaction just applied.
+ */
+static void
+store_flush_position(XLogRecPtr remote_lsn)
+{
+	FlushPosition *flushpos;
+
+	flushpos = (FlushPosition *) MemoryContextAlloc(ApplyContext,
+													sizeof(FlushPosition));
+	flushpos->local_end = XactLastCommitEnd;
+	flushpos->remote_end = remote_lsn;
+
+	dlist_push_tail(&lsn_mapping, &flushpos->node);
+}
+
+/*
+ * Send a Standby Status Update message to the publisher.
+ *
+ * Like the walreceiver, this only sends a message if something changed or
+ * wal_receiver_status_interval has passed, unless forced.
+ */
+static void
+send_feedback(XLogRecPtr recvpos, bool force, bool requestReply)
+{
+	static StringInfo reply_message = NULL;
+	static TimestampTz send_time = 0;
+	static XLogRecPtr last_recvpos = InvalidXLogRecPtr;
+	static XLogRecPtr last_writepos = InvalidXLogRecPtr;
+	static XLogRecPtr last_flushpos = InvalidXLogRecPtr;
+	XLogRecPtr	writepos;
+	XLogRecPtr	flushpos;
+	TimestampTz now;
+	bool		have_pending_txes;
+
+	if (!force && wal_receiver_status_interval <= 0)
+		return;
+
+	/* It's legal to not pass a recvpos */
+	if (recvpos < last_recvpos)
+		recvpos = last_recvpos;
+
+	get_flush_position(&writepos, &flushpos, &have_pending_txes);
+
+	/*
+	 * If no transactions are waiting for a local flush, everything received
+	 * so far has been applied.  Decoding will resend any transaction whose
+	 * commit comes after the position we confirm.
+	 */
+	if (!have_pending_txes)
+		flushpos = writepos = recvpos;
+
+	if (writepos < last_writepos)
+		writepos = last_writepos;
+
+	if (flushpos < last_flushpos)
+		flushpos = last_flushpos;
+
+	now = GetCurrentTimestamp();
+
+	/* if we've already reported everything we're good */
+	if (!force &&
+		writepos == last_writepos &&
+		flushpos == last_flushpos &&
+		!TimestampDifferenceExceeds(send_time, now,
+									wal_receiver_status_interval * 1000))
+		return;
+	send_time = now;
+
+	if (reply_message == NULL)
+	{
+		MemoryContext oldctx = MemoryContextSwitchTo(ApplyContext);
+
+		reply_message = makeStringInfo();
+		MemoryContextSwitchTo(oldctx);
+	}
+	else
+		resetStringInfo(reply_message);
+
+	pq_sendbyte(reply_message, 'r');
+	pq_sendint64(reply_message, recvpos);		/* write */
+	pq_sendint64(reply_message, flushpos);		/* flush */
+	pq_sendint64(reply_message, writepos);		/* apply */
+	pq_sendint64(reply_message, GetCurrentIntegerTimestamp());
+	pq_sendbyte(reply_message, requestReply ? 1 : 0);
+
+	elog(DEBUG2, "sending feedback (force %d) to recv %X/%X, write %X/%X, flush %X/%X",
+		 force,
+		 (uint32) (recvpos >> 32), (uint32) recvpos,
+		 (uint32) (writepos >> 32), (uint32) writepos,
+		 (uint32) (flushpos >> 32), (uint32) flushpos);
+
+	walrcv_send(reply_message->data, reply_message->len);
+
+	logicalrep_worker_report(InvalidXLogRecPtr, 0, flushpos, now);
+
+	if (recvpos > last_recvpos)
+		last_recvpos = recvpos;
+	if (writepos > last_writepos)
+		last_writepos = writepos;
+	if (flushpos > last_flushpos)
+		last_flushpos = flushpos;
+}
+
+/*
+ * Apply main loop.
+ */
+static void
+LogicalRepApplyLoop(XLogRecPtr last_received)
+{
+	TimestampTz last_recv_timestamp = GetCurrentTimestamp();
+	bool		ping_sent = false;
+
+	ApplyMessageContext = AllocSetContextCreate(ApplyContext,
+												"ApplyMessageContext",
+												ALLOCSET_DEFAULT_MINSIZE,
+												ALLOCSET_DEFAULT_INITSIZE,
+												ALLOCSET_DEFAULT_MAXSIZE);
+
+	for (;;)
+	{
+		char	   *buf;
+		int			len;
+
+		CHECK_FOR_INTERRUPTS();
+
+		MemoryContextSwitchTo(ApplyMessageContext);
+
+		len = walrcv_receive(NAPTIME_PER_CYCLE, &buf);
+		if (len != 0)
+		{
+			/* Process the data */
+			for (;;)
+			{
+				StringInfoData s;
+				int			c;
+
+				CHECK_FOR_INTERRUPTS();
+
+				if (len < 0)
+				{
+					ereport(LOG,
+							(errmsg("data stream from publisher has ended")));
+					proc_exit(1);
+				}
+
+				s.data = buf;
+				s.len = len;
+				s.cursor = 0;
+				s.maxlen = -1;
+
+				c = pq_getmsgbyte(&s);
+
+				if (c == 'w')
+				{
+					XLogRecPtr	start_lsn;
+					XLogRecPtr	end_lsn;
+
+					start_lsn = pq_getmsgint64(&s);
+					end_lsn = pq_getmsgint64(&s);
+					(void) pq_getmsgint64(&s);	/* sendTime */
+
+					if (last_received < start_lsn)
+						last_received = start_lsn;
+
+					if (last_received < end_lsn)
+						last_received = end_lsn;
+
+					last_recv_timestamp = GetCurrentTimestamp();
+					ping_sent = false;
+					logicalrep_worker_report(last_received,
+											 last_recv_timestamp,
+											 InvalidXLogRecPtr, 0);
+
+					apply_dispatch(&s);
+				}
+				else if (c == 'k')
+				{
+					XLogRecPtr	endpos;
+					bool		reply_requested;
+
+					endpos = pq_getmsgint64(&s);
+					(void) pq_getmsgint64(&s);	/* sendTime */
+					reply_requested = pq_getmsgbyte(&s);
+
+					if (last_received < endpos)
+						last_received = endpos;
+
+					last_recv_timestamp = GetCurrentTimestamp();
+					ping_sent = false;
+					logicalrep_worker_report(last_received,
+											 last_recv_timestamp,
+											 InvalidXLogRecPtr, 0);
+
+					send_feedback(last_received, reply_requested, false);
+				}
+				/* other message types are purposefully ignored */
+
+				MemoryContextReset(ApplyMessageContext);
+				MemoryContextSwitchTo(ApplyMessageContext);
+
+				len = walrcv_receive(0, &buf);
+				if (len == 0)
+					break;
+			}
+		}
+
+		/* emergency bailout if postmaster has died */
+		if (!PostmasterIsAlive())
+			proc_exit(1);
+
+		if (got_SIGHUP)
+		{
+			got_SIGHUP = false;
+			ProcessConfigFile(PGC_SIGHUP);
+		}
+
+		if (len == 0)
+		{
+			/*
+			 * We didn't receive anything new.  If we haven't heard anything
+			 * from the publisher for more than wal_receiver_timeout / 2,
+			 * ping it, and give up if it still doesn't answer within
+			 * wal_receiver_timeout.
+			 */
+			bool		requestReply = false;
+
+			if (wal_receiver_timeout > 0)
+			{
+				TimestampTz now = GetCurrentTimestamp();
+				TimestampTz timeout;
+
+				timeout = TimestampTzPlusMilliseconds(last_recv_timestamp,
+													  wal_receiver_timeout);
+				if (now >= timeout)
+					ereport(ERROR,
+							(errmsg("terminating logical replication worker due to timeout")));
+
+				if (!ping_sent)
+				{
+					timeout = TimestampTzPlusMilliseconds(last_recv_timestamp,
+												 (wal_receiver_timeout / 2));
+					if (now >= timeout)
+					{
+						requestReply = true;
+						ping_sent = true;
+					}
+				}
+			}
+
+			send_feedback(last_received, requestReply, requestReply);
+		}
+		else
+			send_feedback(last_received, false, false);
+	}
+}
+
+/*
+ * Logical replication apply worker entry point.
+ */
+void
+ApplyWorkerMain(Datum main_arg)
+{
+	int			worker_slot = DatumGetInt32(main_arg);
+	char		originname[NAMEDATALEN];
+	RepOriginId originid;
+	XLogRecPtr	origin_startpos;
+	StringInfoData options;
+	MemoryContext oldctx;
+	ListCell   *lc;
+
+	/* Attach to our slot, so that we can be found and stopped. */
+	logicalrep_worker_attach(worker_slot);
+
+	/* Establish signal handlers. */
+	pqsignal(SIGHUP, logicalrep_worker_sighup);
+	pqsignal(SIGTERM, die);
+	BackgroundWorkerUnblockSignals();
+
+	ApplyContext = AllocSetContextCreate(TopMemoryContext,
+										 "ApplyContext",
+										 ALLOCSET_DEFAULT_MINSIZE,
+										 ALLOCSET_DEFAULT_INITSIZE,
+										 ALLOCSET_DEFAULT_MAXSIZE);
+
+	/* Connect to our database, as superuser. */
+	BackgroundWorkerInitializeConnectionByOid(MyLogicalRepWorker->dbid,
+											  InvalidOid);
+
+	/*
+	 * The position we confirm to the publisher only advances once our
+	 * commits have been flushed, so there is no need to wait for that.
+	 */
+	SetConfigOption("synchronous_commit", "off", PGC_SUSET, PGC_S_OVERRIDE);
+
+	/*
+	 * Load the subscription.  Whoever drops or disables it holds a stronger
+	 * lock while stopping our worker, so once we have the lock we know it
+	 * still exists and is enabled.
+	 */
+	StartTransactionCommand();
+	LockSharedObject(SubscriptionRelationId, MyLogicalRepWorker->subid, 0,
+					 AccessShareLock);
+
+	oldctx = MemoryContextSwitchTo(ApplyContext);
+	MySubscription = GetSubscription(MyLogicalRepWorker->subid, true);
+	MemoryContextSwitchTo(oldctx);
+
+	if (MySubscription == NULL || !MySubscription->enabled)
+	{
+		CommitTransactionCommand();
+		proc_exit(0);
+	}
+
+	/* Set up our replication origin, and find out where to start. */
+	snprintf(originname, sizeof(originname), "pg_%u", MySubscription->oid);
+	originid = replorigin_by_name(originname, false);
+	replorigin_session_setup(originid);
+	replorigin_sesssion_origin = originid;
+	origin_startpos = replorigin_session_get_progress(false);
+
+	CommitTransactionCommand();
+
+	ereport(LOG,
+			(errmsg("logical replication apply for subscription \"%s\" has started",
+					MySubscription->name)));
+
+	CacheRegisterRelcacheCallback(logicalrep_relmap_invalidate_cb,
+								  (Datum) 0);
+
+	/* Load the libpq-specific functions */
+	load_file("libpqwalreceiver", false);
+	if (walrcv_connect_logical == NULL ||
+		walrcv_startstreaming_logical == NULL ||
+		walrcv_receive == NULL || walrcv_send == NULL)
+		elog(ERROR, "libpqwalreceiver didn't initialize correctly");
+
+	/* Connect to the publisher and start streaming. */
+	walrcv_connect_logical(MySubscription->conninfo, MySubscription->name);
+
+	initStringInfo(&options);
+	appendStringInfo(&options, "proto_version '%u'",
+					 LOGICALREP_PROTO_VERSION_NUM);
+	foreach(lc, MySubscription->tables)
+	{
+		char	   *table = (char *) lfirst(lc);
+		char	   *p;
+
+		appendStringInfoString(&options, ", table '");
+		for (p = table; *p; p++)
+		{
+			if (*p == '\'')
+				appendStringInfoChar(&options, '\'');
+			appendStringInfoChar(&options, *p);
+		}
+		appendStringInfoChar(&options, '\'');
+	}
+
+	walrcv_startstreaming_logical(MySubscription->slotname, origin_startpos,
+								  options.data);
+	pfree(options.data);
+
+	/* Run the main loop. */
+	LogicalRepApplyLoop(origin_startpos);
+
+	proc_exit(0);
+}
@@ -0,0 +1,843 @@
+/*-------------------------------------------------------------------------
+ *
+ * pgoutput.c
+ *		Logical replication output plugin
+ *
+ * This plugin writes the binary logical replication protocol implemented in
+ * replication/logical/proto.c, which is consumed by the built-in apply
+ * workers.  It accepts the following options:
+ *
+ *	proto_version	version of the protocol to write (required)
+ *	binary			send values of built-in types in binary format, using
+ *					their send functions, instead of text (default false)
+ *	table			schema-qualified name of a table whose changes should be
+ *					sent; may be given several times.  If it is not given at
+ *					all, changes to all tables are sent.
+ *	columns			"schema.table: col, ..." restricts the columns sent for
+ *					a table to the listed ones and its replica identity
+ *	row_filter		"schema.table: expr" only sends the changes of a table
+ *					for rows that satisfy the boolean expression
+ *
+ * Row filters are evaluated on the new row for inserts and updates and on
+ * the old row for deletes; of the old row, only the replica identity
+ * columns are known unless the table uses REPLICA IDENTITY FULL.  They may
+ * only use immutable functions, since they run in the middle of decoding.
+ *
+ * Changes that are filtered out are never converted by output functions,
+ * which are the main cost of decoding.
+ *
+ * Copyright (c) 2015, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *		  src/backend/replication/pgoutput/pgoutput.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/sysattr.h"
+#include "catalog/pg_class.h"
+#include "executor/executor.h"
+#include "nodes/parsenodes.h"
+#include "optimizer/clauses.h"
+#include "optimizer/planner.h"
+#include "parser/parse_coerce.h"
+#include "parser/parse_collate.h"
+#include "parser/parse_expr.h"
+#include "parser/parse_relation.h"
+#include "parser/parser.h"
+#include "replication/logical.h"
+#include "replication/logicalproto.h"
+#include "replication/output_plugin.h"
+#include "utils/builtins.h"
+#include "utils/hsearch.h"
+#include "utils/int8.h"
+#include "utils/inval.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/relcache.h"
+
+PG_MODULE_MAGIC;
+
+extern void _PG_output_plugin_init(OutputPluginCallbacks *cb);
+
+/* An option applying to one table, given as "schema.table: value" */
+typedef struct PGOutputTableOption
+{
+	char	   *qualname;		/* quoted qualified name of the table */
+	char	   *value;
+} PGOutputTableOption;
+
+typedef struct PGOutputData
+{
+	MemoryContext context;		/* private memory context for transient
+								 * allocations */
+	uint32		protocol_version;
+	bool		binary;			/* send values in binary format? */
+	List	   *tables;			/* qualified names of tables to send, or NIL
+								 * for all tables */
+	List	   *columns;		/* column lists, as PGOutputTableOption */
+	List	   *row_filters;	/* row filters, as PGOutputTableOption */
+	bool		xact_wrote_changes;		/* BEGIN already sent? */
+} PGOutputData;
+
+/*
+ * Entry in the cache of per-relation decisions.  Entries are invalidated
+ * by relcache invalidations, which also force the relation description to
+ * be sent again before the next change.
+ */
+typedef struct RelationSyncEntry
+{
+	Oid			relid;			/* relation oid, hash key */
+	bool		valid;			/* is publish up to date? */
+	bool		publish;		/* are changes to this relation sent? */
+	bool		schema_sent;	/* did we send the relation description? */
+	Bitmapset  *columns;		/* attnums of the columns sent, or NULL for
+								 * all columns */
+	EState	   *estate;			/* executor state of the row filter */
+	ExprState  *row_filter;		/* row filter, or NULL to send all rows */
+	TupleTableSlot *slot;		/* slot the row filter is evaluated on */
+} RelationSyncEntry;
+
+static HTAB *RelationSyncCache = NULL;
+
+static void pgoutput_startup(LogicalDecodingContext *ctx,
+				 OutputPluginOptions *opt, bool is_init);
+static void pgoutput_shutdown(LogicalDecodingContext *ctx);
+static void pgoutput_begin_txn(LogicalDecodingContext *ctx,
+				   ReorderBufferTXN *txn);
+static void pgoutput_commit_txn(LogicalDecodingContext *ctx,
+					ReorderBufferTXN *txn, XLogRecPtr commit_lsn);
+static void pgoutput_change(LogicalDecodingContext *ctx,
+				ReorderBufferTXN *txn, Relation rel,
+				ReorderBufferChange *change);
+
+static void parse_output_parameters(List *options, PGOutputData *data);
+static char *normalize_table_name(const char *name);
+static PGOutputTableOption *parse_table_option(DefElem *defel, List *others);
+static PGOutputTableOption *find_table_option(List *options,
+				  const char *qualname);
+static void init_rel_sync_cache(MemoryContext decoding_context);
+static RelationSyncEntry *get_rel_sync_entry(PGOutputData *data,
+				   Relation rel);
+static void free_rel_sync_entry_filters(RelationSyncEntry *entry);
+static Bitmapset *build_column_set(Relation rel, const char *value);
+static void build_row_filter(RelationSyncEntry *entry, Relation rel,
+				 const char *value);
+static bool row_filter_matches(RelationSyncEntry *entry, HeapTuple tuple);
+static void rel_sync_cache_relation_cb(Datum arg, Oid relid);
+
+/*
+ * Specify output plugin callbacks
+ */
+void
+_PG_output_plugin_init(OutputPluginCallbacks *cb)
+{
+	AssertVariableIsOfType(&_PG_output_plugin_init, LogicalOutputPluginInit);
+
+	cb->startup_cb = pgoutput_startup;
+	cb->begin_cb = pgoutput_begin_txn;
+	cb->change_cb = pgoutput_change;
+	cb->commit_cb = pgoutput_commit_txn;
+	cb->shutdown_cb = pgoutput_shutdown;
+}
+
+static void
+parse_output_parameters(List *options, PGOutputData *data)
+{
+	ListCell   *lc;
+	bool		protocol_version_given = false;
+
+	foreach(lc, options)
+	{
+		DefElem    *defel = (DefElem *) lfirst(lc);
+
+		Assert(defel->arg == NULL || IsA(defel->arg, String));
+
+		if (strcmp(defel->defname, "proto_version") == 0)
+		{
+			int64		parsed;
+
+			if (protocol_version_given)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("conflicting or redundant options")));
+			protocol_version_given = true;
+
+			if (defel->arg == NULL ||
+				!scanint8(strVal(defel->arg), true, &parsed))
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("invalid proto_version")));
+
+			if (parsed > PG_UINT32_MAX || parsed < 0)
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("proto_version \"%s\" out of range",
+								strVal(defel->arg))));
+
+			data->protocol_version = (uint32) parsed;
+		}
+		else if (strcmp(defel->defname, "binary") == 0)
+		{
+			if (defel->arg == NULL)
+				data->binary = true;
+			else if (!parse_bool(strVal(defel->arg), &data->binary))
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("could not parse value \"%s\" for parameter \"%s\"",
+								strVal(defel->arg), defel->defname)));
+		}
+		else if (strcmp(defel->defname, "table") == 0)
+		{
+			if (defel->arg == NULL)
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("table option requires a value")));
+
+			data->tables = lappend(data->tables,
+								   normalize_table_name(strVal(defel->arg)));
+		}
+		else if (strcmp(defel->defname, "columns") == 0)
+			data->columns = lappend(data->columns,
+									parse_table_option(defel, data->columns));
+		else if (strcmp(defel->defname, "row_filter") == 0)
+			data->row_filters = lappend(data->row_filters,
+										parse_table_option(defel,
+														data->row_filters));
+		else
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("unrecognized pgoutput option: %s",
+							defel->defname)));
+	}
+
+	if (!protocol_version_given)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("proto_version option missing")));
+}
+
+/*
+ * Convert a schema-qualified table name to the form we compare relations'
+ * names with.
+ */
+static char *
+normalize_table_name(const char *name)
+{
+	List	   *names = stringToQualifiedNameList(name);
+
+	if (list_length(names) != 2)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("table name \"%s\" must be qualified with a schema name",
+						name)));
+
+	return quote_qualified_identifier(strVal(linitial(names)),
+									  strVal(lsecond(names)));
+}
+
+/*
+ * Parse an option of the form "schema.table: value".
+ *
+ * others are the options of the same kind already given, which must not
+ * name the same table.
+ */
+static PGOutputTableOption *
+parse_table_option(DefElem *defel, List *others)
+{
+	PGOutputTableOption *opt;
+	char	   *str;
+	char	   *p;
+	bool		inquote = false;
+
+	if (defel->arg == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("%s option requires a value", defel->defname)));
+
+	/* Split at the first colon that's not part of a quoted identifier */
+	str = pstrdup(strVal(defel->arg));
+	for (p = str; *p; p++)
+	{
+		if (*p == '"')
+			inquote = !inquote;
+		else if (*p == ':' && !inquote)
+			break;
+	}
+
+	if (*p != ':')
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("invalid value for %s option: \"%s\"",
+						defel->defname, strVal(defel->arg)),
+				 errhint("The value must have the form \"schema.table: ...\".")));
+	*p = '\0';
+
+	opt = palloc(sizeof(PGOutputTableOption));
+	opt->qualname = normalize_table_name(str);
+	opt->value = pstrdup(p + 1);
+
+	if (find_table_option(others, opt->qualname) != NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_SYNTAX_ERROR),
+				 errmsg("conflicting or redundant %s options for table %s",
+						defel->defname, opt->qualname)));
+
+	pfree(str);
+
+	return opt;
+}
+
+/*
+ * Find the option given for a table, if any.
+ */
+static PGOutputTableOption *
+find_table_option(List *options, const char *qualname)
+{
+	ListCell   *lc;
+
+	foreach(lc, options)
+	{
+		PGOutputTableOption *opt = (PGOutputTableOption *) lfirst(lc);
+
+		if (strcmp(opt->qualname, qualname) == 0)
+			return opt;
+	}
+
+	return NULL;
+}
+
+/*
+ * Initialize this plugin
+ */
+static void
+pgoutput_startup(LogicalDecodingContext *ctx, OutputPluginOptions *opt,
+				 bool is_init)
+{
+	PGOutputData *data = palloc0(sizeof(PGOutputData));
+
+	/* Create our memory context for private allocations. */
+	data->context = AllocSetContextCreate(ctx->context,
+										  "logical replication output context",
+										  ALLOCSET_DEFAULT_MINSIZE,
+										  ALLOCSET_DEFAULT_INITSIZE,
+										  ALLOCSET_DEFAULT_MAXSIZE);
+
+	ctx->output_plugin_private = data;
+
+	/* This plugin uses binary protocol. */
+	opt->output_type = OUTPUT_PLUGIN_BINARY_OUTPUT;
+
+	/*
+	 * This is replication start and not slot initialization.
+	 *
+	 * Parse and validate options passed by the client.
+	 */
+	if (!is_init)
+	{
+		parse_output_parameters(ctx->output_plugin_options, data);
+
+		/* Check if we support requested protocol */
+		if (data->protocol_version > LOGICALREP_PROTO_VERSION_NUM)
+			ereport(ERROR,
+					(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					 errmsg("client sent proto_version=%d but we only support protocol %d or lower",
+							data->protocol_version, LOGICALREP_PROTO_VERSION_NUM)));
+
+		if (data->protocol_version < LOGICALREP_PROTO_MIN_VERSION_NUM)
+			ereport(ERROR,
+					(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					 errmsg("client sent proto_version=%d but we only support protocol %d or higher",
+							data->protocol_version, LOGICALREP_PROTO_MIN_VERSION_NUM)));
+
+		/* Initialize relation schema cache. */
+		init_rel_sync_cache(CacheMemoryContext);
+	}
+}
+
+/*
+ * BEGIN callback
+ *
+ * BEGIN is only sent together with the first change of the transaction that
+ * is actually published, so that transactions touching only filtered tables
+ * cost nothing on the wire.
+ */
+static void
+pgoutput_begin_txn(LogicalDecodingContext *ctx, ReorderBufferTXN *txn)
+{
+	PGOutputData *data = (PGOutputData *) ctx->output_plugin_private;
+
+	data->xact_wrote_changes = false;
+}
+
+/*
+ * COMMIT callback
+ */
+static void
+pgoutput_commit_txn(LogicalDecodingContext *ctx, ReorderBufferTXN *txn,
+					XLogRecPtr commit_lsn)
+{
+	PGOutputData *data = (PGOutputData *) ctx->output_plugin_private;
+
+	if (!data->xact_wrote_changes)
+		return;
+
+	OutputPluginPrepareWrite(ctx, true);
+	logicalrep_write_commit(ctx->out, txn, commit_lsn);
+	OutputPluginWrite(ctx, true);
+}
+
+/*
+ * Sends the change to the output, preceded by BEGIN and the relation
+ * description if those were not sent yet.
+ */
+static void
+pgoutput_change(LogicalDecodingContext *ctx, ReorderBufferTXN *txn,
+				Relation relation, ReorderBufferChange *change)
+{
+	PGOutputData *data = (PGOutputData *) ctx->output_plugin_private;
+	MemoryContext old;
+	RelationSyncEntry *relentry;
+	HeapTuple	filtertuple;
+
+	relentry = get_rel_sync_entry(data, relation);
+	if (!relentry->publish)
+		return;
+
+	/* Skip rows not matching the row filter before doing any other work */
+	if (relentry->row_filter != NULL)
+	{
+		if (change->action == REORDER_BUFFER_CHANGE_DELETE)
+			filtertuple = change->data.tp.oldtuple ?
+				&change->data.tp.oldtuple->tuple : NULL;
+		else
+			filtertuple = change->data.tp.newtuple ?
+				&change->data.tp.newtuple->tuple : NULL;
+
+		if (filtertuple == NULL ||
+			!row_filter_matches(relentry, filtertuple))
+			return;
+	}
+
+	/* Avoid leaking memory by using and resetting our own context */
+	old = MemoryContextSwitchTo(data->context);
+
+	if (!data->xact_wrote_changes)
+	{
+		OutputPluginPrepareWrite(ctx, false);
+		logicalrep_write_begin(ctx->out, txn);
+		OutputPluginWrite(ctx, false);
+		data->xact_wrote_changes = true;
+	}
+
+	/*
+	 * Write the relation description if we have not done so since the
+	 * relation last changed.
+	 */
+	if (!relentry->schema_sent)
+	{
+		OutputPluginPrepareWrite(ctx, false);
+		logicalrep_write_rel(ctx->out, relation, relentry->columns);
+		OutputPluginWrite(ctx, false);
+		relentry->schema_sent = true;
+	}
+
+	/* Send the data */
+	switch (change->action)
+	{
+		case REORDER_BUFFER_CHANGE_INSERT:
+			if (change->data.tp.newtuple == NULL)
+				break;
+			OutputPluginPrepareWrite(ctx, true);
+			logicalrep_write_insert(ctx->out, relation,
+									&change->data.tp.newtuple->tuple,
+									relentry->columns, data->binary);
+			OutputPluginWrite(ctx, true);
+			break;
+		case REORDER_BUFFER_CHANGE_UPDATE:
+			{
+				HeapTuple	oldtuple = change->data.tp.oldtuple ?
+				&change->data.tp.oldtuple->tuple : NULL;
+
+				if (change->data.tp.newtuple == NULL)
+					break;
+				OutputPluginPrepareWrite(ctx, true);
+				logicalrep_write_update(ctx->out, relation, oldtuple,
+										&change->data.tp.newtuple->tuple,
+										relentry->columns, data->binary);
+				OutputPluginWrite(ctx, true);
+				break;
+			}
+		case REORDER_BUFFER_CHANGE_DELETE:
+			if (change->data.tp.oldtuple)
+			{
+				OutputPluginPrepareWrite(ctx, true);
+				logicalrep_write_delete(ctx->out, relation,
+										&change->data.tp.oldtuple->tuple,
+										relentry->columns, data->binary);
+				OutputPluginWrite(ctx, true);
+			}
+			else
+				elog(DEBUG1, "didn't send DELETE change because of missing oldtuple");
+			break;
+		default:
+			Assert(false);
+	}
+
+	/* Cleanup */
+	MemoryContextSwitchTo(old);
+	MemoryContextReset(data->context);
+}
+
+/*
+ * Shutdown the output plugin.
+ *
+ * Note, we don't need to clean the data->context as it's child context
+ * of the ctx->context so it will be cleaned up by logical decoding machinery.
+ */
+static void
+pgoutput_shutdown(LogicalDecodingContext *ctx)
+{
+	if (RelationSyncCache)
+	{
+		HASH_SEQ_STATUS status;
+		RelationSyncEntry *entry;
+
+		hash_seq_init(&status, RelationSyncCache);
+		while ((entry = (RelationSyncEntry *) hash_seq_search(&status)) != NULL)
+			free_rel_sync_entry_filters(entry);
+
+		hash_destroy(RelationSyncCache);
+		RelationSyncCache = NULL;
+	}
+}
+
+/*
+ * Initialize the relation schema sync cache for a decoding session.
+ *
+ * The hash table is destroyed at the end of a decoding session. While
+ * relcache invalidations still exist and will still be invoked, they
+ * will just see the null hash table global and take no action.
+ */
+static void
+init_rel_sync_cache(MemoryContext cachectx)
+{
+	HASHCTL		ctl;
+	static bool relation_callbacks_registered = false;
+
+	/* Nothing to do if hash table already exists */
+	if (RelationSyncCache != NULL)
+		return;
+
+	/* Make a new hash table for the cache */
+	MemSet(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(Oid);
+	ctl.entrysize = sizeof(RelationSyncEntry);
+	ctl.hcxt = cachectx;
+
+	RelationSyncCache = hash_create("logical replication output relation cache",
+									128, &ctl,
+									HASH_ELEM | HASH_CONTEXT | HASH_BLOBS);
+
+	Assert(RelationSyncCache != NULL);
+
+	/* No more to do if we already registered callbacks */
+	if (relation_callbacks_registered)
+		return;
+
+	CacheRegisterRelcacheCallback(rel_sync_cache_relation_cb, (Datum) 0);
+	relation_callbacks_registered = true;
+}
+
+/*
+ * Find or create the entry for the relation, deciding whether its changes
+ * are sent if that is not known yet.
+ */
+static RelationSyncEntry *
+get_rel_sync_entry(PGOutputData *data, Relation rel)
+{
+	RelationSyncEntry *entry;
+	bool		found;
+
+	Assert(RelationSyncCache != NULL);
+
+	entry = (RelationSyncEntry *) hash_search(RelationSyncCache,
+											  (void *) &RelationGetRelid(rel),
+											  HASH_ENTER, &found);
+	Assert(entry != NULL);
+
+	if (!found)
+	{
+		entry->valid = false;
+		entry->schema_sent = false;
+		entry->columns = NULL;
+		entry->estate = NULL;
+		entry->row_filter = NULL;
+		entry->slot = NULL;
+	}
+
+	if (!entry->valid)
+	{
+		/* The filters may refer to an older version of the relation */
+		free_rel_sync_entry_filters(entry);
+
+		entry->publish = false;
+
+		if (rel->rd_rel->relkind == RELKIND_RELATION)
+		{
+			char	   *nspname;
+			char	   *qualname;
+			PGOutputTableOption *opt;
+			ListCell   *lc;
+
+			nspname = get_namespace_name(RelationGetNamespace(rel));
+			qualname = quote_qualified_identifier(nspname,
+												  RelationGetRelationName(rel));
+
+			if (data->tables == NIL)
+				entry->publish = true;
+			foreach(lc, data->tables)
+			{
+				if (strcmp(qualname, (char *) lfirst(lc)) == 0)
+				{
+					entry->publish = true;
+					break;
+				}
+			}
+
+			if (entry->publish)
+			{
+				opt = find_table_option(data->columns, qualname);
+				if (opt != NULL)
+					entry->columns = build_column_set(rel, opt->value);
+
+				opt = find_table_option(data->row_filters, qualname);
+				if (opt != NULL)
+					build_row_filter(entry, rel, opt->value);
+			}
+
+			pfree(qualname);
+			pfree(nspname);
+		}
+
+		entry->valid = true;
+	}
+
+	return entry;
+}
+
+/*
+ * Release the column set and row filter of an entry.
+ */
+static void
+free_rel_sync_entry_filters(RelationSyncEntry *entry)
+{
+	if (entry->columns != NULL)
+	{
+		bms_free(entry->columns);
+		entry->columns = NULL;
+	}
+
+	if (entry->estate != NULL)
+	{
+		FreeExecutorState(entry->estate);
+		entry->estate = NULL;
+		entry->row_filter = NULL;
+		entry->slot = NULL;
+	}
+}
+
+/*
+ * Build the set of columns to send for a relation from a column list.
+ *
+ * The replica identity columns are always included, so that the receiver
+ * can identify the rows of updates and deletes.
+ */
+static Bitmapset *
+build_column_set(Relation rel, const char *value)
+{
+	Bitmapset  *columns = NULL;
+	Bitmapset  *idattrs;
+	MemoryContext oldcxt;
+	char	   *rawstring;
+	List	   *names;
+	ListCell   *lc;
+	int			i;
+
+	rawstring = pstrdup(value);
+	if (!SplitIdentifierString(rawstring, ',', &names))
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("invalid column list for table \"%s\": \"%s\"",
+						RelationGetRelationName(rel), value)));
+
+	oldcxt = MemoryContextSwitchTo(CacheMemoryContext);
+
+	foreach(lc, names)
+	{
+		char	   *name = (char *) lfirst(lc);
+		AttrNumber	attnum = get_attnum(RelationGetRelid(rel), name);
+
+		if (attnum <= 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_UNDEFINED_COLUMN),
+					 errmsg("column \"%s\" of relation \"%s\" does not exist",
+							name, RelationGetRelationName(rel))));
+
+		columns = bms_add_member(columns, attnum);
+	}
+
+	idattrs = RelationGetIndexAttrBitmap(rel, INDEX_ATTR_BITMAP_IDENTITY_KEY);
+	i = -1;
+	while ((i = bms_next_member(idattrs, i)) >= 0)
+		columns = bms_add_member(columns,
+								 i + FirstLowInvalidHeapAttributeNumber);
+
+	MemoryContextSwitchTo(oldcxt);
+
+	bms_free(idattrs);
+	list_free(names);
+	pfree(rawstring);
+
+	return columns;
+}
+
+/*
+ * Parse the row filter expression of a relation and prepare it for
+ * execution.
+ */
+static void
+build_row_filter(RelationSyncEntry *entry, Relation rel, const char *value)
+{
+	MemoryContext oldcxt;
+	List	   *raw_parsetree_list;
+	SelectStmt *stmt;
+	ResTarget  *restarget;
+	ParseState *pstate;
+	RangeTblEntry *rte;
+	Node	   *expr;
+
+	oldcxt = MemoryContextSwitchTo(CacheMemoryContext);
+	entry->estate = CreateExecutorState();
+	MemoryContextSwitchTo(entry->estate->es_query_cxt);
+
+	/* Parse the expression as the target list of a SELECT */
+	raw_parsetree_list = raw_parser(psprintf("SELECT %s", value));
+	if (list_length(raw_parsetree_list) != 1)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("invalid row filter for table \"%s\": \"%s\"",
+						RelationGetRelationName(rel), value)));
+	stmt = (SelectStmt *) linitial(raw_parsetree_list);
+	if (!IsA(stmt, SelectStmt) ||
+		list_length(stmt->targetList) != 1 ||
+		stmt->distinctClause != NIL ||
+		stmt->fromClause != NIL ||
+		stmt->whereClause != NULL ||
+		stmt->groupClause != NIL ||
+		stmt->havingClause != NULL ||
+		stmt->windowClause != NIL ||
+		stmt->sortClause != NIL ||
+		stmt->limitCount != NULL ||
+		stmt->limitOffset != NULL ||
+		stmt->lockingClause != NIL ||
+		stmt->withClause != NULL ||
+		stmt->op != SETOP_NONE)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("invalid row filter for table \"%s\": \"%s\"",
+						RelationGetRelationName(rel), value)));
+	restarget = (ResTarget *) linitial(stmt->targetList);
+
+	pstate = make_parsestate(NULL);
+	rte = addRangeTableEntryForRelation(pstate, rel, NULL, false, false);
+	addRTEtoQuery(pstate, rte, false, true, true);
+
+	expr = transformExpr(pstate, restarget->val, EXPR_KIND_WHERE);
+	expr = coerce_to_boolean(pstate, expr, "row_filter");
+	assign_expr_collations(pstate, expr);
+
+	if (pstate->p_hasSubLinks)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("cannot use subquery in row filter")));
+
+	/* Only immutable functions are safe to run while decoding */
+	if (contain_mutable_functions(expr))
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_OBJECT_DEFINITION),
+				 errmsg("functions in row filter must be marked IMMUTABLE")));
+
+	free_parsestate(pstate);
+
+	entry->row_filter = ExecInitExpr(expression_planner((Expr *) expr), NULL);
+	entry->slot = MakeSingleTupleTableSlot(CreateTupleDescCopy(RelationGetDescr(rel)));
+
+	MemoryContextSwitchTo(oldcxt);
+}
+
+/*
+ * Does the row satisfy the row filter of its relation?
+ */
+static bool
+row_filter_matches(RelationSyncEntry *entry, HeapTuple tuple)
+{
+	ExprContext *econtext;
+	Datum		result;
+	bool		isnull;
+
+	ExecStoreTuple(tuple, entry->slot, InvalidBuffer, false);
+
+	econtext = GetPerTupleExprContext(entry->estate);
+	econtext->ecxt_scantuple = entry->slot;
+
+	result = ExecEvalExprSwitchContext(entry->row_filter, econtext,
+									   &isnull, NULL);
+
+	ResetExprContext(econtext);
+	ExecClearTuple(entry->slot);
+
+	return !isnull && DatumGetBool(result);
+}
+
+/*
+ * Relcache invalidation callback
+ */
+static void
+rel_sync_cache_relation_cb(Datum arg, Oid relid)
+{
+	RelationSyncEntry *entry;
+
+	/*
+	 * We can get here if the plugin was used by SQL interface as the
+	 * RelationSyncCache is destroyed when the decoding finishes, but there is
+	 * no way to unregister the relcache invalidation callback.
+	 */
+	if (RelationSyncCache == NULL)
+		return;
+
+	if (OidIsValid(relid))
+	{
+		entry = (RelationSyncEntry *) hash_search(RelationSyncCache, &relid,
+												  HASH_FIND, NULL);
+		if (entry != NULL)
+		{
+			entry->valid = false;
+			entry->schema_sent = false;
+		}
+	}
+	else
+	{
+		HASH_SEQ_STATUS status;
+
+		/* Whole cache reset: forget everything we know. */
+		hash_seq_init(&status, RelationSyncCache);
+		while ((entry = (RelationSyncEntry *) hash_seq_search(&status)) != NULL)
+		{
+			entry->valid = false;
+			entry->schema_sent = false;
+		}
+	}
+}
@@ -72,6 +72,9 @@ Node *replication_parse_result;
 %token K_MAX_RATE
 %token K_WAL
 %token K_TABLESPACE_MAP
+%token K_COMPRESSION
+%token K_PARALLEL
+%token K_INCREMENTAL
 %token K_TIMELINE
 %token K_PHYSICAL
 %token K_LOGICAL
@@ -123,7 +126,8 @@ identify_system:
 
 /*
  * BASE_BACKUP [LABEL '<label>'] [PROGRESS] [FAST] [WAL] [NOWAIT]
- * [MAX_RATE %d] [TABLESPACE_MAP]
+ * [MAX_RATE %d] [TABLESPACE_MAP] [COMPRESSION %d] [PARALLEL %d]
+ * [INCREMENTAL %X/%X]
  */
 base_backup:
 			K_BASE_BACKUP base_backup_opt_list
@@ -178,6 +182,22 @@ base_backup_opt:
 				  $$ = makeDefElem("tablespace_map",
 								   (Node *)makeInteger(TRUE));
 				}
+			| K_COMPRESSION UCONST
+				{
+				  $$ = makeDefElem("compression",
+								   (Node *)makeInteger($2));
+				}
+			| K_PARALLEL UCONST
+				{
+				  $$ = makeDefElem("parallel",
+								   (Node *)makeInteger($2));
+				}
+			| K_INCREMENTAL RECPTR
+				{
+				  $$ = makeDefElem("incremental",
+								   (Node *)makeString(psprintf("%X/%X",
+										(uint32) ($2 >> 32), (uint32) $2)));
+				}
 			;
 
 create_replication_slot:
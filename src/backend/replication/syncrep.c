@@ -21,19 +21,29 @@
  *
  * Replication is either synchronous or not synchronous (async). If it is
  * async, we just fastpath out of here. If it is sync, then we wait for
- * the write or flush location on the standby before releasing the waiting
- * backend. Further complexity in that interaction is expected in later
- * releases.
+ * the write, flush or apply location on the standby before releasing the
+ * waiting backend.
  *
  * The best performing way to manage the waiting backends is to have a
  * single ordered queue of waiting backends, so that we can avoid
  * searching the through all waiters each time we receive a reply.
  *
- * In 9.1 we support only a single synchronous standby, chosen from a
- * priority list of synchronous_standby_names. Before it can become the
- * synchronous standby it must have caught up with the primary; that may
- * take some time. Once caught up, the current highest priority standby
- * will release waiters from the queue.
+ * synchronous_standby_names chooses the standbys in one of two ways:
+ *
+ * In priority mode ("FIRST n (list)", or just a plain list, meaning n = 1)
+ * the n highest priority standbys that are streaming are synchronous, and a
+ * commit is released once all of them have confirmed it. Before a standby
+ * can become synchronous it must have caught up with the primary; that may
+ * take some time.
+ *
+ * In quorum mode ("ANY n (list)") every listed standby that is streaming is
+ * a candidate, and a commit is released once any n of them have confirmed
+ * it, so that a single slow standby doesn't hold up commits.
+ *
+ * In either mode, whichever walsender receives a reply that advances the
+ * release position wakes up the waiters up to that position.  The waiters
+ * are queued in LSN order, so that only the backends actually being released
+ * are visited.
  *
  * Portions Copyright (c) 2010-2015, PostgreSQL Global Development Group
  *
@@ -44,6 +54,7 @@
  */
 #include "postgres.h"
 
+#include <ctype.h>
 #include <unistd.h>
 
 #include "access/xact.h"
@@ -59,6 +70,7 @@
 
 /* User-settable parameters for sync rep */
 char	   *SyncRepStandbyNames;
+SyncRepConfigData *SyncRepConfig = NULL;
 
 #define SyncStandbysDefined() \
 	(SyncRepStandbyNames != NULL && SyncRepStandbyNames[0] != '\0')
@@ -71,6 +83,27 @@ static void SyncRepQueueInsert(int mode);
 static void SyncRepCancelWait(void);
 static int	SyncRepWakeQueue(bool all, int mode);
 
+/*
+ * Copy of the state of one walsender that may currently be used to release
+ * waiters, taken while holding SyncRepLock.
+ */
+typedef struct SyncRepStandbyData
+{
+	int			walsnd_index;	/* index into WalSndCtl->walsnds */
+	int			priority;		/* sync_standby_priority of the walsender */
+	XLogRecPtr	write;
+	XLogRecPtr	flush;
+	XLogRecPtr	apply;
+} SyncRepStandbyData;
+
+static int	SyncRepGetCandidateStandbys(SyncRepStandbyData *cands);
+static int	SyncRepGetPriorityStandbys(SyncRepStandbyData *cands, int ncands);
+static bool SyncRepGetSyncRecPtr(XLogRecPtr *writePtr, XLogRecPtr *flushPtr,
+					 XLogRecPtr *applyPtr, bool *am_sync);
+static XLogRecPtr SyncRepNthLatestRecPtr(XLogRecPtr *ptrs, int nptrs, int nth);
+static int	standby_priority_cmp(const void *a, const void *b);
+static int	recptr_desc_cmp(const void *a, const void *b);
+
 static int	SyncRepGetStandbyPriority(void);
 
 #ifdef USE_ASSERT_CHECKING
@@ -349,73 +382,252 @@ SyncRepInitConfig(void)
 }
 
 /*
- * Find the WAL sender servicing the synchronous standby with the lowest
- * priority value, or NULL if no synchronous standby is connected. If there
- * are multiple standbys with the same lowest priority value, the first one
- * found is selected. The caller must hold SyncRepLock.
+ * Collect the walsenders that are currently able to act as synchronous
+ * standbys: active, streaming, listed in synchronous_standby_names and with
+ * a valid flush position.  The caller must hold SyncRepLock, and cands must
+ * have room for max_wal_senders entries.  Returns the number found.
  */
-WalSnd *
-SyncRepGetSynchronousStandby(void)
+static int
+SyncRepGetCandidateStandbys(SyncRepStandbyData *cands)
 {
-	WalSnd	   *result = NULL;
-	int			result_priority = 0;
+	int			ncands = 0;
 	int			i;
 
 	for (i = 0; i < max_wal_senders; i++)
 	{
 		/* Use volatile pointer to prevent code rearrangement */
 		volatile WalSnd *walsnd = &WalSndCtl->walsnds[i];
-		int			this_priority;
+		SyncRepStandbyData *cand = &cands[ncands];
+		pid_t		pid;
+		WalSndState state;
+
+		SpinLockAcquire(&walsnd->mutex);
+		pid = walsnd->pid;
+		state = walsnd->state;
+		cand->write = walsnd->write;
+		cand->flush = walsnd->flush;
+		cand->apply = walsnd->apply;
+		SpinLockRelease(&walsnd->mutex);
 
 		/* Must be active */
-		if (walsnd->pid == 0)
+		if (pid == 0)
 			continue;
 
 		/* Must be streaming */
-		if (walsnd->state != WALSNDSTATE_STREAMING)
+		if (state != WALSNDSTATE_STREAMING)
 			continue;
 
 		/* Must be synchronous */
-		this_priority = walsnd->sync_standby_priority;
-		if (this_priority == 0)
-			continue;
-
-		/* Must have a lower priority value than any previous ones */
-		if (result != NULL && result_priority <= this_priority)
+		cand->priority = walsnd->sync_standby_priority;
+		if (cand->priority == 0)
 			continue;
 
 		/* Must have a valid flush position */
-		if (XLogRecPtrIsInvalid(walsnd->flush))
+		if (XLogRecPtrIsInvalid(cand->flush))
 			continue;
 
-		result = (WalSnd *) walsnd;
-		result_priority = this_priority;
+		cand->walsnd_index = i;
+		ncands++;
+	}
+
+	return ncands;
+}
 
-		/*
-		 * If priority is equal to 1, there cannot be any other WAL senders
-		 * with a lower priority, so we're done.
-		 */
-		if (this_priority == 1)
-			return result;
+/*
+ * In priority mode, reorder the candidates so that the synchronous standbys
+ * come first, and return how many of them there are.  Candidates with the
+ * same priority value (for instance because they matched the same "*") are
+ * taken in walsender slot order.
+ */
+static int
+SyncRepGetPriorityStandbys(SyncRepStandbyData *cands, int ncands)
+{
+	qsort(cands, ncands, sizeof(SyncRepStandbyData), standby_priority_cmp);
+
+	return Min(ncands, SyncRepConfig->num_sync);
+}
+
+/*
+ * Return the list of walsnd indexes of the standbys that are currently
+ * synchronous.  In quorum mode, that's every candidate.  *am_sync is set to
+ * whether this process's walsender is among them.
+ *
+ * The caller must hold SyncRepLock.
+ */
+List *
+SyncRepGetSyncStandbys(bool *am_sync)
+{
+	SyncRepStandbyData *cands;
+	int			ncands;
+	int			nsync;
+	List	   *result = NIL;
+	int			i;
+
+	*am_sync = false;
+
+	if (SyncRepConfig == NULL)
+		return NIL;
+
+	cands = (SyncRepStandbyData *)
+		palloc(max_wal_senders * sizeof(SyncRepStandbyData));
+	ncands = SyncRepGetCandidateStandbys(cands);
+
+	if (SyncRepConfig->syncrep_method == SYNC_REP_PRIORITY)
+		nsync = SyncRepGetPriorityStandbys(cands, ncands);
+	else
+		nsync = ncands;
+
+	for (i = 0; i < nsync; i++)
+	{
+		result = lappend_int(result, cands[i].walsnd_index);
+		if (MyWalSnd != NULL &&
+			&WalSndCtl->walsnds[cands[i].walsnd_index] == MyWalSnd)
+			*am_sync = true;
 	}
 
+	pfree(cands);
+
 	return result;
 }
 
 /*
- * Update the LSNs on each queue based upon our latest state. This
- * implements a simple policy of first-valid-standby-releases-waiter.
+ * Calculate the write, flush and apply positions up to which all waiters can
+ * be released, based on the positions reported by the synchronous standbys.
+ *
+ * In priority mode that is the oldest position among the synchronous
+ * standbys, and only the walsenders of those standbys release waiters, so
+ * *am_sync is set to whether we're one of them.  In quorum mode it is the
+ * num_sync'th latest position among all candidates, and any of them may
+ * release waiters.
  *
- * Other policies are possible, which would change what we do here and what
- * perhaps also which information we store as well.
+ * Returns false if not enough standbys are connected to release anything.
+ * The caller must hold SyncRepLock.
+ */
+static bool
+SyncRepGetSyncRecPtr(XLogRecPtr *writePtr, XLogRecPtr *flushPtr,
+					 XLogRecPtr *applyPtr, bool *am_sync)
+{
+	SyncRepStandbyData *cands;
+	int			ncands;
+	int			num_sync = SyncRepConfig->num_sync;
+	int			i;
+
+	*writePtr = InvalidXLogRecPtr;
+	*flushPtr = InvalidXLogRecPtr;
+	*applyPtr = InvalidXLogRecPtr;
+	*am_sync = false;
+
+	cands = (SyncRepStandbyData *)
+		palloc(max_wal_senders * sizeof(SyncRepStandbyData));
+	ncands = SyncRepGetCandidateStandbys(cands);
+
+	if (ncands < num_sync)
+	{
+		pfree(cands);
+		return false;
+	}
+
+	if (SyncRepConfig->syncrep_method == SYNC_REP_PRIORITY)
+	{
+		int			nsync = SyncRepGetPriorityStandbys(cands, ncands);
+
+		for (i = 0; i < nsync; i++)
+		{
+			if (&WalSndCtl->walsnds[cands[i].walsnd_index] == MyWalSnd)
+				*am_sync = true;
+
+			if (i == 0 || cands[i].write < *writePtr)
+				*writePtr = cands[i].write;
+			if (i == 0 || cands[i].flush < *flushPtr)
+				*flushPtr = cands[i].flush;
+			if (i == 0 || cands[i].apply < *applyPtr)
+				*applyPtr = cands[i].apply;
+		}
+	}
+	else
+	{
+		XLogRecPtr *ptrs = (XLogRecPtr *) palloc(ncands * sizeof(XLogRecPtr));
+
+		*am_sync = true;
+
+		for (i = 0; i < ncands; i++)
+			ptrs[i] = cands[i].write;
+		*writePtr = SyncRepNthLatestRecPtr(ptrs, ncands, num_sync);
+		for (i = 0; i < ncands; i++)
+			ptrs[i] = cands[i].flush;
+		*flushPtr = SyncRepNthLatestRecPtr(ptrs, ncands, num_sync);
+		for (i = 0; i < ncands; i++)
+			ptrs[i] = cands[i].apply;
+		*applyPtr = SyncRepNthLatestRecPtr(ptrs, ncands, num_sync);
+
+		pfree(ptrs);
+	}
+
+	pfree(cands);
+
+	return true;
+}
+
+/*
+ * Return the nth latest of the given positions, i.e. the latest position
+ * that at least nth of them have reached.
+ */
+static XLogRecPtr
+SyncRepNthLatestRecPtr(XLogRecPtr *ptrs, int nptrs, int nth)
+{
+	Assert(nth >= 1 && nth <= nptrs);
+
+	qsort(ptrs, nptrs, sizeof(XLogRecPtr), recptr_desc_cmp);
+
+	return ptrs[nth - 1];
+}
+
+/*
+ * qsort comparator to sort SyncRepStandbyData entries by priority, then by
+ * walsender slot.
+ */
+static int
+standby_priority_cmp(const void *a, const void *b)
+{
+	const SyncRepStandbyData *sa = (const SyncRepStandbyData *) a;
+	const SyncRepStandbyData *sb = (const SyncRepStandbyData *) b;
+
+	if (sa->priority != sb->priority)
+		return (sa->priority < sb->priority) ? -1 : 1;
+
+	return sa->walsnd_index - sb->walsnd_index;
+}
+
+/*
+ * qsort comparator to sort XLogRecPtrs in descending order.
+ */
+static int
+recptr_desc_cmp(const void *a, const void *b)
+{
+	XLogRecPtr	ra = *(const XLogRecPtr *) a;
+	XLogRecPtr	rb = *(const XLogRecPtr *) b;
+
+	if (ra == rb)
+		return 0;
+	return (ra > rb) ? -1 : 1;
+}
+
+/*
+ * Update the LSNs on each queue based upon our latest state, and release
+ * the waiters that are now satisfied.
  */
 void
 SyncRepReleaseWaiters(void)
 {
 	volatile WalSndCtlData *walsndctl = WalSndCtl;
-	WalSnd	   *syncWalSnd;
+	XLogRecPtr	writePtr;
+	XLogRecPtr	flushPtr;
+	XLogRecPtr	applyPtr;
+	bool		got_recptr;
+	bool		am_sync;
 	int			numwrite = 0;
 	int			numflush = 0;
+	int			numapply = 0;
 
 	/*
 	 * If this WALSender is serving a standby that is not on the list of
@@ -425,26 +637,41 @@ SyncRepReleaseWaiters(void)
 	 */
 	if (MyWalSnd->sync_standby_priority == 0 ||
 		MyWalSnd->state < WALSNDSTATE_STREAMING ||
-		XLogRecPtrIsInvalid(MyWalSnd->flush))
+		XLogRecPtrIsInvalid(MyWalSnd->flush) ||
+		SyncRepConfig == NULL)
+	{
+		announce_next_takeover = true;
 		return;
+	}
 
 	/*
-	 * We're a potential sync standby. Release waiters if we are the highest
-	 * priority standby.
+	 * If none of our positions is ahead of what has already been released,
+	 * this reply can't allow releasing anything more: in either mode, the
+	 * release position only moves past a point once the standby whose reply
+	 * we're processing has passed it, too.  Most replies are like that when
+	 * several standbys are connected, so skip taking the lock for them.  An
+	 * unlocked read is OK here, as the released positions only ever advance.
 	 */
-	LWLockAcquire(SyncRepLock, LW_EXCLUSIVE);
-	syncWalSnd = SyncRepGetSynchronousStandby();
+	if (MyWalSnd->write <= walsndctl->lsn[SYNC_REP_WAIT_WRITE] &&
+		MyWalSnd->flush <= walsndctl->lsn[SYNC_REP_WAIT_FLUSH] &&
+		MyWalSnd->apply <= walsndctl->lsn[SYNC_REP_WAIT_APPLY])
+		return;
 
-	/* We should have found ourselves at least */
-	Assert(syncWalSnd != NULL);
+	/*
+	 * We're a potential sync standby. Release waiters if enough standbys
+	 * have caught up, and, in priority mode, we are one of the synchronous
+	 * ones.
+	 */
+	LWLockAcquire(SyncRepLock, LW_EXCLUSIVE);
+	got_recptr = SyncRepGetSyncRecPtr(&writePtr, &flushPtr, &applyPtr, &am_sync);
 
 	/*
-	 * If we aren't managing the highest priority standby then just leave.
+	 * If we aren't managing one of the synchronous standbys then just leave.
 	 */
-	if (syncWalSnd != MyWalSnd)
+	if (!got_recptr || !am_sync)
 	{
 		LWLockRelease(SyncRepLock);
-		announce_next_takeover = true;
+		announce_next_takeover = !am_sync;
 		return;
 	}
 
@@ -452,33 +679,45 @@ SyncRepReleaseWaiters(void)
 	 * Set the lsn first so that when we wake backends they will release up to
 	 * this location.
 	 */
-	if (walsndctl->lsn[SYNC_REP_WAIT_WRITE] < MyWalSnd->write)
+	if (walsndctl->lsn[SYNC_REP_WAIT_WRITE] < writePtr)
 	{
-		walsndctl->lsn[SYNC_REP_WAIT_WRITE] = MyWalSnd->write;
+		walsndctl->lsn[SYNC_REP_WAIT_WRITE] = writePtr;
 		numwrite = SyncRepWakeQueue(false, SYNC_REP_WAIT_WRITE);
 	}
-	if (walsndctl->lsn[SYNC_REP_WAIT_FLUSH] < MyWalSnd->flush)
+	if (walsndctl->lsn[SYNC_REP_WAIT_FLUSH] < flushPtr)
 	{
-		walsndctl->lsn[SYNC_REP_WAIT_FLUSH] = MyWalSnd->flush;
+		walsndctl->lsn[SYNC_REP_WAIT_FLUSH] = flushPtr;
 		numflush = SyncRepWakeQueue(false, SYNC_REP_WAIT_FLUSH);
 	}
+	if (walsndctl->lsn[SYNC_REP_WAIT_APPLY] < applyPtr)
+	{
+		walsndctl->lsn[SYNC_REP_WAIT_APPLY] = applyPtr;
+		numapply = SyncRepWakeQueue(false, SYNC_REP_WAIT_APPLY);
+	}
 
 	LWLockRelease(SyncRepLock);
 
-	elog(DEBUG3, "released %d procs up to write %X/%X, %d procs up to flush %X/%X",
-		 numwrite, (uint32) (MyWalSnd->write >> 32), (uint32) MyWalSnd->write,
-	   numflush, (uint32) (MyWalSnd->flush >> 32), (uint32) MyWalSnd->flush);
+	elog(DEBUG3, "released %d procs up to write %X/%X, %d procs up to flush %X/%X, %d procs up to apply %X/%X",
+		 numwrite, (uint32) (writePtr >> 32), (uint32) writePtr,
+		 numflush, (uint32) (flushPtr >> 32), (uint32) flushPtr,
+		 numapply, (uint32) (applyPtr >> 32), (uint32) applyPtr);
 
 	/*
-	 * If we are managing the highest priority standby, though we weren't
-	 * prior to this, then announce we are now the sync standby.
+	 * If we are managing a sync standby, though we weren't prior to this,
+	 * then announce we are now a sync standby.
 	 */
 	if (announce_next_takeover)
 	{
 		announce_next_takeover = false;
-		ereport(LOG,
-				(errmsg("standby \"%s\" is now the synchronous standby with priority %u",
-						application_name, MyWalSnd->sync_standby_priority)));
+
+		if (SyncRepConfig->syncrep_method == SYNC_REP_PRIORITY)
+			ereport(LOG,
+					(errmsg("standby \"%s\" is now a synchronous standby with priority %u",
+							application_name, MyWalSnd->sync_standby_priority)));
+		else
+			ereport(LOG,
+					(errmsg("standby \"%s\" is now a candidate for quorum synchronous standby",
+							application_name)));
 	}
 }
 
@@ -493,10 +732,8 @@ SyncRepReleaseWaiters(void)
 static int
 SyncRepGetStandbyPriority(void)
 {
-	char	   *rawstring;
-	List	   *elemlist;
-	ListCell   *l;
-	int			priority = 0;
+	const char *standby_name;
+	int			priority;
 	bool		found = false;
 
 	/*
@@ -506,36 +743,21 @@ SyncRepGetStandbyPriority(void)
 	if (am_cascading_walsender)
 		return 0;
 
-	/* Need a modifiable copy of string */
-	rawstring = pstrdup(SyncRepStandbyNames);
-
-	/* Parse string into list of identifiers */
-	if (!SplitIdentifierString(rawstring, ',', &elemlist))
-	{
-		/* syntax error in list */
-		pfree(rawstring);
-		list_free(elemlist);
-		/* GUC machinery will have already complained - no need to do again */
+	if (!SyncStandbysDefined() || SyncRepConfig == NULL)
 		return 0;
-	}
 
-	foreach(l, elemlist)
+	standby_name = SyncRepConfig->member_names;
+	for (priority = 1; priority <= SyncRepConfig->nmembers; priority++)
 	{
-		char	   *standby_name = (char *) lfirst(l);
-
-		priority++;
-
 		if (pg_strcasecmp(standby_name, application_name) == 0 ||
 			pg_strcasecmp(standby_name, "*") == 0)
 		{
 			found = true;
 			break;
 		}
+		standby_name += strlen(standby_name) + 1;
 	}
 
-	pfree(rawstring);
-	list_free(elemlist);
-
 	return (found ? priority : 0);
 }
 
@@ -684,25 +906,131 @@ SyncRepQueueIsOrderedByLSN(int mode)
  * ===========================================================
  */
 
-bool
-check_synchronous_standby_names(char **newval, void **extra, GucSource source)
+/*
+ * Parse the value of synchronous_standby_names, which is one of
+ *
+ *		standby_name [, ...]
+ *		[FIRST] num_sync ( standby_name [, ...] )
+ *		ANY num_sync ( standby_name [, ...] )
+ *
+ * The first form is the same as FIRST 1 (...).  A leading keyword or number
+ * is only recognized as such when followed by a parenthesized list, so plain
+ * lists of standby names keep working whatever the names are.
+ *
+ * On success, *names is set to the list of names, which point into *rawstring,
+ * a palloc'd copy of value.  On failure, an error detail has been set.
+ */
+static bool
+SyncRepParseStandbyNames(const char *value, int *num_sync, uint8 *method,
+						 char **rawstring, List **names)
 {
-	char	   *rawstring;
-	List	   *elemlist;
+	const char *p = value;
+	const char *q;
+	const char *list_start = value;
+	const char *list_end = value + strlen(value);
+
+	*num_sync = 1;
+	*method = SYNC_REP_PRIORITY;
+	*names = NIL;
+
+	while (isspace((unsigned char) *p))
+		p++;
+
+	/* Check for an optional method keyword, then the number */
+	q = p;
+	if (pg_strncasecmp(q, "ANY", 3) == 0 && isspace((unsigned char) q[3]))
+		q += 3;
+	else if (pg_strncasecmp(q, "FIRST", 5) == 0 && isspace((unsigned char) q[5]))
+		q += 5;
+	while (isspace((unsigned char) *q))
+		q++;
+
+	if (isdigit((unsigned char) *q))
+	{
+		const char *numstart = q;
+		const char *end;
+
+		while (isdigit((unsigned char) *q))
+			q++;
+		end = q;
+		while (isspace((unsigned char) *q))
+			q++;
+
+		if (*q == '(')
+		{
+			long		n;
+
+			/* It's the parenthesized form; the list must end with ')' */
+			while (list_end > q && isspace((unsigned char) list_end[-1]))
+				list_end--;
+			if (list_end[-1] != ')' || list_end - 1 == q)
+			{
+				GUC_check_errdetail("List of standby names must be terminated by \")\".");
+				return false;
+			}
+
+			n = strtol(numstart, NULL, 10);
+			if (end - numstart > 9 || n < 1)
+			{
+				GUC_check_errdetail("Number of synchronous standbys (%.*s) must be greater than zero.",
+									(int) (end - numstart), numstart);
+				return false;
+			}
+
+			*num_sync = (int) n;
+			if (pg_strncasecmp(p, "ANY", 3) == 0 && p != numstart)
+				*method = SYNC_REP_QUORUM;
+			list_start = q + 1;
+			list_end--;
+		}
+	}
 
-	/* Need a modifiable copy of string */
-	rawstring = pstrdup(*newval);
+	/* Need a modifiable copy of the list */
+	*rawstring = pnstrdup(list_start, list_end - list_start);
 
 	/* Parse string into list of identifiers */
-	if (!SplitIdentifierString(rawstring, ',', &elemlist))
+	if (!SplitIdentifierString(*rawstring, ',', names))
 	{
 		/* syntax error in list */
 		GUC_check_errdetail("List syntax is invalid.");
-		pfree(rawstring);
+		return false;
+	}
+
+	return true;
+}
+
+bool
+check_synchronous_standby_names(char **newval, void **extra, GucSource source)
+{
+	char	   *rawstring = NULL;
+	List	   *elemlist = NIL;
+	int			num_sync;
+	uint8		method;
+	bool		has_wildcard = false;
+	SyncRepConfigData *config;
+	Size		size;
+	char	   *ptr;
+	ListCell   *l;
+
+	if (!SyncRepParseStandbyNames(*newval, &num_sync, &method,
+								  &rawstring, &elemlist))
+	{
+		if (rawstring)
+			pfree(rawstring);
 		list_free(elemlist);
 		return false;
 	}
 
+	size = offsetof(SyncRepConfigData, member_names);
+	foreach(l, elemlist)
+	{
+		char	   *standby_name = (char *) lfirst(l);
+
+		if (strcmp(standby_name, "*") == 0)
+			has_wildcard = true;
+		size += strlen(standby_name) + 1;
+	}
+
 	/*
 	 * Any additional validation of standby names should go here.
 	 *
@@ -710,6 +1038,36 @@ check_synchronous_standby_names(char **newval, void **extra, GucSource source)
 	 * postmaster at startup, not WALSender, so the application_name is not
 	 * yet correctly set.
 	 */
+	if (elemlist != NIL && !has_wildcard && num_sync > list_length(elemlist))
+	{
+		GUC_check_errdetail("Number of synchronous standbys (%d) must not exceed the number of standby names (%d).",
+							num_sync, list_length(elemlist));
+		pfree(rawstring);
+		list_free(elemlist);
+		return false;
+	}
+
+	/* Flatten the parsed form into the GUC's extra data */
+	config = (SyncRepConfigData *) malloc(size);
+	if (!config)
+	{
+		pfree(rawstring);
+		list_free(elemlist);
+		return false;
+	}
+	config->config_size = size;
+	config->num_sync = num_sync;
+	config->syncrep_method = method;
+	config->nmembers = list_length(elemlist);
+	ptr = config->member_names;
+	foreach(l, elemlist)
+	{
+		char	   *standby_name = (char *) lfirst(l);
+
+		strcpy(ptr, standby_name);
+		ptr += strlen(standby_name) + 1;
+	}
+	*extra = (void *) config;
 
 	pfree(rawstring);
 	list_free(elemlist);
@@ -717,6 +1075,12 @@ check_synchronous_standby_names(char **newval, void **extra, GucSource source)
 	return true;
 }
 
+void
+assign_synchronous_standby_names(const char *newval, void *extra)
+{
+	SyncRepConfig = (SyncRepConfigData *) extra;
+}
+
 void
 assign_synchronous_commit(int newval, void *extra)
 {
@@ -728,6 +1092,9 @@ assign_synchronous_commit(int newval, void *extra)
 		case SYNCHRONOUS_COMMIT_REMOTE_FLUSH:
 			SyncRepWaitMode = SYNC_REP_WAIT_FLUSH;
 			break;
+		case SYNCHRONOUS_COMMIT_REMOTE_APPLY:
+			SyncRepWaitMode = SYNC_REP_WAIT_APPLY;
+			break;
 		default:
 			SyncRepWaitMode = SYNC_REP_NO_WAIT;
 			break;
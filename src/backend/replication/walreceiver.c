@@ -77,6 +77,8 @@ walrcv_readtimelinehistoryfile_type walrcv_readtimelinehistoryfile = NULL;
 walrcv_receive_type walrcv_receive = NULL;
 walrcv_send_type walrcv_send = NULL;
 walrcv_disconnect_type walrcv_disconnect = NULL;
+walrcv_connect_logical_type walrcv_connect_logical = NULL;
+walrcv_startstreaming_logical_type walrcv_startstreaming_logical = NULL;
 
 #define NAPTIME_PER_CYCLE 100	/* max sleep time between cycles (100ms) */
 
@@ -404,6 +406,26 @@ WalReceiverMain(void)
 					XLogWalRcvSendHSFeedback(true);
 				}
 
+				/*
+				 * The startup process sets our latch when it wants a reply
+				 * sent right away, which also interrupts the wait for data
+				 * below.  Reset it before checking, so that a request made
+				 * after this point isn't missed.
+				 */
+				ResetLatch(&walrcv->latch);
+				if (walrcv->force_reply)
+				{
+					/*
+					 * The recovery process has asked us to send apply
+					 * feedback now.  Make sure the flag is really set to
+					 * false in shared memory before sending the reply, so we
+					 * don't miss a new request for a reply.
+					 */
+					walrcv->force_reply = false;
+					pg_memory_barrier();
+					XLogWalRcvSendReply(true, false);
+				}
+
 				/* Wait a while for data to arrive */
 				len = walrcv_receive(NAPTIME_PER_CYCLE, &buf);
 				if (len != 0)
@@ -1088,6 +1110,22 @@ XLogWalRcvSendReply(bool force, bool requestReply)
 	walrcv_send(reply_message.data, reply_message.len);
 }
 
+/*
+ * Wake up the walreceiver main loop.
+ *
+ * This is called by the startup process whenever interesting xlog records
+ * are applied, so that walreceiver can check if it needs to send an apply
+ * notification back to the master which may be waiting in a COMMIT with
+ * synchronous_commit = remote_apply.
+ */
+void
+WalRcvForceReply(void)
+{
+	WalRcv->force_reply = true;
+	pg_memory_barrier();
+	SetLatch(&WalRcv->latch);
+}
+
 /*
  * Send hot standby feedback message to primary, plus the current time,
  * in case they don't have a watch.
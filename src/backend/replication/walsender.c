@@ -91,6 +91,14 @@
  */
 #define MAX_SEND_SIZE (XLOG_BLCKSZ * 16)
 
+/*
+ * When the standby is far behind, for instance while catching up after a
+ * reconnect, the per-message overhead dominates, so we then send up to a
+ * quarter of the backlog per message, but never more than this.  2MB (with
+ * default 8k blocks) still takes only milliseconds to read and queue.
+ */
+#define MAX_SEND_BATCH_SIZE (MAX_SEND_SIZE * 16)
+
 /* Array of WalSnds in shared memory */
 WalSndCtlData *WalSndCtl = NULL;
 
@@ -2159,7 +2167,7 @@ retry:
 /*
  * Send out the WAL in its normal physical/stored form.
  *
- * Read up to MAX_SEND_SIZE bytes of WAL that's been flushed to disk,
+ * Read up to MAX_SEND_BATCH_SIZE bytes of WAL that's been flushed to disk,
  * but not yet sent to the client, and buffer it in the libpq output
  * buffer.
  *
@@ -2172,7 +2180,9 @@ XLogSendPhysical(void)
 	XLogRecPtr	SendRqstPtr;
 	XLogRecPtr	startptr;
 	XLogRecPtr	endptr;
+	uint64		batchsize;
 	Size		nbytes;
+	Size		frombuffers = 0;
 
 	if (streamingDoneSending)
 	{
@@ -2311,8 +2321,10 @@ XLogSendPhysical(void)
 
 	/*
 	 * Figure out how much to send in one message. If there's no more than
-	 * MAX_SEND_SIZE bytes to send, send everything. Otherwise send
-	 * MAX_SEND_SIZE bytes, but round back to logfile or page boundary.
+	 * MAX_SEND_SIZE bytes to send, send everything. Otherwise send a batch
+	 * of between MAX_SEND_SIZE and MAX_SEND_BATCH_SIZE bytes, depending on
+	 * how far behind the standby is, but round back to logfile or page
+	 * boundary.
 	 *
 	 * The rounding is not only for performance reasons. Walreceiver relies on
 	 * the fact that we never split a WAL record across two messages. Since a
@@ -2321,8 +2333,11 @@ XLogSendPhysical(void)
 	 * SendRqstPtr never points to the middle of a WAL record.
 	 */
 	startptr = sentPtr;
+	batchsize = (SendRqstPtr - startptr) / 4;
+	batchsize = Max(batchsize, MAX_SEND_SIZE);
+	batchsize = Min(batchsize, MAX_SEND_BATCH_SIZE);
 	endptr = startptr;
-	endptr += MAX_SEND_SIZE;
+	endptr += batchsize;
 
 	/* if we went beyond SendRqstPtr, back off */
 	if (SendRqstPtr <= endptr)
@@ -2341,7 +2356,7 @@ XLogSendPhysical(void)
 	}
 
 	nbytes = endptr - startptr;
-	Assert(nbytes <= MAX_SEND_SIZE);
+	Assert(nbytes <= MAX_SEND_BATCH_SIZE);
 
 	/*
 	 * OK to read and send the slice.
@@ -2355,10 +2370,18 @@ XLogSendPhysical(void)
 
 	/*
 	 * Read the log directly into the output buffer to avoid extra memcpy
-	 * calls.
+	 * calls.  When streaming the current timeline on a master, recently
+	 * written WAL is usually still in the WAL buffers, which all walsenders
+	 * can copy from without system calls; only read what's been evicted
+	 * from there from disk.
 	 */
 	enlargeStringInfo(&output_message, nbytes);
-	XLogRead(&output_message.data[output_message.len], startptr, nbytes);
+	if (!am_cascading_walsender && !sendTimeLineIsHistoric)
+		frombuffers = WALReadFromBuffers(&output_message.data[output_message.len],
+										 startptr, nbytes);
+	if (frombuffers < nbytes)
+		XLogRead(&output_message.data[output_message.len + frombuffers],
+				 startptr + frombuffers, nbytes - frombuffers);
 	output_message.len += nbytes;
 	output_message.data[output_message.len] = '\0';
 
@@ -2732,7 +2755,8 @@ pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
 	Tuplestorestate *tupstore;
 	MemoryContext per_query_ctx;
 	MemoryContext oldcontext;
-	WalSnd	   *sync_standby;
+	List	   *sync_standbys;
+	bool		am_sync;
 	int			i;
 
 	/* check to see if caller supports us returning a tuplestore */
@@ -2761,10 +2785,10 @@ pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
 	MemoryContextSwitchTo(oldcontext);
 
 	/*
-	 * Get the currently active synchronous standby.
+	 * Get the currently active synchronous standbys.
 	 */
 	LWLockAcquire(SyncRepLock, LW_SHARED);
-	sync_standby = SyncRepGetSynchronousStandby();
+	sync_standbys = SyncRepGetSyncStandbys(&am_sync);
 	LWLockRelease(SyncRepLock);
 
 	for (i = 0; i < max_wal_senders; i++)
@@ -2831,11 +2855,15 @@ pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
 
 			/*
 			 * More easily understood version of standby state. This is purely
-			 * informational, not different from priority.
+			 * informational.  In quorum mode, all listed standbys are
+			 * considered equally.
 			 */
 			if (priority == 0)
 				values[7] = CStringGetTextDatum("async");
-			else if (walsnd == sync_standby)
+			else if (SyncRepConfig != NULL &&
+					 SyncRepConfig->syncrep_method == SYNC_REP_QUORUM)
+				values[7] = CStringGetTextDatum("quorum");
+			else if (list_member_int(sync_standbys, i))
 				values[7] = CStringGetTextDatum("sync");
 			else
 				values[7] = CStringGetTextDatum("potential");
@@ -21,6 +21,7 @@
 #include "storage/proc.h"
 #include "storage/sinvaladt.h"
 #include "utils/inval.h"
+#include "utils/sharedcatcache.h"
 
 
 uint64		SharedInvalidMessageCounter;
@@ -49,6 +50,7 @@ void
 SendSharedInvalidMessages(const SharedInvalidationMessage *msgs, int n)
 {
 	SIInsertDataEntries(msgs, n);
+	SharedCatCacheInvalidate(msgs, n);
 }
 
 /*
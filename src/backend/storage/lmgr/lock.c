@@ -2222,6 +2222,43 @@ LockReleaseSession(LOCKMETHODID lockmethodid)
 	}
 }
 
+/*
+ * LockHasSessionLocks -- Does the current process hold any session locks of
+ *		the specified lock method?
+ */
+bool
+LockHasSessionLocks(LOCKMETHODID lockmethodid)
+{
+	HASH_SEQ_STATUS status;
+	LOCALLOCK  *locallock;
+
+	if (lockmethodid <= 0 || lockmethodid >= lengthof(LockMethods))
+		elog(ERROR, "unrecognized lock method: %d", lockmethodid);
+
+	hash_seq_init(&status, LockMethodLocalHash);
+
+	while ((locallock = (LOCALLOCK *) hash_seq_search(&status)) != NULL)
+	{
+		LOCALLOCKOWNER *lockOwners = locallock->lockOwners;
+		int			i;
+
+		if (LOCALLOCK_LOCKMETHOD(*locallock) != lockmethodid)
+			continue;
+
+		/* Session locks are those held with a NULL owner */
+		for (i = locallock->numLockOwners - 1; i >= 0; i--)
+		{
+			if (lockOwners[i].owner == NULL && lockOwners[i].nLocks > 0)
+			{
+				hash_seq_term(&status);
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 /*
  * LockReleaseCurrentOwner
  *		Release all locks belonging to CurrentResourceOwner
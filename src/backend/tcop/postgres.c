@@ -65,6 +65,7 @@
 #include "storage/sinval.h"
 #include "tcop/fastpath.h"
 #include "tcop/pquery.h"
+#include "tcop/sessionpool.h"
 #include "tcop/tcopprot.h"
 #include "tcop/utility.h"
 #include "utils/lsyscache.h"
@@ -182,6 +183,7 @@ static ProcSignalReason RecoveryConflictReason;
 static int	InteractiveBackend(StringInfo inBuf);
 static int	interactive_getc(void);
 static int	SocketBackend(StringInfo inBuf);
+static void invalid_frontend_message(int qtype);
 static int	ReadCommand(StringInfo inBuf);
 static void forbidden_in_wal_sender(char firstchar);
 static List *pg_rewrite_query(Query *query);
@@ -324,6 +326,23 @@ interactive_getc(void)
 	return c;
 }
 
+/*
+ * Complain about a frontend message type we don't expect, and end the
+ * connection.  A pooled backend only closes that of the client at fault: the
+ * error aborts what the session was doing, and the session is closed the
+ * next time we look for a command (see SessionPoolSchedule).
+ */
+static void
+invalid_frontend_message(int qtype)
+{
+	if (am_pooled_backend)
+		SessionPoolConnectionLost();
+
+	ereport(am_pooled_backend ? ERROR : FATAL,
+			(errcode(ERRCODE_PROTOCOL_VIOLATION),
+			 errmsg("invalid frontend message type %d", qtype)));
+}
+
 /* ----------------
  *	SocketBackend()		Is called for frontend-backend connections
  *
@@ -444,9 +463,7 @@ SocketBackend(StringInfo inBuf)
 			doing_extended_query_message = true;
 			/* these are only legal in protocol 3 */
 			if (PG_PROTOCOL_MAJOR(FrontendProtocol) < 3)
-				ereport(FATAL,
-						(errcode(ERRCODE_PROTOCOL_VIOLATION),
-						 errmsg("invalid frontend message type %d", qtype)));
+				invalid_frontend_message(qtype);
 			break;
 
 		case 'S':				/* sync */
@@ -456,9 +473,7 @@ SocketBackend(StringInfo inBuf)
 			doing_extended_query_message = false;
 			/* only legal in protocol 3 */
 			if (PG_PROTOCOL_MAJOR(FrontendProtocol) < 3)
-				ereport(FATAL,
-						(errcode(ERRCODE_PROTOCOL_VIOLATION),
-						 errmsg("invalid frontend message type %d", qtype)));
+				invalid_frontend_message(qtype);
 			break;
 
 		case 'd':				/* copy data */
@@ -467,9 +482,7 @@ SocketBackend(StringInfo inBuf)
 			doing_extended_query_message = false;
 			/* these are only legal in protocol 3 */
 			if (PG_PROTOCOL_MAJOR(FrontendProtocol) < 3)
-				ereport(FATAL,
-						(errcode(ERRCODE_PROTOCOL_VIOLATION),
-						 errmsg("invalid frontend message type %d", qtype)));
+				invalid_frontend_message(qtype);
 			break;
 
 		default:
@@ -479,9 +492,7 @@ SocketBackend(StringInfo inBuf)
 			 * fatal because we have probably lost message boundary sync, and
 			 * there's no good way to recover.
 			 */
-			ereport(FATAL,
-					(errcode(ERRCODE_PROTOCOL_VIOLATION),
-					 errmsg("invalid frontend message type %d", qtype)));
+			invalid_frontend_message(qtype);
 			break;
 	}
 
@@ -2893,6 +2904,16 @@ ProcessInterrupts(void)
 		LockErrorCleanup();
 		/* don't send to client, we already know the connection to be dead. */
 		whereToSendOutput = DestNone;
+
+		/* A pooled backend just loses this one client session */
+		if (am_pooled_backend)
+		{
+			ClientConnectionLost = false;
+			SessionPoolConnectionLost();
+			ereport(ERROR,
+					(errcode(ERRCODE_CONNECTION_FAILURE),
+					 errmsg("connection to client lost")));
+		}
 		ereport(FATAL,
 				(errcode(ERRCODE_CONNECTION_FAILURE),
 				 errmsg("connection to client lost")));
@@ -2978,9 +2999,12 @@ ProcessInterrupts(void)
 		/*
 		 * If we are reading a command from the client, just ignore the cancel
 		 * request --- sending an extra error message won't accomplish
-		 * anything.  Otherwise, go ahead and throw the error.
+		 * anything.  Otherwise, go ahead and throw the error.  In a pooled
+		 * backend, also ignore a request sent on behalf of another client
+		 * session.
 		 */
-		if (!DoingCommandRead)
+		if ((!am_pooled_backend || SessionPoolCancelApplies()) &&
+			!DoingCommandRead)
 		{
 			LockErrorCleanup();
 			ereport(ERROR,
@@ -3720,6 +3744,12 @@ PostgresMain(int argc, char *argv[],
 
 	SetProcessingMode(NormalProcessing);
 
+	/*
+	 * With session pooling, the client may be handed over to a pooled
+	 * backend at this point, in which case we exit; see sessionpool.c.
+	 */
+	SessionPoolAttach();
+
 	/*
 	 * Now all GUC states are fully set up.  Report them to client if
 	 * appropriate.
@@ -3973,6 +4003,16 @@ PostgresMain(int argc, char *argv[],
 		 */
 		DoingCommandRead = true;
 
+		/*
+		 * (2b) In a pooled backend, choose the client session to read the
+		 * next command from; this waits for all of the sessions.  Switching
+		 * to another session ends any skip-till-Sync of the previous one.
+		 */
+		if (am_pooled_backend &&
+			SessionPoolSchedule(&unnamed_stmt_psrc, !ignore_till_sync,
+								&got_SIGHUP))
+			ignore_till_sync = false;
+
 		/*
 		 * (3) read a command (loop blocks here)
 		 */
@@ -3994,7 +4034,7 @@ PostgresMain(int argc, char *argv[],
 		 * (5) check for any other interesting events that happened while we
 		 * slept.
 		 */
-		if (got_SIGHUP)
+		if (got_SIGHUP && !am_pooled_backend)
 		{
 			got_SIGHUP = false;
 			ProcessConfigFile(PGC_SIGHUP);
@@ -4237,6 +4277,17 @@ PostgresMain(int argc, char *argv[],
 				if (whereToSendOutput == DestRemote)
 					whereToSendOutput = DestNone;
 
+				/*
+				 * In a pooled backend, this only ends the client session,
+				 * unless it was the last one.
+				 */
+				if (am_pooled_backend &&
+					SessionPoolCloseSession(&unnamed_stmt_psrc))
+				{
+					ignore_till_sync = false;
+					break;
+				}
+
 				/*
 				 * NOTE: if you are tempted to add more code here, DON'T!
 				 * Whatever you had in mind to do should be set up as an
@@ -4258,10 +4309,7 @@ PostgresMain(int argc, char *argv[],
 				break;
 
 			default:
-				ereport(FATAL,
-						(errcode(ERRCODE_PROTOCOL_VIOLATION),
-						 errmsg("invalid frontend message type %d",
-								firstchar)));
+				invalid_frontend_message(firstchar);
 		}
 	}							/* end of input-reading loop */
 }
@@ -23,6 +23,7 @@
 #include "tcop/pquery.h"
 #include "tcop/utility.h"
 #include "utils/memutils.h"
+#include "utils/plancache.h"
 #include "utils/snapmgr.h"
 
 
@@ -465,6 +466,7 @@ PortalStart(Portal portal, ParamListInfo params,
 	MemoryContext oldContext;
 	QueryDesc  *queryDesc;
 	int			myeflags;
+	instr_time	start_time;
 
 	AssertArg(PortalIsValid(portal));
 	AssertState(portal->status == PORTAL_DEFINED);
@@ -475,6 +477,13 @@ PortalStart(Portal portal, ParamListInfo params,
 	saveActivePortal = ActivePortal;
 	saveResourceOwner = CurrentResourceOwner;
 	savePortalContext = PortalContext;
+
+	/* Time executor startup for the plan cache; see CachedPlanAddRunTime */
+	if (portal->cplan)
+		INSTR_TIME_SET_CURRENT(start_time);
+	else
+		INSTR_TIME_SET_ZERO(start_time);
+
 	PG_TRY();
 	{
 		ActivePortal = portal;
@@ -621,6 +630,9 @@ PortalStart(Portal portal, ParamListInfo params,
 	}
 	PG_END_TRY();
 
+	if (portal->cplan)
+		CachedPlanAddRunTime(portal->cplan, start_time);
+
 	MemoryContextSwitchTo(oldContext);
 
 	ActivePortal = saveActivePortal;
@@ -715,6 +727,7 @@ PortalRun(Portal portal, long count, bool isTopLevel,
 	ResourceOwner saveResourceOwner;
 	MemoryContext savePortalContext;
 	MemoryContext saveMemoryContext;
+	instr_time	start_time;
 
 	AssertArg(PortalIsValid(portal));
 
@@ -760,6 +773,13 @@ PortalRun(Portal portal, long count, bool isTopLevel,
 	saveResourceOwner = CurrentResourceOwner;
 	savePortalContext = PortalContext;
 	saveMemoryContext = CurrentMemoryContext;
+
+	/* Time the run for the plan cache; see CachedPlanAddRunTime */
+	if (portal->cplan)
+		INSTR_TIME_SET_CURRENT(start_time);
+	else
+		INSTR_TIME_SET_ZERO(start_time);
+
 	PG_TRY();
 	{
 		ActivePortal = portal;
@@ -851,6 +871,9 @@ PortalRun(Portal portal, long count, bool isTopLevel,
 	}
 	PG_END_TRY();
 
+	if (portal->cplan)
+		CachedPlanAddRunTime(portal->cplan, start_time);
+
 	if (saveMemoryContext == saveTopTransactionContext)
 		MemoryContextSwitchTo(TopTransactionContext);
 	else
@@ -1392,6 +1415,7 @@ PortalRunFetch(Portal portal,
 	ResourceOwner saveResourceOwner;
 	MemoryContext savePortalContext;
 	MemoryContext oldContext;
+	instr_time	start_time;
 
 	AssertArg(PortalIsValid(portal));
 
@@ -1410,6 +1434,13 @@ PortalRunFetch(Portal portal,
 	saveActivePortal = ActivePortal;
 	saveResourceOwner = CurrentResourceOwner;
 	savePortalContext = PortalContext;
+
+	/* Time the run for the plan cache; see CachedPlanAddRunTime */
+	if (portal->cplan)
+		INSTR_TIME_SET_CURRENT(start_time);
+	else
+		INSTR_TIME_SET_ZERO(start_time);
+
 	PG_TRY();
 	{
 		ActivePortal = portal;
@@ -1462,6 +1493,9 @@ PortalRunFetch(Portal portal,
 	}
 	PG_END_TRY();
 
+	if (portal->cplan)
+		CachedPlanAddRunTime(portal->cplan, start_time);
+
 	MemoryContextSwitchTo(oldContext);
 
 	/* Mark portal not active */
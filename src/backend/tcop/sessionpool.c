@@ -0,0 +1,1158 @@
+/*-------------------------------------------------------------------------
+ *
+ * sessionpool.c
+ *	  Transaction-level pooling of client sessions onto shared backends.
+ *
+ * With session_pool_size > 0, client sessions of the same database and role
+ * can share a small number of "pooled backends".  A connection still starts
+ * out in a backend process of its own, which authenticates the client and
+ * sets up its settings as usual.  If fewer than session_pool_size pooled
+ * backends exist for its database and role, that process becomes one;
+ * otherwise it hands the client socket, along with the session's settings,
+ * over to the least busy existing one and exits.  The handoff uses
+ * SCM_RIGHTS messages on a datagram socket that every pooled backend binds
+ * in the pg_session_pool directory of the data directory.
+ *
+ * A pooled backend serves one session at a time and may switch to another
+ * only between transactions, at the point where it would otherwise wait for
+ * the next command.  Switching saves the settings, prepared statements,
+ * unnamed statement and sequence caches (for currval() and lastval()) of
+ * the outgoing session, puts the settings back to the backend's baseline
+ * (see guc.c), and installs those of the incoming session.  A session that
+ * holds something else that can't be moved between clients -- a cursor WITH
+ * HOLD or a session-level advisory lock -- keeps the backend to itself until
+ * it releases it.  Temporary tables and LISTEN are not allowed in pooled
+ * sessions at all.
+ *
+ * A client that violates the protocol only loses its own session; but
+ * terminating a pooled backend, e.g. with pg_terminate_backend(), ends all
+ * the sessions it serves.
+ *
+ * Each session keeps the cancel key it was given by the postmaster when its
+ * connection arrived.  A cancel request for a pooled backend is recorded in
+ * shared memory along with its key, and the backend ignores the resulting
+ * SIGINT unless the key belongs to the session it is currently serving.
+ *
+ * Session pooling needs Unix-domain sockets and poll(2), so it's not
+ * available on Windows.
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/backend/tcop/sessionpool.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <signal.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef HAVE_UNIX_SOCKETS
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#include "access/xact.h"
+#include "commands/prepare.h"
+#include "commands/sequence.h"
+#include "funcapi.h"
+#include "lib/ilist.h"
+#include "libpq/libpq.h"
+#include "libpq/pqformat.h"
+#include "miscadmin.h"
+#include "replication/walsender.h"
+#include "storage/fd.h"
+#include "storage/ipc.h"
+#include "storage/latch.h"
+#include "storage/lock.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
+#include "tcop/sessionpool.h"
+#include "tcop/tcopprot.h"
+#include "utils/builtins.h"
+#include "utils/memutils.h"
+#include "utils/portal.h"
+
+/* GUC variables */
+int			session_pool_size = 0;
+int			max_pooled_sessions = 100;
+bool		session_pooling = true;
+
+bool		am_pooled_backend = false;
+
+/* Largest handoff message we'll send or accept */
+#define MAX_HANDOFF_SIZE	(64 * 1024)
+
+/*
+ * Shared memory state of a pooled backend.
+ */
+typedef struct PooledBackend
+{
+	pid_t		pid;			/* pid of the backend, or 0 if slot unused */
+	Oid			dboid;			/* database served */
+	Oid			roleid;			/* authenticated role served */
+	int			nsessions;		/* sessions, including ones being handed
+								 * over to the backend */
+	bool		accepting;		/* can sessions be handed over to it? */
+	bool		cancel_pending; /* cancel request not yet processed */
+	int32		cancel_key;		/* key given with that request */
+} PooledBackend;
+
+typedef struct SessionPoolCtlData
+{
+	slock_t		mutex;			/* protects everything below */
+	PooledBackend backends[FLEXIBLE_ARRAY_MEMBER];
+} SessionPoolCtlData;
+
+static SessionPoolCtlData *SessionPoolCtl = NULL;
+
+/* Our slot, in a pooled backend */
+static PooledBackend *MyPooledBackend = NULL;
+
+/*
+ * A client session served by this pooled backend.  The saved state is only
+ * valid while the session is not the active one.
+ */
+typedef struct PooledSession
+{
+	dlist_node	node;
+	Port	   *port;			/* connection to the client */
+	bool		own_port;		/* was port allocated by us? */
+	int32		cancel_key;		/* key the client uses to cancel */
+	bool		lost;			/* connection to the client failed */
+	char	   *guc_state;		/* session-specific settings */
+	Size		guc_state_len;
+	HTAB	   *prepared_queries;	/* prepared statements */
+	CachedPlanSource *unnamed_stmt;		/* unnamed prepared statement */
+	SequenceCaches *sequences;	/* currval() and lastval() state */
+} PooledSession;
+
+static dlist_head pooled_sessions = DLIST_STATIC_INIT(pooled_sessions);
+static int	num_pooled_sessions = 0;
+static PooledSession *ActiveSession = NULL;
+
+/* Port of a closed session, freed once another session is active */
+static Port *closed_port = NULL;
+
+/* Socket on which sessions are handed over to us */
+static pgsocket handoff_sock = PGINVALID_SOCKET;
+
+/*
+ * Layout of a handoff message.  The client socket travels as SCM_RIGHTS
+ * control data; the message itself carries the Port (whose pointer fields
+ * are meaningless to the receiver), followed by remote_host, remote_hostname
+ * (empty if unknown), remote_port, database_name and user_name as
+ * null-terminated strings, and then the session's settings.
+ */
+typedef struct SessionHandoff
+{
+	int32		cancel_key;
+	Port		port;
+	Size		guc_state_len;
+} SessionHandoff;
+
+#ifdef HAVE_UNIX_SOCKETS
+static void become_pooled_backend(void);
+static bool hand_over_session(pid_t pid, char *guc_state, Size guc_state_len);
+static void accept_handoffs(CachedPlanSource **unnamed_stmt);
+static void switch_to_session(PooledSession *session,
+				  CachedPlanSource **unnamed_stmt);
+static void reload_config(void);
+static void free_port(Port *port);
+static void SessionPoolShmemExit(int code, Datum arg);
+#endif
+
+
+/*
+ * GUC check_hook for session_pool_size
+ */
+bool
+check_session_pool_size(int *newval, void **extra, GucSource source)
+{
+#if !defined(HAVE_UNIX_SOCKETS) || !defined(HAVE_POLL)
+	if (*newval != 0)
+	{
+		GUC_check_errdetail("Session pooling is not supported on this platform.");
+		return false;
+	}
+#endif
+	return true;
+}
+
+/*
+ * Report shared-memory space needed by SessionPoolShmemInit
+ */
+Size
+SessionPoolShmemSize(void)
+{
+	Size		size;
+
+	size = offsetof(SessionPoolCtlData, backends);
+	size = add_size(size, mul_size(MaxConnections, sizeof(PooledBackend)));
+	return size;
+}
+
+/*
+ * Allocate and initialize the shared state of the session pool
+ */
+void
+SessionPoolShmemInit(void)
+{
+	bool		found;
+
+	SessionPoolCtl = (SessionPoolCtlData *)
+		ShmemInitStruct("Session Pool Data", SessionPoolShmemSize(), &found);
+
+	if (!found)
+	{
+		MemSet(SessionPoolCtl, 0, SessionPoolShmemSize());
+		SpinLockInit(&SessionPoolCtl->mutex);
+	}
+}
+
+/*
+ * Create the directory for handoff sockets, or clean out the sockets left
+ * behind by a previous run.  Called by the postmaster at startup.
+ */
+void
+SessionPoolInitDirectory(void)
+{
+	DIR		   *dir;
+	struct dirent *de;
+	char		path[MAXPGPATH];
+
+	if (session_pool_size == 0)
+		return;
+
+	if (mkdir(SESSION_POOL_DIR, S_IRWXU) < 0 && errno != EEXIST)
+		ereport(FATAL,
+				(errcode_for_file_access(),
+				 errmsg("could not create directory \"%s\": %m",
+						SESSION_POOL_DIR)));
+
+	dir = AllocateDir(SESSION_POOL_DIR);
+	while ((de = ReadDir(dir, SESSION_POOL_DIR)) != NULL)
+	{
+		if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0)
+			continue;
+
+		snprintf(path, sizeof(path), "%s/%s", SESSION_POOL_DIR, de->d_name);
+		if (unlink(path) < 0)
+			ereport(LOG,
+					(errcode_for_file_access(),
+					 errmsg("could not remove file \"%s\": %m", path)));
+	}
+	FreeDir(dir);
+}
+
+/*
+ * Decide what to do with a newly started session: hand it over to a pooled
+ * backend for its database and role, become such a backend ourselves, or
+ * stay a dedicated backend.
+ *
+ * Called once the session is fully set up, before anything is sent to the
+ * client.  Does not return if the session was handed over.
+ */
+void
+SessionPoolAttach(void)
+{
+#ifdef HAVE_UNIX_SOCKETS
+	char	   *guc_state;
+	Size		guc_state_len;
+	bool		poolable;
+	Oid			roleid;
+	int			npooled = 0;
+	PooledBackend *target = NULL;
+	pid_t		target_pid = 0;
+	int			i;
+
+	/*
+	 * Only plain protocol 3 client sessions can be pooled.  SSL connections
+	 * can't be, as the encryption state is private to this process.
+	 */
+	if (session_pool_size == 0 || !session_pooling ||
+		!IsUnderPostmaster || MyProcPort == NULL || am_walsender ||
+		PG_PROTOCOL_MAJOR(FrontendProtocol) < 3 ||
+		MyProcPort->ssl_in_use)
+		return;
+
+	/* Don't strand any commands the client has already sent */
+	if (pq_buffer_has_data())
+		return;
+
+	guc_state = SaveSessionGUCState(&guc_state_len, &poolable);
+	if (!poolable)
+	{
+		pfree(guc_state);
+		return;
+	}
+
+	roleid = GetAuthenticatedUserId();
+
+	SpinLockAcquire(&SessionPoolCtl->mutex);
+	for (i = 0; i < MaxConnections; i++)
+	{
+		PooledBackend *pb = &SessionPoolCtl->backends[i];
+
+		if (pb->pid == 0 || pb->dboid != MyDatabaseId || pb->roleid != roleid)
+			continue;
+
+		npooled++;
+		if (pb->accepting && pb->nsessions < max_pooled_sessions &&
+			(target == NULL || pb->nsessions < target->nsessions))
+			target = pb;
+	}
+
+	if (npooled < session_pool_size)
+	{
+		/* Claim a slot; we'll start accepting sessions once we can */
+		for (i = 0; i < MaxConnections; i++)
+		{
+			PooledBackend *pb = &SessionPoolCtl->backends[i];
+
+			if (pb->pid == 0)
+			{
+				pb->pid = MyProcPid;
+				pb->dboid = MyDatabaseId;
+				pb->roleid = roleid;
+				pb->nsessions = 1;
+				pb->accepting = false;
+				pb->cancel_pending = false;
+				MyPooledBackend = pb;
+				break;
+			}
+		}
+	}
+
+	if (MyPooledBackend == NULL && target != NULL)
+	{
+		target->nsessions++;
+		target_pid = target->pid;
+	}
+	SpinLockRelease(&SessionPoolCtl->mutex);
+
+	if (MyPooledBackend != NULL)
+		become_pooled_backend();
+	else if (target_pid != 0)
+	{
+		if (hand_over_session(target_pid, guc_state, guc_state_len))
+		{
+			/*
+			 * The pooled backend owns the client connection now.  Exiting
+			 * doesn't shut it down, as other processes have it open.
+			 */
+			whereToSendOutput = DestNone;
+			proc_exit(0);
+		}
+
+		/* Failed; carry on as a dedicated backend */
+		SpinLockAcquire(&SessionPoolCtl->mutex);
+		if (target->pid == target_pid)
+			target->nsessions--;
+		SpinLockRelease(&SessionPoolCtl->mutex);
+	}
+
+	pfree(guc_state);
+#endif   /* HAVE_UNIX_SOCKETS */
+}
+
+#ifdef HAVE_UNIX_SOCKETS
+
+/*
+ * Fill in the address of the handoff socket of the given pooled backend.
+ */
+static void
+handoff_socket_address(pid_t pid, struct sockaddr_un * addr)
+{
+	MemSet(addr, 0, sizeof(struct sockaddr_un));
+	addr->sun_family = AF_UNIX;
+	snprintf(addr->sun_path, sizeof(addr->sun_path), "%s/%d",
+			 SESSION_POOL_DIR, (int) pid);
+}
+
+/*
+ * Turn this backend into a pooled backend, with the current session as its
+ * first one.  Our slot in shared memory has been claimed already.
+ */
+static void
+become_pooled_backend(void)
+{
+	struct sockaddr_un addr;
+	PooledSession *session;
+	pgsocket	sock;
+
+	handoff_socket_address(MyProcPid, &addr);
+
+	sock = socket(AF_UNIX, SOCK_DGRAM, 0);
+	if (sock == PGINVALID_SOCKET ||
+		!pg_set_noblock(sock) ||
+		(unlink(addr.sun_path) < 0 && errno != ENOENT) ||
+		bind(sock, (struct sockaddr *) & addr, sizeof(addr)) < 0)
+	{
+		ereport(LOG,
+				(errcode_for_socket_access(),
+				 errmsg("could not create session pool socket \"%s\": %m",
+						addr.sun_path)));
+		if (sock != PGINVALID_SOCKET)
+			closesocket(sock);
+
+		/* Give up the slot, and stay a dedicated backend */
+		SpinLockAcquire(&SessionPoolCtl->mutex);
+		MyPooledBackend->pid = 0;
+		SpinLockRelease(&SessionPoolCtl->mutex);
+		MyPooledBackend = NULL;
+		return;
+	}
+
+	handoff_sock = sock;
+	on_shmem_exit(SessionPoolShmemExit, 0);
+
+	session = (PooledSession *)
+		MemoryContextAllocZero(TopMemoryContext, sizeof(PooledSession));
+	session->port = MyProcPort;
+	session->own_port = false;
+	session->cancel_key = (int32) MyCancelKey;
+	dlist_push_tail(&pooled_sessions, &session->node);
+	num_pooled_sessions = 1;
+	ActiveSession = session;
+	am_pooled_backend = true;
+
+	SpinLockAcquire(&SessionPoolCtl->mutex);
+	MyPooledBackend->accepting = true;
+	SpinLockRelease(&SessionPoolCtl->mutex);
+}
+
+/*
+ * Release our slot and remove our handoff socket at backend exit.
+ */
+static void
+SessionPoolShmemExit(int code, Datum arg)
+{
+	struct sockaddr_un addr;
+
+	SpinLockAcquire(&SessionPoolCtl->mutex);
+	MyPooledBackend->pid = 0;
+	MyPooledBackend->accepting = false;
+	MyPooledBackend->nsessions = 0;
+	SpinLockRelease(&SessionPoolCtl->mutex);
+	MyPooledBackend = NULL;
+
+	handoff_socket_address(MyProcPid, &addr);
+	unlink(addr.sun_path);
+}
+
+/*
+ * Send the client connection of this backend, with the given settings, to
+ * the pooled backend with the given pid.  Returns true on success.
+ *
+ * The message is sent without blocking; if the receiver's queue is full,
+ * we'd rather keep the session than wait.
+ */
+static bool
+hand_over_session(pid_t pid, char *guc_state, Size guc_state_len)
+{
+	Port	   *port = MyProcPort;
+	StringInfoData buf;
+	SessionHandoff hdr;
+	struct sockaddr_un addr;
+	struct msghdr msg;
+	struct iovec iov;
+	union
+	{
+		struct cmsghdr hdr;
+		char		buf[CMSG_SPACE(sizeof(int))];
+	}			cmsgbuf;
+	struct cmsghdr *cmsg;
+	pgsocket	sock;
+	ssize_t		rc;
+	int			save_errno;
+
+	MemSet(&hdr, 0, sizeof(hdr));
+	hdr.cancel_key = (int32) MyCancelKey;
+	memcpy(&hdr.port, port, sizeof(Port));
+	hdr.guc_state_len = guc_state_len;
+
+	initStringInfo(&buf);
+	appendBinaryStringInfo(&buf, (char *) &hdr, sizeof(hdr));
+	appendStringInfoString(&buf, port->remote_host ? port->remote_host : "");
+	appendStringInfoChar(&buf, '\0');
+	appendStringInfoString(&buf,
+						port->remote_hostname ? port->remote_hostname : "");
+	appendStringInfoChar(&buf, '\0');
+	appendStringInfoString(&buf, port->remote_port ? port->remote_port : "");
+	appendStringInfoChar(&buf, '\0');
+	appendStringInfoString(&buf, port->database_name);
+	appendStringInfoChar(&buf, '\0');
+	appendStringInfoString(&buf, port->user_name);
+	appendStringInfoChar(&buf, '\0');
+	appendBinaryStringInfo(&buf, guc_state, guc_state_len);
+
+	if (buf.len > MAX_HANDOFF_SIZE)
+	{
+		pfree(buf.data);
+		return false;
+	}
+
+	sock = socket(AF_UNIX, SOCK_DGRAM, 0);
+	if (sock == PGINVALID_SOCKET)
+	{
+		ereport(LOG,
+				(errcode_for_socket_access(),
+				 errmsg("could not create socket for session handoff: %m")));
+		pfree(buf.data);
+		return false;
+	}
+
+	handoff_socket_address(pid, &addr);
+
+	MemSet(&msg, 0, sizeof(msg));
+	iov.iov_base = buf.data;
+	iov.iov_len = buf.len;
+	msg.msg_name = &addr;
+	msg.msg_namelen = sizeof(addr);
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = cmsgbuf.buf;
+	msg.msg_controllen = sizeof(cmsgbuf.buf);
+
+	cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+	memcpy(CMSG_DATA(cmsg), &port->sock, sizeof(int));
+
+	rc = sendmsg(sock, &msg, MSG_DONTWAIT);
+	save_errno = errno;
+	closesocket(sock);
+	pfree(buf.data);
+
+	if (rc != (ssize_t) iov.iov_len)
+	{
+		errno = save_errno;
+		ereport(DEBUG1,
+				(errcode_for_socket_access(),
+				 errmsg("could not hand over session to pooled backend %d: %m",
+						(int) pid)));
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Read a null-terminated string from a handoff message.
+ */
+static char *
+read_handoff_string(char **ptr, char *end)
+{
+	char	   *str = *ptr;
+	char	   *p;
+
+	for (p = str; p < end && *p != '\0'; p++)
+		;
+	if (p >= end)
+		return NULL;
+	*ptr = p + 1;
+
+	return MemoryContextStrdup(TopMemoryContext, str);
+}
+
+/*
+ * Accept all sessions that have been handed over to us, and greet each of
+ * their clients as a new backend would.
+ */
+static void
+accept_handoffs(CachedPlanSource **unnamed_stmt)
+{
+	char	   *buf = palloc(MAX_HANDOFF_SIZE);
+
+	for (;;)
+	{
+		struct msghdr msg;
+		struct iovec iov;
+		union
+		{
+			struct cmsghdr hdr;
+			char		buf[CMSG_SPACE(sizeof(int))];
+		}			cmsgbuf;
+		struct cmsghdr *cmsg;
+		SessionHandoff hdr;
+		PooledSession *session;
+		Port	   *port;
+		pgsocket	sock = PGINVALID_SOCKET;
+		char	   *ptr;
+		char	   *end;
+		char	   *remote_hostname;
+		ssize_t		rc;
+		StringInfoData keybuf;
+
+		MemSet(&msg, 0, sizeof(msg));
+		iov.iov_base = buf;
+		iov.iov_len = MAX_HANDOFF_SIZE;
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = cmsgbuf.buf;
+		msg.msg_controllen = sizeof(cmsgbuf.buf);
+
+		rc = recvmsg(handoff_sock, &msg, MSG_DONTWAIT);
+		if (rc < 0)
+		{
+			if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)
+				ereport(LOG,
+						(errcode_for_socket_access(),
+						 errmsg("could not receive session handoff: %m")));
+			break;
+		}
+
+		cmsg = CMSG_FIRSTHDR(&msg);
+		if (cmsg != NULL && cmsg->cmsg_level == SOL_SOCKET &&
+			cmsg->cmsg_type == SCM_RIGHTS &&
+			cmsg->cmsg_len == CMSG_LEN(sizeof(int)))
+			memcpy(&sock, CMSG_DATA(cmsg), sizeof(int));
+
+		if (sock == PGINVALID_SOCKET || (msg.msg_flags & MSG_TRUNC) ||
+			rc < (ssize_t) sizeof(SessionHandoff))
+		{
+			ereport(LOG,
+					(errmsg("invalid session handoff message")));
+			if (sock != PGINVALID_SOCKET)
+				closesocket(sock);
+			SpinLockAcquire(&SessionPoolCtl->mutex);
+			MyPooledBackend->nsessions--;
+			SpinLockRelease(&SessionPoolCtl->mutex);
+			continue;
+		}
+
+		memcpy(&hdr, buf, sizeof(hdr));
+		ptr = buf + sizeof(hdr);
+		end = buf + rc;
+
+		port = (Port *) MemoryContextAlloc(TopMemoryContext, sizeof(Port));
+		memcpy(port, &hdr.port, sizeof(Port));
+		port->sock = sock;
+		port->remote_host = read_handoff_string(&ptr, end);
+		remote_hostname = read_handoff_string(&ptr, end);
+		port->remote_hostname = NULL;
+		if (remote_hostname && remote_hostname[0] != '\0')
+			port->remote_hostname = remote_hostname;
+		port->remote_port = read_handoff_string(&ptr, end);
+		port->database_name = read_handoff_string(&ptr, end);
+		port->user_name = read_handoff_string(&ptr, end);
+		port->cmdline_options = NULL;
+		port->guc_options = NIL;
+		port->hba = NULL;
+		port->peer_cn = NULL;
+#if defined(ENABLE_GSS) || defined(ENABLE_SSPI)
+		/* freed with free() at exit, see socket_close() */
+		port->gss = (pg_gssinfo *) calloc(1, sizeof(pg_gssinfo));
+#else
+		port->gss = NULL;
+#endif
+#ifdef USE_OPENSSL
+		port->ssl = NULL;
+		port->peer = NULL;
+#endif
+
+		session = (PooledSession *)
+			MemoryContextAllocZero(TopMemoryContext, sizeof(PooledSession));
+		session->port = port;
+		session->own_port = true;
+		session->cancel_key = hdr.cancel_key;
+		if (hdr.guc_state_len > 0 && ptr + hdr.guc_state_len <= end)
+		{
+			session->guc_state = MemoryContextAlloc(TopMemoryContext,
+													hdr.guc_state_len);
+			memcpy(session->guc_state, ptr, hdr.guc_state_len);
+			session->guc_state_len = hdr.guc_state_len;
+		}
+		dlist_push_tail(&pooled_sessions, &session->node);
+		num_pooled_sessions++;
+
+		switch_to_session(session, unnamed_stmt);
+
+		/* Report the settings and our cancellation info, then go idle */
+		BeginReportingGUCOptions();
+
+		pq_beginmessage(&keybuf, 'K');
+		pq_sendint(&keybuf, (int32) MyProcPid, sizeof(int32));
+		pq_sendint(&keybuf, session->cancel_key, sizeof(int32));
+		pq_endmessage(&keybuf);
+
+		ReadyForQuery(whereToSendOutput);
+	}
+
+	pfree(buf);
+}
+
+/*
+ * Make the given session the active one.
+ */
+static void
+switch_to_session(PooledSession *session, CachedPlanSource **unnamed_stmt)
+{
+	PooledSession *old = ActiveSession;
+	MemoryContext oldcontext;
+
+	if (session == old)
+		return;
+
+	oldcontext = MemoryContextSwitchTo(TopMemoryContext);
+
+	/* Stash away the state of the outgoing session */
+	if (old != NULL)
+	{
+		bool		poolable;
+
+		old->prepared_queries = SwapPreparedStatements(NULL);
+		old->unnamed_stmt = *unnamed_stmt;
+		old->sequences = SwapSequenceCaches(NULL);
+		old->guc_state = SaveSessionGUCState(&old->guc_state_len, &poolable);
+	}
+
+	/*
+	 * Install the incoming session.  Do this before touching the settings,
+	 * so that any error reported from here on goes to its client.
+	 */
+	SwapPreparedStatements(session->prepared_queries);
+	session->prepared_queries = NULL;
+	SwapSequenceCaches(session->sequences);
+	session->sequences = NULL;
+	*unnamed_stmt = session->unnamed_stmt;
+	session->unnamed_stmt = NULL;
+	MyProcPort = session->port;
+	whereToSendOutput = DestRemote;
+	ActiveSession = session;
+
+	if (closed_port != NULL)
+	{
+		free_port(closed_port);
+		closed_port = NULL;
+	}
+
+	/*
+	 * Exchange the settings.  Check hooks may need catalog access, so do it
+	 * in a transaction of its own.
+	 */
+	if ((old != NULL && old->guc_state_len > 0) || session->guc_state_len > 0)
+	{
+		StartTransactionCommand();
+		if (old != NULL && old->guc_state_len > 0)
+			ResetSessionGUCState();
+		if (session->guc_state_len > 0)
+			RestoreSessionGUCState(session->guc_state, session->guc_state_len);
+		CommitTransactionCommand();
+	}
+
+	if (session->guc_state)
+		pfree(session->guc_state);
+	session->guc_state = NULL;
+	session->guc_state_len = 0;
+
+	MemoryContextSwitchTo(oldcontext);
+}
+
+/*
+ * Re-read the configuration file in a pooled backend.  The baseline must be
+ * taken without the settings of the active session in effect.
+ */
+static void
+reload_config(void)
+{
+	char	   *guc_state = NULL;
+	Size		guc_state_len = 0;
+	bool		poolable;
+
+	StartTransactionCommand();
+	if (ActiveSession != NULL)
+	{
+		guc_state = SaveSessionGUCState(&guc_state_len, &poolable);
+		ResetSessionGUCState();
+	}
+	ProcessConfigFile(PGC_SIGHUP);
+	CaptureGUCBaseline();
+	if (guc_state_len > 0)
+		RestoreSessionGUCState(guc_state, guc_state_len);
+	CommitTransactionCommand();
+}
+
+static void
+free_port(Port *port)
+{
+	if (port->remote_host)
+		pfree(port->remote_host);
+	if (port->remote_hostname)
+		pfree(port->remote_hostname);
+	if (port->remote_port)
+		pfree(port->remote_port);
+	if (port->database_name)
+		pfree(port->database_name);
+	if (port->user_name)
+		pfree(port->user_name);
+#if defined(ENABLE_GSS) || defined(ENABLE_SSPI)
+	free(port->gss);
+#endif
+	pfree(port);
+}
+
+#endif   /* HAVE_UNIX_SOCKETS */
+
+/*
+ * Choose the client session to read the next command from, in a pooled
+ * backend.  Called from the main loop of PostgresMain whenever it's about
+ * to wait for a command.
+ *
+ * The active session is kept if there's no switching away from it now: if
+ * it's in a transaction, holds a cursor or session lock, or has sent more
+ * input already.  can_switch is false if it is in the middle of an extended
+ * query message sequence.  Otherwise we wait for any session to send
+ * something, accepting new sessions meanwhile, and switch to the first one
+ * after the active session that has input.  A pending reload of the
+ * configuration file (flagged by *reload_pending) is also done here.
+ *
+ * Returns true if a different session became active.
+ */
+bool
+SessionPoolSchedule(CachedPlanSource **unnamed_stmt, bool can_switch,
+					volatile sig_atomic_t *reload_pending)
+{
+#ifdef HAVE_UNIX_SOCKETS
+	PooledSession *start = ActiveSession;
+	pgsocket   *socks;
+	bool	   *ready;
+	PooledSession **candidates;
+	int			nalloc = 0;
+
+	Assert(am_pooled_backend);
+
+	/* Get rid of a session whose client went away */
+	if (ActiveSession != NULL && ActiveSession->lost &&
+		!SessionPoolCloseSession(unnamed_stmt))
+		proc_exit(0);
+
+	if (ActiveSession != NULL &&
+		(!can_switch ||
+		 IsTransactionOrTransactionBlock() ||
+		 pq_buffer_has_data() ||
+		 !ThereAreNoReadyPortals() ||
+		 LockHasSessionLocks(USER_LOCKMETHOD)))
+		return false;
+
+	socks = NULL;
+	ready = NULL;
+	candidates = NULL;
+
+	for (;;)
+	{
+		dlist_iter	iter;
+		int			nsocks;
+		int			active = -1;
+		int			rc;
+		int			i;
+
+		if (*reload_pending)
+		{
+			*reload_pending = false;
+			reload_config();
+		}
+
+		if (nalloc < num_pooled_sessions + 1)
+		{
+			if (socks)
+			{
+				pfree(socks);
+				pfree(ready);
+				pfree(candidates);
+			}
+			nalloc = num_pooled_sessions + 16;
+			socks = (pgsocket *) palloc(nalloc * sizeof(pgsocket));
+			ready = (bool *) palloc(nalloc * sizeof(bool));
+			candidates = (PooledSession **)
+				palloc(nalloc * sizeof(PooledSession *));
+		}
+
+		/* The handoff socket comes first, then the sessions */
+		socks[0] = handoff_sock;
+		candidates[0] = NULL;
+		nsocks = 1;
+		dlist_foreach(iter, &pooled_sessions)
+		{
+			PooledSession *session = dlist_container(PooledSession, node,
+													 iter.cur);
+
+			if (session == ActiveSession)
+				active = nsocks;
+			socks[nsocks] = session->port->sock;
+			candidates[nsocks] = session;
+			nsocks++;
+		}
+
+		/*
+		 * With no sessions left, sessions handed over to us are still on
+		 * their way; but check every now and then whether a handoff failed
+		 * and we can go away.
+		 */
+		rc = WaitLatchOrSockets(MyLatch,
+								WL_LATCH_SET | WL_SOCKET_READABLE |
+								WL_POSTMASTER_DEATH |
+								(num_pooled_sessions == 0 ? WL_TIMEOUT : 0),
+								socks, ready, nsocks, 1000L);
+
+		if (rc & WL_POSTMASTER_DEATH)
+			ereport(FATAL,
+					(errcode(ERRCODE_ADMIN_SHUTDOWN),
+					 errmsg("terminating connection due to unexpected postmaster exit")));
+
+		if (rc & WL_LATCH_SET)
+		{
+			ResetLatch(MyLatch);
+			ProcessClientReadInterrupt(true);
+		}
+
+		if ((rc & WL_SOCKET_READABLE) && ready[0])
+			accept_handoffs(unnamed_stmt);
+
+		if (rc & WL_SOCKET_READABLE)
+		{
+			/* Look for input, starting after the active session */
+			for (i = 1; i < nsocks; i++)
+			{
+				int			n = active > 0 ?
+				(active - 1 + i) % (nsocks - 1) + 1 : i;
+
+				if (ready[n])
+				{
+					switch_to_session(candidates[n], unnamed_stmt);
+					pfree(socks);
+					pfree(ready);
+					pfree(candidates);
+					return ActiveSession != start;
+				}
+			}
+		}
+
+		if (num_pooled_sessions == 0)
+		{
+			bool		done;
+
+			SpinLockAcquire(&SessionPoolCtl->mutex);
+			done = (MyPooledBackend->nsessions == 0);
+			if (done)
+				MyPooledBackend->accepting = false;
+			SpinLockRelease(&SessionPoolCtl->mutex);
+
+			if (done)
+				proc_exit(0);
+		}
+	}
+#else
+	return false;
+#endif   /* HAVE_UNIX_SOCKETS */
+}
+
+/*
+ * End the active session of a pooled backend, when its client has
+ * disconnected.  Returns false if it was the last session and the backend
+ * should exit.
+ */
+bool
+SessionPoolCloseSession(CachedPlanSource **unnamed_stmt)
+{
+#ifdef HAVE_UNIX_SOCKETS
+	PooledSession *session = ActiveSession;
+	bool		last;
+	HTAB	   *prepared_queries;
+
+	Assert(am_pooled_backend && session != NULL);
+
+	SpinLockAcquire(&SessionPoolCtl->mutex);
+	last = (--MyPooledBackend->nsessions == 0);
+	if (last)
+		MyPooledBackend->accepting = false;
+	SpinLockRelease(&SessionPoolCtl->mutex);
+
+	if (last)
+		return false;
+
+	/* Discard everything the session leaves behind */
+	AbortOutOfAnyTransaction();
+	PortalHashTableDeleteAll();
+	LockReleaseAll(USER_LOCKMETHOD, true);
+
+	if (*unnamed_stmt)
+		DropCachedPlan(*unnamed_stmt);
+	*unnamed_stmt = NULL;
+	DropAllPreparedStatements();
+	prepared_queries = SwapPreparedStatements(NULL);
+	if (prepared_queries)
+		hash_destroy(prepared_queries);
+	ResetSequenceCaches();
+
+	StartTransactionCommand();
+	ResetSessionGUCState();
+	CommitTransactionCommand();
+
+	closesocket(session->port->sock);
+	session->port->sock = PGINVALID_SOCKET;
+	whereToSendOutput = DestNone;
+
+	/* MyProcPort stays valid until another session becomes active */
+	if (session->own_port)
+		closed_port = session->port;
+
+	dlist_delete(&session->node);
+	num_pooled_sessions--;
+	pfree(session);
+	ActiveSession = NULL;
+
+	return true;
+#else
+	return false;
+#endif   /* HAVE_UNIX_SOCKETS */
+}
+
+/*
+ * Note that the connection to the client of the active session has failed,
+ * or that the client broke the protocol so that we can't go on talking to
+ * it.  The session is closed the next time the backend looks for a command.
+ */
+void
+SessionPoolConnectionLost(void)
+{
+	if (ActiveSession != NULL)
+		ActiveSession->lost = true;
+}
+
+/*
+ * Forward a cancel request to a pooled backend.  Returns false if the given
+ * pid isn't one, in which case the caller handles the request.
+ *
+ * Called in the process the postmaster started for the cancel request.
+ */
+bool
+SessionPoolSignalCancel(int backendPID, long cancelAuthCode)
+{
+	bool		found = false;
+	int			i;
+
+	if (session_pool_size == 0)
+		return false;
+
+	SpinLockAcquire(&SessionPoolCtl->mutex);
+	for (i = 0; i < MaxConnections; i++)
+	{
+		PooledBackend *pb = &SessionPoolCtl->backends[i];
+
+		if (pb->pid == backendPID)
+		{
+			pb->cancel_pending = true;
+			pb->cancel_key = (int32) cancelAuthCode;
+			found = true;
+			break;
+		}
+	}
+	SpinLockRelease(&SessionPoolCtl->mutex);
+
+	if (found)
+	{
+		/* The backend checks the key against the session it's serving */
+		ereport(DEBUG2,
+				(errmsg_internal("processing cancel request: sending SIGINT to pooled backend %d",
+								 backendPID)));
+		kill(backendPID, SIGINT);
+	}
+
+	return found;
+}
+
+/*
+ * Should a query cancel interrupt cancel the query of the active session?
+ *
+ * A cancel request for another session doesn't; SIGINTs from other sources,
+ * such as pg_cancel_backend(), always do.
+ */
+bool
+SessionPoolCancelApplies(void)
+{
+	bool		pending;
+	int32		key;
+
+	SpinLockAcquire(&SessionPoolCtl->mutex);
+	pending = MyPooledBackend->cancel_pending;
+	key = MyPooledBackend->cancel_key;
+	MyPooledBackend->cancel_pending = false;
+	SpinLockRelease(&SessionPoolCtl->mutex);
+
+	if (!pending)
+		return true;
+
+	return ActiveSession != NULL && key == ActiveSession->cancel_key;
+}
+
+/*
+ * SQL-callable function reporting the pooled backends and their sessions.
+ */
+Datum
+pg_stat_get_session_pool(PG_FUNCTION_ARGS)
+{
+#define PG_STAT_GET_SESSION_POOL_COLS	4
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+	int			i;
+
+	/* check to see if caller supports us returning a tuplestore */
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("set-valued function called in context that cannot accept a set")));
+	if (!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("materialize mode required, but it is not " \
+						"allowed in this context")));
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	for (i = 0; i < MaxConnections; i++)
+	{
+		PooledBackend pb;
+		Datum		values[PG_STAT_GET_SESSION_POOL_COLS];
+		bool		nulls[PG_STAT_GET_SESSION_POOL_COLS];
+
+		SpinLockAcquire(&SessionPoolCtl->mutex);
+		memcpy(&pb, &SessionPoolCtl->backends[i], sizeof(PooledBackend));
+		SpinLockRelease(&SessionPoolCtl->mutex);
+
+		if (pb.pid == 0)
+			continue;
+
+		MemSet(nulls, 0, sizeof(nulls));
+		values[0] = Int32GetDatum(pb.pid);
+		values[1] = ObjectIdGetDatum(pb.dboid);
+		values[2] = ObjectIdGetDatum(pb.roleid);
+		values[3] = Int32GetDatum(pb.nsessions);
+
+		tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+	}
+
+	/* clean up and return the tuplestore */
+	tuplestore_donestoring(tupstore);
+
+	return (Datum) 0;
+}
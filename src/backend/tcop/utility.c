@@ -172,6 +172,7 @@ check_xact_readonly(Node *parsetree)
 		case T_CreateSchemaStmt:
 		case T_CreateSeqStmt:
 		case T_CreateStmt:
+		case T_CreateStatsStmt:
 		case T_CreateTableAsStmt:
 		case T_RefreshMatViewStmt:
 		case T_CreateTableSpaceStmt:
@@ -525,6 +526,11 @@ standard_ProcessUtility(Node *parsetree,
 			DropTableSpace((DropTableSpaceStmt *) parsetree);
 			break;
 
+		case T_CreateStatsStmt:
+			/* no event trigger support for statistics objects */
+			CreateStatistics((CreateStatsStmt *) parsetree);
+			break;
+
 		case T_AlterTableSpaceOptionsStmt:
 			/* no event triggers for global objects */
 			AlterTableSpaceOptions((AlterTableSpaceOptionsStmt *) parsetree);
@@ -1568,6 +1574,9 @@ ExecDropStmt(DropStmt *stmt, bool isTopLevel)
 		case OBJECT_FOREIGN_TABLE:
 			RemoveRelations(stmt);
 			break;
+		case OBJECT_STATISTIC_EXT:
+			RemoveStatisticsObjects(stmt);
+			break;
 		default:
 			RemoveObjects(stmt);
 			break;
@@ -2080,6 +2089,9 @@ CreateCommandTag(Node *parsetree)
 				case OBJECT_INDEX:
 					tag = "DROP INDEX";
 					break;
+				case OBJECT_STATISTIC_EXT:
+					tag = "DROP STATISTICS";
+					break;
 				case OBJECT_TYPE:
 					tag = "DROP TYPE";
 					break;
@@ -2292,6 +2304,10 @@ CreateCommandTag(Node *parsetree)
 			tag = "CREATE SEQUENCE";
 			break;
 
+		case T_CreateStatsStmt:
+			tag = "CREATE STATISTICS";
+			break;
+
 		case T_AlterSeqStmt:
 			tag = "ALTER SEQUENCE";
 			break;
@@ -2872,6 +2888,10 @@ GetCommandLogLevel(Node *parsetree)
 			lev = LOGSTMT_DDL;
 			break;
 
+		case T_CreateStatsStmt:
+			lev = LOGSTMT_DDL;
+			break;
+
 		case T_AlterSeqStmt:
 			lev = LOGSTMT_DDL;
 			break;
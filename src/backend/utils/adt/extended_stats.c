@@ -0,0 +1,914 @@
+/*-------------------------------------------------------------------------
+ *
+ * extended_stats.c
+ *	  Multi-column ("extended") statistics
+ *
+ * The per-column statistics in pg_statistic tell the planner nothing about
+ * how the values of different columns relate, so it has to assume that
+ * they're independent, multiplying the selectivities of restrictions on
+ * several columns of a table and the numbers of distinct values of several
+ * grouping columns.  With correlated columns, such as a city and its zip
+ * code, that badly underestimates the rows matching restrictions on both,
+ * and overestimates the number of groups.
+ *
+ * CREATE STATISTICS defines a statistics object on a group of columns, and
+ * ANALYZE then builds, from the same sample rows it uses for the per-column
+ * statistics, the kinds of multi-column statistics the object asks for:
+ *
+ * ndistinct: the estimated number of distinct values of each combination
+ * of two or more of the columns, used by estimate_num_groups().
+ *
+ * functional dependencies: for each combination of columns and each other
+ * column, the fraction of the sample rows whose values in the combination
+ * determine the value of the other column.  If the fraction ("degree") of
+ * the dependency a => b is f, then
+ *		P(a = x AND b = y) = P(a = x) * (f + (1 - f) * P(b = y))
+ * which clauselist_selectivity() uses for equality restrictions.
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *	  src/backend/utils/adt/extended_stats.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <math.h>
+
+#include "access/heapam.h"
+#include "access/htup_details.h"
+#include "catalog/indexing.h"
+#include "catalog/pg_collation.h"
+#include "catalog/pg_statistic_ext.h"
+#include "catalog/pg_type.h"
+#include "commands/vacuum.h"
+#include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
+#include "optimizer/cost.h"
+#include "utils/array.h"
+#include "utils/extended_stats.h"
+#include "utils/fmgroids.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/sortsupport.h"
+#include "utils/syscache.h"
+#include "utils/typcache.h"
+
+
+/*
+ * The sample values of the columns of one statistics object, and the
+ * support for sorting the sample rows by a subset of the columns.
+ */
+typedef struct StatExtSample
+{
+	int			numrows;		/* number of sample rows */
+	int			ncols;			/* number of columns */
+	AttrNumber	attnums[STATS_MAX_DIMENSIONS];	/* the columns */
+	Datum	   *values[STATS_MAX_DIMENSIONS];	/* per-column sample values */
+	bool	   *isnull[STATS_MAX_DIMENSIONS];	/* per-column null flags */
+	SortSupportData ssup[STATS_MAX_DIMENSIONS]; /* per-column sorting */
+} StatExtSample;
+
+/* qsort_arg context for sorting sample rows by some of the columns */
+typedef struct CompareRowsContext
+{
+	StatExtSample *sample;
+	int			ncols;			/* number of columns to compare */
+	int			cols[STATS_MAX_DIMENSIONS]; /* indexes into sample arrays */
+} CompareRowsContext;
+
+static bool fetch_sample(StatExtSample *sample, Relation onerel,
+			 int2vector *keys, int numrows, HeapTuple *rows);
+static int	compare_rows(const void *a, const void *b, void *arg);
+static void sort_rows_by(StatExtSample *sample, int *rowidx,
+			 CompareRowsContext *cxt, int mask, int lastcol);
+static MVNDistinct *build_ndistinct(StatExtSample *sample, double totalrows);
+static MVDependencies *build_dependencies(StatExtSample *sample);
+static void statext_store(Oid statOid, MVNDistinct *ndistinct,
+			  MVDependencies *dependencies);
+static bytea *serialize_stats(void *data, Size len);
+static bool dependency_compatible_clause(Node *clause, Index relid,
+							 AttrNumber *attnum);
+
+
+/*
+ * BuildRelationExtStatistics
+ *		Compute the extended statistics of all the statistics objects
+ *		defined on 'onerel', from the given sample rows, and store them in
+ *		pg_statistic_ext.
+ *
+ * 'totalrows' is the estimated total number of rows in the table.
+ */
+void
+BuildRelationExtStatistics(Relation onerel, double totalrows,
+						   int numrows, HeapTuple *rows)
+{
+	List	   *statoids;
+	ListCell   *lc;
+	MemoryContext cxt;
+	MemoryContext oldcxt;
+
+	statoids = RelationGetStatExtList(onerel);
+	if (statoids == NIL)
+		return;
+
+	cxt = AllocSetContextCreate(CurrentMemoryContext,
+								"Extended statistics",
+								ALLOCSET_DEFAULT_MINSIZE,
+								ALLOCSET_DEFAULT_INITSIZE,
+								ALLOCSET_DEFAULT_MAXSIZE);
+	oldcxt = MemoryContextSwitchTo(cxt);
+
+	foreach(lc, statoids)
+	{
+		Oid			statOid = lfirst_oid(lc);
+		HeapTuple	htup;
+		Form_pg_statistic_ext statform;
+		Datum		datum;
+		bool		isnull;
+		ArrayType  *arr;
+		char	   *kinds;
+		int			nkinds;
+		bool		want_ndistinct = false;
+		bool		want_dependencies = false;
+		StatExtSample sample;
+		MVNDistinct *ndistinct = NULL;
+		MVDependencies *dependencies = NULL;
+		int			i;
+
+		htup = SearchSysCache1(STATEXTOID, ObjectIdGetDatum(statOid));
+		if (!HeapTupleIsValid(htup))
+			continue;			/* concurrently dropped */
+		statform = (Form_pg_statistic_ext) GETSTRUCT(htup);
+
+		datum = SysCacheGetAttr(STATEXTOID, htup,
+								Anum_pg_statistic_ext_stxkind, &isnull);
+		Assert(!isnull);
+		arr = DatumGetArrayTypeP(datum);
+		if (ARR_NDIM(arr) != 1 || ARR_HASNULL(arr) ||
+			ARR_ELEMTYPE(arr) != CHAROID)
+			elog(ERROR, "stxkind is not a 1-D char array");
+		kinds = (char *) ARR_DATA_PTR(arr);
+		nkinds = ARR_DIMS(arr)[0];
+		for (i = 0; i < nkinds; i++)
+		{
+			if (kinds[i] == STATS_EXT_NDISTINCT)
+				want_ndistinct = true;
+			else if (kinds[i] == STATS_EXT_DEPENDENCIES)
+				want_dependencies = true;
+		}
+
+		if (numrows >= 2 &&
+			fetch_sample(&sample, onerel, &statform->stxkeys,
+						 numrows, rows))
+		{
+			if (want_ndistinct)
+				ndistinct = build_ndistinct(&sample, totalrows);
+			if (want_dependencies)
+				dependencies = build_dependencies(&sample);
+		}
+
+		ReleaseSysCache(htup);
+
+		statext_store(statOid, ndistinct, dependencies);
+
+		MemoryContextResetAndDeleteChildren(cxt);
+	}
+
+	MemoryContextSwitchTo(oldcxt);
+	MemoryContextDelete(cxt);
+}
+
+/*
+ * fetch_sample
+ *		Extract the values of the statistics object's columns from the
+ *		sample rows, and set up sorting for them.
+ *
+ * Returns false if some column's type has no default btree ordering (it
+ * might have been changed after the statistics object was created), in
+ * which case we can't build anything.
+ */
+static bool
+fetch_sample(StatExtSample *sample, Relation onerel, int2vector *keys,
+			 int numrows, HeapTuple *rows)
+{
+	TupleDesc	tupdesc = RelationGetDescr(onerel);
+	int			i;
+	int			j;
+
+	sample->numrows = numrows;
+	sample->ncols = keys->dim1;
+	Assert(sample->ncols >= 2 && sample->ncols <= STATS_MAX_DIMENSIONS);
+
+	for (j = 0; j < sample->ncols; j++)
+	{
+		AttrNumber	attnum = keys->values[j];
+		Form_pg_attribute attr = tupdesc->attrs[attnum - 1];
+		TypeCacheEntry *typentry;
+		bool		is_varlena = (!attr->attbyval && attr->attlen == -1);
+
+		if (attr->attisdropped)
+			return false;
+
+		typentry = lookup_type_cache(attr->atttypid, TYPECACHE_LT_OPR);
+		if (!OidIsValid(typentry->lt_opr))
+			return false;
+
+		sample->attnums[j] = attnum;
+
+		memset(&sample->ssup[j], 0, sizeof(SortSupportData));
+		sample->ssup[j].ssup_cxt = CurrentMemoryContext;
+		/* We always use the default collation for statistics */
+		sample->ssup[j].ssup_collation = DEFAULT_COLLATION_OID;
+		sample->ssup[j].ssup_nulls_first = false;
+		sample->ssup[j].abbreviate = false;
+		PrepareSortSupportFromOrderingOp(typentry->lt_opr, &sample->ssup[j]);
+
+		sample->values[j] = (Datum *) palloc(numrows * sizeof(Datum));
+		sample->isnull[j] = (bool *) palloc(numrows * sizeof(bool));
+		for (i = 0; i < numrows; i++)
+		{
+			Datum		value;
+			bool		isnull;
+
+			value = heap_getattr(rows[i], attnum, tupdesc, &isnull);
+			if (!isnull && is_varlena)
+				value = PointerGetDatum(PG_DETOAST_DATUM(value));
+			sample->values[j][i] = value;
+			sample->isnull[j][i] = isnull;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * qsort_arg comparator for sorting sample row numbers by the columns in the
+ * CompareRowsContext.  Nulls sort last and are equal to each other, so that
+ * they form a group of their own.
+ */
+static int
+compare_rows(const void *a, const void *b, void *arg)
+{
+	int			ra = *(const int *) a;
+	int			rb = *(const int *) b;
+	CompareRowsContext *cxt = (CompareRowsContext *) arg;
+	StatExtSample *sample = cxt->sample;
+	int			i;
+
+	for (i = 0; i < cxt->ncols; i++)
+	{
+		int			col = cxt->cols[i];
+		int			compare;
+
+		compare = ApplySortComparator(sample->values[col][ra],
+									  sample->isnull[col][ra],
+									  sample->values[col][rb],
+									  sample->isnull[col][rb],
+									  &sample->ssup[col]);
+		if (compare != 0)
+			return compare;
+	}
+
+	return 0;
+}
+
+/*
+ * sort_rows_by
+ *		Sort the sample row numbers in 'rowidx' by the columns in the bitmask
+ *		'mask', then by column 'lastcol' if it's >= 0.
+ *
+ * On return, 'cxt' is set up to compare rows by the columns in 'mask' only.
+ */
+static void
+sort_rows_by(StatExtSample *sample, int *rowidx, CompareRowsContext *cxt,
+			 int mask, int lastcol)
+{
+	int			i;
+
+	cxt->sample = sample;
+	cxt->ncols = 0;
+	for (i = 0; i < sample->ncols; i++)
+	{
+		if (mask & (1 << i))
+			cxt->cols[cxt->ncols++] = i;
+	}
+	if (lastcol >= 0)
+		cxt->cols[cxt->ncols++] = lastcol;
+
+	for (i = 0; i < sample->numrows; i++)
+		rowidx[i] = i;
+	qsort_arg((void *) rowidx, sample->numrows, sizeof(int),
+			  compare_rows, (void *) cxt);
+
+	if (lastcol >= 0)
+		cxt->ncols--;
+}
+
+/*
+ * build_ndistinct
+ *		Estimate the number of distinct values of each combination of two or
+ *		more of the columns.
+ *
+ * We use the same estimator as compute_scalar_stats() does for a single
+ * column, treating each combination of values as one value.
+ */
+static MVNDistinct *
+build_ndistinct(StatExtSample *sample, double totalrows)
+{
+	int			ncols = sample->ncols;
+	int			numrows = sample->numrows;
+	int			maxitems = (1 << ncols) - ncols - 1;
+	MVNDistinct *result;
+	int		   *rowidx;
+	int			mask;
+
+	result = (MVNDistinct *) palloc0(offsetof(MVNDistinct, items) +
+									 maxitems * sizeof(MVNDistinctItem));
+	result->magic = STATS_NDISTINCT_MAGIC;
+	rowidx = (int *) palloc(numrows * sizeof(int));
+
+	for (mask = 1; mask < (1 << ncols); mask++)
+	{
+		CompareRowsContext cxt;
+		MVNDistinctItem *item;
+		int			ndistinct = 1;
+		int			nsingle = 0;
+		int			groupsize = 1;
+		double		stadistinct;
+		int			i;
+
+		/* Single columns are covered by pg_statistic */
+		if ((mask & (mask - 1)) == 0)
+			continue;
+
+		vacuum_delay_point();
+
+		sort_rows_by(sample, rowidx, &cxt, mask, -1);
+
+		for (i = 1; i < numrows; i++)
+		{
+			if (compare_rows(&rowidx[i - 1], &rowidx[i], &cxt) != 0)
+			{
+				if (groupsize == 1)
+					nsingle++;
+				ndistinct++;
+				groupsize = 0;
+			}
+			groupsize++;
+		}
+		if (groupsize == 1)
+			nsingle++;
+
+		if (nsingle == ndistinct)
+		{
+			/* If we found no repeated values, assume it's unique */
+			stadistinct = -1.0;
+		}
+		else if (nsingle == 0)
+		{
+			/* Every value appeared more than once; assume that's all */
+			stadistinct = ndistinct;
+		}
+		else
+		{
+			/* The Haas-Stokes estimator, see compute_scalar_stats() */
+			double		n = numrows;
+			double		f1 = nsingle;
+			double		d = ndistinct;
+			double		denom;
+
+			denom = (n - f1) + f1 * n / totalrows;
+			stadistinct = (n * d) / denom;
+			/* Clamp to sane range in case of roundoff error */
+			if (stadistinct < d)
+				stadistinct = d;
+			if (stadistinct > totalrows)
+				stadistinct = totalrows;
+			stadistinct = floor(stadistinct + 0.5);
+
+			/*
+			 * If the estimate is more than 10% of the rows, assume that it
+			 * scales with the table, as compute_scalar_stats() does.
+			 */
+			if (stadistinct > 0.1 * totalrows)
+				stadistinct = -(stadistinct / totalrows);
+		}
+
+		item = &result->items[result->nitems++];
+		item->ndistinct = stadistinct;
+		item->nattrs = 0;
+		for (i = 0; i < ncols; i++)
+		{
+			if (mask & (1 << i))
+				item->attrs[item->nattrs++] = sample->attnums[i];
+		}
+	}
+
+	Assert(result->nitems == maxitems);
+
+	return result;
+}
+
+/*
+ * build_dependencies
+ *		Measure the degree of the functional dependency of each column on
+ *		each combination of the other columns.
+ *
+ * The degree is the fraction of the sample rows belonging to groups of
+ * equal values of the determining columns that all have the same value of
+ * the dependent column.  We sort the rows by the determining columns and
+ * then by the dependent one, so that for each group it's enough to compare
+ * its first and last rows.  Dependencies of degree zero aren't stored.
+ */
+static MVDependencies *
+build_dependencies(StatExtSample *sample)
+{
+	int			ncols = sample->ncols;
+	int			numrows = sample->numrows;
+	int			maxdeps = ncols * (1 << (ncols - 1));
+	MVDependencies *result;
+	int		   *rowidx;
+	int			mask;
+
+	result = (MVDependencies *) palloc0(offsetof(MVDependencies, deps) +
+										maxdeps * sizeof(MVDependency));
+	result->magic = STATS_DEPENDENCIES_MAGIC;
+	rowidx = (int *) palloc(numrows * sizeof(int));
+
+	/* The full set of columns doesn't determine any other column */
+	for (mask = 1; mask < (1 << ncols) - 1; mask++)
+	{
+		int			dependent;
+
+		for (dependent = 0; dependent < ncols; dependent++)
+		{
+			CompareRowsContext cxt;
+			CompareRowsContext depcxt;
+			MVDependency *dep;
+			int			supporting = 0;
+			int			groupstart = 0;
+			int			i;
+
+			if (mask & (1 << dependent))
+				continue;
+
+			vacuum_delay_point();
+
+			sort_rows_by(sample, rowidx, &cxt, mask, dependent);
+
+			depcxt.sample = sample;
+			depcxt.ncols = 1;
+			depcxt.cols[0] = dependent;
+
+			for (i = 1; i <= numrows; i++)
+			{
+				if (i < numrows &&
+					compare_rows(&rowidx[i - 1], &rowidx[i], &cxt) == 0)
+					continue;
+
+				/* rows groupstart .. i-1 form a group */
+				if (compare_rows(&rowidx[groupstart], &rowidx[i - 1],
+								 &depcxt) == 0)
+					supporting += i - groupstart;
+				groupstart = i;
+			}
+
+			if (supporting == 0)
+				continue;
+
+			dep = &result->deps[result->ndeps++];
+			dep->degree = (double) supporting / (double) numrows;
+			dep->nattrs = 0;
+			for (i = 0; i < ncols; i++)
+			{
+				if (mask & (1 << i))
+					dep->attrs[dep->nattrs++] = sample->attnums[i];
+			}
+			dep->attrs[dep->nattrs++] = sample->attnums[dependent];
+		}
+	}
+
+	return result;
+}
+
+/*
+ * serialize_stats
+ *		Wrap the given struct into a bytea.
+ *
+ * The statistics are only ever read back by this module, on the same
+ * architecture, so a plain copy is good enough.
+ */
+static bytea *
+serialize_stats(void *data, Size len)
+{
+	bytea	   *result = (bytea *) palloc(VARHDRSZ + len);
+
+	SET_VARSIZE(result, VARHDRSZ + len);
+	memcpy(VARDATA(result), data, len);
+
+	return result;
+}
+
+/*
+ * statext_store
+ *		Replace the statistics stored in a pg_statistic_ext entry.  NULL
+ *		arguments reset the corresponding statistics.
+ */
+static void
+statext_store(Oid statOid, MVNDistinct *ndistinct,
+			  MVDependencies *dependencies)
+{
+	Relation	pg_stext;
+	HeapTuple	oldtup;
+	HeapTuple	newtup;
+	Datum		values[Natts_pg_statistic_ext];
+	bool		nulls[Natts_pg_statistic_ext];
+	bool		replaces[Natts_pg_statistic_ext];
+
+	memset(nulls, true, sizeof(nulls));
+	memset(replaces, false, sizeof(replaces));
+	memset(values, 0, sizeof(values));
+
+	replaces[Anum_pg_statistic_ext_stxndistinct - 1] = true;
+	replaces[Anum_pg_statistic_ext_stxdependencies - 1] = true;
+
+	if (ndistinct != NULL)
+	{
+		Size		len = offsetof(MVNDistinct, items) +
+		ndistinct->nitems * sizeof(MVNDistinctItem);
+
+		nulls[Anum_pg_statistic_ext_stxndistinct - 1] = false;
+		values[Anum_pg_statistic_ext_stxndistinct - 1] =
+			PointerGetDatum(serialize_stats(ndistinct, len));
+	}
+	if (dependencies != NULL)
+	{
+		Size		len = offsetof(MVDependencies, deps) +
+		dependencies->ndeps * sizeof(MVDependency);
+
+		nulls[Anum_pg_statistic_ext_stxdependencies - 1] = false;
+		values[Anum_pg_statistic_ext_stxdependencies - 1] =
+			PointerGetDatum(serialize_stats(dependencies, len));
+	}
+
+	pg_stext = heap_open(StatisticExtRelationId, RowExclusiveLock);
+
+	oldtup = SearchSysCache1(STATEXTOID, ObjectIdGetDatum(statOid));
+	if (!HeapTupleIsValid(oldtup))
+	{
+		/* concurrently dropped */
+		heap_close(pg_stext, RowExclusiveLock);
+		return;
+	}
+
+	newtup = heap_modify_tuple(oldtup, RelationGetDescr(pg_stext),
+							   values, nulls, replaces);
+	ReleaseSysCache(oldtup);
+	simple_heap_update(pg_stext, &newtup->t_self, newtup);
+	CatalogUpdateIndexes(pg_stext, newtup);
+
+	heap_freetuple(newtup);
+	heap_close(pg_stext, RowExclusiveLock);
+}
+
+/*
+ * statext_is_kind_built
+ *		Have the statistics of the given kind been built for the
+ *		pg_statistic_ext tuple?
+ */
+bool
+statext_is_kind_built(HeapTuple htup, char kind)
+{
+	AttrNumber	attnum;
+
+	switch (kind)
+	{
+		case STATS_EXT_NDISTINCT:
+			attnum = Anum_pg_statistic_ext_stxndistinct;
+			break;
+		case STATS_EXT_DEPENDENCIES:
+			attnum = Anum_pg_statistic_ext_stxdependencies;
+			break;
+		default:
+			elog(ERROR, "unrecognized statistic kind: %c", kind);
+			attnum = 0;			/* keep compiler quiet */
+			break;
+	}
+
+	return !heap_attisnull(htup, attnum);
+}
+
+/*
+ * statext_load
+ *		Fetch a copy of the statistics stored in the given column of a
+ *		pg_statistic_ext entry, checking that they look sane.  'header' is
+ *		the size of the struct before its array of 'itemsize' items.
+ */
+static void *
+statext_load(Oid statOid, AttrNumber attnum, uint32 magic,
+			 Size header, Size itemsize)
+{
+	HeapTuple	htup;
+	Datum		datum;
+	bool		isnull;
+	bytea	   *data;
+	Size		len;
+	void	   *result;
+	uint32		datamagic;
+	int			nitems;
+
+	htup = SearchSysCache1(STATEXTOID, ObjectIdGetDatum(statOid));
+	if (!HeapTupleIsValid(htup))
+		elog(ERROR, "cache lookup failed for statistics object %u", statOid);
+
+	datum = SysCacheGetAttr(STATEXTOID, htup, attnum, &isnull);
+	if (isnull)
+		elog(ERROR, "statistics of statistics object %u have not been built",
+			 statOid);
+
+	data = DatumGetByteaP(datum);
+	len = VARSIZE(data) - VARHDRSZ;
+	if (len < header)
+		elog(ERROR, "invalid extended statistics of statistics object %u",
+			 statOid);
+
+	result = palloc(len);
+	memcpy(result, VARDATA(data), len);
+	ReleaseSysCache(htup);
+
+	/* Both structs start with the magic number and item count */
+	datamagic = *(uint32 *) result;
+	nitems = ((int *) result)[1];
+	if (datamagic != magic || nitems < 0 ||
+		len != header + nitems * itemsize)
+		elog(ERROR, "invalid extended statistics of statistics object %u",
+			 statOid);
+
+	return result;
+}
+
+/*
+ * statext_ndistinct_load
+ *		Fetch the ndistinct statistics of a statistics object.
+ */
+MVNDistinct *
+statext_ndistinct_load(Oid statOid)
+{
+	StaticAssertStmt(offsetof(MVNDistinct, nitems) == sizeof(uint32),
+					 "unexpected MVNDistinct layout");
+
+	return (MVNDistinct *) statext_load(statOid,
+										Anum_pg_statistic_ext_stxndistinct,
+										STATS_NDISTINCT_MAGIC,
+										offsetof(MVNDistinct, items),
+										sizeof(MVNDistinctItem));
+}
+
+/*
+ * statext_dependencies_load
+ *		Fetch the functional dependencies of a statistics object.
+ */
+MVDependencies *
+statext_dependencies_load(Oid statOid)
+{
+	StaticAssertStmt(offsetof(MVDependencies, ndeps) == sizeof(uint32),
+					 "unexpected MVDependencies layout");
+
+	return (MVDependencies *) statext_load(statOid,
+									   Anum_pg_statistic_ext_stxdependencies,
+										   STATS_DEPENDENCIES_MAGIC,
+										   offsetof(MVDependencies, deps),
+										   sizeof(MVDependency));
+}
+
+/*
+ * choose_best_statistics
+ *		Choose the statistics of the given kind that cover the most of the
+ *		columns in 'attnums', from the StatisticExtInfos in 'stats'.
+ *
+ * Statistics covering fewer than two of the columns are useless.  Among
+ * those covering equally many, we prefer the ones on fewer columns, whose
+ * estimates are likely to be more accurate.  Returns NULL if there's
+ * nothing suitable.
+ */
+StatisticExtInfo *
+choose_best_statistics(List *stats, Bitmapset *attnums, char requiredkind)
+{
+	StatisticExtInfo *best = NULL;
+	int			best_matched = 1;
+	int			best_nkeys = 0;
+	ListCell   *lc;
+
+	foreach(lc, stats)
+	{
+		StatisticExtInfo *info = (StatisticExtInfo *) lfirst(lc);
+		Bitmapset  *matched;
+		int			nmatched;
+		int			nkeys;
+
+		if (info->kind != requiredkind)
+			continue;
+
+		matched = bms_intersect(attnums, info->keys);
+		nmatched = bms_num_members(matched);
+		bms_free(matched);
+		nkeys = bms_num_members(info->keys);
+
+		if (nmatched > best_matched ||
+			(nmatched == best_matched && best != NULL && nkeys < best_nkeys))
+		{
+			best = info;
+			best_matched = nmatched;
+			best_nkeys = nkeys;
+		}
+	}
+
+	return best;
+}
+
+/*
+ * dependency_compatible_clause
+ *		Can the functional dependencies be used for the clause?
+ *
+ * They can for equality restrictions "Var = pseudo-constant" on a user
+ * column of relation 'relid', whose operator uses eqsel() for its estimates.
+ * If so, the column is returned in *attnum.
+ */
+static bool
+dependency_compatible_clause(Node *clause, Index relid, AttrNumber *attnum)
+{
+	OpExpr	   *expr;
+	Node	   *left;
+	Node	   *right;
+	Var		   *var;
+
+	if (IsA(clause, RestrictInfo))
+	{
+		RestrictInfo *rinfo = (RestrictInfo *) clause;
+
+		if (rinfo->pseudoconstant)
+			return false;
+		if (!bms_is_member(relid, rinfo->clause_relids) ||
+			bms_membership(rinfo->clause_relids) != BMS_SINGLETON)
+			return false;
+		clause = (Node *) rinfo->clause;
+	}
+
+	if (!is_opclause(clause) || list_length(((OpExpr *) clause)->args) != 2)
+		return false;
+	expr = (OpExpr *) clause;
+
+	left = (Node *) linitial(expr->args);
+	right = (Node *) lsecond(expr->args);
+	if (IsA(left, RelabelType))
+		left = (Node *) ((RelabelType *) left)->arg;
+	if (IsA(right, RelabelType))
+		right = (Node *) ((RelabelType *) right)->arg;
+
+	if (IsA(left, Var) && is_pseudo_constant_clause(right))
+		var = (Var *) left;
+	else if (IsA(right, Var) && is_pseudo_constant_clause(left))
+		var = (Var *) right;
+	else
+		return false;
+
+	if (var->varno != relid || var->varlevelsup != 0 ||
+		!AttrNumberIsForUserDefinedAttr(var->varattno))
+		return false;
+
+	if (get_oprrest(expr->opno) != F_EQSEL)
+		return false;
+
+	*attnum = var->varattno;
+	return true;
+}
+
+/*
+ * dependencies_clauselist_selectivity
+ *		Estimate the combined selectivity of those of 'clauses' that
+ *		functional dependencies on 'rel' apply to.
+ *
+ * We pick the statistics covering the most of the columns restricted by
+ * compatible clauses, and then repeatedly the strongest of its dependencies
+ * whose columns are all restricted, preferring those with more determining
+ * columns.  The selectivity of the clauses on a dependency's dependent
+ * column is replaced by (f + (1 - f) * s), f being the degree of the
+ * dependency, and the column isn't considered further.
+ *
+ * The list indexes of the clauses estimated here are added to
+ * *estimatedclauses; the caller must multiply the result by the
+ * selectivities of the others.
+ */
+Selectivity
+dependencies_clauselist_selectivity(PlannerInfo *root,
+									List *clauses,
+									int varRelid,
+									JoinType jointype,
+									SpecialJoinInfo *sjinfo,
+									RelOptInfo *rel,
+									Bitmapset **estimatedclauses)
+{
+	Selectivity s1 = 1.0;
+	AttrNumber *list_attnums;
+	Bitmapset  *clauses_attnums = NULL;
+	StatisticExtInfo *stat;
+	MVDependencies *dependencies;
+	ListCell   *lc;
+	int			listidx;
+
+	if (rel == NULL || rel->rtekind != RTE_RELATION || rel->statlist == NIL)
+		return 1.0;
+
+	list_attnums = (AttrNumber *) palloc(sizeof(AttrNumber) *
+										 list_length(clauses));
+	listidx = 0;
+	foreach(lc, clauses)
+	{
+		Node	   *clause = (Node *) lfirst(lc);
+		AttrNumber	attnum;
+
+		if (dependency_compatible_clause(clause, rel->relid, &attnum))
+		{
+			list_attnums[listidx] = attnum;
+			clauses_attnums = bms_add_member(clauses_attnums, attnum);
+		}
+		else
+			list_attnums[listidx] = InvalidAttrNumber;
+		listidx++;
+	}
+
+	if (bms_num_members(clauses_attnums) < 2)
+	{
+		pfree(list_attnums);
+		return 1.0;
+	}
+
+	stat = choose_best_statistics(rel->statlist, clauses_attnums,
+								  STATS_EXT_DEPENDENCIES);
+	if (stat == NULL)
+	{
+		pfree(list_attnums);
+		return 1.0;
+	}
+
+	dependencies = statext_dependencies_load(stat->statOid);
+
+	for (;;)
+	{
+		MVDependency *strongest = NULL;
+		AttrNumber	dependent;
+		int			i;
+
+		for (i = 0; i < dependencies->ndeps; i++)
+		{
+			MVDependency *dep = &dependencies->deps[i];
+			int			j;
+
+			for (j = 0; j < dep->nattrs; j++)
+			{
+				if (!bms_is_member(dep->attrs[j], clauses_attnums))
+					break;
+			}
+			if (j < dep->nattrs)
+				continue;
+
+			if (strongest == NULL ||
+				dep->nattrs > strongest->nattrs ||
+				(dep->nattrs == strongest->nattrs &&
+				 dep->degree > strongest->degree))
+				strongest = dep;
+		}
+
+		if (strongest == NULL)
+			break;
+
+		dependent = strongest->attrs[strongest->nattrs - 1];
+
+		listidx = 0;
+		foreach(lc, clauses)
+		{
+			if (list_attnums[listidx] == dependent)
+			{
+				Selectivity s2;
+
+				s2 = clause_selectivity(root, (Node *) lfirst(lc),
+										varRelid, jointype, sjinfo);
+				s1 *= strongest->degree + (1.0 - strongest->degree) * s2;
+				*estimatedclauses = bms_add_member(*estimatedclauses, listidx);
+			}
+			listidx++;
+		}
+
+		clauses_attnums = bms_del_member(clauses_attnums, dependent);
+	}
+
+	pfree(dependencies);
+	pfree(list_attnums);
+
+	return s1;
+}
@@ -31,6 +31,8 @@
 #include "catalog/pg_language.h"
 #include "catalog/pg_opclass.h"
 #include "catalog/pg_operator.h"
+#include "catalog/pg_partition.h"
+#include "catalog/pg_partitioned_table.h"
 #include "catalog/pg_proc.h"
 #include "catalog/pg_tablesample_method.h"
 #include "catalog/pg_trigger.h"
@@ -406,6 +408,7 @@ static void get_const_expr(Const *constval, deparse_context *context,
 			   int showtype);
 static void get_const_collation(Const *constval, deparse_context *context);
 static void simple_quote_literal(StringInfo buf, const char *val);
+static void get_partition_bound_datum(StringInfo buf, Const *datum);
 static void get_sublink_expr(SubLink *sublink, deparse_context *context);
 static void get_from_clause(Query *query, const char *prefix,
 				deparse_context *context);
@@ -1122,6 +1125,19 @@ pg_get_indexdef_worker(Oid indexrelid, int colno,
 		Oid			keycoltype;
 		Oid			keycolcollation;
 
+		/*
+		 * Included (non-key) columns follow the key columns, in their own
+		 * INCLUDE clause.  They're not part of a constraint definition.
+		 */
+		if (keyno == idxrec->indnkeyatts)
+		{
+			if (attrsOnly)
+				break;
+			if (!colno)
+				appendStringInfoString(&buf, ") INCLUDE (");
+			sep = "";
+		}
+
 		if (!colno)
 			appendStringInfoString(&buf, sep);
 		sep = ", ";
@@ -1164,7 +1180,8 @@ pg_get_indexdef_worker(Oid indexrelid, int colno,
 			keycolcollation = exprCollation(indexkey);
 		}
 
-		if (!attrsOnly && (!colno || colno == keyno + 1))
+		if (!attrsOnly && keyno < idxrec->indnkeyatts &&
+			(!colno || colno == keyno + 1))
 		{
 			Oid			indcoll;
 
@@ -1666,6 +1683,143 @@ decompile_column_index_array(Datum column_index_array, Oid relId,
 }
 
 
+/*
+ * pg_get_partkeydef
+ *
+ * Returns the partition key of a partitioned table, ie, everything that
+ * needs to appear after "PARTITION BY", or NULL if the table isn't
+ * partitioned.
+ */
+Datum
+pg_get_partkeydef(PG_FUNCTION_ARGS)
+{
+	Oid			relid = PG_GETARG_OID(0);
+	HeapTuple	tuple;
+	Form_pg_partitioned_table form;
+	StringInfoData buf;
+
+	tuple = SearchSysCache1(PARTRELID, ObjectIdGetDatum(relid));
+	if (!HeapTupleIsValid(tuple))
+		PG_RETURN_NULL();
+	form = (Form_pg_partitioned_table) GETSTRUCT(tuple);
+
+	/*
+	 * The key's operator class and collation are those of the column, so
+	 * the column name is all that's needed to re-create it.
+	 */
+	initStringInfo(&buf);
+	appendStringInfo(&buf, "%s (%s)",
+					 form->partstrat == PARTITION_STRATEGY_RANGE ?
+					 "RANGE" : "LIST",
+			quote_identifier(get_relid_attribute_name(relid,
+													  form->partattnum)));
+
+	ReleaseSysCache(tuple);
+
+	PG_RETURN_TEXT_P(string_to_text(buf.data));
+}
+
+/*
+ * pg_get_partition_bound
+ *
+ * Returns the bound of a partition, ie, the FOR VALUES clause of the
+ * CREATE TABLE ... PARTITION OF command that created it, or NULL if the
+ * table isn't a partition.
+ */
+Datum
+pg_get_partition_bound(PG_FUNCTION_ARGS)
+{
+	Oid			relid = PG_GETARG_OID(0);
+	HeapTuple	tuple;
+	Datum		datum;
+	bool		isnull;
+	PartitionBoundSpec *spec;
+	StringInfoData buf;
+	ListCell   *lc;
+
+	tuple = SearchSysCache1(PARTITIONRELID, ObjectIdGetDatum(relid));
+	if (!HeapTupleIsValid(tuple))
+		PG_RETURN_NULL();
+
+	datum = SysCacheGetAttr(PARTITIONRELID, tuple,
+							Anum_pg_partition_partbound, &isnull);
+	if (isnull)
+		elog(ERROR, "null partbound for partition %u", relid);
+	spec = (PartitionBoundSpec *) stringToNode(TextDatumGetCString(datum));
+
+	ReleaseSysCache(tuple);
+
+	initStringInfo(&buf);
+	if (spec->strategy == PARTITION_STRATEGY_LIST)
+	{
+		appendStringInfoString(&buf, "FOR VALUES IN (");
+		foreach(lc, spec->listdatums)
+		{
+			if (lc != list_head(spec->listdatums))
+				appendStringInfoString(&buf, ", ");
+			get_partition_bound_datum(&buf, (Const *) lfirst(lc));
+		}
+		appendStringInfoChar(&buf, ')');
+	}
+	else
+	{
+		appendStringInfoString(&buf, "FOR VALUES FROM (");
+		get_partition_bound_datum(&buf, (Const *) spec->lowerdatum);
+		appendStringInfoString(&buf, ") TO (");
+		get_partition_bound_datum(&buf, (Const *) spec->upperdatum);
+		appendStringInfoChar(&buf, ')');
+	}
+
+	PG_RETURN_TEXT_P(string_to_text(buf.data));
+}
+
+/*
+ * Append one datum of a partition bound, NULL standing for UNBOUNDED.
+ *
+ * The grammar only accepts numbers and string literals there, so anything
+ * that doesn't look like an unsigned or negative number is quoted; it's
+ * coerced to the key's type when the bound is read back.
+ */
+static void
+get_partition_bound_datum(StringInfo buf, Const *datum)
+{
+	Oid			typoutput;
+	bool		typIsVarlena;
+	char	   *extval;
+	const char *digits;
+
+	if (datum == NULL)
+	{
+		appendStringInfoString(buf, "UNBOUNDED");
+		return;
+	}
+
+	getTypeOutputInfo(datum->consttype, &typoutput, &typIsVarlena);
+	extval = OidOutputFunctionCall(typoutput, datum->constvalue);
+
+	digits = (extval[0] == '-') ? extval + 1 : extval;
+	switch (datum->consttype)
+	{
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+		case FLOAT4OID:
+		case FLOAT8OID:
+		case NUMERICOID:
+			if (isdigit((unsigned char) digits[0]) &&
+				strspn(digits, "0123456789+-eE.") == strlen(digits))
+			{
+				appendStringInfoString(buf, extval);
+				break;
+			}
+			/* FALL THRU */
+		default:
+			simple_quote_literal(buf, extval);
+			break;
+	}
+}
+
+
 /* ----------
  * get_expr			- Decompile an expression tree
  *
@@ -107,6 +107,7 @@
 #include "catalog/pg_collation.h"
 #include "catalog/pg_opfamily.h"
 #include "catalog/pg_statistic.h"
+#include "catalog/pg_statistic_ext.h"
 #include "catalog/pg_type.h"
 #include "executor/executor.h"
 #include "mb/pg_wchar.h"
@@ -127,6 +128,7 @@
 #include "utils/bytea.h"
 #include "utils/date.h"
 #include "utils/datum.h"
+#include "utils/extended_stats.h"
 #include "utils/fmgroids.h"
 #include "utils/lsyscache.h"
 #include "utils/nabstime.h"
@@ -3141,6 +3143,93 @@ add_unique_group_var(PlannerInfo *root, List *varinfos,
 	return varinfos;
 }
 
+/*
+ * Helper routine for estimate_num_groups: estimate the number of distinct
+ * combinations of the values of as many as possible of the GroupVarInfos
+ * in *varinfos, all belonging to 'rel', using its multi-column ndistinct
+ * statistics.
+ *
+ * On success, the estimate is returned in *ndistinct, the GroupVarInfos it
+ * covers are removed from *varinfos, and we return true.  Returns false if
+ * there are no statistics covering at least two of the Vars.
+ */
+static bool
+estimate_multivariate_ndistinct(PlannerInfo *root, RelOptInfo *rel,
+								List **varinfos, double *ndistinct)
+{
+	Bitmapset  *attnums = NULL;
+	Bitmapset  *matched;
+	StatisticExtInfo *stat;
+	MVNDistinct *stats;
+	MVNDistinctItem *item = NULL;
+	List	   *newlist = NIL;
+	ListCell   *lc;
+	int			i;
+
+	/* bail out immediately if the table has no extended statistics */
+	if (rel->statlist == NIL)
+		return false;
+
+	/* Only plain Vars of user columns can be matched to the statistics */
+	foreach(lc, *varinfos)
+	{
+		GroupVarInfo *varinfo = (GroupVarInfo *) lfirst(lc);
+		Var		   *var = (Var *) varinfo->var;
+
+		if (IsA(var, Var) && var->varno == rel->relid &&
+			AttrNumberIsForUserDefinedAttr(var->varattno))
+			attnums = bms_add_member(attnums, var->varattno);
+	}
+
+	stat = choose_best_statistics(rel->statlist, attnums,
+								  STATS_EXT_NDISTINCT);
+	if (stat == NULL)
+		return false;
+
+	/* The statistics cover all the combinations of their columns */
+	matched = bms_intersect(attnums, stat->keys);
+	stats = statext_ndistinct_load(stat->statOid);
+	for (i = 0; i < stats->nitems; i++)
+	{
+		MVNDistinctItem *tmpitem = &stats->items[i];
+		Bitmapset  *itemattnums = NULL;
+		int			j;
+
+		for (j = 0; j < tmpitem->nattrs; j++)
+			itemattnums = bms_add_member(itemattnums, tmpitem->attrs[j]);
+		if (bms_equal(itemattnums, matched))
+			item = tmpitem;
+		bms_free(itemattnums);
+		if (item)
+			break;
+	}
+
+	if (item == NULL)
+		elog(ERROR, "corrupt MVNDistinct entry");
+
+	/* Negative values are fractions of the table's rows */
+	*ndistinct = item->ndistinct;
+	if (*ndistinct < 0)
+		*ndistinct = -(*ndistinct) * rel->tuples;
+
+	foreach(lc, *varinfos)
+	{
+		GroupVarInfo *varinfo = (GroupVarInfo *) lfirst(lc);
+		Var		   *var = (Var *) varinfo->var;
+
+		if (IsA(var, Var) && var->varno == rel->relid &&
+			bms_is_member(var->varattno, matched))
+			continue;
+		newlist = lappend(newlist, varinfo);
+	}
+	*varinfos = newlist;
+
+	pfree(stats);
+	bms_free(matched);
+
+	return true;
+}
+
 /*
  * estimate_num_groups		- Estimate number of groups in a grouped query
  *
@@ -3161,9 +3250,9 @@ add_unique_group_var(PlannerInfo *root, List *varinfos,
  *	pgset - NULL, or a List** pointing to a grouping set to filter the
  *		groupExprs against
  *
- * Given the lack of any cross-correlation statistics in the system, it's
- * impossible to do anything really trustworthy with GROUP BY conditions
- * involving multiple Vars.  We should however avoid assuming the worst
+ * Unless there are multi-column statistics for them, it's impossible to do
+ * anything really trustworthy with GROUP BY conditions involving multiple
+ * Vars.  We should however avoid assuming the worst
  * case (all possible cross-product terms actually appear as groups) since
  * very often the grouped-by Vars are highly correlated.  Our current approach
  * is as follows:
@@ -3198,7 +3287,10 @@ add_unique_group_var(PlannerInfo *root, List *varinfos,
  *		of 10 is derived from pre-Postgres-7.4 practice.)  Multiplying
  *		by the restriction selectivity is effectively assuming that the
  *		restriction clauses are independent of the grouping, which is a crummy
- *		assumption, but it's hard to do better.
+ *		assumption, but it's hard to do better.  If the rel has multi-column
+ *		ndistinct statistics (see CREATE STATISTICS) covering several of its
+ *		Vars, we take the number of distinct combinations of those from there
+ *		instead, and count them as a single Var.
  *	5.  If there are Vars from multiple rels, we repeat step 4 for each such
  *		rel, and multiply the results together.
  * Note that rels not containing grouped Vars are ignored completely, as are
@@ -3334,25 +3426,25 @@ estimate_num_groups(PlannerInfo *root, List *groupExprs, double input_rows,
 	{
 		GroupVarInfo *varinfo1 = (GroupVarInfo *) linitial(varinfos);
 		RelOptInfo *rel = varinfo1->rel;
-		double		reldistinct = varinfo1->ndistinct;
-		double		relmaxndistinct = reldistinct;
-		int			relvarcount = 1;
+		double		reldistinct = 1.0;
+		double		relmaxndistinct = 0.0;
+		int			relvarcount = 0;
 		List	   *newvarinfos = NIL;
+		List	   *relvarinfos = NIL;
 
 		/*
-		 * Get the product of numdistinct estimates of the Vars for this rel.
-		 * Also, construct new varinfos list of remaining Vars.
+		 * Split the list of varinfos in two - one for the current rel, one
+		 * for remaining Vars on other rels.
 		 */
+		relvarinfos = lcons(varinfo1, relvarinfos);
 		for_each_cell(l, lnext(list_head(varinfos)))
 		{
 			GroupVarInfo *varinfo2 = (GroupVarInfo *) lfirst(l);
 
 			if (varinfo2->rel == varinfo1->rel)
 			{
-				reldistinct *= varinfo2->ndistinct;
-				if (relmaxndistinct < varinfo2->ndistinct)
-					relmaxndistinct = varinfo2->ndistinct;
-				relvarcount++;
+				/* varinfos on current rel */
+				relvarinfos = lcons(varinfo2, relvarinfos);
 			}
 			else
 			{
@@ -3361,6 +3453,40 @@ estimate_num_groups(PlannerInfo *root, List *groupExprs, double input_rows,
 			}
 		}
 
+		/*
+		 * Get the product of numdistinct estimates of the Vars for this rel,
+		 * using multi-column ndistinct statistics for as many of them as
+		 * possible, and the per-column estimates for the rest.
+		 */
+		while (relvarinfos != NIL)
+		{
+			double		mvndistinct;
+
+			if (estimate_multivariate_ndistinct(root, rel, &relvarinfos,
+												&mvndistinct))
+			{
+				reldistinct *= mvndistinct;
+				if (relmaxndistinct < mvndistinct)
+					relmaxndistinct = mvndistinct;
+				relvarcount++;
+			}
+			else
+			{
+				foreach(l, relvarinfos)
+				{
+					GroupVarInfo *varinfo2 = (GroupVarInfo *) lfirst(l);
+
+					reldistinct *= varinfo2->ndistinct;
+					if (relmaxndistinct < varinfo2->ndistinct)
+						relmaxndistinct = varinfo2->ndistinct;
+					relvarcount++;
+				}
+
+				/* we're done with this relation */
+				relvarinfos = NIL;
+			}
+		}
+
 		/*
 		 * Sanity check --- don't divide by zero if empty relation.
 		 */
@@ -4424,7 +4550,7 @@ examine_variable(PlannerInfo *root, Node *node, int varRelid,
 						 * should match has_unique_index().
 						 */
 						if (index->unique &&
-							index->ncolumns == 1 &&
+							index->nkeycolumns == 1 &&
 							(index->indpred == NIL || index->predOK))
 							vardata->isunique = true;
 
@@ -6394,6 +6520,52 @@ add_predicate_to_quals(IndexOptInfo *index, List *indexQuals)
 	return list_concat(predExtraQuals, indexQuals);
 }
 
+/*
+ * Find the boundary quals a btree skip scan would use: those that would be
+ * boundary quals (see btcostestimate) if the leading index column were
+ * constrained by an '=' qual.
+ */
+static List *
+btree_skip_bound_quals(IndexOptInfo *index, List *qinfos)
+{
+	List	   *boundQuals = NIL;
+	int			indexcol = 1;
+	bool		eqQualHere = false;
+	ListCell   *lc;
+
+	foreach(lc, qinfos)
+	{
+		IndexQualInfo *qinfo = (IndexQualInfo *) lfirst(lc);
+		Expr	   *clause = qinfo->rinfo->clause;
+
+		if (indexcol != qinfo->indexcol)
+		{
+			/* Beginning of a new column's quals */
+			if (!eqQualHere)
+				break;			/* done if no '=' qual for indexcol */
+			eqQualHere = false;
+			indexcol++;
+			if (indexcol != qinfo->indexcol)
+				break;			/* no quals at all for indexcol */
+		}
+
+		if (IsA(clause, NullTest))
+		{
+			if (((NullTest *) clause)->nulltesttype == IS_NULL)
+				eqQualHere = true;
+		}
+		else if (OidIsValid(qinfo->clause_op) &&
+				 get_op_opfamily_strategy(qinfo->clause_op,
+										  index->opfamily[indexcol]) ==
+				 BTEqualStrategyNumber)
+			eqQualHere = true;
+
+		boundQuals = lappend(boundQuals, qinfo->rinfo);
+	}
+
+	return boundQuals;
+}
+
 
 Datum
 btcostestimate(PG_FUNCTION_ARGS)
@@ -6514,7 +6686,7 @@ btcostestimate(PG_FUNCTION_ARGS)
 	 * NullTest invalidates that theory, even though it sets eqQualHere.
 	 */
 	if (index->unique &&
-		indexcol == index->ncolumns - 1 &&
+		indexcol == index->nkeycolumns - 1 &&
 		eqQualHere &&
 		!found_saop &&
 		!found_is_null_op)
@@ -6678,7 +6850,7 @@ btcostestimate(PG_FUNCTION_ARGS)
 			if (index->reverse_sort[0])
 				varCorrelation = -varCorrelation;
 
-			if (index->ncolumns > 1)
+			if (index->nkeycolumns > 1)
 				costs.indexCorrelation = varCorrelation * 0.75;
 			else
 				costs.indexCorrelation = varCorrelation;
@@ -6687,6 +6859,69 @@ btcostestimate(PG_FUNCTION_ARGS)
 		}
 	}
 
+	/*
+	 * If this is a skip scan path (see index_skip_prefix() in indxpath.c), the
+	 * leading index column has no quals, so the plain scan computed above
+	 * would read the whole index.  A skip scan instead descends the tree once
+	 * for each distinct value of the leading column and reads just the
+	 * entries matching the remaining quals under it, which wins when the
+	 * leading column has few distinct values.  Without a real ndistinct
+	 * estimate we assume every index entry has its own leading value, so the
+	 * skip scan loses to the plain one; guessing wrong could be very
+	 * expensive.
+	 */
+	if (path->indexskipprefix > 0)
+	{
+		List	   *skipBoundQuals;
+		GenericCosts skipcosts;
+		Selectivity skipSelectivity;
+		double		ndistinct;
+		bool		isdefault;
+		double		spc_random_page_cost;
+
+		Assert(path->indexskipprefix == 1);
+		skipBoundQuals = btree_skip_bound_quals(index, qinfos);
+
+		vardata.rel = index->rel;
+		ndistinct = get_variable_numdistinct(&vardata, &isdefault);
+		if (isdefault)
+			ndistinct = Max(index->tuples, 1.0);
+
+		skipSelectivity =
+			clauselist_selectivity(root,
+								   add_predicate_to_quals(index, skipBoundQuals),
+								   index->rel->relid,
+								   JOIN_INNER,
+								   NULL);
+
+		MemSet(&skipcosts, 0, sizeof(skipcosts));
+		skipcosts.numIndexTuples =
+			Max(rint(skipSelectivity * index->rel->tuples), 1.0);
+
+		genericcostestimate(root, path, loop_count, qinfos, &skipcosts);
+
+		/*
+		 * Each prefix costs two descents (one to find the prefix value, one to
+		 * position the scan within it), charged as for the initial descent
+		 * above, plus a visit to at least one leaf page.
+		 */
+		descentCost = (index->tree_height + 1) * 50.0 * cpu_operator_cost;
+		if (index->tuples > 1)
+			descentCost += ceil(log(index->tuples) / log(2.0)) *
+				cpu_operator_cost;
+		skipcosts.indexStartupCost += 2.0 * descentCost;
+		skipcosts.indexTotalCost += 2.0 * ndistinct * descentCost;
+
+		get_tablespace_page_costs(index->reltablespace,
+								  &spc_random_page_cost,
+								  NULL);
+		skipcosts.indexTotalCost +=
+			Min(ndistinct, index->pages) * spc_random_page_cost;
+
+		costs.indexStartupCost = skipcosts.indexStartupCost;
+		costs.indexTotalCost = skipcosts.indexTotalCost;
+	}
+
 	ReleaseVariableStats(vardata);
 
 	*indexStartupCost = costs.indexStartupCost;
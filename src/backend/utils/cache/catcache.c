@@ -24,6 +24,7 @@
 #include "access/xact.h"
 #include "catalog/pg_operator.h"
 #include "catalog/pg_type.h"
+#include "funcapi.h"
 #include "miscadmin.h"
 #ifdef CATCACHE_STATS
 #include "storage/ipc.h"		/* for on_proc_exit */
@@ -35,8 +36,10 @@
 #include "utils/memutils.h"
 #include "utils/rel.h"
 #include "utils/resowner_private.h"
+#include "utils/sharedcatcache.h"
 #include "utils/syscache.h"
 #include "utils/tqual.h"
+#include "utils/tuplestore.h"
 
 
  /* #define CACHEDEBUG */	/* turns DEBUG elogs on */
@@ -69,9 +72,15 @@
 #define CACHE6_elog(a,b,c,d,e,f,g)
 #endif
 
+/* Memory charged to a cache entry */
+#define CATCTUP_SIZE(ct)	(sizeof(CatCTup) + (ct)->tuple.t_len)
+
 /* Cache management header --- pointer is NULL until created */
 static CatCacheHeader *CacheHdr = NULL;
 
+/* GUC parameter: limit on CacheHdr->ch_size in kB, or 0 for none */
+int			catalog_cache_memory_limit = 0;
+
 
 static uint32 CatalogCacheComputeHashValue(CatCache *cache, int nkeys,
 							 ScanKey cur_skey);
@@ -83,6 +92,7 @@ static void CatCachePrintStats(int code, Datum arg);
 #endif
 static void CatCacheRemoveCTup(CatCache *cache, CatCTup *ct);
 static void CatCacheRemoveCList(CatCache *cache, CatCList *cl);
+static void CatCacheEnforceLimit(CatCTup *keep);
 static void CatalogCacheInitializeCache(CatCache *cache);
 static CatCTup *CatalogCacheCreateEntry(CatCache *cache, HeapTuple ntp,
 						uint32 hashValue, Index hashIndex,
@@ -373,8 +383,12 @@ CatCacheRemoveCTup(CatCache *cache, CatCTup *ct)
 		return;					/* nothing left to do */
 	}
 
-	/* delink from linked list */
+	/* delink from linked lists */
 	dlist_delete(&ct->cache_elem);
+	dlist_delete(&ct->lru_elem);
+
+	cache->cc_size -= CATCTUP_SIZE(ct);
+	CacheHdr->ch_size -= CATCTUP_SIZE(ct);
 
 	/* free associated tuple data */
 	if (ct->tuple.t_data != NULL)
@@ -503,9 +517,7 @@ CatalogCacheIdInvalidate(int cacheId, uint32 hashValue)
 				else
 					CatCacheRemoveCTup(ccp, ct);
 				CACHE1_elog(DEBUG2, "CatalogCacheIdInvalidate: invalidated");
-#ifdef CATCACHE_STATS
 				ccp->cc_invals++;
-#endif
 				/* could be multiple matches, so keep looking! */
 			}
 		}
@@ -636,9 +648,7 @@ ResetCatalogCache(CatCache *cache)
 			}
 			else
 				CatCacheRemoveCTup(cache, ct);
-#ifdef CATCACHE_STATS
 			cache->cc_invals++;
-#endif
 		}
 	}
 }
@@ -764,6 +774,8 @@ InitCatCache(int id,
 		CacheHdr = (CatCacheHeader *) palloc(sizeof(CatCacheHeader));
 		slist_init(&CacheHdr->ch_caches);
 		CacheHdr->ch_ntup = 0;
+		CacheHdr->ch_size = 0;
+		dlist_init(&CacheHdr->ch_lru);
 #ifdef CATCACHE_STATS
 		/* set up to dump stats at backend exit */
 		on_proc_exit(CatCachePrintStats, 0);
@@ -1122,6 +1134,8 @@ SearchCatCache(CatCache *cache,
 	Relation	relation;
 	SysScanDesc scandesc;
 	HeapTuple	ntp;
+	bool		use_shared;
+	uint64		shared_generation = 0;
 
 	/* Make sure we're in an xact, even if this ends up being a cache hit */
 	Assert(IsTransactionState());
@@ -1132,9 +1146,7 @@ SearchCatCache(CatCache *cache,
 	if (cache->cc_tupdesc == NULL)
 		CatalogCacheInitializeCache(cache);
 
-#ifdef CATCACHE_STATS
 	cache->cc_searches++;
-#endif
 
 	/*
 	 * initialize the search key information
@@ -1188,6 +1200,7 @@ SearchCatCache(CatCache *cache,
 		 * near the front of the hashbucket's list.)
 		 */
 		dlist_move_head(bucket, &ct->cache_elem);
+		dlist_move_tail(&CacheHdr->ch_lru, &ct->lru_elem);
 
 		/*
 		 * If it's a positive entry, bump its refcount and return it. If it's
@@ -1202,9 +1215,7 @@ SearchCatCache(CatCache *cache,
 			CACHE3_elog(DEBUG2, "SearchCatCache(%s): found in bucket %d",
 						cache->cc_relname, hashIndex);
 
-#ifdef CATCACHE_STATS
 			cache->cc_hits++;
-#endif
 
 			return &ct->tuple;
 		}
@@ -1213,14 +1224,52 @@ SearchCatCache(CatCache *cache,
 			CACHE3_elog(DEBUG2, "SearchCatCache(%s): found neg entry in bucket %d",
 						cache->cc_relname, hashIndex);
 
-#ifdef CATCACHE_STATS
 			cache->cc_neg_hits++;
-#endif
 
 			return NULL;
 		}
 	}
 
+	/*
+	 * Tuple was not found in cache.  Try the shared catalog cache next, if
+	 * enabled; see sharedcatcache.c.
+	 */
+	use_shared = SharedCatCacheUsable(cache);
+	if (use_shared)
+	{
+		ntp = SharedCatCacheSearch(cache, hashValue, &shared_generation);
+		if (ntp != NULL)
+		{
+			bool		res;
+
+			HeapKeyTest(ntp,
+						cache->cc_tupdesc,
+						cache->cc_nkeys,
+						cur_skey,
+						res);
+			if (res)
+			{
+				ct = CatalogCacheCreateEntry(cache, ntp,
+											 hashValue, hashIndex,
+											 false);
+				heap_freetuple(ntp);
+				ResourceOwnerEnlargeCatCacheRefs(CurrentResourceOwner);
+				ct->refcount++;
+				ResourceOwnerRememberCatCacheRef(CurrentResourceOwner, &ct->tuple);
+
+				CACHE2_elog(DEBUG2, "SearchCatCache(%s): found in shared cache",
+							cache->cc_relname);
+
+				cache->cc_newloads++;
+
+				return &ct->tuple;
+			}
+
+			/* Hash collision; load the tuple we want and let it replace this */
+			heap_freetuple(ntp);
+		}
+	}
+
 	/*
 	 * Tuple was not found in cache, so we have to try to retrieve it directly
 	 * from the relation.  If found, we will add it to the cache; if not
@@ -1256,6 +1305,10 @@ SearchCatCache(CatCache *cache,
 		ResourceOwnerEnlargeCatCacheRefs(CurrentResourceOwner);
 		ct->refcount++;
 		ResourceOwnerRememberCatCacheRef(CurrentResourceOwner, &ct->tuple);
+		/* share the detoasted copy */
+		if (use_shared)
+			SharedCatCacheInsert(cache, hashValue, &ct->tuple,
+								 shared_generation);
 		break;					/* assume only one match */
 	}
 
@@ -1302,9 +1355,7 @@ SearchCatCache(CatCache *cache,
 	CACHE3_elog(DEBUG2, "SearchCatCache(%s): put in bucket %d",
 				cache->cc_relname, hashIndex);
 
-#ifdef CATCACHE_STATS
 	cache->cc_newloads++;
-#endif
 
 	return &ct->tuple;
 }
@@ -1421,9 +1472,7 @@ SearchCatCacheList(CatCache *cache,
 
 	Assert(nkeys > 0 && nkeys < cache->cc_nkeys);
 
-#ifdef CATCACHE_STATS
 	cache->cc_lsearches++;
-#endif
 
 	/*
 	 * initialize the search key information
@@ -1489,9 +1538,7 @@ SearchCatCacheList(CatCache *cache,
 		CACHE2_elog(DEBUG2, "SearchCatCacheList(%s): found list",
 					cache->cc_relname);
 
-#ifdef CATCACHE_STATS
 		cache->cc_lhits++;
-#endif
 
 		return cl;
 	}
@@ -1735,9 +1782,12 @@ CatalogCacheCreateEntry(CatCache *cache, HeapTuple ntp,
 	ct->hash_value = hashValue;
 
 	dlist_push_head(&cache->cc_bucket[hashIndex], &ct->cache_elem);
+	dlist_push_tail(&CacheHdr->ch_lru, &ct->lru_elem);
 
 	cache->cc_ntup++;
 	CacheHdr->ch_ntup++;
+	cache->cc_size += CATCTUP_SIZE(ct);
+	CacheHdr->ch_size += CATCTUP_SIZE(ct);
 
 	/*
 	 * If the hash table has become too full, enlarge the buckets array. Quite
@@ -1746,9 +1796,53 @@ CatalogCacheCreateEntry(CatCache *cache, HeapTuple ntp,
 	if (cache->cc_ntup > cache->cc_nbuckets * 2)
 		RehashCatCache(cache);
 
+	/* Make room for the new entry if the caches are over budget */
+	CatCacheEnforceLimit(ct);
+
 	return ct;
 }
 
+/*
+ * CatCacheEnforceLimit
+ *
+ * Evict the least recently used tuples until the caches fit into
+ * catalog_cache_memory_limit again.  Tuples that are referenced, directly or
+ * through a CatCList, are skipped, as is "keep", a new entry that its caller
+ * hasn't had a chance to reference yet.  Evicting a tuple that belongs to
+ * an unreferenced CatCList removes the list too.
+ */
+static void
+CatCacheEnforceLimit(CatCTup *keep)
+{
+	Size		limit = (Size) catalog_cache_memory_limit * 1024;
+	int			nleft;
+
+	if (catalog_cache_memory_limit <= 0 || CacheHdr->ch_size <= limit)
+		return;
+
+	/*
+	 * Each entry we look at is either removed or moved to the end of the LRU
+	 * list, so this looks at every entry at most once.
+	 */
+	for (nleft = CacheHdr->ch_ntup;
+		 nleft > 0 && CacheHdr->ch_size > limit;
+		 nleft--)
+	{
+		CatCTup    *ct = dlist_container(CatCTup, lru_elem,
+										 dlist_head_node(&CacheHdr->ch_lru));
+
+		if (ct == keep || ct->refcount > 0 ||
+			(ct->c_list != NULL && ct->c_list->refcount > 0))
+		{
+			dlist_move_tail(&CacheHdr->ch_lru, &ct->lru_elem);
+			continue;
+		}
+
+		ct->my_cache->cc_evictions++;
+		CatCacheRemoveCTup(ct->my_cache, ct);
+	}
+}
+
 /*
  * build_dummy_tuple
  *		Generate a palloc'd HeapTuple that contains the specified key
@@ -1936,3 +2030,98 @@ PrintCatCacheListLeakWarning(CatCList *list)
 		 list->my_cache->cc_relname, list->my_cache->id,
 		 list, list->refcount);
 }
+
+
+/*
+ * pg_stat_get_syscache
+ *		SQL SRF showing the size and usage counters of this backend's
+ *		catalog caches, plus one row for the relation cache.
+ */
+Datum
+pg_stat_get_syscache(PG_FUNCTION_ARGS)
+{
+#define PG_STAT_GET_SYSCACHE_COLS	11
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+	RelationCacheStats relstats;
+	Datum		values[PG_STAT_GET_SYSCACHE_COLS];
+	bool		nulls[PG_STAT_GET_SYSCACHE_COLS];
+	slist_iter	iter;
+
+	/* check to see if caller supports us returning a tuplestore */
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("set-valued function called in context that cannot accept a set")));
+	if (!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("materialize mode required, but it is not " \
+						"allowed in this context")));
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	slist_foreach(iter, &CacheHdr->ch_caches)
+	{
+		CatCache   *cache = slist_container(CatCache, cc_next, iter.cur);
+
+		/* skip caches this backend has never used */
+		if (cache->cc_tupdesc == NULL)
+			continue;
+
+		MemSet(nulls, 0, sizeof(nulls));
+
+		values[0] = Int32GetDatum(cache->id);
+		values[1] = CStringGetTextDatum(cache->cc_relname);
+		values[2] = ObjectIdGetDatum(cache->cc_indexoid);
+		values[3] = Int32GetDatum(cache->cc_ntup);
+		values[4] = Int64GetDatum((int64) cache->cc_size);
+		values[5] = Int64GetDatum((int64) cache->cc_searches);
+		values[6] = Int64GetDatum((int64) cache->cc_hits);
+		values[7] = Int64GetDatum((int64) cache->cc_neg_hits);
+		values[8] = Int64GetDatum((int64) cache->cc_newloads);
+		values[9] = Int64GetDatum((int64) cache->cc_invals);
+		values[10] = Int64GetDatum((int64) cache->cc_evictions);
+
+		tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+	}
+
+	/* The relation cache has no cache ID, index or negative entries */
+	GetRelationCacheStats(&relstats);
+
+	MemSet(nulls, 0, sizeof(nulls));
+
+	nulls[0] = true;
+	values[1] = CStringGetTextDatum("relcache");
+	nulls[2] = true;
+	values[3] = Int32GetDatum(relstats.entries);
+	values[4] = Int64GetDatum((int64) relstats.size);
+	values[5] = Int64GetDatum((int64) relstats.searches);
+	values[6] = Int64GetDatum((int64) relstats.hits);
+	nulls[7] = true;
+	values[8] = Int64GetDatum((int64) relstats.loads);
+	values[9] = Int64GetDatum((int64) relstats.invals);
+	values[10] = Int64GetDatum((int64) relstats.evictions);
+
+	tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+
+	/* clean up and return the tuplestore */
+	tuplestore_donestoring(tupstore);
+
+	return (Datum) 0;
+}
@@ -107,6 +107,7 @@
 #include "utils/memutils.h"
 #include "utils/rel.h"
 #include "utils/relmapper.h"
+#include "utils/sharedcatcache.h"
 #include "utils/snapmgr.h"
 #include "utils/syscache.h"
 
@@ -938,6 +939,14 @@ AtEOXact_Inval(bool isCommit)
 	{
 		ProcessInvalidationMessages(&transInvalInfo->PriorCmdInvalidMsgs,
 									LocalExecuteInvalidationMessage);
+
+		/*
+		 * Other backends don't need to hear about our aborted changes, but
+		 * nontransactional (in-place) updates must not survive in the shared
+		 * catalog cache.
+		 */
+		ProcessInvalidationMessagesMulti(&transInvalInfo->PriorCmdInvalidMsgs,
+										 SharedCatCacheInvalidate);
 	}
 
 	/* Need not free anything explicitly */
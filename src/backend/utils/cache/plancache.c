@@ -9,7 +9,12 @@
  * changes in the objects they depend on.
  *
  * The logic for choosing generic or custom plans is in choose_custom_plan,
- * which see for comments.
+ * which see for comments.  Backends pool what they learn about each query
+ * for that choice --- the estimated costs of its custom plans and the
+ * measured run times of both kinds of plans --- in a shared hash table keyed
+ * by the query text and parameter types, so that a backend preparing a query
+ * that others have already run need not repeat their experiments.  (The
+ * plans themselves stay backend-local.)
  *
  * Cache invalidation is driven off sinval events.  Any CachedPlanSource
  * that matches the event is marked invalid, as is its generic CachedPlan
@@ -49,7 +54,9 @@
 
 #include <limits.h>
 
+#include "access/hash.h"
 #include "access/transam.h"
+#include "access/xact.h"
 #include "catalog/namespace.h"
 #include "executor/executor.h"
 #include "executor/spi.h"
@@ -61,6 +68,9 @@
 #include "parser/analyze.h"
 #include "parser/parsetree.h"
 #include "storage/lmgr.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
 #include "tcop/pquery.h"
 #include "tcop/utility.h"
 #include "utils/inval.h"
@@ -79,6 +89,65 @@
 	((plansource)->raw_parse_tree && \
 	 IsA((plansource)->raw_parse_tree, TransactionStmt))
 
+/*
+ * Shared statistics for choosing between custom and generic plans of one
+ * query.  Entries are never removed, so backends may keep pointers to them;
+ * once the table is full, further queries are decided on local statistics
+ * only.  The key and query text are protected by PlanCacheStatsLock, the
+ * rest by the mutex.
+ *
+ * The same query text can refer to different tables, or be subject to
+ * different row security policies, depending on the search_path and the
+ * role it runs under, so both are part of the key.
+ *
+ * A hash of the query text isn't enough to tell queries apart, so the entry
+ * also keeps the text itself, or as much of it as fits, and a lookup that
+ * finds a different text is treated like one that finds nothing.  Longer
+ * texts are told apart by their lengths and hashes only.
+ */
+typedef struct PlanChoiceKey
+{
+	Oid			dbid;			/* database the query runs in */
+	Oid			userid;			/* role the query runs as */
+	uint32		query_hash;		/* hash of query text */
+	uint32		query_len;		/* length of query text */
+	uint32		params_hash;	/* hash of parameter types */
+	uint32		path_hash;		/* hash of the effective search_path */
+} PlanChoiceKey;
+
+/* Bytes of query text kept in PlanChoiceStats */
+#define PLAN_CHOICE_TEXT_LEN		1024
+
+typedef struct PlanChoiceStats
+{
+	PlanChoiceKey key;			/* hash key; must be first */
+	char		query_text[PLAN_CHOICE_TEXT_LEN];	/* NUL-padded, not
+													 * necessarily terminated */
+	slock_t		mutex;
+	double		total_custom_cost;		/* total cost of custom plans so far */
+	int			num_custom_plans;		/* number of plans included in total */
+	double		custom_time;	/* average msec to plan and execute custom
+								 * plan */
+	int			num_custom_runs;	/* number of runs included in average */
+	double		generic_time;	/* average msec to execute generic plan */
+	int			num_generic_runs;	/* number of runs included in average */
+} PlanChoiceStats;
+
+/* Run times are averaged over about this many recent runs */
+#define PLAN_CHOICE_TIME_WINDOW		20
+/* Timed runs of each kind of plan needed before the timings are trusted */
+#define PLAN_CHOICE_MIN_RUNS		3
+/* Every this many plans, try the kind of plan not currently preferred */
+#define PLAN_CHOICE_PROBE_INTERVAL	50
+/* Search path entries included in PlanChoiceKey.path_hash */
+#define PLAN_CHOICE_MAX_PATH		32
+
+static HTAB *PlanChoiceHash = NULL;
+
+/* GUC parameters */
+bool		plan_cache_adaptive = false;
+int			plan_cache_shared_entries = 1000;
+
 /*
  * This is the head of the backend's list of "saved" CachedPlanSources (i.e.,
  * those that are in long-lived storage and are examined for sinval events).
@@ -95,6 +164,8 @@ static CachedPlan *BuildCachedPlan(CachedPlanSource *plansource, List *qlist,
 static bool choose_custom_plan(CachedPlanSource *plansource,
 				   ParamListInfo boundParams);
 static double cached_plan_cost(CachedPlan *plan, bool include_planner);
+static PlanChoiceStats *GetPlanChoiceStats(CachedPlanSource *plansource);
+static void RecordPlanRunTime(CachedPlan *plan);
 static void AcquireExecutorLocks(List *stmt_list, bool acquire);
 static void AcquirePlannerLocks(List *stmt_list, bool acquire);
 static void ScanQueryForLocks(Query *parsetree, bool acquire);
@@ -106,6 +177,39 @@ static void PlanCacheFuncCallback(Datum arg, int cacheid, uint32 hashvalue);
 static void PlanCacheSysCallback(Datum arg, int cacheid, uint32 hashvalue);
 
 
+/*
+ * PlanCacheShmemSize: report shared-memory space needed by PlanCacheShmemInit
+ */
+Size
+PlanCacheShmemSize(void)
+{
+	if (plan_cache_shared_entries <= 0)
+		return 0;
+	return hash_estimate_size(plan_cache_shared_entries,
+							  sizeof(PlanChoiceStats));
+}
+
+/*
+ * PlanCacheShmemInit: allocate and initialize the shared plan choice table
+ */
+void
+PlanCacheShmemInit(void)
+{
+	HASHCTL		info;
+
+	if (plan_cache_shared_entries <= 0)
+		return;
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(PlanChoiceKey);
+	info.entrysize = sizeof(PlanChoiceStats);
+	PlanChoiceHash = ShmemInitHash("Plan Choice Statistics",
+								   plan_cache_shared_entries,
+								   plan_cache_shared_entries,
+								   &info,
+								   HASH_ELEM | HASH_BLOBS);
+}
+
 /*
  * InitPlanCache: initialize module during InitPostgres.
  *
@@ -207,6 +311,10 @@ CreateCachedPlan(Node *raw_parse_tree,
 	plansource->generic_cost = -1;
 	plansource->total_custom_cost = 0;
 	plansource->num_custom_plans = 0;
+	plansource->num_plan_choices = 0;
+	plansource->choice_stats_valid = false;
+	plansource->choice_stats_user = InvalidOid;
+	plansource->choice_stats = NULL;
 	plansource->hasRowSecurity = false;
 	plansource->rowSecurityDisabled
 		= (security_context & SECURITY_ROW_LEVEL_DISABLED) != 0;
@@ -277,6 +385,10 @@ CreateOneShotCachedPlan(Node *raw_parse_tree,
 	plansource->generic_cost = -1;
 	plansource->total_custom_cost = 0;
 	plansource->num_custom_plans = 0;
+	plansource->num_plan_choices = 0;
+	plansource->choice_stats_valid = false;
+	plansource->choice_stats_user = InvalidOid;
+	plansource->choice_stats = NULL;
 
 	return plansource;
 }
@@ -656,6 +768,9 @@ RevalidateCachedQuery(CachedPlanSource *plansource)
 	plansource->invalItems = NIL;
 	plansource->search_path = NULL;
 
+	/* The search_path may have changed, so look up the statistics anew */
+	plansource->choice_stats_valid = false;
+
 	/*
 	 * Free the query_context.  We don't really expect MemoryContextDelete to
 	 * fail, but just in case, make sure the CachedPlanSource is left in a
@@ -1000,6 +1115,10 @@ BuildCachedPlan(CachedPlanSource *plansource, List *qlist,
 	plan->is_oneshot = plansource->is_oneshot;
 	plan->is_saved = false;
 	plan->is_valid = true;
+	plan->is_custom = (boundParams != NULL);
+	plan->choice_stats = NULL;
+	INSTR_TIME_SET_ZERO(plan->run_time);
+	plan->has_run = false;
 
 	/* assign generation number to new plan */
 	plan->generation = ++(plansource->generation);
@@ -1017,7 +1136,15 @@ BuildCachedPlan(CachedPlanSource *plansource, List *qlist,
 static bool
 choose_custom_plan(CachedPlanSource *plansource, ParamListInfo boundParams)
 {
+	PlanChoiceStats *stats;
+	double		total_custom_cost;
+	int			num_custom_plans;
+	double		custom_time = 0;
+	int			num_custom_runs = 0;
+	double		generic_time = 0;
+	int			num_generic_runs = 0;
 	double		avg_custom_cost;
+	bool		customplan;
 
 	/* One-shot plans will always be considered custom */
 	if (plansource->is_oneshot)
@@ -1036,11 +1163,35 @@ choose_custom_plan(CachedPlanSource *plansource, ParamListInfo boundParams)
 	if (plansource->cursor_options & CURSOR_OPT_CUSTOM_PLAN)
 		return true;
 
+	/*
+	 * Use the custom plan costs seen by all backends if they are more than
+	 * our own, which saves a fresh prepared statement from repeating the
+	 * custom plans of other sessions before it may use a generic plan.
+	 */
+	total_custom_cost = plansource->total_custom_cost;
+	num_custom_plans = plansource->num_custom_plans;
+
+	stats = GetPlanChoiceStats(plansource);
+	if (stats != NULL)
+	{
+		SpinLockAcquire(&stats->mutex);
+		if (stats->num_custom_plans > num_custom_plans)
+		{
+			total_custom_cost = stats->total_custom_cost;
+			num_custom_plans = stats->num_custom_plans;
+		}
+		custom_time = stats->custom_time;
+		num_custom_runs = stats->num_custom_runs;
+		generic_time = stats->generic_time;
+		num_generic_runs = stats->num_generic_runs;
+		SpinLockRelease(&stats->mutex);
+	}
+
 	/* Generate custom plans until we have done at least 5 (arbitrary) */
-	if (plansource->num_custom_plans < 5)
+	if (num_custom_plans < 5)
 		return true;
 
-	avg_custom_cost = plansource->total_custom_cost / plansource->num_custom_plans;
+	avg_custom_cost = total_custom_cost / num_custom_plans;
 
 	/*
 	 * Prefer generic plan if it's less expensive than the average custom
@@ -1052,10 +1203,36 @@ choose_custom_plan(CachedPlanSource *plansource, ParamListInfo boundParams)
 	 * Note that if generic_cost is -1 (indicating we've not yet determined
 	 * the generic plan cost), we'll always prefer generic at this point.
 	 */
-	if (plansource->generic_cost < avg_custom_cost)
-		return false;
+	customplan = !(plansource->generic_cost < avg_custom_cost);
+
+	if (stats == NULL || !plan_cache_adaptive)
+		return customplan;
+
+	/*
+	 * The cost estimates can be far off, notably for a generic plan over
+	 * skewed data, and they charge only a crude guess for planning.  Once
+	 * both kinds of plan have been timed often enough, go by the measured
+	 * times instead, which include planning for the custom plans.
+	 */
+	if (num_custom_runs >= PLAN_CHOICE_MIN_RUNS &&
+		num_generic_runs >= PLAN_CHOICE_MIN_RUNS)
+		customplan = (custom_time < generic_time);
+
+	/*
+	 * Every so often use the other kind of plan, so that its timing gets
+	 * measured in the first place and can't go stale as the data changes.
+	 * Don't bother if it was already found to be much slower.
+	 */
+	if (plansource->num_plan_choices % PLAN_CHOICE_PROBE_INTERVAL ==
+		PLAN_CHOICE_PROBE_INTERVAL - 1)
+	{
+		if (customplan ?
+			(num_generic_runs == 0 || generic_time < 2 * custom_time) :
+			(num_custom_runs == 0 || custom_time < 2 * generic_time))
+			customplan = !customplan;
+	}
 
-	return true;
+	return customplan;
 }
 
 /*
@@ -1112,6 +1289,131 @@ cached_plan_cost(CachedPlan *plan, bool include_planner)
 	return result;
 }
 
+/*
+ * GetPlanChoiceStats: find the shared choice statistics of a query
+ *
+ * The entry is created if it doesn't exist yet and there's room for it.
+ * Returns NULL if there is no entry.  The answer is remembered until the
+ * query is analyzed again, which happens when the search_path changes, or
+ * until it's used under a different role.
+ */
+static PlanChoiceStats *
+GetPlanChoiceStats(CachedPlanSource *plansource)
+{
+	PlanChoiceKey key;
+	PlanChoiceStats *entry;
+	const char *query_string = plansource->query_string;
+	Size		query_len = strlen(query_string);
+	Oid			path[PLAN_CHOICE_MAX_PATH];
+	int			npath;
+	bool		found;
+
+	if (plansource->choice_stats_valid &&
+		plansource->choice_stats_user == GetUserId())
+		return plansource->choice_stats;
+
+	plansource->choice_stats_user = GetUserId();
+	if (PlanChoiceHash == NULL)
+	{
+		plansource->choice_stats = NULL;
+		plansource->choice_stats_valid = true;
+		return NULL;
+	}
+
+	MemSet(&key, 0, sizeof(key));
+	key.dbid = MyDatabaseId;
+	key.userid = plansource->choice_stats_user;
+	key.query_hash = DatumGetUInt32(hash_any((const unsigned char *) query_string,
+											 query_len));
+	key.query_len = (uint32) query_len;
+	if (plansource->num_params > 0)
+		key.params_hash = DatumGetUInt32(hash_any((const unsigned char *) plansource->param_types,
+								   plansource->num_params * sizeof(Oid)));
+
+	/*
+	 * Hash the schemas actually searched, including the implicit ones, so
+	 * that the temporary schemas of different sessions are told apart.
+	 */
+	npath = fetch_search_path_array(path, PLAN_CHOICE_MAX_PATH);
+	key.path_hash = DatumGetUInt32(hash_any((const unsigned char *) path,
+								Min(npath, PLAN_CHOICE_MAX_PATH) * sizeof(Oid)));
+	key.path_hash ^= (uint32) npath;
+
+	LWLockAcquire(PlanCacheStatsLock, LW_SHARED);
+	entry = (PlanChoiceStats *) hash_search(PlanChoiceHash, &key,
+											HASH_FIND, &found);
+	if (found && strncmp(entry->query_text, query_string,
+						 PLAN_CHOICE_TEXT_LEN) != 0)
+		entry = NULL;
+	LWLockRelease(PlanCacheStatsLock);
+
+	if (!found)
+	{
+		LWLockAcquire(PlanCacheStatsLock, LW_EXCLUSIVE);
+		entry = (PlanChoiceStats *) hash_search(PlanChoiceHash, &key,
+												HASH_FIND, &found);
+		if (found)
+		{
+			/* someone else just made it */
+			if (strncmp(entry->query_text, query_string,
+						PLAN_CHOICE_TEXT_LEN) != 0)
+				entry = NULL;
+		}
+		else if (hash_get_num_entries(PlanChoiceHash) < plan_cache_shared_entries)
+		{
+			entry = (PlanChoiceStats *) hash_search(PlanChoiceHash, &key,
+													HASH_ENTER_NULL, &found);
+			if (entry != NULL && !found)
+			{
+				MemSet(entry->query_text, 0, PLAN_CHOICE_TEXT_LEN);
+				memcpy(entry->query_text, query_string,
+					   Min(query_len, PLAN_CHOICE_TEXT_LEN));
+				SpinLockInit(&entry->mutex);
+				entry->total_custom_cost = 0;
+				entry->num_custom_plans = 0;
+				entry->custom_time = 0;
+				entry->num_custom_runs = 0;
+				entry->generic_time = 0;
+				entry->num_generic_runs = 0;
+			}
+		}
+		LWLockRelease(PlanCacheStatsLock);
+	}
+
+	plansource->choice_stats = entry;
+	plansource->choice_stats_valid = true;
+	return entry;
+}
+
+/*
+ * RecordPlanRunTime: fold a timed use of a plan into its choice statistics
+ */
+static void
+RecordPlanRunTime(CachedPlan *plan)
+{
+	PlanChoiceStats *stats = plan->choice_stats;
+	double		msec;
+
+	msec = INSTR_TIME_GET_MILLISEC(plan->run_time);
+
+	SpinLockAcquire(&stats->mutex);
+	if (plan->is_custom)
+	{
+		if (stats->num_custom_runs < INT_MAX)
+			stats->num_custom_runs++;
+		stats->custom_time += (msec - stats->custom_time) /
+			Min(stats->num_custom_runs, PLAN_CHOICE_TIME_WINDOW);
+	}
+	else
+	{
+		if (stats->num_generic_runs < INT_MAX)
+			stats->num_generic_runs++;
+		stats->generic_time += (msec - stats->generic_time) /
+			Min(stats->num_generic_runs, PLAN_CHOICE_TIME_WINDOW);
+	}
+	SpinLockRelease(&stats->mutex);
+}
+
 /*
  * GetCachedPlan: get a cached plan from a CachedPlanSource.
  *
@@ -1137,6 +1439,7 @@ GetCachedPlan(CachedPlanSource *plansource, ParamListInfo boundParams,
 	CachedPlan *plan;
 	List	   *qlist;
 	bool		customplan;
+	instr_time	start_time;
 
 	/* Assert caller is doing things in a sane order */
 	Assert(plansource->magic == CACHEDPLANSOURCE_MAGIC);
@@ -1206,16 +1509,52 @@ GetCachedPlan(CachedPlanSource *plansource, ParamListInfo boundParams,
 
 	if (customplan)
 	{
-		/* Build a custom plan */
+		double		custom_cost;
+
+		/* Build a custom plan, timing it as part of its use */
+		INSTR_TIME_SET_CURRENT(start_time);
 		plan = BuildCachedPlan(plansource, qlist, boundParams);
+		INSTR_TIME_SET_CURRENT(plan->run_time);
+		INSTR_TIME_SUBTRACT(plan->run_time, start_time);
+		custom_cost = cached_plan_cost(plan, true);
 		/* Accumulate total costs of custom plans, but 'ware overflow */
 		if (plansource->num_custom_plans < INT_MAX)
 		{
-			plansource->total_custom_cost += cached_plan_cost(plan, true);
+			plansource->total_custom_cost += custom_cost;
 			plansource->num_custom_plans++;
 		}
+		/* ... and likewise for all backends */
+		if (plansource->choice_stats != NULL)
+		{
+			PlanChoiceStats *stats = plansource->choice_stats;
+
+			SpinLockAcquire(&stats->mutex);
+			if (stats->num_custom_plans < INT_MAX)
+			{
+				stats->total_custom_cost += custom_cost;
+				stats->num_custom_plans++;
+			}
+			SpinLockRelease(&stats->mutex);
+		}
 	}
 
+	/*
+	 * Time this use of the plan if the choice is adaptive, unless the plan
+	 * (necessarily a generic one) is already being timed for another use.
+	 * Whoever runs the plan reports the time spent in the executor through
+	 * CachedPlanAddRunTime; a generic plan starts out with no time.
+	 */
+	if (plansource->choice_stats != NULL && plan_cache_adaptive &&
+		plan->choice_stats == NULL)
+	{
+		plan->choice_stats = plansource->choice_stats;
+		if (!customplan)
+			INSTR_TIME_SET_ZERO(plan->run_time);
+		plan->has_run = false;
+	}
+	if (plansource->num_plan_choices < UINT_MAX)
+		plansource->num_plan_choices++;
+
 	/* Flag the plan as in use by caller */
 	if (useResOwner)
 		ResourceOwnerEnlargePlanCacheRefs(CurrentResourceOwner);
@@ -1259,6 +1598,20 @@ ReleaseCachedPlan(CachedPlan *plan, bool useResOwner)
 		ResourceOwnerForgetPlanCacheRef(CurrentResourceOwner, plan);
 	}
 	Assert(plan->refcount > 0);
+
+	/*
+	 * The first release after the plan was handed out ends its timed use.
+	 * Don't count uses that never reached the executor, such as plpgsql's
+	 * simple expressions, nor those that failed, which is when we're not in
+	 * a valid transaction anymore.
+	 */
+	if (plan->choice_stats != NULL)
+	{
+		if (plan->has_run && IsTransactionState())
+			RecordPlanRunTime(plan);
+		plan->choice_stats = NULL;
+	}
+
 	plan->refcount--;
 	if (plan->refcount == 0)
 	{
@@ -1271,6 +1624,28 @@ ReleaseCachedPlan(CachedPlan *plan, bool useResOwner)
 	}
 }
 
+/*
+ * CachedPlanAddRunTime: count executor time towards a plan's timed use
+ *
+ * Callers that run the executor on a plan obtained from GetCachedPlan
+ * report each stretch of it here, 'start' being when it began.  Time spent
+ * between those, such as waiting for the client to fetch more rows of a
+ * portal, is thus left out of the plan's timing.
+ */
+void
+CachedPlanAddRunTime(CachedPlan *plan, instr_time start)
+{
+	instr_time	now;
+
+	Assert(plan->magic == CACHEDPLAN_MAGIC);
+	if (plan->choice_stats == NULL)
+		return;
+
+	INSTR_TIME_SET_CURRENT(now);
+	INSTR_TIME_ACCUM_DIFF(plan->run_time, now, start);
+	plan->has_run = true;
+}
+
 /*
  * CachedPlanSetParentContext: move a CachedPlanSource to a new memory context
  *
@@ -1392,6 +1767,9 @@ CopyCachedPlan(CachedPlanSource *plansource)
 	newsource->generic_cost = plansource->generic_cost;
 	newsource->total_custom_cost = plansource->total_custom_cost;
 	newsource->num_custom_plans = plansource->num_custom_plans;
+	newsource->num_plan_choices = plansource->num_plan_choices;
+	newsource->choice_stats_valid = plansource->choice_stats_valid;
+	newsource->choice_stats = plansource->choice_stats;
 
 	MemoryContextSwitchTo(oldcxt);
 
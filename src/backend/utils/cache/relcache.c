@@ -51,6 +51,8 @@
 #include "catalog/pg_opclass.h"
 #include "catalog/pg_proc.h"
 #include "catalog/pg_rewrite.h"
+#include "catalog/pg_statistic_ext.h"
+#include "catalog/pg_subscription.h"
 #include "catalog/pg_tablespace.h"
 #include "catalog/pg_trigger.h"
 #include "catalog/pg_type.h"
@@ -97,6 +99,7 @@ static const FormData_pg_attribute Desc_pg_type[Natts_pg_type] = {Schema_pg_type
 static const FormData_pg_attribute Desc_pg_database[Natts_pg_database] = {Schema_pg_database};
 static const FormData_pg_attribute Desc_pg_authid[Natts_pg_authid] = {Schema_pg_authid};
 static const FormData_pg_attribute Desc_pg_auth_members[Natts_pg_auth_members] = {Schema_pg_auth_members};
+static const FormData_pg_attribute Desc_pg_subscription[Natts_pg_subscription] = {Schema_pg_subscription};
 static const FormData_pg_attribute Desc_pg_index[Natts_pg_index] = {Schema_pg_index};
 
 /*
@@ -109,10 +112,29 @@ typedef struct relidcacheent
 {
 	Oid			reloid;
 	Relation	reldesc;
+	Size		size;			/* memory charged for entry when inserted */
+	uint64		lastused;		/* relcache_clock value when last opened */
 } RelIdCacheEnt;
 
 static HTAB *RelationIdCache;
 
+/*
+ * The relcache is kept within relation_cache_memory_limit (in kB, 0 for no
+ * limit) by evicting unreferenced entries at commit, least recently opened
+ * first.  The memory used by an entry is estimated when it is inserted,
+ * since its memory is not separately accounted for.
+ */
+int			relation_cache_memory_limit = 0;
+
+static Size relcache_size = 0;
+static uint64 relcache_clock = 0;
+
+/* Counters shown by pg_stat_syscache */
+static long relcacheSearches = 0L;
+static long relcacheHits = 0L;
+static long relcacheLoads = 0L;
+static long relcacheEvictions = 0L;
+
 /*
  * This flag is false until we have prepared the critical relcache entries
  * that are needed to do indexscans on the tables read by relcache building.
@@ -187,6 +209,7 @@ do { \
 		/* see comments in RelationBuildDesc and RelationBuildLocalRelation */ \
 		Relation _old_rel = hentry->reldesc; \
 		Assert(replace_allowed); \
+		relcache_size -= hentry->size; \
 		hentry->reldesc = (RELATION); \
 		if (RelationHasReferenceCountZero(_old_rel)) \
 			RelationDestroyRelation(_old_rel, false); \
@@ -196,6 +219,9 @@ do { \
 	} \
 	else \
 		hentry->reldesc = (RELATION); \
+	hentry->size = RelationCacheEntrySize(RELATION); \
+	hentry->lastused = ++relcache_clock; \
+	relcache_size += hentry->size; \
 } while(0)
 
 #define RelationIdCacheLookup(ID, RELATION) \
@@ -219,6 +245,8 @@ do { \
 	if (hentry == NULL) \
 		elog(WARNING, "failed to delete relcache entry for OID %u", \
 			 (RELATION)->rd_id); \
+	else \
+		relcache_size -= hentry->size; \
 } while(0)
 
 
@@ -248,6 +276,8 @@ static void RelationClearRelation(Relation relation, bool rebuild);
 
 static void RelationReloadIndexInfo(Relation relation);
 static void RelationFlushRelation(Relation relation);
+static Size RelationCacheEntrySize(Relation relation);
+static void RelationCacheEnforceLimit(void);
 static void RememberToFreeTupleDescAtEOX(TupleDesc td);
 static void AtEOXact_cleanup(Relation relation, bool isCommit);
 static void AtEOSubXact_cleanup(Relation relation, bool isCommit,
@@ -1298,11 +1328,12 @@ RelationInitIndexAccessInfo(Relation relation)
 	/*
 	 * Fill the support procedure OID array, as well as the info about
 	 * opfamilies and opclass input types.  (aminfo and supportinfo are left
-	 * as zeroes, and are filled on-the-fly when used)
+	 * as zeroes, and are filled on-the-fly when used)  Included (non-key)
+	 * columns have no opclass, so their entries are left as zeroes too.
 	 */
 	IndexSupportInitialize(indclass, relation->rd_support,
 						   relation->rd_opfamily, relation->rd_opcintype,
-						   amsupport, natts);
+						   amsupport, IndexRelationGetNumberOfKeyAttributes(relation));
 
 	/*
 	 * Similarly extract indoption and copy it to the cache entry
@@ -1741,18 +1772,26 @@ formrdesc(const char *relationName, Oid relationReltype,
 Relation
 RelationIdGetRelation(Oid relationId)
 {
+	RelIdCacheEnt *hentry;
 	Relation	rd;
 
 	/* Make sure we're in an xact, even if this ends up being a cache hit */
 	Assert(IsTransactionState());
 
+	relcacheSearches++;
+
 	/*
 	 * first try to find reldesc in the cache
 	 */
-	RelationIdCacheLookup(relationId, rd);
-
-	if (RelationIsValid(rd))
+	hentry = (RelIdCacheEnt *) hash_search(RelationIdCache,
+										   (void *) &relationId,
+										   HASH_FIND, NULL);
+	if (hentry != NULL)
 	{
+		rd = hentry->reldesc;
+		hentry->lastused = ++relcache_clock;
+		relcacheHits++;
+
 		RelationIncrementReferenceCount(rd);
 		/* revalidate cache entry if necessary */
 		if (!rd->rd_isvalid)
@@ -1777,10 +1816,128 @@ RelationIdGetRelation(Oid relationId)
 	 */
 	rd = RelationBuildDesc(relationId, true);
 	if (RelationIsValid(rd))
+	{
+		relcacheLoads++;
 		RelationIncrementReferenceCount(rd);
+	}
 	return rd;
 }
 
+/*
+ * RelationCacheEntrySize
+ *
+ * Estimate the memory used by a relcache entry.  We count the fixed-size
+ * parts and the tuple descriptor, and a minimal block for each private
+ * memory context; other subsidiary data is ignored.
+ */
+static Size
+RelationCacheEntrySize(Relation relation)
+{
+	Size		size;
+
+	size = sizeof(RelationData) + CLASS_TUPLE_SIZE;
+	size += sizeof(struct tupleDesc) +
+		relation->rd_att->natts * (sizeof(Form_pg_attribute) +
+								   ATTRIBUTE_FIXED_PART_SIZE);
+	if (relation->rd_rulescxt)
+		size += ALLOCSET_SMALL_INITSIZE;
+	if (relation->rd_partcxt)
+		size += ALLOCSET_SMALL_INITSIZE;
+	if (relation->rd_indexcxt)
+		size += ALLOCSET_SMALL_INITSIZE;
+
+	return size;
+}
+
+/* qsort comparator for RelationCacheEnforceLimit: least recently used first */
+static int
+relidcacheent_lastused_cmp(const void *a, const void *b)
+{
+	uint64		ua = (*(RelIdCacheEnt *const *) a)->lastused;
+	uint64		ub = (*(RelIdCacheEnt *const *) b)->lastused;
+
+	if (ua < ub)
+		return -1;
+	if (ua > ub)
+		return 1;
+	return 0;
+}
+
+/*
+ * RelationCacheEnforceLimit
+ *
+ * Evict least recently opened relcache entries until the cache fits into
+ * 90% of relation_cache_memory_limit, so that we don't need to do this at
+ * every commit of a backend that keeps using a bit more than the limit.
+ * Only entries nobody references and that carry no transaction-local state
+ * can go; nailed entries never go.  An evicted entry is simply rebuilt on
+ * its next use, as if it had been invalidated.
+ *
+ * This is called at commit, when the transaction's references are gone.
+ */
+static void
+RelationCacheEnforceLimit(void)
+{
+	Size		target;
+	HASH_SEQ_STATUS status;
+	RelIdCacheEnt *idhentry;
+	RelIdCacheEnt **candidates;
+	int			ncandidates = 0;
+	int			i;
+
+	if (relation_cache_memory_limit <= 0 ||
+		relcache_size <= (Size) relation_cache_memory_limit * 1024)
+		return;
+	target = (Size) relation_cache_memory_limit * 1024 / 10 * 9;
+
+	candidates = (RelIdCacheEnt **)
+		palloc(hash_get_num_entries(RelationIdCache) * sizeof(RelIdCacheEnt *));
+
+	hash_seq_init(&status, RelationIdCache);
+	while ((idhentry = (RelIdCacheEnt *) hash_seq_search(&status)) != NULL)
+	{
+		Relation	relation = idhentry->reldesc;
+
+		if (RelationHasReferenceCountZero(relation) &&
+			!relation->rd_isnailed &&
+			relation->rd_createSubid == InvalidSubTransactionId &&
+			relation->rd_newRelfilenodeSubid == InvalidSubTransactionId)
+			candidates[ncandidates++] = idhentry;
+	}
+
+	qsort(candidates, ncandidates, sizeof(RelIdCacheEnt *),
+		  relidcacheent_lastused_cmp);
+
+	/*
+	 * Entries don't move within the hashtable, and evicting one doesn't
+	 * remove any other, so the remaining candidates stay valid.
+	 */
+	for (i = 0; i < ncandidates && relcache_size > target; i++)
+	{
+		RelationClearRelation(candidates[i]->reldesc, false);
+		relcacheEvictions++;
+	}
+
+	pfree(candidates);
+}
+
+/*
+ * GetRelationCacheStats
+ *
+ * Report the relation cache's size and usage counts.
+ */
+void
+GetRelationCacheStats(RelationCacheStats *stats)
+{
+	stats->entries = RelationIdCache ? hash_get_num_entries(RelationIdCache) : 0;
+	stats->size = relcache_size;
+	stats->searches = relcacheSearches;
+	stats->hits = relcacheHits;
+	stats->loads = relcacheLoads;
+	stats->invals = relcacheInvalsReceived;
+	stats->evictions = relcacheEvictions;
+}
+
 /* ----------------------------------------------------------------
  *				cache invalidation support routines
  * ----------------------------------------------------------------
@@ -2011,6 +2168,7 @@ RelationDestroyRelation(Relation relation, bool remember_tupdesc)
 			FreeTupleDesc(relation->rd_att);
 	}
 	list_free(relation->rd_indexlist);
+	list_free(relation->rd_statlist);
 	bms_free(relation->rd_indexattr);
 	bms_free(relation->rd_keyattr);
 	bms_free(relation->rd_idattr);
@@ -2027,6 +2185,8 @@ RelationDestroyRelation(Relation relation, bool remember_tupdesc)
 		MemoryContextDelete(relation->rd_rulescxt);
 	if (relation->rd_rsdesc)
 		MemoryContextDelete(relation->rd_rsdesc->rscxt);
+	if (relation->rd_partcxt)
+		MemoryContextDelete(relation->rd_partcxt);
 	if (relation->rd_fdwroutine)
 		pfree(relation->rd_fdwroutine);
 	pfree(relation);
@@ -2275,6 +2435,17 @@ RelationClearRelation(Relation relation, bool rebuild)
 
 #undef SWAPFIELD
 
+		/*
+		 * Partitioning info is rebuilt on demand.  Callers may still hold
+		 * pointers into the old copy, though, so keep it until end of
+		 * transaction rather than freeing it with the temporary entry.
+		 */
+		if (newrel->rd_partcxt && TopTransactionContext)
+		{
+			MemoryContextSetParent(newrel->rd_partcxt, TopTransactionContext);
+			newrel->rd_partcxt = NULL;
+		}
+
 		/* And now we can throw away the temporary entry */
 		RelationDestroyRelation(newrel, !keep_tupdesc);
 	}
@@ -2611,6 +2782,10 @@ AtEOXact_RelationCache(bool isCommit)
 	eoxact_list_overflowed = false;
 	NextEOXactTupleDescNum = 0;
 	EOXactTupleDescArrayLen = 0;
+
+	/* Trim the cache if it's over budget, now that nothing is in use */
+	if (isCommit)
+		RelationCacheEnforceLimit();
 }
 
 /*
@@ -3210,8 +3385,10 @@ RelationCacheInitializePhase2(void)
 				  true, Natts_pg_authid, Desc_pg_authid);
 		formrdesc("pg_auth_members", AuthMemRelation_Rowtype_Id, true,
 				  false, Natts_pg_auth_members, Desc_pg_auth_members);
+		formrdesc("pg_subscription", SubscriptionRelation_Rowtype_Id, true,
+				  true, Natts_pg_subscription, Desc_pg_subscription);
 
-#define NUM_CRITICAL_SHARED_RELS	3	/* fix if you change list above */
+#define NUM_CRITICAL_SHARED_RELS	4	/* fix if you change list above */
 	}
 
 	MemoryContextSwitchTo(oldcxt);
@@ -3906,6 +4083,62 @@ RelationGetIndexList(Relation relation)
 	return result;
 }
 
+/*
+ * RelationGetStatExtList
+ *		get a list of OIDs of extended statistics on this relation
+ *
+ * The list is built and cached just like the index list, see
+ * RelationGetIndexList; creating or dropping a statistics object sends a
+ * relcache invalidation so that the list is recomputed.  The result is
+ * sorted by OID and palloc'd in the caller's context.
+ */
+List *
+RelationGetStatExtList(Relation relation)
+{
+	Relation	indrel;
+	SysScanDesc indscan;
+	ScanKeyData skey;
+	HeapTuple	htup;
+	List	   *result;
+	List	   *oldlist;
+	MemoryContext oldcxt;
+
+	/* Quick exit if we already computed the list. */
+	if (relation->rd_statvalid)
+		return list_copy(relation->rd_statlist);
+
+	result = NIL;
+
+	/* Prepare to scan pg_statistic_ext for entries having stxrelid = this rel. */
+	ScanKeyInit(&skey,
+				Anum_pg_statistic_ext_stxrelid,
+				BTEqualStrategyNumber, F_OIDEQ,
+				ObjectIdGetDatum(RelationGetRelid(relation)));
+
+	indrel = heap_open(StatisticExtRelationId, AccessShareLock);
+	indscan = systable_beginscan(indrel, StatisticExtRelidIndexId, true,
+								 NULL, 1, &skey);
+
+	while (HeapTupleIsValid(htup = systable_getnext(indscan)))
+		result = insert_ordered_oid(result, HeapTupleGetOid(htup));
+
+	systable_endscan(indscan);
+
+	heap_close(indrel, AccessShareLock);
+
+	/* Now save a copy of the completed list in the relcache entry. */
+	oldcxt = MemoryContextSwitchTo(CacheMemoryContext);
+	oldlist = relation->rd_statlist;
+	relation->rd_statlist = list_copy(result);
+	relation->rd_statvalid = true;
+	MemoryContextSwitchTo(oldcxt);
+
+	/* Don't leak the old list, if there is one */
+	list_free(oldlist);
+
+	return result;
+}
+
 /*
  * insert_ordered_oid
  *		Insert a new Oid into a sorted list of Oids, preserving ordering
@@ -4265,7 +4498,11 @@ RelationGetIndexAttrBitmap(Relation relation, IndexAttrBitmapKind attrKind)
 		/* Is this index the configured (or default) replica identity? */
 		isIDKey = (indexOid == relreplindex);
 
-		/* Collect simple attribute references */
+		/*
+		 * Collect simple attribute references.  Included (non-key) columns
+		 * matter for HOT, since their values are stored in the index, but
+		 * they are not part of any key.
+		 */
 		for (i = 0; i < indexInfo->ii_NumIndexAttrs; i++)
 		{
 			int			attrnum = indexInfo->ii_KeyAttrNumbers[i];
@@ -4275,6 +4512,9 @@ RelationGetIndexAttrBitmap(Relation relation, IndexAttrBitmapKind attrKind)
 				indexattrs = bms_add_member(indexattrs,
 							   attrnum - FirstLowInvalidHeapAttributeNumber);
 
+				if (i >= indexInfo->ii_NumIndexKeyAttrs)
+					continue;
+
 				if (isKey)
 					uindexattrs = bms_add_member(uindexattrs,
 							   attrnum - FirstLowInvalidHeapAttributeNumber);
@@ -4859,6 +5099,12 @@ load_relcache_init_file(bool shared)
 		rel->rd_exclprocs = NULL;
 		rel->rd_exclstrats = NULL;
 		rel->rd_fdwroutine = NULL;
+		rel->rd_partcxt = NULL;
+		rel->rd_partkeyvalid = false;
+		rel->rd_partcheckvalid = false;
+		rel->rd_partkey = NULL;
+		rel->rd_partdesc = NULL;
+		rel->rd_partcheck = NIL;
 
 		/*
 		 * Reset transient-state fields in the relcache entry
@@ -4870,6 +5116,8 @@ load_relcache_init_file(bool shared)
 			rel->rd_refcnt = 0;
 		rel->rd_indexvalid = 0;
 		rel->rd_indexlist = NIL;
+		rel->rd_statvalid = false;
+		rel->rd_statlist = NIL;
 		rel->rd_oidindex = InvalidOid;
 		rel->rd_replidindex = InvalidOid;
 		rel->rd_indexattr = NULL;
@@ -0,0 +1,514 @@
+/*-------------------------------------------------------------------------
+ *
+ * sharedcatcache.c
+ *	  Shared-memory second-level cache of system catalog tuples.
+ *
+ * Every backend's catcache loads the catalog tuples it needs with an index
+ * scan of its own, so a new connection has to redo the lookups all the other
+ * connections have already done.  When shared_catcache_entries is set, the
+ * tuples loaded are also copied into a fixed-size table in shared memory,
+ * which SearchCatCache consults before scanning the catalog.  The tuples are
+ * still copied into the backend-local catcache, which stays authoritative
+ * for the backend; this is only a faster way to fill it.  Negative entries
+ * and catcache lists are not shared.
+ *
+ * Entries are keyed like catcache invalidation messages, by cache ID,
+ * database (InvalidOid for shared catalogs) and hash value of the keys, and
+ * hold a single tuple; the caller checks that it really has the keys it is
+ * looking for.  Every invalidation message sent (see SendSharedInvalidMessages)
+ * removes the entries it covers, and when the table is full, entries are
+ * replaced in clock-sweep order.
+ *
+ * The table is divided into NUM_SHARED_CATCACHE_PARTITIONS partitions by
+ * the hash code of the key, as the shared buffer and lock tables are.  Each
+ * partition has an LWLock, a range of the slots holding the tuples, and a
+ * clock hand of its own, so that lookups and insertions of different
+ * partitions never contend.  Removing all tuples of a catalog or database
+ * visits the partitions one at a time.
+ *
+ * Invalidation messages are sent only once the change has become visible,
+ * so a backend could load the old version of a tuple with an older catalog
+ * snapshot and enter it after the message removed the entry.  To prevent
+ * that, every removal advances the generation counter of its partition,
+ * and a global one.  A backend reads the partition's counter before loading
+ * a tuple, makes sure its catalog snapshot is taken after the global one
+ * last moved, and enters the tuple only if the partition's counter hasn't
+ * moved since.
+ *
+ * A transaction that has modified catalogs can see its own uncommitted
+ * changes, so it neither uses nor fills the shared cache.
+ *
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/backend/utils/cache/sharedcatcache.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/htup_details.h"
+#include "access/xact.h"
+#include "miscadmin.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
+#include "utils/hsearch.h"
+#include "utils/sharedcatcache.h"
+#include "utils/snapmgr.h"
+
+
+typedef struct SharedCatCacheKey
+{
+	Oid			dbid;			/* database, or InvalidOid if shared catalog */
+	int			cacheId;		/* syscache ID */
+	uint32		hashValue;		/* hash value of the tuple's keys */
+} SharedCatCacheKey;
+
+typedef struct SharedCatCacheLookupEnt
+{
+	SharedCatCacheKey key;		/* hash key; must be first */
+	int			slot;			/* index of the slot holding the tuple */
+} SharedCatCacheLookupEnt;
+
+typedef struct SharedCatCacheSlot
+{
+	bool		used;			/* does the slot hold a tuple? */
+	bool		recently_used;	/* referenced since the clock hand passed? */
+	SharedCatCacheKey key;
+	Oid			reloid;			/* catalog the tuple is from */
+	ItemPointerData t_self;
+	uint32		t_len;
+	char		data[SHARED_CATCACHE_TUPLE_SIZE];	/* HeapTupleHeader */
+} SharedCatCacheSlot;
+
+/*
+ * All fields, and the lookup entries and slots of the partition, are
+ * protected by the partition's lock, except that recently_used is also set
+ * by holders of the lock in shared mode.
+ */
+typedef struct SharedCatCachePartition
+{
+	uint64		generation;		/* advanced by every invalidation */
+	int			first_slot;		/* the partition's slots */
+	int			nslots;
+	int			clock_hand;		/* next slot to consider for replacement */
+} SharedCatCachePartition;
+
+typedef struct SharedCatCacheCtlData
+{
+	slock_t		mutex;			/* protects generation */
+	uint64		generation;		/* advanced by every invalidation */
+	SharedCatCachePartition partitions[NUM_SHARED_CATCACHE_PARTITIONS];
+	SharedCatCacheSlot slots[FLEXIBLE_ARRAY_MEMBER];
+} SharedCatCacheCtlData;
+
+#define SharedCatCacheHashPartition(hashcode) \
+	((hashcode) % NUM_SHARED_CATCACHE_PARTITIONS)
+#define SharedCatCachePartitionLock(hashcode) \
+	(&MainLWLockArray[SHARED_CATCACHE_LWLOCK_OFFSET + \
+		SharedCatCacheHashPartition(hashcode)].lock)
+#define SharedCatCachePartitionLockByIndex(i) \
+	(&MainLWLockArray[SHARED_CATCACHE_LWLOCK_OFFSET + (i)].lock)
+
+/* GUC parameter */
+int			shared_catcache_entries = 0;
+
+static SharedCatCacheCtlData *SharedCatCacheCtl = NULL;
+static HTAB *SharedCatCacheHash = NULL;
+
+/* Counter value our catalog snapshot is known to be newer than */
+static uint64 snapshot_generation = 0;
+static bool snapshot_generation_valid = false;
+
+static SharedCatCachePartition *SharedCatCacheLockForRemoval(int partition);
+static void SharedCatCacheRemoveSlot(SharedCatCacheSlot *slot);
+static void SharedCatCacheRemoveMatching(Oid dbid, Oid reloid);
+
+
+/*
+ * Report shared-memory space needed by SharedCatCacheShmemInit
+ */
+Size
+SharedCatCacheShmemSize(void)
+{
+	Size		size;
+
+	if (shared_catcache_entries <= 0)
+		return 0;
+
+	size = offsetof(SharedCatCacheCtlData, slots);
+	size = add_size(size, mul_size(shared_catcache_entries,
+								   sizeof(SharedCatCacheSlot)));
+	size = add_size(size, hash_estimate_size(shared_catcache_entries,
+											 sizeof(SharedCatCacheLookupEnt)));
+	return size;
+}
+
+/*
+ * Allocate and initialize the shared catalog cache
+ */
+void
+SharedCatCacheShmemInit(void)
+{
+	HASHCTL		info;
+	bool		found;
+
+	if (shared_catcache_entries <= 0)
+		return;
+
+	SharedCatCacheCtl = (SharedCatCacheCtlData *)
+		ShmemInitStruct("Shared Catalog Cache",
+						add_size(offsetof(SharedCatCacheCtlData, slots),
+								 mul_size(shared_catcache_entries,
+										  sizeof(SharedCatCacheSlot))),
+						&found);
+	if (!found)
+	{
+		int			i;
+
+		SpinLockInit(&SharedCatCacheCtl->mutex);
+		SharedCatCacheCtl->generation = 0;
+
+		/* Divide the slots evenly among the partitions */
+		for (i = 0; i < NUM_SHARED_CATCACHE_PARTITIONS; i++)
+		{
+			SharedCatCachePartition *part = &SharedCatCacheCtl->partitions[i];
+			int			next_slot;
+
+			part->generation = 0;
+			part->first_slot = (int) ((int64) shared_catcache_entries * i /
+									  NUM_SHARED_CATCACHE_PARTITIONS);
+			next_slot = (int) ((int64) shared_catcache_entries * (i + 1) /
+							   NUM_SHARED_CATCACHE_PARTITIONS);
+			part->nslots = next_slot - part->first_slot;
+			part->clock_hand = part->first_slot;
+		}
+		for (i = 0; i < shared_catcache_entries; i++)
+		{
+			SharedCatCacheCtl->slots[i].used = false;
+			SharedCatCacheCtl->slots[i].recently_used = false;
+		}
+	}
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(SharedCatCacheKey);
+	info.entrysize = sizeof(SharedCatCacheLookupEnt);
+	info.num_partitions = NUM_SHARED_CATCACHE_PARTITIONS;
+	SharedCatCacheHash = ShmemInitHash("Shared Catalog Cache Lookup",
+									   shared_catcache_entries,
+									   shared_catcache_entries,
+									   &info,
+									   HASH_ELEM | HASH_BLOBS |
+									   HASH_PARTITION);
+}
+
+/*
+ * Can this backend use the shared cache for the given catcache just now?
+ */
+bool
+SharedCatCacheUsable(CatCache *cache)
+{
+	if (SharedCatCacheCtl == NULL)
+		return false;
+	if (IsBootstrapProcessingMode())
+		return false;
+	/* Logical decoding sees the catalogs as of the past */
+	if (HistoricSnapshotActive())
+		return false;
+	if (!cache->cc_relisshared && !OidIsValid(MyDatabaseId))
+		return false;
+	/* See if we might have modified the catalogs */
+	if (TransactionIdIsValid(GetTopTransactionIdIfAny()))
+		return false;
+	return true;
+}
+
+static void
+SharedCatCacheSetKey(SharedCatCacheKey *key, CatCache *cache,
+					 uint32 hashValue)
+{
+	MemSet(key, 0, sizeof(SharedCatCacheKey));
+	key->dbid = cache->cc_relisshared ? InvalidOid : MyDatabaseId;
+	key->cacheId = cache->id;
+	key->hashValue = hashValue;
+}
+
+/*
+ * SharedCatCacheSearch
+ *
+ * Returns a palloc'd copy of the shared tuple with the given hash value,
+ * or NULL if there is none.  In the latter case, the current generation of
+ * its partition is returned in *generation, to be passed to
+ * SharedCatCacheInsert once the tuple has been loaded, and the catalog
+ * snapshot is made fresh enough for that.  Caller must have checked
+ * SharedCatCacheUsable.
+ */
+HeapTuple
+SharedCatCacheSearch(CatCache *cache, uint32 hashValue, uint64 *generation)
+{
+	SharedCatCacheKey key;
+	uint32		hashcode;
+	LWLock	   *partitionLock;
+	SharedCatCacheLookupEnt *ent;
+	HeapTuple	tuple = NULL;
+	uint64		global_generation;
+
+	SharedCatCacheSetKey(&key, cache, hashValue);
+	hashcode = get_hash_value(SharedCatCacheHash, &key);
+	partitionLock = SharedCatCachePartitionLock(hashcode);
+
+	LWLockAcquire(partitionLock, LW_SHARED);
+
+	ent = (SharedCatCacheLookupEnt *)
+		hash_search_with_hash_value(SharedCatCacheHash, &key, hashcode,
+									HASH_FIND, NULL);
+	if (ent != NULL)
+	{
+		SharedCatCacheSlot *slot = &SharedCatCacheCtl->slots[ent->slot];
+
+		tuple = (HeapTuple) palloc(HEAPTUPLESIZE + slot->t_len);
+		tuple->t_len = slot->t_len;
+		tuple->t_self = slot->t_self;
+		tuple->t_tableOid = slot->reloid;
+		tuple->t_data = (HeapTupleHeader) ((char *) tuple + HEAPTUPLESIZE);
+		memcpy((char *) tuple->t_data, slot->data, slot->t_len);
+		slot->recently_used = true;
+	}
+	*generation = SharedCatCacheCtl->partitions[
+						SharedCatCacheHashPartition(hashcode)].generation;
+
+	LWLockRelease(partitionLock);
+
+	if (tuple != NULL)
+		return tuple;
+
+	/*
+	 * If there have been invalidations since our catalog snapshot was known
+	 * to be newer than the global counter, it may predate one of them.
+	 * Removals advance the global counter while holding the partition lock,
+	 * so any removal from our partition before the above has been counted.
+	 */
+	SpinLockAcquire(&SharedCatCacheCtl->mutex);
+	global_generation = SharedCatCacheCtl->generation;
+	SpinLockRelease(&SharedCatCacheCtl->mutex);
+
+	if (!snapshot_generation_valid || snapshot_generation != global_generation)
+	{
+		InvalidateCatalogSnapshot();
+		snapshot_generation = global_generation;
+		snapshot_generation_valid = true;
+	}
+
+	return NULL;
+}
+
+/*
+ * SharedCatCacheInsert
+ *
+ * Enter a tuple loaded from the catalog into the shared cache, unless it
+ * might have been invalidated since the generation given by
+ * SharedCatCacheSearch.  The tuple must not be toasted.
+ */
+void
+SharedCatCacheInsert(CatCache *cache, uint32 hashValue, HeapTuple tuple,
+					 uint64 generation)
+{
+	SharedCatCacheKey key;
+	uint32		hashcode;
+	LWLock	   *partitionLock;
+	SharedCatCachePartition *part;
+	SharedCatCacheLookupEnt *ent;
+	SharedCatCacheSlot *slot;
+	bool		found;
+
+	if (tuple->t_len > SHARED_CATCACHE_TUPLE_SIZE)
+		return;
+
+	SharedCatCacheSetKey(&key, cache, hashValue);
+	hashcode = get_hash_value(SharedCatCacheHash, &key);
+	partitionLock = SharedCatCachePartitionLock(hashcode);
+	part = &SharedCatCacheCtl->partitions[SharedCatCacheHashPartition(hashcode)];
+
+	/* With very few entries, some partitions have no slots */
+	if (part->nslots == 0)
+		return;
+
+	LWLockAcquire(partitionLock, LW_EXCLUSIVE);
+
+	if (part->generation != generation)
+	{
+		LWLockRelease(partitionLock);
+		return;
+	}
+
+	ent = (SharedCatCacheLookupEnt *)
+		hash_search_with_hash_value(SharedCatCacheHash, &key, hashcode,
+									HASH_FIND, NULL);
+	if (ent != NULL)
+		slot = &SharedCatCacheCtl->slots[ent->slot];
+	else
+	{
+		int			slotno;
+
+		/* Run the clock sweep to find a free or not recently used slot */
+		for (;;)
+		{
+			slotno = part->clock_hand;
+			slot = &SharedCatCacheCtl->slots[slotno];
+			if (++part->clock_hand >= part->first_slot + part->nslots)
+				part->clock_hand = part->first_slot;
+			if (!slot->used)
+				break;
+			if (!slot->recently_used)
+			{
+				SharedCatCacheRemoveSlot(slot);
+				break;
+			}
+			slot->recently_used = false;
+		}
+
+		ent = (SharedCatCacheLookupEnt *)
+			hash_search_with_hash_value(SharedCatCacheHash, &key, hashcode,
+										HASH_ENTER_NULL, &found);
+		if (ent == NULL)
+		{
+			LWLockRelease(partitionLock);
+			return;
+		}
+		Assert(!found);
+		ent->slot = slotno;
+		slot->used = true;
+		slot->key = key;
+	}
+
+	slot->recently_used = true;
+	slot->reloid = cache->cc_reloid;
+	slot->t_self = tuple->t_self;
+	slot->t_len = tuple->t_len;
+	memcpy(slot->data, (char *) tuple->t_data, tuple->t_len);
+
+	LWLockRelease(partitionLock);
+}
+
+/*
+ * Lock a partition exclusively to remove tuples covered by invalidations.
+ *
+ * The counters are advanced right away: until the lock is released, nobody
+ * can look at the partition, and others' catalog snapshots may just as well
+ * be refreshed a bit early.
+ */
+static SharedCatCachePartition *
+SharedCatCacheLockForRemoval(int partition)
+{
+	SharedCatCachePartition *part = &SharedCatCacheCtl->partitions[partition];
+
+	LWLockAcquire(SharedCatCachePartitionLockByIndex(partition), LW_EXCLUSIVE);
+
+	part->generation++;
+	SpinLockAcquire(&SharedCatCacheCtl->mutex);
+	SharedCatCacheCtl->generation++;
+	SpinLockRelease(&SharedCatCacheCtl->mutex);
+
+	return part;
+}
+
+/*
+ * Remove a slot's tuple.  Caller must hold the lock of the slot's partition
+ * exclusively.
+ */
+static void
+SharedCatCacheRemoveSlot(SharedCatCacheSlot *slot)
+{
+	Assert(slot->used);
+	hash_search(SharedCatCacheHash, &slot->key, HASH_REMOVE, NULL);
+	slot->used = false;
+	slot->recently_used = false;
+}
+
+/*
+ * Remove the tuples of a database, or only those of one of its catalogs if
+ * reloid is valid, from all partitions.
+ */
+static void
+SharedCatCacheRemoveMatching(Oid dbid, Oid reloid)
+{
+	int			i;
+
+	for (i = 0; i < NUM_SHARED_CATCACHE_PARTITIONS; i++)
+	{
+		SharedCatCachePartition *part = SharedCatCacheLockForRemoval(i);
+		int			j;
+
+		for (j = part->first_slot; j < part->first_slot + part->nslots; j++)
+		{
+			SharedCatCacheSlot *slot = &SharedCatCacheCtl->slots[j];
+
+			if (slot->used && slot->key.dbid == dbid &&
+				(!OidIsValid(reloid) || slot->reloid == reloid))
+				SharedCatCacheRemoveSlot(slot);
+		}
+
+		LWLockRelease(SharedCatCachePartitionLockByIndex(i));
+	}
+}
+
+/*
+ * SharedCatCacheInvalidate
+ *
+ * Remove the tuples covered by the given invalidation messages.  This is
+ * called for every message sent to other backends.
+ */
+void
+SharedCatCacheInvalidate(const SharedInvalidationMessage *msgs, int n)
+{
+	int			i;
+
+	if (SharedCatCacheCtl == NULL)
+		return;
+
+	for (i = 0; i < n; i++)
+	{
+		const SharedInvalidationMessage *msg = &msgs[i];
+
+		if (msg->id >= 0)
+		{
+			SharedCatCacheKey key;
+			uint32		hashcode;
+			SharedCatCacheLookupEnt *ent;
+
+			MemSet(&key, 0, sizeof(key));
+			key.dbid = msg->cc.dbId;
+			key.cacheId = msg->cc.id;
+			key.hashValue = msg->cc.hashValue;
+			hashcode = get_hash_value(SharedCatCacheHash, &key);
+
+			SharedCatCacheLockForRemoval(SharedCatCacheHashPartition(hashcode));
+			ent = (SharedCatCacheLookupEnt *)
+				hash_search_with_hash_value(SharedCatCacheHash, &key,
+											hashcode, HASH_FIND, NULL);
+			if (ent != NULL)
+				SharedCatCacheRemoveSlot(&SharedCatCacheCtl->slots[ent->slot]);
+			LWLockRelease(SharedCatCachePartitionLock(hashcode));
+		}
+		else if (msg->id == SHAREDINVALCATALOG_ID)
+			SharedCatCacheRemoveMatching(msg->cat.dbId, msg->cat.catId);
+	}
+}
+
+/*
+ * SharedCatCacheDropDatabase
+ *
+ * Remove all tuples of a database being dropped, lest a database created
+ * later with the same OID find them.
+ */
+void
+SharedCatCacheDropDatabase(Oid dbid)
+{
+	if (SharedCatCacheCtl == NULL)
+		return;
+
+	SharedCatCacheRemoveMatching(dbid, InvalidOid);
+}
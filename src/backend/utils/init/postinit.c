@@ -48,6 +48,7 @@
 #include "storage/proc.h"
 #include "storage/sinvaladt.h"
 #include "storage/smgr.h"
+#include "tcop/sessionpool.h"
 #include "tcop/tcopprot.h"
 #include "utils/acl.h"
 #include "utils/fmgroids.h"
@@ -529,7 +530,9 @@ BaseInit(void)
  * In bootstrap mode no parameters are used.  The autovacuum launcher process
  * doesn't use any parameters either, because it only goes far enough to be
  * able to read pg_database; it doesn't connect to any particular database.
- * In walsender mode only username is used.
+ * In walsender mode only username is used.  A background worker may also
+ * pass neither a database name nor OID, in which case it can only access
+ * shared catalogs.
  *
  * As of PostgreSQL 8.2, we expect InitProcess() was already called, so we
  * already have a PGPROC struct ... but it's not completely filled in yet.
@@ -799,6 +802,22 @@ InitPostgres(const char *in_dbname, Oid dboid, const char *username,
 		return;
 	}
 
+	/*
+	 * A background worker that did not ask for a particular database, such
+	 * as the logical replication launcher, can only access shared catalogs.
+	 * We're done with it now.
+	 */
+	if (IsBackgroundWorker && in_dbname == NULL && !OidIsValid(dboid))
+	{
+		/* report this backend in the PgBackendStatus array */
+		pgstat_bestart();
+
+		/* close the transaction we started above */
+		CommitTransactionCommand();
+
+		return;
+	}
+
 	/*
 	 * Set up the global variables holding database id and default tablespace.
 	 * But note we won't actually try to touch the database just yet.
@@ -949,17 +968,26 @@ InitPostgres(const char *in_dbname, Oid dboid, const char *username,
 	if (!bootstrap)
 		CheckMyDatabase(dbname, am_superuser);
 
+	/* Process pg_db_role_setting options */
+	process_settings(MyDatabaseId, GetSessionUserId());
+
+	/*
+	 * With session pooling, the settings so far are common to all sessions
+	 * of this database and role; remember them so that a pooled backend can
+	 * return to them between sessions.
+	 */
+	if (session_pool_size > 0 && MyProcPort != NULL)
+		CaptureGUCBaseline();
+
 	/*
 	 * Now process any command-line switches and any additional GUC variable
 	 * settings passed in the startup packet.   We couldn't do this before
-	 * because we didn't know if client is a superuser.
+	 * because we didn't know if client is a superuser.  (They take priority
+	 * over the pg_db_role_setting options regardless of the order.)
 	 */
 	if (MyProcPort != NULL)
 		process_startup_options(MyProcPort, am_superuser);
 
-	/* Process pg_db_role_setting options */
-	process_settings(MyDatabaseId, GetSessionUserId());
-
 	/* Apply PostAuthDelay as soon as we've read all options */
 	if (PostAuthDelay > 0)
 		pg_usleep(PostAuthDelay * 1000000L);
@@ -31,6 +31,8 @@
 #include "access/transam.h"
 #include "access/twophase.h"
 #include "access/xact.h"
+#include "access/xlogparallel.h"
+#include "access/xlogprefetch.h"
 #include "catalog/namespace.h"
 #include "commands/async.h"
 #include "commands/prepare.h"
@@ -58,6 +60,8 @@
 #include "postmaster/postmaster.h"
 #include "postmaster/syslogger.h"
 #include "postmaster/walwriter.h"
+#include "replication/logicallauncher.h"
+#include "replication/reorderbuffer.h"
 #include "replication/slot.h"
 #include "replication/syncrep.h"
 #include "replication/walreceiver.h"
@@ -69,6 +73,7 @@
 #include "storage/pg_shmem.h"
 #include "storage/proc.h"
 #include "storage/predicate.h"
+#include "tcop/sessionpool.h"
 #include "tcop/tcopprot.h"
 #include "tsearch/ts_cache.h"
 #include "utils/builtins.h"
@@ -79,7 +84,9 @@
 #include "utils/plancache.h"
 #include "utils/portal.h"
 #include "utils/ps_status.h"
+#include "utils/relcache.h"
 #include "utils/rls.h"
+#include "utils/sharedcatcache.h"
 #include "utils/snapmgr.h"
 #include "utils/tzparser.h"
 #include "utils/xml.h"
@@ -347,6 +354,7 @@ static const struct config_enum_entry constraint_exclusion_options[] = {
 static const struct config_enum_entry synchronous_commit_options[] = {
 	{"local", SYNCHRONOUS_COMMIT_LOCAL_FLUSH, false},
 	{"remote_write", SYNCHRONOUS_COMMIT_REMOTE_WRITE, false},
+	{"remote_apply", SYNCHRONOUS_COMMIT_REMOTE_APPLY, false},
 	{"on", SYNCHRONOUS_COMMIT_ON, false},
 	{"off", SYNCHRONOUS_COMMIT_OFF, false},
 	{"true", SYNCHRONOUS_COMMIT_ON, true},
@@ -796,6 +804,15 @@ static struct config_bool ConfigureNamesBool[] =
 		true,
 		NULL, NULL, NULL
 	},
+	{
+		{"enable_indexskipscan", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables the planner's use of index skip scans."),
+			NULL
+		},
+		&enable_indexskipscan,
+		true,
+		NULL, NULL, NULL
+	},
 	{
 		{"enable_bitmapscan", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Enables the planner's use of bitmap-scan plans."),
@@ -841,6 +858,15 @@ static struct config_bool ConfigureNamesBool[] =
 		true,
 		NULL, NULL, NULL
 	},
+	{
+		{"enable_memoize", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables the planner's use of memoization of parameterized nested-loop inner scans."),
+			NULL
+		},
+		&enable_memoize,
+		true,
+		NULL, NULL, NULL
+	},
 	{
 		{"enable_nestloop", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Enables the planner's use of nested-loop join plans."),
@@ -868,6 +894,24 @@ static struct config_bool ConfigureNamesBool[] =
 		true,
 		NULL, NULL, NULL
 	},
+	{
+		{"enable_partitionwise_join", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables the planner's use of partition-wise joins."),
+			NULL
+		},
+		&enable_partitionwise_join,
+		false,
+		NULL, NULL, NULL
+	},
+	{
+		{"enable_partitionwise_aggregate", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables the planner's use of partition-wise grouping and aggregation."),
+			NULL
+		},
+		&enable_partitionwise_aggregate,
+		false,
+		NULL, NULL, NULL
+	},
 	{
 		{"geqo", PGC_USERSET, QUERY_TUNING_GEQO,
 			gettext_noop("Enables genetic query optimization."),
@@ -878,6 +922,25 @@ static struct config_bool ConfigureNamesBool[] =
 		true,
 		NULL, NULL, NULL
 	},
+	{
+		{"geqo_idp", PGC_USERSET, QUERY_TUNING_GEQO,
+			gettext_noop("GEQO: use iterative dynamic programming instead of the genetic algorithm."),
+			gettext_noop("This makes the join order search for large queries "
+						 "deterministic.")
+		},
+		&geqo_idp,
+		true,
+		NULL, NULL, NULL
+	},
+	{
+		{"plan_cache_adaptive", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Chooses between custom and generic plans of prepared statements by measured run times."),
+			gettext_noop("Otherwise the choice is based on estimated costs only.")
+		},
+		&plan_cache_adaptive,
+		false,
+		NULL, NULL, NULL
+	},
 	{
 		/* Not for general use --- used by SET SESSION AUTHORIZATION */
 		{"is_superuser", PGC_INTERNAL, UNGROUPED,
@@ -907,6 +970,15 @@ static struct config_bool ConfigureNamesBool[] =
 		false,
 		NULL, NULL, NULL
 	},
+	{
+		{"session_pooling", PGC_BACKEND, CONN_AUTH_SETTINGS,
+			gettext_noop("Allows this session to be served by a pooled backend."),
+			gettext_noop("Has no effect unless session_pool_size is set.")
+		},
+		&session_pooling,
+		true,
+		NULL, NULL, NULL
+	},
 	{
 		{"ssl", PGC_POSTMASTER, CONN_AUTH_SECURITY,
 			gettext_noop("Enables SSL connections."),
@@ -1678,6 +1750,15 @@ static struct config_int ConfigureNamesInt[] =
 		8, 1, INT_MAX,
 		NULL, NULL, NULL
 	},
+	{
+		{"plan_cache_shared_entries", PGC_POSTMASTER, QUERY_TUNING_OTHER,
+			gettext_noop("Sets the maximum number of queries whose plan choice statistics are shared between sessions."),
+			NULL
+		},
+		&plan_cache_shared_entries,
+		1000, 0, INT_MAX / 2,
+		NULL, NULL, NULL
+	},
 	{
 		{"geqo_threshold", PGC_USERSET, QUERY_TUNING_GEQO,
 			gettext_noop("Sets the threshold of FROM items beyond which GEQO is used."),
@@ -1687,6 +1768,15 @@ static struct config_int ConfigureNamesInt[] =
 		12, 2, INT_MAX,
 		NULL, NULL, NULL
 	},
+	{
+		{"geqo_idp_block_size", PGC_USERSET, QUERY_TUNING_GEQO,
+			gettext_noop("GEQO: number of FROM items joined in each round of iterative dynamic programming."),
+			NULL
+		},
+		&geqo_idp_block_size,
+		4, 2, INT_MAX,
+		NULL, NULL, NULL
+	},
 	{
 		{"geqo_effort", PGC_USERSET, QUERY_TUNING_GEQO,
 			gettext_noop("GEQO: effort is used to set the default for other GEQO parameters."),
@@ -1791,6 +1881,28 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"session_pool_size", PGC_POSTMASTER, CONN_AUTH_SETTINGS,
+			gettext_noop("Sets the number of pooled backends per database and role."),
+			gettext_noop("Client sessions are multiplexed onto this many backends "
+						 "for each combination of database and role. "
+						 "0 disables session pooling.")
+		},
+		&session_pool_size,
+		0, 0, MAX_BACKENDS,
+		check_session_pool_size, NULL, NULL
+	},
+
+	{
+		{"max_pooled_sessions", PGC_POSTMASTER, CONN_AUTH_SETTINGS,
+			gettext_noop("Sets the maximum number of client sessions served by one pooled backend."),
+			NULL
+		},
+		&max_pooled_sessions,
+		100, 1, MAX_BACKENDS,
+		NULL, NULL, NULL
+	},
+
 	/*
 	 * We sometimes multiply the number of shared buffers by two without
 	 * checking for overflow, so we mustn't allow more than INT_MAX / 2.
@@ -1880,6 +1992,19 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"logical_decoding_work_mem", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the maximum memory to be used for logical decoding."),
+			gettext_noop("This much memory can be used by each logical decoding "
+						 "session to buffer changes of transactions, before "
+						 "they are streamed or spilled to disk."),
+			GUC_UNIT_KB
+		},
+		&logical_decoding_work_mem,
+		65536, 64, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
 	/*
 	 * We use the hopefully-safely-small value of 100kB as the compiled-in
 	 * default for max_stack_depth.  InitializeGUCOptions will increase it if
@@ -1896,6 +2021,40 @@ static struct config_int ConfigureNamesInt[] =
 		check_max_stack_depth, assign_max_stack_depth, NULL
 	},
 
+	{
+		{"shared_catcache_entries", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the number of system catalog tuples cached in shared memory."),
+			gettext_noop("Zero disables the shared catalog cache.")
+		},
+		&shared_catcache_entries,
+		0, 0, INT_MAX / 1024,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"catalog_cache_memory_limit", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the maximum memory to be used by the catalog caches."),
+			gettext_noop("When exceeded, the least recently used entries are evicted. "
+						 "Zero means no limit."),
+			GUC_UNIT_KB
+		},
+		&catalog_cache_memory_limit,
+		0, 0, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"relation_cache_memory_limit", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the maximum memory to be used by the relation cache."),
+			gettext_noop("When exceeded at commit, the least recently used entries "
+						 "are evicted. Zero means no limit."),
+			GUC_UNIT_KB
+		},
+		&relation_cache_memory_limit,
+		0, 0, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"temp_file_limit", PGC_SUSET, RESOURCES_DISK,
 			gettext_noop("Limits the total size of all temporary files used by each session."),
@@ -2226,6 +2385,31 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"recovery_workers", PGC_POSTMASTER, WAL_SETTINGS,
+			gettext_noop("Sets the number of background workers used to replay WAL during recovery."),
+			gettext_noop("Zero replays all WAL in the startup process.")
+		},
+		&recovery_workers,
+		0, 0, MAX_BACKENDS,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"recovery_prefetch_distance", PGC_SIGHUP, WAL_SETTINGS,
+			gettext_noop("Sets how far ahead of replay to look for blocks to prefetch during recovery."),
+			gettext_noop("Zero disables prefetching."),
+			GUC_UNIT_KB
+		},
+		&recovery_prefetch_distance,
+#ifdef USE_PREFETCH
+		0, 0, MAX_KILOBYTES,
+#else
+		0, 0, 0,
+#endif
+		NULL, NULL, NULL
+	},
+
 	{
 		/* see max_connections */
 		{"max_wal_senders", PGC_POSTMASTER, REPLICATION_SENDING,
@@ -2467,6 +2651,16 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"max_logical_replication_workers", PGC_POSTMASTER, REPLICATION_STANDBY,
+			gettext_noop("Sets the maximum number of logical replication apply workers."),
+			gettext_noop("Zero disables the logical replication launcher."),
+		},
+		&max_logical_replication_workers,
+		4, 0, MAX_BACKENDS,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"wal_segment_size", PGC_INTERNAL, PRESET_OPTIONS,
 			gettext_noop("Shows the number of pages per write ahead log segment."),
@@ -2658,6 +2852,17 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"max_stats_entries", PGC_POSTMASTER, STATS_COLLECTOR,
+			gettext_noop("Sets the maximum number of tables tracked by the statistics system."),
+			gettext_noop("Space for a proportional number of functions and databases "
+						 "is reserved as well.")
+		},
+		&pgstat_max_entries,
+		250000, 100, INT_MAX / 2,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gin_pending_list_limit", PGC_USERSET, CLIENT_CONN_STATEMENT,
 			gettext_noop("Sets the maximum size of the pending list for GIN index."),
@@ -3321,13 +3526,12 @@ static struct config_string ConfigureNamesString[] =
 
 	{
 		{"synchronous_standby_names", PGC_SIGHUP, REPLICATION_MASTER,
-			gettext_noop("List of names of potential synchronous standbys."),
-			NULL,
-			GUC_LIST_INPUT
+			gettext_noop("Number and names of synchronous standbys."),
+			NULL
 		},
 		&SyncRepStandbyNames,
 		"",
-		check_synchronous_standby_names, NULL, NULL
+		check_synchronous_standby_names, assign_synchronous_standby_names, NULL
 	},
 
 	{
@@ -9006,6 +9210,384 @@ RestoreGUCState(void *gucstate)
 	}
 }
 
+/*
+ * Session pooling support
+ *
+ * A pooled backend serves several client sessions, one at a time.  The
+ * settings a session made for itself, in its startup packet or with SET, are
+ * saved when the backend switches away from it and reapplied when it is
+ * switched back in.  In between, those variables are put back to the
+ * baseline: the values in effect once the configuration file and the
+ * per-database and per-role settings have been processed.
+ */
+
+typedef struct GucBaselineEntry
+{
+	char	   *name;
+	char	   *value;
+	GucSource	source;
+	GucContext	scontext;
+	char	   *sourcefile;
+	int			sourceline;
+} GucBaselineEntry;
+
+static GucBaselineEntry *guc_baseline = NULL;
+static int	num_guc_baseline = 0;
+
+/* Entry flags in a serialized session state */
+#define SESSION_GUC_HAS_RESET	0x01
+#define SESSION_GUC_HAS_VALUE	0x02
+
+/*
+ * Is a setting from this source specific to the client session?  Settings
+ * forced with PGC_S_OVERRIDE at startup are part of the baseline; those that
+ * follow from session settings (is_superuser) are recomputed by assign hooks.
+ */
+static bool
+is_session_guc_source(GucSource source)
+{
+	return source >= PGC_S_CLIENT && source != PGC_S_OVERRIDE;
+}
+
+/*
+ * Should this variable be part of a session's state at all?
+ */
+static bool
+is_session_guc(struct config_generic * gconf)
+{
+	/* session_pooling only matters to the process a session started in */
+	if (strcmp(gconf->name, "session_pooling") == 0)
+		return false;
+
+	return is_session_guc_source(gconf->source) ||
+		is_session_guc_source(gconf->reset_source);
+}
+
+/*
+ * Format the current or reset value of a variable for re-setting it.
+ */
+static char *
+session_guc_value(struct config_generic * gconf, bool reset)
+{
+	switch (gconf->vartype)
+	{
+		case PGC_BOOL:
+			{
+				struct config_bool *conf = (struct config_bool *) gconf;
+				bool		val = reset ? conf->reset_val : *conf->variable;
+
+				return pstrdup(val ? "on" : "off");
+			}
+		case PGC_INT:
+			{
+				struct config_int *conf = (struct config_int *) gconf;
+
+				return psprintf("%d", reset ? conf->reset_val : *conf->variable);
+			}
+		case PGC_REAL:
+			{
+				struct config_real *conf = (struct config_real *) gconf;
+
+				return psprintf("%.*g", REALTYPE_PRECISION,
+								reset ? conf->reset_val : *conf->variable);
+			}
+		case PGC_STRING:
+			{
+				struct config_string *conf = (struct config_string *) gconf;
+				char	   *val = reset ? conf->reset_val : *conf->variable;
+
+				return pstrdup(val ? val : "");
+			}
+		case PGC_ENUM:
+			{
+				struct config_enum *conf = (struct config_enum *) gconf;
+
+				return pstrdup(config_enum_lookup_by_value(conf,
+								reset ? conf->reset_val : *conf->variable));
+			}
+	}
+	return NULL;				/* keep compiler quiet */
+}
+
+static int
+guc_baseline_compare(const void *a, const void *b)
+{
+	const GucBaselineEntry *ea = (const GucBaselineEntry *) a;
+	const GucBaselineEntry *eb = (const GucBaselineEntry *) b;
+
+	return guc_name_compare(ea->name, eb->name);
+}
+
+/*
+ * CaptureGUCBaseline:
+ * Remember the current settings as the ones to return to whenever no client
+ * session is active.  Called outside any client session, and again after the
+ * configuration file has been re-read.
+ */
+void
+CaptureGUCBaseline(void)
+{
+	int			i;
+
+	for (i = 0; i < num_guc_baseline; i++)
+	{
+		free(guc_baseline[i].name);
+		free(guc_baseline[i].value);
+		if (guc_baseline[i].sourcefile)
+			free(guc_baseline[i].sourcefile);
+	}
+	if (guc_baseline)
+		free(guc_baseline);
+	num_guc_baseline = 0;
+
+	guc_baseline = (GucBaselineEntry *)
+		guc_malloc(FATAL, num_guc_variables * sizeof(GucBaselineEntry));
+
+	for (i = 0; i < num_guc_variables; i++)
+	{
+		struct config_generic *gconf = guc_variables[i];
+		GucBaselineEntry *entry;
+		char	   *value;
+
+		if (gconf->source == PGC_S_DEFAULT)
+			continue;
+
+		entry = &guc_baseline[num_guc_baseline++];
+		value = session_guc_value(gconf, false);
+		entry->name = guc_strdup(FATAL, gconf->name);
+		entry->value = guc_strdup(FATAL, value);
+		entry->source = gconf->source;
+		entry->scontext = gconf->scontext;
+		entry->sourcefile = gconf->sourcefile ?
+			guc_strdup(FATAL, gconf->sourcefile) : NULL;
+		entry->sourceline = gconf->sourceline;
+		pfree(value);
+	}
+
+	qsort(guc_baseline, num_guc_baseline, sizeof(GucBaselineEntry),
+		  guc_baseline_compare);
+}
+
+/*
+ * Put a variable back to its baseline value.
+ */
+static void
+reset_guc_to_baseline(struct config_generic * gconf)
+{
+	GucBaselineEntry key;
+	GucBaselineEntry *entry;
+
+	key.name = (char *) gconf->name;
+	entry = (GucBaselineEntry *) bsearch(&key, guc_baseline, num_guc_baseline,
+										 sizeof(GucBaselineEntry),
+										 guc_baseline_compare);
+
+	/* Let the lower-priority baseline setting replace the session's */
+	gconf->source = PGC_S_DEFAULT;
+	gconf->reset_source = PGC_S_DEFAULT;
+
+	if (entry)
+	{
+		(void) set_config_option(entry->name, entry->value,
+								 entry->scontext, entry->source,
+								 GUC_ACTION_SET, true, ERROR, false);
+		if (entry->sourcefile)
+			set_config_sourcefile(entry->name, entry->sourcefile,
+								  entry->sourceline);
+	}
+	else
+		(void) set_config_option(gconf->name, NULL,
+								 gconf->context, PGC_S_DEFAULT,
+								 GUC_ACTION_SET, true, ERROR, false);
+}
+
+/*
+ * SaveSessionGUCState:
+ * Serialize the settings specific to the current client session into a
+ * palloc'd buffer, whose length is returned in *len.
+ *
+ * *poolable is set to false if the session has settings that cannot be
+ * carried over to another backend.
+ */
+char *
+SaveSessionGUCState(Size *len, bool *poolable)
+{
+	StringInfoData buf;
+	int			i;
+	int			i_role = -1;
+
+	initStringInfo(&buf);
+	*poolable = true;
+
+	for (i = 0; i <= num_guc_variables; i++)
+	{
+		struct config_generic *gconf;
+		char		flags = 0;
+
+		/* As in SerializeGUCState, "role" must follow session_authorization */
+		if (i == num_guc_variables)
+		{
+			if (i_role < 0)
+				break;
+			gconf = guc_variables[i_role];
+		}
+		else
+		{
+			gconf = guc_variables[i];
+			if (strcmp(gconf->name, "role") == 0)
+			{
+				i_role = i;
+				continue;
+			}
+		}
+
+		if (!is_session_guc(gconf))
+			continue;
+
+		/*
+		 * Only variables that can be changed at any time can be moved to
+		 * another backend.  Preloaded libraries are loaded at backend start
+		 * only, so a session asking for its own can't be moved either.
+		 */
+		if ((gconf->context != PGC_USERSET && gconf->context != PGC_SUSET) ||
+			strcmp(gconf->name, "session_preload_libraries") == 0 ||
+			strcmp(gconf->name, "local_preload_libraries") == 0)
+			*poolable = false;
+
+		if (is_session_guc_source(gconf->reset_source))
+			flags |= SESSION_GUC_HAS_RESET;
+		if (is_session_guc_source(gconf->source))
+			flags |= SESSION_GUC_HAS_VALUE;
+
+		appendBinaryStringInfo(&buf, gconf->name, strlen(gconf->name) + 1);
+		appendBinaryStringInfo(&buf, &flags, sizeof(flags));
+		if (flags & SESSION_GUC_HAS_RESET)
+		{
+			char	   *value = session_guc_value(gconf, true);
+
+			appendBinaryStringInfo(&buf, value, strlen(value) + 1);
+			appendBinaryStringInfo(&buf, (char *) &gconf->reset_source,
+								   sizeof(gconf->reset_source));
+			appendBinaryStringInfo(&buf, (char *) &gconf->reset_scontext,
+								   sizeof(gconf->reset_scontext));
+			pfree(value);
+		}
+		if (flags & SESSION_GUC_HAS_VALUE)
+		{
+			char	   *value = session_guc_value(gconf, false);
+
+			appendBinaryStringInfo(&buf, value, strlen(value) + 1);
+			appendBinaryStringInfo(&buf, (char *) &gconf->source,
+								   sizeof(gconf->source));
+			appendBinaryStringInfo(&buf, (char *) &gconf->scontext,
+								   sizeof(gconf->scontext));
+			pfree(value);
+		}
+	}
+
+	*len = buf.len;
+	return buf.data;
+}
+
+/*
+ * ResetSessionGUCState:
+ * Return all settings specific to the current client session to the
+ * baseline.  Must be called in a transaction, as check hooks may need to
+ * consult the catalogs.
+ */
+void
+ResetSessionGUCState(void)
+{
+	bool		save_reporting_enabled = reporting_enabled;
+	int			i;
+	int			i_role = -1;
+
+	Assert(IsTransactionState());
+
+	/* The client of the session doesn't get to see these changes */
+	reporting_enabled = false;
+	PG_TRY();
+	{
+		for (i = 0; i < num_guc_variables; i++)
+		{
+			if (strcmp(guc_variables[i]->name, "role") == 0)
+				i_role = i;
+			else if (is_session_guc(guc_variables[i]))
+				reset_guc_to_baseline(guc_variables[i]);
+		}
+		if (i_role >= 0 && is_session_guc(guc_variables[i_role]))
+			reset_guc_to_baseline(guc_variables[i_role]);
+	}
+	PG_CATCH();
+	{
+		reporting_enabled = save_reporting_enabled;
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+	reporting_enabled = save_reporting_enabled;
+}
+
+/*
+ * RestoreSessionGUCState:
+ * Reapply the settings saved by SaveSessionGUCState.  The variables involved
+ * should be at their baseline values.  Must be called in a transaction.
+ */
+void
+RestoreSessionGUCState(char *state, Size len)
+{
+	bool		save_reporting_enabled = reporting_enabled;
+	char	   *srcptr = state;
+	char	   *srcend = state + len;
+
+	Assert(IsTransactionState());
+
+	reporting_enabled = false;
+	PG_TRY();
+	{
+		while (srcptr < srcend)
+		{
+			char	   *varname;
+			char	   *varvalue;
+			char		flags;
+			GucSource	varsource;
+			GucContext	varscontext;
+
+			varname = read_gucstate(&srcptr, srcend);
+			read_gucstate_binary(&srcptr, srcend, &flags, sizeof(flags));
+
+			if (flags & SESSION_GUC_HAS_RESET)
+			{
+				varvalue = read_gucstate(&srcptr, srcend);
+				read_gucstate_binary(&srcptr, srcend,
+									 &varsource, sizeof(varsource));
+				read_gucstate_binary(&srcptr, srcend,
+									 &varscontext, sizeof(varscontext));
+				(void) set_config_option(varname, varvalue,
+										 varscontext, varsource,
+										 GUC_ACTION_SET, true, ERROR, false);
+			}
+			if (flags & SESSION_GUC_HAS_VALUE)
+			{
+				varvalue = read_gucstate(&srcptr, srcend);
+				read_gucstate_binary(&srcptr, srcend,
+									 &varsource, sizeof(varsource));
+				read_gucstate_binary(&srcptr, srcend,
+									 &varscontext, sizeof(varscontext));
+				(void) set_config_option(varname, varvalue,
+										 varscontext, varsource,
+										 GUC_ACTION_SET, true, ERROR, false);
+			}
+		}
+	}
+	PG_CATCH();
+	{
+		reporting_enabled = save_reporting_enabled;
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+	reporting_enabled = save_reporting_enabled;
+}
+
 /*
  * A little "long argument" simulation, although not quite GNU
  * compliant. Takes a string of the form "some-option=some value" and
@@ -10021,28 +10603,14 @@ assign_pgstat_temp_directory(const char *newval, void *extra)
 {
 	/* check_canonical_path already canonicalized newval for us */
 	char	   *dname;
-	char	   *tname;
-	char	   *fname;
 
 	/* directory */
 	dname = guc_malloc(ERROR, strlen(newval) + 1);		/* runtime dir */
 	sprintf(dname, "%s", newval);
 
-	/* global stats */
-	tname = guc_malloc(ERROR, strlen(newval) + 12);		/* /global.tmp */
-	sprintf(tname, "%s/global.tmp", newval);
-	fname = guc_malloc(ERROR, strlen(newval) + 13);		/* /global.stat */
-	sprintf(fname, "%s/global.stat", newval);
-
 	if (pgstat_stat_directory)
 		free(pgstat_stat_directory);
 	pgstat_stat_directory = dname;
-	if (pgstat_stat_tmpname)
-		free(pgstat_stat_tmpname);
-	pgstat_stat_tmpname = tname;
-	if (pgstat_stat_filename)
-		free(pgstat_stat_filename);
-	pgstat_stat_filename = fname;
 }
 
 static bool
@@ -20,6 +20,8 @@
 #include <sys/wait.h>
 #include <signal.h>
 #include <time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 
 #ifdef HAVE_LIBZ
 #include <zlib.h>
@@ -51,6 +53,21 @@ typedef struct TablespaceList
 	TablespaceListCell *tail;
 } TablespaceList;
 
+/*
+ * State of unpacking a tar stream into a directory
+ */
+typedef struct UnpackState
+{
+	int			rownum;			/* tablespace being received */
+	char		current_path[MAXPGPATH];	/* directory to unpack into */
+	char		filename[MAXPGPATH];	/* current (or last) member */
+	char		header[512];	/* tar header being received */
+	int			header_len;		/* bytes of it received so far */
+	FILE	   *file;			/* regular file being written, if any */
+	int			len_left;		/* bytes of the file still to come */
+	int			padding_left;	/* bytes of padding still to come */
+} UnpackState;
+
 /* Global options */
 static char *basedir = NULL;
 static TablespaceList tablespace_dirs = {NULL, NULL};
@@ -67,6 +84,16 @@ static bool writerecoveryconf = false;
 static int	standby_message_timeout = 10 * 1000;		/* 10 sec = default */
 static pg_time_t last_progress_report = 0;
 static int32 maxrate = 0;		/* no limit by default */
+static int	servercompresslevel = 0;
+static int	numjobs = 1;
+static bool incremental = false;
+static XLogRecPtr incremental_startptr = InvalidXLogRecPtr;
+
+/* Paths received in an incremental backup, see record_received_path */
+static char **received_paths = NULL;
+static int	nreceived = 0;
+static int	maxreceived = 0;
+static bool received_sorted = false;
 
 
 /* Progress counters */
@@ -102,6 +129,13 @@ static void progress_report(int tablespacenum, const char *filename, bool force)
 
 static void ReceiveTarFile(PGconn *conn, PGresult *res, int rownum);
 static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum);
+static void unpack_tar_data(UnpackState *state, char *buf, int len);
+static void unpack_tar_header(UnpackState *state);
+static void unpack_finish_file(UnpackState *state);
+static void apply_incremental_file(const char *incrpath);
+static void record_received_path(const char *path);
+static void remove_unreceived_files(const char *path, bool isbasedir);
+static void prepare_incremental_backup(void);
 static void GenerateRecoveryConf(PGconn *conn);
 static void WriteRecoveryConf(void);
 static void BaseBackup(void);
@@ -247,9 +281,14 @@ usage(void)
 	printf(_("      --xlogdir=XLOGDIR  location for the transaction log directory\n"));
 	printf(_("  -z, --gzip             compress tar output\n"));
 	printf(_("  -Z, --compress=0-9     compress tar output with given compression level\n"));
+	printf(_("      --server-compress=1-9\n"
+			 "                         have the server compress the data it sends\n"));
+	printf(_("      --incremental      update a plain backup in DIRECTORY, receiving only\n"
+			 "                         the blocks changed since it was taken\n"));
 	printf(_("\nGeneral options:\n"));
 	printf(_("  -c, --checkpoint=fast|spread\n"
 			 "                         set fast or spread checkpointing\n"));
+	printf(_("  -j, --jobs=NUM         use this many server processes to read files\n"));
 	printf(_("  -l, --label=LABEL      set backup label\n"));
 	printf(_("  -P, --progress         show progress information\n"));
 	printf(_("  -v, --verbose          output verbose messages\n"));
@@ -535,6 +574,82 @@ verify_dir_is_empty_or_create(char *dirname)
 }
 
 
+/*
+ * Check that the target directory of an incremental backup contains a
+ * backup, and find out where that backup started from its backup_label.
+ * Also remove the WAL the previous backup came with, as the new backup needs
+ * its own.
+ */
+static void
+prepare_incremental_backup(void)
+{
+	char		path[MAXPGPATH];
+	char		line[MAXPGPATH];
+	FILE	   *lf;
+	uint32		hi,
+				lo;
+	const char *xlogdirs[] = {"pg_xlog/archive_status", "pg_xlog"};
+	int			i;
+
+	snprintf(path, sizeof(path), "%s/backup_label", basedir);
+	lf = fopen(path, "r");
+	if (lf == NULL)
+	{
+		fprintf(stderr,
+				_("%s: directory \"%s\" does not contain a plain-format base backup: %s\n"),
+				progname, basedir, strerror(errno));
+		exit(1);
+	}
+	while (fgets(line, sizeof(line), lf) != NULL)
+	{
+		if (sscanf(line, "START WAL LOCATION: %X/%X", &hi, &lo) == 2)
+		{
+			incremental_startptr = ((uint64) hi) << 32 | lo;
+			break;
+		}
+	}
+	fclose(lf);
+
+	if (incremental_startptr == InvalidXLogRecPtr)
+	{
+		fprintf(stderr, _("%s: could not find start location in file \"%s\"\n"),
+				progname, path);
+		exit(1);
+	}
+
+	for (i = 0; i < lengthof(xlogdirs); i++)
+	{
+		DIR		   *dir;
+		struct dirent *de;
+
+		snprintf(path, sizeof(path), "%s/%s", basedir, xlogdirs[i]);
+		dir = opendir(path);
+		if (dir == NULL)
+			continue;
+		while ((de = readdir(dir)) != NULL)
+		{
+			char		fn[MAXPGPATH];
+			struct stat st;
+
+			if (snprintf(fn, sizeof(fn), "%s/%s", path, de->d_name) >=
+				sizeof(fn))
+			{
+				fprintf(stderr, _("%s: file name too long: \"%s/%s\"\n"),
+						progname, path, de->d_name);
+				exit(1);
+			}
+			if (lstat(fn, &st) == 0 && S_ISREG(st.st_mode) && unlink(fn) != 0)
+			{
+				fprintf(stderr, _("%s: could not remove file \"%s\": %s\n"),
+						progname, fn, strerror(errno));
+				exit(1);
+			}
+		}
+		closedir(dir);
+	}
+}
+
+
 /*
  * Print a progress report based on the global variables. If verbose output
  * is enabled, also print the current file name.
@@ -827,6 +942,12 @@ ReceiveTarFile(PGconn *conn, PGresult *res, int rownum)
 					disconnect_and_exit(1);
 				}
 			}
+			else if (servercompresslevel != 0)
+			{
+				/* The stream is compressed already, just write it out */
+				snprintf(filename, sizeof(filename), "%s/base.tar.gz", basedir);
+				tarfile = fopen(filename, "wb");
+			}
 			else
 #endif
 			{
@@ -855,6 +976,12 @@ ReceiveTarFile(PGconn *conn, PGresult *res, int rownum)
 				disconnect_and_exit(1);
 			}
 		}
+		else if (servercompresslevel != 0)
+		{
+			snprintf(filename, sizeof(filename), "%s/%s.tar.gz", basedir,
+					 PQgetvalue(res, rownum, 0));
+			tarfile = fopen(filename, "wb");
+		}
 		else
 #endif
 		{
@@ -879,7 +1006,10 @@ ReceiveTarFile(PGconn *conn, PGresult *res, int rownum)
 	else
 #endif
 	{
-		/* Either no zlib support, or zlib support but compresslevel = 0 */
+		/*
+		 * Either no zlib support, or zlib support but compresslevel = 0, or
+		 * the server compresses the stream
+		 */
 		if (!tarfile)
 		{
 			fprintf(stderr, _("%s: could not create file \"%s\": %s\n"),
@@ -924,6 +1054,33 @@ ReceiveTarFile(PGconn *conn, PGresult *res, int rownum)
 
 			MemSet(zerobuf, 0, sizeof(zerobuf));
 
+#ifdef HAVE_LIBZ
+
+			/*
+			 * If the server compressed the stream, it consists of gzip
+			 * members. Append the rest of the archive as one more. A
+			 * recovery.conf in it overrides one from the server when
+			 * extracting.
+			 */
+			if (servercompresslevel != 0)
+			{
+				if (fflush(tarfile) != 0)
+				{
+					fprintf(stderr, _("%s: could not write to file \"%s\": %s\n"),
+							progname, filename, strerror(errno));
+					disconnect_and_exit(1);
+				}
+				ztarfile = gzdopen(dup(fileno(tarfile)), "wb");
+				if (!ztarfile)
+				{
+					fprintf(stderr,
+							_("%s: could not create compressed file \"%s\": %s\n"),
+							progname, filename, get_gz_error(ztarfile));
+					disconnect_and_exit(1);
+				}
+			}
+#endif
+
 			if (basetablespace && writerecoveryconf)
 			{
 				char		header[512];
@@ -956,8 +1113,8 @@ ReceiveTarFile(PGconn *conn, PGresult *res, int rownum)
 					disconnect_and_exit(1);
 				}
 			}
-			else
 #endif
+			if (tarfile != NULL)
 			{
 				if (strcmp(basedir, "-") != 0)
 				{
@@ -980,12 +1137,12 @@ ReceiveTarFile(PGconn *conn, PGresult *res, int rownum)
 			disconnect_and_exit(1);
 		}
 
-		if (!writerecoveryconf || !basetablespace)
+		if (!writerecoveryconf || !basetablespace || servercompresslevel != 0)
 		{
 			/*
 			 * When not writing recovery.conf, or when not working on the base
 			 * tablespace, we never have to look for an existing recovery.conf
-			 * file in the stream.
+			 * file in the stream.  Nor can we, if the server compressed it.
 			 */
 			WRITE_TAR_DATA(copybuf, r);
 		}
@@ -1123,6 +1280,431 @@ get_tablespace_mapping(const char *dir)
 }
 
 
+/*
+ * Remember that 'path' was received in an incremental backup, so that it's
+ * not removed by remove_unreceived_files.
+ */
+static void
+record_received_path(const char *path)
+{
+	if (!incremental)
+		return;
+
+	if (nreceived >= maxreceived)
+	{
+		maxreceived = Max(maxreceived * 2, 1024);
+		received_paths = pg_realloc(received_paths,
+									maxreceived * sizeof(char *));
+	}
+	received_paths[nreceived++] = pg_strdup(path);
+	received_sorted = false;
+}
+
+static int
+compare_paths(const void *a, const void *b)
+{
+	return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+/*
+ * Remove the files and directories under 'path' that were not part of the
+ * incremental backup just received, because they were dropped since the
+ * backup it was based on.  pg_xlog in the data directory is left alone.
+ */
+static void
+remove_unreceived_files(const char *path, bool isbasedir)
+{
+	DIR		   *dir;
+	struct dirent *de;
+
+	if (!received_sorted)
+	{
+		qsort(received_paths, nreceived, sizeof(char *), compare_paths);
+		received_sorted = true;
+	}
+
+	dir = opendir(path);
+	if (dir == NULL)
+	{
+		fprintf(stderr, _("%s: could not open directory \"%s\": %s\n"),
+				progname, path, strerror(errno));
+		disconnect_and_exit(1);
+	}
+
+	while ((de = readdir(dir)) != NULL)
+	{
+		char		fn[MAXPGPATH];
+		char	   *key = fn;
+		bool		received;
+		struct stat st;
+
+		if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0)
+			continue;
+		if (isbasedir && strcmp(de->d_name, "pg_xlog") == 0)
+			continue;
+
+		snprintf(fn, sizeof(fn), "%s/%s", path, de->d_name);
+		if (lstat(fn, &st) != 0)
+		{
+			fprintf(stderr, _("%s: could not stat file \"%s\": %s\n"),
+					progname, fn, strerror(errno));
+			disconnect_and_exit(1);
+		}
+
+		received = bsearch(&key, received_paths, nreceived, sizeof(char *),
+						   compare_paths) != NULL;
+
+		if (S_ISDIR(st.st_mode))
+		{
+			remove_unreceived_files(fn, false);
+			if (!received)
+			{
+				if (verbose)
+					fprintf(stderr, _("%s: removing directory \"%s\"\n"),
+							progname, fn);
+				if (rmdir(fn) != 0)
+					fprintf(stderr, _("%s: could not remove directory \"%s\": %s\n"),
+							progname, fn, strerror(errno));
+			}
+		}
+		else if (S_ISREG(st.st_mode) && !received)
+		{
+			if (verbose)
+				fprintf(stderr, _("%s: removing file \"%s\"\n"),
+						progname, fn);
+			if (unlink(fn) != 0)
+			{
+				fprintf(stderr, _("%s: could not remove file \"%s\": %s\n"),
+						progname, fn, strerror(errno));
+				disconnect_and_exit(1);
+			}
+		}
+	}
+
+	closedir(dir);
+}
+
+/*
+ * Apply the changed blocks received in "<file>.incr" to "<file>", and remove
+ * the .incr file.  See sendFileIncremental in the server for the format.
+ */
+static void
+apply_incremental_file(const char *incrpath)
+{
+	char		target[MAXPGPATH];
+	FILE	   *in;
+	FILE	   *out;
+	uint32		hdr[3];
+	uint32		nblocks;
+	uint32		nchanged;
+	uint32	   *blknos;
+	char		page[BLCKSZ];
+	uint32		i;
+
+	strlcpy(target, incrpath, sizeof(target));
+	target[strlen(target) - strlen(".incr")] = '\0';
+
+	in = fopen(incrpath, "rb");
+	if (in == NULL)
+	{
+		fprintf(stderr, _("%s: could not open file \"%s\": %s\n"),
+				progname, incrpath, strerror(errno));
+		disconnect_and_exit(1);
+	}
+
+	if (fread(hdr, sizeof(hdr), 1, in) != 1 ||
+		ntohl(hdr[0]) != INCREMENTAL_FILE_MAGIC)
+	{
+		fprintf(stderr, _("%s: invalid incremental file \"%s\"\n"),
+				progname, incrpath);
+		disconnect_and_exit(1);
+	}
+	nblocks = ntohl(hdr[1]);
+	nchanged = ntohl(hdr[2]);
+
+	/*
+	 * The file is normally there already, from the backup we're based on.  If
+	 * it's new since then, all of its blocks have been sent.
+	 */
+	out = fopen(target, "r+b");
+	if (out == NULL && errno == ENOENT)
+		out = fopen(target, "w+b");
+	if (out == NULL)
+	{
+		fprintf(stderr, _("%s: could not open file \"%s\": %s\n"),
+				progname, target, strerror(errno));
+		disconnect_and_exit(1);
+	}
+
+	blknos = pg_malloc(Max(nchanged, 1) * sizeof(uint32));
+	if (nchanged > 0 && fread(blknos, sizeof(uint32), nchanged, in) != nchanged)
+	{
+		fprintf(stderr, _("%s: invalid incremental file \"%s\"\n"),
+				progname, incrpath);
+		disconnect_and_exit(1);
+	}
+
+	for (i = 0; i < nchanged; i++)
+	{
+		pgoff_t		offset = (pgoff_t) ntohl(blknos[i]) * BLCKSZ;
+
+		if (fread(page, BLCKSZ, 1, in) != 1)
+		{
+			fprintf(stderr, _("%s: invalid incremental file \"%s\"\n"),
+					progname, incrpath);
+			disconnect_and_exit(1);
+		}
+		if (fseeko(out, offset, SEEK_SET) != 0 ||
+			fwrite(page, BLCKSZ, 1, out) != 1)
+		{
+			fprintf(stderr, _("%s: could not write to file \"%s\": %s\n"),
+					progname, target, strerror(errno));
+			disconnect_and_exit(1);
+		}
+	}
+
+	/* The relation may have been truncated, or extended */
+	if (fflush(out) != 0 ||
+		ftruncate(fileno(out), (pgoff_t) nblocks * BLCKSZ) != 0)
+	{
+		fprintf(stderr, _("%s: could not truncate file \"%s\": %s\n"),
+				progname, target, strerror(errno));
+		disconnect_and_exit(1);
+	}
+
+	free(blknos);
+	fclose(out);
+	fclose(in);
+
+	if (unlink(incrpath) != 0)
+	{
+		fprintf(stderr, _("%s: could not remove file \"%s\": %s\n"),
+				progname, incrpath, strerror(errno));
+		disconnect_and_exit(1);
+	}
+
+	record_received_path(target);
+}
+
+/*
+ * We're done writing the current regular file.
+ */
+static void
+unpack_finish_file(UnpackState *state)
+{
+	fclose(state->file);
+	state->file = NULL;
+
+	if (incremental && pg_str_endswith(state->filename, ".incr"))
+		apply_incremental_file(state->filename);
+	else
+		record_received_path(state->filename);
+}
+
+/*
+ * Process a complete tar header: create the directory or symbolic link, or
+ * open the regular file whose contents follow.
+ */
+static void
+unpack_tar_header(UnpackState *state)
+{
+	char	   *header = state->header;
+	const char *mapped_tblspc_path;
+	int			filemode;
+
+	/* The server doesn't send end-of-archive blocks, but be tolerant */
+	if (header[0] == '\0')
+		return;
+
+	if (sscanf(header + 124, "%11o", &state->len_left) != 1)
+	{
+		fprintf(stderr, _("%s: could not parse file size\n"),
+				progname);
+		disconnect_and_exit(1);
+	}
+
+	/* Set permissions on the file */
+	if (sscanf(&header[100], "%07o ", &filemode) != 1)
+	{
+		fprintf(stderr, _("%s: could not parse file mode\n"),
+				progname);
+		disconnect_and_exit(1);
+	}
+
+	/*
+	 * All files are padded up to 512 bytes
+	 */
+	state->padding_left =
+		((state->len_left + 511) & ~511) - state->len_left;
+
+	/*
+	 * First part of header is zero terminated filename
+	 */
+	if (snprintf(state->filename, sizeof(state->filename), "%s/%s",
+				 state->current_path, header) >= sizeof(state->filename))
+	{
+		fprintf(stderr, _("%s: file name too long: \"%s/%s\"\n"),
+				progname, state->current_path, header);
+		disconnect_and_exit(1);
+	}
+	if (state->filename[strlen(state->filename) - 1] == '/')
+	{
+		char	   *filename = state->filename;
+
+		/*
+		 * Ends in a slash means directory or symlink to directory
+		 */
+		if (header[156] == '5')
+		{
+			/*
+			 * Directory
+			 */
+			filename[strlen(filename) - 1] = '\0';	/* Remove trailing slash */
+			if (mkdir(filename, S_IRWXU) != 0)
+			{
+				/*
+				 * When streaming WAL, pg_xlog will have been created by the
+				 * wal receiver process. Also, when transaction log directory
+				 * location was specified, pg_xlog has already been created as
+				 * a symbolic link before starting the actual backup. So just
+				 * ignore creation failures on related directories.  In an
+				 * incremental backup, the directories are there already.
+				 */
+				if (!((incremental ||
+					   pg_str_endswith(filename, "/pg_xlog") ||
+					   pg_str_endswith(filename, "/archive_status")) &&
+					  errno == EEXIST))
+				{
+					fprintf(stderr,
+							_("%s: could not create directory \"%s\": %s\n"),
+							progname, filename, strerror(errno));
+					disconnect_and_exit(1);
+				}
+			}
+#ifndef WIN32
+			if (chmod(filename, (mode_t) filemode))
+				fprintf(stderr,
+						_("%s: could not set permissions on directory \"%s\": %s\n"),
+						progname, filename, strerror(errno));
+#endif
+			record_received_path(filename);
+		}
+		else if (header[156] == '2')
+		{
+			/*
+			 * Symbolic link
+			 *
+			 * It's most likely a link in pg_tblspc directory, to the location
+			 * of a tablespace. Apply any tablespace mapping given on the
+			 * command line (--tablespace-mapping). (We blindly apply the
+			 * mapping without checking that the link really is inside
+			 * pg_tblspc. We don't expect there to be other symlinks in a data
+			 * directory, but if there are, you can call it an undocumented
+			 * feature that you can map them too.)
+			 */
+			filename[strlen(filename) - 1] = '\0';	/* Remove trailing slash */
+
+			mapped_tblspc_path = get_tablespace_mapping(&header[157]);
+			if (incremental)
+				unlink(filename);
+			if (symlink(mapped_tblspc_path, filename) != 0)
+			{
+				fprintf(stderr,
+						_("%s: could not create symbolic link from \"%s\" to \"%s\": %s\n"),
+						progname, filename, mapped_tblspc_path,
+						strerror(errno));
+				disconnect_and_exit(1);
+			}
+			record_received_path(filename);
+		}
+		else
+		{
+			fprintf(stderr,
+					_("%s: unrecognized link indicator \"%c\"\n"),
+					progname, header[156]);
+			disconnect_and_exit(1);
+		}
+		return;					/* directory or link handled */
+	}
+
+	/*
+	 * regular file
+	 */
+	state->file = fopen(state->filename, "wb");
+	if (!state->file)
+	{
+		fprintf(stderr, _("%s: could not create file \"%s\": %s\n"),
+				progname, state->filename, strerror(errno));
+		disconnect_and_exit(1);
+	}
+
+#ifndef WIN32
+	if (chmod(state->filename, (mode_t) filemode))
+		fprintf(stderr, _("%s: could not set permissions on file \"%s\": %s\n"),
+				progname, state->filename, strerror(errno));
+#endif
+
+	if (state->len_left == 0)
+		unpack_finish_file(state);
+}
+
+/*
+ * Unpack a piece of an uncompressed tar stream.  Headers, file contents and
+ * padding may be split across pieces arbitrarily.
+ */
+static void
+unpack_tar_data(UnpackState *state, char *buf, int len)
+{
+	while (len > 0)
+	{
+		int			n;
+
+		if (state->len_left > 0)
+		{
+			/*
+			 * Contents of the current regular file
+			 */
+			n = Min(len, state->len_left);
+			if (fwrite(buf, n, 1, state->file) != 1)
+			{
+				fprintf(stderr, _("%s: could not write to file \"%s\": %s\n"),
+						progname, state->filename, strerror(errno));
+				disconnect_and_exit(1);
+			}
+			state->len_left -= n;
+			if (state->len_left == 0)
+				unpack_finish_file(state);
+		}
+		else if (state->padding_left > 0)
+		{
+			/*
+			 * Padding after a file, ignore it
+			 */
+			n = Min(len, state->padding_left);
+			state->padding_left -= n;
+		}
+		else
+		{
+			/*
+			 * A tar header, possibly split
+			 */
+			n = Min(len, 512 - state->header_len);
+			memcpy(state->header + state->header_len, buf, n);
+			state->header_len += n;
+			if (state->header_len == 512)
+			{
+				state->header_len = 0;
+				unpack_tar_header(state);
+			}
+		}
+
+		buf += n;
+		len -= n;
+		totaldone += n;
+	}
+	progress_report(state->rownum, state->filename, false);
+}
+
 /*
  * Receive a tar format stream from the connection to the server, and unpack
  * the contents of it into a directory. Only files, directories and
@@ -1131,26 +1713,45 @@ get_tablespace_mapping(const char *dir)
  * If the data is for the main data directory, it will be restored in the
  * specified directory. If it's for another tablespace, it will be restored
  * in the original or mapped directory.
+ *
+ * If the server compresses the stream, it's decompressed here; it may consist
+ * of several gzip members.
  */
 static void
 ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
 {
-	char		current_path[MAXPGPATH];
-	char		filename[MAXPGPATH];
-	const char *mapped_tblspc_path;
-	int			current_len_left;
-	int			current_padding = 0;
+	UnpackState state;
 	bool		basetablespace;
 	char	   *copybuf = NULL;
-	FILE	   *file = NULL;
+
+#ifdef HAVE_LIBZ
+	z_stream	zstream;
+	char		zbuf[32768];
+
+	if (servercompresslevel != 0)
+	{
+		MemSet(&zstream, 0, sizeof(zstream));
+		/* 15 + 32 means a 32k window, and detect the gzip header */
+		if (inflateInit2(&zstream, 15 + 32) != Z_OK)
+		{
+			fprintf(stderr,
+					_("%s: could not initialize compression library\n"),
+					progname);
+			disconnect_and_exit(1);
+		}
+	}
+#endif
+
+	MemSet(&state, 0, sizeof(state));
+	state.rownum = rownum;
 
 	basetablespace = PQgetisnull(res, rownum, 0);
 	if (basetablespace)
-		strlcpy(current_path, basedir, sizeof(current_path));
+		strlcpy(state.current_path, basedir, sizeof(state.current_path));
 	else
-		strlcpy(current_path,
+		strlcpy(state.current_path,
 				get_tablespace_mapping(PQgetvalue(res, rownum, 1)),
-				sizeof(current_path));
+				sizeof(state.current_path));
 
 	/*
 	 * Get the COPY data
@@ -1180,9 +1781,6 @@ ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
 			/*
 			 * End of chunk
 			 */
-			if (file)
-				fclose(file);
-
 			break;
 		}
 		else if (r == -2)
@@ -1192,191 +1790,45 @@ ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
 			disconnect_and_exit(1);
 		}
 
-		if (file == NULL)
+#ifdef HAVE_LIBZ
+		if (servercompresslevel != 0)
 		{
-			int			filemode;
-
-			/*
-			 * No current file, so this must be the header for a new file
-			 */
-			if (r != 512)
-			{
-				fprintf(stderr, _("%s: invalid tar block header size: %d\n"),
-						progname, r);
-				disconnect_and_exit(1);
-			}
-			totaldone += 512;
-
-			if (sscanf(copybuf + 124, "%11o", &current_len_left) != 1)
-			{
-				fprintf(stderr, _("%s: could not parse file size\n"),
-						progname);
-				disconnect_and_exit(1);
-			}
-
-			/* Set permissions on the file */
-			if (sscanf(&copybuf[100], "%07o ", &filemode) != 1)
-			{
-				fprintf(stderr, _("%s: could not parse file mode\n"),
-						progname);
-				disconnect_and_exit(1);
-			}
-
-			/*
-			 * All files are padded up to 512 bytes
-			 */
-			current_padding =
-				((current_len_left + 511) & ~511) - current_len_left;
-
-			/*
-			 * First part of header is zero terminated filename
-			 */
-			snprintf(filename, sizeof(filename), "%s/%s", current_path,
-					 copybuf);
-			if (filename[strlen(filename) - 1] == '/')
+			zstream.next_in = (Bytef *) copybuf;
+			zstream.avail_in = r;
+			while (zstream.avail_in > 0)
 			{
-				/*
-				 * Ends in a slash means directory or symlink to directory
-				 */
-				if (copybuf[156] == '5')
-				{
-					/*
-					 * Directory
-					 */
-					filename[strlen(filename) - 1] = '\0';		/* Remove trailing slash */
-					if (mkdir(filename, S_IRWXU) != 0)
-					{
-						/*
-						 * When streaming WAL, pg_xlog will have been created
-						 * by the wal receiver process. Also, when transaction
-						 * log directory location was specified, pg_xlog has
-						 * already been created as a symbolic link before
-						 * starting the actual backup. So just ignore creation
-						 * failures on related directories.
-						 */
-						if (!((pg_str_endswith(filename, "/pg_xlog") ||
-							 pg_str_endswith(filename, "/archive_status")) &&
-							  errno == EEXIST))
-						{
-							fprintf(stderr,
-							_("%s: could not create directory \"%s\": %s\n"),
-									progname, filename, strerror(errno));
-							disconnect_and_exit(1);
-						}
-					}
-#ifndef WIN32
-					if (chmod(filename, (mode_t) filemode))
-						fprintf(stderr,
-								_("%s: could not set permissions on directory \"%s\": %s\n"),
-								progname, filename, strerror(errno));
-#endif
-				}
-				else if (copybuf[156] == '2')
-				{
-					/*
-					 * Symbolic link
-					 *
-					 * It's most likely a link in pg_tblspc directory, to the
-					 * location of a tablespace. Apply any tablespace mapping
-					 * given on the command line (--tablespace-mapping). (We
-					 * blindly apply the mapping without checking that the
-					 * link really is inside pg_tblspc. We don't expect there
-					 * to be other symlinks in a data directory, but if there
-					 * are, you can call it an undocumented feature that you
-					 * can map them too.)
-					 */
-					filename[strlen(filename) - 1] = '\0';		/* Remove trailing slash */
+				int			rc;
 
-					mapped_tblspc_path = get_tablespace_mapping(&copybuf[157]);
-					if (symlink(mapped_tblspc_path, filename) != 0)
-					{
-						fprintf(stderr,
-								_("%s: could not create symbolic link from \"%s\" to \"%s\": %s\n"),
-								progname, filename, mapped_tblspc_path,
-								strerror(errno));
-						disconnect_and_exit(1);
-					}
-				}
-				else
+				zstream.next_out = (Bytef *) zbuf;
+				zstream.avail_out = sizeof(zbuf);
+				rc = inflate(&zstream, Z_NO_FLUSH);
+				if (rc != Z_OK && rc != Z_STREAM_END)
 				{
 					fprintf(stderr,
-							_("%s: unrecognized link indicator \"%c\"\n"),
-							progname, copybuf[156]);
+							_("%s: could not decompress data: %s\n"),
+							progname, zstream.msg ? zstream.msg : "unknown error");
 					disconnect_and_exit(1);
 				}
-				continue;		/* directory or link handled */
-			}
+				unpack_tar_data(&state, zbuf, sizeof(zbuf) - zstream.avail_out);
 
-			/*
-			 * regular file
-			 */
-			file = fopen(filename, "wb");
-			if (!file)
-			{
-				fprintf(stderr, _("%s: could not create file \"%s\": %s\n"),
-						progname, filename, strerror(errno));
-				disconnect_and_exit(1);
+				/* Another gzip member may follow */
+				if (rc == Z_STREAM_END)
+					inflateReset(&zstream);
 			}
-
-#ifndef WIN32
-			if (chmod(filename, (mode_t) filemode))
-				fprintf(stderr, _("%s: could not set permissions on file \"%s\": %s\n"),
-						progname, filename, strerror(errno));
+			continue;
+		}
 #endif
 
-			if (current_len_left == 0)
-			{
-				/*
-				 * Done with this file, next one will be a new tar header
-				 */
-				fclose(file);
-				file = NULL;
-				continue;
-			}
-		}						/* new file */
-		else
-		{
-			/*
-			 * Continuing blocks in existing file
-			 */
-			if (current_len_left == 0 && r == current_padding)
-			{
-				/*
-				 * Received the padding block for this file, ignore it and
-				 * close the file, then move on to the next tar header.
-				 */
-				fclose(file);
-				file = NULL;
-				totaldone += r;
-				continue;
-			}
-
-			if (fwrite(copybuf, r, 1, file) != 1)
-			{
-				fprintf(stderr, _("%s: could not write to file \"%s\": %s\n"),
-						progname, filename, strerror(errno));
-				disconnect_and_exit(1);
-			}
-			totaldone += r;
-			progress_report(rownum, filename, false);
-
-			current_len_left -= r;
-			if (current_len_left == 0 && current_padding == 0)
-			{
-				/*
-				 * Received the last block, and there is no padding to be
-				 * expected. Close the file and move on to the next tar
-				 * header.
-				 */
-				fclose(file);
-				file = NULL;
-				continue;
-			}
-		}						/* continuing data in existing file */
+		unpack_tar_data(&state, copybuf, r);
 	}							/* loop over all data blocks */
-	progress_report(rownum, filename, true);
+	progress_report(rownum, state.filename, true);
+
+#ifdef HAVE_LIBZ
+	if (servercompresslevel != 0)
+		inflateEnd(&zstream);
+#endif
 
-	if (file != NULL)
+	if (state.file != NULL || state.header_len != 0)
 	{
 		fprintf(stderr,
 				_("%s: COPY stream ended before last file was finished\n"),
@@ -1389,6 +1841,9 @@ ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
 
 	if (basetablespace && writerecoveryconf)
 		WriteRecoveryConf();
+
+	if (incremental)
+		remove_unreceived_files(state.current_path, basetablespace);
 }
 
 /*
@@ -1577,6 +2032,8 @@ WriteRecoveryConf(void)
 	}
 
 	fclose(cf);
+
+	record_received_path(filename);
 }
 
 
@@ -1590,6 +2047,9 @@ BaseBackup(void)
 	char	   *basebkp;
 	char		escaped_label[MAXPGPATH];
 	char	   *maxrate_clause = NULL;
+	char	   *compression_clause = NULL;
+	char	   *parallel_clause = NULL;
+	char	   *incremental_clause = NULL;
 	int			i;
 	char		xlogstart[64];
 	char		xlogend[64];
@@ -1650,16 +2110,27 @@ BaseBackup(void)
 
 	if (maxrate > 0)
 		maxrate_clause = psprintf("MAX_RATE %u", maxrate);
+	if (servercompresslevel > 0)
+		compression_clause = psprintf("COMPRESSION %d", servercompresslevel);
+	if (numjobs > 1)
+		parallel_clause = psprintf("PARALLEL %d", numjobs);
+	if (incremental)
+		incremental_clause = psprintf("INCREMENTAL %X/%X",
+									  (uint32) (incremental_startptr >> 32),
+									  (uint32) incremental_startptr);
 
 	basebkp =
-		psprintf("BASE_BACKUP LABEL '%s' %s %s %s %s %s %s",
+		psprintf("BASE_BACKUP LABEL '%s' %s %s %s %s %s %s %s %s %s",
 				 escaped_label,
 				 showprogress ? "PROGRESS" : "",
 				 includewal && !streamwal ? "WAL" : "",
 				 fastcheckpoint ? "FAST" : "",
 				 includewal ? "NOWAIT" : "",
 				 maxrate_clause ? maxrate_clause : "",
-				 format == 't' ? "TABLESPACE_MAP" : "");
+				 format == 't' ? "TABLESPACE_MAP" : "",
+				 compression_clause ? compression_clause : "",
+				 parallel_clause ? parallel_clause : "",
+				 incremental_clause ? incremental_clause : "");
 
 	if (PQsendQuery(conn, basebkp) == 0)
 	{
@@ -1738,7 +2209,19 @@ BaseBackup(void)
 		{
 			char	   *path = (char *) get_tablespace_mapping(PQgetvalue(res, i, 1));
 
-			verify_dir_is_empty_or_create(path);
+			/* In an incremental backup, it holds the previous backup */
+			if (incremental)
+			{
+				if (pg_mkdir_p(path, S_IRWXU) == -1)
+				{
+					fprintf(stderr,
+							_("%s: could not create directory \"%s\": %s\n"),
+							progname, path, strerror(errno));
+					disconnect_and_exit(1);
+				}
+			}
+			else
+				verify_dir_is_empty_or_create(path);
 		}
 	}
 
@@ -1950,6 +2433,9 @@ main(int argc, char **argv)
 		{"verbose", no_argument, NULL, 'v'},
 		{"progress", no_argument, NULL, 'P'},
 		{"xlogdir", required_argument, NULL, 1},
+		{"server-compress", required_argument, NULL, 2},
+		{"incremental", no_argument, NULL, 3},
+		{"jobs", required_argument, NULL, 'j'},
 		{NULL, 0, NULL, 0}
 	};
 	int			c;
@@ -1974,7 +2460,7 @@ main(int argc, char **argv)
 		}
 	}
 
-	while ((c = getopt_long(argc, argv, "D:F:r:RT:xX:l:zZ:d:c:h:p:U:s:wWvP",
+	while ((c = getopt_long(argc, argv, "D:F:r:RT:xX:l:zZ:d:c:h:j:p:U:s:wWvP",
 							long_options, &option_index)) != -1)
 	{
 		switch (c)
@@ -2043,6 +2529,27 @@ main(int argc, char **argv)
 			case 1:
 				xlog_dir = pg_strdup(optarg);
 				break;
+			case 2:
+				servercompresslevel = atoi(optarg);
+				if (servercompresslevel <= 0 || servercompresslevel > 9)
+				{
+					fprintf(stderr, _("%s: invalid compression level \"%s\"\n"),
+							progname, optarg);
+					exit(1);
+				}
+				break;
+			case 3:
+				incremental = true;
+				break;
+			case 'j':
+				numjobs = atoi(optarg);
+				if (numjobs <= 0 || numjobs > MAX_PARALLEL_WORKERS)
+				{
+					fprintf(stderr, _("%s: invalid number of parallel jobs \"%s\"\n"),
+							progname, optarg);
+					exit(1);
+				}
+				break;
 			case 'l':
 				label = pg_strdup(optarg);
 				break;
@@ -2155,6 +2662,26 @@ main(int argc, char **argv)
 		exit(1);
 	}
 
+	if (compresslevel != 0 && servercompresslevel != 0)
+	{
+		fprintf(stderr,
+				_("%s: cannot specify both --compress and --server-compress\n"),
+				progname);
+		fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+				progname);
+		exit(1);
+	}
+
+	if (incremental && (format != 'p' || strcmp(xlog_dir, "") != 0))
+	{
+		fprintf(stderr,
+				_("%s: incremental backups can only be taken in plain mode, without --xlogdir\n"),
+				progname);
+		fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+				progname);
+		exit(1);
+	}
+
 	if (format != 'p' && streamwal)
 	{
 		fprintf(stderr,
@@ -2190,7 +2717,7 @@ main(int argc, char **argv)
 	}
 
 #ifndef HAVE_LIBZ
-	if (compresslevel != 0)
+	if (compresslevel != 0 || servercompresslevel != 0)
 	{
 		fprintf(stderr,
 				_("%s: this build does not support compression\n"),
@@ -2202,9 +2729,12 @@ main(int argc, char **argv)
 	/*
 	 * Verify that the target directory exists, or create it. For plaintext
 	 * backups, always require the directory. For tar backups, require it
-	 * unless we are writing to stdout.
+	 * unless we are writing to stdout. For incremental backups, the
+	 * directory must contain the backup to update.
 	 */
-	if (format == 'p' || strcmp(basedir, "-") != 0)
+	if (incremental)
+		prepare_incremental_backup();
+	else if (format == 'p' || strcmp(basedir, "-") != 0)
 		verify_dir_is_empty_or_create(basedir);
 
 	/* Create transaction log symlink, if required */
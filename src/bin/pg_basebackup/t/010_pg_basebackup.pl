@@ -2,7 +2,7 @@ use strict;
 use warnings;
 use Cwd;
 use TestLib;
-use Test::More tests => 35;
+use Test::More tests => 40;
 
 program_help_ok('pg_basebackup');
 program_version_ok('pg_basebackup');
@@ -49,6 +49,18 @@ command_ok([ 'pg_basebackup', '-D', "$tempdir/tarbackup", '-Ft' ],
 	'tar format');
 ok(-f "$tempdir/tarbackup/base.tar", 'backup tar was created');
 
+command_ok([ 'pg_basebackup', '-D', "$tempdir/backup_par", '-j', '3' ],
+	'pg_basebackup with workers');
+ok(-f "$tempdir/backup_par/PG_VERSION", 'backup with workers was created');
+
+psql 'postgres', 'CREATE TABLE test_incr AS SELECT generate_series(1, 1000) AS a;';
+command_ok([ 'pg_basebackup', '-D', "$tempdir/backup", '--incremental' ],
+	'incremental backup on top of earlier backup');
+ok(-f "$tempdir/backup/backup_label", 'incremental backup was applied');
+command_fails(
+	[ 'pg_basebackup', '-D', "$tempdir/tarbackup", '-Ft', '--incremental' ],
+	'incremental backup in tar format fails');
+
 my $superlongname = "superlongname_" . ("x" x 100);
 
 system_or_bail 'touch', "$tempdir/pgdata/$superlongname";
@@ -4540,6 +4540,8 @@ getTables(Archive *fout, DumpOptions *dopt, int *numTables)
 	int			i_checkoption;
 	int			i_toastreloptions;
 	int			i_reloftype;
+	int			i_partkeydef;
+	int			i_partbound;
 	int			i_relpages;
 
 	/* Make sure we are in proper schema */
@@ -4590,7 +4592,9 @@ getTables(Archive *fout, DumpOptions *dopt, int *numTables)
 						  "array_to_string(array_remove(array_remove(c.reloptions,'check_option=local'),'check_option=cascaded'), ', ') AS reloptions, "
 						  "CASE WHEN 'check_option=local' = ANY (c.reloptions) THEN 'LOCAL'::text "
 						  "WHEN 'check_option=cascaded' = ANY (c.reloptions) THEN 'CASCADED'::text ELSE NULL END AS checkoption, "
-						  "array_to_string(array(SELECT 'toast.' || x FROM unnest(tc.reloptions) x), ', ') AS toast_reloptions "
+						  "array_to_string(array(SELECT 'toast.' || x FROM unnest(tc.reloptions) x), ', ') AS toast_reloptions, "
+						  "pg_catalog.pg_get_partkeydef(c.oid) AS partkeydef, "
+						  "pg_catalog.pg_get_partition_bound(c.oid) AS partbound "
 						  "FROM pg_class c "
 						  "LEFT JOIN pg_depend d ON "
 						  "(c.relkind = '%c' AND "
@@ -5055,6 +5059,8 @@ getTables(Archive *fout, DumpOptions *dopt, int *numTables)
 	i_checkoption = PQfnumber(res, "checkoption");
 	i_toastreloptions = PQfnumber(res, "toast_reloptions");
 	i_reloftype = PQfnumber(res, "reloftype");
+	i_partkeydef = PQfnumber(res, "partkeydef");
+	i_partbound = PQfnumber(res, "partbound");
 
 	if (dopt->lockWaitTimeout && fout->remoteVersion >= 70300)
 	{
@@ -5103,6 +5109,14 @@ getTables(Archive *fout, DumpOptions *dopt, int *numTables)
 			tblinfo[i].reloftype = NULL;
 		else
 			tblinfo[i].reloftype = pg_strdup(PQgetvalue(res, i, i_reloftype));
+		if (i_partkeydef == -1 || PQgetisnull(res, i, i_partkeydef))
+			tblinfo[i].partkeydef = NULL;
+		else
+			tblinfo[i].partkeydef = pg_strdup(PQgetvalue(res, i, i_partkeydef));
+		if (i_partbound == -1 || PQgetisnull(res, i, i_partbound))
+			tblinfo[i].partbound = NULL;
+		else
+			tblinfo[i].partbound = pg_strdup(PQgetvalue(res, i, i_partbound));
 		tblinfo[i].ncheck = atoi(PQgetvalue(res, i, i_relchecks));
 		if (PQgetisnull(res, i, i_owning_tab))
 		{
@@ -7209,9 +7223,11 @@ getTableAttrs(Archive *fout, DumpOptions *dopt, TableInfo *tblinfo, int numTable
 				/*
 				 * An unvalidated constraint needs to be dumped separately, so
 				 * that potentially-violating existing data is loaded before
-				 * the constraint.
+				 * the constraint.  So does one defined on a partition, as
+				 * CREATE TABLE ... PARTITION OF can't list constraints.
 				 */
-				constrs[j].separate = !validated;
+				constrs[j].separate = !validated ||
+					(tbinfo->partbound != NULL && constrs[j].conislocal);
 
 				constrs[j].dobj.dump = tbinfo->dobj.dump;
 
@@ -7250,7 +7266,8 @@ getTableAttrs(Archive *fout, DumpOptions *dopt, TableInfo *tblinfo, int numTable
  * such a column it will mistakenly get pg_attribute.attislocal set to true.)
  * However, in binary_upgrade mode, we must print all such columns anyway and
  * fix the attislocal/attisdropped state later, so as to keep control of the
- * physical column order.
+ * physical column order.  A partition's columns are never printed, as
+ * CREATE TABLE ... PARTITION OF takes all of them from the parent.
  *
  * This function exists because there are scattered nonobvious places that
  * must be kept in sync with this decision.
@@ -7258,6 +7275,8 @@ getTableAttrs(Archive *fout, DumpOptions *dopt, TableInfo *tblinfo, int numTable
 bool
 shouldPrintColumn(DumpOptions *dopt, TableInfo *tbinfo, int colno)
 {
+	if (tbinfo->partbound)
+		return false;
 	if (dopt->binary_upgrade)
 		return true;
 	return (tbinfo->attislocal[colno] && !tbinfo->attisdropped[colno]);
@@ -13812,7 +13831,36 @@ dumpTableSchema(Archive *fout, DumpOptions *dopt, TableInfo *tbinfo)
 		if (tbinfo->reloftype && !dopt->binary_upgrade)
 			appendPQExpBuffer(q, " OF %s", tbinfo->reloftype);
 
-		if (tbinfo->relkind != RELKIND_MATVIEW)
+		if (tbinfo->partbound)
+		{
+			/*
+			 * A partition takes its columns from its parent, including in a
+			 * binary upgrade: partitions only have the parent's columns, in
+			 * the parent's order, unless some were dropped or added to the
+			 * partition alone, which can't be reproduced.  Constraints and
+			 * column properties of its own are dumped separately.
+			 */
+			TableInfo  *parentRel = parents[0];
+
+			for (j = 0; j < tbinfo->numatts; j++)
+			{
+				if (tbinfo->attisdropped[j] && dopt->binary_upgrade)
+					exit_horribly(NULL, "cannot upgrade partition \"%s\" with dropped columns\n",
+								  tbinfo->dobj.name);
+				if (tbinfo->attislocal[j] && !tbinfo->attisdropped[j])
+					exit_horribly(NULL, "cannot dump column \"%s\" of partition \"%s\", which is not inherited from its parent\n",
+								  tbinfo->attnames[j], tbinfo->dobj.name);
+			}
+
+			appendPQExpBufferStr(q, " PARTITION OF ");
+			if (parentRel->dobj.namespace != tbinfo->dobj.namespace)
+				appendPQExpBuffer(q, "%s.",
+								fmtId(parentRel->dobj.namespace->dobj.name));
+			appendPQExpBuffer(q, "%s\n%s",
+							  fmtId(parentRel->dobj.name),
+							  tbinfo->partbound);
+		}
+		else if (tbinfo->relkind != RELKIND_MATVIEW)
 		{
 			/* Dump the attributes */
 			actual_atts = 0;
@@ -13965,6 +14013,9 @@ dumpTableSchema(Archive *fout, DumpOptions *dopt, TableInfo *tbinfo)
 				appendPQExpBuffer(q, "\nSERVER %s", fmtId(srvname));
 		}
 
+		if (tbinfo->partkeydef)
+			appendPQExpBuffer(q, "\nPARTITION BY %s", tbinfo->partkeydef);
+
 		if ((tbinfo->reloptions && strlen(tbinfo->reloptions) > 0) ||
 		  (tbinfo->toast_reloptions && strlen(tbinfo->toast_reloptions) > 0))
 		{
@@ -14063,7 +14114,8 @@ dumpTableSchema(Archive *fout, DumpOptions *dopt, TableInfo *tbinfo)
 			{
 				ConstraintInfo *constr = &(tbinfo->checkexprs[k]);
 
-				if (constr->separate || constr->conislocal)
+				if (constr->separate || constr->conislocal ||
+					tbinfo->partbound)
 					continue;
 
 				appendPQExpBufferStr(q, "\n-- For binary upgrade, set up inherited constraint.\n");
@@ -14081,7 +14133,7 @@ dumpTableSchema(Archive *fout, DumpOptions *dopt, TableInfo *tbinfo)
 				appendPQExpBufferStr(q, "::pg_catalog.regclass;\n");
 			}
 
-			if (numParents > 0)
+			if (numParents > 0 && !tbinfo->partbound)
 			{
 				appendPQExpBufferStr(q, "\n-- For binary upgrade, set up inheritance this way.\n");
 				for (k = 0; k < numParents; k++)
@@ -219,6 +219,8 @@ typedef struct _tableInfo
 	uint32		toast_minmxid;	/* for restore toast min multi xid */
 	int			ncheck;			/* # of CHECK expressions */
 	char	   *reloftype;		/* underlying type for typed table */
+	char	   *partkeydef;		/* partition key, if partitioned table */
+	char	   *partbound;		/* FOR VALUES clause, if partition */
 	/* these two are set only if table is a sequence owned by a column: */
 	Oid			owning_tab;		/* OID of table owning sequence */
 	int			owning_col;		/* attr # of column owning sequence */
@@ -1175,7 +1175,8 @@ psql_completion(const char *text, int start, int end)
 			 pg_strcasecmp(prev_wd, "(") == 0)
 	{
 		static const char *const list_INDEXOPTIONS[] =
-		{"fillfactor", "fastupdate", "gin_pending_list_limit", NULL};
+		{"fillfactor", "fastupdate", "gin_pending_list_limit",
+		"deferred_cleanup", "autosummarize", NULL};
 
 		COMPLETE_WITH_LIST(list_INDEXOPTIONS);
 	}
@@ -323,12 +323,18 @@ typedef struct GinOptions
 	int32		vl_len_;		/* varlena header (do not touch directly!) */
 	bool		useFastUpdate;	/* use fast updates? */
 	int			pendingListCleanupSize; /* maximum size of pending list */
+	bool		deferredCleanup;	/* leave pending list cleanup to
+									 * autovacuum? */
 } GinOptions;
 
 #define GIN_DEFAULT_USE_FASTUPDATE	true
 #define GinGetUseFastUpdate(relation) \
 	((relation)->rd_options ? \
 	 ((GinOptions *) (relation)->rd_options)->useFastUpdate : GIN_DEFAULT_USE_FASTUPDATE)
+#define GIN_DEFAULT_DEFERRED_CLEANUP	false
+#define GinGetDeferredCleanup(relation) \
+	((relation)->rd_options ? \
+	 ((GinOptions *) (relation)->rd_options)->deferredCleanup : GIN_DEFAULT_DEFERRED_CLEANUP)
 #define GinGetPendingListCleanupSize(relation) \
 	((relation)->rd_options && \
 	 ((GinOptions *) (relation)->rd_options)->pendingListCleanupSize != -1 ? \
@@ -935,7 +941,7 @@ extern void ginHeapTupleFastCollect(GinState *ginstate,
 						GinTupleCollector *collector,
 						OffsetNumber attnum, Datum value, bool isNull,
 						ItemPointer ht_ctid);
-extern void ginInsertCleanup(GinState *ginstate,
+extern void ginInsertCleanup(GinState *ginstate, bool full_clean,
 				 bool vac_delay, IndexBulkDeleteResult *stats);
 
 /* ginpostinglist.c */
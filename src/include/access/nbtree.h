@@ -154,8 +154,65 @@ typedef struct BTMetaPageData
 	( (i1).ip_blkid.bi_hi == (i2).ip_blkid.bi_hi && \
 	  (i1).ip_blkid.bi_lo == (i2).ip_blkid.bi_lo && \
 	  (i1).ip_posid == (i2).ip_posid )
+
+/*
+ * Downlinks are compared by block number only: the offset part of a pivot
+ * tuple's t_tid may hold its number of attributes (see below).  Since each
+ * page has exactly one downlink, the block number is enough to identify it.
+ */
 #define BTEntrySame(i1, i2) \
-	BTTidSame((i1)->t_tid, (i2)->t_tid)
+	( ItemPointerGetBlockNumber(&(i1)->t_tid) == \
+	  ItemPointerGetBlockNumber(&(i2)->t_tid) )
+
+/*
+ *	Suffix truncation of pivot tuples.
+ *
+ *	When a leaf page is split, the new high key of the left page (and hence
+ *	the downlink inserted into the parent) need only contain enough leading
+ *	key attributes to distinguish the last item on the left page from the
+ *	first item on the right page.  Trailing attributes are cut off, and are
+ *	considered to be "minus infinity" by _bt_compare().  This makes pivot
+ *	tuples smaller, which increases the fan-out of internal pages.
+ *
+ *	A truncated tuple has INDEX_ALT_TID_MASK set in t_info, and keeps its
+ *	number of attributes in the offset number part of t_tid.  The block
+ *	number part is still available for use as a downlink.  Tuples without
+ *	the flag (including all leaf-level data items and any pivot tuple written
+ *	before truncation was introduced) contain all of the index's attributes.
+ */
+#define INDEX_ALT_TID_MASK			INDEX_AM_RESERVED_BIT
+#define BT_N_KEYS_OFFSET_MASK		0x0FFF
+
+#define BTreeTupleIsTruncated(itup) \
+	(((itup)->t_info & INDEX_ALT_TID_MASK) != 0)
+#define BTreeTupGetNAtts(itup, rel) \
+	( \
+		BTreeTupleIsTruncated(itup) ? \
+		( \
+			AssertMacro(ItemPointerGetOffsetNumber(&(itup)->t_tid) & BT_N_KEYS_OFFSET_MASK), \
+			ItemPointerGetOffsetNumber(&(itup)->t_tid) & BT_N_KEYS_OFFSET_MASK \
+		) \
+		: \
+		RelationGetNumberOfAttributes(rel) \
+	)
+#define BTreeTupSetNAtts(itup, n) \
+	do { \
+		(itup)->t_info |= INDEX_ALT_TID_MASK; \
+		ItemPointerSetOffsetNumber(&(itup)->t_tid, (n) & BT_N_KEYS_OFFSET_MASK); \
+	} while(0)
+
+/*
+ * Point a pivot tuple at a child page.  The offset part of a truncated
+ * tuple's t_tid is its attribute count and must be preserved; untruncated
+ * pivot tuples traditionally carry P_HIKEY there.
+ */
+#define BTreeInnerTupleSetDownLink(itup, blkno) \
+	do { \
+		if (BTreeTupleIsTruncated(itup)) \
+			ItemPointerSetBlockNumber(&(itup)->t_tid, (blkno)); \
+		else \
+			ItemPointerSet(&(itup)->t_tid, (blkno), P_HIKEY); \
+	} while(0)
 
 
 /*
@@ -275,9 +332,9 @@ typedef struct xl_btree_insert
  *
  * The left page's data portion contains the new item, if it's the _L variant.
  * (In the _R variants, the new item is one of the right page's tuples.)
- * If level > 0, an IndexTuple representing the HIKEY of the left page
- * follows.  We don't need this on leaf pages, because it's the same as the
- * leftmost key in the new right page.
+ * An IndexTuple representing the HIKEY of the left page follows.  On leaf
+ * pages it is a suffix-truncated copy of the leftmost key in the new right
+ * page, so it can't be reconstructed from the right page's contents.
  *
  * Backup Blk 1: new right page
  *
@@ -609,6 +666,15 @@ typedef struct BTScanOpaqueData
 	BTArrayKeyInfo *arrayKeys;	/* info about each equality-type array key */
 	MemoryContext arrayContext; /* scan-lifespan context for array data */
 
+	/* workspace for skip scan support (see _bt_preprocess_skip_keys) */
+	bool		skipScan;		/* skipping over leading-column values? */
+	ScanKey		skipKeyData;	/* leading-column key + copy of keyData */
+	bool		skipPrefixValid;	/* skipKeyData[0] holds a prefix value */
+	bool		markSkipValid;	/* markSkipPrefix is valid */
+	Datum		markSkipPrefix; /* prefix value at time of btmarkpos */
+	bool		markSkipIsNull; /* ... and whether it was NULL */
+	MemoryContext skipContext;	/* scan-lifespan context for skip data */
+
 	/* info about killed items if any (killedItems is NULL if never used) */
 	int		   *killedItems;	/* currPos.items indexes of killed items */
 	int			numKilled;		/* number of currently stored items */
@@ -711,6 +777,8 @@ extern int32 _bt_compare(Relation rel, int keysz, ScanKey scankey,
 			Page page, OffsetNumber offnum);
 extern bool _bt_first(IndexScanDesc scan, ScanDirection dir);
 extern bool _bt_next(IndexScanDesc scan, ScanDirection dir);
+extern bool _bt_skip_find_prefix(IndexScanDesc scan, ScanDirection dir,
+					 bool first, Datum *value, bool *isnull);
 extern Buffer _bt_get_endpoint(Relation rel, uint32 level, bool rightmost);
 
 /*
@@ -718,6 +786,9 @@ extern Buffer _bt_get_endpoint(Relation rel, uint32 level, bool rightmost);
  */
 extern ScanKey _bt_mkscankey(Relation rel, IndexTuple itup);
 extern ScanKey _bt_mkscankey_nodata(Relation rel);
+extern IndexTuple _bt_truncate(Relation rel, IndexTuple lastleft,
+			 IndexTuple firstright);
+extern IndexTuple _bt_nonkey_truncate(Relation rel, IndexTuple itup);
 extern void _bt_freeskey(ScanKey skey);
 extern void _bt_freestack(BTStack stack);
 extern void _bt_preprocess_array_keys(IndexScanDesc scan);
@@ -725,6 +796,11 @@ extern void _bt_start_array_keys(IndexScanDesc scan, ScanDirection dir);
 extern bool _bt_advance_array_keys(IndexScanDesc scan, ScanDirection dir);
 extern void _bt_mark_array_keys(IndexScanDesc scan);
 extern void _bt_restore_array_keys(IndexScanDesc scan);
+extern void _bt_preprocess_skip_keys(IndexScanDesc scan);
+extern bool _bt_start_skip_keys(IndexScanDesc scan, ScanDirection dir);
+extern bool _bt_advance_skip_keys(IndexScanDesc scan, ScanDirection dir);
+extern void _bt_mark_skip_keys(IndexScanDesc scan);
+extern void _bt_restore_skip_keys(IndexScanDesc scan);
 extern void _bt_preprocess_keys(IndexScanDesc scan);
 extern IndexTuple _bt_checkkeys(IndexScanDesc scan,
 			  Page page, OffsetNumber offnum,
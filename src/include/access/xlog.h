@@ -256,10 +256,12 @@ extern void GetFullPageWriteInfo(XLogRecPtr *RedoRecPtr_p, bool *doPageWrites_p)
 extern XLogRecPtr GetRedoRecPtr(void);
 extern XLogRecPtr GetInsertRecPtr(void);
 extern XLogRecPtr GetFlushRecPtr(void);
+extern Size WALReadFromBuffers(char *dstbuf, XLogRecPtr startptr, Size count);
 extern void GetNextXidAndEpoch(TransactionId *xid, uint32 *epoch);
 
 extern bool CheckPromoteSignal(void);
 extern void WakeupRecovery(void);
+extern void XLogRequestWalReceiverReply(void);
 extern void SetWalWriterSleeping(bool sleeping);
 
 extern void assign_max_wal_size(int newval, void *extra);
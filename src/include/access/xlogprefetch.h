@@ -0,0 +1,34 @@
+/*-------------------------------------------------------------------------
+ *
+ * xlogprefetch.h
+ *	  Prefetching of blocks referenced by WAL records during recovery
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/access/xlogprefetch.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef XLOGPREFETCH_H
+#define XLOGPREFETCH_H
+
+#include "access/xlogreader.h"
+#include "fmgr.h"
+
+/* GUC variable */
+extern int	recovery_prefetch_distance;
+
+typedef struct XLogPrefetcher XLogPrefetcher;
+
+extern Size XLogPrefetchShmemSize(void);
+extern void XLogPrefetchShmemInit(void);
+
+extern XLogPrefetcher *XLogPrefetcherAllocate(void);
+extern void XLogPrefetcherFree(XLogPrefetcher *prefetcher);
+extern void XLogPrefetcherReadAhead(XLogPrefetcher *prefetcher,
+						XLogReaderState *replay);
+
+extern Datum pg_stat_get_wal_prefetch(PG_FUNCTION_ARGS);
+
+#endif   /* XLOGPREFETCH_H */
@@ -17,6 +17,8 @@
 
 extern bool XLogHaveInvalidPages(void);
 extern void XLogCheckInvalidPages(void);
+extern void XLogNoteInvalidPage(RelFileNode node, ForkNumber forkno,
+					BlockNumber blkno, bool present);
 
 extern void XLogDropRelation(RelFileNode rnode, ForkNumber forknum);
 extern void XLogDropDatabase(Oid dbid);
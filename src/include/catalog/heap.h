@@ -119,6 +119,14 @@ extern void RemoveAttrDefault(Oid relid, AttrNumber attnum,
 				  DropBehavior behavior, bool complain, bool internal);
 extern void RemoveAttrDefaultById(Oid attrdefId);
 extern void RemoveStatistics(Oid relid, AttrNumber attnum);
+extern void RemoveStatisticsExt(Oid relid, AttrNumber attnum);
+
+extern void StorePartitionKey(Oid relid, char strategy, AttrNumber attnum,
+				  Oid opclass, Oid collation);
+extern void RemovePartitionKey(Oid relid);
+extern void StorePartitionBound(Oid relid, Oid parentId,
+					PartitionBoundSpec *bound);
+extern void RemovePartitionBound(Oid relid);
 
 extern Form_pg_attribute SystemAttributeDefinition(AttrNumber attno,
 						  bool relhasoids);
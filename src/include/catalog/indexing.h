@@ -316,6 +316,28 @@ DECLARE_UNIQUE_INDEX(pg_replication_origin_roiident_index, 6001, on pg_replicati
 DECLARE_UNIQUE_INDEX(pg_replication_origin_roname_index, 6002, on pg_replication_origin using btree(roname text_pattern_ops));
 #define ReplicationOriginNameIndex 6002
 
+DECLARE_UNIQUE_INDEX(pg_subscription_oid_index, 6101, on pg_subscription using btree(oid oid_ops));
+#define SubscriptionObjectIndexId 6101
+
+DECLARE_UNIQUE_INDEX(pg_subscription_subdbid_subname_index, 6102, on pg_subscription using btree(subdbid oid_ops, subname name_ops));
+#define SubscriptionNameIndexId 6102
+
+DECLARE_UNIQUE_INDEX(pg_partitioned_table_partrelid_index, 6112, on pg_partitioned_table using btree(partrelid oid_ops));
+#define PartitionedRelidIndexId 6112
+
+DECLARE_UNIQUE_INDEX(pg_partition_partrelid_index, 6114, on pg_partition using btree(partrelid oid_ops));
+#define PartitionRelidIndexId 6114
+
+DECLARE_INDEX(pg_partition_partparent_index, 6115, on pg_partition using btree(partparent oid_ops));
+#define PartitionParentIndexId 6115
+
+DECLARE_UNIQUE_INDEX(pg_statistic_ext_oid_index, 6119, on pg_statistic_ext using btree(oid oid_ops));
+#define StatisticExtOidIndexId	6119
+DECLARE_UNIQUE_INDEX(pg_statistic_ext_name_index, 6120, on pg_statistic_ext using btree(stxname name_ops, stxnamespace oid_ops));
+#define StatisticExtNameIndexId 6120
+DECLARE_INDEX(pg_statistic_ext_relid_index, 6121, on pg_statistic_ext using btree(stxrelid oid_ops));
+#define StatisticExtRelidIndexId 6121
+
 DECLARE_UNIQUE_INDEX(pg_tablesample_method_name_index, 3331, on pg_tablesample_method using btree(tsmname name_ops));
 #define TableSampleMethodNameIndexId  3331
 DECLARE_UNIQUE_INDEX(pg_tablesample_method_oid_index, 3332, on pg_tablesample_method using btree(oid oid_ops));
@@ -0,0 +1,95 @@
+/*-------------------------------------------------------------------------
+ *
+ * partition.h
+ *	  Header file for declarative partitioning related functions
+ *
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/catalog/partition.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include "access/skey.h"
+#include "fmgr.h"
+#include "nodes/bitmapset.h"
+#include "nodes/parsenodes.h"
+#include "utils/relcache.h"
+
+/*
+ * The partition key of a partitioned table, as cached in its relcache entry.
+ */
+typedef struct PartitionKeyData
+{
+	char		strategy;		/* PARTITION_STRATEGY_xxx */
+	AttrNumber	partattr;		/* key column */
+	Oid			parttype;		/* type of the key column */
+	int32		parttypmod;
+	int16		parttyplen;
+	bool		parttypbyval;
+	Oid			partopfamily;	/* btree operator family of the key */
+	Oid			partopcintype;	/* input type of the key's operator class */
+	Oid			partcollation;	/* collation of the key, or InvalidOid */
+	FmgrInfo	partcmp;		/* btree comparison support function */
+} PartitionKeyData;
+
+typedef PartitionKeyData *PartitionKey;
+
+/*
+ * The partitions of a partitioned table and their bounds, as cached in its
+ * relcache entry.
+ *
+ * Partitions are numbered in bound order: by lower bound for range
+ * partitioning, and by smallest accepted value for list partitioning.  The
+ * bound arrays are therefore sorted, and the partition that holds a given
+ * key value, or the partitions that can hold a range of them, are found by
+ * binary search.  Range partitions don't overlap, so their upper bounds are
+ * sorted as well; lower bounds are inclusive and upper bounds exclusive.
+ */
+typedef struct PartitionDescData
+{
+	int			nparts;			/* number of partitions */
+	Oid		   *oids;			/* partition OIDs, in bound order */
+
+	/* range partitioning: bounds of each partition */
+	Datum	   *lower;
+	bool	   *lower_unbounded;
+	Datum	   *upper;
+	bool	   *upper_unbounded;
+
+	/* list partitioning: all accepted values, sorted, and their partitions */
+	int			nvalues;
+	Datum	   *values;
+	int		   *valueparts;
+} PartitionDescData;
+
+typedef PartitionDescData *PartitionDesc;
+
+/*
+ * A restriction "key op value" on a partition key, where op is the member
+ * of the key's operator family with the given btree strategy and both input
+ * types equal to the operator class input type.
+ */
+typedef struct PartitionPruneClause
+{
+	StrategyNumber strategy;
+	Datum		value;
+} PartitionPruneClause;
+
+extern PartitionKey RelationGetPartitionKey(Relation rel);
+extern PartitionDesc RelationGetPartitionDesc(Relation rel);
+extern List *RelationGetPartitionQual(Relation rel);
+extern Oid	get_partition_parent(Oid relid);
+
+extern void check_new_partition_bound(const char *relname, Relation parent,
+						  PartitionBoundSpec *spec);
+extern int	get_partition_for_value(Relation rel, Datum value, bool isnull);
+extern Bitmapset *get_partitions_for_clauses(Relation rel,
+						   PartitionPruneClause *clauses, int nclauses);
+extern bool partition_bounds_equal(Relation rel1, Relation rel2);
+
+#endif   /* PARTITION_H */
@@ -1116,4 +1116,48 @@ DATA(insert (	4104	603  603 12 s	  2572	  3580 0 ));
 /* we could, but choose not to, supply entries for strategies 13 and 14 */
 DATA(insert (	4104	603  600  7 s	   433	  3580 0 ));
 
+/*
+ * BRIN bloom opfamilies
+ */
+DATA(insert (	3316	 23   23 1 s		96	  3580 0 ));
+DATA(insert (	3317	 20   20 1 s	   410	  3580 0 ));
+DATA(insert (	3318	 25   25 1 s		98	  3580 0 ));
+DATA(insert (	3319   1114 1114 1 s	  2060	  3580 0 ));
+DATA(insert (	3320   1184 1184 1 s	  1320	  3580 0 ));
+DATA(insert (	3321   2950 2950 1 s	  2972	  3580 0 ));
+
+/*
+ * BRIN minmax multi opfamilies
+ */
+DATA(insert (	3322	  23   23 1 s	    97	  3580 0 ));
+DATA(insert (	3322	  23   23 2 s	   523	  3580 0 ));
+DATA(insert (	3322	  23   23 3 s	    96	  3580 0 ));
+DATA(insert (	3322	  23   23 4 s	   525	  3580 0 ));
+DATA(insert (	3322	  23   23 5 s	   521	  3580 0 ));
+DATA(insert (	3323	  20   20 1 s	   412	  3580 0 ));
+DATA(insert (	3323	  20   20 2 s	   414	  3580 0 ));
+DATA(insert (	3323	  20   20 3 s	   410	  3580 0 ));
+DATA(insert (	3323	  20   20 4 s	   415	  3580 0 ));
+DATA(insert (	3323	  20   20 5 s	   413	  3580 0 ));
+DATA(insert (	3324	 701  701 1 s	   672	  3580 0 ));
+DATA(insert (	3324	 701  701 2 s	   673	  3580 0 ));
+DATA(insert (	3324	 701  701 3 s	   670	  3580 0 ));
+DATA(insert (	3324	 701  701 4 s	   675	  3580 0 ));
+DATA(insert (	3324	 701  701 5 s	   674	  3580 0 ));
+DATA(insert (	3325	1082 1082 1 s	  1095	  3580 0 ));
+DATA(insert (	3325	1082 1082 2 s	  1096	  3580 0 ));
+DATA(insert (	3325	1082 1082 3 s	  1093	  3580 0 ));
+DATA(insert (	3325	1082 1082 4 s	  1098	  3580 0 ));
+DATA(insert (	3325	1082 1082 5 s	  1097	  3580 0 ));
+DATA(insert (	3326	1114 1114 1 s	  2062	  3580 0 ));
+DATA(insert (	3326	1114 1114 2 s	  2063	  3580 0 ));
+DATA(insert (	3326	1114 1114 3 s	  2060	  3580 0 ));
+DATA(insert (	3326	1114 1114 4 s	  2065	  3580 0 ));
+DATA(insert (	3326	1114 1114 5 s	  2064	  3580 0 ));
+DATA(insert (	3327	1184 1184 1 s	  1322	  3580 0 ));
+DATA(insert (	3327	1184 1184 2 s	  1323	  3580 0 ));
+DATA(insert (	3327	1184 1184 3 s	  1320	  3580 0 ));
+DATA(insert (	3327	1184 1184 4 s	  1325	  3580 0 ));
+DATA(insert (	3327	1184 1184 5 s	  1324	  3580 0 ));
+
 #endif   /* PG_AMOP_H */
@@ -660,4 +660,67 @@ DATA(insert (	4104   603	 603  4  4108 ));
 DATA(insert (	4104   603	 603  11 4067 ));
 DATA(insert (	4104   603	 603  13  187 ));
 
+/* bloom */
+DATA(insert (	3316    23    23  1  3296 ));
+DATA(insert (	3316    23    23  2  3297 ));
+DATA(insert (	3316    23    23  3  3298 ));
+DATA(insert (	3316    23    23  4  3299 ));
+DATA(insert (	3316    23    23  15  450 ));
+DATA(insert (	3317    20    20  1  3296 ));
+DATA(insert (	3317    20    20  2  3297 ));
+DATA(insert (	3317    20    20  3  3298 ));
+DATA(insert (	3317    20    20  4  3299 ));
+DATA(insert (	3317    20    20  15  949 ));
+DATA(insert (	3318    25    25  1  3296 ));
+DATA(insert (	3318    25    25  2  3297 ));
+DATA(insert (	3318    25    25  3  3298 ));
+DATA(insert (	3318    25    25  4  3299 ));
+DATA(insert (	3318    25    25  15  400 ));
+DATA(insert (	3319  1114  1114  1  3296 ));
+DATA(insert (	3319  1114  1114  2  3297 ));
+DATA(insert (	3319  1114  1114  3  3298 ));
+DATA(insert (	3319  1114  1114  4  3299 ));
+DATA(insert (	3319  1114  1114  15 2039 ));
+DATA(insert (	3320  1184  1184  1  3296 ));
+DATA(insert (	3320  1184  1184  2  3297 ));
+DATA(insert (	3320  1184  1184  3  3298 ));
+DATA(insert (	3320  1184  1184  4  3299 ));
+DATA(insert (	3320  1184  1184  15 2039 ));
+DATA(insert (	3321  2950  2950  1  3296 ));
+DATA(insert (	3321  2950  2950  2  3297 ));
+DATA(insert (	3321  2950  2950  3  3298 ));
+DATA(insert (	3321  2950  2950  4  3299 ));
+DATA(insert (	3321  2950  2950  15 2963 ));
+/* minmax multi */
+DATA(insert (	3322    23    23  1  3300 ));
+DATA(insert (	3322    23    23  2  3307 ));
+DATA(insert (	3322    23    23  3  3308 ));
+DATA(insert (	3322    23    23  4  3309 ));
+DATA(insert (	3322    23    23  11 3310 ));
+DATA(insert (	3323    20    20  1  3300 ));
+DATA(insert (	3323    20    20  2  3307 ));
+DATA(insert (	3323    20    20  3  3308 ));
+DATA(insert (	3323    20    20  4  3309 ));
+DATA(insert (	3323    20    20  11 3311 ));
+DATA(insert (	3324   701   701  1  3300 ));
+DATA(insert (	3324   701   701  2  3307 ));
+DATA(insert (	3324   701   701  3  3308 ));
+DATA(insert (	3324   701   701  4  3309 ));
+DATA(insert (	3324   701   701  11 3312 ));
+DATA(insert (	3325  1082  1082  1  3300 ));
+DATA(insert (	3325  1082  1082  2  3307 ));
+DATA(insert (	3325  1082  1082  3  3308 ));
+DATA(insert (	3325  1082  1082  4  3309 ));
+DATA(insert (	3325  1082  1082  11 3313 ));
+DATA(insert (	3326  1114  1114  1  3300 ));
+DATA(insert (	3326  1114  1114  2  3307 ));
+DATA(insert (	3326  1114  1114  3  3308 ));
+DATA(insert (	3326  1114  1114  4  3309 ));
+DATA(insert (	3326  1114  1114  11 3314 ));
+DATA(insert (	3327  1184  1184  1  3300 ));
+DATA(insert (	3327  1184  1184  2  3307 ));
+DATA(insert (	3327  1184  1184  3  3308 ));
+DATA(insert (	3327  1184  1184  4  3309 ));
+DATA(insert (	3327  1184  1184  11 3315 ));
+
 #endif   /* PG_AMPROC_H */
@@ -182,5 +182,17 @@ DATA(insert OID = 4081 (	3580	uuid_minmax_ops			PGNSP PGUID ));
 DATA(insert OID = 4103 (	3580	range_inclusion_ops		PGNSP PGUID ));
 DATA(insert OID = 4082 (	3580	pg_lsn_minmax_ops		PGNSP PGUID ));
 DATA(insert OID = 4104 (	3580	box_inclusion_ops		PGNSP PGUID ));
+DATA(insert OID = 3316 (	3580	int4_bloom_ops			PGNSP PGUID ));
+DATA(insert OID = 3317 (	3580	int8_bloom_ops			PGNSP PGUID ));
+DATA(insert OID = 3318 (	3580	text_bloom_ops			PGNSP PGUID ));
+DATA(insert OID = 3319 (	3580	timestamp_bloom_ops		PGNSP PGUID ));
+DATA(insert OID = 3320 (	3580	timestamptz_bloom_ops	PGNSP PGUID ));
+DATA(insert OID = 3321 (	3580	uuid_bloom_ops			PGNSP PGUID ));
+DATA(insert OID = 3322 (	3580	int4_minmax_multi_ops	PGNSP PGUID ));
+DATA(insert OID = 3323 (	3580	int8_minmax_multi_ops	PGNSP PGUID ));
+DATA(insert OID = 3324 (	3580	float8_minmax_multi_ops PGNSP PGUID ));
+DATA(insert OID = 3325 (	3580	date_minmax_multi_ops	PGNSP PGUID ));
+DATA(insert OID = 3326 (	3580	timestamp_minmax_multi_ops	PGNSP PGUID ));
+DATA(insert OID = 3327 (	3580	timestamptz_minmax_multi_ops	PGNSP PGUID ));
 
 #endif   /* PG_OPFAMILY_H */
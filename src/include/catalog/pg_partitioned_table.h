@@ -0,0 +1,63 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_partitioned_table.h
+ *	  definition of the system "partitioned table" relation
+ *	  (pg_partitioned_table)
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/catalog/pg_partitioned_table.h
+ *
+ * NOTES
+ *	  the genbki.pl script reads this file and generates .bki
+ *	  information from the DATA() statements.
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef PG_PARTITIONED_TABLE_H
+#define PG_PARTITIONED_TABLE_H
+
+#include "catalog/genbki.h"
+
+/* ----------------
+ *		pg_partitioned_table definition.  cpp turns this into
+ *		typedef struct FormData_pg_partitioned_table
+ * ----------------
+ */
+#define PartitionedRelationId 6111
+
+CATALOG(pg_partitioned_table,6111) BKI_WITHOUT_OIDS
+{
+	Oid			partrelid;		/* OID of partitioned table */
+	char		partstrat;		/* partitioning strategy, see
+								 * PARTITION_STRATEGY_xxx in parsenodes.h */
+	int16		partattnum;		/* partition key column */
+	Oid			partopclass;	/* btree operator class of the key */
+	Oid			partcollation;	/* collation of the key, or InvalidOid */
+} FormData_pg_partitioned_table;
+
+/* ----------------
+ *		Form_pg_partitioned_table corresponds to a pointer to a tuple with
+ *		the format of pg_partitioned_table relation.
+ * ----------------
+ */
+typedef FormData_pg_partitioned_table *Form_pg_partitioned_table;
+
+/* ----------------
+ *		compiler constants for pg_partitioned_table
+ * ----------------
+ */
+#define Natts_pg_partitioned_table				5
+#define Anum_pg_partitioned_table_partrelid		1
+#define Anum_pg_partitioned_table_partstrat		2
+#define Anum_pg_partitioned_table_partattnum	3
+#define Anum_pg_partitioned_table_partopclass	4
+#define Anum_pg_partitioned_table_partcollation 5
+
+/* ----------------
+ *		pg_partitioned_table has no initial contents
+ * ----------------
+ */
+
+#endif   /* PG_PARTITIONED_TABLE_H */
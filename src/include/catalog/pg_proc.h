@@ -604,6 +604,8 @@ DATA(insert OID = 3801 (  brinoptions		   PGNSP PGUID 12 1 0 0 0 f f f f t f s 2
 DESCR("brin(internal)");
 DATA(insert OID = 3952 (  brin_summarize_new_values PGNSP PGUID 12 1 0 0 0 f f f f f f v 1 0 23 "2205" _null_ _null_ _null_ _null_ _null_ brin_summarize_new_values _null_ _null_ _null_ ));
 DESCR("brin: standalone scan new table pages");
+DATA(insert OID = 3295 (  brin_summarize_range PGNSP PGUID 12 1 0 0 0 f f f f t f v 2 0 23 "2205 20" _null_ _null_ _null_ _null_ _null_ brin_summarize_range _null_ _null_ _null_ ));
+DESCR("brin: standalone scan new table pages");
 
 DATA(insert OID = 339 (  poly_same		   PGNSP PGUID 12 1 0 0 0 f f f f t f i 2 0 16 "604 604" _null_ _null_ _null_ _null_ _null_ poly_same _null_ _null_ _null_ ));
 DATA(insert OID = 340 (  poly_contain	   PGNSP PGUID 12 1 0 0 0 f f f f t f i 2 0 16 "604 604" _null_ _null_ _null_ _null_ _null_ poly_contain _null_ _null_ _null_ ));
@@ -2042,6 +2044,10 @@ DATA(insert OID = 1662 (  pg_get_triggerdef    PGNSP PGUID 12 1 0 0 0 f f f f t
 DESCR("trigger description");
 DATA(insert OID = 1387 (  pg_get_constraintdef PGNSP PGUID 12 1 0 0 0 f f f f t f s 1 0 25 "26" _null_ _null_ _null_ _null_ _null_ pg_get_constraintdef _null_ _null_ _null_ ));
 DESCR("constraint description");
+DATA(insert OID = 6125 (  pg_get_partkeydef	PGNSP PGUID 12 1 0 0 0 f f f f t f s 1 0 25 "26" _null_ _null_ _null_ _null_ _null_ pg_get_partkeydef _null_ _null_ _null_ ));
+DESCR("partition key description");
+DATA(insert OID = 6126 (  pg_get_partition_bound	PGNSP PGUID 12 1 0 0 0 f f f f t f s 1 0 25 "26" _null_ _null_ _null_ _null_ _null_ pg_get_partition_bound _null_ _null_ _null_ ));
+DESCR("partition bound description");
 DATA(insert OID = 1716 (  pg_get_expr		   PGNSP PGUID 12 1 0 0 0 f f f f t f s 2 0 25 "194 26" _null_ _null_ _null_ _null_ _null_ pg_get_expr _null_ _null_ _null_ ));
 DESCR("deparse an encoded expression");
 DATA(insert OID = 1665 (  pg_get_serial_sequence	PGNSP PGUID 12 1 0 0 0 f f f f t f s 2 0 25 "25 25" _null_ _null_ _null_ _null_ _null_ pg_get_serial_sequence _null_ _null_ _null_ ));
@@ -2849,6 +2855,8 @@ DATA(insert OID = 2845 (  pg_stat_get_db_blk_write_time PGNSP PGUID 12 1 0 0 0 f
 DESCR("statistics: block write time, in msec");
 DATA(insert OID = 3195 (  pg_stat_get_archiver		PGNSP PGUID 12 1 0 0 0 f f f f f f s 0 0 2249 "" "{20,25,1184,20,25,1184,1184}" "{o,o,o,o,o,o,o}" "{archived_count,last_archived_wal,last_archived_time,failed_count,last_failed_wal,last_failed_time,stats_reset}" _null_ _null_ pg_stat_get_archiver _null_ _null_ _null_ ));
 DESCR("statistics: information about WAL archiver");
+DATA(insert OID = 3347 (  pg_stat_get_wal_prefetch	PGNSP PGUID 12 1 0 0 0 f f f f f f v 0 0 2249 "" "{20,20,20,20,20,20,701,23}" "{o,o,o,o,o,o,o,o}" "{prefetch,hit,skip_init,skip_new,skip_fpw,skip_rep,hit_ratio,distance}" _null_ _null_ pg_stat_get_wal_prefetch _null_ _null_ _null_ ));
+DESCR("statistics: information about WAL prefetching during recovery");
 DATA(insert OID = 2769 ( pg_stat_get_bgwriter_timed_checkpoints PGNSP PGUID 12 1 0 0 0 f f f f t f s 0 0 20 "" _null_ _null_ _null_ _null_ _null_ pg_stat_get_bgwriter_timed_checkpoints _null_ _null_ _null_ ));
 DESCR("statistics: number of timed checkpoints started by the bgwriter");
 DATA(insert OID = 2770 ( pg_stat_get_bgwriter_requested_checkpoints PGNSP PGUID 12 1 0 0 0 f f f f t f s 0 0 20 "" _null_ _null_ _null_ _null_ _null_ pg_stat_get_bgwriter_requested_checkpoints _null_ _null_ _null_ ));
@@ -4197,6 +4205,8 @@ DATA(insert OID = 2741 (  gincostestimate  PGNSP PGUID 12 1 0 0 0 f f f f t f v
 DESCR("gin(internal)");
 DATA(insert OID = 2788 (  ginoptions	   PGNSP PGUID 12 1 0 0 0 f f f f t f s 2 0 17 "1009 16" _null_ _null_ _null_ _null_  _null_ ginoptions _null_ _null_ _null_ ));
 DESCR("gin(internal)");
+DATA(insert OID = 3294 (  gin_clean_pending_list PGNSP PGUID 12 1 0 0 0 f f f f t f v 1 0 20 "2205" _null_ _null_ _null_ _null_ _null_ gin_clean_pending_list _null_ _null_ _null_ ));
+DESCR("clean up GIN pending list");
 
 /* GIN array support */
 DATA(insert OID = 2743 (  ginarrayextract	 PGNSP PGUID 12 1 0 0 0 f f f f t f i 3 0 2281 "2277 2281 2281" _null_ _null_ _null_ _null_ _null_ ginarrayextract _null_ _null_ _null_ ));
@@ -4235,6 +4245,38 @@ DESCR("BRIN inclusion support");
 DATA(insert OID = 4108 ( brin_inclusion_union	PGNSP PGUID 12 1 0 0 0 f f f f t f i 3 0 16 "2281 2281 2281" _null_ _null_ _null_ _null_ _null_ brin_inclusion_union _null_ _null_ _null_ ));
 DESCR("BRIN inclusion support");
 
+/* BRIN minmax multi */
+DATA(insert OID = 3300 ( brin_minmax_multi_opcinfo PGNSP PGUID 12 1 0 0 0 f f f f t f i 1 0 2281 "2281" _null_ _null_ _null_ _null_ _null_ brin_minmax_multi_opcinfo _null_ _null_ _null_ ));
+DESCR("BRIN multi minmax support");
+DATA(insert OID = 3307 ( brin_minmax_multi_add_value PGNSP PGUID 12 1 0 0 0 f f f f t f i 4 0 16 "2281 2281 2281 2281" _null_ _null_ _null_ _null_ _null_ brin_minmax_multi_add_value _null_ _null_ _null_ ));
+DESCR("BRIN multi minmax support");
+DATA(insert OID = 3308 ( brin_minmax_multi_consistent PGNSP PGUID 12 1 0 0 0 f f f f t f i 3 0 16 "2281 2281 2281" _null_ _null_ _null_ _null_ _null_ brin_minmax_multi_consistent _null_ _null_ _null_ ));
+DESCR("BRIN multi minmax support");
+DATA(insert OID = 3309 ( brin_minmax_multi_union PGNSP PGUID 12 1 0 0 0 f f f f t f i 3 0 16 "2281 2281 2281" _null_ _null_ _null_ _null_ _null_ brin_minmax_multi_union _null_ _null_ _null_ ));
+DESCR("BRIN multi minmax support");
+DATA(insert OID = 3310 ( brin_minmax_multi_distance_int4 PGNSP PGUID 12 1 0 0 0 f f f f t f i 2 0 701 "23 23" _null_ _null_ _null_ _null_ _null_ brin_minmax_multi_distance_int4 _null_ _null_ _null_ ));
+DESCR("BRIN multi minmax int4 distance");
+DATA(insert OID = 3311 ( brin_minmax_multi_distance_int8 PGNSP PGUID 12 1 0 0 0 f f f f t f i 2 0 701 "20 20" _null_ _null_ _null_ _null_ _null_ brin_minmax_multi_distance_int8 _null_ _null_ _null_ ));
+DESCR("BRIN multi minmax int8 distance");
+DATA(insert OID = 3312 ( brin_minmax_multi_distance_float8 PGNSP PGUID 12 1 0 0 0 f f f f t f i 2 0 701 "701 701" _null_ _null_ _null_ _null_ _null_ brin_minmax_multi_distance_float8 _null_ _null_ _null_ ));
+DESCR("BRIN multi minmax float8 distance");
+DATA(insert OID = 3313 ( brin_minmax_multi_distance_date PGNSP PGUID 12 1 0 0 0 f f f f t f i 2 0 701 "1082 1082" _null_ _null_ _null_ _null_ _null_ brin_minmax_multi_distance_date _null_ _null_ _null_ ));
+DESCR("BRIN multi minmax date distance");
+DATA(insert OID = 3314 ( brin_minmax_multi_distance_timestamp PGNSP PGUID 12 1 0 0 0 f f f f t f i 2 0 701 "1114 1114" _null_ _null_ _null_ _null_ _null_ brin_minmax_multi_distance_timestamp _null_ _null_ _null_ ));
+DESCR("BRIN multi minmax timestamp distance");
+DATA(insert OID = 3315 ( brin_minmax_multi_distance_timestamptz PGNSP PGUID 12 1 0 0 0 f f f f t f i 2 0 701 "1184 1184" _null_ _null_ _null_ _null_ _null_ brin_minmax_multi_distance_timestamptz _null_ _null_ _null_ ));
+DESCR("BRIN multi minmax timestamp with time zone distance");
+
+/* BRIN bloom */
+DATA(insert OID = 3296 ( brin_bloom_opcinfo		PGNSP PGUID 12 1 0 0 0 f f f f t f i 1 0 2281 "2281" _null_ _null_ _null_ _null_ _null_ brin_bloom_opcinfo _null_ _null_ _null_ ));
+DESCR("BRIN bloom support");
+DATA(insert OID = 3297 ( brin_bloom_add_value	PGNSP PGUID 12 1 0 0 0 f f f f t f i 4 0 16 "2281 2281 2281 2281" _null_ _null_ _null_ _null_ _null_ brin_bloom_add_value _null_ _null_ _null_ ));
+DESCR("BRIN bloom support");
+DATA(insert OID = 3298 ( brin_bloom_consistent	PGNSP PGUID 12 1 0 0 0 f f f f t f i 3 0 16 "2281 2281 2281" _null_ _null_ _null_ _null_ _null_ brin_bloom_consistent _null_ _null_ _null_ ));
+DESCR("BRIN bloom support");
+DATA(insert OID = 3299 ( brin_bloom_union		PGNSP PGUID 12 1 0 0 0 f f f f t f i 3 0 16 "2281 2281 2281" _null_ _null_ _null_ _null_ _null_ brin_bloom_union _null_ _null_ _null_ ));
+DESCR("BRIN bloom support");
+
 /* userlock replacements */
 DATA(insert OID = 2880 (  pg_advisory_lock				PGNSP PGUID 12 1 0 0 0 f f f f t f v 1 0 2278 "20" _null_ _null_ _null_ _null_ _null_ pg_advisory_lock_int8 _null_ _null_ _null_ ));
 DESCR("obtain exclusive advisory lock");
@@ -5307,6 +5349,26 @@ DESCR("get an individual replication origin's replication progress");
 DATA(insert OID = 6014 ( pg_show_replication_origin_status PGNSP PGUID 12 1 100 0 0 f f f f f t v 0 0 2249 "" "{26,25,3220,3220}" "{o,o,o,o}" "{local_id, external_id, remote_lsn, local_lsn}" _null_ _null_ pg_show_replication_origin_status _null_ _null_ _null_ ));
 DESCR("get progress for all replication origins");
 
+/* catalog/pg_subscription.h */
+DATA(insert OID = 6105 ( pg_subscription_create PGNSP PGUID 12 1 0 0 0 f f f f f f v 4 0 26 "19 25 19 1009" _null_ _null_ "{subscription_name,conninfo,slot_name,tables}" _null_ _null_ pg_subscription_create _null_ _null_ _null_ ));
+DESCR("create a subscription applying changes from a remote logical slot");
+
+DATA(insert OID = 6106 ( pg_subscription_drop PGNSP PGUID 12 1 0 0 0 f f f f t f v 1 0 2278 "19" _null_ _null_ _null_ _null_ _null_ pg_subscription_drop _null_ _null_ _null_ ));
+DESCR("drop a subscription");
+
+DATA(insert OID = 6107 ( pg_subscription_enable PGNSP PGUID 12 1 0 0 0 f f f f t f v 1 0 2278 "19" _null_ _null_ _null_ _null_ _null_ pg_subscription_enable _null_ _null_ _null_ ));
+DESCR("start applying changes of a subscription");
+
+DATA(insert OID = 6108 ( pg_subscription_disable PGNSP PGUID 12 1 0 0 0 f f f f t f v 1 0 2278 "19" _null_ _null_ _null_ _null_ _null_ pg_subscription_disable _null_ _null_ _null_ ));
+DESCR("stop applying changes of a subscription");
+
+DATA(insert OID = 6109 (  pg_stat_get_subscription	PGNSP PGUID 12 1 10 0 0 f f f f f t s 0 0 2249 "" "{26,23,3220,1184,3220,1184}" "{o,o,o,o,o,o}" "{subid,pid,received_lsn,last_msg_receipt_time,reply_lsn,reply_time}" _null_ _null_ pg_stat_get_subscription _null_ _null_ _null_ ));
+DESCR("statistics: information about logical replication apply workers");
+DATA(insert OID = 6110 (  pg_stat_get_session_pool	PGNSP PGUID 12 1 10 0 0 f f f f f t s 0 0 2249 "" "{23,26,26,23}" "{o,o,o,o}" "{pid,datid,usesysid,sessions}" _null_ _null_ pg_stat_get_session_pool _null_ _null_ _null_ ));
+DESCR("statistics: information about pooled backends");
+DATA(insert OID = 6124 (  pg_stat_get_syscache	PGNSP PGUID 12 1 100 0 0 f f f f f t v 0 0 2249 "" "{23,25,26,23,20,20,20,20,20,20,20}" "{o,o,o,o,o,o,o,o,o,o,o}" "{cache_id,cache_name,indexrelid,entries,size,searches,hits,neg_hits,loads,invalidations,evictions}" _null_ _null_ pg_stat_get_syscache _null_ _null_ _null_ ));
+DESCR("statistics: size and usage of this session's catalog and relation caches");
+
 /* tablesample */
 DATA(insert OID = 3335 (  tsm_system_init		PGNSP PGUID 12 1 0 0 0 f f f f t f v 3 0 2278 "2281 23 700" _null_ _null_ _null_ _null_ _null_ tsm_system_init _null_ _null_ _null_ ));
 DESCR("tsm_system_init(internal)");
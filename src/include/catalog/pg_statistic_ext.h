@@ -0,0 +1,85 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_statistic_ext.h
+ *	  definition of the system "extended statistic" relation
+ *	  (pg_statistic_ext) along with the relation's initial contents.
+ *
+ * Each row describes a statistics object created with CREATE STATISTICS on
+ * a group of columns of a table, and holds the multi-column statistics
+ * ANALYZE last computed for it.
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/catalog/pg_statistic_ext.h
+ *
+ * NOTES
+ *	  the genbki.pl script reads this file and generates .bki
+ *	  information from the DATA() statements.
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef PG_STATISTIC_EXT_H
+#define PG_STATISTIC_EXT_H
+
+#include "catalog/genbki.h"
+
+/* ----------------
+ *		pg_statistic_ext definition.  cpp turns this into
+ *		typedef struct FormData_pg_statistic_ext
+ * ----------------
+ */
+#define StatisticExtRelationId	6118
+
+CATALOG(pg_statistic_ext,6118)
+{
+	Oid			stxrelid;		/* relation containing the columns */
+	NameData	stxname;		/* statistics object name */
+	Oid			stxnamespace;	/* namespace, that of stxrelid */
+
+	/*
+	 * variable-length fields start here, but we allow direct access to
+	 * stxkeys
+	 */
+	int2vector	stxkeys;		/* column numbers, in ascending order */
+
+#ifdef CATALOG_VARLEN
+	char		stxkind[1] BKI_FORCE_NOT_NULL;	/* statistic kinds to build,
+												 * see STATS_EXT_xxx */
+	bytea		stxndistinct;	/* serialized MVNDistinct, or NULL */
+	bytea		stxdependencies;	/* serialized MVDependencies, or NULL */
+#endif
+} FormData_pg_statistic_ext;
+
+/* ----------------
+ *		Form_pg_statistic_ext corresponds to a pointer to a tuple with
+ *		the format of pg_statistic_ext relation.
+ * ----------------
+ */
+typedef FormData_pg_statistic_ext *Form_pg_statistic_ext;
+
+/* ----------------
+ *		compiler constants for pg_statistic_ext
+ * ----------------
+ */
+#define Natts_pg_statistic_ext					7
+#define Anum_pg_statistic_ext_stxrelid			1
+#define Anum_pg_statistic_ext_stxname			2
+#define Anum_pg_statistic_ext_stxnamespace		3
+#define Anum_pg_statistic_ext_stxkeys			4
+#define Anum_pg_statistic_ext_stxkind			5
+#define Anum_pg_statistic_ext_stxndistinct		6
+#define Anum_pg_statistic_ext_stxdependencies	7
+
+/*
+ * Statistic kinds, as stored in stxkind
+ */
+#define STATS_EXT_NDISTINCT			'd'
+#define STATS_EXT_DEPENDENCIES		'f'
+
+/* ----------------
+ *		pg_statistic_ext has no initial contents
+ * ----------------
+ */
+
+#endif   /* PG_STATISTIC_EXT_H */
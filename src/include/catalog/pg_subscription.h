@@ -0,0 +1,98 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_subscription.h
+ *	  definition of the system "subscription" relation (pg_subscription)
+ *	  along with the relation's initial contents.
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/catalog/pg_subscription.h
+ *
+ * NOTES
+ *	  the genbki.pl script reads this file and generates .bki
+ *	  information from the DATA() statements.
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef PG_SUBSCRIPTION_H
+#define PG_SUBSCRIPTION_H
+
+#include "catalog/genbki.h"
+#include "nodes/pg_list.h"
+
+/* ----------------
+ *		pg_subscription definition. cpp turns this into
+ *		typedef struct FormData_pg_subscription
+ * ----------------
+ */
+#define SubscriptionRelationId	6100
+#define SubscriptionRelation_Rowtype_Id	6127
+
+/*
+ * Subscriptions are shared across the cluster, so that the logical
+ * replication launcher can find them without connecting to any particular
+ * database.  Each one is applied within the database named by subdbid.
+ * That's also why its relcache entry is built by formrdesc(), like those
+ * of pg_database and pg_authid.
+ */
+CATALOG(pg_subscription,6100) BKI_SHARED_RELATION BKI_ROWTYPE_OID(6127) BKI_SCHEMA_MACRO
+{
+	Oid			subdbid;		/* database the subscription applies to */
+	NameData	subname;		/* name of the subscription */
+	bool		subenabled;		/* true if an apply worker should run */
+	NameData	subslotname;	/* logical slot to stream from */
+
+#ifdef CATALOG_VARLEN			/* variable-length fields start here */
+	text		subconninfo BKI_FORCE_NOT_NULL;	/* connection to publisher */
+	text		subtables[1];	/* qualified names of replicated tables, or
+								 * NULL for all tables */
+#endif
+} FormData_pg_subscription;
+
+/* ----------------
+ *		Form_pg_subscription corresponds to a pointer to a tuple with
+ *		the format of pg_subscription relation.
+ * ----------------
+ */
+typedef FormData_pg_subscription *Form_pg_subscription;
+
+/* ----------------
+ *		compiler constants for pg_subscription
+ * ----------------
+ */
+#define Natts_pg_subscription					6
+#define Anum_pg_subscription_subdbid			1
+#define Anum_pg_subscription_subname			2
+#define Anum_pg_subscription_subenabled			3
+#define Anum_pg_subscription_subslotname		4
+#define Anum_pg_subscription_subconninfo		5
+#define Anum_pg_subscription_subtables			6
+
+/* ----------------
+ *		pg_subscription has no initial contents
+ * ----------------
+ */
+
+/*
+ * In-memory representation of a subscription, as returned by
+ * GetSubscription().
+ */
+typedef struct Subscription
+{
+	Oid			oid;			/* OID of the subscription */
+	Oid			dbid;			/* database the subscription applies to */
+	char	   *name;			/* name of the subscription */
+	bool		enabled;		/* is the subscription enabled? */
+	char	   *slotname;		/* logical slot on the publisher */
+	char	   *conninfo;		/* connection string to the publisher */
+	List	   *tables;			/* qualified table names (char *), or NIL
+								 * for all tables */
+} Subscription;
+
+extern Subscription *GetSubscription(Oid subid, bool missing_ok);
+extern List *GetSubscriptionList(void);
+extern void FreeSubscription(Subscription *sub);
+extern int	CountDBSubscriptions(Oid dbid);
+
+#endif   /* PG_SUBSCRIPTION_H */
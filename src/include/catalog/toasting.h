@@ -49,10 +49,12 @@ extern void BootstrapToastTable(char *relName,
 DECLARE_TOAST(pg_attrdef, 2830, 2831);
 DECLARE_TOAST(pg_constraint, 2832, 2833);
 DECLARE_TOAST(pg_description, 2834, 2835);
+DECLARE_TOAST(pg_partition, 6116, 6117);
 DECLARE_TOAST(pg_proc, 2836, 2837);
 DECLARE_TOAST(pg_rewrite, 2838, 2839);
 DECLARE_TOAST(pg_seclabel, 3598, 3599);
 DECLARE_TOAST(pg_statistic, 2840, 2841);
+DECLARE_TOAST(pg_statistic_ext, 6122, 6123);
 DECLARE_TOAST(pg_trigger, 2336, 2337);
 
 /* shared catalogs */
@@ -65,5 +67,8 @@ DECLARE_TOAST(pg_db_role_setting, 2966, 2967);
 DECLARE_TOAST(pg_shseclabel, 4060, 4061);
 #define PgShseclabelToastTable 4060
 #define PgShseclabelToastIndex 4061
+DECLARE_TOAST(pg_subscription, 6103, 6104);
+#define PgSubscriptionToastTable 6103
+#define PgSubscriptionToastIndex 6104
 
 #endif   /* TOASTING_H */
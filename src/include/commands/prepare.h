@@ -15,6 +15,7 @@
 
 #include "commands/explain.h"
 #include "datatype/timestamp.h"
+#include "utils/hsearch.h"
 #include "utils/plancache.h"
 
 /*
@@ -55,5 +56,6 @@ extern TupleDesc FetchPreparedStatementResultDesc(PreparedStatement *stmt);
 extern List *FetchPreparedStatementTargetList(PreparedStatement *stmt);
 
 extern void DropAllPreparedStatements(void);
+extern HTAB *SwapPreparedStatements(HTAB *queries);
 
 #endif   /* PREPARE_H */
@@ -78,6 +78,10 @@ extern ObjectAddress AlterSequence(AlterSeqStmt *stmt);
 extern void ResetSequence(Oid seq_relid);
 extern void ResetSequenceCaches(void);
 
+/* opaque, for pooled backends */
+typedef struct SequenceCaches SequenceCaches;
+extern SequenceCaches *SwapSequenceCaches(SequenceCaches *caches);
+
 extern void seq_redo(XLogReaderState *rptr);
 extern void seq_desc(StringInfo buf, XLogReaderState *rptr);
 extern const char *seq_identify(uint8 info);
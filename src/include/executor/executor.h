@@ -150,6 +150,8 @@ extern TupleHashEntry FindTupleHashEntry(TupleHashTable hashtable,
 				   TupleTableSlot *slot,
 				   FmgrInfo *eqfunctions,
 				   FmgrInfo *hashfunctions);
+extern TupleHashEntry RemoveTupleHashEntry(TupleHashTable hashtable,
+					 TupleTableSlot *slot);
 
 /*
  * prototypes from functions in execJunk.c
@@ -193,6 +195,10 @@ extern ResultRelInfo *ExecGetTriggerResultRel(EState *estate, Oid relid);
 extern bool ExecContextForcesOids(PlanState *planstate, bool *hasoids);
 extern void ExecConstraints(ResultRelInfo *resultRelInfo,
 				TupleTableSlot *slot, EState *estate);
+extern void ExecSetupPartitionRouting(ResultRelInfo *resultRelInfo,
+						  EState *estate);
+extern ResultRelInfo *ExecFindPartition(ResultRelInfo *resultRelInfo,
+				  TupleTableSlot **slot, EState *estate);
 extern void ExecWithCheckOptions(WCOKind kind, ResultRelInfo *resultRelInfo,
 					 TupleTableSlot *slot, EState *estate);
 extern LockTupleMode ExecUpdateLockMode(EState *estate, ResultRelInfo *relinfo);
@@ -218,6 +224,17 @@ extern TupleTableSlot *EvalPlanQualNext(EPQState *epqstate);
 extern void EvalPlanQualBegin(EPQState *epqstate, EState *parentestate);
 extern void EvalPlanQualEnd(EPQState *epqstate);
 
+/*
+ * prototypes from functions in execPartition.c
+ */
+extern PartitionPruneState *ExecInitPartitionPrune(PlanState *planstate,
+					   PartitionPruneInfo *pinfo);
+extern Bitmapset *ExecFindValidSubplans(PartitionPruneState *prunestate,
+					  bool initial);
+extern void ExecKeepValidSubplans(PartitionPruneState *prunestate,
+					  Bitmapset *validsubplans);
+extern void ExecEndPartitionPrune(PartitionPruneState *prunestate);
+
 /*
  * prototypes from functions in execProcnode.c
  */
@@ -284,6 +284,7 @@ extern void dlist_insert_before(dlist_node *before, dlist_node *node);
 extern void dlist_delete(dlist_node *node);
 extern dlist_node *dlist_pop_head_node(dlist_head *head);
 extern void dlist_move_head(dlist_head *head, dlist_node *node);
+extern void dlist_move_tail(dlist_head *head, dlist_node *node);
 extern bool dlist_has_next(dlist_head *head, dlist_node *node);
 extern bool dlist_has_prev(dlist_head *head, dlist_node *node);
 extern dlist_node *dlist_next_node(dlist_head *head, dlist_node *node);
@@ -421,6 +422,25 @@ dlist_move_head(dlist_head *head, dlist_node *node)
 	dlist_check(head);
 }
 
+/*
+ * Move element from its current position in the list to the tail position in
+ * the same list.
+ *
+ * Undefined behaviour if 'node' is not already part of the list.
+ */
+STATIC_IF_INLINE void
+dlist_move_tail(dlist_head *head, dlist_node *node)
+{
+	/* fast path if it's already at the tail */
+	if (head->head.prev == node)
+		return;
+
+	dlist_delete(node);
+	dlist_push_tail(head, node);
+
+	dlist_check(head);
+}
+
 /*
  * Check whether 'node' has a following node.
  * Caution: unreliable if 'node' is not in the list.
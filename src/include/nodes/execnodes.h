@@ -17,6 +17,7 @@
 #include "access/genam.h"
 #include "access/heapam.h"
 #include "executor/instrument.h"
+#include "lib/ilist.h"
 #include "lib/pairingheap.h"
 #include "nodes/params.h"
 #include "nodes/plannodes.h"
@@ -33,7 +34,8 @@
  *		entries for a particular index.  Used for both index_build and
  *		retail creation of index entries.
  *
- *		NumIndexAttrs		number of columns in this index
+ *		NumIndexAttrs		total number of columns in this index
+ *		NumIndexKeyAttrs	number of key columns in index
  *		KeyAttrNumbers		underlying-rel attribute numbers used as keys
  *							(zeroes indicate expressions)
  *		Expressions			expr trees for expression entries, or NIL if none
@@ -58,7 +60,8 @@
 typedef struct IndexInfo
 {
 	NodeTag		type;
-	int			ii_NumIndexAttrs;
+	int			ii_NumIndexAttrs;	/* total number of columns in index */
+	int			ii_NumIndexKeyAttrs;	/* number of key columns in index */
 	AttrNumber	ii_KeyAttrNumbers[INDEX_MAX_KEYS];
 	List	   *ii_Expressions; /* list of Expr */
 	List	   *ii_ExpressionsState;	/* list of ExprState */
@@ -318,6 +321,15 @@ typedef struct JunkFilter
  *		projectReturning		for computing a RETURNING list
  *		onConflictSetProj		for computing ON CONFLICT DO UPDATE SET
  *		onConflictSetWhere		list of ON CONFLICT DO UPDATE exprs (qual)
+ *		PartitionRouting		state for routing tuples to partitions, if
+ *								inserting into a partitioned table
+ *		PartitionCheck			constraint implied by the partition bound,
+ *								if the relation is a partition
+ *		PartitionCheckExpr		expr state for PartitionCheck
+ *		PartitionRootMap		conversion of tuples from the rowtype of a
+ *								partition tuples were routed to back to that
+ *								of the partitioned table inserted into, or
+ *								NULL if they are the same
  * ----------------
  */
 typedef struct ResultRelInfo
@@ -341,8 +353,41 @@ typedef struct ResultRelInfo
 	ProjectionInfo *ri_projectReturning;
 	ProjectionInfo *ri_onConflictSetProj;
 	List	   *ri_onConflictSetWhere;
+	struct PartitionRoutingState *ri_PartitionRouting;
+	List	   *ri_PartitionCheck;
+	List	   *ri_PartitionCheckExpr;
+	struct TupleConversionMap *ri_PartitionRootMap;
 } ResultRelInfo;
 
+/* ----------------
+ *	 PartitionRoutingState information
+ *
+ *		Tuples inserted into a partitioned table are stored in the partition
+ *		that accepts them.  Partitions are opened, as ResultRelInfos, when
+ *		the first tuple is routed to them.
+ *
+ *		nparts					number of partitions
+ *		partoids				their OIDs, in partition descriptor order
+ *		partrels				their ResultRelInfos, or NULL if not open yet
+ *		partmaps				conversion of tuples from the partitioned
+ *								table's rowtype to the partition's, or NULL
+ *								if they are the same
+ *		partslots				slots for converted tuples
+ *		rootslot				slot for a tuple converted back to the
+ *								partitioned table's rowtype, for RETURNING
+ *								and WITH CHECK OPTION processing
+ * ----------------
+ */
+typedef struct PartitionRoutingState
+{
+	int			nparts;
+	Oid		   *partoids;
+	ResultRelInfo **partrels;
+	struct TupleConversionMap **partmaps;
+	TupleTableSlot **partslots;
+	TupleTableSlot *rootslot;
+} PartitionRoutingState;
+
 /* ----------------
  *	  EState information
  *
@@ -736,6 +781,11 @@ typedef struct FuncExprState
  *		ScalarArrayOpExprState node
  *
  * This is a FuncExprState plus some additional data.
+ *
+ * If the array is a large enough constant and the operator (or, for ALL,
+ * its negator) is a hashable equality, the elements are loaded into a hash
+ * table on first use and each evaluation probes it instead of looping over
+ * the array.
  * ----------------
  */
 typedef struct ScalarArrayOpExprState
@@ -746,6 +796,17 @@ typedef struct ScalarArrayOpExprState
 	int16		typlen;
 	bool		typbyval;
 	char		typalign;
+	/* These fields are used only for hashed evaluation */
+	bool		hash_built;		/* has the hash table been built yet? */
+	uint32		hash_mask;		/* hash table size - 1 */
+	Datum	   *hash_elems;		/* non-null elements, by hash bucket */
+	uint32	   *hash_codes;		/* hash codes of the elements */
+	bool	   *hash_used;		/* is the bucket occupied? */
+	bool		has_nulls;		/* does the array contain NULLs? */
+	FmgrInfo	cur_eq_func;	/* equality function, scalar vs element */
+	FmgrInfo	lhs_hash_func;	/* hash function for the scalar type */
+	FmgrInfo	tab_eq_func;	/* equality function for the element type */
+	FmgrInfo	tab_hash_func;	/* hash function for the element type */
 } ScalarArrayOpExprState;
 
 /* ----------------
@@ -1138,11 +1199,55 @@ typedef struct ModifyTableState
 										 * target */
 } ModifyTableState;
 
+/* ----------------
+ *	 PartitionPruneState information
+ *
+ *		Run-time state of the PartitionPruneInfo of an Append or MergeAppend
+ *		node; see execPartition.c.
+ *
+ *		partrel			the partitioned table
+ *		nsubplans		number of subplans
+ *		subpartidx		for each subplan, the PartitionDesc index of the
+ *						partition it belongs to, or -1 if it's never pruned
+ *		nvalues			number of "key op value" restrictions
+ *		strategies		their btree strategies
+ *		values			ExprStates computing their values
+ *		value_isexec	does each value depend on PARAM_EXEC params?
+ *		narrays			number of "key = ANY (array)" restrictions
+ *		arrays			ExprStates computing their arrays
+ *		array_isexec	does each array depend on PARAM_EXEC params?
+ *		has_exec		do any restrictions depend on PARAM_EXEC params?
+ *		econtext		context to evaluate the restrictions in
+ * ----------------
+ */
+typedef struct PartitionPruneState
+{
+	Relation	pp_partrel;
+	int			pp_nsubplans;
+	int		   *pp_subpartidx;
+	int			pp_nvalues;
+	StrategyNumber *pp_strategies;
+	ExprState **pp_values;
+	bool	   *pp_value_isexec;
+	int			pp_narrays;
+	ExprState **pp_arrays;
+	bool	   *pp_array_isexec;
+	bool		pp_has_exec;
+	ExprContext *pp_econtext;
+} PartitionPruneState;
+
 /* ----------------
  *	 AppendState information
  *
  *		nplans			how many plans are in the array
  *		whichplan		which plan is being executed (0 .. n-1)
+ *		prune_state		run-time pruning state, if there's pruning left to
+ *						do once the node is run, else NULL
+ *		valid_subplans	subplans not ruled out for the current params
+ *		prune_pending	must valid_subplans be recomputed?
+ *
+ *		Subplans ruled out already at executor startup are not initialized
+ *		at all, so nplans can be less than the number of the plan's subplans.
  * ----------------
  */
 typedef struct AppendState
@@ -1151,6 +1256,9 @@ typedef struct AppendState
 	PlanState **appendplans;	/* array of PlanStates for my inputs */
 	int			as_nplans;
 	int			as_whichplan;
+	PartitionPruneState *as_prune_state;
+	Bitmapset  *as_valid_subplans;
+	bool		as_prune_pending;
 } AppendState;
 
 /* ----------------
@@ -1162,6 +1270,9 @@ typedef struct AppendState
  *		slots			current output tuple of each subplan
  *		heap			heap of active tuples
  *		initialized		true if we have fetched first tuple from each subplan
+ *		prune_state		run-time pruning state, as for Append
+ *
+ *		As for Append, nplans doesn't count subplans pruned at startup.
  * ----------------
  */
 typedef struct MergeAppendState
@@ -1174,6 +1285,7 @@ typedef struct MergeAppendState
 	TupleTableSlot **ms_slots;	/* array of length ms_nplans */
 	struct binaryheap *ms_heap; /* binary heap of slot indices */
 	bool		ms_initialized; /* are subplans started? */
+	PartitionPruneState *ms_prune_state;
 } MergeAppendState;
 
 /* ----------------
@@ -1774,6 +1886,46 @@ typedef struct MaterialState
 	Tuplestorestate *tuplestorestate;
 } MaterialState;
 
+/* ----------------
+ *	 MemoizeState information
+ *
+ *		memoize nodes remember the rows returned by their subplan for each
+ *		set of parameter values, in a hash table limited to work_mem.
+ *		When the table is full, the least recently used entries are
+ *		evicted.
+ * ----------------
+ */
+/* these structs are private in nodeMemoize.c: */
+typedef struct MemoizeEntry MemoizeEntry;
+typedef struct MemoizeTuple MemoizeTuple;
+
+typedef struct MemoizeState
+{
+	ScanState	ss;				/* its first field is NodeTag */
+	int			mstatus;		/* state of the current scan, see
+								 * nodeMemoize.c */
+	int			nkeys;			/* number of cache keys */
+	List	   *param_exprs;	/* ExprStates computing the cache keys */
+	Bitmapset  *keyparamids;	/* params referenced by param_exprs */
+	FmgrInfo   *eqfunctions;	/* per-key equality fns */
+	FmgrInfo   *hashfunctions;	/* per-key hash fns */
+	AttrNumber *keyColIdx;		/* key column numbers in probeslot */
+	TupleTableSlot *probeslot;	/* holds the keys of the current lookup */
+	TupleHashTable hashtable;	/* hash table with one entry per key */
+	MemoryContext tableContext; /* memory context containing hash table */
+	dlist_head	lru_list;		/* entries, least recently used first */
+	Size		mem_used;		/* memory used by the entries */
+	Size		mem_limit;		/* memory the entries may use */
+	MemoizeEntry *entry;		/* entry of the current scan, if any */
+	MemoizeTuple *last_tuple;	/* last cached tuple returned or added */
+	/* statistics for EXPLAIN ANALYZE */
+	long		cache_hits;		/* # of rescans answered from the cache */
+	long		cache_misses;	/* # of rescans that ran the subplan */
+	long		cache_evictions;	/* # of entries evicted for space */
+	long		cache_overflows;	/* # of entries too big to cache */
+	Size		mem_peak;		/* peak value of mem_used */
+} MemoizeState;
+
 /* ----------------
  *	 SortState information
  * ----------------
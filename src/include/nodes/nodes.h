@@ -69,6 +69,7 @@ typedef enum NodeTag
 	T_MergeJoin,
 	T_HashJoin,
 	T_Material,
+	T_Memoize,
 	T_Sort,
 	T_Group,
 	T_Agg,
@@ -82,6 +83,7 @@ typedef enum NodeTag
 	T_NestLoopParam,
 	T_PlanRowMark,
 	T_PlanInvalItem,
+	T_PartitionPruneInfo,
 
 	/*
 	 * TAGS FOR PLAN STATE NODES (execnodes.h)
@@ -116,6 +118,7 @@ typedef enum NodeTag
 	T_MergeJoinState,
 	T_HashJoinState,
 	T_MaterialState,
+	T_MemoizeState,
 	T_SortState,
 	T_GroupState,
 	T_AggState,
@@ -221,6 +224,7 @@ typedef enum NodeTag
 	T_PlannerGlobal,
 	T_RelOptInfo,
 	T_IndexOptInfo,
+	T_StatisticExtInfo,
 	T_ParamPathInfo,
 	T_Path,
 	T_IndexPath,
@@ -237,6 +241,7 @@ typedef enum NodeTag
 	T_MergeAppendPath,
 	T_ResultPath,
 	T_MaterialPath,
+	T_MemoizePath,
 	T_UniquePath,
 	T_EquivalenceClass,
 	T_EquivalenceMember,
@@ -378,6 +383,7 @@ typedef enum NodeTag
 	T_CreatePolicyStmt,
 	T_AlterPolicyStmt,
 	T_CreateTransformStmt,
+	T_CreateStatsStmt,
 
 	/*
 	 * TAGS FOR PARSE TREE NODES (parsenodes.h)
@@ -426,6 +432,8 @@ typedef enum NodeTag
 	T_RoleSpec,
 	T_RangeTableSample,
 	T_TableSampleClause,
+	T_PartitionSpec,
+	T_PartitionBoundSpec,
 
 	/*
 	 * TAGS FOR REPLICATION GRAMMAR PARSE NODES (replnodes.h)
@@ -1405,6 +1405,7 @@ typedef enum ObjectType
 	OBJECT_RULE,
 	OBJECT_SCHEMA,
 	OBJECT_SEQUENCE,
+	OBJECT_STATISTIC_EXT,
 	OBJECT_TABCONSTRAINT,
 	OBJECT_TABLE,
 	OBJECT_TABLESPACE,
@@ -1746,8 +1747,45 @@ typedef struct CreateStmt
 	OnCommitAction oncommit;	/* what do we do at COMMIT? */
 	char	   *tablespacename; /* table space to use, or NULL */
 	bool		if_not_exists;	/* just do nothing if it already exists? */
+	struct PartitionSpec *partspec;		/* PARTITION BY clause, or NULL */
+	struct PartitionBoundSpec *partbound;	/* FOR VALUES clause of a
+											 * partition, or NULL */
 } CreateStmt;
 
+/* ----------
+ * Definitions for declarative partitioning in CreateStmt
+ *
+ * A partitioned table is created with PARTITION BY, and its partitions with
+ * CREATE TABLE ... PARTITION OF parent FOR VALUES ...; the partition is then
+ * an inheritance child of the parent, with its bound recorded in
+ * pg_partition.  PartitionBoundSpec is also the format of that catalog
+ * column: in raw gram.y output its datums are A_Const nodes, and after parse
+ * analysis they are non-null Consts of the partition key's type.  A NULL
+ * range datum stands for UNBOUNDED.
+ * ----------
+ */
+
+#define PARTITION_STRATEGY_LIST		'l'
+#define PARTITION_STRATEGY_RANGE	'r'
+
+typedef struct PartitionSpec
+{
+	NodeTag		type;
+	char	   *strategy;		/* partitioning strategy, "list" or "range" */
+	char	   *colname;		/* partition key column */
+	int			location;		/* token location, or -1 if unknown */
+} PartitionSpec;
+
+typedef struct PartitionBoundSpec
+{
+	NodeTag		type;
+	char		strategy;		/* PARTITION_STRATEGY_xxx */
+	List	   *listdatums;		/* values accepted by a list partition */
+	Node	   *lowerdatum;		/* range partition lower bound (inclusive) */
+	Node	   *upperdatum;		/* range partition upper bound (exclusive) */
+	int			location;		/* token location, or -1 if unknown */
+} PartitionBoundSpec;
+
 /* ----------
  * Definitions for constraints in CreateStmt
  *
@@ -2416,6 +2454,8 @@ typedef struct IndexStmt
 	char	   *accessMethod;	/* name of access method (eg. btree) */
 	char	   *tableSpace;		/* tablespace, or NULL for default */
 	List	   *indexParams;	/* columns to index: a list of IndexElem */
+	List	   *indexIncludingParams;	/* additional columns to store in the
+										 * index: a list of IndexElem */
 	List	   *options;		/* WITH clause options: a list of DefElem */
 	Node	   *whereClause;	/* qualification (partial-index predicate) */
 	List	   *excludeOpNames; /* exclusion operator names, or NIL if none */
@@ -2432,6 +2472,21 @@ typedef struct IndexStmt
 	bool		if_not_exists;	/* just do nothing if index already exists? */
 } IndexStmt;
 
+/* ----------------------
+ *		Create Statistics Statement
+ * ----------------------
+ */
+typedef struct CreateStatsStmt
+{
+	NodeTag		type;
+	char	   *statname;		/* name of new statistics object */
+	RangeVar   *relation;		/* table the statistics are on */
+	List	   *keys;			/* column names (list of String) */
+	List	   *stat_types;		/* statistic kinds (list of String), or NIL
+								 * for all kinds */
+	bool		if_not_exists;	/* just do nothing if it already exists? */
+} CreateStatsStmt;
+
 /* ----------------------
  *		Create Function Statement
  * ----------------------
@@ -199,6 +199,7 @@ typedef struct Append
 {
 	Plan		plan;
 	List	   *appendplans;
+	struct PartitionPruneInfo *part_prune_info; /* run-time pruning, or NULL */
 } Append;
 
 /* ----------------
@@ -216,6 +217,7 @@ typedef struct MergeAppend
 	Oid		   *sortOperators;	/* OIDs of operators to sort them by */
 	Oid		   *collations;		/* OIDs of collations */
 	bool	   *nullsFirst;		/* NULLS FIRST/LAST directions */
+	struct PartitionPruneInfo *part_prune_info; /* run-time pruning, or NULL */
 } MergeAppend;
 
 /* ----------------
@@ -324,6 +326,9 @@ typedef Scan SampleScan;
  *
  * indexorderdir specifies the scan ordering, for indexscans on amcanorder
  * indexes (for other indexes it should be "don't care").
+ *
+ * indexskipprefix is the number of leading index columns to skip over (see
+ * IndexPath), or zero.
  * ----------------
  */
 typedef struct IndexScan
@@ -336,6 +341,7 @@ typedef struct IndexScan
 	List	   *indexorderbyorig;		/* the same in original form */
 	List	   *indexorderbyops;	/* OIDs of sort ops for ORDER BY exprs */
 	ScanDirection indexorderdir;	/* forward or backward or don't care */
+	int			indexskipprefix;	/* # of leading columns to skip over */
 } IndexScan;
 
 /* ----------------
@@ -363,6 +369,7 @@ typedef struct IndexOnlyScan
 	List	   *indexorderby;	/* list of index ORDER BY exprs */
 	List	   *indextlist;		/* TargetEntry list describing index's cols */
 	ScanDirection indexorderdir;	/* forward or backward or don't care */
+	int			indexskipprefix;	/* # of leading columns to skip over */
 } IndexOnlyScan;
 
 /* ----------------
@@ -388,6 +395,7 @@ typedef struct BitmapIndexScan
 	Oid			indexid;		/* OID of index to scan */
 	List	   *indexqual;		/* list of index quals (OpExprs) */
 	List	   *indexqualorig;	/* the same in original form */
+	int			indexskipprefix;	/* # of leading columns to skip over */
 } BitmapIndexScan;
 
 /* ----------------
@@ -652,6 +660,24 @@ typedef struct Material
 	Plan		plan;
 } Material;
 
+/* ----------------
+ *		memoize node
+ *
+ * Caches the rows its subplan returns for each distinct set of values of
+ * param_exprs, so that rescanning it with parameter values seen before
+ * returns the remembered rows instead of running the subplan again.  The
+ * keys are expressions over the nestloop parameters the subplan uses.
+ * ----------------
+ */
+typedef struct Memoize
+{
+	Plan		plan;
+	int			numKeys;		/* number of cache keys */
+	Oid		   *hashOperators;	/* hash equality operators for the keys */
+	List	   *param_exprs;	/* cache key expressions */
+	uint32		est_entries;	/* estimated number of cache entries, or 0 */
+} Memoize;
+
 /* ----------------
  *		sort node
  * ----------------
@@ -921,6 +947,33 @@ typedef struct PlanRowMark
 } PlanRowMark;
 
 
+/*
+ * PartitionPruneInfo -
+ *	   plan-time representation of run-time partition pruning
+ *
+ * An Append or MergeAppend scanning a partitioned table gets one of these
+ * when some of the restrictions on the table's partition key compare it
+ * with values that aren't known until execution: Params, or expressions
+ * calling stable functions.  Each "key op value" restriction is represented
+ * by the btree strategy of op, as seen from the key, and the value; each
+ * "key = ANY (array)" restriction just by the array.  The executor
+ * evaluates these to skip the subplans that can't produce any rows.
+ *
+ * subpartoids has an entry for each subplan: the OID of the partition of
+ * reloid that the subplan's relation is, or is a descendant of, or
+ * InvalidOid if the subplan scans the partitioned table itself.
+ */
+typedef struct PartitionPruneInfo
+{
+	NodeTag		type;
+	Oid			reloid;			/* OID of the partitioned table */
+	List	   *strategies;		/* integer list of btree strategies */
+	List	   *values;			/* comparison values, one per strategy */
+	List	   *arrayvalues;	/* arrays the key must equal a member of */
+	List	   *subpartoids;	/* OID list, one per subplan */
+} PartitionPruneInfo;
+
+
 /*
  * Plan invalidation info
  *
@@ -362,6 +362,8 @@ typedef struct PlannerInfo
  *		lateral_referencers - relids of rels that reference this one laterally
  *		indexlist - list of IndexOptInfo nodes for relation's indexes
  *					(always NIL if it's not a table)
+ *		statlist - list of StatisticExtInfo nodes for the relation's
+ *				   extended statistics (always NIL if it's not a table)
  *		pages - number of disk pages in relation (zero if not a table)
  *		tuples - number of tuples in relation (not considering restrictions)
  *		allvisfrac - fraction of disk pages that are marked all-visible
@@ -459,6 +461,7 @@ typedef struct RelOptInfo
 	Relids		lateral_relids; /* minimum parameterization of rel */
 	Relids		lateral_referencers;	/* rels that reference me laterally */
 	List	   *indexlist;		/* list of IndexOptInfo */
+	List	   *statlist;		/* list of StatisticExtInfo */
 	BlockNumber pages;			/* size estimates derived from pg_class */
 	double		tuples;
 	double		allvisfrac;
@@ -487,11 +490,15 @@ typedef struct RelOptInfo
  *		Per-index information for planning/optimization
  *
  *		indexkeys[], indexcollations[], opfamily[], and opcintype[]
- *		each have ncolumns entries.
+ *		each have ncolumns entries.  Only the first nkeycolumns of them are
+ *		key columns; any remaining ones are included (non-key) columns,
+ *		which can be returned by an index-only scan but can't be used in
+ *		index quals or orderings, and have zeroes in opfamily[] and
+ *		opcintype[].
  *
  *		sortopfamily[], reverse_sort[], and nulls_first[] likewise have
  *		ncolumns entries, if the index is ordered; but if it is unordered,
- *		those pointers are NULL.
+ *		those pointers are NULL.  Only the key columns' entries are valid.
  *
  *		Zeroes in the indexkeys[] array indicate index columns that are
  *		expressions; there is one element in indexprs for each such column.
@@ -523,6 +530,7 @@ typedef struct IndexOptInfo
 
 	/* index descriptor information */
 	int			ncolumns;		/* number of columns in index */
+	int			nkeycolumns;	/* number of key columns in index */
 	int		   *indexkeys;		/* column numbers of index's keys, or 0 */
 	Oid		   *indexcollations;	/* OIDs of collations of index columns */
 	Oid		   *opfamily;		/* OIDs of operator families for columns */
@@ -553,6 +561,24 @@ typedef struct IndexOptInfo
 	bool		amhasgetbitmap; /* does AM have amgetbitmap interface? */
 } IndexOptInfo;
 
+/*
+ * StatisticExtInfo
+ *		Information about extended statistics for planning/optimization
+ *
+ * Each pg_statistic_ext row is represented by one StatisticExtInfo for each
+ * kind of statistic it has been built for.  The statistics themselves are
+ * fetched from the syscache when they're used.
+ */
+typedef struct StatisticExtInfo
+{
+	NodeTag		type;
+
+	Oid			statOid;		/* OID of the statistics row */
+	RelOptInfo *rel;			/* back-link to statistic's table */
+	char		kind;			/* statistic kind of this entry */
+	Bitmapset  *keys;			/* attnums of the columns covered */
+} StatisticExtInfo;
+
 
 /*
  * EquivalenceClasses
@@ -802,6 +828,11 @@ typedef struct Path
  * we need not recompute them when considering using the same index in a
  * bitmap index/heap scan (see BitmapHeapPath).  The costs of the IndexPath
  * itself represent the costs of an IndexScan or IndexOnlyScan plan type.
+ *
+ * 'indexskipprefix' is the number of leading index columns the index AM
+ * should skip over, visiting each distinct prefix value in turn, or zero
+ * for an ordinary scan.  indxpath.c builds a skip scan path alongside the
+ * ordinary one when skipping is possible, and add_path keeps the cheaper.
  *----------
  */
 typedef struct IndexPath
@@ -816,6 +847,7 @@ typedef struct IndexPath
 	ScanDirection indexscandir;
 	Cost		indextotalcost;
 	Selectivity indexselectivity;
+	int			indexskipprefix;
 } IndexPath;
 
 /*
@@ -1000,6 +1032,24 @@ typedef struct MaterialPath
 	Path	   *subpath;
 } MaterialPath;
 
+/*
+ * MemoizePath represents use of a Memoize plan node, i.e., caching of the
+ * output of a parameterized subpath for each distinct set of parameter
+ * values.  param_exprs are the outer-side expressions the parameters are
+ * computed from, and hash_operators their hashable equality operators.
+ * calls is the expected number of rescans, est_entries the number of
+ * entries we expect to keep; they are used for costing.
+ */
+typedef struct MemoizePath
+{
+	Path		path;
+	Path	   *subpath;
+	List	   *hash_operators; /* OIDs of hash equality ops for keys */
+	List	   *param_exprs;	/* cache keys */
+	double		calls;			/* expected number of rescans */
+	uint32		est_entries;	/* estimated cache entries, set by costing */
+} MemoizePath;
+
 /*
  * UniquePath represents elimination of distinct rows from the output of
  * its subpath.
@@ -53,14 +53,18 @@ extern Cost disable_cost;
 extern bool enable_seqscan;
 extern bool enable_indexscan;
 extern bool enable_indexonlyscan;
+extern bool enable_indexskipscan;
 extern bool enable_bitmapscan;
 extern bool enable_tidscan;
 extern bool enable_sort;
 extern bool enable_hashagg;
 extern bool enable_nestloop;
 extern bool enable_material;
+extern bool enable_memoize;
 extern bool enable_mergejoin;
 extern bool enable_hashjoin;
+extern bool enable_partitionwise_join;
+extern bool enable_partitionwise_aggregate;
 extern int	constraint_exclusion;
 
 extern double clamp_row_est(double nrows);
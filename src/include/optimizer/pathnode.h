@@ -43,6 +43,7 @@ extern IndexPath *create_index_path(PlannerInfo *root,
 				  List *pathkeys,
 				  ScanDirection indexscandir,
 				  bool indexonly,
+				  int indexskipprefix,
 				  Relids required_outer,
 				  double loop_count);
 extern BitmapHeapPath *create_bitmap_heap_path(PlannerInfo *root,
@@ -67,6 +68,9 @@ extern MergeAppendPath *create_merge_append_path(PlannerInfo *root,
 						 Relids required_outer);
 extern ResultPath *create_result_path(List *quals);
 extern MaterialPath *create_material_path(RelOptInfo *rel, Path *subpath);
+extern MemoizePath *create_memoize_path(RelOptInfo *rel, Path *subpath,
+					List *param_exprs, List *hash_operators,
+					double calls);
 extern UniquePath *create_unique_path(PlannerInfo *root, RelOptInfo *rel,
 				   Path *subpath, SpecialJoinInfo *sjinfo);
 extern Path *create_subqueryscan_path(PlannerInfo *root, RelOptInfo *rel,
@@ -145,6 +149,13 @@ extern RelOptInfo *build_join_rel(PlannerInfo *root,
 			   SpecialJoinInfo *sjinfo,
 			   List **restrictlist_ptr);
 extern RelOptInfo *build_empty_join_rel(PlannerInfo *root);
+extern RelOptInfo *build_child_join_rel(PlannerInfo *root,
+					 RelOptInfo *parent_joinrel,
+					 RelOptInfo *outer_rel,
+					 RelOptInfo *inner_rel,
+					 List *appinfos,
+					 SpecialJoinInfo *sjinfo,
+					 List *restrictlist);
 extern AppendRelInfo *find_childrel_appendrelinfo(PlannerInfo *root,
 							RelOptInfo *rel);
 extern RelOptInfo *find_childrel_top_parent(PlannerInfo *root, RelOptInfo *rel);
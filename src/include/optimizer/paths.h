@@ -22,6 +22,8 @@
  */
 extern bool enable_geqo;
 extern int	geqo_threshold;
+extern bool geqo_idp;
+extern int	geqo_idp_block_size;
 
 /* Hook for plugins to get control in set_rel_pathlist() */
 typedef void (*set_rel_pathlist_hook_type) (PlannerInfo *root,
@@ -49,6 +51,8 @@ extern PGDLLIMPORT join_search_hook_type join_search_hook;
 extern RelOptInfo *make_one_rel(PlannerInfo *root, List *joinlist);
 extern RelOptInfo *standard_join_search(PlannerInfo *root, int levels_needed,
 					 List *initial_rels);
+extern RelOptInfo *idp_join_search(PlannerInfo *root, int levels_needed,
+				List *initial_rels);
 
 #ifdef OPTIMIZER_DEBUG
 extern void debug_print_rel(PlannerInfo *root, RelOptInfo *rel);
@@ -14,6 +14,7 @@
 #ifndef PREP_H
 #define PREP_H
 
+#include "catalog/partition.h"
 #include "nodes/plannodes.h"
 #include "nodes/relation.h"
 
@@ -64,4 +65,15 @@ extern Node *adjust_appendrel_attrs(PlannerInfo *root, Node *node,
 extern Node *adjust_appendrel_attrs_multilevel(PlannerInfo *root, Node *node,
 								  RelOptInfo *child_rel);
 
+extern Node *adjust_appendrel_attrs_multiple(PlannerInfo *root, Node *node,
+								List *appinfos);
+
+extern bool match_partition_key_clause(PartitionKey key, Index rti,
+						   Oid opno, Oid inputcollid,
+						   Node *leftop, Node *rightop,
+						   Node **other, StrategyNumber *strategy);
+
+extern AppendRelInfo **find_partition_appinfos(PlannerInfo *root,
+						Relation parent, Index rti);
+
 #endif   /* PREP_H */
@@ -20,6 +20,17 @@
 #define MAX_RATE_LOWER	32
 #define MAX_RATE_UPPER	1048576
 
+/*
+ * Maximum value of PARALLEL option in BASE_BACKUP command.
+ */
+#define MAX_PARALLEL_WORKERS	64
+
+/*
+ * Magic number at the start of the "<file>.incr" members sent instead of
+ * relation files in an INCREMENTAL base backup.
+ */
+#define INCREMENTAL_FILE_MAGIC	0x50474942
+
 
 typedef struct
 {
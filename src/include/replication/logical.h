@@ -40,6 +40,13 @@ typedef struct LogicalDecodingContext
 	OutputPluginCallbacks callbacks;
 	OutputPluginOptions options;
 
+	/*
+	 * Can large in-progress transactions be streamed to the output plugin?
+	 * Set if the plugin provides the stream callbacks; the plugin may clear
+	 * it in its startup callback.
+	 */
+	bool		streaming;
+
 	/*
 	 * User specified options
 	 */
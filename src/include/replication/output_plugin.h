@@ -80,6 +80,51 @@ typedef bool (*LogicalDecodeFilterByOriginCB) (
 											 struct LogicalDecodingContext *,
 													  RepOriginId origin_id);
 
+/*
+ * Called before streaming a chunk of changes of an in-progress transaction.
+ * Only used if the output plugin provides all the stream_* callbacks, and
+ * hasn't turned streaming off in its startup callback.
+ */
+typedef void (*LogicalDecodeStreamStartCB) (
+											 struct LogicalDecodingContext *,
+													  ReorderBufferTXN *txn);
+
+/*
+ * Called after streaming a chunk of changes of an in-progress transaction.
+ */
+typedef void (*LogicalDecodeStreamStopCB) (
+											 struct LogicalDecodingContext *,
+													  ReorderBufferTXN *txn);
+
+/*
+ * Callback for every individual change of a streamed transaction.  The
+ * change may belong to a subtransaction of txn; change->txn tells which.
+ */
+typedef void (*LogicalDecodeStreamChangeCB) (
+											 struct LogicalDecodingContext *,
+														ReorderBufferTXN *txn,
+														Relation relation,
+												ReorderBufferChange *change);
+
+/*
+ * Called when a (sub)transaction some of whose changes were streamed has
+ * aborted; those changes must be discarded.
+ */
+typedef void (*LogicalDecodeStreamAbortCB) (
+											 struct LogicalDecodingContext *,
+													   ReorderBufferTXN *txn,
+													   XLogRecPtr abort_lsn);
+
+/*
+ * Called at the commit of a streamed transaction, after its last chunk of
+ * changes.  All changes streamed for the transaction and for any of its
+ * subtransactions (txn->subtxns) become committed.
+ */
+typedef void (*LogicalDecodeStreamCommitCB) (
+											 struct LogicalDecodingContext *,
+														ReorderBufferTXN *txn,
+														XLogRecPtr commit_lsn);
+
 /*
  * Called to shutdown an output plugin.
  */
@@ -98,6 +143,12 @@ typedef struct OutputPluginCallbacks
 	LogicalDecodeCommitCB commit_cb;
 	LogicalDecodeFilterByOriginCB filter_by_origin_cb;
 	LogicalDecodeShutdownCB shutdown_cb;
+	/* streaming of in-progress transactions, optional */
+	LogicalDecodeStreamStartCB stream_start_cb;
+	LogicalDecodeStreamStopCB stream_stop_cb;
+	LogicalDecodeStreamChangeCB stream_change_cb;
+	LogicalDecodeStreamAbortCB stream_abort_cb;
+	LogicalDecodeStreamCommitCB stream_commit_cb;
 } OutputPluginCallbacks;
 
 void		OutputPluginPrepareWrite(struct LogicalDecodingContext *ctx, bool last_write);
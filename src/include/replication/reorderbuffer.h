@@ -20,6 +20,9 @@
 #include "utils/snapshot.h"
 #include "utils/timestamp.h"
 
+/* GUC variable */
+extern PGDLLIMPORT int logical_decoding_work_mem;
+
 /* an individual tuple, stored in one chunk of memory */
 typedef struct ReorderBufferTupleBuf
 {
@@ -75,6 +78,9 @@ typedef struct ReorderBufferChange
 	/* The type of change. */
 	enum ReorderBufferChangeType action;
 
+	/* Transaction this change belongs to, NULL if not queued to one. */
+	struct ReorderBufferTXN *txn;
+
 	RepOriginId origin_id;
 
 	/*
@@ -143,6 +149,12 @@ typedef struct ReorderBufferTXN
 	 */
 	bool		is_known_as_subxact;
 
+	/*
+	 * Have some of this transaction's changes already been streamed to the
+	 * output plugin, before its commit was decoded?
+	 */
+	bool		is_streamed;
+
 	/*
 	 * LSN of the first data carrying, WAL record with knowledge about this
 	 * xid. This is allowed to *not* be first record adorned with this xid, if
@@ -190,6 +202,14 @@ typedef struct ReorderBufferTXN
 	Snapshot	base_snapshot;
 	XLogRecPtr	base_snapshot_lsn;
 
+	/*
+	 * Snapshot and command id in effect at the end of the last streamed
+	 * chunk of changes, so the next one can resume from there.  NULL and
+	 * InvalidCommandId if nothing has been streamed yet.
+	 */
+	Snapshot	snapshot_now;
+	CommandId	command_id;
+
 	/*
 	 * How many ReorderBufferChange's do we have in this txn.
 	 *
@@ -203,6 +223,12 @@ typedef struct ReorderBufferTXN
 	 */
 	uint64		nentries_mem;
 
+	/*
+	 * Memory used by the changes of this transaction (not including its
+	 * subtransactions), for enforcing logical_decoding_work_mem.
+	 */
+	Size		size;
+
 	/*
 	 * List of ReorderBufferChange structs, including new Snapshots and new
 	 * CommandIds
@@ -274,6 +300,35 @@ typedef void (*ReorderBufferCommitCB) (
 												   ReorderBufferTXN *txn,
 												   XLogRecPtr commit_lsn);
 
+/* start streaming a chunk of an in-progress transaction */
+typedef void (*ReorderBufferStreamStartCB) (
+												   ReorderBuffer *rb,
+												   ReorderBufferTXN *txn);
+
+/* stop streaming a chunk of an in-progress transaction */
+typedef void (*ReorderBufferStreamStopCB) (
+												   ReorderBuffer *rb,
+												   ReorderBufferTXN *txn);
+
+/* streamed change callback signature */
+typedef void (*ReorderBufferStreamChangeCB) (
+														 ReorderBuffer *rb,
+														 ReorderBufferTXN *txn,
+														 Relation relation,
+												ReorderBufferChange *change);
+
+/* discard a previously streamed (sub)transaction */
+typedef void (*ReorderBufferStreamAbortCB) (
+												   ReorderBuffer *rb,
+												   ReorderBufferTXN *txn,
+												   XLogRecPtr abort_lsn);
+
+/* commit a previously streamed transaction */
+typedef void (*ReorderBufferStreamCommitCB) (
+												   ReorderBuffer *rb,
+												   ReorderBufferTXN *txn,
+												   XLogRecPtr commit_lsn);
+
 struct ReorderBuffer
 {
 	/*
@@ -301,6 +356,15 @@ struct ReorderBuffer
 	ReorderBufferApplyChangeCB apply_change;
 	ReorderBufferCommitCB commit;
 
+	/*
+	 * Callbacks to be called when streaming in-progress transactions.
+	 */
+	ReorderBufferStreamStartCB stream_start;
+	ReorderBufferStreamStopCB stream_stop;
+	ReorderBufferStreamChangeCB stream_change;
+	ReorderBufferStreamAbortCB stream_abort;
+	ReorderBufferStreamCommitCB stream_commit;
+
 	/*
 	 * Pointer that will be passed untouched to the callbacks.
 	 */
@@ -338,6 +402,9 @@ struct ReorderBuffer
 	/* buffer for disk<->memory conversions */
 	char	   *outbuf;
 	Size		outbufsize;
+
+	/* memory used by the changes of all transactions */
+	Size		size;
 };
 
 
@@ -14,6 +14,7 @@
 #define _SYNCREP_H
 
 #include "access/xlogdefs.h"
+#include "nodes/pg_list.h"
 #include "utils/guc.h"
 
 #define SyncRepRequested() \
@@ -23,16 +24,35 @@
 #define SYNC_REP_NO_WAIT		-1
 #define SYNC_REP_WAIT_WRITE		0
 #define SYNC_REP_WAIT_FLUSH		1
+#define SYNC_REP_WAIT_APPLY		2
 
-#define NUM_SYNC_REP_WAIT_MODE	2
+#define NUM_SYNC_REP_WAIT_MODE	3
 
 /* syncRepState */
 #define SYNC_REP_NOT_WAITING		0
 #define SYNC_REP_WAITING			1
 #define SYNC_REP_WAIT_COMPLETE		2
 
+/* syncrep_method of SyncRepConfigData */
+#define SYNC_REP_PRIORITY		0
+#define SYNC_REP_QUORUM			1
+
+/*
+ * Parsed form of synchronous_standby_names, kept as the GUC's "extra" data.
+ * member_names holds nmembers null-terminated names stored back to back.
+ */
+typedef struct SyncRepConfigData
+{
+	int			config_size;	/* total size of this struct, in bytes */
+	int			num_sync;		/* number of sync standbys to wait for */
+	uint8		syncrep_method;	/* SYNC_REP_PRIORITY or SYNC_REP_QUORUM */
+	int			nmembers;		/* number of names in member_names */
+	char		member_names[FLEXIBLE_ARRAY_MEMBER];
+} SyncRepConfigData;
+
 /* user-settable parameters for synchronous replication */
 extern char *SyncRepStandbyNames;
+extern SyncRepConfigData *SyncRepConfig;
 
 /* called by user backend */
 extern void SyncRepWaitForLSN(XLogRecPtr XactCommitLSN);
@@ -47,11 +67,11 @@ extern void SyncRepReleaseWaiters(void);
 /* called by checkpointer */
 extern void SyncRepUpdateSyncStandbysDefined(void);
 
-/* forward declaration to avoid pulling in walsender_private.h */
-struct WalSnd;
-extern struct WalSnd *SyncRepGetSynchronousStandby(void);
+/* called by wal sender and user backend */
+extern List *SyncRepGetSyncStandbys(bool *am_sync);
 
 extern bool check_synchronous_standby_names(char **newval, void **extra, GucSource source);
+extern void assign_synchronous_standby_names(const char *newval, void *extra);
 extern void assign_synchronous_commit(int newval, void *extra);
 
 #endif   /* _SYNCREP_H */
@@ -111,10 +111,16 @@ typedef struct
 
 	slock_t		mutex;			/* locks shared variables shown above */
 
+	/*
+	 * force walreceiver reply?  This doesn't need to be locked; memory
+	 * barriers for ordering are sufficient.
+	 */
+	bool		force_reply;
+
 	/*
 	 * Latch used by startup process to wake up walreceiver after telling it
 	 * where to start streaming (after setting receiveStart and
-	 * receiveStartTLI).
+	 * receiveStartTLI), or to make it send a reply promptly.
 	 */
 	Latch		latch;
 } WalRcvData;
@@ -146,8 +152,16 @@ extern PGDLLIMPORT walrcv_send_type walrcv_send;
 typedef void (*walrcv_disconnect_type) (void);
 extern PGDLLIMPORT walrcv_disconnect_type walrcv_disconnect;
 
+/* Used by logical replication apply workers */
+typedef void (*walrcv_connect_logical_type) (char *conninfo, char *appname);
+extern PGDLLIMPORT walrcv_connect_logical_type walrcv_connect_logical;
+
+typedef void (*walrcv_startstreaming_logical_type) (char *slotname, XLogRecPtr startpoint, char *options);
+extern PGDLLIMPORT walrcv_startstreaming_logical_type walrcv_startstreaming_logical;
+
 /* prototypes for functions in walreceiver.c */
 extern void WalReceiverMain(void) pg_attribute_noreturn();
+extern void WalRcvForceReply(void);
 
 /* prototypes for functions in walreceiverfuncs.c */
 extern Size WalRcvShmemSize(void);
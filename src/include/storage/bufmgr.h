@@ -22,6 +22,9 @@
 
 typedef void *Block;
 
+/* avoid including smgr.h here */
+struct SMgrRelationData;
+
 /* Possible arguments for GetAccessStrategy() */
 typedef enum BufferAccessStrategyType
 {
@@ -146,6 +149,8 @@ extern PGDLLIMPORT int32 *LocalRefCount;
  */
 extern void PrefetchBuffer(Relation reln, ForkNumber forkNum,
 			   BlockNumber blockNum);
+extern bool PrefetchSharedBuffer(struct SMgrRelationData *smgr_reln, ForkNumber forkNum,
+					 BlockNumber blockNum);
 extern Buffer ReadBuffer(Relation reln, BlockNumber blockNum);
 extern Buffer ReadBufferExtended(Relation reln, ForkNumber forkNum,
 				   BlockNumber blockNum, ReadBufferMode mode,
@@ -113,6 +113,8 @@ extern void DisownLatch(volatile Latch *latch);
 extern int	WaitLatch(volatile Latch *latch, int wakeEvents, long timeout);
 extern int WaitLatchOrSocket(volatile Latch *latch, int wakeEvents,
 				  pgsocket sock, long timeout);
+extern int WaitLatchOrSockets(volatile Latch *latch, int wakeEvents,
+				   pgsocket *socks, bool *ready, int nsocks, long timeout);
 extern void SetLatch(volatile Latch *latch);
 extern void ResetLatch(volatile Latch *latch);
 
@@ -135,8 +135,9 @@ extern PGDLLIMPORT LWLockPadded *MainLWLockArray;
 #define CommitTsControlLock			(&MainLWLockArray[38].lock)
 #define CommitTsLock				(&MainLWLockArray[39].lock)
 #define ReplicationOriginLock		(&MainLWLockArray[40].lock)
+#define PlanCacheStatsLock			(&MainLWLockArray[41].lock)
 
-#define NUM_INDIVIDUAL_LWLOCKS		41
+#define NUM_INDIVIDUAL_LWLOCKS		42
 
 /*
  * It's a bit odd to declare NUM_BUFFER_PARTITIONS and NUM_LOCK_PARTITIONS
@@ -155,14 +156,26 @@ extern PGDLLIMPORT LWLockPadded *MainLWLockArray;
 #define LOG2_NUM_PREDICATELOCK_PARTITIONS  4
 #define NUM_PREDICATELOCK_PARTITIONS  (1 << LOG2_NUM_PREDICATELOCK_PARTITIONS)
 
+/* Number of partitions the shared statistics hash tables are divided into */
+#define LOG2_NUM_PGSTAT_PARTITIONS  4
+#define NUM_PGSTAT_PARTITIONS  (1 << LOG2_NUM_PGSTAT_PARTITIONS)
+
+/* Number of partitions the shared catalog cache is divided into */
+#define LOG2_NUM_SHARED_CATCACHE_PARTITIONS  4
+#define NUM_SHARED_CATCACHE_PARTITIONS  (1 << LOG2_NUM_SHARED_CATCACHE_PARTITIONS)
+
 /* Offsets for various chunks of preallocated lwlocks. */
 #define BUFFER_MAPPING_LWLOCK_OFFSET	NUM_INDIVIDUAL_LWLOCKS
 #define LOCK_MANAGER_LWLOCK_OFFSET		\
 	(BUFFER_MAPPING_LWLOCK_OFFSET + NUM_BUFFER_PARTITIONS)
 #define PREDICATELOCK_MANAGER_LWLOCK_OFFSET \
 	(LOCK_MANAGER_LWLOCK_OFFSET + NUM_LOCK_PARTITIONS)
-#define NUM_FIXED_LWLOCKS \
+#define PGSTAT_LWLOCK_OFFSET	\
 	(PREDICATELOCK_MANAGER_LWLOCK_OFFSET + NUM_PREDICATELOCK_PARTITIONS)
+#define SHARED_CATCACHE_LWLOCK_OFFSET	\
+	(PGSTAT_LWLOCK_OFFSET + NUM_PGSTAT_PARTITIONS)
+#define NUM_FIXED_LWLOCKS \
+	(SHARED_CATCACHE_LWLOCK_OFFSET + NUM_SHARED_CATCACHE_PARTITIONS)
 
 typedef enum LWLockMode
 {
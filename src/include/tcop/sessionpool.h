@@ -0,0 +1,51 @@
+/*-------------------------------------------------------------------------
+ *
+ * sessionpool.h
+ *	  Transaction-level pooling of client sessions onto shared backends.
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/tcop/sessionpool.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef SESSIONPOOL_H
+#define SESSIONPOOL_H
+
+#include <signal.h>
+
+#include "fmgr.h"
+#include "utils/guc.h"
+#include "utils/plancache.h"
+
+/* Directory, relative to the data directory, for handoff sockets */
+#define SESSION_POOL_DIR	"pg_session_pool"
+
+/* GUC variables */
+extern int	session_pool_size;
+extern int	max_pooled_sessions;
+extern bool session_pooling;
+
+/* Is this a pooled backend, serving possibly many client sessions? */
+extern bool am_pooled_backend;
+
+extern Size SessionPoolShmemSize(void);
+extern void SessionPoolShmemInit(void);
+extern void SessionPoolInitDirectory(void);
+
+extern void SessionPoolAttach(void);
+extern bool SessionPoolSchedule(CachedPlanSource **unnamed_stmt,
+					bool can_switch, volatile sig_atomic_t *reload_pending);
+extern bool SessionPoolCloseSession(CachedPlanSource **unnamed_stmt);
+extern void SessionPoolConnectionLost(void);
+
+extern bool SessionPoolSignalCancel(int backendPID, long cancelAuthCode);
+extern bool SessionPoolCancelApplies(void);
+
+extern bool check_session_pool_size(int *newval, void **extra,
+						GucSource source);
+
+extern Datum pg_stat_get_session_pool(PG_FUNCTION_ARGS);
+
+#endif   /* SESSIONPOOL_H */
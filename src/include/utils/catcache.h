@@ -52,7 +52,7 @@ typedef struct catcache
 												 * heap scans */
 	bool		cc_isname[CATCACHE_MAXKEYS];	/* flag "name" key columns */
 	dlist_head	cc_lists;		/* list of CatCList structs */
-#ifdef CATCACHE_STATS
+	Size		cc_size;		/* memory used by tuples in this cache */
 	long		cc_searches;	/* total # searches against this cache */
 	long		cc_hits;		/* # of matches against existing entry */
 	long		cc_neg_hits;	/* # of matches against negative entry */
@@ -65,7 +65,7 @@ typedef struct catcache
 	long		cc_invals;		/* # of entries invalidated from cache */
 	long		cc_lsearches;	/* total # list-searches */
 	long		cc_lhits;		/* # of matches against existing lists */
-#endif
+	long		cc_evictions;	/* # of entries evicted to stay in budget */
 	dlist_head *cc_bucket;		/* hash buckets */
 } CatCache;
 
@@ -83,6 +83,13 @@ typedef struct catctup
 	 */
 	dlist_node	cache_elem;		/* list member of per-bucket list */
 
+	/*
+	 * All tuples of all caches are also members of a global dlist in LRU
+	 * order, most recently used last, from which unreferenced tuples are
+	 * evicted when the caches exceed catalog_cache_memory_limit.
+	 */
+	dlist_node	lru_elem;		/* list member of global LRU list */
+
 	/*
 	 * The tuple may also be a member of at most one CatCList.  (If a single
 	 * catcache is list-searched with varying numbers of keys, we may have to
@@ -155,8 +162,13 @@ typedef struct catcacheheader
 {
 	slist_head	ch_caches;		/* head of list of CatCache structs */
 	int			ch_ntup;		/* # of tuples in all caches */
+	Size		ch_size;		/* memory used by tuples in all caches */
+	dlist_head	ch_lru;			/* all tuples, least recently used first */
 } CatCacheHeader;
 
+/* GUC parameter */
+extern int	catalog_cache_memory_limit;
+
 
 /* this extern duplicates utils/memutils.h... */
 extern PGDLLIMPORT MemoryContext CacheMemoryContext;
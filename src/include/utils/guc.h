@@ -382,6 +382,12 @@ extern Size EstimateGUCStateSpace(void);
 extern void SerializeGUCState(Size maxsize, char *start_address);
 extern void RestoreGUCState(void *gucstate);
 
+/* Session pooling support */
+extern void CaptureGUCBaseline(void);
+extern char *SaveSessionGUCState(Size *len, bool *poolable);
+extern void ResetSessionGUCState(void);
+extern void RestoreSessionGUCState(char *state, Size len);
+
 /* Support for messages reported from GUC check hooks */
 
 extern PGDLLIMPORT char *GUC_check_errmsg_string;
@@ -17,6 +17,7 @@
 
 #include "access/tupdesc.h"
 #include "nodes/params.h"
+#include "portability/instr_time.h"
 
 #define CACHEDPLANSOURCE_MAGIC		195726186
 #define CACHEDPLAN_MAGIC			953717834
@@ -109,6 +110,10 @@ typedef struct CachedPlanSource
 	double		generic_cost;	/* cost of generic plan, or -1 if not known */
 	double		total_custom_cost;		/* total cost of custom plans so far */
 	int			num_custom_plans;		/* number of plans included in total */
+	uint32		num_plan_choices;		/* number of plans handed out so far */
+	bool		choice_stats_valid;		/* has choice_stats been looked up? */
+	Oid			choice_stats_user;		/* ... and for which role */
+	struct PlanChoiceStats *choice_stats;	/* shared statistics, or NULL */
 	bool		hasRowSecurity; /* planned with row security? */
 	int			row_security_env;		/* row security setting when planned */
 	bool		rowSecurityDisabled;	/* is row security disabled? */
@@ -137,9 +142,21 @@ typedef struct CachedPlan
 	int			generation;		/* parent's generation number for this plan */
 	int			refcount;		/* count of live references to this struct */
 	MemoryContext context;		/* context containing this CachedPlan */
+	/* Execution timing fed back into the parent's shared choice statistics: */
+	bool		is_custom;		/* built for specific parameter values? */
+	struct PlanChoiceStats *choice_stats;	/* where to report the timed use,
+											 * or NULL if none is going on */
+	instr_time	run_time;		/* planning and executor time of timed use */
+	bool		has_run;		/* has the timed use reached the executor? */
 } CachedPlan;
 
+/* GUC parameters */
+extern bool plan_cache_adaptive;
+extern int	plan_cache_shared_entries;
 
+
+extern Size PlanCacheShmemSize(void);
+extern void PlanCacheShmemInit(void);
 extern void InitPlanCache(void);
 extern void ResetPlanCache(void);
 
@@ -175,5 +192,6 @@ extern CachedPlan *GetCachedPlan(CachedPlanSource *plansource,
 			  ParamListInfo boundParams,
 			  bool useResOwner);
 extern void ReleaseCachedPlan(CachedPlan *plan, bool useResOwner);
+extern void CachedPlanAddRunTime(CachedPlan *plan, instr_time start);
 
 #endif   /* PLANCACHE_H */
@@ -112,11 +112,31 @@ typedef struct RelationData
 	Oid			rd_oidindex;	/* OID of unique index on OID, if any */
 	Oid			rd_replidindex; /* OID of replica identity index, if any */
 
+	/* data managed by RelationGetStatExtList: */
+	List	   *rd_statlist;	/* list of OIDs of extended stats */
+	bool		rd_statvalid;	/* is rd_statlist valid? */
+
 	/* data managed by RelationGetIndexAttrBitmap: */
 	Bitmapset  *rd_indexattr;	/* identifies columns used in indexes */
 	Bitmapset  *rd_keyattr;		/* cols that can be ref'd by foreign keys */
 	Bitmapset  *rd_idattr;		/* included in replica identity index */
 
+	/*
+	 * Declarative partitioning info, built on demand by partition.c (see
+	 * RelationGetPartitionKey, RelationGetPartitionDesc and
+	 * RelationGetPartitionQual).  It all lives in rd_partcxt.
+	 */
+	MemoryContext rd_partcxt;	/* private memory cxt for partitioning info */
+	bool		rd_partkeyvalid;	/* is rd_partkey valid? */
+	bool		rd_partcheckvalid;	/* is rd_partcheck valid? */
+	/* use "struct" here to avoid needing to include partition.h: */
+	struct PartitionKeyData *rd_partkey;	/* partition key, or NULL if the
+											 * rel is not partitioned */
+	struct PartitionDescData *rd_partdesc;	/* partitions, or NULL if not
+											 * yet built */
+	List	   *rd_partcheck;	/* partition constraint, if rel is a
+								 * partition */
+
 	/*
 	 * rd_options is set whenever rd_rel is loaded into the relcache entry.
 	 * Note that you can NOT look into rd_rel for this data.  NULL means "use
@@ -350,6 +370,21 @@ typedef struct ViewOptions
  */
 #define RelationGetNumberOfAttributes(relation) ((relation)->rd_rel->relnatts)
 
+/*
+ * IndexRelationGetNumberOfAttributes
+ *		Returns the number of attributes in an index, including any
+ *		included (non-key) columns.
+ */
+#define IndexRelationGetNumberOfAttributes(relation) \
+	((relation)->rd_index->indnatts)
+
+/*
+ * IndexRelationGetNumberOfKeyAttributes
+ *		Returns the number of key attributes in an index.
+ */
+#define IndexRelationGetNumberOfKeyAttributes(relation) \
+	((relation)->rd_index->indnkeyatts)
+
 /*
  * RelationGetDescr
  *		Returns tuple descriptor for a relation.
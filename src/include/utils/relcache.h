@@ -38,6 +38,7 @@ extern void RelationClose(Relation relation);
  * Routines to compute/retrieve additional cached information
  */
 extern List *RelationGetIndexList(Relation relation);
+extern List *RelationGetStatExtList(Relation relation);
 extern Oid	RelationGetOidIndex(Relation relation);
 extern Oid	RelationGetReplicaIndex(Relation relation);
 extern List *RelationGetIndexExpressions(Relation relation);
@@ -113,6 +114,22 @@ extern void AtEOXact_RelationCache(bool isCommit);
 extern void AtEOSubXact_RelationCache(bool isCommit, SubTransactionId mySubid,
 						  SubTransactionId parentSubid);
 
+/*
+ * Relation cache statistics, reported by pg_stat_syscache
+ */
+typedef struct RelationCacheStats
+{
+	int			entries;		/* # of relations in cache */
+	Size		size;			/* estimated memory used by them */
+	long		searches;		/* # of RelationIdGetRelation calls */
+	long		hits;			/* # of them finding an existing entry */
+	long		loads;			/* # of entries built from the catalogs */
+	long		invals;			/* # of invalidation events for entries */
+	long		evictions;		/* # of entries evicted to stay in budget */
+} RelationCacheStats;
+
+extern void GetRelationCacheStats(RelationCacheStats *stats);
+
 /*
  * Routines to help manage rebuilding of relcache init files
  */
@@ -121,6 +138,9 @@ extern void RelationCacheInitFilePreInvalidate(void);
 extern void RelationCacheInitFilePostInvalidate(void);
 extern void RelationCacheInitFileRemove(void);
 
+/* GUC parameter */
+extern int	relation_cache_memory_limit;
+
 /* should be used only by relcache.c and catcache.c */
 extern bool criticalRelcachesBuilt;
 
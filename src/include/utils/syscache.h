@@ -72,6 +72,8 @@ enum SysCacheIdentifier
 	OPEROID,
 	OPFAMILYAMNAMENSP,
 	OPFAMILYOID,
+	PARTITIONRELID,
+	PARTRELID,
 	PROCNAMEARGSNSP,
 	PROCOID,
 	RANGETYPE,
@@ -80,6 +82,8 @@ enum SysCacheIdentifier
 	REPLORIGIDENT,
 	REPLORIGNAME,
 	RULERELNAME,
+	STATEXTNAMENSP,
+	STATEXTOID,
 	STATRELATTINH,
 	TABLESAMPLEMETHODNAME,
 	TABLESAMPLEMETHODOID,
@@ -0,0 +1,45 @@
+--
+-- With max_stats_entries at its minimum, the shared statistics hash tables
+-- fill up at once.  Counts for objects that don't fit are dropped, and that
+-- is logged, but it must not cause any errors.
+--
+SHOW max_stats_entries;
+
+DO $$
+BEGIN
+  FOR i IN 1..200 LOOP
+    EXECUTE format('CREATE TABLE stats_full_tab_%s (a int)', i);
+    EXECUTE format('INSERT INTO stats_full_tab_%s VALUES (1)', i);
+    EXECUTE format('CREATE FUNCTION stats_full_func_%s() RETURNS int '
+                   'AS ''BEGIN RETURN 1; END'' LANGUAGE plpgsql', i);
+    EXECUTE format('SELECT stats_full_func_%s()', i);
+  END LOOP;
+END
+$$;
+
+-- wait for the counts to be flushed
+SELECT pg_sleep(1.0);
+
+-- some of the counts went missing
+SELECT count(*) < 200 AS tables_dropped
+  FROM pg_stat_user_tables
+  WHERE relname LIKE 'stats\_full\_tab\_%' AND n_tup_ins > 0;
+SELECT count(*) < 200 AS functions_dropped
+  FROM pg_stat_user_functions
+  WHERE funcname LIKE 'stats\_full\_func\_%';
+
+-- but nothing else did
+SELECT count(*) FROM stats_full_tab_1;
+SELECT stats_full_func_200();
+
+-- dropping objects that have no entries is fine too
+DO $$
+BEGIN
+  FOR i IN 1..200 LOOP
+    EXECUTE format('DROP TABLE stats_full_tab_%s', i);
+    EXECUTE format('DROP FUNCTION stats_full_func_%s()', i);
+  END LOOP;
+END
+$$;
+SELECT pg_stat_clear_snapshot();
+SELECT count(*) FROM pg_stat_user_tables WHERE relname LIKE 'stats\_full\_tab\_%';
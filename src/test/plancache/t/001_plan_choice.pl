@@ -0,0 +1,117 @@
+# Test the choice between custom and generic plans of prepared statements.
+#
+# A prepared query calls an immutable function, slow(), which counts its
+# calls and takes a while.  A custom plan calls it once, when it is planned;
+# a generic one once per row, when it is run.  The number of calls thus
+# tells which kind of plan a run used, and makes generic plans much slower
+# than their estimated cost suggests.
+use strict;
+use warnings;
+
+use TestLib;
+use Test::More tests => 5;
+
+use IPC::Run qw(run);
+
+my $tempdir       = tempdir;
+my $tempdir_short = tempdir_short;
+
+my $datadir = "$tempdir/data";
+my $logfile = "$tempdir/server.log";
+my $port    = $ENV{PGPORT};
+
+$ENV{PGHOST}     = $tempdir_short;
+$ENV{PGPORT}     = $port;
+$ENV{PGDATABASE} = "postgres";
+
+# Run some SQL in a new session, returning its output.
+sub query_result
+{
+	my ($sql) = @_;
+	my ($stdout, $stderr);
+
+	run [ 'psql', '-X', '-A', '-t', '-q', '-v', 'ON_ERROR_STOP=1', '-f',
+		'-' ], '<', \$sql, '>', \$stdout, '2>', \$stderr
+	  or BAIL_OUT("psql failed: $stderr");
+	chomp($stdout);
+	return $stdout;
+}
+
+# Prepare the query in a new session, after the given settings, and run it
+# a number of times.  Returns the number of calls of slow() by each run.
+sub plan_calls
+{
+	my ($settings, $runs) = @_;
+	my $sql = qq{$settings
+SET pc.calls = 0;
+PREPARE pc_query(int) AS SELECT count(*) FROM pc_tab WHERE a = slow(\$1);
+};
+
+	$sql .= qq{EXECUTE pc_query(1);
+SELECT current_setting('pc.calls');
+SET pc.calls = 0;
+} x $runs;
+
+	my @lines = split /\n/, query_result($sql);
+	return join ' ', @lines[ grep { $_ % 2 == 1 } 0 .. $#lines ];
+}
+
+# Don't leave the server behind if a test bails out.
+END
+{
+	system('pg_ctl', '-D', $datadir, '-s', '-m', 'immediate', 'stop')
+	  if -e "$datadir/postmaster.pid";
+}
+
+standard_initdb($datadir);
+system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-l', $logfile, '-o',
+	"-k $tempdir_short --listen-addresses='' -p $port", 'start');
+
+query_result(
+	q{
+CREATE FUNCTION slow(x int) RETURNS int
+LANGUAGE plpgsql IMMUTABLE COST 1 AS $$
+BEGIN
+    PERFORM set_config('pc.calls',
+                       (current_setting('pc.calls')::int + 1)::text, false);
+    PERFORM pg_sleep(0.005);
+    RETURN x;
+END;
+$$;
+CREATE SCHEMA pc1;
+CREATE TABLE pc1.pc_tab (a int);
+INSERT INTO pc1.pc_tab SELECT generate_series(1, 20);
+ANALYZE pc1.pc_tab;
+CREATE SCHEMA pc2;
+CREATE TABLE pc2.pc_tab AS SELECT * FROM pc1.pc_tab;
+ANALYZE pc2.pc_tab;
+CREATE ROLE regress_pc_role;
+GRANT USAGE ON SCHEMA pc1 TO regress_pc_role;
+GRANT SELECT ON pc1.pc_tab TO regress_pc_role;
+});
+
+# By estimated costs alone, which is the default, the generic plan wins
+# once five custom plans have been made; another session can then use it
+# right away.
+is(plan_calls('SET search_path = pc1, public;', 6),
+	'1 1 1 1 1 20', 'generic plan used after five custom plans');
+is(plan_calls('SET search_path = pc1, public;', 1),
+	'20', 'custom plans of other sessions are taken into account');
+
+# The same query text under another search_path or role is another query.
+is(plan_calls('SET search_path = pc2, public;', 1),
+	'1', 'plan choice statistics are kept per search_path');
+is( plan_calls(
+		'SET search_path = pc1, public; SET ROLE regress_pc_role;',
+		1),
+	'1',
+	'plan choice statistics are kept per role');
+
+# With measured run times, the generic plan is given up once it has been
+# run often enough to be found much slower than the custom ones.
+is( plan_calls(
+		'SET plan_cache_adaptive = on; SET search_path = pc1, pc2, public;',
+		10),
+	'1 1 1 1 1 20 20 20 1 1', 'custom plans used when found faster');
+
+system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-m', 'fast', 'stop');
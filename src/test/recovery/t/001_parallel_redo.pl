@@ -0,0 +1,252 @@
+# Test parallel redo (recovery_workers) on a hot standby and in crash
+# recovery.
+#
+# A master server runs a workload of inserts, updates and deletes on tables
+# with indexes, while a standby replays it with redo workers.  Once the
+# standby has caught up, queries on it, including index-only scans, have to
+# return the same results as on the master.  The master is then crashed and
+# has to come back with the same data, replayed by its own redo workers.
+use strict;
+use warnings;
+
+use TestLib;
+use Test::More tests => 8;
+
+use IPC::Run qw(run);
+
+my $tempdir       = tempdir;
+my $tempdir_short = tempdir_short;
+
+my $master_datadir  = "$tempdir/data_master";
+my $standby_datadir = "$tempdir/data_standby";
+my $master_log      = "$tempdir/master.log";
+my $standby_log     = "$tempdir/standby.log";
+
+my $port_master  = $ENV{PGPORT};
+my $port_standby = $port_master + 1;
+
+my $connstr_master  = "port=$port_master";
+my $connstr_standby = "port=$port_standby";
+
+$ENV{PGHOST}     = $tempdir_short;
+$ENV{PGDATABASE} = "postgres";
+
+sub append_to_file
+{
+	my ($filename, $str) = @_;
+
+	open my $fh, ">>", $filename or die "could not open file $filename";
+	print $fh $str;
+	close $fh;
+}
+
+sub slurp_file
+{
+	my ($filename) = @_;
+	local $/;
+
+	open my $fh, "<", $filename or die "could not open file $filename";
+	my $contents = <$fh>;
+	close $fh;
+	return $contents;
+}
+
+sub start_server
+{
+	my ($datadir, $port, $logfile) = @_;
+
+	system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-l', $logfile,
+		'-o', "-k $tempdir_short --listen-addresses='' -p $port", 'start');
+}
+
+sub stop_server
+{
+	my ($datadir, $mode) = @_;
+
+	system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-m', $mode,
+		'stop');
+}
+
+sub run_sql
+{
+	my ($connstr, $sql) = @_;
+
+	system_or_bail('psql', '-q', '--no-psqlrc', '-d', $connstr, '-c', $sql);
+}
+
+# Run a query and return its output, unaligned and without headers.
+sub query_result
+{
+	my ($connstr, $query) = @_;
+	my ($stdout, $stderr);
+
+	run [ 'psql', '-q', '-A', '-t', '--no-psqlrc', '-d', $connstr, '-c',
+		$query ], '>', \$stdout, '2>', \$stderr
+	  or BAIL_OUT("psql failed: $stderr");
+	return $stdout;
+}
+
+# Run a query once a second, until it returns 't' (i.e. SQL boolean true).
+sub poll_query_until
+{
+	my ($query, $connstr) = @_;
+
+	my $max_attempts = 30;
+	my $attempts     = 0;
+	my ($stdout, $stderr);
+
+	while ($attempts < $max_attempts)
+	{
+		my $cmd = [ 'psql', '-At', '-c', "$query", '-d', "$connstr" ];
+		my $result = run $cmd, '>', \$stdout, '2>', \$stderr;
+
+		chomp($stdout);
+		if ($stdout eq "t")
+		{
+			return 1;
+		}
+
+		# Wait a second before retrying.
+		sleep 1;
+		$attempts++;
+	}
+
+	diag $stderr;
+	return 0;
+}
+
+# Compare the result of a query on the master and the standby.
+sub check_standby_query
+{
+	my ($query, $test_name) = @_;
+
+	is(query_result($connstr_standby, $query),
+		query_result($connstr_master, $query), $test_name);
+}
+
+# Don't leave the servers behind if a test bails out.
+END
+{
+	foreach my $datadir ($master_datadir, $standby_datadir)
+	{
+		system('pg_ctl', '-D', $datadir, '-s', '-m', 'immediate', 'stop')
+		  if -e "$datadir/postmaster.pid";
+	}
+}
+
+# Set up the master.
+standard_initdb($master_datadir);
+append_to_file(
+	"$master_datadir/postgresql.conf", qq(
+wal_level = hot_standby
+max_wal_senders = 2
+wal_keep_segments = 20
+hot_standby = on
+autovacuum = off
+max_connections = 10
+max_worker_processes = 4
+recovery_workers = 2
+));
+append_to_file("$master_datadir/pg_hba.conf", qq(
+local replication all trust
+));
+start_server($master_datadir, $port_master, $master_log);
+
+# Tables with indexes, with all-visible pages on the standby to begin with.
+run_sql(
+	$connstr_master, q{
+CREATE TABLE redo_tab1 (a int PRIMARY KEY, b int, c text);
+CREATE INDEX redo_tab1_b ON redo_tab1 (b);
+CREATE TABLE redo_tab2 (a int PRIMARY KEY, b int);
+INSERT INTO redo_tab1
+  SELECT i, i % 100, repeat('x', i % 50) FROM generate_series(1, 10000) i;
+INSERT INTO redo_tab2 SELECT i, i FROM generate_series(1, 10000) i;
+});
+run_sql($connstr_master, 'VACUUM redo_tab1');
+run_sql($connstr_master, 'VACUUM redo_tab2');
+
+# Set up the standby, replaying with two workers.
+system_or_bail('pg_basebackup', '-D', $standby_datadir, '-p', $port_master,
+	'-x');
+append_to_file(
+	"$standby_datadir/recovery.conf", qq(
+primary_conninfo='$connstr_master application_name=standby'
+standby_mode=on
+recovery_target_timeline='latest'
+));
+start_server($standby_datadir, $port_standby, $standby_log);
+
+like(slurp_file($standby_log), qr/parallel redo started with 2 workers/,
+	'standby replays with redo workers');
+
+# The workload: the first UPDATE and DELETE clear visibility map bits of
+# pages whose new index entries are replayed by other workers.
+run_sql(
+	$connstr_master, q{
+UPDATE redo_tab1 SET b = b + 1000 WHERE a % 3 = 0;
+DELETE FROM redo_tab1 WHERE a % 7 = 0;
+INSERT INTO redo_tab1
+  SELECT i, i % 100, repeat('y', i % 50) FROM generate_series(10001, 20000) i;
+UPDATE redo_tab2 SET b = -b WHERE a % 5 = 0;
+INSERT INTO redo_tab2 SELECT i, i FROM generate_series(10001, 12000) i;
+CREATE TABLE redo_tab3 AS SELECT * FROM redo_tab1 WHERE a % 2 = 0;
+CREATE INDEX redo_tab3_b ON redo_tab3 (b);
+TRUNCATE redo_tab2;
+INSERT INTO redo_tab2 SELECT i, i * 2 FROM generate_series(1, 5000) i;
+});
+run_sql($connstr_master, 'VACUUM redo_tab1');
+run_sql($connstr_master, 'VACUUM redo_tab2');
+run_sql($connstr_master, 'VACUUM redo_tab3');
+run_sql($connstr_master, 'DELETE FROM redo_tab3 WHERE b > 1000');
+
+my $caughtup_query =
+"SELECT pg_current_xlog_location() = replay_location FROM pg_stat_replication WHERE application_name = 'standby';";
+poll_query_until($caughtup_query, $connstr_master)
+  or die "Timed out while waiting for standby to catch up";
+
+check_standby_query('SELECT count(*), sum(a), sum(b) FROM redo_tab1',
+	'heap contents match on standby');
+check_standby_query(
+	q{SET enable_seqscan = off; SET enable_bitmapscan = off;
+	  SELECT count(*), sum(b) FROM redo_tab1 WHERE b >= 0},
+	'index-only scan results match on standby');
+check_standby_query('SELECT count(*), sum(a), sum(b) FROM redo_tab2',
+	'truncated table matches on standby');
+check_standby_query(
+	q{SET enable_seqscan = off; SET enable_bitmapscan = off;
+	  SELECT count(*), sum(b) FROM redo_tab3 WHERE b >= 0},
+	'new table and index match on standby');
+
+# recovery_workers is capped at max_worker_processes.
+stop_server($standby_datadir, 'fast');
+append_to_file("$standby_datadir/postgresql.conf", qq(
+recovery_workers = 10
+));
+start_server($standby_datadir, $port_standby, $standby_log);
+like(
+	slurp_file($standby_log),
+	qr/recovery_workers \(10\) exceeds max_worker_processes \(4\)/,
+	'recovery_workers is capped at max_worker_processes');
+stop_server($standby_datadir, 'fast');
+
+# Crash the master in the middle of a workload, and let it recover.
+run_sql(
+	$connstr_master, q{
+CHECKPOINT;
+UPDATE redo_tab1 SET c = 'z' WHERE a % 11 = 0;
+DELETE FROM redo_tab2 WHERE a % 3 = 0;
+INSERT INTO redo_tab3 SELECT * FROM redo_tab1 WHERE a % 13 = 0;
+});
+my $crash_query =
+    'SELECT (SELECT sum(length(c)) FROM redo_tab1), '
+  . '(SELECT sum(b) FROM redo_tab2), (SELECT sum(a) FROM redo_tab3)';
+my $expected = query_result($connstr_master, $crash_query);
+stop_server($master_datadir, 'immediate');
+start_server($master_datadir, $port_master, $master_log);
+
+like(slurp_file($master_log), qr/parallel redo started with 2 workers/,
+	'crash recovery replays with redo workers');
+is(query_result($connstr_master, $crash_query),
+	$expected, 'data matches after crash recovery');
+
+stop_server($master_datadir, 'fast');
@@ -0,0 +1,219 @@
+# Test prefetching of blocks referenced by WAL (recovery_prefetch_distance)
+# on a hot standby and in crash recovery.
+#
+# The master runs without full_page_writes, so that replay has to read the
+# blocks its records modify, and the standby has so few shared buffers that
+# most of them aren't cached.  Once the standby has caught up, its data has
+# to match the master's, and pg_stat_wal_prefetch has to show that blocks
+# were prefetched.  The master is then crashed and has to come back with the
+# same data, having prefetched during crash recovery too.
+use strict;
+use warnings;
+
+use TestLib;
+use Test::More tests => 6;
+
+use IPC::Run qw(run);
+
+my $tempdir       = tempdir;
+my $tempdir_short = tempdir_short;
+
+my $master_datadir  = "$tempdir/data_master";
+my $standby_datadir = "$tempdir/data_standby";
+my $master_log      = "$tempdir/master.log";
+my $standby_log     = "$tempdir/standby.log";
+
+my $port_master  = $ENV{PGPORT};
+my $port_standby = $port_master + 1;
+
+my $connstr_master  = "port=$port_master";
+my $connstr_standby = "port=$port_standby";
+
+$ENV{PGHOST}     = $tempdir_short;
+$ENV{PGDATABASE} = "postgres";
+
+sub append_to_file
+{
+	my ($filename, $str) = @_;
+
+	open my $fh, ">>", $filename or die "could not open file $filename";
+	print $fh $str;
+	close $fh;
+}
+
+sub start_server
+{
+	my ($datadir, $port, $logfile) = @_;
+
+	system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-l', $logfile,
+		'-o', "-k $tempdir_short --listen-addresses='' -p $port", 'start');
+}
+
+sub stop_server
+{
+	my ($datadir, $mode) = @_;
+
+	system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-m', $mode,
+		'stop');
+}
+
+sub run_sql
+{
+	my ($connstr, $sql) = @_;
+
+	system_or_bail('psql', '-q', '--no-psqlrc', '-d', $connstr, '-c', $sql);
+}
+
+# Run a query and return its output, unaligned and without headers.
+sub query_result
+{
+	my ($connstr, $query) = @_;
+	my ($stdout, $stderr);
+
+	run [ 'psql', '-q', '-A', '-t', '--no-psqlrc', '-d', $connstr, '-c',
+		$query ], '>', \$stdout, '2>', \$stderr
+	  or BAIL_OUT("psql failed: $stderr");
+	return $stdout;
+}
+
+# Run a query once a second, until it returns 't' (i.e. SQL boolean true).
+sub poll_query_until
+{
+	my ($query, $connstr) = @_;
+
+	my $max_attempts = 30;
+	my $attempts     = 0;
+	my ($stdout, $stderr);
+
+	while ($attempts < $max_attempts)
+	{
+		my $cmd = [ 'psql', '-At', '-c', "$query", '-d', "$connstr" ];
+		my $result = run $cmd, '>', \$stdout, '2>', \$stderr;
+
+		chomp($stdout);
+		if ($stdout eq "t")
+		{
+			return 1;
+		}
+
+		# Wait a second before retrying.
+		sleep 1;
+		$attempts++;
+	}
+
+	diag $stderr;
+	return 0;
+}
+
+# Compare the result of a query on the master and the standby.
+sub check_standby_query
+{
+	my ($query, $test_name) = @_;
+
+	is(query_result($connstr_standby, $query),
+		query_result($connstr_master, $query), $test_name);
+}
+
+# Don't leave the servers behind if a test bails out.
+END
+{
+	foreach my $datadir ($master_datadir, $standby_datadir)
+	{
+		system('pg_ctl', '-D', $datadir, '-s', '-m', 'immediate', 'stop')
+		  if -e "$datadir/postmaster.pid";
+	}
+}
+
+# Set up the master.  It prefetches too, for crash recovery.
+standard_initdb($master_datadir);
+append_to_file(
+	"$master_datadir/postgresql.conf", qq(
+wal_level = hot_standby
+max_wal_senders = 2
+wal_keep_segments = 20
+hot_standby = on
+full_page_writes = off
+autovacuum = off
+max_connections = 10
+recovery_prefetch_distance = 256kB
+));
+append_to_file("$master_datadir/pg_hba.conf", qq(
+local replication all trust
+));
+start_server($master_datadir, $port_master, $master_log);
+
+# A table much larger than the standby's shared buffers.
+run_sql(
+	$connstr_master, q{
+CREATE TABLE prefetch_tab (a int PRIMARY KEY, b int, c text);
+INSERT INTO prefetch_tab
+  SELECT i, i, repeat('x', 100) FROM generate_series(1, 20000) i;
+});
+run_sql($connstr_master, 'VACUUM prefetch_tab');
+
+# Set up the standby with the minimum of shared buffers.
+system_or_bail('pg_basebackup', '-D', $standby_datadir, '-p', $port_master,
+	'-x');
+append_to_file(
+	"$standby_datadir/postgresql.conf", qq(
+shared_buffers = 128kB
+));
+append_to_file(
+	"$standby_datadir/recovery.conf", qq(
+primary_conninfo='$connstr_master application_name=standby'
+standby_mode=on
+recovery_target_timeline='latest'
+));
+start_server($standby_datadir, $port_standby, $standby_log);
+
+# Updates scattered all over the table, and a new table, whose blocks
+# are initialized by redo rather than read.
+run_sql(
+	$connstr_master, q{
+UPDATE prefetch_tab SET b = -b WHERE a % 97 = 0;
+DELETE FROM prefetch_tab WHERE a % 101 = 0;
+UPDATE prefetch_tab SET c = 'y' WHERE a % 89 = 0;
+CREATE TABLE prefetch_tab2 AS SELECT a, b FROM prefetch_tab WHERE a % 2 = 0;
+UPDATE prefetch_tab SET b = b + 1 WHERE a % 83 = 0;
+});
+
+my $caughtup_query =
+"SELECT pg_current_xlog_location() = replay_location FROM pg_stat_replication WHERE application_name = 'standby';";
+poll_query_until($caughtup_query, $connstr_master)
+  or die "Timed out while waiting for standby to catch up";
+
+check_standby_query('SELECT count(*), sum(a), sum(b) FROM prefetch_tab',
+	'table contents match on standby');
+check_standby_query(
+	q{SET enable_seqscan = off; SET enable_bitmapscan = off;
+	  SELECT count(*), sum(b) FROM prefetch_tab WHERE a > 0},
+	'index scan results match on standby');
+check_standby_query('SELECT count(*), sum(b) FROM prefetch_tab2',
+	'new table matches on standby');
+
+is(query_result($connstr_standby,
+		'SELECT prefetch > 0, skip_init > 0 FROM pg_stat_wal_prefetch'),
+	"t|t\n", 'standby prefetched blocks');
+stop_server($standby_datadir, 'fast');
+
+# Crash the master after a workload, and let it recover.
+run_sql(
+	$connstr_master, q{
+CHECKPOINT;
+UPDATE prefetch_tab SET b = b * 2 WHERE a % 79 = 0;
+DELETE FROM prefetch_tab2 WHERE a % 3 = 0;
+});
+my $crash_query =
+    'SELECT (SELECT sum(b) FROM prefetch_tab), '
+  . '(SELECT sum(b) FROM prefetch_tab2)';
+my $expected = query_result($connstr_master, $crash_query);
+stop_server($master_datadir, 'immediate');
+start_server($master_datadir, $port_master, $master_log);
+
+is(query_result($connstr_master, $crash_query),
+	$expected, 'data matches after crash recovery');
+is(query_result($connstr_master,
+		'SELECT prefetch > 0 FROM pg_stat_wal_prefetch'),
+	"t\n", 'crash recovery prefetched blocks');
+
+stop_server($master_datadir, 'fast');
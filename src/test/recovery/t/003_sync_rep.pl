@@ -0,0 +1,220 @@
+# Test quorum-based and priority-based synchronous replication
+# (synchronous_standby_names = 'ANY n (...)' and 'FIRST n (...)').
+#
+# A master streams to three standbys.  For each setting, pg_stat_replication
+# has to show the expected sync_state of every standby, and commits have to
+# return once enough standbys have confirmed them, and wait otherwise.  A
+# waiting commit is released by canceling it, with a warning.
+use strict;
+use warnings;
+
+use TestLib;
+use Test::More tests => 11;
+
+use IPC::Run qw(run start);
+
+my $tempdir       = tempdir;
+my $tempdir_short = tempdir_short;
+
+my $master_datadir = "$tempdir/data_master";
+my $master_log     = "$tempdir/master.log";
+my $port_master    = $ENV{PGPORT};
+my $connstr_master = "port=$port_master";
+
+my @standby_datadirs = map { "$tempdir/data_standby$_" } (1 .. 3);
+
+$ENV{PGHOST}     = $tempdir_short;
+$ENV{PGDATABASE} = "postgres";
+
+sub append_to_file
+{
+	my ($filename, $str) = @_;
+
+	open my $fh, ">>", $filename or die "could not open file $filename";
+	print $fh $str;
+	close $fh;
+}
+
+sub start_server
+{
+	my ($datadir, $port, $logfile) = @_;
+
+	system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-l', $logfile,
+		'-o', "-k $tempdir_short --listen-addresses='' -p $port", 'start');
+}
+
+sub stop_server
+{
+	my ($datadir, $mode) = @_;
+
+	system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-m', $mode,
+		'stop');
+}
+
+sub run_sql
+{
+	my ($connstr, $sql) = @_;
+
+	system_or_bail('psql', '-q', '--no-psqlrc', '-d', $connstr, '-c', $sql);
+}
+
+# Run a query once a second, until it returns 't' (i.e. SQL boolean true).
+sub poll_query_until
+{
+	my ($query, $connstr) = @_;
+
+	my $max_attempts = 30;
+	my $attempts     = 0;
+	my ($stdout, $stderr);
+
+	while ($attempts < $max_attempts)
+	{
+		my $cmd = [ 'psql', '-At', '-c', "$query", '-d', "$connstr" ];
+		my $result = run $cmd, '>', \$stdout, '2>', \$stderr;
+
+		chomp($stdout);
+		if ($stdout eq "t")
+		{
+			return 1;
+		}
+
+		# Wait a second before retrying.
+		sleep 1;
+		$attempts++;
+	}
+
+	diag $stderr;
+	return 0;
+}
+
+sub start_standby
+{
+	my ($n) = @_;
+
+	start_server($standby_datadirs[ $n - 1 ],
+		$port_master + $n, "$tempdir/standby$n.log");
+}
+
+sub stop_standby
+{
+	my ($n) = @_;
+
+	stop_server($standby_datadirs[ $n - 1 ], 'fast');
+}
+
+# Set synchronous_standby_names, and wait until the walsenders show the
+# expected sync_state of each standby, like "standby1:sync,standby2:async".
+sub check_sync_state
+{
+	my ($standby_names, $expected, $test_name) = @_;
+
+	run_sql($connstr_master,
+		"ALTER SYSTEM SET synchronous_standby_names = '$standby_names'");
+	run_sql($connstr_master, 'SELECT pg_reload_conf()');
+	ok( poll_query_until(
+			"SELECT string_agg(application_name || ':' || sync_state, ',' "
+			  . "ORDER BY application_name) = '$expected' "
+			  . "FROM pg_stat_replication",
+			$connstr_master),
+		$test_name);
+}
+
+# Commit a transaction, and cancel its wait for the standbys after a few
+# seconds.  Returns true if the commit didn't have to be released that way.
+sub commit_released
+{
+	my $insert = 'INSERT INTO sync_tab VALUES (1)';
+	my ($stdout, $stderr);
+
+	my $h = start [ 'psql', '-q', '--no-psqlrc', '-d', $connstr_master, '-c',
+		$insert ], '>', \$stdout, '2>', \$stderr;
+	sleep 3;
+	run_sql($connstr_master,
+		"SELECT pg_cancel_backend(pid) FROM pg_stat_activity "
+		  . "WHERE query = '$insert' AND pid <> pg_backend_pid()");
+	$h->finish or BAIL_OUT("psql failed: $stderr");
+	return $stderr !~ /canceling wait for synchronous replication/;
+}
+
+# Don't leave the servers behind if a test bails out.
+END
+{
+	foreach my $datadir ($master_datadir, @standby_datadirs)
+	{
+		system('pg_ctl', '-D', $datadir, '-s', '-m', 'immediate', 'stop')
+		  if -e "$datadir/postmaster.pid";
+	}
+}
+
+# Set up the master and three standbys.
+standard_initdb($master_datadir);
+append_to_file(
+	"$master_datadir/postgresql.conf", qq(
+wal_level = hot_standby
+max_wal_senders = 4
+wal_keep_segments = 20
+hot_standby = on
+max_connections = 10
+));
+append_to_file("$master_datadir/pg_hba.conf", qq(
+local replication all trust
+));
+start_server($master_datadir, $port_master, $master_log);
+run_sql($connstr_master, 'CREATE TABLE sync_tab (a int)');
+
+foreach my $n (1 .. 3)
+{
+	system_or_bail('pg_basebackup', '-D', $standby_datadirs[ $n - 1 ],
+		'-p', $port_master, '-x');
+	append_to_file(
+		"$standby_datadirs[$n - 1]/recovery.conf", qq(
+primary_conninfo='$connstr_master application_name=standby$n'
+standby_mode=on
+));
+	start_standby($n);
+}
+
+# Quorum commit: any two of the three standbys.
+check_sync_state(
+	'ANY 2 (standby1, standby2, standby3)',
+	'standby1:quorum,standby2:quorum,standby3:quorum',
+	'all standbys are quorum candidates');
+ok(commit_released(), 'quorum commit with three standbys');
+
+stop_standby(1);
+ok(commit_released(), 'quorum commit with two standbys');
+
+stop_standby(2);
+ok(!commit_released(), 'quorum commit waits with one standby');
+
+start_standby(1);
+ok(commit_released(), 'quorum commit with two standbys again');
+
+# Priority commit: the first two connected standbys in the list.
+start_standby(2);
+check_sync_state(
+	'FIRST 2 (standby1, standby2, standby3)',
+	'standby1:sync,standby2:sync,standby3:potential',
+	'first two standbys are synchronous');
+ok(commit_released(), 'priority commit with three standbys');
+
+stop_standby(1);
+check_sync_state(
+	'FIRST 2 (standby1, standby2, standby3)',
+	'standby2:sync,standby3:sync',
+	'potential standby takes over');
+ok(commit_released(), 'priority commit after a standby went away');
+
+# The plain list form is the same as FIRST 1.
+start_standby(1);
+check_sync_state(
+	'standby3, standby2',
+	'standby1:async,standby2:potential,standby3:sync',
+	'plain list makes the first connected standby synchronous');
+
+stop_standby(3);
+ok(commit_released(), 'plain list commit after the synchronous standby went away');
+
+stop_standby(1);
+stop_standby(2);
+stop_server($master_datadir, 'fast');
@@ -0,0 +1,240 @@
+# Test that walsenders send the same WAL whether they copy it from the WAL
+# buffers or read it back from the segment files.
+#
+# The master has the minimum of WAL buffers.  One standby streams while the
+# workload runs, so it is sent WAL from the buffers, and from disk whenever
+# it falls behind.  Another standby only connects after the workload, so it
+# is sent all of that WAL from disk.  Both have to end up with the same data
+# as the master, and with segment files identical to the master's, byte for
+# byte.
+use strict;
+use warnings;
+
+use TestLib;
+use Test::More tests => 5;
+
+use IPC::Run qw(run);
+
+my $tempdir       = tempdir;
+my $tempdir_short = tempdir_short;
+
+my $master_datadir = "$tempdir/data_master";
+my $live_datadir   = "$tempdir/data_live";
+my $late_datadir   = "$tempdir/data_late";
+
+my $port_master = $ENV{PGPORT};
+my $port_live   = $port_master + 1;
+my $port_late   = $port_master + 2;
+
+my $connstr_master = "port=$port_master";
+my $connstr_live   = "port=$port_live";
+my $connstr_late   = "port=$port_late";
+
+$ENV{PGHOST}     = $tempdir_short;
+$ENV{PGDATABASE} = "postgres";
+
+sub append_to_file
+{
+	my ($filename, $str) = @_;
+
+	open my $fh, ">>", $filename or die "could not open file $filename";
+	print $fh $str;
+	close $fh;
+}
+
+sub slurp_file
+{
+	my ($filename) = @_;
+	local $/;
+
+	open my $fh, "<", $filename or die "could not open file $filename";
+	binmode $fh;
+	my $contents = <$fh>;
+	close $fh;
+	return $contents;
+}
+
+sub start_server
+{
+	my ($datadir, $port, $logfile) = @_;
+
+	system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-l', $logfile,
+		'-o', "-k $tempdir_short --listen-addresses='' -p $port", 'start');
+}
+
+sub stop_server
+{
+	my ($datadir, $mode) = @_;
+
+	system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-m', $mode,
+		'stop');
+}
+
+sub run_sql
+{
+	my ($connstr, $sql) = @_;
+
+	system_or_bail('psql', '-q', '--no-psqlrc', '-d', $connstr, '-c', $sql);
+}
+
+# Run a query and return its output, unaligned and without headers.
+sub query_result
+{
+	my ($connstr, $query) = @_;
+	my ($stdout, $stderr);
+
+	run [ 'psql', '-q', '-A', '-t', '--no-psqlrc', '-d', $connstr, '-c',
+		$query ], '>', \$stdout, '2>', \$stderr
+	  or BAIL_OUT("psql failed: $stderr");
+	return $stdout;
+}
+
+# Run a query once a second, until it returns 't' (i.e. SQL boolean true).
+sub poll_query_until
+{
+	my ($query, $connstr) = @_;
+
+	my $max_attempts = 30;
+	my $attempts     = 0;
+	my ($stdout, $stderr);
+
+	while ($attempts < $max_attempts)
+	{
+		my $cmd = [ 'psql', '-At', '-c', "$query", '-d', "$connstr" ];
+		my $result = run $cmd, '>', \$stdout, '2>', \$stderr;
+
+		chomp($stdout);
+		if ($stdout eq "t")
+		{
+			return 1;
+		}
+
+		# Wait a second before retrying.
+		sleep 1;
+		$attempts++;
+	}
+
+	diag $stderr;
+	return 0;
+}
+
+sub set_up_standby
+{
+	my ($datadir, $name) = @_;
+
+	system_or_bail('pg_basebackup', '-D', $datadir, '-p', $port_master,
+		'-x');
+	append_to_file(
+		"$datadir/recovery.conf", qq(
+primary_conninfo='$connstr_master application_name=$name'
+standby_mode=on
+));
+}
+
+# Compare the segment files of the standby with the master's, from the
+# first one given up to the master's current one, which isn't complete.
+# Returns the number of segments compared, or -1 if any of them differ or
+# are missing on the standby.
+sub compare_segments
+{
+	my ($datadir, $first, $current) = @_;
+	my $compared = 0;
+
+	opendir my $dh, "$master_datadir/pg_xlog" or die "could not open pg_xlog";
+	my @segments =
+	  grep { /^[0-9A-F]{24}$/ && $_ ge $first && $_ lt $current } readdir $dh;
+	closedir $dh;
+
+	foreach my $segment (sort @segments)
+	{
+		if (!-e "$datadir/pg_xlog/$segment"
+			|| slurp_file("$datadir/pg_xlog/$segment") ne
+			slurp_file("$master_datadir/pg_xlog/$segment"))
+		{
+			diag "segment $segment is missing or differs in $datadir";
+			return -1;
+		}
+		$compared++;
+	}
+	return $compared;
+}
+
+# Don't leave the servers behind if a test bails out.
+END
+{
+	foreach my $datadir ($master_datadir, $live_datadir, $late_datadir)
+	{
+		system('pg_ctl', '-D', $datadir, '-s', '-m', 'immediate', 'stop')
+		  if -e "$datadir/postmaster.pid";
+	}
+}
+
+# Set up the master, with WAL evicted from the buffers soon after it's
+# written, and keeping all the segments the test generates.
+standard_initdb($master_datadir);
+append_to_file(
+	"$master_datadir/postgresql.conf", qq(
+wal_level = hot_standby
+wal_buffers = 32kB
+max_wal_senders = 3
+wal_keep_segments = 32
+max_wal_size = 1GB
+hot_standby = on
+autovacuum = off
+max_connections = 10
+));
+append_to_file("$master_datadir/pg_hba.conf", qq(
+local replication all trust
+));
+start_server($master_datadir, $port_master, "$tempdir/master.log");
+
+set_up_standby($live_datadir, 'live');
+set_up_standby($late_datadir, 'late');
+start_server($live_datadir, $port_live, "$tempdir/live.log");
+
+# A workload spanning a few segments, while only the first standby is
+# connected.
+my $first = query_result($connstr_master,
+	'SELECT pg_xlogfile_name(pg_current_xlog_location())');
+chomp($first);
+run_sql(
+	$connstr_master, q{
+CREATE TABLE send_tab (a int, b text);
+INSERT INTO send_tab
+  SELECT i, repeat(md5(i::text), 3) FROM generate_series(1, 200000) i;
+UPDATE send_tab SET b = md5(b) WHERE a % 3 = 0;
+});
+
+start_server($late_datadir, $port_late, "$tempdir/late.log");
+
+# Finish the last segment of the workload, and wait for both standbys.
+run_sql($connstr_master, 'SELECT pg_switch_xlog()');
+run_sql($connstr_master, 'INSERT INTO send_tab VALUES (0, NULL)');
+my $current = query_result($connstr_master,
+	'SELECT pg_xlogfile_name(pg_current_xlog_location())');
+chomp($current);
+
+my $caughtup_query =
+"SELECT count(*) = 2 FROM pg_stat_replication WHERE pg_current_xlog_location() = replay_location;";
+poll_query_until($caughtup_query, $connstr_master)
+  or die "Timed out while waiting for standbys to catch up";
+
+my $query = 'SELECT count(*), sum(a), md5(string_agg(b, \'\' ORDER BY a)) FROM send_tab';
+my $expected = query_result($connstr_master, $query);
+is(query_result($connstr_live, $query), $expected,
+	'data matches on live standby');
+is(query_result($connstr_late, $query), $expected,
+	'data matches on late standby');
+
+my $live_segments = compare_segments($live_datadir, $first, $current);
+my $late_segments = compare_segments($late_datadir, $first, $current);
+cmp_ok($live_segments, '>=', 3,
+	'live standby has the same segment files as the master');
+cmp_ok($late_segments, '>=', 3,
+	'late standby has the same segment files as the master');
+is($late_segments, $live_segments,
+	'both standbys have all of the segments');
+
+stop_server($late_datadir,   'fast');
+stop_server($live_datadir,   'fast');
+stop_server($master_datadir, 'fast');
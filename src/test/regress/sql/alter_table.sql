@@ -1687,3 +1687,40 @@ ALTER TABLE logged1 SET UNLOGGED; -- silently do nothing
 DROP TABLE logged3;
 DROP TABLE logged2;
 DROP TABLE logged1;
+
+--
+-- partitioned tables
+--
+CREATE TABLE partitioned (a int, b text) PARTITION BY RANGE (a);
+CREATE TABLE part_lo PARTITION OF partitioned FOR VALUES FROM (UNBOUNDED) TO (10);
+CREATE TABLE part_hi PARTITION OF partitioned FOR VALUES FROM (10) TO (UNBOUNDED) PARTITION BY LIST (b);
+CREATE TABLE part_hi_x PARTITION OF part_hi FOR VALUES IN ('x');
+
+-- the partition key can't be dropped or changed
+ALTER TABLE partitioned DROP COLUMN a;
+ALTER TABLE partitioned ALTER COLUMN a TYPE bigint;
+ALTER TABLE part_lo DROP COLUMN a;
+
+-- new columns are added to all partitions
+ALTER TABLE partitioned ADD COLUMN c int DEFAULT 0;
+INSERT INTO partitioned VALUES (1, 'a'), (15, 'x');
+SELECT tableoid::regclass, * FROM partitioned ORDER BY a;
+
+-- partitioned tables and partitions don't take part in plain inheritance
+CREATE TABLE plain (a int, b text, c int);
+ALTER TABLE plain INHERIT partitioned;
+ALTER TABLE plain INHERIT part_lo;
+ALTER TABLE partitioned INHERIT plain;
+ALTER TABLE part_lo INHERIT plain;
+ALTER TABLE part_lo NO INHERIT partitioned;
+DROP TABLE plain;
+
+-- partitions can be dropped and created again
+DROP TABLE part_lo;
+INSERT INTO partitioned VALUES (2, 'b');
+CREATE TABLE part_lo PARTITION OF partitioned FOR VALUES FROM (UNBOUNDED) TO (10);
+INSERT INTO partitioned VALUES (2, 'b');
+SELECT tableoid::regclass, * FROM partitioned ORDER BY a;
+
+-- leave the partitioned table behind, to be dumped and restored by the
+-- pg_upgrade test
@@ -291,6 +291,53 @@ select 33 = all (null::int[]);
 select null::int = all ('{1,2,3}');
 select 33 = all ('{1,null,3}');
 select 33 = all ('{33,null,33}');
+-- large constant arrays are searched using a hash table
+select count(*) from generate_series(1, 100) g
+  where g in (3, 5, 7, 11, 13, 17, 19, 23, 29, 31);
+select count(*) from generate_series(1, 100) g
+  where g not in (3, 5, 7, 11, 13, 17, 19, 23, 29, 31);
+select count(*) from generate_series(1, 100) g
+  where g not in (3, 5, 7, 11, 13, 17, 19, 23, 29, null);
+select g, g = any ('{3,5,7,11,13,17,19,23,29,null}'::int[])
+  from generate_series(1, 4) g;
+select 'foo' = any ('{a,b,c,d,e,f,g,h,foo}'::text[]);
+select null::text <> all ('{a,b,c,d,e,f,g,h,foo}'::text[]);
+-- the array can also be a parameter; run the statements often enough for
+-- a generic plan to be considered as well
+prepare saop_any(int[]) as
+  select count(*) from generate_series(1, 100) g where g = any ($1);
+execute saop_any('{2,3,5,7,11,13,17,19,23,29}');
+execute saop_any('{2,3,5,7,11,13,17,19,23,29}');
+execute saop_any('{2,3,5,7,11,13,17,19,23,29}');
+execute saop_any('{2,3,5,7,11,13,17,19,23,29}');
+execute saop_any('{2,3,5,7,11,13,17,19,23,29}');
+execute saop_any('{2,3,5,7,11,13,17,19,23,29}');
+execute saop_any('{2,3,5,7,11,13,17,19,23,29,31,37}');
+deallocate saop_any;
+-- and a parameter that arrives toasted: a field of a plpgsql record keeps
+-- the out-of-line value it was fetched with
+create temp table saop_arrays (a int[]);
+alter table saop_arrays alter column a set storage external;
+insert into saop_arrays select array_agg(g * 2) from generate_series(1, 5000) g;
+select pg_column_size(a) > 2000 as out_of_line from saop_arrays;
+create function saop_toasted(out n_any bigint, out n_all bigint)
+  returns setof record language plpgsql as $$
+declare
+  r record;
+begin
+  for i in 1..7 loop
+    for r in select a from saop_arrays loop
+      select count(*) into n_any from generate_series(1, 10000) g
+        where g = any (r.a);
+      select count(*) into n_all from generate_series(1, 10000) g
+        where g <> all (r.a);
+      return next;
+    end loop;
+  end loop;
+end $$;
+select * from saop_toasted();
+drop function saop_toasted();
+drop table saop_arrays;
 
 -- test indexes on arrays
 create temp table arr_tbl (f1 int[] unique);
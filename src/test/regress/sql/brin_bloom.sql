@@ -0,0 +1,51 @@
+--
+-- BRIN bloom opclasses
+--
+-- Each value appears twice, in distant page ranges, so the values are not
+-- correlated with their physical position as minmax would like.
+CREATE TABLE brintest_bloom (int4col int4, int8col int8, textcol text,
+    tscol timestamp, tstzcol timestamptz, uuidcol uuid) WITH (fillfactor = 10);
+INSERT INTO brintest_bloom
+  SELECT i % 500, (i % 500) * 1000000000::int8, 'val' || (i % 500),
+         '2015-01-01'::timestamp + (i % 500) * interval '1 hour',
+         '2015-01-01 00:00+00'::timestamptz + (i % 500) * interval '1 hour',
+         ('00000000-0000-0000-0000-' || lpad((i % 500)::text, 12, '0'))::uuid
+  FROM generate_series(1, 1000) i;
+
+CREATE INDEX brinidx_bloom ON brintest_bloom USING brin (
+    int4col int4_bloom_ops, int8col int8_bloom_ops, textcol text_bloom_ops,
+    tscol timestamp_bloom_ops, tstzcol timestamptz_bloom_ops,
+    uuidcol uuid_bloom_ops) WITH (pages_per_range = 2);
+
+SET enable_seqscan = off;
+EXPLAIN (COSTS OFF) SELECT * FROM brintest_bloom WHERE int4col = 42;
+SELECT count(*) FROM brintest_bloom WHERE int4col = 42;
+SELECT count(*) FROM brintest_bloom WHERE int8col = 42000000000;
+SELECT count(*) FROM brintest_bloom WHERE textcol = 'val42';
+SELECT count(*) FROM brintest_bloom WHERE tscol = '2015-01-01 10:00';
+SELECT count(*) FROM brintest_bloom WHERE tstzcol = '2015-01-01 10:00+00';
+SELECT count(*) FROM brintest_bloom
+  WHERE uuidcol = '00000000-0000-0000-0000-000000000042';
+SELECT count(*) FROM brintest_bloom WHERE textcol = 'nosuchvalue';
+-- bloom filters can't answer range queries
+EXPLAIN (COSTS OFF) SELECT * FROM brintest_bloom WHERE int4col < 42;
+
+-- new page ranges are summarized on request
+INSERT INTO brintest_bloom (int4col, textcol)
+  SELECT 1000 + i, 'new' || i FROM generate_series(1, 100) i;
+SELECT brin_summarize_new_values('brinidx_bloom') > 0 AS summarized;
+SELECT count(*) FROM brintest_bloom WHERE textcol = 'new50';
+SELECT count(*) FROM brintest_bloom WHERE int4col = 1050;
+RESET enable_seqscan;
+
+SELECT brin_summarize_range('brinidx_bloom', 0);
+SELECT brin_summarize_range('brinidx_bloom', -1);  -- fail
+SELECT brin_summarize_range('onek_unique1', 0);  -- fail
+
+CREATE INDEX ON brintest_bloom USING brin (int4col int8_bloom_ops);  -- fail
+
+CREATE INDEX brinidx_bloom_auto ON brintest_bloom
+  USING brin (int4col int4_bloom_ops) WITH (autosummarize = on);
+SELECT reloptions FROM pg_class WHERE relname = 'brinidx_bloom_auto';
+
+DROP TABLE brintest_bloom;
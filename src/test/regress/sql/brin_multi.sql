@@ -0,0 +1,43 @@
+--
+-- BRIN minmax-multi opclasses
+--
+-- Mostly increasing values with regular outliers, which would make a plain
+-- minmax summary cover nearly the whole value range in every page range.
+CREATE TABLE brintest_multi (int4col int4, int8col int8, float8col float8,
+    datecol date, tscol timestamp, tstzcol timestamptz) WITH (fillfactor = 10);
+INSERT INTO brintest_multi
+  SELECT v, v, v, '2000-01-01'::date + v,
+         '2000-01-01'::timestamp + v * interval '1 hour',
+         '2000-01-01 00:00+00'::timestamptz + v * interval '1 hour'
+  FROM (SELECT CASE WHEN i % 10 = 0 THEN i * 100 ELSE i END AS v
+        FROM generate_series(1, 1000) i) s;
+
+CREATE INDEX brinidx_multi ON brintest_multi USING brin (
+    int4col int4_minmax_multi_ops, int8col int8_minmax_multi_ops,
+    float8col float8_minmax_multi_ops, datecol date_minmax_multi_ops,
+    tscol timestamp_minmax_multi_ops, tstzcol timestamptz_minmax_multi_ops)
+  WITH (pages_per_range = 4);
+
+SET enable_seqscan = off;
+EXPLAIN (COSTS OFF) SELECT * FROM brintest_multi WHERE int4col < 100;
+SELECT count(*) FROM brintest_multi WHERE int4col < 100;
+SELECT count(*) FROM brintest_multi WHERE int8col BETWEEN 1000 AND 2000;
+SELECT count(*) FROM brintest_multi WHERE float8col > 50000;
+SELECT count(*) FROM brintest_multi WHERE datecol = '2000-01-01'::date + 501;
+SELECT count(*) FROM brintest_multi WHERE datecol = '2000-01-01'::date + 500;
+SELECT count(*) FROM brintest_multi WHERE tscol >= '2011-04-18 00:00';
+SELECT count(*) FROM brintest_multi WHERE tstzcol <= '2000-01-01 05:00+00';
+
+-- a range summarized incrementally must give the same answers
+INSERT INTO brintest_multi (int4col, int8col)
+  SELECT CASE WHEN i % 2 = 0 THEN -i ELSE 200000 + i END, i
+  FROM generate_series(1, 100) i;
+SELECT brin_summarize_new_values('brinidx_multi') > 0 AS summarized;
+SELECT count(*) FROM brintest_multi WHERE int4col < 0;
+SELECT count(*) FROM brintest_multi WHERE int4col > 200000;
+SELECT count(*) FROM brintest_multi WHERE int4col BETWEEN 150000 AND 199999;
+RESET enable_seqscan;
+
+CREATE INDEX ON brintest_multi USING brin (int4col float8_minmax_multi_ops);  -- fail
+
+DROP TABLE brintest_multi;
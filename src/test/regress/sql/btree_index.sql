@@ -92,3 +92,69 @@ vacuum btree_tall_tbl;
 -- need to insert some rows to cause the fast root page to split.
 insert into btree_tall_tbl (id, t)
   select g, repeat('x', 100) from generate_series(1, 500) g;
+
+--
+-- Test B-tree skip scans, which visit each distinct value of the leading
+-- index column when only later columns have quals.  The NULL leading
+-- values form a prefix of their own.
+--
+create table btree_skip_tbl (a int4, b int4, c text);
+insert into btree_skip_tbl
+  select i % 5, i, 'c' || i from generate_series(1, 10000) i;
+insert into btree_skip_tbl
+  select null, i, 'n' || i from generate_series(1, 100) i;
+create index btree_skip_idx on btree_skip_tbl (a, b);
+vacuum analyze btree_skip_tbl;
+
+set enable_seqscan to false;
+set enable_bitmapscan to false;
+
+explain (costs off)
+select a, b from btree_skip_tbl where b = 42 order by a, b;
+select a, b from btree_skip_tbl where b = 42 order by a, b;
+
+-- backward scan
+explain (costs off)
+select a, b from btree_skip_tbl where b < 4 order by a desc, b desc;
+select a, b from btree_skip_tbl where b < 4 order by a desc, b desc;
+
+-- heap fetches, and a range qual spanning the NULL prefix
+select count(*), count(a), min(c), max(c) from btree_skip_tbl where b between 95 and 105;
+
+-- mark and restore under a merge join
+create table btree_skip_outer (a int4, b int4);
+insert into btree_skip_outer values (1, 1), (1, 1), (2, 2), (2, 2), (3, 3), (4, 4), (4, 4), (null, 1);
+set enable_hashjoin to false;
+set enable_nestloop to false;
+explain (costs off)
+select o.a, o.b from btree_skip_outer o join btree_skip_tbl s
+  on s.a = o.a and s.b = o.b
+  where s.b < 10 order by o.a, o.b;
+select o.a, o.b from btree_skip_outer o join btree_skip_tbl s
+  on s.a = o.a and s.b = o.b
+  where s.b < 10 order by o.a, o.b;
+reset enable_hashjoin;
+reset enable_nestloop;
+
+-- bitmap scans can skip too
+set enable_bitmapscan to true;
+set enable_indexscan to false;
+explain (costs off) select count(*) from btree_skip_tbl where b = 42;
+select count(*) from btree_skip_tbl where b = 42;
+reset enable_indexscan;
+set enable_bitmapscan to false;
+
+-- the ordinary scan is still available, with the same results
+set enable_indexskipscan to false;
+explain (costs off)
+select a, b from btree_skip_tbl where b = 42 order by a, b;
+select a, b from btree_skip_tbl where b = 42 order by a, b;
+reset enable_indexskipscan;
+
+-- no skipping when the leading column has a qual of its own
+explain (costs off)
+select a, b from btree_skip_tbl where a = 2 and b = 42;
+
+reset enable_seqscan;
+reset enable_bitmapscan;
+drop table btree_skip_tbl, btree_skip_outer;
@@ -0,0 +1,59 @@
+--
+-- Bounded catalog and relation caches
+--
+-- With tiny limits, touching many relations evicts catalog cache and
+-- relcache entries, which must not change any results.
+--
+CREATE FUNCTION cache_limits_read(int) RETURNS bigint LANGUAGE plpgsql AS $$
+DECLARE
+  result bigint;
+BEGIN
+  EXECUTE format('SELECT sum(a) + sum(length(b)) FROM cache_limits_%s', $1)
+    INTO result;
+  RETURN result;
+END
+$$;
+
+DO $$
+BEGIN
+  FOR i IN 1..100 LOOP
+    EXECUTE format('CREATE TABLE cache_limits_%s (a int PRIMARY KEY, b text)', i);
+    EXECUTE format('INSERT INTO cache_limits_%s VALUES (%s, repeat(''x'', %s))',
+                   i, i, i);
+  END LOOP;
+END
+$$;
+
+CREATE TEMP TABLE cache_limits_before AS
+  SELECT cache_name, evictions FROM pg_stat_syscache;
+
+SET catalog_cache_memory_limit = '64kB';
+SET relation_cache_memory_limit = '64kB';
+
+-- each run rebuilds what the previous one's commit evicted
+SELECT sum(cache_limits_read(i)) FROM generate_series(1, 100) i;
+SELECT sum(cache_limits_read(i)) FROM generate_series(1, 100) i;
+
+-- both kinds of cache had to evict entries
+SELECT s.cache_name = 'relcache' AS is_relcache,
+       sum(s.evictions - coalesce(b.evictions, 0)) > 0 AS evicted
+  FROM pg_stat_syscache s LEFT JOIN cache_limits_before b USING (cache_name)
+  GROUP BY 1 ORDER BY 1;
+
+-- entries rebuilt after eviction see later changes
+ALTER TABLE cache_limits_1 ADD COLUMN c int DEFAULT 7;
+SELECT sum(cache_limits_read(i)) FROM generate_series(1, 100) i;
+SELECT * FROM cache_limits_1;
+INSERT INTO cache_limits_1 VALUES (1, 'dup');
+
+RESET catalog_cache_memory_limit;
+RESET relation_cache_memory_limit;
+
+DO $$
+BEGIN
+  FOR i IN 1..100 LOOP
+    EXECUTE format('DROP TABLE cache_limits_%s', i);
+  END LOOP;
+END
+$$;
+DROP FUNCTION cache_limits_read(int);
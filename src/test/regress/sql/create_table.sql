@@ -265,3 +265,64 @@ CREATE TABLE as_select1 AS SELECT * FROM pg_class WHERE relkind = 'r';
 CREATE TABLE as_select1 AS SELECT * FROM pg_class WHERE relkind = 'r';
 CREATE TABLE IF NOT EXISTS as_select1 AS SELECT * FROM pg_class WHERE relkind = 'r';
 DROP TABLE as_select1;
+
+--
+-- Partitioned tables and partitions
+--
+
+-- invalid partition keys
+CREATE TABLE partitioned (a int, b text) PARTITION BY HASH (a);
+CREATE TABLE partitioned (a int, b text) PARTITION BY RANGE (a, b);
+CREATE TABLE partitioned (a int, b text) PARTITION BY RANGE (c);
+CREATE TABLE partitioned (a point) PARTITION BY LIST (a);
+CREATE TABLE no_part (a int, b text);
+CREATE TABLE partitioned (c int) INHERITS (no_part) PARTITION BY RANGE (a);
+
+CREATE TABLE range_parted (a int, b text) PARTITION BY RANGE (a);
+CREATE TABLE list_parted (a text, b int) PARTITION BY LIST (a);
+SELECT c.relname, p.partstrat, p.partattnum FROM pg_partitioned_table p JOIN pg_class c ON c.oid = p.partrelid ORDER BY c.relname;
+
+-- invalid partition bounds
+CREATE TABLE fail_part PARTITION OF no_part FOR VALUES IN (1);
+CREATE TABLE fail_part PARTITION OF range_parted FOR VALUES IN (1);
+CREATE TABLE fail_part PARTITION OF list_parted FOR VALUES FROM ('a') TO ('z');
+CREATE TABLE fail_part PARTITION OF list_parted FOR VALUES IN ('a', UNBOUNDED);
+CREATE TABLE fail_part PARTITION OF range_parted FOR VALUES FROM ('a') TO (10);
+CREATE TABLE fail_part PARTITION OF range_parted FOR VALUES FROM (10) TO (1);
+
+-- range partitions must not overlap; each one includes its lower bound
+-- but not its upper bound
+CREATE TABLE part_lo PARTITION OF range_parted FOR VALUES FROM (UNBOUNDED) TO (1);
+CREATE TABLE part_1_10 PARTITION OF range_parted FOR VALUES FROM (1) TO (10);
+CREATE TABLE part_20_30 PARTITION OF range_parted FOR VALUES FROM (20) TO (30);
+CREATE TABLE fail_part PARTITION OF range_parted FOR VALUES FROM (UNBOUNDED) TO (0);
+CREATE TABLE fail_part PARTITION OF range_parted FOR VALUES FROM (5) TO (15);
+CREATE TABLE fail_part PARTITION OF range_parted FOR VALUES FROM (25) TO (UNBOUNDED);
+CREATE TABLE part_30_up PARTITION OF range_parted FOR VALUES FROM (30) TO (UNBOUNDED);
+
+-- a partition can be partitioned itself
+CREATE TABLE part_10_20 PARTITION OF range_parted FOR VALUES FROM (10) TO (20) PARTITION BY LIST (b);
+CREATE TABLE part_10_20_x PARTITION OF part_10_20 FOR VALUES IN ('x');
+
+-- list partitions must not share values
+CREATE TABLE part_ab PARTITION OF list_parted FOR VALUES IN ('a', 'b');
+CREATE TABLE part_c PARTITION OF list_parted FOR VALUES IN ('c');
+CREATE TABLE fail_part PARTITION OF list_parted FOR VALUES IN ('d', 'b');
+
+-- a partition has the persistence of its parent
+CREATE TEMP TABLE fail_part PARTITION OF list_parted FOR VALUES IN ('d');
+
+-- partitioned tables and partitions have no other inheritance children
+CREATE TABLE fail_child () INHERITS (range_parted);
+CREATE TABLE fail_child () INHERITS (part_ab);
+
+SELECT c.relname, pg_get_partkeydef(c.oid), pg_get_partition_bound(c.oid)
+  FROM pg_class c
+  WHERE c.oid IN (SELECT partrelid FROM pg_partitioned_table UNION ALL
+                  SELECT partrelid FROM pg_partition)
+  ORDER BY c.relname;
+
+-- partitions go away with their parent
+DROP TABLE part_c;
+DROP TABLE range_parted, list_parted, no_part;
+SELECT count(*) FROM pg_partition;
@@ -27,3 +27,24 @@ insert into gin_test_tbl select array[1, 3, g] from generate_series(1, 1000) g;
 
 delete from gin_test_tbl where i @> array[2];
 vacuum gin_test_tbl;
+
+-- Test deferring pending list cleanup to autovacuum.  Whether autovacuum
+-- or the inserting backend does the cleanup, the results must be the same.
+alter index gin_test_idx set (fastupdate = on, deferred_cleanup = on);
+select reloptions from pg_class where relname = 'gin_test_idx';
+
+set gin_pending_list_limit = 64;
+insert into gin_test_tbl select array[1, 4, g] from generate_series(1, 5000) g;
+reset gin_pending_list_limit;
+
+-- Flush whatever is left in the pending list; a second call finds it empty
+select gin_clean_pending_list('gin_test_idx') >= 0 as cleaned;
+select gin_clean_pending_list('gin_test_idx');
+
+set enable_seqscan = off;
+select count(*) from gin_test_tbl where i @> array[4];
+reset enable_seqscan;
+
+select gin_clean_pending_list('onek_unique1');  -- fail, not a GIN index
+
+alter index gin_test_idx reset (deferred_cleanup);
@@ -275,3 +275,11 @@ set default_text_search_config = no_such_config;
 select func_with_bad_set();
 
 reset check_function_bodies;
+
+-- Invalid values of synchronous_standby_names are rejected, by ALTER SYSTEM
+-- as it can't be SET
+alter system set synchronous_standby_names = 'ANY 0 (a)';
+alter system set synchronous_standby_names = 'FIRST 3 (a, b)';
+alter system set synchronous_standby_names = 'ANY 4 (a, b, c)';
+alter system set synchronous_standby_names = 'FIRST 2 (a, b';
+alter system set synchronous_standby_names = 'ANY 1 a, b)';
@@ -0,0 +1,56 @@
+--
+-- Indexes with included (non-key) columns
+--
+CREATE TABLE tbl_include (c1 int, c2 int, c3 int, c4 text);
+CREATE UNIQUE INDEX tbl_include_unique ON tbl_include (c1, c2) INCLUDE (c3, c4);
+SELECT pg_get_indexdef('tbl_include_unique'::regclass);
+SELECT indnatts, indnkeyatts FROM pg_index
+  WHERE indexrelid = 'tbl_include_unique'::regclass;
+
+INSERT INTO tbl_include
+  SELECT i, 2 * i, 3 * i, 'x' || i FROM generate_series(1, 1000) i;
+
+-- uniqueness is enforced on the key columns only
+INSERT INTO tbl_include VALUES (1, 2, 0, 'other');  -- fail
+INSERT INTO tbl_include VALUES (1, 3, 3, 'x1');
+INSERT INTO tbl_include VALUES (NULL, 1, 3, 'x1'), (NULL, 1, 3, 'x1');
+
+-- included columns are returned by index-only scans, but not searched
+VACUUM ANALYZE tbl_include;
+SET enable_seqscan = off;
+SET enable_bitmapscan = off;
+EXPLAIN (COSTS OFF) SELECT c1, c2, c3, c4 FROM tbl_include WHERE c1 < 3 ORDER BY c1, c2;
+SELECT c1, c2, c3, c4 FROM tbl_include WHERE c1 < 3 ORDER BY c1, c2;
+EXPLAIN (COSTS OFF) SELECT c1, c3 FROM tbl_include WHERE c1 < 10 AND c3 = 6;
+SELECT c1, c3 FROM tbl_include WHERE c1 < 10 AND c3 = 6;
+RESET enable_seqscan;
+RESET enable_bitmapscan;
+
+-- included columns take no options, and must be simple columns
+CREATE INDEX ON tbl_include (c1) INCLUDE (c4 COLLATE "C");
+CREATE INDEX ON tbl_include (c1) INCLUDE (c4 text_pattern_ops);
+CREATE INDEX ON tbl_include (c1) INCLUDE (c3 DESC);
+CREATE INDEX ON tbl_include (c1) INCLUDE (c3 NULLS FIRST);
+CREATE INDEX ON tbl_include (c1) INCLUDE ((c3 + 1));
+CREATE INDEX ON tbl_include (c1) INCLUDE (nosuchcol);
+CREATE INDEX ON tbl_include USING gist (c1) INCLUDE (c3);
+
+-- such an index cannot back a constraint
+ALTER TABLE tbl_include
+  ADD UNIQUE USING INDEX tbl_include_unique;
+
+-- but it can be the replica identity; only key columns need to be NOT NULL
+DELETE FROM tbl_include WHERE c1 IS NULL;
+ALTER TABLE tbl_include REPLICA IDENTITY USING INDEX tbl_include_unique;
+ALTER TABLE tbl_include ALTER c1 SET NOT NULL, ALTER c2 SET NOT NULL;
+ALTER TABLE tbl_include REPLICA IDENTITY USING INDEX tbl_include_unique;
+SELECT relreplident FROM pg_class WHERE oid = 'tbl_include'::regclass;
+SELECT indisreplident FROM pg_index
+  WHERE indexrelid = 'tbl_include_unique'::regclass;
+
+-- CREATE TABLE LIKE copies the included columns
+CREATE TABLE tbl_include_like (LIKE tbl_include INCLUDING INDEXES);
+SELECT indnatts, indnkeyatts, indisunique FROM pg_index
+  WHERE indrelid = 'tbl_include_like'::regclass;
+
+DROP TABLE tbl_include, tbl_include_like;
@@ -36,3 +36,50 @@ insert into inserttest values(30, 50, repeat('x', 10000));
 select col1, col2, char_length(col3) from inserttest;
 
 drop table inserttest;
+
+--
+-- insert into partitioned tables
+--
+create table range_parted (a int, b text) partition by range (a);
+create table part_lo partition of range_parted for values from (unbounded) to (1);
+create table part_1_10 partition of range_parted for values from (1) to (10);
+create table part_10_20 partition of range_parted for values from (10) to (20) partition by list (b);
+create table part_10_20_x partition of part_10_20 for values in ('x');
+create table part_10_20_yz partition of part_10_20 for values in ('y', 'z');
+create table part_30_up partition of range_parted for values from (30) to (unbounded);
+
+-- rows go to the partition whose bound accepts them, even if it is
+-- partitioned itself
+insert into range_parted values (-5, 'a'), (0, 'b'), (1, 'c'), (9, 'd'),
+    (10, 'x'), (15, 'z'), (30, 'e'), (1000, 'f');
+select tableoid::regclass, * from range_parted order by a;
+
+-- fail, no partition accepts these rows
+insert into range_parted values (25, 'a');
+insert into range_parted values (null, 'a');
+insert into range_parted values (12, 'w');
+
+-- rows inserted into a partition directly must satisfy its bound
+insert into part_1_10 values (20, 'a');
+insert into part_1_10 values (5, 'g');
+
+-- RETURNING is computed for the partitioned table
+insert into range_parted values (2, 'h'), (11, 'y') returning tableoid::regclass, *;
+
+-- an update can't move a row to another partition
+update range_parted set a = 25 where a = 2;
+
+-- ON CONFLICT is not supported
+insert into range_parted values (3, 'i') on conflict do nothing;
+
+-- COPY routes rows the same way
+copy range_parted from stdin;
+-1	j
+12	z
+100	k
+\.
+select tableoid::regclass, * from range_parted order by a;
+
+-- dropping the partitioned table drops its partitions
+drop table range_parted;
+select count(*) from pg_class where relname like 'part\_%';
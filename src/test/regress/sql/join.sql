@@ -343,15 +343,51 @@ select count(*) from tenk1 x where
   x.unique1 = 0 and
   x.unique1 in (select aa.f1 from int4_tbl aa,float8_tbl bb where aa.f1=bb.f1);
 
--- try that with GEQO too
+-- try that with GEQO too, both with iterative dynamic programming in
+-- several rounds and with the genetic algorithm
 begin;
 set geqo = on;
 set geqo_threshold = 2;
+set geqo_idp_block_size = 2;
 select count(*) from tenk1 x where
   x.unique1 in (select a.f1 from int4_tbl a,float8_tbl b where a.f1=b.f1) and
   x.unique1 = 0 and
   x.unique1 in (select aa.f1 from int4_tbl aa,float8_tbl bb where aa.f1=bb.f1);
+set geqo_idp = off;
+select count(*) from tenk1 x where
+  x.unique1 in (select a.f1 from int4_tbl a,float8_tbl b where a.f1=b.f1) and
+  x.unique1 = 0 and
+  x.unique1 in (select aa.f1 from int4_tbl aa,float8_tbl bb where aa.f1=bb.f1);
+rollback;
+
+--
+-- iterative dynamic programming over several rounds must respect the join
+-- order constraints of outer joins; compare with the exhaustive search
+--
+create temp view idp_view as
+select count(*) as n, count(b.unique1) as nb, count(c.q1) as nc,
+       count(d.f1) as nd, count(g.f1) as ng, sum(a.unique1) as sa
+from onek a
+  left join onek b on a.unique1 = b.unique2 and b.ten = 0
+  left join int8_tbl c on b.unique1 = c.q1
+  join tenk1 e on e.unique1 = a.unique2
+  left join int4_tbl d on d.f1 = c.q2 or d.f1 = a.unique1
+  join onek f on f.unique1 = e.unique2 % 1000
+  left join int4_tbl g on g.f1 = f.thousand and g.f1 <> b.unique1
+  join int4_tbl h on h.f1 = a.ten - 1 or h.f1 = 0
+where a.ten < 3;
+select * from idp_view;
+begin;
+set geqo = on;
+set geqo_threshold = 2;
+set geqo_idp_block_size = 2;
+select * from idp_view;
+set geqo_idp_block_size = 3;
+select * from idp_view;
+set geqo_idp_block_size = 5;
+select * from idp_view;
 rollback;
+drop view idp_view;
 
 
 --
@@ -0,0 +1,71 @@
+--
+-- Test Memoize nodes caching the inner side of parameterized nested loops
+--
+
+-- Show EXPLAIN ANALYZE output without the timing, and hide the memory
+-- usage and any nonzero number of evictions, which depend on the platform
+CREATE FUNCTION explain_memoize(query text) RETURNS SETOF text
+LANGUAGE plpgsql AS
+$$
+DECLARE
+    ln text;
+BEGIN
+    FOR ln IN
+        EXECUTE 'EXPLAIN (ANALYZE, COSTS OFF, TIMING OFF) ' || query
+    LOOP
+        IF ln LIKE 'Planning time:%' OR ln LIKE 'Execution time:%' THEN
+            CONTINUE;
+        END IF;
+        ln := regexp_replace(ln, 'Evictions: [1-9]\d*', 'Evictions: N');
+        ln := regexp_replace(ln, 'Memory Usage: \d+', 'Memory Usage: N');
+        RETURN NEXT ln;
+    END LOOP;
+END;
+$$;
+
+CREATE TABLE memo_inner (a int, c int);
+INSERT INTO memo_inner SELECT i, i FROM generate_series(0, 9999) i;
+CREATE INDEX memo_inner_a_idx ON memo_inner (a);
+-- ten distinct keys, in turn
+CREATE TABLE memo_outer (b int);
+INSERT INTO memo_outer SELECT i % 10 FROM generate_series(1, 1000) i;
+-- 2000 distinct keys, each four times in a row
+CREATE TABLE memo_quads (b int);
+INSERT INTO memo_quads SELECT i / 4 FROM generate_series(0, 7999) i;
+ANALYZE memo_inner;
+ANALYZE memo_outer;
+ANALYZE memo_quads;
+
+SET enable_hashjoin TO off;
+SET enable_mergejoin TO off;
+
+-- all but the first lookup of each key are answered from the cache
+SELECT explain_memoize('SELECT count(*), sum(i.c) FROM memo_outer o JOIN memo_inner i ON o.b = i.a');
+SELECT count(*), sum(i.c) FROM memo_outer o JOIN memo_inner i ON o.b = i.a;
+
+-- not all keys fit into the cache, so the least recently used are evicted;
+-- the most recently used entry is kept, so the repeated lookups still hit
+SET work_mem TO '64kB';
+SELECT explain_memoize('SELECT count(*), sum(i.c) FROM memo_quads o JOIN memo_inner i ON o.b = i.a');
+SELECT count(*), sum(i.c) FROM memo_quads o JOIN memo_inner i ON o.b = i.a;
+RESET work_mem;
+
+-- a change of a parameter other than the cache key empties the cache
+CREATE TABLE memo_small (x int);
+INSERT INTO memo_small VALUES (3), (5), (8);
+ANALYZE memo_small;
+SELECT explain_memoize('SELECT x, (SELECT count(*) FROM memo_outer o JOIN memo_inner i ON o.b = i.a WHERE i.c < s.x) FROM memo_small s');
+SELECT x, (SELECT count(*) FROM memo_outer o JOIN memo_inner i ON o.b = i.a WHERE i.c < s.x) FROM memo_small s;
+
+-- the results are the same without caching
+SET enable_memoize TO off;
+SELECT count(*), sum(i.c) FROM memo_outer o JOIN memo_inner i ON o.b = i.a;
+SELECT count(*), sum(i.c) FROM memo_quads o JOIN memo_inner i ON o.b = i.a;
+SELECT x, (SELECT count(*) FROM memo_outer o JOIN memo_inner i ON o.b = i.a WHERE i.c < s.x) FROM memo_small s;
+
+RESET enable_memoize;
+RESET enable_hashjoin;
+RESET enable_mergejoin;
+
+DROP FUNCTION explain_memoize(text);
+DROP TABLE memo_inner, memo_outer, memo_quads, memo_small;
@@ -0,0 +1,36 @@
+--
+-- PARTITION_AGG
+-- Test partition-wise grouping and aggregation
+--
+
+CREATE TABLE pagg (a int, b int) PARTITION BY LIST (a);
+CREATE TABLE pagg_p1 PARTITION OF pagg FOR VALUES IN (1, 2);
+CREATE TABLE pagg_p2 PARTITION OF pagg FOR VALUES IN (3, 4);
+CREATE TABLE pagg_p3 PARTITION OF pagg FOR VALUES IN (5);
+INSERT INTO pagg SELECT i % 5 + 1, i FROM generate_series(1, 1000) i;
+ANALYZE pagg_p1;
+ANALYZE pagg_p2;
+ANALYZE pagg_p3;
+
+-- not done by default
+EXPLAIN (COSTS OFF)
+SELECT a, count(*), sum(b) FROM pagg GROUP BY a ORDER BY a;
+SELECT a, count(*), sum(b) FROM pagg GROUP BY a ORDER BY a;
+
+SET enable_partitionwise_aggregate = on;
+-- the partitioned table itself gets an aggregate too; it never has rows
+EXPLAIN (COSTS OFF)
+SELECT a, count(*), sum(b) FROM pagg GROUP BY a ORDER BY a;
+SELECT a, count(*), sum(b) FROM pagg GROUP BY a ORDER BY a;
+
+-- HAVING is checked in each partition, after pruning
+EXPLAIN (COSTS OFF)
+SELECT a, count(*) FROM pagg WHERE a > 2 GROUP BY a HAVING count(*) > 100 ORDER BY a;
+SELECT a, count(*) FROM pagg WHERE a > 2 GROUP BY a HAVING count(*) > 100 ORDER BY a;
+
+-- the GROUP BY clause must include the partition key
+EXPLAIN (COSTS OFF)
+SELECT b, count(*) FROM pagg GROUP BY b;
+
+RESET enable_partitionwise_aggregate;
+DROP TABLE pagg;
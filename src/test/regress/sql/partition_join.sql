@@ -0,0 +1,65 @@
+--
+-- PARTITION_JOIN
+-- Test partition-wise joins
+--
+
+CREATE TABLE pj1 (a int, b int) PARTITION BY RANGE (a);
+CREATE TABLE pj1_p1 PARTITION OF pj1 FOR VALUES FROM (UNBOUNDED) TO (100);
+CREATE TABLE pj1_p2 PARTITION OF pj1 FOR VALUES FROM (100) TO (200);
+CREATE TABLE pj1_p3 PARTITION OF pj1 FOR VALUES FROM (200) TO (UNBOUNDED);
+INSERT INTO pj1 SELECT i, i % 10 FROM generate_series(0, 299) i;
+ANALYZE pj1_p1;
+ANALYZE pj1_p2;
+ANALYZE pj1_p3;
+
+CREATE TABLE pj2 (a int, b int) PARTITION BY RANGE (a);
+CREATE TABLE pj2_p1 PARTITION OF pj2 FOR VALUES FROM (UNBOUNDED) TO (100);
+CREATE TABLE pj2_p2 PARTITION OF pj2 FOR VALUES FROM (100) TO (200);
+CREATE TABLE pj2_p3 PARTITION OF pj2 FOR VALUES FROM (200) TO (UNBOUNDED);
+INSERT INTO pj2 SELECT i, i % 7 FROM generate_series(0, 299, 3) i;
+ANALYZE pj2_p1;
+ANALYZE pj2_p2;
+ANALYZE pj2_p3;
+
+-- partitioned differently
+CREATE TABLE pj3 (a int, b int) PARTITION BY RANGE (a);
+CREATE TABLE pj3_p1 PARTITION OF pj3 FOR VALUES FROM (UNBOUNDED) TO (150);
+CREATE TABLE pj3_p2 PARTITION OF pj3 FOR VALUES FROM (150) TO (UNBOUNDED);
+INSERT INTO pj3 SELECT i, i % 3 FROM generate_series(0, 299, 5) i;
+ANALYZE pj3_p1;
+ANALYZE pj3_p2;
+
+-- Use only nested loops, whose cost grows with the product of the sizes
+-- of their inputs, so that joining the partitions separately is clearly
+-- cheapest
+SET enable_hashjoin = off;
+SET enable_mergejoin = off;
+
+-- not done by default
+EXPLAIN (COSTS OFF)
+SELECT count(*), sum(pj1.b), sum(pj2.b) FROM pj1 JOIN pj2 ON pj1.a = pj2.a;
+SELECT count(*), sum(pj1.b), sum(pj2.b) FROM pj1 JOIN pj2 ON pj1.a = pj2.a;
+
+SET enable_partitionwise_join = on;
+EXPLAIN (COSTS OFF)
+SELECT count(*), sum(pj1.b), sum(pj2.b) FROM pj1 JOIN pj2 ON pj1.a = pj2.a;
+SELECT count(*), sum(pj1.b), sum(pj2.b) FROM pj1 JOIN pj2 ON pj1.a = pj2.a;
+
+-- partitions pruned from one side have nothing to join with
+EXPLAIN (COSTS OFF)
+SELECT count(*), sum(pj1.b), sum(pj2.b) FROM pj1 JOIN pj2 ON pj1.a = pj2.a WHERE pj1.a < 100;
+SELECT count(*), sum(pj1.b), sum(pj2.b) FROM pj1 JOIN pj2 ON pj1.a = pj2.a WHERE pj1.a < 100;
+
+EXPLAIN (COSTS OFF)
+SELECT count(*), count(pj2.a) FROM pj1 LEFT JOIN pj2 ON pj1.a = pj2.a;
+SELECT count(*), count(pj2.a) FROM pj1 LEFT JOIN pj2 ON pj1.a = pj2.a;
+
+-- the tables must be partitioned the same way
+EXPLAIN (COSTS OFF)
+SELECT count(*) FROM pj1 JOIN pj3 ON pj1.a = pj3.a;
+SELECT count(*) FROM pj1 JOIN pj3 ON pj1.a = pj3.a;
+
+RESET enable_partitionwise_join;
+RESET enable_hashjoin;
+RESET enable_mergejoin;
+DROP TABLE pj1, pj2, pj3;
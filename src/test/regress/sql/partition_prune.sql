@@ -0,0 +1,98 @@
+--
+-- Test partition pruning at plan time
+--
+
+CREATE TABLE rp (a int, b text) PARTITION BY RANGE (a);
+CREATE TABLE rp_lo PARTITION OF rp FOR VALUES FROM (UNBOUNDED) TO (1);
+CREATE TABLE rp_1_10 PARTITION OF rp FOR VALUES FROM (1) TO (10);
+CREATE TABLE rp_10_20 PARTITION OF rp FOR VALUES FROM (10) TO (20);
+CREATE TABLE rp_20_up PARTITION OF rp FOR VALUES FROM (20) TO (UNBOUNDED);
+
+CREATE TABLE lp (a text, b int) PARTITION BY LIST (a);
+CREATE TABLE lp_ab PARTITION OF lp FOR VALUES IN ('a', 'b');
+CREATE TABLE lp_c PARTITION OF lp FOR VALUES IN ('c');
+CREATE TABLE lp_de PARTITION OF lp FOR VALUES IN ('d', 'e');
+
+-- the partitioned table itself is scanned first; it never holds any rows
+EXPLAIN (COSTS OFF) SELECT * FROM rp;
+EXPLAIN (COSTS OFF) SELECT * FROM rp WHERE a = 5;
+EXPLAIN (COSTS OFF) SELECT * FROM rp WHERE a < 10;
+EXPLAIN (COSTS OFF) SELECT * FROM rp WHERE a >= 10 AND a < 20;
+EXPLAIN (COSTS OFF) SELECT * FROM rp WHERE 15 > a;
+EXPLAIN (COSTS OFF) SELECT * FROM rp WHERE a IN (0, 25);
+EXPLAIN (COSTS OFF) SELECT * FROM rp WHERE a IN (0, NULL);
+
+-- OR clauses are not used for pruning
+EXPLAIN (COSTS OFF) SELECT * FROM rp WHERE a = 5 OR a = 25;
+
+-- if no partition can hold matching rows, only the parent is scanned
+EXPLAIN (COSTS OFF) SELECT * FROM rp WHERE a > 5 AND a < 3;
+
+EXPLAIN (COSTS OFF) SELECT * FROM lp WHERE a = 'c';
+EXPLAIN (COSTS OFF) SELECT * FROM lp WHERE a IN ('a', 'e');
+EXPLAIN (COSTS OFF) SELECT * FROM lp WHERE a > 'b';
+EXPLAIN (COSTS OFF) SELECT * FROM lp WHERE a = 'f';
+
+--
+-- Test partition pruning at run time
+--
+
+INSERT INTO rp VALUES (0, 'a'), (5, 'b'), (15, 'c'), (25, 'd');
+ANALYZE rp_lo;
+ANALYZE rp_1_10;
+ANALYZE rp_10_20;
+ANALYZE rp_20_up;
+
+-- the parameters of a generic plan are used at executor startup, and
+-- the subplans ruled out are not even initialized
+PREPARE rp_q1 (int, int) AS SELECT * FROM rp WHERE a BETWEEN $1 AND $2;
+EXECUTE rp_q1 (1, 12);
+EXECUTE rp_q1 (1, 12);
+EXECUTE rp_q1 (1, 12);
+EXECUTE rp_q1 (1, 12);
+EXECUTE rp_q1 (1, 12);
+EXPLAIN (COSTS OFF) EXECUTE rp_q1 (1, 12);
+-- a null parameter rules out every partition, leaving only the parent
+EXPLAIN (COSTS OFF) EXECUTE rp_q1 (NULL, 12);
+EXECUTE rp_q1 (20, 10);
+DEALLOCATE rp_q1;
+
+-- EXPLAIN ANALYZE shows the subplans skipped at run time as never
+-- executed; leave out the timing lines, which vary from run to run
+CREATE FUNCTION explain_analyze(query text) RETURNS SETOF text
+LANGUAGE plpgsql AS
+$$
+DECLARE
+    ln text;
+BEGIN
+    FOR ln IN
+        EXECUTE 'EXPLAIN (ANALYZE, COSTS OFF, TIMING OFF) ' || query
+    LOOP
+        IF ln LIKE 'Planning time:%' OR ln LIKE 'Execution time:%' THEN
+            CONTINUE;
+        END IF;
+        RETURN NEXT ln;
+    END LOOP;
+END;
+$$;
+
+-- the params set by an initplan are used once it has run
+SELECT explain_analyze('SELECT * FROM rp WHERE a = (SELECT 5)');
+
+-- nestloop params are used again on each rescan
+CREATE TABLE rp_vals (c int);
+INSERT INTO rp_vals VALUES (5), (15), (NULL);
+SELECT explain_analyze('SELECT * FROM rp_vals, LATERAL (SELECT * FROM rp WHERE a = rp_vals.c OFFSET 0) s');
+SELECT * FROM rp_vals, LATERAL (SELECT * FROM rp WHERE a = rp_vals.c OFFSET 0) s;
+
+-- backward scans skip the ruled out subplans too
+BEGIN;
+DECLARE rp_cur SCROLL CURSOR FOR SELECT * FROM rp WHERE a > (SELECT 3);
+FETCH ALL FROM rp_cur;
+FETCH BACKWARD ALL FROM rp_cur;
+-- rewinding the cursor rescans the Append
+FETCH FIRST FROM rp_cur;
+COMMIT;
+
+DROP FUNCTION explain_analyze(text);
+DROP TABLE rp, lp, rp_vals;
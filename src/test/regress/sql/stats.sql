@@ -149,4 +149,43 @@ SELECT pr.snap_ts < pg_stat_get_snapshot_timestamp() as snapshot_newer
 FROM prevstats AS pr;
 
 DROP TABLE trunc_stats_test, trunc_stats_test1, trunc_stats_test2, trunc_stats_test3, trunc_stats_test4;
+
+-- Statistics are kept in shared memory.  A backend's counts become visible,
+-- to itself as well as to others, as soon as they are flushed, and resets
+-- take effect immediately.
+CREATE TABLE stats_shmem_test (a int);
+INSERT INTO stats_shmem_test SELECT generate_series(1, 10);
+SELECT count(*) FROM stats_shmem_test;
+SELECT pg_sleep(1.0);
+SELECT seq_scan, n_tup_ins, n_live_tup
+  FROM pg_stat_user_tables WHERE relname = 'stats_shmem_test';
+SELECT pg_stat_reset_single_table_counters('stats_shmem_test'::regclass);
+SELECT seq_scan, n_tup_ins, n_live_tup
+  FROM pg_stat_user_tables WHERE relname = 'stats_shmem_test';
+
+-- function counts
+SET track_functions TO 'all';
+CREATE FUNCTION stats_shmem_func() RETURNS int AS 'BEGIN RETURN 1; END' LANGUAGE plpgsql;
+SELECT stats_shmem_func();
+SELECT stats_shmem_func();
+SELECT pg_sleep(1.0);
+SELECT calls FROM pg_stat_user_functions WHERE funcname = 'stats_shmem_func';
+SELECT pg_stat_reset_single_function_counters('stats_shmem_func'::regproc);
+SELECT count(*) FROM pg_stat_user_functions WHERE funcname = 'stats_shmem_func';
+RESET track_functions;
+
+-- cluster-wide counters
+CREATE TEMP TABLE prev_resets AS
+  SELECT (SELECT stats_reset FROM pg_stat_bgwriter) AS bgwriter_reset,
+         (SELECT stats_reset FROM pg_stat_archiver) AS archiver_reset;
+SELECT pg_stat_reset_shared('bgwriter');
+SELECT pg_stat_reset_shared('archiver');
+SELECT (SELECT stats_reset FROM pg_stat_bgwriter) > bgwriter_reset AS bgwriter_reset,
+       (SELECT stats_reset FROM pg_stat_archiver) > archiver_reset AS archiver_reset
+  FROM prev_resets;
+SELECT pg_stat_reset_shared('nosuchtarget');  -- fail
+
+DROP TABLE stats_shmem_test;
+DROP FUNCTION stats_shmem_func();
+
 -- End of Stats Test
@@ -0,0 +1,81 @@
+--
+-- STATS_EXT
+-- Test multi-column statistics
+--
+
+-- Return the number of rows the planner estimates for the top node of
+-- a query's plan
+CREATE FUNCTION check_estimated_rows(query text) RETURNS int
+LANGUAGE plpgsql AS
+$$
+DECLARE
+    ln text;
+BEGIN
+    FOR ln IN EXECUTE 'EXPLAIN ' || query LOOP
+        RETURN substring(ln FROM 'rows=(\d+)')::int;
+    END LOOP;
+END;
+$$;
+
+-- b is determined by a
+CREATE TABLE stxtest (a int, b int, c int, p point);
+INSERT INTO stxtest SELECT i % 100, i % 50, i, NULL FROM generate_series(1, 10000) i;
+ANALYZE stxtest;
+
+-- errors
+CREATE STATISTICS stxtest_s ON a FROM stxtest;
+CREATE STATISTICS stxtest_s ON a, a FROM stxtest;
+CREATE STATISTICS stxtest_s ON a, x FROM stxtest;
+CREATE STATISTICS stxtest_s ON a, ctid FROM stxtest;
+CREATE STATISTICS stxtest_s ON a, p FROM stxtest;
+CREATE STATISTICS stxtest_s (foo) ON a, b FROM stxtest;
+CREATE VIEW stxtest_v AS SELECT * FROM stxtest;
+CREATE STATISTICS stxtest_s ON a, b FROM stxtest_v;
+DROP VIEW stxtest_v;
+DROP STATISTICS stxtest_s;
+DROP STATISTICS IF EXISTS stxtest_s;
+
+-- without multi-column statistics, the columns are taken to be independent
+SELECT check_estimated_rows('SELECT * FROM stxtest WHERE a = 1 AND b = 1');
+SELECT check_estimated_rows('SELECT a, b, count(*) FROM stxtest GROUP BY a, b');
+
+-- the statistics are only used once ANALYZE has built them
+CREATE STATISTICS stxtest_s ON b, a FROM stxtest;
+CREATE STATISTICS stxtest_s ON a, b FROM stxtest;
+CREATE STATISTICS IF NOT EXISTS stxtest_s ON a, b FROM stxtest;
+SELECT stxname, stxkeys, stxkind, stxndistinct IS NOT NULL AS nd, stxdependencies IS NOT NULL AS deps
+  FROM pg_statistic_ext WHERE stxrelid = 'stxtest'::regclass ORDER BY stxname;
+SELECT check_estimated_rows('SELECT * FROM stxtest WHERE a = 1 AND b = 1');
+SELECT check_estimated_rows('SELECT a, b, count(*) FROM stxtest GROUP BY a, b');
+ANALYZE stxtest;
+SELECT stxname, stxkeys, stxkind, stxndistinct IS NOT NULL AS nd, stxdependencies IS NOT NULL AS deps
+  FROM pg_statistic_ext WHERE stxrelid = 'stxtest'::regclass ORDER BY stxname;
+SELECT check_estimated_rows('SELECT * FROM stxtest WHERE a = 1 AND b = 1');
+SELECT check_estimated_rows('SELECT a, b, count(*) FROM stxtest GROUP BY a, b');
+-- a is not determined by b, so the dependency works one way only
+SELECT check_estimated_rows('SELECT * FROM stxtest WHERE a = 1 AND b = 1 AND c = 1');
+DROP STATISTICS stxtest_s;
+SELECT check_estimated_rows('SELECT * FROM stxtest WHERE a = 1 AND b = 1');
+SELECT check_estimated_rows('SELECT a, b, count(*) FROM stxtest GROUP BY a, b');
+
+-- only the kinds of statistics asked for are built
+CREATE STATISTICS stxtest_nd (ndistinct) ON a, b FROM stxtest;
+CREATE STATISTICS stxtest_deps (dependencies) ON a, b FROM stxtest;
+ANALYZE stxtest;
+SELECT stxname, stxkeys, stxkind, stxndistinct IS NOT NULL AS nd, stxdependencies IS NOT NULL AS deps
+  FROM pg_statistic_ext WHERE stxrelid = 'stxtest'::regclass ORDER BY stxname;
+SELECT check_estimated_rows('SELECT * FROM stxtest WHERE a = 1 AND b = 1');
+SELECT check_estimated_rows('SELECT a, b, count(*) FROM stxtest GROUP BY a, b');
+DROP STATISTICS stxtest_deps;
+SELECT check_estimated_rows('SELECT * FROM stxtest WHERE a = 1 AND b = 1');
+SELECT check_estimated_rows('SELECT a, b, count(*) FROM stxtest GROUP BY a, b');
+
+-- dropping a column drops the statistics objects including it
+CREATE STATISTICS stxtest_s ON b, c FROM stxtest;
+ALTER TABLE stxtest DROP COLUMN a;
+SELECT stxname, stxkeys, stxkind, stxndistinct IS NOT NULL AS nd, stxdependencies IS NOT NULL AS deps
+  FROM pg_statistic_ext WHERE stxrelid = 'stxtest'::regclass ORDER BY stxname;
+
+DROP TABLE stxtest;
+SELECT count(*) FROM pg_statistic_ext WHERE stxname LIKE 'stxtest%';
+DROP FUNCTION check_estimated_rows(text);
@@ -0,0 +1,48 @@
+--
+-- SUBSCRIPTION
+--
+
+-- Subscriptions are created enabled; disable this one before the launcher
+-- gets to start a worker for it, as there is no publisher to connect to.
+BEGIN;
+SELECT pg_subscription_create('regress_testsub', 'dbname=regress_doesnotexist',
+  'regress_testslot', ARRAY['public.t1', '"My Schema".t2', 'Public.T3']) IS NOT NULL AS created;
+SELECT pg_subscription_disable('regress_testsub');
+COMMIT;
+
+SELECT subname, subenabled, subslotname, subconninfo, subtables
+  FROM pg_subscription WHERE subdbid = (SELECT oid FROM pg_database WHERE datname = current_database());
+-- a disabled subscription has no worker
+SELECT subname, pid, received_lsn FROM pg_stat_subscription;
+-- the replication origin tracking its progress
+SELECT count(*) FROM pg_replication_origin o, pg_subscription s
+  WHERE o.roname = 'pg_' || s.oid AND s.subname = 'regress_testsub';
+
+-- errors
+SELECT pg_subscription_create('regress_testsub', 'dbname=regress_doesnotexist',
+  'regress_testslot', NULL);
+SELECT pg_subscription_create('regress_testsub2', NULL, 'regress_testslot', NULL);
+SELECT pg_subscription_create('regress_testsub2', 'dbname=regress_doesnotexist',
+  'regress_testslot', ARRAY['t1']);
+SELECT pg_subscription_create('regress_testsub2', 'dbname=regress_doesnotexist',
+  'regress_testslot', ARRAY['public.t1', NULL]);
+SELECT pg_subscription_create('regress_testsub2', 'dbname=regress_doesnotexist',
+  'regress_testslot', ARRAY[['public.t1'], ['public.t2']]);
+SELECT pg_subscription_drop('regress_nosuchsub');
+SELECT pg_subscription_enable('regress_nosuchsub');
+SELECT pg_subscription_disable('regress_nosuchsub');
+
+-- only superusers can manage subscriptions
+CREATE ROLE regress_subscription_user;
+SET SESSION AUTHORIZATION regress_subscription_user;
+SELECT pg_subscription_create('regress_testsub2', 'dbname=regress_doesnotexist',
+  'regress_testslot', NULL);
+SELECT pg_subscription_disable('regress_testsub');
+SELECT pg_subscription_drop('regress_testsub');
+RESET SESSION AUTHORIZATION;
+DROP ROLE regress_subscription_user;
+
+-- dropping a subscription drops its replication origin too
+SELECT pg_subscription_drop('regress_testsub');
+SELECT count(*) FROM pg_subscription WHERE subname = 'regress_testsub';
+SELECT count(*) FROM pg_replication_origin WHERE roname LIKE 'pg\_%';
@@ -0,0 +1,225 @@
+# Test built-in session pooling.
+#
+# With session_pool_size = 1, all sessions of a database and role share one
+# pooled backend.  Each of them has to keep its own settings, prepared
+# statements and sequence state; a client that breaks the protocol must only
+# lose its own session; and terminating the pooled backend ends all of its
+# sessions.
+use strict;
+use warnings;
+
+use TestLib;
+use Test::More tests => 16;
+
+use IO::Socket::UNIX;
+use IPC::Run qw(run start pump finish timeout);
+
+my $tempdir       = tempdir;
+my $tempdir_short = tempdir_short;
+
+my $datadir = "$tempdir/data";
+my $logfile = "$tempdir/server.log";
+my $port    = $ENV{PGPORT};
+
+$ENV{PGHOST}     = $tempdir_short;
+$ENV{PGPORT}     = $port;
+$ENV{PGDATABASE} = "postgres";
+
+# Sessions whose server goes away must not take the test down with them.
+$SIG{PIPE} = 'IGNORE';
+
+# Run a query in a dedicated backend, returning its output.
+sub query_result
+{
+	my ($query) = @_;
+	my ($stdout, $stderr);
+
+	local $ENV{PGOPTIONS} = '-c session_pooling=off';
+	run [ 'psql', '-X', '-A', '-t', '-q', '-c', $query ],
+	  '>', \$stdout, '2>', \$stderr
+	  or BAIL_OUT("psql failed: $stderr");
+	chomp($stdout);
+	return $stdout;
+}
+
+# Run a query once a second, until it returns 't' (i.e. SQL boolean true).
+sub poll_query_until
+{
+	my ($query) = @_;
+	my $attempts = 0;
+
+	while ($attempts < 30)
+	{
+		return 1 if query_result($query) eq 't';
+		sleep 1;
+		$attempts++;
+	}
+	return 0;
+}
+
+# A psql session that stays connected, so that several of them can share the
+# pooled backend at the same time.
+sub start_session
+{
+	my $session = { in => '', out => '', err => '', timeout => timeout(60) };
+
+	$session->{handle} = start [ 'psql', '-X', '-A', '-t', '-q', '-f', '-' ],
+	  '<', \$session->{in}, '>', \$session->{out}, '2>', \$session->{err},
+	  $session->{timeout};
+	return $session;
+}
+
+# Run some SQL in a session, returning what it printed to stdout and stderr.
+sub session_query
+{
+	my ($session, $sql) = @_;
+
+	$session->{out} = '';
+	$session->{err} = '';
+	$session->{in} .= "$sql\n\\echo __done__\n";
+	$session->{timeout}->start(60);
+	pump $session->{handle}
+	  until $session->{out} =~ /__done__\n/
+	  || !$session->{handle}->pumpable;
+
+	my $out = $session->{out};
+	$out =~ s/__done__\n$//;
+	chomp($out);
+	return wantarray ? ($out, $session->{err}) : $out;
+}
+
+sub end_session
+{
+	my ($session) = @_;
+
+	$session->{in} .= "\\q\n";
+	eval { finish $session->{handle}; };
+}
+
+# Read one message from the server over a raw protocol connection.
+sub read_message
+{
+	my ($sock) = @_;
+	my ($hdr, $body) = ('', '');
+
+	while (length($hdr) < 5)
+	{
+		return undef
+		  unless sysread($sock, $hdr, 5 - length($hdr), length($hdr));
+	}
+	my ($type, $len) = unpack('aN', $hdr);
+	while (length($body) < $len - 4)
+	{
+		return undef
+		  unless sysread($sock, $body, $len - 4 - length($body),
+			length($body));
+	}
+	return ($type, $body);
+}
+
+# Don't leave the server behind if a test bails out.
+END
+{
+	system('pg_ctl', '-D', $datadir, '-s', '-m', 'immediate', 'stop')
+	  if -e "$datadir/postmaster.pid";
+}
+
+standard_initdb($datadir);
+open my $conf, '>>', "$datadir/postgresql.conf" or die;
+print $conf "session_pool_size = 1\n";
+close $conf;
+system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-l', $logfile, '-o',
+	"-k $tempdir_short --listen-addresses='' -p $port", 'start');
+
+query_result('CREATE SEQUENCE pool_seq');
+
+# The first session becomes the pooled backend, the second is handed over
+# to it.
+my $s1 = start_session();
+my $pid = session_query($s1, 'SELECT pg_backend_pid()');
+poll_query_until('SELECT count(*) = 1 FROM pg_stat_session_pool')
+  or die "Timed out while waiting for pooled backend";
+my $s2 = start_session();
+is(session_query($s2, 'SELECT pg_backend_pid()'),
+	$pid, 'sessions share the pooled backend');
+is(query_result("SELECT sessions FROM pg_stat_session_pool WHERE pid = $pid"),
+	'2', 'pg_stat_session_pool counts the sessions');
+
+# Settings
+session_query($s1, "SET work_mem = '1234kB'");
+is(session_query($s2, 'SHOW work_mem'),
+	'4MB', 'settings of one session are not seen in another');
+is(session_query($s1, 'SHOW work_mem'),
+	'1234kB', 'settings of a session are kept across switches');
+
+# Prepared statements
+session_query($s1, 'PREPARE pool_stmt AS SELECT 42');
+my ($out, $err) = session_query($s2, 'EXECUTE pool_stmt');
+like($err, qr/prepared statement "pool_stmt" does not exist/,
+	'prepared statements of one session are not seen in another');
+is(session_query($s1, 'EXECUTE pool_stmt'),
+	'42', 'prepared statements of a session are kept across switches');
+
+# Sequences
+is(session_query($s1, "SELECT nextval('pool_seq')"), '1', 'nextval');
+is(session_query($s2, "SELECT nextval('pool_seq')"), '2',
+	'nextval in another session');
+is(session_query($s1, "SELECT currval('pool_seq'), lastval()"),
+	'1|1', 'currval and lastval of a session are kept across switches');
+is(session_query($s2, "SELECT currval('pool_seq'), lastval()"),
+	'2|2', 'currval and lastval of another session');
+my $s3 = start_session();
+($out, $err) = session_query($s3, "SELECT currval('pool_seq')");
+like(
+	$err,
+	qr/currval of sequence "pool_seq" is not yet defined in this session/,
+	'currval is not defined in a new session');
+end_session($s3);
+poll_query_until(
+	"SELECT sessions = 2 FROM pg_stat_session_pool WHERE pid = $pid")
+  or die "Timed out while waiting for session to close";
+
+# A client that sends garbage only loses its own session.
+my $sock = IO::Socket::UNIX->new(Peer => "$tempdir_short/.s.PGSQL.$port")
+  or die "could not connect: $!";
+my $user   = getpwuid($<);
+my $params = "user\0$user\0database\0postgres\0\0";
+syswrite($sock, pack('NN', 8 + length($params), 196608) . $params);
+my ($type, $body);
+do
+{
+	($type, $body) = read_message($sock);
+	die "connection closed during startup" unless defined $type;
+} while ($type ne 'Z');
+is(session_query($s1, 'SELECT sessions FROM pg_stat_session_pool'),
+	'3', 'raw connection joined the pooled backend');
+
+syswrite($sock, pack('aN', 'Y', 4));
+($type, $body) = read_message($sock);
+like($body, qr/invalid frontend message type 89/,
+	'protocol violation is reported to the client');
+do
+{
+	($type, $body) = read_message($sock);
+} while (defined $type);
+close $sock;
+is(session_query($s1, 'SELECT pg_backend_pid()'),
+	$pid, 'other sessions survive a protocol violation');
+poll_query_until(
+	"SELECT sessions = 2 FROM pg_stat_session_pool WHERE pid = $pid")
+  or die "Timed out while waiting for session to close";
+
+# Terminating the pooled backend ends all of its sessions.
+query_result("SELECT pg_terminate_backend($pid)");
+poll_query_until('SELECT count(*) = 0 FROM pg_stat_session_pool')
+  or die "Timed out while waiting for pooled backend to exit";
+($out, $err) = session_query($s1, 'SELECT 1');
+like($err, qr/terminating connection|server closed the connection/,
+	'pg_terminate_backend ends the active session');
+($out, $err) = session_query($s2, 'SELECT 1');
+like($err, qr/terminating connection|server closed the connection/,
+	'pg_terminate_backend ends the other sessions');
+end_session($s1);
+end_session($s2);
+
+system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-m', 'fast', 'stop');
@@ -0,0 +1,177 @@
+# Test the shared catalog cache (shared_catcache_entries).
+#
+# Catalog entries are changed by one session after others have loaded them,
+# and have to be seen changed by sessions started later, which fill their
+# caches from shared memory, as well as by sessions that were already
+# running.  With many more entries in use than the cache holds, entries are
+# replaced all the time, in every partition; with fewer than there are
+# partitions, some partitions hold no entries at all.
+use strict;
+use warnings;
+
+use TestLib;
+use Test::More tests => 8;
+
+use IPC::Run qw(run start pump finish timeout);
+
+my $tempdir       = tempdir;
+my $tempdir_short = tempdir_short;
+
+my $datadir = "$tempdir/data";
+my $logfile = "$tempdir/server.log";
+my $port    = $ENV{PGPORT};
+
+$ENV{PGHOST}     = $tempdir_short;
+$ENV{PGPORT}     = $port;
+$ENV{PGDATABASE} = "postgres";
+
+sub append_to_file
+{
+	my ($filename, $str) = @_;
+
+	open my $fh, ">>", $filename or die "could not open file $filename";
+	print $fh $str;
+	close $fh;
+}
+
+sub start_server
+{
+	system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-l', $logfile, '-o',
+		"-k $tempdir_short --listen-addresses='' -p $port", 'start');
+}
+
+# Run some SQL in a new session, returning its output.
+sub query_result
+{
+	my ($sql, $dbname) = @_;
+	my ($stdout, $stderr);
+
+	$dbname = 'postgres' unless defined $dbname;
+	run [ 'psql', '-X', '-A', '-t', '-q', '-v', 'ON_ERROR_STOP=1', '-d',
+		$dbname, '-c', $sql ], '>', \$stdout, '2>', \$stderr
+	  or BAIL_OUT("psql failed: $stderr");
+	chomp($stdout);
+	return $stdout;
+}
+
+# A psql session that stays connected, keeping its catalog cache.
+sub start_session
+{
+	my $session = { in => '', out => '', err => '', timeout => timeout(60) };
+
+	$session->{handle} = start [ 'psql', '-X', '-A', '-t', '-q', '-f', '-' ],
+	  '<', \$session->{in}, '>', \$session->{out}, '2>', \$session->{err},
+	  $session->{timeout};
+	return $session;
+}
+
+sub session_query
+{
+	my ($session, $sql) = @_;
+
+	$session->{out} = '';
+	$session->{in} .= "$sql\n\\echo __done__\n";
+	$session->{timeout}->start(60);
+	pump $session->{handle} until $session->{out} =~ /__done__\n/;
+
+	my $out = $session->{out};
+	$out =~ s/__done__\n$//;
+	chomp($out);
+	return $out;
+}
+
+sub end_session
+{
+	my ($session) = @_;
+
+	$session->{in} .= "\\q\n";
+	eval { finish $session->{handle}; };
+}
+
+# Don't leave the server behind if a test bails out.
+END
+{
+	system('pg_ctl', '-D', $datadir, '-s', '-m', 'immediate', 'stop')
+	  if -e "$datadir/postmaster.pid";
+}
+
+standard_initdb($datadir);
+append_to_file("$datadir/postgresql.conf", "shared_catcache_entries = 64\n");
+start_server();
+
+# Entries of database-local and shared catalogs
+query_result(
+	q{
+CREATE TABLE sc_tab (a int);
+CREATE FUNCTION sc_func() RETURNS int LANGUAGE sql AS 'SELECT 1';
+CREATE ROLE regress_sc_role LOGIN;
+});
+my $load_query =
+  "SELECT sc_func(), pg_has_role('regress_sc_role', 'USAGE') FROM sc_tab";
+my $running = start_session();
+is(session_query($running, "$load_query UNION ALL SELECT 1, true"),
+	'1|t', 'running session has loaded entries');
+query_result($load_query) for 1 .. 2;
+
+query_result(
+	q{
+ALTER TABLE sc_tab RENAME TO sc_tab2;
+CREATE OR REPLACE FUNCTION sc_func() RETURNS int LANGUAGE sql AS 'SELECT 2';
+ALTER ROLE regress_sc_role RENAME TO regress_sc_role2;
+});
+is(query_result("SELECT to_regclass('sc_tab') IS NULL, count(*) FROM sc_tab2"),
+	't|0', 'new session sees renamed table');
+is(query_result('SELECT sc_func()'), '2',
+	'new session sees replaced function');
+is( query_result(
+		"SELECT to_regrole('regress_sc_role') IS NULL, pg_has_role('regress_sc_role2', 'USAGE')"
+	),
+	't|t',
+	'new session sees renamed role');
+is(session_query($running, 'SELECT sc_func()'),
+	'2', 'running session sees replaced function');
+end_session($running);
+
+# Many more functions than the cache holds, changed all at once
+query_result(
+	q{
+DO $$
+BEGIN
+    FOR i IN 1..200 LOOP
+        EXECUTE format('CREATE FUNCTION sc_f%s() RETURNS int LANGUAGE sql AS ''SELECT %s''', i, i);
+    END LOOP;
+END
+$$;
+});
+my $sum_query = 'SELECT ' . join(' + ', map { "sc_f$_()" } 1 .. 200);
+query_result($sum_query) for 1 .. 2;
+query_result(
+	q{
+DO $$
+BEGIN
+    FOR i IN 1..200 LOOP
+        EXECUTE format('CREATE OR REPLACE FUNCTION sc_f%s() RETURNS int LANGUAGE sql AS ''SELECT %s''', i, 2 * i);
+    END LOOP;
+END
+$$;
+});
+is(query_result($sum_query), '40200', 'replaced entries are not found');
+
+# Entries of a dropped database don't linger
+query_result('CREATE DATABASE sc_db');
+query_result(q{CREATE FUNCTION sc_func() RETURNS int LANGUAGE sql AS 'SELECT 1'},
+	'sc_db');
+query_result('SELECT sc_func()', 'sc_db') for 1 .. 2;
+query_result('DROP DATABASE sc_db');
+query_result('CREATE DATABASE sc_db');
+is(query_result(q{SELECT to_regprocedure('sc_func()') IS NULL}, 'sc_db'),
+	't', 'function of dropped database is not found');
+
+# Fewer entries than partitions
+system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-m', 'fast', 'stop');
+append_to_file("$datadir/postgresql.conf", "shared_catcache_entries = 8\n");
+start_server();
+query_result($sum_query) for 1 .. 2;
+is(query_result($sum_query), '40200', 'cache with fewer entries than partitions');
+
+system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-m', 'fast', 'stop');
@@ -0,0 +1,311 @@
+# Test the pgoutput plugin, and the application of its changes by a
+# subscription.
+#
+# A publisher server decodes its changes with pgoutput, which is first
+# checked directly through the SQL interface.  A subscriber server then
+# applies inserts, updates and deletes to tables identified by a primary
+# key, by an index with included columns, and by all columns; including a
+# row that is being updated concurrently by a local transaction.
+use strict;
+use warnings;
+
+use TestLib;
+use Test::More tests => 14;
+
+use IPC::Run qw(run start);
+
+my $tempdir       = tempdir;
+my $tempdir_short = tempdir_short;
+
+my $pub_datadir = "$tempdir/data_publisher";
+my $sub_datadir = "$tempdir/data_subscriber";
+my $pub_log     = "$tempdir/publisher.log";
+my $sub_log     = "$tempdir/subscriber.log";
+
+my $port_pub = $ENV{PGPORT};
+my $port_sub = $port_pub + 1;
+
+my $connstr_pub = "port=$port_pub";
+my $connstr_sub = "port=$port_sub";
+
+$ENV{PGHOST}     = $tempdir_short;
+$ENV{PGDATABASE} = "postgres";
+
+sub append_to_file
+{
+	my ($filename, $str) = @_;
+
+	open my $fh, ">>", $filename or die "could not open file $filename";
+	print $fh $str;
+	close $fh;
+}
+
+sub slurp_file
+{
+	my ($filename) = @_;
+	local $/;
+
+	open my $fh, "<", $filename or die "could not open file $filename";
+	my $contents = <$fh>;
+	close $fh;
+	return $contents;
+}
+
+sub start_server
+{
+	my ($datadir, $port, $logfile) = @_;
+
+	system_or_bail('pg_ctl', '-D', $datadir, '-s', '-w', '-l', $logfile,
+		'-o', "-k $tempdir_short --listen-addresses='' -p $port", 'start');
+}
+
+sub run_sql
+{
+	my ($connstr, $sql) = @_;
+
+	system_or_bail('psql', '-q', '--no-psqlrc', '-v', 'ON_ERROR_STOP=1',
+		'-d', $connstr, '-c', $sql);
+}
+
+# Run a query and return its output, unaligned and without headers, and
+# what it printed to stderr.
+sub query_result
+{
+	my ($connstr, $query) = @_;
+	my ($stdout, $stderr);
+
+	run [ 'psql', '-q', '-A', '-t', '--no-psqlrc', '-d', $connstr, '-c',
+		$query ], '>', \$stdout, '2>', \$stderr;
+	chomp($stdout);
+	return wantarray ? ($stdout, $stderr) : $stdout;
+}
+
+# Run a query once a second, until it returns 't' (i.e. SQL boolean true).
+sub poll_query_until
+{
+	my ($query, $connstr) = @_;
+
+	my $max_attempts = 30;
+	my $attempts     = 0;
+	my ($stdout, $stderr);
+
+	while ($attempts < $max_attempts)
+	{
+		my $cmd = [ 'psql', '-At', '-c', "$query", '-d', "$connstr" ];
+		my $result = run $cmd, '>', \$stdout, '2>', \$stderr;
+
+		chomp($stdout);
+		if ($stdout eq "t")
+		{
+			return 1;
+		}
+
+		# Wait a second before retrying.
+		sleep 1;
+		$attempts++;
+	}
+
+	diag $stderr;
+	return 0;
+}
+
+# Compare the result of a query on the publisher and the subscriber.
+sub check_subscriber_query
+{
+	my ($query, $test_name) = @_;
+
+	is(query_result($connstr_sub, $query),
+		query_result($connstr_pub, $query), $test_name);
+}
+
+# Don't leave the servers behind if a test bails out.
+END
+{
+	foreach my $datadir ($pub_datadir, $sub_datadir)
+	{
+		system('pg_ctl', '-D', $datadir, '-s', '-m', 'immediate', 'stop')
+		  if -e "$datadir/postmaster.pid";
+	}
+}
+
+# The tables, the same on both servers.
+my $ddl = q{
+CREATE TABLE tab_key (a int PRIMARY KEY, b text);
+CREATE TABLE tab_include (a int NOT NULL, b int NOT NULL, c text);
+CREATE UNIQUE INDEX tab_include_idx ON tab_include (a) INCLUDE (b);
+ALTER TABLE tab_include REPLICA IDENTITY USING INDEX tab_include_idx;
+CREATE TABLE tab_full (a int, b text);
+ALTER TABLE tab_full REPLICA IDENTITY FULL;
+CREATE TABLE tab_notrep (a int PRIMARY KEY);
+};
+
+# Set up the publisher.
+standard_initdb($pub_datadir);
+append_to_file(
+	"$pub_datadir/postgresql.conf", qq(
+wal_level = logical
+max_wal_senders = 4
+max_replication_slots = 4
+max_logical_replication_workers = 0
+));
+append_to_file("$pub_datadir/pg_hba.conf", qq(
+local replication all trust
+));
+start_server($pub_datadir, $port_pub, $pub_log);
+run_sql($connstr_pub, $ddl);
+
+# pgoutput, used directly: a transaction is sent as BEGIN, the description
+# of each relation before its first change, the changes and COMMIT.
+run_sql($connstr_pub,
+	"SELECT pg_create_logical_replication_slot('regress_peek_slot', 'pgoutput')"
+);
+run_sql(
+	$connstr_pub, q{
+INSERT INTO tab_key VALUES (1000, 'peek');
+BEGIN;
+INSERT INTO tab_notrep VALUES (1000);
+UPDATE tab_key SET b = 'peeked' WHERE a = 1000;
+DELETE FROM tab_key WHERE a = 1000;
+COMMIT;
+INSERT INTO tab_notrep VALUES (1001);
+});
+
+my $peek_query = q{
+SELECT string_agg(chr(get_byte(data, 0)), '' ORDER BY n)
+  FROM pg_logical_slot_peek_binary_changes('regress_peek_slot', NULL, NULL,
+                                           'proto_version', '1'%s)
+       WITH ORDINALITY AS c(location, xid, data, n)};
+is(query_result($connstr_pub, sprintf($peek_query, '')),
+	'BRICBRIUDCBIC', 'pgoutput sends all changes');
+is(query_result($connstr_pub,
+		sprintf($peek_query, ", 'table', 'public.tab_key'")),
+	'BRICBUDC', 'pgoutput skips changes to tables not listed');
+
+is( query_result(
+		$connstr_pub,
+		sprintf($peek_query,
+			", 'table', 'public.tab_key', 'row_filter', 'public.tab_key: b = ''peeked'''"
+		)),
+	'BRUC',
+	'pgoutput skips rows not matching the row filter');
+
+my ($stdout, $stderr) = query_result($connstr_pub,
+	"SELECT count(*) FROM pg_logical_slot_peek_binary_changes('regress_peek_slot', NULL, NULL)"
+);
+like($stderr, qr/proto_version option missing/,
+	'pgoutput requires proto_version');
+($stdout, $stderr) = query_result($connstr_pub,
+	"SELECT count(*) FROM pg_logical_slot_peek_binary_changes('regress_peek_slot', NULL, NULL, 'proto_version', '1', 'table', 'tab_key')"
+);
+like(
+	$stderr,
+	qr/table name "tab_key" must be qualified with a schema name/,
+	'pgoutput requires qualified table names');
+($stdout, $stderr) = query_result($connstr_pub,
+	sprintf($peek_query, ", 'row_filter', 'public.tab_key: true; SELECT 1'"));
+like(
+	$stderr,
+	qr/invalid row filter for table "tab_key": " true; SELECT 1"/,
+	'pgoutput rejects row filters of several statements');
+run_sql($connstr_pub,
+	"SELECT pg_drop_replication_slot('regress_peek_slot')");
+
+# Set up the subscriber, applying changes to all tables but tab_notrep.
+run_sql($connstr_pub,
+	"SELECT pg_create_logical_replication_slot('regress_sub_slot', 'pgoutput')"
+);
+
+standard_initdb($sub_datadir);
+append_to_file(
+	"$sub_datadir/postgresql.conf", qq(
+max_worker_processes = 8
+max_logical_replication_workers = 4
+));
+start_server($sub_datadir, $port_sub, $sub_log);
+run_sql($connstr_sub, $ddl);
+run_sql($connstr_sub,
+"SELECT pg_subscription_create('regress_sub', '$connstr_pub host=$tempdir_short dbname=postgres', 'regress_sub_slot', ARRAY['public.tab_key', 'public.tab_include', 'public.tab_full'])"
+);
+
+# Wait until a row inserted after everything else has arrived.
+sub wait_for_marker
+{
+	my ($marker) = @_;
+
+	run_sql($connstr_pub, "INSERT INTO tab_key VALUES ($marker, 'marker')");
+	poll_query_until("SELECT count(*) = 1 FROM tab_key WHERE a = $marker",
+		$connstr_sub)
+	  or die "Timed out while waiting for subscriber to catch up";
+}
+
+run_sql(
+	$connstr_pub, q{
+INSERT INTO tab_key SELECT i, 'row ' || i FROM generate_series(1, 100) i;
+INSERT INTO tab_include
+  SELECT i, i * 10, 'row ' || i FROM generate_series(1, 100) i;
+INSERT INTO tab_full SELECT i, 'row ' || i FROM generate_series(1, 100) i;
+INSERT INTO tab_notrep SELECT i FROM generate_series(1, 100) i;
+
+UPDATE tab_key SET b = 'updated' WHERE a <= 10;
+UPDATE tab_key SET a = a + 1000 WHERE a = 50;
+DELETE FROM tab_key WHERE a > 90 AND a <= 100;
+
+UPDATE tab_include SET c = 'updated' WHERE a <= 10;
+UPDATE tab_include SET b = -b WHERE a > 10 AND a <= 20;
+DELETE FROM tab_include WHERE a > 90;
+
+UPDATE tab_full SET b = 'updated' WHERE a <= 10;
+DELETE FROM tab_full WHERE a > 90;
+});
+wait_for_marker(-1);
+
+check_subscriber_query(
+	q{SELECT count(*), sum(a), md5(string_agg(b, ',' ORDER BY a)) FROM tab_key},
+	'changes to table with primary key applied');
+check_subscriber_query(
+	q{SELECT count(*), sum(b), md5(string_agg(c, ',' ORDER BY a)) FROM tab_include},
+	'changes to table with included columns in replica identity applied');
+check_subscriber_query(
+	q{SELECT count(*), sum(a), md5(string_agg(b, ',' ORDER BY a)) FROM tab_full},
+	'changes to table with replica identity full applied');
+is(query_result($connstr_sub, 'SELECT count(*) FROM tab_notrep'),
+	'0', 'changes to table not subscribed to skipped');
+
+# Remote changes to rows being updated locally wait for the local
+# transaction, and are then applied to the local version of the row.
+my $local_sql = q{
+BEGIN;
+UPDATE tab_key SET b = 'local' WHERE a = 1;
+UPDATE tab_full SET b = 'local' WHERE a = 2;
+SELECT pg_sleep(3);
+COMMIT;
+};
+my $local_psql = start [ 'psql', '-q', '--no-psqlrc', '-d', $connstr_sub,
+	'-f', '-' ], '<', \$local_sql, '>', \$stdout, '2>', \$stderr;
+poll_query_until(
+	"SELECT count(*) = 1 FROM pg_stat_activity WHERE query LIKE 'SELECT pg_sleep%'",
+	$connstr_sub)
+  or die "Timed out while waiting for local transaction";
+
+run_sql(
+	$connstr_pub, q{
+UPDATE tab_key SET b = 'remote' WHERE a = 1;
+DELETE FROM tab_full WHERE a = 2;
+});
+wait_for_marker(-2);
+$local_psql->finish;
+
+is(query_result($connstr_sub, 'SELECT b FROM tab_key WHERE a = 1'),
+	'remote', 'remote update applied after concurrent local update');
+is(query_result($connstr_sub, 'SELECT count(*) FROM tab_full WHERE a = 2'),
+	'1', 'remote delete of old row version leaves locally updated row');
+is(query_result($connstr_sub, 'SELECT count(*) FROM tab_full WHERE a = 3'),
+	'1', 'unrelated rows of table with replica identity full kept');
+unlike(slurp_file($sub_log), qr/tuple concurrently updated/,
+	'apply worker did not fail on concurrent update');
+
+run_sql($connstr_sub, "SELECT pg_subscription_drop('regress_sub')");
+system_or_bail('pg_ctl', '-D', $sub_datadir, '-s', '-w', '-m', 'fast',
+	'stop');
+system_or_bail('pg_ctl', '-D', $pub_datadir, '-s', '-w', '-m', 'fast',
+	'stop');
@@ -0,0 +1,13 @@
+/* src/interfaces/ecpg/include/decimal.h */
+
+#ifndef _ECPG_DECIMAL_H
+#define _ECPG_DECIMAL_H
+
+#include <ecpg_informix.h>
+
+#ifndef _ECPGLIB_H				/* source created by ecpg which defines this
+								 * symbol */
+typedef decimal dec_t;
+#endif   /* ndef _ECPGLIB_H */
+
+#endif   /* ndef _ECPG_DECIMAL_H */
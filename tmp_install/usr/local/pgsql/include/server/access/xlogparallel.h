@@ -0,0 +1,36 @@
+/*-------------------------------------------------------------------------
+ *
+ * xlogparallel.h
+ *	  Parallel replay of WAL records by background workers
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/access/xlogparallel.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef XLOGPARALLEL_H
+#define XLOGPARALLEL_H
+
+#include "access/xlogreader.h"
+#include "storage/block.h"
+#include "storage/relfilenode.h"
+
+/* GUC variable */
+extern int	recovery_workers;
+
+/* >= 0 in a redo worker, -1 everywhere else */
+extern int	ParallelRedoWorkerNumber;
+
+/* used by the startup process */
+extern void ParallelRedoStart(void);
+extern bool ParallelRedoDispatch(XLogReaderState *record);
+extern void ParallelRedoWaitForWorkers(void);
+extern void ParallelRedoShutdown(void);
+
+/* used by redo workers */
+extern void ParallelRedoReportInvalidPage(RelFileNode node, ForkNumber forkno,
+							  BlockNumber blkno, bool present);
+
+#endif   /* XLOGPARALLEL_H */
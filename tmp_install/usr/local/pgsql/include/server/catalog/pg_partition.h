@@ -0,0 +1,61 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_partition.h
+ *	  definition of the system "partition" relation (pg_partition)
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/catalog/pg_partition.h
+ *
+ * NOTES
+ *	  the genbki.pl script reads this file and generates .bki
+ *	  information from the DATA() statements.
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef PG_PARTITION_H
+#define PG_PARTITION_H
+
+#include "catalog/genbki.h"
+
+/* ----------------
+ *		pg_partition definition.  cpp turns this into
+ *		typedef struct FormData_pg_partition
+ * ----------------
+ */
+#define PartitionRelationId 6113
+
+CATALOG(pg_partition,6113) BKI_WITHOUT_OIDS
+{
+	Oid			partrelid;		/* OID of partition */
+	Oid			partparent;		/* OID of partitioned table it belongs to */
+
+#ifdef CATALOG_VARLEN			/* variable-length fields start here */
+	pg_node_tree partbound;		/* nodeToString representation of the
+								 * partition's PartitionBoundSpec */
+#endif
+} FormData_pg_partition;
+
+/* ----------------
+ *		Form_pg_partition corresponds to a pointer to a tuple with
+ *		the format of pg_partition relation.
+ * ----------------
+ */
+typedef FormData_pg_partition *Form_pg_partition;
+
+/* ----------------
+ *		compiler constants for pg_partition
+ * ----------------
+ */
+#define Natts_pg_partition				3
+#define Anum_pg_partition_partrelid		1
+#define Anum_pg_partition_partparent	2
+#define Anum_pg_partition_partbound		3
+
+/* ----------------
+ *		pg_partition has no initial contents
+ * ----------------
+ */
+
+#endif   /* PG_PARTITION_H */
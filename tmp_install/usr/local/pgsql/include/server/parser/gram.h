@@ -0,0 +1,572 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_BASE_YY_GRAM_H_INCLUDED
+# define YY_BASE_YY_GRAM_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int base_yydebug;
+#endif
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    IDENT = 258,                   /* IDENT  */
+    FCONST = 259,                  /* FCONST  */
+    SCONST = 260,                  /* SCONST  */
+    BCONST = 261,                  /* BCONST  */
+    XCONST = 262,                  /* XCONST  */
+    Op = 263,                      /* Op  */
+    ICONST = 264,                  /* ICONST  */
+    PARAM = 265,                   /* PARAM  */
+    TYPECAST = 266,                /* TYPECAST  */
+    DOT_DOT = 267,                 /* DOT_DOT  */
+    COLON_EQUALS = 268,            /* COLON_EQUALS  */
+    EQUALS_GREATER = 269,          /* EQUALS_GREATER  */
+    LESS_EQUALS = 270,             /* LESS_EQUALS  */
+    GREATER_EQUALS = 271,          /* GREATER_EQUALS  */
+    NOT_EQUALS = 272,              /* NOT_EQUALS  */
+    ABORT_P = 273,                 /* ABORT_P  */
+    ABSOLUTE_P = 274,              /* ABSOLUTE_P  */
+    ACCESS = 275,                  /* ACCESS  */
+    ACTION = 276,                  /* ACTION  */
+    ADD_P = 277,                   /* ADD_P  */
+    ADMIN = 278,                   /* ADMIN  */
+    AFTER = 279,                   /* AFTER  */
+    AGGREGATE = 280,               /* AGGREGATE  */
+    ALL = 281,                     /* ALL  */
+    ALSO = 282,                    /* ALSO  */
+    ALTER = 283,                   /* ALTER  */
+    ALWAYS = 284,                  /* ALWAYS  */
+    ANALYSE = 285,                 /* ANALYSE  */
+    ANALYZE = 286,                 /* ANALYZE  */
+    AND = 287,                     /* AND  */
+    ANY = 288,                     /* ANY  */
+    ARRAY = 289,                   /* ARRAY  */
+    AS = 290,                      /* AS  */
+    ASC = 291,                     /* ASC  */
+    ASSERTION = 292,               /* ASSERTION  */
+    ASSIGNMENT = 293,              /* ASSIGNMENT  */
+    ASYMMETRIC = 294,              /* ASYMMETRIC  */
+    AT = 295,                      /* AT  */
+    ATTRIBUTE = 296,               /* ATTRIBUTE  */
+    AUTHORIZATION = 297,           /* AUTHORIZATION  */
+    BACKWARD = 298,                /* BACKWARD  */
+    BEFORE = 299,                  /* BEFORE  */
+    BEGIN_P = 300,                 /* BEGIN_P  */
+    BETWEEN = 301,                 /* BETWEEN  */
+    BIGINT = 302,                  /* BIGINT  */
+    BINARY = 303,                  /* BINARY  */
+    BIT = 304,                     /* BIT  */
+    BOOLEAN_P = 305,               /* BOOLEAN_P  */
+    BOTH = 306,                    /* BOTH  */
+    BY = 307,                      /* BY  */
+    CACHE = 308,                   /* CACHE  */
+    CALLED = 309,                  /* CALLED  */
+    CASCADE = 310,                 /* CASCADE  */
+    CASCADED = 311,                /* CASCADED  */
+    CASE = 312,                    /* CASE  */
+    CAST = 313,                    /* CAST  */
+    CATALOG_P = 314,               /* CATALOG_P  */
+    CHAIN = 315,                   /* CHAIN  */
+    CHAR_P = 316,                  /* CHAR_P  */
+    CHARACTER = 317,               /* CHARACTER  */
+    CHARACTERISTICS = 318,         /* CHARACTERISTICS  */
+    CHECK = 319,                   /* CHECK  */
+    CHECKPOINT = 320,              /* CHECKPOINT  */
+    CLASS = 321,                   /* CLASS  */
+    CLOSE = 322,                   /* CLOSE  */
+    CLUSTER = 323,                 /* CLUSTER  */
+    COALESCE = 324,                /* COALESCE  */
+    COLLATE = 325,                 /* COLLATE  */
+    COLLATION = 326,               /* COLLATION  */
+    COLUMN = 327,                  /* COLUMN  */
+    COMMENT = 328,                 /* COMMENT  */
+    COMMENTS = 329,                /* COMMENTS  */
+    COMMIT = 330,                  /* COMMIT  */
+    COMMITTED = 331,               /* COMMITTED  */
+    CONCURRENTLY = 332,            /* CONCURRENTLY  */
+    CONFIGURATION = 333,           /* CONFIGURATION  */
+    CONFLICT = 334,                /* CONFLICT  */
+    CONNECTION = 335,              /* CONNECTION  */
+    CONSTRAINT = 336,              /* CONSTRAINT  */
+    CONSTRAINTS = 337,             /* CONSTRAINTS  */
+    CONTENT_P = 338,               /* CONTENT_P  */
+    CONTINUE_P = 339,              /* CONTINUE_P  */
+    CONVERSION_P = 340,            /* CONVERSION_P  */
+    COPY = 341,                    /* COPY  */
+    COST = 342,                    /* COST  */
+    CREATE = 343,                  /* CREATE  */
+    CROSS = 344,                   /* CROSS  */
+    CSV = 345,                     /* CSV  */
+    CUBE = 346,                    /* CUBE  */
+    CURRENT_P = 347,               /* CURRENT_P  */
+    CURRENT_CATALOG = 348,         /* CURRENT_CATALOG  */
+    CURRENT_DATE = 349,            /* CURRENT_DATE  */
+    CURRENT_ROLE = 350,            /* CURRENT_ROLE  */
+    CURRENT_SCHEMA = 351,          /* CURRENT_SCHEMA  */
+    CURRENT_TIME = 352,            /* CURRENT_TIME  */
+    CURRENT_TIMESTAMP = 353,       /* CURRENT_TIMESTAMP  */
+    CURRENT_USER = 354,            /* CURRENT_USER  */
+    CURSOR = 355,                  /* CURSOR  */
+    CYCLE = 356,                   /* CYCLE  */
+    DATA_P = 357,                  /* DATA_P  */
+    DATABASE = 358,                /* DATABASE  */
+    DAY_P = 359,                   /* DAY_P  */
+    DEALLOCATE = 360,              /* DEALLOCATE  */
+    DEC = 361,                     /* DEC  */
+    DECIMAL_P = 362,               /* DECIMAL_P  */
+    DECLARE = 363,                 /* DECLARE  */
+    DEFAULT = 364,                 /* DEFAULT  */
+    DEFAULTS = 365,                /* DEFAULTS  */
+    DEFERRABLE = 366,              /* DEFERRABLE  */
+    DEFERRED = 367,                /* DEFERRED  */
+    DEFINER = 368,                 /* DEFINER  */
+    DELETE_P = 369,                /* DELETE_P  */
+    DELIMITER = 370,               /* DELIMITER  */
+    DELIMITERS = 371,              /* DELIMITERS  */
+    DESC = 372,                    /* DESC  */
+    DICTIONARY = 373,              /* DICTIONARY  */
+    DISABLE_P = 374,               /* DISABLE_P  */
+    DISCARD = 375,                 /* DISCARD  */
+    DISTINCT = 376,                /* DISTINCT  */
+    DO = 377,                      /* DO  */
+    DOCUMENT_P = 378,              /* DOCUMENT_P  */
+    DOMAIN_P = 379,                /* DOMAIN_P  */
+    DOUBLE_P = 380,                /* DOUBLE_P  */
+    DROP = 381,                    /* DROP  */
+    EACH = 382,                    /* EACH  */
+    ELSE = 383,                    /* ELSE  */
+    ENABLE_P = 384,                /* ENABLE_P  */
+    ENCODING = 385,                /* ENCODING  */
+    ENCRYPTED = 386,               /* ENCRYPTED  */
+    END_P = 387,                   /* END_P  */
+    ENUM_P = 388,                  /* ENUM_P  */
+    ESCAPE = 389,                  /* ESCAPE  */
+    EVENT = 390,                   /* EVENT  */
+    EXCEPT = 391,                  /* EXCEPT  */
+    EXCLUDE = 392,                 /* EXCLUDE  */
+    EXCLUDING = 393,               /* EXCLUDING  */
+    EXCLUSIVE = 394,               /* EXCLUSIVE  */
+    EXECUTE = 395,                 /* EXECUTE  */
+    EXISTS = 396,                  /* EXISTS  */
+    EXPLAIN = 397,                 /* EXPLAIN  */
+    EXTENSION = 398,               /* EXTENSION  */
+    EXTERNAL = 399,                /* EXTERNAL  */
+    EXTRACT = 400,                 /* EXTRACT  */
+    FALSE_P = 401,                 /* FALSE_P  */
+    FAMILY = 402,                  /* FAMILY  */
+    FETCH = 403,                   /* FETCH  */
+    FILTER = 404,                  /* FILTER  */
+    FIRST_P = 405,                 /* FIRST_P  */
+    FLOAT_P = 406,                 /* FLOAT_P  */
+    FOLLOWING = 407,               /* FOLLOWING  */
+    FOR = 408,                     /* FOR  */
+    FORCE = 409,                   /* FORCE  */
+    FOREIGN = 410,                 /* FOREIGN  */
+    FORWARD = 411,                 /* FORWARD  */
+    FREEZE = 412,                  /* FREEZE  */
+    FROM = 413,                    /* FROM  */
+    FULL = 414,                    /* FULL  */
+    FUNCTION = 415,                /* FUNCTION  */
+    FUNCTIONS = 416,               /* FUNCTIONS  */
+    GLOBAL = 417,                  /* GLOBAL  */
+    GRANT = 418,                   /* GRANT  */
+    GRANTED = 419,                 /* GRANTED  */
+    GREATEST = 420,                /* GREATEST  */
+    GROUP_P = 421,                 /* GROUP_P  */
+    GROUPING = 422,                /* GROUPING  */
+    HANDLER = 423,                 /* HANDLER  */
+    HAVING = 424,                  /* HAVING  */
+    HEADER_P = 425,                /* HEADER_P  */
+    HOLD = 426,                    /* HOLD  */
+    HOUR_P = 427,                  /* HOUR_P  */
+    IDENTITY_P = 428,              /* IDENTITY_P  */
+    IF_P = 429,                    /* IF_P  */
+    ILIKE = 430,                   /* ILIKE  */
+    IMMEDIATE = 431,               /* IMMEDIATE  */
+    IMMUTABLE = 432,               /* IMMUTABLE  */
+    IMPLICIT_P = 433,              /* IMPLICIT_P  */
+    IMPORT_P = 434,                /* IMPORT_P  */
+    IN_P = 435,                    /* IN_P  */
+    INCLUDE = 436,                 /* INCLUDE  */
+    INCLUDING = 437,               /* INCLUDING  */
+    INCREMENT = 438,               /* INCREMENT  */
+    INDEX = 439,                   /* INDEX  */
+    INDEXES = 440,                 /* INDEXES  */
+    INHERIT = 441,                 /* INHERIT  */
+    INHERITS = 442,                /* INHERITS  */
+    INITIALLY = 443,               /* INITIALLY  */
+    INLINE_P = 444,                /* INLINE_P  */
+    INNER_P = 445,                 /* INNER_P  */
+    INOUT = 446,                   /* INOUT  */
+    INPUT_P = 447,                 /* INPUT_P  */
+    INSENSITIVE = 448,             /* INSENSITIVE  */
+    INSERT = 449,                  /* INSERT  */
+    INSTEAD = 450,                 /* INSTEAD  */
+    INT_P = 451,                   /* INT_P  */
+    INTEGER = 452,                 /* INTEGER  */
+    INTERSECT = 453,               /* INTERSECT  */
+    INTERVAL = 454,                /* INTERVAL  */
+    INTO = 455,                    /* INTO  */
+    INVOKER = 456,                 /* INVOKER  */
+    IS = 457,                      /* IS  */
+    ISNULL = 458,                  /* ISNULL  */
+    ISOLATION = 459,               /* ISOLATION  */
+    JOIN = 460,                    /* JOIN  */
+    KEY = 461,                     /* KEY  */
+    LABEL = 462,                   /* LABEL  */
+    LANGUAGE = 463,                /* LANGUAGE  */
+    LARGE_P = 464,                 /* LARGE_P  */
+    LAST_P = 465,                  /* LAST_P  */
+    LATERAL_P = 466,               /* LATERAL_P  */
+    LEADING = 467,                 /* LEADING  */
+    LEAKPROOF = 468,               /* LEAKPROOF  */
+    LEAST = 469,                   /* LEAST  */
+    LEFT = 470,                    /* LEFT  */
+    LEVEL = 471,                   /* LEVEL  */
+    LIKE = 472,                    /* LIKE  */
+    LIMIT = 473,                   /* LIMIT  */
+    LISTEN = 474,                  /* LISTEN  */
+    LOAD = 475,                    /* LOAD  */
+    LOCAL = 476,                   /* LOCAL  */
+    LOCALTIME = 477,               /* LOCALTIME  */
+    LOCALTIMESTAMP = 478,          /* LOCALTIMESTAMP  */
+    LOCATION = 479,                /* LOCATION  */
+    LOCK_P = 480,                  /* LOCK_P  */
+    LOCKED = 481,                  /* LOCKED  */
+    LOGGED = 482,                  /* LOGGED  */
+    MAPPING = 483,                 /* MAPPING  */
+    MATCH = 484,                   /* MATCH  */
+    MATERIALIZED = 485,            /* MATERIALIZED  */
+    MAXVALUE = 486,                /* MAXVALUE  */
+    MINUTE_P = 487,                /* MINUTE_P  */
+    MINVALUE = 488,                /* MINVALUE  */
+    MODE = 489,                    /* MODE  */
+    MONTH_P = 490,                 /* MONTH_P  */
+    MOVE = 491,                    /* MOVE  */
+    NAME_P = 492,                  /* NAME_P  */
+    NAMES = 493,                   /* NAMES  */
+    NATIONAL = 494,                /* NATIONAL  */
+    NATURAL = 495,                 /* NATURAL  */
+    NCHAR = 496,                   /* NCHAR  */
+    NEXT = 497,                    /* NEXT  */
+    NO = 498,                      /* NO  */
+    NONE = 499,                    /* NONE  */
+    NOT = 500,                     /* NOT  */
+    NOTHING = 501,                 /* NOTHING  */
+    NOTIFY = 502,                  /* NOTIFY  */
+    NOTNULL = 503,                 /* NOTNULL  */
+    NOWAIT = 504,                  /* NOWAIT  */
+    NULL_P = 505,                  /* NULL_P  */
+    NULLIF = 506,                  /* NULLIF  */
+    NULLS_P = 507,                 /* NULLS_P  */
+    NUMERIC = 508,                 /* NUMERIC  */
+    OBJECT_P = 509,                /* OBJECT_P  */
+    OF = 510,                      /* OF  */
+    OFF = 511,                     /* OFF  */
+    OFFSET = 512,                  /* OFFSET  */
+    OIDS = 513,                    /* OIDS  */
+    ON = 514,                      /* ON  */
+    ONLY = 515,                    /* ONLY  */
+    OPERATOR = 516,                /* OPERATOR  */
+    OPTION = 517,                  /* OPTION  */
+    OPTIONS = 518,                 /* OPTIONS  */
+    OR = 519,                      /* OR  */
+    ORDER = 520,                   /* ORDER  */
+    ORDINALITY = 521,              /* ORDINALITY  */
+    OUT_P = 522,                   /* OUT_P  */
+    OUTER_P = 523,                 /* OUTER_P  */
+    OVER = 524,                    /* OVER  */
+    OVERLAPS = 525,                /* OVERLAPS  */
+    OVERLAY = 526,                 /* OVERLAY  */
+    OWNED = 527,                   /* OWNED  */
+    OWNER = 528,                   /* OWNER  */
+    PARSER = 529,                  /* PARSER  */
+    PARTIAL = 530,                 /* PARTIAL  */
+    PARTITION = 531,               /* PARTITION  */
+    PASSING = 532,                 /* PASSING  */
+    PASSWORD = 533,                /* PASSWORD  */
+    PLACING = 534,                 /* PLACING  */
+    PLANS = 535,                   /* PLANS  */
+    POLICY = 536,                  /* POLICY  */
+    POSITION = 537,                /* POSITION  */
+    PRECEDING = 538,               /* PRECEDING  */
+    PRECISION = 539,               /* PRECISION  */
+    PRESERVE = 540,                /* PRESERVE  */
+    PREPARE = 541,                 /* PREPARE  */
+    PREPARED = 542,                /* PREPARED  */
+    PRIMARY = 543,                 /* PRIMARY  */
+    PRIOR = 544,                   /* PRIOR  */
+    PRIVILEGES = 545,              /* PRIVILEGES  */
+    PROCEDURAL = 546,              /* PROCEDURAL  */
+    PROCEDURE = 547,               /* PROCEDURE  */
+    PROGRAM = 548,                 /* PROGRAM  */
+    QUOTE = 549,                   /* QUOTE  */
+    RANGE = 550,                   /* RANGE  */
+    READ = 551,                    /* READ  */
+    REAL = 552,                    /* REAL  */
+    REASSIGN = 553,                /* REASSIGN  */
+    RECHECK = 554,                 /* RECHECK  */
+    RECURSIVE = 555,               /* RECURSIVE  */
+    REF = 556,                     /* REF  */
+    REFERENCES = 557,              /* REFERENCES  */
+    REFRESH = 558,                 /* REFRESH  */
+    REINDEX = 559,                 /* REINDEX  */
+    RELATIVE_P = 560,              /* RELATIVE_P  */
+    RELEASE = 561,                 /* RELEASE  */
+    RENAME = 562,                  /* RENAME  */
+    REPEATABLE = 563,              /* REPEATABLE  */
+    REPLACE = 564,                 /* REPLACE  */
+    REPLICA = 565,                 /* REPLICA  */
+    RESET = 566,                   /* RESET  */
+    RESTART = 567,                 /* RESTART  */
+    RESTRICT = 568,                /* RESTRICT  */
+    RETURNING = 569,               /* RETURNING  */
+    RETURNS = 570,                 /* RETURNS  */
+    REVOKE = 571,                  /* REVOKE  */
+    RIGHT = 572,                   /* RIGHT  */
+    ROLE = 573,                    /* ROLE  */
+    ROLLBACK = 574,                /* ROLLBACK  */
+    ROLLUP = 575,                  /* ROLLUP  */
+    ROW = 576,                     /* ROW  */
+    ROWS = 577,                    /* ROWS  */
+    RULE = 578,                    /* RULE  */
+    SAVEPOINT = 579,               /* SAVEPOINT  */
+    SCHEMA = 580,                  /* SCHEMA  */
+    SCROLL = 581,                  /* SCROLL  */
+    SEARCH = 582,                  /* SEARCH  */
+    SECOND_P = 583,                /* SECOND_P  */
+    SECURITY = 584,                /* SECURITY  */
+    SELECT = 585,                  /* SELECT  */
+    SEQUENCE = 586,                /* SEQUENCE  */
+    SEQUENCES = 587,               /* SEQUENCES  */
+    SERIALIZABLE = 588,            /* SERIALIZABLE  */
+    SERVER = 589,                  /* SERVER  */
+    SESSION = 590,                 /* SESSION  */
+    SESSION_USER = 591,            /* SESSION_USER  */
+    SET = 592,                     /* SET  */
+    SETS = 593,                    /* SETS  */
+    SETOF = 594,                   /* SETOF  */
+    SHARE = 595,                   /* SHARE  */
+    SHOW = 596,                    /* SHOW  */
+    SIMILAR = 597,                 /* SIMILAR  */
+    SIMPLE = 598,                  /* SIMPLE  */
+    SKIP = 599,                    /* SKIP  */
+    SMALLINT = 600,                /* SMALLINT  */
+    SNAPSHOT = 601,                /* SNAPSHOT  */
+    SOME = 602,                    /* SOME  */
+    SQL_P = 603,                   /* SQL_P  */
+    STABLE = 604,                  /* STABLE  */
+    STANDALONE_P = 605,            /* STANDALONE_P  */
+    START = 606,                   /* START  */
+    STATEMENT = 607,               /* STATEMENT  */
+    STATISTICS = 608,              /* STATISTICS  */
+    STDIN = 609,                   /* STDIN  */
+    STDOUT = 610,                  /* STDOUT  */
+    STORAGE = 611,                 /* STORAGE  */
+    STRICT_P = 612,                /* STRICT_P  */
+    STRIP_P = 613,                 /* STRIP_P  */
+    SUBSTRING = 614,               /* SUBSTRING  */
+    SYMMETRIC = 615,               /* SYMMETRIC  */
+    SYSID = 616,                   /* SYSID  */
+    SYSTEM_P = 617,                /* SYSTEM_P  */
+    TABLE = 618,                   /* TABLE  */
+    TABLES = 619,                  /* TABLES  */
+    TABLESAMPLE = 620,             /* TABLESAMPLE  */
+    TABLESPACE = 621,              /* TABLESPACE  */
+    TEMP = 622,                    /* TEMP  */
+    TEMPLATE = 623,                /* TEMPLATE  */
+    TEMPORARY = 624,               /* TEMPORARY  */
+    TEXT_P = 625,                  /* TEXT_P  */
+    THEN = 626,                    /* THEN  */
+    TIME = 627,                    /* TIME  */
+    TIMESTAMP = 628,               /* TIMESTAMP  */
+    TO = 629,                      /* TO  */
+    TRAILING = 630,                /* TRAILING  */
+    TRANSACTION = 631,             /* TRANSACTION  */
+    TRANSFORM = 632,               /* TRANSFORM  */
+    TREAT = 633,                   /* TREAT  */
+    TRIGGER = 634,                 /* TRIGGER  */
+    TRIM = 635,                    /* TRIM  */
+    TRUE_P = 636,                  /* TRUE_P  */
+    TRUNCATE = 637,                /* TRUNCATE  */
+    TRUSTED = 638,                 /* TRUSTED  */
+    TYPE_P = 639,                  /* TYPE_P  */
+    TYPES_P = 640,                 /* TYPES_P  */
+    UNBOUNDED = 641,               /* UNBOUNDED  */
+    UNCOMMITTED = 642,             /* UNCOMMITTED  */
+    UNENCRYPTED = 643,             /* UNENCRYPTED  */
+    UNION = 644,                   /* UNION  */
+    UNIQUE = 645,                  /* UNIQUE  */
+    UNKNOWN = 646,                 /* UNKNOWN  */
+    UNLISTEN = 647,                /* UNLISTEN  */
+    UNLOGGED = 648,                /* UNLOGGED  */
+    UNTIL = 649,                   /* UNTIL  */
+    UPDATE = 650,                  /* UPDATE  */
+    USER = 651,                    /* USER  */
+    USING = 652,                   /* USING  */
+    VACUUM = 653,                  /* VACUUM  */
+    VALID = 654,                   /* VALID  */
+    VALIDATE = 655,                /* VALIDATE  */
+    VALIDATOR = 656,               /* VALIDATOR  */
+    VALUE_P = 657,                 /* VALUE_P  */
+    VALUES = 658,                  /* VALUES  */
+    VARCHAR = 659,                 /* VARCHAR  */
+    VARIADIC = 660,                /* VARIADIC  */
+    VARYING = 661,                 /* VARYING  */
+    VERBOSE = 662,                 /* VERBOSE  */
+    VERSION_P = 663,               /* VERSION_P  */
+    VIEW = 664,                    /* VIEW  */
+    VIEWS = 665,                   /* VIEWS  */
+    VOLATILE = 666,                /* VOLATILE  */
+    WHEN = 667,                    /* WHEN  */
+    WHERE = 668,                   /* WHERE  */
+    WHITESPACE_P = 669,            /* WHITESPACE_P  */
+    WINDOW = 670,                  /* WINDOW  */
+    WITH = 671,                    /* WITH  */
+    WITHIN = 672,                  /* WITHIN  */
+    WITHOUT = 673,                 /* WITHOUT  */
+    WORK = 674,                    /* WORK  */
+    WRAPPER = 675,                 /* WRAPPER  */
+    WRITE = 676,                   /* WRITE  */
+    XML_P = 677,                   /* XML_P  */
+    XMLATTRIBUTES = 678,           /* XMLATTRIBUTES  */
+    XMLCONCAT = 679,               /* XMLCONCAT  */
+    XMLELEMENT = 680,              /* XMLELEMENT  */
+    XMLEXISTS = 681,               /* XMLEXISTS  */
+    XMLFOREST = 682,               /* XMLFOREST  */
+    XMLPARSE = 683,                /* XMLPARSE  */
+    XMLPI = 684,                   /* XMLPI  */
+    XMLROOT = 685,                 /* XMLROOT  */
+    XMLSERIALIZE = 686,            /* XMLSERIALIZE  */
+    YEAR_P = 687,                  /* YEAR_P  */
+    YES_P = 688,                   /* YES_P  */
+    ZONE = 689,                    /* ZONE  */
+    NOT_LA = 690,                  /* NOT_LA  */
+    NULLS_LA = 691,                /* NULLS_LA  */
+    WITH_LA = 692,                 /* WITH_LA  */
+    POSTFIXOP = 693,               /* POSTFIXOP  */
+    UMINUS = 694                   /* UMINUS  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 191 "gram.y"
+
+	core_YYSTYPE		core_yystype;
+	/* these fields must match core_YYSTYPE: */
+	int					ival;
+	char				*str;
+	const char			*keyword;
+
+	char				chr;
+	bool				boolean;
+	JoinType			jtype;
+	DropBehavior		dbehavior;
+	OnCommitAction		oncommit;
+	List				*list;
+	Node				*node;
+	Value				*value;
+	ObjectType			objtype;
+	TypeName			*typnam;
+	FunctionParameter   *fun_param;
+	FunctionParameterMode fun_param_mode;
+	FuncWithArgs		*funwithargs;
+	DefElem				*defelt;
+	SortBy				*sortby;
+	WindowDef			*windef;
+	JoinExpr			*jexpr;
+	IndexElem			*ielem;
+	Alias				*alias;
+	RangeVar			*range;
+	IntoClause			*into;
+	WithClause			*with;
+	InferClause			*infer;
+	OnConflictClause	*onconflict;
+	A_Indices			*aind;
+	ResTarget			*target;
+	struct PrivTarget	*privtarget;
+	AccessPriv			*accesspriv;
+	struct ImportQual	*importqual;
+	InsertStmt			*istmt;
+	VariableSetStmt		*vsetstmt;
+	PartitionSpec		*partspec;
+	PartitionBoundSpec	*partboundspec;
+
+#line 545 "gram.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+/* Location type.  */
+#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
+typedef struct YYLTYPE YYLTYPE;
+struct YYLTYPE
+{
+  int first_line;
+  int first_column;
+  int last_line;
+  int last_column;
+};
+# define YYLTYPE_IS_DECLARED 1
+# define YYLTYPE_IS_TRIVIAL 1
+#endif
+
+
+
+
+int base_yyparse (core_yyscan_t yyscanner);
+
+
+#endif /* !YY_BASE_YY_GRAM_H_INCLUDED  */
@@ -0,0 +1 @@
+/* src/include/port/freebsd.h */
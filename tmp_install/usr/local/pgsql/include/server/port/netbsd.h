@@ -0,0 +1 @@
+/* src/include/port/netbsd.h */
@@ -0,0 +1,62 @@
+/*-------------------------------------------------------------------------
+ *
+ * logicallauncher.h
+ *	  Exports for the logical replication launcher and apply workers.
+ *
+ * Portions Copyright (c) 2015, PostgreSQL Global Development Group
+ *
+ * src/include/replication/logicallauncher.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef LOGICALLAUNCHER_H
+#define LOGICALLAUNCHER_H
+
+#include "access/xlogdefs.h"
+#include "datatype/timestamp.h"
+#include "fmgr.h"
+
+/* GUC variable */
+extern int	max_logical_replication_workers;
+
+/*
+ * Shared memory state of one apply worker.  Slots are handed out by the
+ * launcher; the worker fills in its pid and progress once running.
+ */
+typedef struct LogicalRepWorker
+{
+	bool		in_use;			/* slot is assigned to a subscription */
+	Oid			dbid;			/* database to connect to */
+	Oid			subid;			/* subscription being applied */
+	pid_t		pid;			/* pid of the worker, or 0 if not running */
+
+	/* Progress, for monitoring */
+	XLogRecPtr	received_lsn;	/* last LSN received from the publisher */
+	TimestampTz last_recv_time; /* time of last message from the publisher */
+	XLogRecPtr	reply_lsn;		/* last flush position reported back */
+	TimestampTz reply_time;		/* time of last feedback message */
+} LogicalRepWorker;
+
+/* The worker slot of the current process, in an apply worker */
+extern LogicalRepWorker *MyLogicalRepWorker;
+
+extern void ApplyLauncherRegister(void);
+extern void ApplyLauncherMain(Datum main_arg) pg_attribute_noreturn();
+
+extern Size ApplyLauncherShmemSize(void);
+extern void ApplyLauncherShmemInit(void);
+
+extern void ApplyLauncherWakeupAtCommit(void);
+extern void AtEOXact_ApplyLauncher(bool isCommit);
+
+extern void logicalrep_worker_attach(int slot);
+extern void logicalrep_worker_report(XLogRecPtr received_lsn,
+						 TimestampTz recv_time, XLogRecPtr reply_lsn,
+						 TimestampTz reply_time);
+extern void logicalrep_worker_stop(Oid subid);
+
+extern void ApplyWorkerMain(Datum main_arg) pg_attribute_noreturn();
+
+extern Datum pg_stat_get_subscription(PG_FUNCTION_ARGS);
+
+#endif   /* LOGICALLAUNCHER_H */
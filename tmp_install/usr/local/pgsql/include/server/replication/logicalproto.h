@@ -0,0 +1,97 @@
+/*-------------------------------------------------------------------------
+ *
+ * logicalproto.h
+ *		logical replication protocol
+ *
+ * Copyright (c) 2015, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *		src/include/replication/logicalproto.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef LOGICAL_PROTO_H
+#define LOGICAL_PROTO_H
+
+#include "lib/stringinfo.h"
+#include "nodes/bitmapset.h"
+#include "replication/reorderbuffer.h"
+#include "utils/rel.h"
+
+/*
+ * Protocol capabilities
+ *
+ * LOGICALREP_PROTO_VERSION_NUM is the version of the protocol written by
+ * the pgoutput plugin and understood by the apply worker.  The subscriber
+ * sends the version it wants in the "proto_version" plugin option.
+ */
+#define LOGICALREP_PROTO_MIN_VERSION_NUM 1
+#define LOGICALREP_PROTO_VERSION_NUM 1
+
+/* Tuple coming via logical replication. */
+typedef struct LogicalRepTupleData
+{
+	int			natts;
+	char	  **values;			/* text or binary representation of each
+								 * column, or NULL if the column is null */
+	int		   *lengths;		/* length of each value */
+	bool	   *binary;			/* is the value in binary format? */
+	bool	   *changed;		/* false for toasted columns that were not
+								 * changed and hence not sent */
+} LogicalRepTupleData;
+
+typedef uint32 LogicalRepRelId;
+
+/* Relation information as sent by the publisher. */
+typedef struct LogicalRepRelation
+{
+	LogicalRepRelId remoteid;	/* unique id of the relation */
+	char	   *nspname;		/* schema name */
+	char	   *relname;		/* relation name */
+	char		replident;		/* replica identity */
+	int			natts;			/* number of columns */
+	char	  **attnames;		/* column names */
+	Oid		   *atttyps;		/* column types on the publisher */
+	Bitmapset  *attkeys;		/* replica identity key columns */
+} LogicalRepRelation;
+
+typedef struct LogicalRepBeginData
+{
+	XLogRecPtr	final_lsn;
+	TimestampTz committime;
+	TransactionId xid;
+} LogicalRepBeginData;
+
+typedef struct LogicalRepCommitData
+{
+	XLogRecPtr	commit_lsn;
+	XLogRecPtr	end_lsn;
+	TimestampTz committime;
+} LogicalRepCommitData;
+
+extern void logicalrep_write_begin(StringInfo out, ReorderBufferTXN *txn);
+extern void logicalrep_read_begin(StringInfo in,
+					  LogicalRepBeginData *begin_data);
+extern void logicalrep_write_commit(StringInfo out, ReorderBufferTXN *txn,
+						XLogRecPtr commit_lsn);
+extern void logicalrep_read_commit(StringInfo in,
+					   LogicalRepCommitData *commit_data);
+extern void logicalrep_write_insert(StringInfo out, Relation rel,
+						HeapTuple newtuple, Bitmapset *columns, bool binary);
+extern LogicalRepRelId logicalrep_read_insert(StringInfo in,
+					   LogicalRepTupleData *newtup);
+extern void logicalrep_write_update(StringInfo out, Relation rel,
+						HeapTuple oldtuple, HeapTuple newtuple,
+						Bitmapset *columns, bool binary);
+extern LogicalRepRelId logicalrep_read_update(StringInfo in,
+					   bool *has_oldtuple, LogicalRepTupleData *oldtup,
+					   LogicalRepTupleData *newtup);
+extern void logicalrep_write_delete(StringInfo out, Relation rel,
+						HeapTuple oldtuple, Bitmapset *columns, bool binary);
+extern LogicalRepRelId logicalrep_read_delete(StringInfo in,
+					   LogicalRepTupleData *oldtup);
+extern void logicalrep_write_rel(StringInfo out, Relation rel,
+					 Bitmapset *columns);
+extern LogicalRepRelation *logicalrep_read_rel(StringInfo in);
+
+#endif   /* LOGICAL_PROTO_H */
@@ -0,0 +1,157 @@
+/*-------------------------------------------------------------------------
+ * output_plugin.h
+ *	   PostgreSQL Logical Decode Plugin Interface
+ *
+ * Copyright (c) 2012-2015, PostgreSQL Global Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef OUTPUT_PLUGIN_H
+#define OUTPUT_PLUGIN_H
+
+#include "replication/reorderbuffer.h"
+
+struct LogicalDecodingContext;
+struct OutputPluginCallbacks;
+
+typedef enum OutputPluginOutputType
+{
+	OUTPUT_PLUGIN_BINARY_OUTPUT,
+	OUTPUT_PLUGIN_TEXTUAL_OUTPUT
+} OutputPluginOutputType;
+
+/*
+ * Options set by the output plugin, in the startup callback.
+ */
+typedef struct OutputPluginOptions
+{
+	OutputPluginOutputType output_type;
+} OutputPluginOptions;
+
+/*
+ * Type of the shared library symbol _PG_output_plugin_init that is looked up
+ * when loading an output plugin shared library.
+ */
+typedef void (*LogicalOutputPluginInit) (struct OutputPluginCallbacks *cb);
+
+/*
+ * Callback that gets called in a user-defined plugin. ctx->private_data can
+ * be set to some private data.
+ *
+ * "is_init" will be set to "true" if the decoding slot just got defined. When
+ * the same slot is used from there one, it will be "false".
+ */
+typedef void (*LogicalDecodeStartupCB) (
+										  struct LogicalDecodingContext *ctx,
+												OutputPluginOptions *options,
+													bool is_init
+);
+
+/*
+ * Callback called for every (explicit or implicit) BEGIN of a successful
+ * transaction.
+ */
+typedef void (*LogicalDecodeBeginCB) (
+											 struct LogicalDecodingContext *,
+												  ReorderBufferTXN *txn);
+
+/*
+ * Callback for every individual change in a successful transaction.
+ */
+typedef void (*LogicalDecodeChangeCB) (
+											 struct LogicalDecodingContext *,
+												   ReorderBufferTXN *txn,
+												   Relation relation,
+												   ReorderBufferChange *change
+);
+
+/*
+ * Called for every (explicit or implicit) COMMIT of a successful transaction.
+ */
+typedef void (*LogicalDecodeCommitCB) (
+											 struct LogicalDecodingContext *,
+												   ReorderBufferTXN *txn,
+												   XLogRecPtr commit_lsn);
+
+/*
+ * Filter changes by origin.
+ */
+typedef bool (*LogicalDecodeFilterByOriginCB) (
+											 struct LogicalDecodingContext *,
+													  RepOriginId origin_id);
+
+/*
+ * Called before streaming a chunk of changes of an in-progress transaction.
+ * Only used if the output plugin provides all the stream_* callbacks, and
+ * hasn't turned streaming off in its startup callback.
+ */
+typedef void (*LogicalDecodeStreamStartCB) (
+											 struct LogicalDecodingContext *,
+													  ReorderBufferTXN *txn);
+
+/*
+ * Called after streaming a chunk of changes of an in-progress transaction.
+ */
+typedef void (*LogicalDecodeStreamStopCB) (
+											 struct LogicalDecodingContext *,
+													  ReorderBufferTXN *txn);
+
+/*
+ * Callback for every individual change of a streamed transaction.  The
+ * change may belong to a subtransaction of txn; change->txn tells which.
+ */
+typedef void (*LogicalDecodeStreamChangeCB) (
+											 struct LogicalDecodingContext *,
+														ReorderBufferTXN *txn,
+														Relation relation,
+												ReorderBufferChange *change);
+
+/*
+ * Called when a (sub)transaction some of whose changes were streamed has
+ * aborted; those changes must be discarded.
+ */
+typedef void (*LogicalDecodeStreamAbortCB) (
+											 struct LogicalDecodingContext *,
+													   ReorderBufferTXN *txn,
+													   XLogRecPtr abort_lsn);
+
+/*
+ * Called at the commit of a streamed transaction, after its last chunk of
+ * changes.  All changes streamed for the transaction and for any of its
+ * subtransactions (txn->subtxns) become committed.
+ */
+typedef void (*LogicalDecodeStreamCommitCB) (
+											 struct LogicalDecodingContext *,
+														ReorderBufferTXN *txn,
+														XLogRecPtr commit_lsn);
+
+/*
+ * Called to shutdown an output plugin.
+ */
+typedef void (*LogicalDecodeShutdownCB) (
+											  struct LogicalDecodingContext *
+);
+
+/*
+ * Output plugin callbacks
+ */
+typedef struct OutputPluginCallbacks
+{
+	LogicalDecodeStartupCB startup_cb;
+	LogicalDecodeBeginCB begin_cb;
+	LogicalDecodeChangeCB change_cb;
+	LogicalDecodeCommitCB commit_cb;
+	LogicalDecodeFilterByOriginCB filter_by_origin_cb;
+	LogicalDecodeShutdownCB shutdown_cb;
+	/* streaming of in-progress transactions, optional */
+	LogicalDecodeStreamStartCB stream_start_cb;
+	LogicalDecodeStreamStopCB stream_stop_cb;
+	LogicalDecodeStreamChangeCB stream_change_cb;
+	LogicalDecodeStreamAbortCB stream_abort_cb;
+	LogicalDecodeStreamCommitCB stream_commit_cb;
+} OutputPluginCallbacks;
+
+void		OutputPluginPrepareWrite(struct LogicalDecodingContext *ctx, bool last_write);
+void		OutputPluginWrite(struct LogicalDecodingContext *ctx, bool last_write);
+
+#endif   /* OUTPUT_PLUGIN_H */
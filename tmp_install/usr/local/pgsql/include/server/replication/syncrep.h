@@ -0,0 +1,77 @@
+/*-------------------------------------------------------------------------
+ *
+ * syncrep.h
+ *	  Exports from replication/syncrep.c.
+ *
+ * Portions Copyright (c) 2010-2015, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *		src/include/replication/syncrep.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef _SYNCREP_H
+#define _SYNCREP_H
+
+#include "access/xlogdefs.h"
+#include "nodes/pg_list.h"
+#include "utils/guc.h"
+
+#define SyncRepRequested() \
+	(max_wal_senders > 0 && synchronous_commit > SYNCHRONOUS_COMMIT_LOCAL_FLUSH)
+
+/* SyncRepWaitMode */
+#define SYNC_REP_NO_WAIT		-1
+#define SYNC_REP_WAIT_WRITE		0
+#define SYNC_REP_WAIT_FLUSH		1
+#define SYNC_REP_WAIT_APPLY		2
+
+#define NUM_SYNC_REP_WAIT_MODE	3
+
+/* syncRepState */
+#define SYNC_REP_NOT_WAITING		0
+#define SYNC_REP_WAITING			1
+#define SYNC_REP_WAIT_COMPLETE		2
+
+/* syncrep_method of SyncRepConfigData */
+#define SYNC_REP_PRIORITY		0
+#define SYNC_REP_QUORUM			1
+
+/*
+ * Parsed form of synchronous_standby_names, kept as the GUC's "extra" data.
+ * member_names holds nmembers null-terminated names stored back to back.
+ */
+typedef struct SyncRepConfigData
+{
+	int			config_size;	/* total size of this struct, in bytes */
+	int			num_sync;		/* number of sync standbys to wait for */
+	uint8		syncrep_method;	/* SYNC_REP_PRIORITY or SYNC_REP_QUORUM */
+	int			nmembers;		/* number of names in member_names */
+	char		member_names[FLEXIBLE_ARRAY_MEMBER];
+} SyncRepConfigData;
+
+/* user-settable parameters for synchronous replication */
+extern char *SyncRepStandbyNames;
+extern SyncRepConfigData *SyncRepConfig;
+
+/* called by user backend */
+extern void SyncRepWaitForLSN(XLogRecPtr XactCommitLSN);
+
+/* called at backend exit */
+extern void SyncRepCleanupAtProcExit(void);
+
+/* called by wal sender */
+extern void SyncRepInitConfig(void);
+extern void SyncRepReleaseWaiters(void);
+
+/* called by checkpointer */
+extern void SyncRepUpdateSyncStandbysDefined(void);
+
+/* called by wal sender and user backend */
+extern List *SyncRepGetSyncStandbys(bool *am_sync);
+
+extern bool check_synchronous_standby_names(char **newval, void **extra, GucSource source);
+extern void assign_synchronous_standby_names(const char *newval, void *extra);
+extern void assign_synchronous_commit(int newval, void *extra);
+
+#endif   /* _SYNCREP_H */
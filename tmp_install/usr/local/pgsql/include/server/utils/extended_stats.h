@@ -0,0 +1,84 @@
+/*-------------------------------------------------------------------------
+ *
+ * extended_stats.h
+ *	  Multi-column ("extended") statistics, built by ANALYZE for the
+ *	  statistics objects defined with CREATE STATISTICS, and their use
+ *	  in selectivity and group-count estimation.
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/utils/extended_stats.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef EXTENDED_STATS_H
+#define EXTENDED_STATS_H
+
+#include "access/htup.h"
+#include "nodes/relation.h"
+#include "utils/relcache.h"
+
+/* Maximum number of columns of a statistics object */
+#define STATS_MAX_DIMENSIONS	8
+
+#define STATS_NDISTINCT_MAGIC		0xA352BFA4
+#define STATS_DEPENDENCIES_MAGIC	0xB4549A2C
+
+/*
+ * Estimated number of distinct values of one combination of columns.  As in
+ * pg_statistic's stadistinct, a negative ndistinct is the negative of the
+ * fraction of the table's rows, used when the number seems to grow with
+ * the table.
+ */
+typedef struct MVNDistinctItem
+{
+	double		ndistinct;		/* number of distinct values */
+	int			nattrs;			/* number of columns */
+	AttrNumber	attrs[STATS_MAX_DIMENSIONS];	/* column numbers */
+} MVNDistinctItem;
+
+/* The ndistinct estimates of all combinations of two or more columns */
+typedef struct MVNDistinct
+{
+	uint32		magic;			/* STATS_NDISTINCT_MAGIC */
+	int			nitems;			/* number of items */
+	MVNDistinctItem items[FLEXIBLE_ARRAY_MEMBER];
+} MVNDistinct;
+
+/*
+ * Functional dependency of the last of attrs on the others: the fraction of
+ * rows, 'degree', in which the other columns' values determine its value.
+ */
+typedef struct MVDependency
+{
+	double		degree;			/* degree of validity, 0..1 */
+	int			nattrs;			/* number of columns, including the
+								 * dependent one */
+	AttrNumber	attrs[STATS_MAX_DIMENSIONS];	/* determining columns,
+												 * then the dependent one */
+} MVDependency;
+
+typedef struct MVDependencies
+{
+	uint32		magic;			/* STATS_DEPENDENCIES_MAGIC */
+	int			ndeps;			/* number of dependencies */
+	MVDependency deps[FLEXIBLE_ARRAY_MEMBER];
+} MVDependencies;
+
+extern void BuildRelationExtStatistics(Relation onerel, double totalrows,
+						   int numrows, HeapTuple *rows);
+extern bool statext_is_kind_built(HeapTuple htup, char kind);
+extern MVNDistinct *statext_ndistinct_load(Oid statOid);
+extern MVDependencies *statext_dependencies_load(Oid statOid);
+extern StatisticExtInfo *choose_best_statistics(List *stats,
+					   Bitmapset *attnums, char requiredkind);
+extern Selectivity dependencies_clauselist_selectivity(PlannerInfo *root,
+									List *clauses,
+									int varRelid,
+									JoinType jointype,
+									SpecialJoinInfo *sjinfo,
+									RelOptInfo *rel,
+									Bitmapset **estimatedclauses);
+
+#endif   /* EXTENDED_STATS_H */
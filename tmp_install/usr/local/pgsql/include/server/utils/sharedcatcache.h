@@ -0,0 +1,40 @@
+/*-------------------------------------------------------------------------
+ *
+ * sharedcatcache.h
+ *	  Shared-memory second-level cache of system catalog tuples.
+ *
+ * See sharedcatcache.c for comments.
+ *
+ * Portions Copyright (c) 1996-2015, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/utils/sharedcatcache.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef SHAREDCATCACHE_H
+#define SHAREDCATCACHE_H
+
+#include "access/htup.h"
+#include "storage/sinval.h"
+#include "utils/catcache.h"
+
+/* Tuples longer than this are not kept in the shared cache */
+#define SHARED_CATCACHE_TUPLE_SIZE	512
+
+/* GUC parameter */
+extern int	shared_catcache_entries;
+
+extern Size SharedCatCacheShmemSize(void);
+extern void SharedCatCacheShmemInit(void);
+
+extern bool SharedCatCacheUsable(CatCache *cache);
+extern HeapTuple SharedCatCacheSearch(CatCache *cache, uint32 hashValue,
+					 uint64 *generation);
+extern void SharedCatCacheInsert(CatCache *cache, uint32 hashValue,
+					 HeapTuple tuple, uint64 generation);
+extern void SharedCatCacheInvalidate(const SharedInvalidationMessage *msgs,
+						 int n);
+extern void SharedCatCacheDropDatabase(Oid dbid);
+
+#endif   /* SHAREDCATCACHE_H */